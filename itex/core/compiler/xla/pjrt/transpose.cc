@@ -88,6 +88,7 @@ limitations under the License.
 #include "itex/core/compiler/xla/pjrt/transpose_kernels.h"
 #include "itex/core/compiler/xla/status.h"
 #include "itex/core/compiler/xla/util.h"
+#include "itex/core/utils/cpu_info.h"
 #include "itex/core/utils/logging.h"
 
 namespace itex_xla {
@@ -126,7 +127,8 @@ void ConvertF64ToEf57(const double* input, float* output, int n) {
 }
 
 template <typename T, int inner_bs,
-          TransposePlan::Transformation transformation>
+          TransposePlan::Transformation transformation,
+          TransposePlan::Isa isa>
 void MacroKernel(const char* __restrict a, int64_t lda, int outer_bs_a,
                  char* __restrict b, int64_t ldb, int outer_bs_b,
                  void* __restrict scratch) {
@@ -148,19 +150,32 @@ void MacroKernel(const char* __restrict a, int64_t lda, int outer_bs_a,
     lda = outer_bs_a * inner_bs * sizeof(float);
   }
 
-  for (int i = 0; i < outer_bs_a; ++i) {
-    for (int j = 0; j < outer_bs_b; ++j) {
-      TransposeMicroKernel<T, inner_bs>::Apply(
-          a + inner_bs * j * lda + i * inner_bs * sizeof(T), lda,
-          b + inner_bs * i * ldb + j * inner_bs * sizeof(T), ldb);
-    }
+  switch (isa) {
+    case TransposePlan::Isa::kGeneric:
+      for (int i = 0; i < outer_bs_a; ++i) {
+        for (int j = 0; j < outer_bs_b; ++j) {
+          TransposeMicroKernel<T, inner_bs>::Apply(
+              a + inner_bs * j * lda + i * inner_bs * sizeof(T), lda,
+              b + inner_bs * i * ldb + j * inner_bs * sizeof(T), ldb);
+        }
+      }
+      break;
+    case TransposePlan::Isa::kAvx2:
+      Avx2TransposeBlocks<T, inner_bs>(a, lda, outer_bs_a, b, ldb,
+                                       outer_bs_b);
+      break;
+    case TransposePlan::Isa::kAvx512:
+      Avx512TransposeBlocks<T, inner_bs>(a, lda, outer_bs_a, b, ldb,
+                                         outer_bs_b);
+      break;
   }
 }
 
 // Transpose() is a driver function that implements a multidimensional loop nest
 // following by iterating over the linked Node data structure.
 template <typename T, int inner_bs,
-          TransposePlan::Transformation transformation>
+          TransposePlan::Transformation transformation,
+          TransposePlan::Isa isa>
 void Transpose(const char* __restrict a, int outer_bs_a, char* __restrict b,
                int outer_bs_b, TransposePlan::Node const* __restrict node,
                void* __restrict scratch) {
@@ -182,9 +197,9 @@ void Transpose(const char* __restrict a, int outer_bs_a, char* __restrict b,
     const int64_t ldb_block = next_node->ldb;
     int64_t i;
     for (i = start; i < stop; i += inc) {
-      MacroKernel<T, inner_bs, transformation>(a + i * lda, lda_block,
-                                               outer_bs_a, b + i * ldb,
-                                               ldb_block, outer_bs_b, scratch);
+      MacroKernel<T, inner_bs, transformation, isa>(
+          a + i * lda, lda_block, outer_bs_a, b + i * ldb, ldb_block,
+          outer_bs_b, scratch);
     }
     // Handle trailing elements that didn't fit in a complete macrokernel.
     // Only the innermost dimensions have non-trivial outer_bs blocking.
@@ -194,7 +209,7 @@ void Transpose(const char* __restrict a, int outer_bs_a, char* __restrict b,
       if (node->is_inner_dim_in_a) {
         outer_bs_a = (end - i) / inner_bs;
         if (outer_bs_a > 0) {
-          MacroKernel<T, inner_bs, transformation>(
+          MacroKernel<T, inner_bs, transformation, isa>(
               a + i * lda, lda_block, outer_bs_a, b + i * ldb, ldb_block,
               outer_bs_b, scratch);
           i += outer_bs_a * inner_bs;
@@ -202,22 +217,22 @@ void Transpose(const char* __restrict a, int outer_bs_a, char* __restrict b,
         // If there are still trailing elements left over that don't fit in the
         // inner block size, handle them via an unvectorized transpose.
         if (i < end) {
-          MacroKernel<T, 1, transformation>(a + i * lda, lda_block, end - i,
-                                            b + i * ldb, ldb_block,
-                                            outer_bs_b * inner_bs, scratch);
+          MacroKernel<T, 1, transformation, isa>(
+              a + i * lda, lda_block, end - i, b + i * ldb, ldb_block,
+              outer_bs_b * inner_bs, scratch);
         }
       } else if (node->is_inner_dim_in_b) {
         outer_bs_b = (end - i) / inner_bs;
         if (outer_bs_b > 0) {
-          MacroKernel<T, inner_bs, transformation>(
+          MacroKernel<T, inner_bs, transformation, isa>(
               a + i * lda, lda_block, outer_bs_a, b + i * ldb, ldb_block,
               outer_bs_b, scratch);
           i += outer_bs_b * inner_bs;
         }
         if (i < end) {
-          MacroKernel<T, 1, transformation>(a + i * lda, lda_block,
-                                            outer_bs_a * inner_bs, b + i * ldb,
-                                            ldb_block, end - i, scratch);
+          MacroKernel<T, 1, transformation, isa>(
+              a + i * lda, lda_block, outer_bs_a * inner_bs, b + i * ldb,
+              ldb_block, end - i, scratch);
         }
       }
     } else if (node->trailing_tile_next_node_inc) {
@@ -231,13 +246,13 @@ void Transpose(const char* __restrict a, int outer_bs_a, char* __restrict b,
       if (trailing_next_node->inc < 0) {
         const int64_t lda_block = trailing_next_node->lda;
         const int64_t ldb_block = trailing_next_node->ldb;
-        MacroKernel<T, inner_bs, transformation>(
+        MacroKernel<T, inner_bs, transformation, isa>(
             a + i * lda, lda_block, outer_bs_a, b + i * ldb, ldb_block,
             outer_bs_b, scratch);
       } else {
-        Transpose<T, inner_bs, transformation>(a + i * lda, outer_bs_a,
-                                               b + i * ldb, outer_bs_b,
-                                               trailing_next_node, scratch);
+        Transpose<T, inner_bs, transformation, isa>(
+            a + i * lda, outer_bs_a, b + i * ldb, outer_bs_b,
+            trailing_next_node, scratch);
       }
     }
   } else {
@@ -246,7 +261,7 @@ void Transpose(const char* __restrict a, int outer_bs_a, char* __restrict b,
     // but we call Transpose() recursively instead of MacroKernel().
     int64_t i;
     for (i = start; i < stop; i += inc) {
-      Transpose<T, inner_bs, transformation>(
+      Transpose<T, inner_bs, transformation, isa>(
           a + i * lda, outer_bs_a, b + i * ldb, outer_bs_b, next_node, scratch);
     }
     if (i < end) {
@@ -255,28 +270,29 @@ void Transpose(const char* __restrict a, int outer_bs_a, char* __restrict b,
       if (node->is_inner_dim_in_a) {
         outer_bs_a = (end - i) / inner_bs;
         if (outer_bs_a > 0) {
-          Transpose<T, inner_bs, transformation>(a + i * lda, outer_bs_a,
-                                                 b + i * ldb, outer_bs_b,
-                                                 next_node, scratch);
+          Transpose<T, inner_bs, transformation, isa>(
+              a + i * lda, outer_bs_a, b + i * ldb, outer_bs_b, next_node,
+              scratch);
           i += outer_bs_a * inner_bs;
         }
         if (i < end) {
-          Transpose<T, 1, transformation>(a + i * lda, end - i, b + i * ldb,
-                                          outer_bs_b * inner_bs, next_node,
-                                          scratch);
+          Transpose<T, 1, transformation, isa>(a + i * lda, end - i,
+                                               b + i * ldb,
+                                               outer_bs_b * inner_bs,
+                                               next_node, scratch);
         }
       } else if (node->is_inner_dim_in_b) {
         outer_bs_b = (end - i) / inner_bs;
         if (outer_bs_b > 0) {
-          Transpose<T, inner_bs, transformation>(a + i * lda, outer_bs_a,
-                                                 b + i * ldb, outer_bs_b,
-                                                 next_node, scratch);
+          Transpose<T, inner_bs, transformation, isa>(
+              a + i * lda, outer_bs_a, b + i * ldb, outer_bs_b, next_node,
+              scratch);
           i += outer_bs_b * inner_bs;
         }
         if (i < end) {
-          Transpose<T, 1, transformation>(a + i * lda, outer_bs_a * inner_bs,
-                                          b + i * ldb, end - i, next_node,
-                                          scratch);
+          Transpose<T, 1, transformation, isa>(
+              a + i * lda, outer_bs_a * inner_bs, b + i * ldb, end - i,
+              next_node, scratch);
         }
       }
     } else if (node->trailing_tile_next_node_inc) {
@@ -285,13 +301,13 @@ void Transpose(const char* __restrict a, int outer_bs_a, char* __restrict b,
       if (trailing_next_node->inc < 0) {
         const int64_t lda_block = trailing_next_node->lda;
         const int64_t ldb_block = trailing_next_node->ldb;
-        MacroKernel<T, inner_bs, transformation>(
+        MacroKernel<T, inner_bs, transformation, isa>(
             a + i * lda, lda_block, outer_bs_a, b + i * ldb, ldb_block,
             outer_bs_b, scratch);
       } else {
-        Transpose<T, inner_bs, transformation>(a + i * lda, outer_bs_a,
-                                               b + i * ldb, outer_bs_b,
-                                               trailing_next_node, scratch);
+        Transpose<T, inner_bs, transformation, isa>(
+            a + i * lda, outer_bs_a, b + i * ldb, outer_bs_b,
+            trailing_next_node, scratch);
       }
     }
   }
@@ -372,7 +388,8 @@ void TransposeConstStride1(const char* __restrict a, char* __restrict b,
   }
 }
 
-template <typename T, TransposePlan::Transformation transformation>
+template <typename T, TransposePlan::Transformation transformation,
+          TransposePlan::Isa isa>
 void TransposePlan::ExecuteTyped(const char* a, char* b,
                                  absl::Span<Node const> nodes) const {
   if (inner_kernel_is_memcpy_) {
@@ -386,22 +403,22 @@ void TransposePlan::ExecuteTyped(const char* a, char* b,
     switch (inner_block_elems_) {
       case 1:
         if (nodes.size() > 1) {
-          Transpose<T, 1, transformation>(a, outer_block_elems_a_, b,
-                                          outer_block_elems_b_, nodes.data(),
-                                          scratch.get());
+          Transpose<T, 1, transformation, isa>(
+              a, outer_block_elems_a_, b, outer_block_elems_b_, nodes.data(),
+              scratch.get());
         } else {
-          MacroKernel<T, 1, transformation>(
+          MacroKernel<T, 1, transformation, isa>(
               a, nodes.back().lda, outer_block_elems_a_, b, nodes.back().ldb,
               outer_block_elems_b_, scratch.get());
         }
         break;
       case 2:
         if (nodes.size() > 1) {
-          Transpose<T, 2, transformation>(a, outer_block_elems_a_, b,
-                                          outer_block_elems_b_, nodes.data(),
-                                          scratch.get());
+          Transpose<T, 2, transformation, isa>(
+              a, outer_block_elems_a_, b, outer_block_elems_b_, nodes.data(),
+              scratch.get());
         } else {
-          MacroKernel<T, 2, transformation>(
+          MacroKernel<T, 2, transformation, isa>(
               a, nodes.back().lda, outer_block_elems_a_, b, nodes.back().ldb,
               outer_block_elems_b_, scratch.get());
         }
@@ -409,33 +426,33 @@ void TransposePlan::ExecuteTyped(const char* a, char* b,
       case 4:
 
         if (nodes.size() > 1) {
-          Transpose<T, 4, transformation>(a, outer_block_elems_a_, b,
-                                          outer_block_elems_b_, nodes.data(),
-                                          scratch.get());
+          Transpose<T, 4, transformation, isa>(
+              a, outer_block_elems_a_, b, outer_block_elems_b_, nodes.data(),
+              scratch.get());
         } else {
-          MacroKernel<T, 4, transformation>(
+          MacroKernel<T, 4, transformation, isa>(
               a, nodes.back().lda, outer_block_elems_a_, b, nodes.back().ldb,
               outer_block_elems_b_, scratch.get());
         }
         break;
       case 8:
         if (nodes.size() > 1) {
-          Transpose<T, 8, transformation>(a, outer_block_elems_a_, b,
-                                          outer_block_elems_b_, nodes.data(),
-                                          scratch.get());
+          Transpose<T, 8, transformation, isa>(
+              a, outer_block_elems_a_, b, outer_block_elems_b_, nodes.data(),
+              scratch.get());
         } else {
-          MacroKernel<T, 8, transformation>(
+          MacroKernel<T, 8, transformation, isa>(
               a, nodes.back().lda, outer_block_elems_a_, b, nodes.back().ldb,
               outer_block_elems_b_, scratch.get());
         }
         break;
       case 16:
         if (nodes.size() > 1) {
-          Transpose<T, 16, transformation>(a, outer_block_elems_a_, b,
-                                           outer_block_elems_b_, nodes.data(),
-                                           scratch.get());
+          Transpose<T, 16, transformation, isa>(
+              a, outer_block_elems_a_, b, outer_block_elems_b_, nodes.data(),
+              scratch.get());
         } else {
-          MacroKernel<T, 16, transformation>(
+          MacroKernel<T, 16, transformation, isa>(
               a, nodes.back().lda, outer_block_elems_a_, b, nodes.back().ldb,
               outer_block_elems_b_, scratch.get());
         }
@@ -452,6 +469,39 @@ struct uint128 {
 };
 static_assert(sizeof(uint128) == 16, "uint128 should be 16 bytes in size");
 
+// The plans of 16-byte elements and of the ef57 transformation always use the
+// generic kernels.
+template <TransposePlan::Isa isa>
+void TransposePlan::ExecuteForIsa(const char* a, char* b,
+                                  absl::Span<Node const> nodes) const {
+  switch (elem_size_in_bytes_) {
+    case 1:
+      ExecuteTyped<uint8_t, Transformation::kNone, isa>(a, b, nodes);
+      break;
+    case 2:
+      ExecuteTyped<uint16_t, Transformation::kNone, isa>(a, b, nodes);
+      break;
+    case 4:
+      if (transformation_ == Transformation::kNone) {
+        ExecuteTyped<uint32_t, Transformation::kNone, isa>(a, b, nodes);
+      } else {
+        ITEX_DCHECK(transformation_ == Transformation::kF64ToEf57);
+        ExecuteTyped<uint32_t, Transformation::kF64ToEf57, Isa::kGeneric>(
+            a, b, nodes);
+      }
+      break;
+    case 8:
+      ExecuteTyped<uint64_t, Transformation::kNone, isa>(a, b, nodes);
+      break;
+    case 16:
+      ExecuteTyped<uint128, Transformation::kNone, Isa::kGeneric>(a, b,
+                                                                  nodes);
+      break;
+    default:
+      ITEX_LOG(FATAL) << "Unimplemented element size " << elem_size_in_bytes_;
+  }
+}
+
 void TransposePlan::Execute(
     const void* a, void* b,
     const std::function<void(std::function<void(void)>)>& schedule_work) const {
@@ -463,29 +513,16 @@ void TransposePlan::Execute(
   char* bc = static_cast<char*>(b);
 
   auto execute_by_type = [&](absl::Span<Node const> nodes) {
-    switch (elem_size_in_bytes_) {
-      case 1:
-        ExecuteTyped<uint8_t, Transformation::kNone>(ac, bc, nodes);
+    switch (isa_) {
+      case Isa::kGeneric:
+        ExecuteForIsa<Isa::kGeneric>(ac, bc, nodes);
         break;
-      case 2:
-        ExecuteTyped<uint16_t, Transformation::kNone>(ac, bc, nodes);
-        break;
-      case 4:
-        if (transformation_ == Transformation::kNone) {
-          ExecuteTyped<uint32_t, Transformation::kNone>(ac, bc, nodes);
-        } else {
-          ITEX_DCHECK(transformation_ == Transformation::kF64ToEf57);
-          ExecuteTyped<uint32_t, Transformation::kF64ToEf57>(ac, bc, nodes);
-        }
-        break;
-      case 8:
-        ExecuteTyped<uint64_t, Transformation::kNone>(ac, bc, nodes);
+      case Isa::kAvx2:
+        ExecuteForIsa<Isa::kAvx2>(ac, bc, nodes);
         break;
-      case 16:
-        ExecuteTyped<uint128, Transformation::kNone>(ac, bc, nodes);
+      case Isa::kAvx512:
+        ExecuteForIsa<Isa::kAvx512>(ac, bc, nodes);
         break;
-      default:
-        ITEX_LOG(FATAL) << "Unimplemented element size " << elem_size_in_bytes_;
     }
   };
 
@@ -878,11 +915,31 @@ void TransposePlan::BuildPlanNodes(
   }
 }
 
+TransposePlan::Isa TransposePlan::SupportedIsa() {
+#ifdef ITEX_XLA_HAVE_ISA_TRANSPOSE_KERNELS
+  static const Isa isa = [] {
+    using itex::port::TestCPUFeature;
+    if (TestCPUFeature(itex::port::AVX512F) &&
+        TestCPUFeature(itex::port::AVX512BW) &&
+        TestCPUFeature(itex::port::AVX512VL)) {
+      return Isa::kAvx512;
+    }
+    if (TestCPUFeature(itex::port::AVX2)) {
+      return Isa::kAvx2;
+    }
+    return Isa::kGeneric;
+  }();
+  return isa;
+#else
+  return Isa::kGeneric;
+#endif  // ITEX_XLA_HAVE_ISA_TRANSPOSE_KERNELS
+}
+
 StatusOr<std::unique_ptr<TransposePlan>> TransposePlan::Create(
     size_t elem_size_in_bytes, absl::Span<int64_t const> dims,
     absl::Span<int64_t const> permutation,
     std::variant<Tiling, Striding> input_layout, Tiling output_tiling,
-    Transformation transformation, int num_threads) {
+    Transformation transformation, int num_threads, Isa max_isa) {
   auto is_negative = [](int d) { return d < 0; };
   if (absl::c_find_if(dims, is_negative) != dims.end()) {
     return InvalidArgument("dims must be non-negative, got %s",
@@ -1003,6 +1060,7 @@ StatusOr<std::unique_ptr<TransposePlan>> TransposePlan::Create(
   }
 
   plan->transformation_ = transformation;
+  plan->isa_ = std::min(max_isa, SupportedIsa());
   switch (transformation) {
     case Transformation::kNone:
       break;
@@ -1019,6 +1077,7 @@ StatusOr<std::unique_ptr<TransposePlan>> TransposePlan::Create(
             "multiple of 2",
             sizeof(float));
       }
+      plan->isa_ = Isa::kGeneric;
   }
 
   plan->Initialize();
@@ -1026,6 +1085,43 @@ StatusOr<std::unique_ptr<TransposePlan>> TransposePlan::Create(
   return plan;
 }
 
+// Returns the smallest and largest block sizes for which "isa" has a
+// vectorized kernel for elements of "elem_size_in_bytes", or {0, 0} if it has
+// none.
+static std::pair<int, int> InnerBlockElemsRange(TransposePlan::Isa isa,
+                                                int64_t elem_size_in_bytes) {
+  switch (isa) {
+    case TransposePlan::Isa::kGeneric:
+      switch (elem_size_in_bytes) {
+        case 1:
+          return {4, 16};
+        case 2:
+          return {8, 8};
+        case 4:
+          return {4, 8};
+        case 8:
+          return {2, 4};
+        case 16:
+          return {1, 1};
+      }
+      break;
+    case TransposePlan::Isa::kAvx2:
+    case TransposePlan::Isa::kAvx512:
+      switch (elem_size_in_bytes) {
+        case 1:
+        case 2:
+        case 4:
+          return {8, 16};
+        case 8:
+          return {4, isa == TransposePlan::Isa::kAvx512 ? 16 : 8};
+        case 16:
+          return {0, 0};
+      }
+      break;
+  }
+  ITEX_LOG(FATAL) << "Unreachable: element size " << elem_size_in_bytes;
+}
+
 void TransposePlan::Initialize() {
   if (num_elems_ == 0) {
     return;
@@ -1099,34 +1195,25 @@ void TransposePlan::Initialize() {
     inner_block_elems_ = -1;
     outer_block_elems_a_ = -1;
     outer_block_elems_b_ = -1;
+    isa_ = Isa::kGeneric;
   } else {
     // What are the smallest and largest block sizes for which we have a
     // vectorized kernel for this element size?
     int min_inner_block_elems;
     int max_inner_block_elems;
-    switch (elem_size_in_bytes_) {
-      case 1:
-        min_inner_block_elems = 4;
-        max_inner_block_elems = 16;
-        break;
-      case 2:
-        min_inner_block_elems = 8;
-        max_inner_block_elems = 8;
-        break;
-      case 4:
-        min_inner_block_elems = 4;
-        max_inner_block_elems = 8;
-        break;
-      case 8:
-        min_inner_block_elems = 2;
-        max_inner_block_elems = 4;
-        break;
-      case 16:
-        min_inner_block_elems = 1;
-        max_inner_block_elems = 1;
-        break;
-      default:
-        ITEX_LOG(FATAL) << "Unreachable: element size " << elem_size_in_bytes_;
+    if (isa_ != Isa::kGeneric) {
+      std::tie(min_inner_block_elems, max_inner_block_elems) =
+          InnerBlockElemsRange(isa_, elem_size_in_bytes_);
+      // Falls back to the generic kernels, which have smaller blocks, if the
+      // stride-1 dimensions are too small for the register-blocked ones.
+      if (min_inner_block_elems == 0 ||
+          min_inner_block_elems > std::min(a_stride1_size, b_stride1_size)) {
+        isa_ = Isa::kGeneric;
+      }
+    }
+    if (isa_ == Isa::kGeneric) {
+      std::tie(min_inner_block_elems, max_inner_block_elems) =
+          InnerBlockElemsRange(isa_, elem_size_in_bytes_);
     }
     inner_block_elems_ = max_inner_block_elems;
     while (inner_block_elems_ > std::min(a_stride1_size, b_stride1_size)) {
@@ -1310,10 +1397,22 @@ std::string TransposePlan::ToString() const {
       transformation_str = "ef57";
       break;
   }
+  std::string isa_str;
+  switch (isa_) {
+    case Isa::kGeneric:
+      isa_str = "generic";
+      break;
+    case Isa::kAvx2:
+      isa_str = "avx2";
+      break;
+    case Isa::kAvx512:
+      isa_str = "avx512";
+      break;
+  }
   return absl::StrFormat(
       "elem_size=%d a_dims=%s b_dims=%s permutation=%s a_tiling=%s b_tiling=%s "
       "lda=%s lda_tile=%s ldb=%s ldb_tile=%s loop_order=%s "
-      "loop_parallelism=%s outer_bs=[%d,%d] inner_bs=%d "
+      "loop_parallelism=%s outer_bs=[%d,%d] inner_bs=%d isa=%s "
       "transformation=%s scratch_size=%d\n"
       "nodes:\n%s",
       elem_size_in_bytes_, absl::StrJoin(a_dims_, ","),
@@ -1324,7 +1423,7 @@ std::string TransposePlan::ToString() const {
       absl::StrJoin(ldb_tile_, ","),
       absl::StrJoin(loop_order_, ",", format_loop_order),
       absl::StrJoin(loop_parallelism_, ","), outer_block_elems_a_,
-      outer_block_elems_b_, inner_block_elems_, transformation_str,
+      outer_block_elems_b_, inner_block_elems_, isa_str, transformation_str,
       scratch_size_, nodes_str);
 }
 
@@ -72,6 +72,10 @@ class TransposePlan {
   //
   // num_threads: is the number of threads requested. The actual number of
   //   threads used may be smaller if there isn't enough work per thread.
+  //
+  // max_isa: the widest instruction set whose micro-kernels the plan may use.
+  //   The plan uses the widest one supported by the CPU, and the generic
+  //   kernels if the stride-1 dimensions are too small for it.
   struct Tiling {
     absl::Span<int64_t const> tiling;
   };
@@ -86,6 +90,15 @@ class TransposePlan {
     // representation used on TPU.
     kF64ToEf57 = 1,
   };
+  enum class Isa {
+    // The kernels of TransposeMicroKernel, vectorized for the instruction set
+    // of the build.
+    kGeneric = 0,
+
+    // The register-blocked kernels, selected at runtime.
+    kAvx2 = 1,
+    kAvx512 = 2,
+  };
 
   static StatusOr<std::unique_ptr<TransposePlan>> Create(
       size_t elem_size_in_bytes, absl::Span<int64_t const> dims,
@@ -93,7 +106,11 @@ class TransposePlan {
       std::variant<Tiling, Striding> input_layout = Tiling{},
       Tiling output_tiling = Tiling{},
       Transformation transformation = Transformation::kNone,
-      int num_threads = 1);
+      int num_threads = 1, Isa max_isa = Isa::kAvx512);
+
+  // Returns the widest instruction set with micro-kernels that the CPU
+  // supports.
+  static Isa SupportedIsa();
 
   TransposePlan();
   ~TransposePlan();
@@ -125,6 +142,9 @@ class TransposePlan {
   // Returns the number of items of parallel work in the plan.
   int Parallelism() const { return nodes_.size(); }
 
+  // Returns the instruction set of the micro-kernels of the plan.
+  Isa isa() const { return isa_; }
+
   struct Node;
 
  protected:
@@ -161,9 +181,13 @@ class TransposePlan {
   // The signature of ExecuteTyped uses char* pointers because we perform
   // address calculations with strides in bytes; the strides need not be
   // multiples of the element size.
-  template <typename T, Transformation transformation>
+  template <typename T, Transformation transformation, Isa isa>
   void ExecuteTyped(const char* a, char* b, absl::Span<Node const> nodes) const;
 
+  template <Isa isa>
+  void ExecuteForIsa(const char* a, char* b,
+                     absl::Span<Node const> nodes) const;
+
   // Number of threads requested.
   int num_threads_requested_ = 1;
 
@@ -229,6 +253,9 @@ class TransposePlan {
   int outer_block_elems_a_ = 4;
   int outer_block_elems_b_ = 4;
 
+  // Instruction set of the micro-kernels.
+  Isa isa_ = Isa::kGeneric;
+
   // Transformations to apply to the input before transposition.
   // Currently the only supported transformation is EF57 conversion, which is
   // a pair-of-floats extended precision representation used on TPU. We
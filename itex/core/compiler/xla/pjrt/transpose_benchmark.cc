@@ -0,0 +1,245 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Benchmarks TransposePlan over a sweep of shapes, permutations and element
+// sizes. Every transpose is run with the micro-kernels of each instruction set
+// the CPU supports (generic, AVX2, AVX-512) and reports its median GB/s,
+// counting the bytes read and written, next to the GB/s of a memcpy of the
+// same size, which bounds what a transpose can reach. The outputs of the
+// register-blocked kernels are checked against the generic ones.
+//
+// Usage: transpose_benchmark [--filter=0,2,1] [--elem_sizes=1,2,4,8]
+//                            [--min_time=0.2] [--num_threads=1]
+//
+// A "-" is printed for the instruction sets the CPU lacks, and "=generic"
+// when the plan falls back to the generic kernels because the stride-1
+// dimensions are smaller than the register-blocked ones.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_split.h"
+#include "itex/core/compiler/xla/pjrt/transpose.h"
+#include "itex/core/utils/command_line_flags.h"
+#include "itex/core/utils/env_time.h"
+
+namespace itex_xla {
+namespace {
+
+constexpr int kWarmupRuns = 2;
+constexpr size_t kMinRuns = 5;
+constexpr size_t kMaxRuns = 10000;
+
+struct TransposeCase {
+  std::vector<int64_t> dims;
+  std::vector<int64_t> permutation;
+};
+
+// Matrix transposes, the layout changes between NHWC and NCHW, and inner
+// dimensions too small for the register-blocked kernels. The shapes are in
+// elements, so the 8-byte cases move 8 times the bytes of the 1-byte ones.
+std::vector<TransposeCase> Cases() {
+  return {
+      {{128, 128}, {1, 0}},
+      {{1024, 1024}, {1, 0}},
+      {{4096, 256}, {1, 0}},
+      {{37, 1021}, {1, 0}},
+      {{64, 128, 256}, {0, 2, 1}},
+      {{64, 128, 256}, {2, 1, 0}},
+      {{64, 128, 256}, {2, 0, 1}},
+      {{64, 128, 256}, {1, 0, 2}},
+      {{16, 56, 56, 64}, {0, 3, 1, 2}},
+      {{16, 64, 56, 56}, {0, 2, 3, 1}},
+      {{256, 256, 3}, {2, 0, 1}},
+  };
+}
+
+const char* IsaName(TransposePlan::Isa isa) {
+  switch (isa) {
+    case TransposePlan::Isa::kGeneric:
+      return "generic";
+    case TransposePlan::Isa::kAvx2:
+      return "avx2";
+    case TransposePlan::Isa::kAvx512:
+      return "avx512";
+  }
+  return "unknown";
+}
+
+// Returns the median time of "fn" in seconds.
+double MedianSeconds(const std::function<void()>& fn, float min_time) {
+  for (int i = 0; i < kWarmupRuns; ++i) fn();
+  std::vector<double> secs;
+  const uint64_t start = itex::EnvTime::NowNanos();
+  const uint64_t min_nanos = static_cast<uint64_t>(min_time * 1e9);
+  while (secs.size() < kMinRuns ||
+         (itex::EnvTime::NowNanos() - start < min_nanos &&
+          secs.size() < kMaxRuns)) {
+    const uint64_t run_start = itex::EnvTime::NowNanos();
+    fn();
+    secs.push_back((itex::EnvTime::NowNanos() - run_start) / 1e9);
+  }
+  std::sort(secs.begin(), secs.end());
+  return secs[secs.size() / 2];
+}
+
+// Runs each piece of work of a plan on a thread of its own.
+void ScheduleOnThreads(std::function<void(void)> work) {
+  std::thread(std::move(work)).detach();
+}
+
+int Main(int argc, char** argv) {
+  std::string filter;
+  std::string elem_sizes = "1,2,4,8";
+  float min_time = 0.2;
+  int32_t num_threads = 1;
+  std::vector<itex::Flag> flag_list = {
+      itex::Flag("filter", &filter,
+                 "Only run the cases whose name contains this."),
+      itex::Flag("elem_sizes", &elem_sizes,
+                 "Comma separated element sizes in bytes to sweep."),
+      itex::Flag("min_time", &min_time, "Minimum seconds to run each case."),
+      itex::Flag("num_threads", &num_threads,
+                 "Threads of the plans, and of the memcpy reference."),
+  };
+  const std::string usage = itex::Flags::Usage(argv[0], flag_list);
+  if (!itex::Flags::Parse(&argc, argv, flag_list) || argc != 1 ||
+      num_threads < 1) {
+    std::fprintf(stderr, "%s", usage.c_str());
+    return 2;
+  }
+
+  const std::vector<TransposePlan::Isa> isas = {TransposePlan::Isa::kGeneric,
+                                                TransposePlan::Isa::kAvx2,
+                                                TransposePlan::Isa::kAvx512};
+  const TransposePlan::Isa supported = TransposePlan::SupportedIsa();
+  std::printf("CPU micro-kernels: %s\n", IsaName(supported));
+  std::printf("%-40s %8s %9s %9s %9s %8s %7s\n", "case (GB/s)", "memcpy",
+              "generic", "avx2", "avx512", "speedup", "%memcpy");
+
+  std::mt19937 rng(301);
+  int failures = 0;
+  for (absl::string_view size_str : absl::StrSplit(elem_sizes, ',')) {
+    int elem_size;
+    if (!absl::SimpleAtoi(size_str, &elem_size)) {
+      std::fprintf(stderr, "Invalid element size %s\n",
+                   std::string(size_str).c_str());
+      return 2;
+    }
+    for (const TransposeCase& c : Cases()) {
+      const std::string name =
+          absl::StrCat("[", absl::StrJoin(c.dims, ","), "] perm=",
+                       absl::StrJoin(c.permutation, ","), " x", elem_size, "B");
+      if (!absl::StrContains(name, filter)) continue;
+      int64_t num_elems = 1;
+      for (int64_t d : c.dims) num_elems *= d;
+      const size_t num_bytes = num_elems * elem_size;
+      // Bytes read and written.
+      const double gbytes = 2.0 * num_bytes / 1e9;
+
+      std::vector<char> input(num_bytes);
+      for (char& x : input) x = static_cast<char>(rng());
+      std::vector<char> expected(num_bytes);
+      std::vector<char> output(num_bytes);
+
+      const int64_t chunk = (num_bytes + num_threads - 1) / num_threads;
+      const double memcpy_secs = MedianSeconds(
+          [&] {
+            std::vector<std::thread> threads;
+            for (int t = 1; t < num_threads; ++t) {
+              const int64_t begin = std::min<int64_t>(t * chunk, num_bytes);
+              const int64_t end = std::min<int64_t>(begin + chunk, num_bytes);
+              threads.emplace_back([&, begin, end] {
+                std::memcpy(output.data() + begin, input.data() + begin,
+                            end - begin);
+              });
+            }
+            std::memcpy(output.data(), input.data(),
+                        std::min<int64_t>(chunk, num_bytes));
+            for (std::thread& thread : threads) thread.join();
+          },
+          min_time);
+
+      std::string row;
+      double generic_rate = 0;
+      double best_rate = 0;
+      for (TransposePlan::Isa isa : isas) {
+        if (isa > supported) {
+          absl::StrAppend(&row, absl::StrFormat(" %9s", "-"));
+          continue;
+        }
+        auto plan_or = TransposePlan::Create(
+            elem_size, c.dims, c.permutation, TransposePlan::Tiling{},
+            TransposePlan::Tiling{}, TransposePlan::Transformation::kNone,
+            num_threads, isa);
+        if (!plan_or.ok()) {
+          std::fprintf(stderr, "%s failed: %s\n", name.c_str(),
+                       plan_or.status().ToString().c_str());
+          ++failures;
+          break;
+        }
+        const TransposePlan& plan = **plan_or;
+        if (isa != TransposePlan::Isa::kGeneric &&
+            plan.isa() == TransposePlan::Isa::kGeneric) {
+          absl::StrAppend(&row, absl::StrFormat(" %9s", "=generic"));
+          continue;
+        }
+        std::fill(output.begin(), output.end(), 0);
+        const double secs = MedianSeconds(
+            [&] {
+              if (plan.Parallelism() > 1) {
+                plan.Execute(input.data(), output.data(), ScheduleOnThreads);
+              } else {
+                plan.Execute(input.data(), output.data());
+              }
+            },
+            min_time);
+        if (isa == TransposePlan::Isa::kGeneric) {
+          expected = output;
+        } else if (output != expected) {
+          std::fprintf(stderr, "%s: the %s output differs from generic\n",
+                       name.c_str(), IsaName(isa));
+          ++failures;
+        }
+        const double rate = gbytes / secs;
+        if (isa == TransposePlan::Isa::kGeneric) generic_rate = rate;
+        best_rate = std::max(best_rate, rate);
+        absl::StrAppend(&row, absl::StrFormat(" %9.2f", rate));
+      }
+      const double memcpy_rate = gbytes / memcpy_secs;
+      std::printf("%-40s %8.2f%s %7.2fx %6.1f%%\n", name.c_str(), memcpy_rate,
+                  row.c_str(), generic_rate > 0 ? best_rate / generic_rate : 0,
+                  100 * best_rate / memcpy_rate);
+    }
+  }
+  return failures > 0 ? 1 : 0;
+}
+
+}  // namespace
+}  // namespace itex_xla
+
+int main(int argc, char** argv) { return itex_xla::Main(argc, argv); }
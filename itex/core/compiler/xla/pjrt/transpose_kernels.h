@@ -22,6 +22,20 @@ limitations under the License.
 
 #include "third_party/eigen3/Eigen/Core"
 
+// The AVX2 and AVX-512 kernels are compiled with a target attribute rather
+// than with the flags of the build, and TransposePlan selects them at runtime
+// on the CPUs which support them.
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define ITEX_XLA_HAVE_ISA_TRANSPOSE_KERNELS 1
+#define ITEX_XLA_TARGET_AVX2 __attribute__((target("avx2")))
+#define ITEX_XLA_TARGET_AVX512 \
+  __attribute__((target("avx2,avx512f,avx512bw,avx512vl")))
+#else
+#define ITEX_XLA_TARGET_AVX2
+#define ITEX_XLA_TARGET_AVX512
+#endif
+
 namespace itex_xla {
 
 // Generic transpose kernel.
@@ -289,6 +303,522 @@ struct TransposeMicroKernel<uint64_t, /*bs=*/4> {
 
 #endif  // EIGEN_VECTORIZE_AVX
 
+// Register-blocked kernels for AVX2 and AVX-512, with the same contract as
+// TransposeMicroKernel. Each block is loaded into registers, transposed with
+// in-register shuffles and stored, so a bs x bs block costs bs loads and bs
+// stores of a row. The block sizes without a specialization fall back to the
+// kernels of the narrower ISA, and eventually to TransposeMicroKernel.
+template <typename T, int bs>
+struct Avx2TransposeMicroKernel : TransposeMicroKernel<T, bs> {};
+
+template <typename T, int bs>
+struct Avx512TransposeMicroKernel : Avx2TransposeMicroKernel<T, bs> {};
+
+#ifdef ITEX_XLA_HAVE_ISA_TRANSPOSE_KERNELS
+
+template <>
+struct Avx2TransposeMicroKernel<uint8_t, /*bs=*/8> {
+  ITEX_XLA_TARGET_AVX2 static void Apply(const char* __restrict a,
+                                         int64_t lda, char* __restrict b,
+                                         int64_t ldb) {
+    __m128i packet[8];
+    for (int i = 0; i < 8; ++i) {
+      packet[i] =
+          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(a + lda * i));
+    }
+    // 00 10 01 11 02 12 ... 07 17
+    __m128i t0 = _mm_unpacklo_epi8(packet[0], packet[1]);
+    __m128i t1 = _mm_unpacklo_epi8(packet[2], packet[3]);
+    __m128i t2 = _mm_unpacklo_epi8(packet[4], packet[5]);
+    __m128i t3 = _mm_unpacklo_epi8(packet[6], packet[7]);
+    // 00 10 20 30 01 11 21 31 ... 03 13 23 33
+    __m128i s0 = _mm_unpacklo_epi16(t0, t1);
+    __m128i s1 = _mm_unpackhi_epi16(t0, t1);  // 04 14 24 34 ...
+    __m128i s2 = _mm_unpacklo_epi16(t2, t3);  // 40 50 60 70 ...
+    __m128i s3 = _mm_unpackhi_epi16(t2, t3);  // 44 54 64 74 ...
+    // 00 10 20 30 40 50 60 70 01 11 21 31 41 51 61 71
+    packet[0] = _mm_unpacklo_epi32(s0, s2);
+    packet[2] = _mm_unpackhi_epi32(s0, s2);
+    packet[4] = _mm_unpacklo_epi32(s1, s3);
+    packet[6] = _mm_unpackhi_epi32(s1, s3);
+    for (int i = 0; i < 8; i += 2) {
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(b + ldb * i), packet[i]);
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(b + ldb * (i + 1)),
+                       _mm_unpackhi_epi64(packet[i], packet[i]));
+    }
+  }
+};
+
+// Rows i and i + 8 share a register, so that the 128-bit lanes transpose the
+// two 8x16 halves of the block in parallel.
+template <>
+struct Avx2TransposeMicroKernel<uint8_t, /*bs=*/16> {
+  ITEX_XLA_TARGET_AVX2 static void Apply(const char* __restrict a,
+                                         int64_t lda, char* __restrict b,
+                                         int64_t ldb) {
+    __m256i packet[8];
+    for (int i = 0; i < 8; ++i) {
+      packet[i] = _mm256_inserti128_si256(
+          _mm256_castsi128_si256(
+              _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + lda * i))),
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + lda * (i + 8))),
+          1);
+    }
+    // Columns 0-7 and 8-15 of rows 0 and 1, in each lane.
+    __m256i t0 = _mm256_unpacklo_epi8(packet[0], packet[1]);
+    __m256i t1 = _mm256_unpackhi_epi8(packet[0], packet[1]);
+    __m256i t2 = _mm256_unpacklo_epi8(packet[2], packet[3]);
+    __m256i t3 = _mm256_unpackhi_epi8(packet[2], packet[3]);
+    __m256i t4 = _mm256_unpacklo_epi8(packet[4], packet[5]);
+    __m256i t5 = _mm256_unpackhi_epi8(packet[4], packet[5]);
+    __m256i t6 = _mm256_unpacklo_epi8(packet[6], packet[7]);
+    __m256i t7 = _mm256_unpackhi_epi8(packet[6], packet[7]);
+    // Columns 0-3, 4-7, 8-11 and 12-15 of rows 0-3, then of rows 4-7.
+    __m256i s0 = _mm256_unpacklo_epi16(t0, t2);
+    __m256i s1 = _mm256_unpackhi_epi16(t0, t2);
+    __m256i s2 = _mm256_unpacklo_epi16(t1, t3);
+    __m256i s3 = _mm256_unpackhi_epi16(t1, t3);
+    __m256i s4 = _mm256_unpacklo_epi16(t4, t6);
+    __m256i s5 = _mm256_unpackhi_epi16(t4, t6);
+    __m256i s6 = _mm256_unpacklo_epi16(t5, t7);
+    __m256i s7 = _mm256_unpackhi_epi16(t5, t7);
+    // Columns 2i and 2i + 1 of rows 0-7 in the low lane, and of rows 8-15 in
+    // the high lane.
+    packet[0] = _mm256_unpacklo_epi32(s0, s4);
+    packet[1] = _mm256_unpackhi_epi32(s0, s4);
+    packet[2] = _mm256_unpacklo_epi32(s1, s5);
+    packet[3] = _mm256_unpackhi_epi32(s1, s5);
+    packet[4] = _mm256_unpacklo_epi32(s2, s6);
+    packet[5] = _mm256_unpackhi_epi32(s2, s6);
+    packet[6] = _mm256_unpacklo_epi32(s3, s7);
+    packet[7] = _mm256_unpackhi_epi32(s3, s7);
+    for (int i = 0; i < 8; ++i) {
+      // Output rows 2i and 2i + 1.
+      __m256i rows = _mm256_permute4x64_epi64(packet[i], 0xd8);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(b + ldb * (2 * i)),
+                       _mm256_castsi256_si128(rows));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(b + ldb * (2 * i + 1)),
+                       _mm256_extracti128_si256(rows, 1));
+    }
+  }
+};
+
+template <>
+struct Avx2TransposeMicroKernel<uint16_t, /*bs=*/8> {
+  ITEX_XLA_TARGET_AVX2 static void Apply(const char* __restrict a,
+                                         int64_t lda, char* __restrict b,
+                                         int64_t ldb) {
+    __m128i packet[8];
+    for (int i = 0; i < 8; ++i) {
+      packet[i] =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + lda * i));
+    }
+    // Columns 0-3, then 4-7, of rows 0 and 1.
+    __m128i t0 = _mm_unpacklo_epi16(packet[0], packet[1]);
+    __m128i t1 = _mm_unpackhi_epi16(packet[0], packet[1]);
+    __m128i t2 = _mm_unpacklo_epi16(packet[2], packet[3]);
+    __m128i t3 = _mm_unpackhi_epi16(packet[2], packet[3]);
+    __m128i t4 = _mm_unpacklo_epi16(packet[4], packet[5]);
+    __m128i t5 = _mm_unpackhi_epi16(packet[4], packet[5]);
+    __m128i t6 = _mm_unpacklo_epi16(packet[6], packet[7]);
+    __m128i t7 = _mm_unpackhi_epi16(packet[6], packet[7]);
+    // Columns 0-1, 2-3, 4-5 and 6-7 of rows 0-3, then of rows 4-7.
+    __m128i s0 = _mm_unpacklo_epi32(t0, t2);
+    __m128i s1 = _mm_unpackhi_epi32(t0, t2);
+    __m128i s2 = _mm_unpacklo_epi32(t1, t3);
+    __m128i s3 = _mm_unpackhi_epi32(t1, t3);
+    __m128i s4 = _mm_unpacklo_epi32(t4, t6);
+    __m128i s5 = _mm_unpackhi_epi32(t4, t6);
+    __m128i s6 = _mm_unpacklo_epi32(t5, t7);
+    __m128i s7 = _mm_unpackhi_epi32(t5, t7);
+    packet[0] = _mm_unpacklo_epi64(s0, s4);
+    packet[1] = _mm_unpackhi_epi64(s0, s4);
+    packet[2] = _mm_unpacklo_epi64(s1, s5);
+    packet[3] = _mm_unpackhi_epi64(s1, s5);
+    packet[4] = _mm_unpacklo_epi64(s2, s6);
+    packet[5] = _mm_unpackhi_epi64(s2, s6);
+    packet[6] = _mm_unpacklo_epi64(s3, s7);
+    packet[7] = _mm_unpackhi_epi64(s3, s7);
+    for (int i = 0; i < 8; ++i) {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(b + ldb * i), packet[i]);
+    }
+  }
+};
+
+// Transposes the 8x8 blocks of 16-bit elements in each 128-bit lane of
+// "packet".
+ITEX_XLA_TARGET_AVX2 inline void TransposeLanes8x8x16(__m256i* packet) {
+  __m256i t0 = _mm256_unpacklo_epi16(packet[0], packet[1]);
+  __m256i t1 = _mm256_unpackhi_epi16(packet[0], packet[1]);
+  __m256i t2 = _mm256_unpacklo_epi16(packet[2], packet[3]);
+  __m256i t3 = _mm256_unpackhi_epi16(packet[2], packet[3]);
+  __m256i t4 = _mm256_unpacklo_epi16(packet[4], packet[5]);
+  __m256i t5 = _mm256_unpackhi_epi16(packet[4], packet[5]);
+  __m256i t6 = _mm256_unpacklo_epi16(packet[6], packet[7]);
+  __m256i t7 = _mm256_unpackhi_epi16(packet[6], packet[7]);
+  // Columns 0-1, 2-3, 4-5 and 6-7 of rows 0-3, then of rows 4-7.
+  __m256i s0 = _mm256_unpacklo_epi32(t0, t2);
+  __m256i s1 = _mm256_unpackhi_epi32(t0, t2);
+  __m256i s2 = _mm256_unpacklo_epi32(t1, t3);
+  __m256i s3 = _mm256_unpackhi_epi32(t1, t3);
+  __m256i s4 = _mm256_unpacklo_epi32(t4, t6);
+  __m256i s5 = _mm256_unpackhi_epi32(t4, t6);
+  __m256i s6 = _mm256_unpacklo_epi32(t5, t7);
+  __m256i s7 = _mm256_unpackhi_epi32(t5, t7);
+  packet[0] = _mm256_unpacklo_epi64(s0, s4);
+  packet[1] = _mm256_unpackhi_epi64(s0, s4);
+  packet[2] = _mm256_unpacklo_epi64(s1, s5);
+  packet[3] = _mm256_unpackhi_epi64(s1, s5);
+  packet[4] = _mm256_unpacklo_epi64(s2, s6);
+  packet[5] = _mm256_unpackhi_epi64(s2, s6);
+  packet[6] = _mm256_unpacklo_epi64(s3, s7);
+  packet[7] = _mm256_unpackhi_epi64(s3, s7);
+}
+
+// Each row is a register. The lanes transpose the four 8x8 quarters of the
+// block, which are then swapped across lanes.
+template <>
+struct Avx2TransposeMicroKernel<uint16_t, /*bs=*/16> {
+  ITEX_XLA_TARGET_AVX2 static void Apply(const char* __restrict a,
+                                         int64_t lda, char* __restrict b,
+                                         int64_t ldb) {
+    __m256i packet[16];
+    for (int i = 0; i < 16; ++i) {
+      packet[i] =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + lda * i));
+    }
+    TransposeLanes8x8x16(packet);
+    TransposeLanes8x8x16(packet + 8);
+    for (int i = 0; i < 8; ++i) {
+      _mm256_storeu_si256(
+          reinterpret_cast<__m256i*>(b + ldb * i),
+          _mm256_permute2x128_si256(packet[i], packet[i + 8], 0x20));
+      _mm256_storeu_si256(
+          reinterpret_cast<__m256i*>(b + ldb * (i + 8)),
+          _mm256_permute2x128_si256(packet[i], packet[i + 8], 0x31));
+    }
+  }
+};
+
+template <>
+struct Avx2TransposeMicroKernel<uint32_t, /*bs=*/8> {
+  ITEX_XLA_TARGET_AVX2 static void Apply(const char* __restrict a,
+                                         int64_t lda, char* __restrict b,
+                                         int64_t ldb) {
+    __m256 packet[8];
+    for (int i = 0; i < 8; ++i) {
+      packet[i] = _mm256_loadu_ps(reinterpret_cast<const float*>(a + lda * i));
+    }
+    __m256 t0 = _mm256_unpacklo_ps(packet[0], packet[1]);
+    __m256 t1 = _mm256_unpackhi_ps(packet[0], packet[1]);
+    __m256 t2 = _mm256_unpacklo_ps(packet[2], packet[3]);
+    __m256 t3 = _mm256_unpackhi_ps(packet[2], packet[3]);
+    __m256 t4 = _mm256_unpacklo_ps(packet[4], packet[5]);
+    __m256 t5 = _mm256_unpackhi_ps(packet[4], packet[5]);
+    __m256 t6 = _mm256_unpacklo_ps(packet[6], packet[7]);
+    __m256 t7 = _mm256_unpackhi_ps(packet[6], packet[7]);
+    // Columns i and i + 4 of rows 0-3, then of rows 4-7.
+    __m256 s0 = _mm256_shuffle_ps(t0, t2, 0x44);
+    __m256 s1 = _mm256_shuffle_ps(t0, t2, 0xee);
+    __m256 s2 = _mm256_shuffle_ps(t1, t3, 0x44);
+    __m256 s3 = _mm256_shuffle_ps(t1, t3, 0xee);
+    __m256 s4 = _mm256_shuffle_ps(t4, t6, 0x44);
+    __m256 s5 = _mm256_shuffle_ps(t4, t6, 0xee);
+    __m256 s6 = _mm256_shuffle_ps(t5, t7, 0x44);
+    __m256 s7 = _mm256_shuffle_ps(t5, t7, 0xee);
+    packet[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+    packet[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+    packet[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+    packet[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+    packet[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+    packet[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+    packet[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+    packet[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+    for (int i = 0; i < 8; ++i) {
+      _mm256_storeu_ps(reinterpret_cast<float*>(b + ldb * i), packet[i]);
+    }
+  }
+};
+
+template <>
+struct Avx2TransposeMicroKernel<uint64_t, /*bs=*/4> {
+  ITEX_XLA_TARGET_AVX2 static void Apply(const char* __restrict a,
+                                         int64_t lda, char* __restrict b,
+                                         int64_t ldb) {
+    __m256i packet[4];
+    for (int i = 0; i < 4; ++i) {
+      packet[i] =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + lda * i));
+    }
+    // 00 10 02 12
+    __m256i t0 = _mm256_unpacklo_epi64(packet[0], packet[1]);
+    // 01 11 03 13
+    __m256i t1 = _mm256_unpackhi_epi64(packet[0], packet[1]);
+    __m256i t2 = _mm256_unpacklo_epi64(packet[2], packet[3]);
+    __m256i t3 = _mm256_unpackhi_epi64(packet[2], packet[3]);
+    packet[0] = _mm256_permute2x128_si256(t0, t2, 0x20);
+    packet[1] = _mm256_permute2x128_si256(t1, t3, 0x20);
+    packet[2] = _mm256_permute2x128_si256(t0, t2, 0x31);
+    packet[3] = _mm256_permute2x128_si256(t1, t3, 0x31);
+    for (int i = 0; i < 4; ++i) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(b + ldb * i), packet[i]);
+    }
+  }
+};
+
+// Applies the kernel bs x bs to the four quarters of a 2bs x 2bs block.
+template <typename Kernel, typename T, int bs>
+struct QuarterTransposeMicroKernel {
+  static void Apply(const char* __restrict a, int64_t lda, char* __restrict b,
+                    int64_t ldb) {
+    for (int i = 0; i < 2; ++i) {
+      for (int j = 0; j < 2; ++j) {
+        Kernel::Apply(a + bs * j * lda + i * bs * sizeof(T), lda,
+                      b + bs * i * ldb + j * bs * sizeof(T), ldb);
+      }
+    }
+  }
+};
+
+template <>
+struct Avx2TransposeMicroKernel<uint32_t, /*bs=*/16> {
+  ITEX_XLA_TARGET_AVX2 static void Apply(const char* __restrict a,
+                                         int64_t lda, char* __restrict b,
+                                         int64_t ldb) {
+    QuarterTransposeMicroKernel<Avx2TransposeMicroKernel<uint32_t, 8>,
+                                uint32_t, 8>::Apply(a, lda, b, ldb);
+  }
+};
+
+template <>
+struct Avx2TransposeMicroKernel<uint64_t, /*bs=*/8> {
+  ITEX_XLA_TARGET_AVX2 static void Apply(const char* __restrict a,
+                                         int64_t lda, char* __restrict b,
+                                         int64_t ldb) {
+    QuarterTransposeMicroKernel<Avx2TransposeMicroKernel<uint64_t, 4>,
+                                uint64_t, 4>::Apply(a, lda, b, ldb);
+  }
+};
+
+// Completes the 16x16 32-bit and 8x8 64-bit kernels. Their in-lane unpacks
+// leave the rows of group r of column l * stride + c in lane l of
+// packet[r * stride + c]. The four groups of each column are gathered into
+// packet[l * stride + c], which is then output row l * stride + c.
+ITEX_XLA_TARGET_AVX512 inline void TransposeLanes4x4(__m512i* packet,
+                                                     int stride) {
+  for (int c = 0; c < stride; ++c) {
+    __m512i* p = packet + c;
+    __m512i u = _mm512_shuffle_i64x2(p[0], p[stride], 0x88);
+    __m512i v = _mm512_shuffle_i64x2(p[0], p[stride], 0xdd);
+    __m512i w = _mm512_shuffle_i64x2(p[2 * stride], p[3 * stride], 0x88);
+    __m512i x = _mm512_shuffle_i64x2(p[2 * stride], p[3 * stride], 0xdd);
+    p[0] = _mm512_shuffle_i64x2(u, w, 0x88);
+    p[stride] = _mm512_shuffle_i64x2(v, x, 0x88);
+    p[2 * stride] = _mm512_shuffle_i64x2(u, w, 0xdd);
+    p[3 * stride] = _mm512_shuffle_i64x2(v, x, 0xdd);
+  }
+}
+
+// Rows i, i + 4, i + 8 and i + 12 share a register. The in-lane unpacks leave
+// columns 4k to 4k + 3 of rows 4l to 4l + 3 in lane l of t[k], one column per
+// 32-bit element, and a permutation of the 32-bit elements makes lane j of
+// t[k] output row 4k + j.
+template <>
+struct Avx512TransposeMicroKernel<uint8_t, /*bs=*/16> {
+  ITEX_XLA_TARGET_AVX512 static void Apply(const char* __restrict a,
+                                           int64_t lda, char* __restrict b,
+                                           int64_t ldb) {
+    __m512i packet[4];
+    for (int i = 0; i < 4; ++i) {
+      __m512i rows = _mm512_castsi128_si512(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + lda * i)));
+      rows = _mm512_inserti32x4(
+          rows,
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + lda * (i + 4))),
+          1);
+      rows = _mm512_inserti32x4(
+          rows,
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + lda * (i + 8))),
+          2);
+      packet[i] = _mm512_inserti32x4(
+          rows,
+          _mm_loadu_si128(
+              reinterpret_cast<const __m128i*>(a + lda * (i + 12))),
+          3);
+    }
+    // Columns 0-7, then 8-15, of rows 4l and 4l + 1.
+    __m512i s0 = _mm512_unpacklo_epi8(packet[0], packet[1]);
+    __m512i s1 = _mm512_unpackhi_epi8(packet[0], packet[1]);
+    __m512i s2 = _mm512_unpacklo_epi8(packet[2], packet[3]);
+    __m512i s3 = _mm512_unpackhi_epi8(packet[2], packet[3]);
+    __m512i t[4];
+    t[0] = _mm512_unpacklo_epi16(s0, s2);
+    t[1] = _mm512_unpackhi_epi16(s0, s2);
+    t[2] = _mm512_unpacklo_epi16(s1, s3);
+    t[3] = _mm512_unpackhi_epi16(s1, s3);
+    const __m512i transpose4x4 = _mm512_set_epi32(15, 11, 7, 3, 14, 10, 6, 2,
+                                                  13, 9, 5, 1, 12, 8, 4, 0);
+    for (int k = 0; k < 4; ++k) {
+      __m512i rows = _mm512_permutexvar_epi32(transpose4x4, t[k]);
+      char* row = b + ldb * (4 * k);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(row),
+                       _mm512_castsi512_si128(rows));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(row + ldb),
+                       _mm512_extracti32x4_epi32(rows, 1));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(row + 2 * ldb),
+                       _mm512_extracti32x4_epi32(rows, 2));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(row + 3 * ldb),
+                       _mm512_extracti32x4_epi32(rows, 3));
+    }
+  }
+};
+
+// Rows i and i + 8 share a register. The lanes transpose the four 8x8
+// quarters of the block at once, which leaves output row i in lanes 0 and 2 of
+// packet[i] and output row i + 8 in lanes 1 and 3.
+template <>
+struct Avx512TransposeMicroKernel<uint16_t, /*bs=*/16> {
+  ITEX_XLA_TARGET_AVX512 static void Apply(const char* __restrict a,
+                                           int64_t lda, char* __restrict b,
+                                           int64_t ldb) {
+    __m512i packet[8];
+    for (int i = 0; i < 8; ++i) {
+      packet[i] = _mm512_inserti64x4(
+          _mm512_castsi256_si512(_mm256_loadu_si256(
+              reinterpret_cast<const __m256i*>(a + lda * i))),
+          _mm256_loadu_si256(
+              reinterpret_cast<const __m256i*>(a + lda * (i + 8))),
+          1);
+    }
+    __m512i t0 = _mm512_unpacklo_epi16(packet[0], packet[1]);
+    __m512i t1 = _mm512_unpackhi_epi16(packet[0], packet[1]);
+    __m512i t2 = _mm512_unpacklo_epi16(packet[2], packet[3]);
+    __m512i t3 = _mm512_unpackhi_epi16(packet[2], packet[3]);
+    __m512i t4 = _mm512_unpacklo_epi16(packet[4], packet[5]);
+    __m512i t5 = _mm512_unpackhi_epi16(packet[4], packet[5]);
+    __m512i t6 = _mm512_unpacklo_epi16(packet[6], packet[7]);
+    __m512i t7 = _mm512_unpackhi_epi16(packet[6], packet[7]);
+    __m512i s0 = _mm512_unpacklo_epi32(t0, t2);
+    __m512i s1 = _mm512_unpackhi_epi32(t0, t2);
+    __m512i s2 = _mm512_unpacklo_epi32(t1, t3);
+    __m512i s3 = _mm512_unpackhi_epi32(t1, t3);
+    __m512i s4 = _mm512_unpacklo_epi32(t4, t6);
+    __m512i s5 = _mm512_unpackhi_epi32(t4, t6);
+    __m512i s6 = _mm512_unpacklo_epi32(t5, t7);
+    __m512i s7 = _mm512_unpackhi_epi32(t5, t7);
+    packet[0] = _mm512_unpacklo_epi64(s0, s4);
+    packet[1] = _mm512_unpackhi_epi64(s0, s4);
+    packet[2] = _mm512_unpacklo_epi64(s1, s5);
+    packet[3] = _mm512_unpackhi_epi64(s1, s5);
+    packet[4] = _mm512_unpacklo_epi64(s2, s6);
+    packet[5] = _mm512_unpackhi_epi64(s2, s6);
+    packet[6] = _mm512_unpacklo_epi64(s3, s7);
+    packet[7] = _mm512_unpackhi_epi64(s3, s7);
+    const __m512i swap_lanes = _mm512_set_epi64(7, 6, 3, 2, 5, 4, 1, 0);
+    for (int i = 0; i < 8; ++i) {
+      __m512i rows = _mm512_permutexvar_epi64(swap_lanes, packet[i]);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(b + ldb * i),
+                          _mm512_castsi512_si256(rows));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(b + ldb * (i + 8)),
+                          _mm512_extracti64x4_epi64(rows, 1));
+    }
+  }
+};
+
+template <>
+struct Avx512TransposeMicroKernel<uint32_t, /*bs=*/16> {
+  ITEX_XLA_TARGET_AVX512 static void Apply(const char* __restrict a,
+                                           int64_t lda, char* __restrict b,
+                                           int64_t ldb) {
+    __m512i packet[16];
+    for (int i = 0; i < 16; ++i) {
+      packet[i] = _mm512_loadu_si512(a + lda * i);
+    }
+    __m512i t[16];
+    for (int i = 0; i < 16; i += 2) {
+      t[i] = _mm512_unpacklo_epi32(packet[i], packet[i + 1]);
+      t[i + 1] = _mm512_unpackhi_epi32(packet[i], packet[i + 1]);
+    }
+    // Lane l of packet[4 * r + c] holds rows 4r to 4r + 3 of column 4l + c.
+    for (int r = 0; r < 16; r += 4) {
+      packet[r] = _mm512_unpacklo_epi64(t[r], t[r + 2]);
+      packet[r + 1] = _mm512_unpackhi_epi64(t[r], t[r + 2]);
+      packet[r + 2] = _mm512_unpacklo_epi64(t[r + 1], t[r + 3]);
+      packet[r + 3] = _mm512_unpackhi_epi64(t[r + 1], t[r + 3]);
+    }
+    TransposeLanes4x4(packet, 4);
+    for (int i = 0; i < 16; ++i) {
+      _mm512_storeu_si512(b + ldb * i, packet[i]);
+    }
+  }
+};
+
+template <>
+struct Avx512TransposeMicroKernel<uint64_t, /*bs=*/8> {
+  ITEX_XLA_TARGET_AVX512 static void Apply(const char* __restrict a,
+                                           int64_t lda, char* __restrict b,
+                                           int64_t ldb) {
+    __m512i packet[8];
+    __m512i t[8];
+    for (int i = 0; i < 8; ++i) {
+      t[i] = _mm512_loadu_si512(a + lda * i);
+    }
+    // Lane l of packet[2 * r + c] holds rows 2r and 2r + 1 of column 2l + c.
+    for (int r = 0; r < 8; r += 2) {
+      packet[r] = _mm512_unpacklo_epi64(t[r], t[r + 1]);
+      packet[r + 1] = _mm512_unpackhi_epi64(t[r], t[r + 1]);
+    }
+    TransposeLanes4x4(packet, 2);
+    for (int i = 0; i < 8; ++i) {
+      _mm512_storeu_si512(b + ldb * i, packet[i]);
+    }
+  }
+};
+
+template <>
+struct Avx512TransposeMicroKernel<uint64_t, /*bs=*/16> {
+  ITEX_XLA_TARGET_AVX512 static void Apply(const char* __restrict a,
+                                           int64_t lda, char* __restrict b,
+                                           int64_t ldb) {
+    QuarterTransposeMicroKernel<Avx512TransposeMicroKernel<uint64_t, 8>,
+                                uint64_t, 8>::Apply(a, lda, b, ldb);
+  }
+};
+
+#endif  // ITEX_XLA_HAVE_ISA_TRANSPOSE_KERNELS
+
+// Applies the micro-kernel to the outer_bs_a x outer_bs_b blocks of a
+// macro-kernel. The loop is compiled for the ISA of the kernel, so that the
+// kernel is inlined into it.
+template <typename T, int bs>
+ITEX_XLA_TARGET_AVX2 void Avx2TransposeBlocks(const char* __restrict a,
+                                              int64_t lda, int outer_bs_a,
+                                              char* __restrict b, int64_t ldb,
+                                              int outer_bs_b) {
+  for (int i = 0; i < outer_bs_a; ++i) {
+    for (int j = 0; j < outer_bs_b; ++j) {
+      Avx2TransposeMicroKernel<T, bs>::Apply(
+          a + bs * j * lda + i * bs * sizeof(T), lda,
+          b + bs * i * ldb + j * bs * sizeof(T), ldb);
+    }
+  }
+}
+
+template <typename T, int bs>
+ITEX_XLA_TARGET_AVX512 void Avx512TransposeBlocks(const char* __restrict a,
+                                                  int64_t lda, int outer_bs_a,
+                                                  char* __restrict b,
+                                                  int64_t ldb,
+                                                  int outer_bs_b) {
+  for (int i = 0; i < outer_bs_a; ++i) {
+    for (int j = 0; j < outer_bs_b; ++j) {
+      Avx512TransposeMicroKernel<T, bs>::Apply(
+          a + bs * j * lda + i * bs * sizeof(T), lda,
+          b + bs * i * ldb + j * bs * sizeof(T), ldb);
+    }
+  }
+}
+
 }  // namespace itex_xla
 
 #endif  // ITEX_CORE_COMPILER_XLA_PJRT_TRANSPOSE_KERNELS_H_
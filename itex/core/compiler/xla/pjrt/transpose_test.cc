@@ -0,0 +1,262 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Checks that the plans of every instruction set give the output of the
+// generic kernels, and that the plans choose the instruction set and inner
+// block size they are expected to. On CPUs without AVX2 or AVX-512 the plans
+// of those instruction sets are generic ones.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "itex/core/compiler/xla/pjrt/transpose.h"
+#include "itex/core/utils/logging.h"
+
+namespace itex_xla {
+namespace {
+
+using Isa = TransposePlan::Isa;
+
+constexpr Isa kIsas[] = {Isa::kGeneric, Isa::kAvx2, Isa::kAvx512};
+
+struct TransposeCase {
+  std::vector<int64_t> dims;
+  std::vector<int64_t> permutation;
+};
+
+// The cases of transpose_benchmark.
+std::vector<TransposeCase> BenchmarkCases() {
+  return {
+      {{128, 128}, {1, 0}},
+      {{1024, 1024}, {1, 0}},
+      {{4096, 256}, {1, 0}},
+      {{37, 1021}, {1, 0}},
+      {{64, 128, 256}, {0, 2, 1}},
+      {{64, 128, 256}, {2, 1, 0}},
+      {{64, 128, 256}, {2, 0, 1}},
+      {{64, 128, 256}, {1, 0, 2}},
+      {{16, 56, 56, 64}, {0, 3, 1, 2}},
+      {{16, 64, 56, 56}, {0, 2, 3, 1}},
+      {{256, 256, 3}, {2, 0, 1}},
+  };
+}
+
+// Sizes that are not multiples of any block size, that leave trailing
+// elements after the inner blocks of 16, or that are smaller than the
+// register-blocked kernels.
+std::vector<TransposeCase> OddCases() {
+  return {
+      {{1, 1}, {1, 0}},         {{3, 5}, {1, 0}},
+      {{7, 9}, {1, 0}},         {{17, 33}, {1, 0}},
+      {{19, 23}, {1, 0}},       {{31, 47}, {1, 0}},
+      {{16, 17}, {1, 0}},       {{33, 16}, {1, 0}},
+      {{65, 129}, {1, 0}},      {{130, 67}, {1, 0}},
+      {{9, 31, 7}, {2, 0, 1}},  {{5, 19, 33}, {0, 2, 1}},
+      {{17, 3, 35}, {2, 1, 0}}, {{2, 18, 3, 34}, {0, 3, 1, 2}},
+  };
+}
+
+std::string CaseName(const TransposeCase& c, int elem_size, Isa isa) {
+  return absl::StrCat("[", absl::StrJoin(c.dims, ","), "] perm=",
+                      absl::StrJoin(c.permutation, ","), " x", elem_size,
+                      "B isa=", static_cast<int>(isa));
+}
+
+// Transposes one element at a time.
+std::vector<char> NaiveTranspose(const std::vector<char>& input,
+                                 const TransposeCase& c, int elem_size) {
+  const int rank = c.dims.size();
+  std::vector<int64_t> input_strides(rank, 1);
+  for (int i = rank - 2; i >= 0; --i) {
+    input_strides[i] = input_strides[i + 1] * c.dims[i + 1];
+  }
+  std::vector<char> output(input.size());
+  std::vector<int64_t> index(rank, 0);
+  for (size_t out = 0; out < input.size() / elem_size; ++out) {
+    int64_t in = 0;
+    for (int i = 0; i < rank; ++i) {
+      in += index[i] * input_strides[c.permutation[i]];
+    }
+    std::memcpy(&output[out * elem_size], &input[in * elem_size], elem_size);
+    for (int i = rank - 1; i >= 0; --i) {
+      if (++index[i] < c.dims[c.permutation[i]]) break;
+      index[i] = 0;
+    }
+  }
+  return output;
+}
+
+std::unique_ptr<TransposePlan> CreatePlan(
+    const TransposeCase& c, int elem_size, Isa max_isa, int num_threads = 1,
+    TransposePlan::Transformation transformation =
+        TransposePlan::Transformation::kNone) {
+  auto plan_or = TransposePlan::Create(
+      elem_size, c.dims, c.permutation, TransposePlan::Tiling{},
+      TransposePlan::Tiling{}, transformation, num_threads, max_isa);
+  ITEX_CHECK(plan_or.ok()) << plan_or.status().ToString();
+  return std::move(plan_or).value();
+}
+
+std::vector<char> Execute(const TransposePlan& plan,
+                          const std::vector<char>& input) {
+  std::vector<char> output(input.size(), 0);
+  plan.Execute(input.data(), output.data(),
+               [](std::function<void(void)> work) { work(); });
+  return output;
+}
+
+void CheckPlanIsa(const TransposePlan& plan, Isa max_isa) {
+  ITEX_CHECK(plan.isa() <= std::min(max_isa, TransposePlan::SupportedIsa()))
+      << plan.ToString();
+}
+
+// Every instruction set gives the output of the generic kernels, which give
+// the output of a naive transpose, with one thread and with several.
+void TestMatchesGeneric() {
+  std::vector<TransposeCase> cases = BenchmarkCases();
+  for (const TransposeCase& c : OddCases()) cases.push_back(c);
+  std::mt19937 rng(301);
+  for (int elem_size : {1, 2, 4, 8, 16}) {
+    for (const TransposeCase& c : cases) {
+      int64_t num_elems = 1;
+      for (int64_t d : c.dims) num_elems *= d;
+      std::vector<char> input(num_elems * elem_size);
+      for (char& x : input) x = static_cast<char>(rng());
+      const std::vector<char> expected = NaiveTranspose(input, c, elem_size);
+      for (int num_threads : {1, 3}) {
+        std::vector<char> generic;
+        for (Isa isa : kIsas) {
+          auto plan = CreatePlan(c, elem_size, isa, num_threads);
+          CheckPlanIsa(*plan, isa);
+          const std::vector<char> output = Execute(*plan, input);
+          if (isa == Isa::kGeneric) {
+            ITEX_CHECK(output == expected) << CaseName(c, elem_size, isa);
+            generic = output;
+          } else {
+            ITEX_CHECK(output == generic) << CaseName(c, elem_size, isa);
+          }
+        }
+      }
+    }
+  }
+}
+
+// The register-blocked plans use the largest inner block their kernels have
+// that fits in the stride-1 dimensions, and the smallest one down to the size
+// of the stride-1 dimensions.
+void TestInnerBlocks() {
+  struct InnerBlockCase {
+    int elem_size;
+    int64_t stride1_size;
+    Isa isa;
+    int inner_bs;
+  };
+  const InnerBlockCase cases[] = {
+      {1, 64, Isa::kAvx2, 16},   {2, 64, Isa::kAvx2, 16},
+      {4, 64, Isa::kAvx2, 16},   {8, 64, Isa::kAvx2, 8},
+      {1, 64, Isa::kAvx512, 16}, {2, 64, Isa::kAvx512, 16},
+      {4, 64, Isa::kAvx512, 16}, {8, 64, Isa::kAvx512, 16},
+      {4, 12, Isa::kAvx2, 8},    {1, 8, Isa::kAvx512, 8},
+      {8, 4, Isa::kAvx2, 4},     {8, 7, Isa::kAvx512, 4},
+  };
+  std::mt19937 rng(302);
+  for (const InnerBlockCase& ib : cases) {
+    if (ib.isa > TransposePlan::SupportedIsa()) continue;
+    const TransposeCase c = {{3 * ib.stride1_size + 1, ib.stride1_size},
+                             {1, 0}};
+    auto plan = CreatePlan(c, ib.elem_size, ib.isa);
+    const std::string name = CaseName(c, ib.elem_size, ib.isa);
+    ITEX_CHECK(plan->isa() == ib.isa) << name << " " << plan->ToString();
+    ITEX_CHECK(absl::StrContains(plan->ToString(),
+                                 absl::StrCat(" inner_bs=", ib.inner_bs, " ")))
+        << name << " " << plan->ToString();
+
+    std::vector<char> input((3 * ib.stride1_size + 1) * ib.stride1_size *
+                            ib.elem_size);
+    for (char& x : input) x = static_cast<char>(rng());
+    ITEX_CHECK(Execute(*plan, input) == NaiveTranspose(input, c, ib.elem_size))
+        << name;
+  }
+}
+
+// Sizes that are not multiples of the inner block leave tiles that the
+// register-blocked plans transpose with inner blocks of 1, on either side of
+// the transpose and in loop nests of several nodes.
+void TestTrailingTiles() {
+  const TransposeCase cases[] = {
+      {{35, 16}, {1, 0}},     {{16, 35}, {1, 0}},
+      {{43, 27}, {1, 0}},     {{3, 43, 27}, {0, 2, 1}},
+      {{27, 5, 43}, {2, 1, 0}},
+  };
+  std::mt19937 rng(303);
+  for (Isa isa : {Isa::kAvx2, Isa::kAvx512}) {
+    if (isa > TransposePlan::SupportedIsa()) continue;
+    for (int elem_size : {1, 2, 4, 8}) {
+      for (const TransposeCase& c : cases) {
+        auto plan = CreatePlan(c, elem_size, isa);
+        const std::string name = CaseName(c, elem_size, isa);
+        ITEX_CHECK(plan->isa() == isa) << name << " " << plan->ToString();
+        int64_t num_elems = 1;
+        for (int64_t d : c.dims) num_elems *= d;
+        std::vector<char> input(num_elems * elem_size);
+        for (char& x : input) x = static_cast<char>(rng());
+        ITEX_CHECK(Execute(*plan, input) == NaiveTranspose(input, c, elem_size))
+            << name;
+      }
+    }
+  }
+}
+
+// Plans fall back to the generic kernels when the stride-1 dimensions are
+// smaller than the smallest register-blocked kernel, for 16-byte elements,
+// with the ef57 transformation, and when the transpose is a memcpy.
+void TestFallbackToGeneric() {
+  for (Isa isa : kIsas) {
+    ITEX_CHECK(CreatePlan({{64, 7}, {1, 0}}, 4, isa)->isa() == Isa::kGeneric);
+    ITEX_CHECK(CreatePlan({{7, 64}, {1, 0}}, 1, isa)->isa() == Isa::kGeneric);
+    ITEX_CHECK(CreatePlan({{64, 3}, {1, 0}}, 8, isa)->isa() == Isa::kGeneric);
+    ITEX_CHECK(CreatePlan({{64, 64}, {1, 0}}, 16, isa)->isa() ==
+               Isa::kGeneric);
+    ITEX_CHECK(CreatePlan({{64, 64}, {1, 0}}, 4, isa, /*num_threads=*/1,
+                          TransposePlan::Transformation::kF64ToEf57)
+                   ->isa() == Isa::kGeneric);
+    ITEX_CHECK(CreatePlan({{64, 64, 8}, {1, 0, 2}}, 4, isa)->isa() ==
+               Isa::kGeneric);
+  }
+  // A generic plan never uses the register-blocked kernels.
+  ITEX_CHECK(CreatePlan({{64, 64}, {1, 0}}, 4, Isa::kGeneric)->isa() ==
+             Isa::kGeneric);
+}
+
+}  // namespace
+}  // namespace itex_xla
+
+int main(int argc, char** argv) {
+  itex_xla::TestMatchesGeneric();
+  itex_xla::TestInnerBlocks();
+  itex_xla::TestTrailingTiles();
+  itex_xla::TestFallbackToGeneric();
+  std::printf("PASSED\n");
+  return 0;
+}
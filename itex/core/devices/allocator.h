@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef ITEX_CORE_DEVICES_ALLOCATOR_H_
 #define ITEX_CORE_DEVICES_ALLOCATOR_H_
 
+#include <cstddef>
 #include <string>
 
 namespace itex {
@@ -37,5 +38,20 @@ class Allocator {
   virtual void DeallocateRaw(void* ptr) = 0;
 };
 
+// The source of raw memory regions for a pooling allocator such as
+// BFCAllocator.
+class SubAllocator {
+ public:
+  SubAllocator() = default;
+  virtual ~SubAllocator() = default;
+
+  // Returns a region of "num_bytes" bytes aligned to at least "alignment", or
+  // nullptr on failure.
+  virtual void* Alloc(size_t alignment, size_t num_bytes) = 0;
+
+  // Returns a region previously obtained from Alloc with the same "num_bytes".
+  virtual void Free(void* ptr, size_t num_bytes) = 0;
+};
+
 }  // namespace itex
 #endif  // ITEX_CORE_DEVICES_ALLOCATOR_H_
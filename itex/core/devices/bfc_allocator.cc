@@ -15,17 +15,128 @@ limitations under the License.
 
 #include "itex/core/devices/bfc_allocator.h"
 
+#include <atomic>
+#include <chrono>  // NOLINT(build/c++11)
+
+#include "itex/core/utils/annotation_stack.h"
+#include "itex/core/utils/strcat.h"
+
 namespace itex {
 
-BFCAllocator::BFCAllocator(ITEX_GPUDevice* device) : Allocator() {
-  device_ = device;
-  memory_limit_ = device_->get_info<sycl::info::device::global_mem_size>();
+namespace {
+
+#ifndef INTEL_CPU_ONLY
+// This function set the upper bound of memory allocation size, the
+// actuall allocation size is the minimal value of this limit size
+// and the size want to get from system.
+size_t GetLimitAlloc(ITEX_GPUDevice* device) {
+  int64 limit_size = 4 * 1024;  // unit is MB
+  if (IsXeHPC(device)) {
+    // Use a big value that means do not set limit.
+    limit_size = 1024 * 1024;
+  }
+  TF_ABORT_IF_ERROR(ReadInt64FromEnvVar("ITEX_LIMIT_MEMORY_SIZE_IN_MB",
+                                        limit_size, &limit_size));
+  return limit_size * 1024 * 1024;
+}
+
+size_t LimitAlloc(ITEX_GPUDevice* device) {
+  static size_t limit_alloc = GetLimitAlloc(device);
+  return limit_alloc;
+}
+
+size_t GetDeviceMemoryLimit(ITEX_GPUDevice* device) {
+  size_t memory_limit = device->get_info<sycl::info::device::global_mem_size>();
   size_t _800mb = 800 * 1024 * 1024;
   // Leave 800MB memory for system like proper did.
-  memory_limit_ -= _800mb;
+  memory_limit -= _800mb;
+  return memory_limit;
+}
+
+BFCAllocator::Options GetDeviceOptions(ITEX_GPUDevice* device) {
+  BFCAllocator::Options opts = BFCAllocator::GetOptionsFromEnv();
+  opts.region_size_limit = LimitAlloc(device);
+  return opts;
+}
+#endif  // INTEL_CPU_ONLY
+
+std::atomic<uint64> next_allocator_id{0};
+
+// Guards ThreadCache::allocator, so that a thread exiting while the allocator
+// of one of its caches is destroyed never returns chunks to it.
+mutex* ThreadCacheOwnersLock() {
+  static mutex* lock = new mutex;
+  return lock;
+}
+
+// The cache of the last allocator the thread used, and whether the caches of
+// the thread were released because it is exiting. They are trivially
+// destructible, so they stay readable while the thread exits.
+thread_local uint64 last_cache_allocator_id = UINT64_MAX;
+thread_local void* last_cache = nullptr;
+thread_local bool thread_caches_released = false;
+
+int64 NowMicros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+#ifndef INTEL_CPU_ONLY
+BFCAllocator::BFCAllocator(ITEX_GPUDevice* device)
+    : BFCAllocator(std::make_unique<ITEX_GPUSubAllocator>(device),
+                   GetDeviceMemoryLimit(device), "itex_device_bfc",
+                   GetDeviceOptions(device)) {}
+#endif  // INTEL_CPU_ONLY
+
+BFCAllocator::Options BFCAllocator::GetOptionsFromEnv() {
+  Options opts;
+  // The thread caches are opt-in: each thread that allocates can keep up to
+  // this many MB out of the bins.
+  int64 thread_cache_size = 0;  // unit is MB
+  TF_ABORT_IF_ERROR(ReadInt64FromEnvVar("ITEX_THREAD_CACHE_SIZE_IN_MB",
+                                        thread_cache_size, &thread_cache_size));
+  opts.thread_cache_bytes = std::max<int64>(thread_cache_size, 0) * 1024 * 1024;
+  int64 history_size = 0;
+  TF_ABORT_IF_ERROR(ReadInt64FromEnvVar("ITEX_BFC_ALLOCATION_HISTORY_SIZE",
+                                        history_size, &history_size));
+  opts.history_size = std::max<int64>(history_size, 0);
+  TF_ABORT_IF_ERROR(ReadBoolFromEnvVar("ITEX_BFC_GARBAGE_COLLECTION", false,
+                                       &opts.garbage_collection));
+  TF_ABORT_IF_ERROR(ReadInt64FromEnvVar("ITEX_BFC_REGION_IDLE_RELEASE_MS", 0,
+                                        &opts.region_idle_release_ms));
+  return opts;
+}
+
+BFCAllocator::BFCAllocator(std::unique_ptr<SubAllocator> sub_allocator,
+                           size_t memory_limit, const string& name,
+                           const Options& opts)
+    : Allocator(),
+      sub_allocator_(std::move(sub_allocator)),
+      memory_limit_(memory_limit),
+      name_(name),
+      opts_(opts),
+      id_(next_allocator_id.fetch_add(1)) {
   ITEX_VLOG(1) << "Set memory limit to " << memory_limit_ << " Bytes";
-  curr_region_allocation_bytes_ = RoundedBytes(memory_limit_);
+  if (opts_.allow_growth) {
+    curr_region_allocation_bytes_ =
+        RoundedBytes(std::min(memory_limit_, size_t{2} << 20));
+  } else {
+    curr_region_allocation_bytes_ = RoundedBytes(memory_limit_);
+  }
   free_chunks_list_ = kInvalidChunkHandle;
+  stats_.bytes_limit = memory_limit_;
+
+  if (opts_.history_size > 0) {
+    ITEX_VLOG(1) << "Recording the last " << opts_.history_size
+                 << " allocations of " << name_;
+    history_.reserve(opts_.history_size);
+    opts_.thread_cache_bytes = 0;
+    // Kernels only push their names when annotations are enabled.
+    AnnotationStack::Enable(true);
+  }
 
   // Create a bunch of bins of various good sizes.
 
@@ -35,29 +146,30 @@ BFCAllocator::BFCAllocator(ITEX_GPUDevice* device) : Allocator() {
   for (BinNum b = 0; b < kNumBins; b++) {
     size_t bin_size = BinNumToSize(b);
     ITEX_VLOG(1) << "Creating bin of max chunk size " << bin_size;
-    new (BinFromIndex(b)) Bin(this, bin_size);
+    BinFromIndex(b)->bin_size = bin_size;
     ITEX_CHECK_EQ(BinForSize(bin_size), BinFromIndex(b));
-    ITEX_CHECK_EQ(BinForSize(bin_size + 255), BinFromIndex(b));
-    ITEX_CHECK_EQ(BinForSize(bin_size * 2 - 1), BinFromIndex(b));
     if (b + 1 < kNumBins) {
-      ITEX_CHECK_NE(BinForSize(bin_size * 2), BinFromIndex(b));
+      ITEX_CHECK_EQ(BinForSize(BinNumToSize(b + 1) - 1), BinFromIndex(b));
+      ITEX_CHECK_NE(BinForSize(BinNumToSize(b + 1)), BinFromIndex(b));
     }
   }
 }
 
 BFCAllocator::~BFCAllocator() {
+  {
+    // Threads that exit later must not touch this allocator.
+    mutex_lock owners_lock(ThreadCacheOwnersLock());
+    mutex_lock l(&thread_caches_lock_);
+    for (auto& cache : thread_caches_) cache->allocator = nullptr;
+  }
   // Return memory back.
   ITEX_VLOG(2) << "Number of regions allocated: "
                << region_manager_.regions().size();
   for (const auto& region : region_manager_.regions()) {
     if (region.ptr()) {
-      ITEX_GPUFree(device_, region.ptr());
+      sub_allocator_->Free(region.ptr(), region.memory_size());
     }
   }
-
-  for (BinNum b = 0; b < kNumBins; b++) {
-    BinFromIndex(b)->~Bin();
-  }
 }
 
 void* BFCAllocator::AllocateRaw(size_t num_bytes) {
@@ -71,10 +183,36 @@ void* BFCAllocator::AllocateRaw(size_t num_bytes) {
   // so all memory addresses are nicely byte aligned.
   size_t rounded_bytes = RoundedBytes(num_bytes);
 
+  if (UseThreadCache(rounded_bytes)) {
+    void* ptr = AllocateFromThreadCache(rounded_bytes);
+    if (ptr != nullptr) return ptr;
+  }
+
+  void* ptr = AllocateFromBins(rounded_bytes, num_bytes);
+  if (ptr != nullptr) return ptr;
+
+  if (opts_.thread_cache_bytes > 0) {
+    // Chunks parked in the thread caches cannot be coalesced, so give them
+    // back before declaring out of memory.
+    FlushThreadCaches();
+    ptr = AllocateFromBins(rounded_bytes, num_bytes);
+    if (ptr != nullptr) return ptr;
+  }
+
+  ITEX_LOG(ERROR) << "Allocator ran out of memory trying "
+                  << "to allocate " << num_bytes << " Bytes"
+                  << " (rounded to " << rounded_bytes << " Bytes)";
+  DumpMemoryLog();
+
+  return nullptr;
+}
+
+void* BFCAllocator::AllocateFromBins(size_t rounded_bytes, size_t num_bytes) {
   // The BFC allocator tries to find the best fit first.
   BinNum bin_num = BinNumForSize(rounded_bytes);
 
   mutex_lock l(&lock_);
+  ++stats_.num_central_lock_acquisitions;
 
   void* ptr = FindChunkPtr(bin_num, rounded_bytes, num_bytes);
   if (ptr != nullptr) {
@@ -84,8 +222,10 @@ void* BFCAllocator::AllocateRaw(size_t num_bytes) {
     return ptr;
   }
 
-  // No memory in current memory pool, try to extend from system.
-  if (Extend(rounded_bytes)) {
+  // No memory in current memory pool, try to extend from system. Under
+  // pressure, entirely free regions may be given back to make room.
+  if (Extend(rounded_bytes) ||
+      (DeallocateFreeRegions(rounded_bytes) && Extend(rounded_bytes))) {
     ptr = FindChunkPtr(bin_num, rounded_bytes, num_bytes);
     if (ptr != nullptr) {
       ITEX_VLOG(2) << "Requested bytes: " << num_bytes
@@ -95,10 +235,6 @@ void* BFCAllocator::AllocateRaw(size_t num_bytes) {
     }
   }
 
-  ITEX_LOG(ERROR) << "Allocator ran out of memory trying "
-                  << "to allocate " << num_bytes << " Bytes"
-                  << " (rounded to " << rounded_bytes << " Bytes)";
-
   return nullptr;
 }
 
@@ -108,15 +244,316 @@ void BFCAllocator::DeallocateRaw(void* ptr) {
     ITEX_VLOG(1) << "tried to deallocate nullptr";
     return;
   }
+  if (opts_.thread_cache_bytes > 0 && DeallocateToThreadCache(ptr)) return;
+
   mutex_lock l(&lock_);
+  ++stats_.num_central_lock_acquisitions;
+  FreeToBins(ptr);
+}
 
+void BFCAllocator::FreeToBins(void* ptr) {
   // Find the chunk from the ptr.
   BFCAllocator::ChunkHandle h = region_manager_.get_handle(ptr);
   ITEX_CHECK(h != kInvalidChunkHandle);
   Chunk* chunk = ChunkFromHandle(h);
+  ITEX_CHECK(chunk->in_use());
+  stats_.bytes_in_use -= chunk->size;
+  requested_bytes_in_use_ -= chunk->requested_size;
+  if (opts_.history_size > 0) RecordHistory(false, chunk);
   // Mark the chunk as no longer in use.
   chunk->allocation_id = -1;
-  InsertFreeChunkIntoBin(TryToCoalesce(h));
+  h = TryToCoalesce(h);
+  InsertFreeChunkIntoBin(h);
+
+  if (opts_.region_idle_release_ms > 0) {
+    // A free chunk without neighbours covers its whole region.
+    chunk = ChunkFromHandle(h);
+    if (chunk->prev == kInvalidChunkHandle &&
+        chunk->next == kInvalidChunkHandle) {
+      const int64 now = NowMicros();
+      if (idle_regions_.empty()) {
+        next_idle_check_us_ = now + opts_.region_idle_release_ms * 1000;
+      }
+      idle_regions_[chunk->ptr] = now;
+    }
+    MaybeReleaseIdleRegions();
+  }
+}
+
+struct BFCAllocator::ThreadCacheOwner {
+  ~ThreadCacheOwner() {
+    thread_caches_released = true;
+    last_cache_allocator_id = UINT64_MAX;
+    last_cache = nullptr;
+    mutex_lock l(ThreadCacheOwnersLock());
+    for (auto& entry : caches) {
+      ThreadCache* cache = entry.second.get();
+      if (cache->allocator != nullptr) {
+        cache->allocator->ReleaseThreadCache(cache);
+      }
+    }
+  }
+
+  // Keyed by allocator id.
+  std::unordered_map<uint64, std::shared_ptr<ThreadCache>> caches;
+};
+
+BFCAllocator::ThreadCache* BFCAllocator::GetThreadCache() {
+  // Most threads only talk to one allocator, so remember the last lookup.
+  if (last_cache_allocator_id == id_) {
+    return static_cast<ThreadCache*>(last_cache);
+  }
+  // Frees from the thread_local destructors that run after the owner go to
+  // the bins.
+  if (thread_caches_released) return nullptr;
+
+  static thread_local ThreadCacheOwner owner;
+  auto it = owner.caches.find(id_);
+  if (it == owner.caches.end()) {
+    auto cache = std::make_shared<ThreadCache>();
+    cache->allocator = this;
+    {
+      mutex_lock l(&thread_caches_lock_);
+      thread_caches_.push_back(cache);
+    }
+    it = owner.caches.emplace(id_, std::move(cache)).first;
+  }
+  last_cache_allocator_id = id_;
+  last_cache = it->second.get();
+  return it->second.get();
+}
+
+void BFCAllocator::ReleaseThreadCache(ThreadCache* cache) {
+  {
+    mutex_lock l(&thread_caches_lock_);
+    thread_caches_.erase(
+        std::remove_if(thread_caches_.begin(), thread_caches_.end(),
+                       [cache](const std::shared_ptr<ThreadCache>& c) {
+                         return c.get() == cache;
+                       }),
+        thread_caches_.end());
+  }
+  std::vector<void*> released;
+  {
+    mutex_lock l(&cache->mu);
+    for (int c = 0; c < kNumThreadCacheClasses; ++c) {
+      released.insert(released.end(), cache->chunks[c].begin(),
+                      cache->chunks[c].end());
+      cache->chunks[c].clear();
+    }
+    cache->cached_bytes = 0;
+  }
+  cache->allocator = nullptr;
+  if (!released.empty()) ReleaseToBins(released);
+}
+
+void* BFCAllocator::AllocateFromThreadCache(size_t rounded_bytes) {
+  const int size_class = ThreadCacheClass(rounded_bytes);
+  ThreadCache* cache = GetThreadCache();
+  if (cache == nullptr) return nullptr;
+  {
+    mutex_lock l(&cache->mu);
+    std::vector<void*>& chunks = cache->chunks[size_class];
+    if (!chunks.empty()) {
+      void* ptr = chunks.back();
+      chunks.pop_back();
+      cache->cached_bytes -= rounded_bytes;
+      return ptr;
+    }
+  }
+
+  // Refill with a batch from the transfer cache, or else with chunks that
+  // already exist in the bins. Extending the pool is left to
+  // AllocateFromBins.
+  void* batch[kThreadCacheBatchSize];
+  int batch_size = 0;
+  {
+    mutex_lock l(&transfer_cache_.mu);
+    std::vector<void*>& chunks = transfer_cache_.chunks[size_class];
+    while (batch_size < kThreadCacheBatchSize && !chunks.empty()) {
+      batch[batch_size++] = chunks.back();
+      chunks.pop_back();
+    }
+    transfer_cache_.cached_bytes -= batch_size * rounded_bytes;
+  }
+  if (batch_size == 0) {
+    mutex_lock l(&lock_);
+    ++stats_.num_central_lock_acquisitions;
+    BinNum bin_num = BinNumForSize(rounded_bytes);
+    while (batch_size < kThreadCacheBatchSize) {
+      void* ptr = FindChunkPtr(bin_num, rounded_bytes, rounded_bytes);
+      if (ptr == nullptr) break;
+      if (!cached_chunk_tags_.Set(ptr, size_class)) {
+        // Out of spans to tag. The chunk is handed out uncached, and freed
+        // to the bins directly.
+        if (batch_size == 0) return ptr;
+        FreeToBins(ptr);
+        break;
+      }
+      batch[batch_size++] = ptr;
+    }
+  }
+  if (batch_size == 0) return nullptr;
+
+  if (batch_size > 1) {
+    mutex_lock l(&cache->mu);
+    std::vector<void*>& chunks = cache->chunks[size_class];
+    chunks.insert(chunks.end(), batch + 1, batch + batch_size);
+    cache->cached_bytes += (batch_size - 1) * rounded_bytes;
+  }
+  return batch[0];
+}
+
+bool BFCAllocator::DeallocateToThreadCache(void* ptr) {
+  const int size_class = cached_chunk_tags_.Get(ptr);
+  if (size_class < 0) return false;
+
+  const size_t class_bytes = ThreadCacheClassBytes(size_class);
+  std::vector<void*> transferred;
+  std::vector<void*> released;
+  ThreadCache* cache = GetThreadCache();
+  if (cache == nullptr) {
+    ReleaseToBins({ptr});
+    return true;
+  }
+  {
+    mutex_lock l(&cache->mu);
+    std::vector<void*>& chunks = cache->chunks[size_class];
+    chunks.push_back(ptr);
+    cache->cached_bytes += class_bytes;
+
+    if (chunks.size() > kThreadCacheClassCapacity) {
+      // Keep the most recently freed half, which is the most likely to be
+      // reused soon.
+      const size_t num_transferred = chunks.size() / 2;
+      transferred.assign(chunks.begin(), chunks.begin() + num_transferred);
+      chunks.erase(chunks.begin(), chunks.begin() + num_transferred);
+      cache->cached_bytes -= num_transferred * class_bytes;
+    }
+    if (cache->cached_bytes > opts_.thread_cache_bytes) {
+      for (int c = 0; c < kNumThreadCacheClasses; ++c) {
+        released.insert(released.end(), cache->chunks[c].begin(),
+                        cache->chunks[c].end());
+        cache->chunks[c].clear();
+      }
+      cache->cached_bytes = 0;
+    }
+  }
+
+  if (!transferred.empty()) {
+    const size_t transferred_bytes = transferred.size() * class_bytes;
+    mutex_lock l(&transfer_cache_.mu);
+    if (transfer_cache_.cached_bytes + transferred_bytes <=
+        opts_.thread_cache_bytes) {
+      std::vector<void*>& chunks = transfer_cache_.chunks[size_class];
+      chunks.insert(chunks.end(), transferred.begin(), transferred.end());
+      transfer_cache_.cached_bytes += transferred_bytes;
+      transferred.clear();
+    }
+  }
+  released.insert(released.end(), transferred.begin(), transferred.end());
+  if (!released.empty()) ReleaseToBins(released);
+  return true;
+}
+
+void BFCAllocator::ReleaseToBins(const std::vector<void*>& ptrs) {
+  mutex_lock l(&lock_);
+  ++stats_.num_central_lock_acquisitions;
+  for (void* ptr : ptrs) {
+    cached_chunk_tags_.Set(ptr, -1);
+    FreeToBins(ptr);
+  }
+}
+
+BFCAllocator::CachedChunkTags::~CachedChunkTags() {
+  for (Span& span : spans_) {
+    Mid* mid = span.mid.load(std::memory_order_relaxed);
+    if (mid == nullptr) continue;
+    for (auto& leaf : mid->leaves) delete leaf.load(std::memory_order_relaxed);
+    delete mid;
+  }
+}
+
+const BFCAllocator::CachedChunkTags::Span*
+BFCAllocator::CachedChunkTags::FindSpan(std::uintptr_t key) const {
+  for (int i = 0; i < kNumSpans; ++i) {
+    const Span& span = spans_[(key + i) % kNumSpans];
+    const std::uintptr_t span_key = span.key.load(std::memory_order_acquire);
+    if (span_key == key) return &span;
+    if (span_key == 0) return nullptr;
+  }
+  return nullptr;
+}
+
+int BFCAllocator::CachedChunkTags::Get(const void* ptr) const {
+  const std::uintptr_t p = reinterpret_cast<std::uintptr_t>(ptr);
+  const Span* span = FindSpan((p >> kSpanBits) + 1);
+  if (span == nullptr) return -1;
+  const Leaf* leaf = span->mid.load(std::memory_order_relaxed)
+                         ->leaves[MidIndex(p)]
+                         .load(std::memory_order_acquire);
+  if (leaf == nullptr) return -1;
+  // Tags change under `lock_`, and a cached chunk only reaches another thread
+  // through the caller's own synchronization, so a relaxed load sees the
+  // latest tag of any chunk the caller may free.
+  return leaf->tags[LeafIndex(p)].load(std::memory_order_relaxed) - 1;
+}
+
+bool BFCAllocator::CachedChunkTags::Set(const void* ptr, int size_class) {
+  const std::uintptr_t p = reinterpret_cast<std::uintptr_t>(ptr);
+  const std::uintptr_t key = (p >> kSpanBits) + 1;
+  Span* span = const_cast<Span*>(FindSpan(key));
+  if (span == nullptr) {
+    if (size_class < 0) return true;
+    for (int i = 0; i < kNumSpans && span == nullptr; ++i) {
+      Span& slot = spans_[(key + i) % kNumSpans];
+      if (slot.key.load(std::memory_order_relaxed) == 0) span = &slot;
+    }
+    if (span == nullptr) return false;
+    span->mid.store(new Mid(), std::memory_order_relaxed);
+    span->key.store(key, std::memory_order_release);
+  }
+  std::atomic<Leaf*>& leaf_slot =
+      span->mid.load(std::memory_order_relaxed)->leaves[MidIndex(p)];
+  Leaf* leaf = leaf_slot.load(std::memory_order_relaxed);
+  if (leaf == nullptr) {
+    if (size_class < 0) return true;
+    leaf = new Leaf();
+    leaf_slot.store(leaf, std::memory_order_release);
+  }
+  leaf->tags[LeafIndex(p)].store(static_cast<uint8_t>(size_class + 1),
+                                 std::memory_order_relaxed);
+  return true;
+}
+
+void BFCAllocator::FlushThreadCaches() {
+  std::vector<void*> released;
+  {
+    mutex_lock l(&thread_caches_lock_);
+    for (auto& cache : thread_caches_) {
+      mutex_lock cache_lock(&cache->mu);
+      for (int c = 0; c < kNumThreadCacheClasses; ++c) {
+        released.insert(released.end(), cache->chunks[c].begin(),
+                        cache->chunks[c].end());
+        cache->chunks[c].clear();
+      }
+      cache->cached_bytes = 0;
+    }
+  }
+  {
+    mutex_lock l(&transfer_cache_.mu);
+    for (int c = 0; c < kNumThreadCacheClasses; ++c) {
+      released.insert(released.end(), transfer_cache_.chunks[c].begin(),
+                      transfer_cache_.chunks[c].end());
+      transfer_cache_.chunks[c].clear();
+    }
+    transfer_cache_.cached_bytes = 0;
+  }
+  if (!released.empty()) {
+    ITEX_VLOG(1) << "Flushing " << released.size()
+                 << " chunks from thread caches of " << Name();
+    ReleaseToBins(released);
+  }
 }
 
 // static
@@ -130,52 +567,57 @@ size_t BFCAllocator::RoundedBytes(size_t bytes) {
 
 void* BFCAllocator::FindChunkPtr(BinNum bin_num, size_t rounded_bytes,
                                  size_t num_bytes) {
-  // First identify the first bin that could satisfy rounded_bytes.
-  for (; bin_num < kNumBins; bin_num++) {
-    // Start searching from the first bin for the smallest chunk that fits
-    // rounded_bytes.
-    Bin* b = BinFromIndex(bin_num);
-    for (auto citer = b->free_chunks.begin(); citer != b->free_chunks.end();
-         ++citer) {
-      const BFCAllocator::ChunkHandle h = (*citer);
-      BFCAllocator::Chunk* chunk = ChunkFromHandle(h);
-      ITEX_DCHECK(!chunk->in_use());
-      if (chunk->size >= rounded_bytes) {
-        // We found an existing chunk that fits us that wasn't in use, so remove
-        // it from the free bin structure prior to using.
-        RemoveFreeChunkIterFromBin(&b->free_chunks, citer);
-        // If we can break the size of the chunk into two reasonably large
-        // pieces, do so.  In any case don't waste more than a threshold of
-        // kMaxInternalFragmentation bytes on padding this alloc. Use 128MB
-        // as the default threshold.
-        const int64_t kMaxInternalFragmentation = 128 << 20;
-        if (chunk->size >= rounded_bytes * 2 ||
-            static_cast<int64_t>(chunk->size) - rounded_bytes >=
-                kMaxInternalFragmentation) {
-          SplitChunk(h, rounded_bytes);
-          chunk = ChunkFromHandle(h);  // Update chunk pointer in case it moved
-        }
-
-        // The requested size of the returned chunk is what the user
-        // has allocated.
-        chunk->requested_size = num_bytes;
-        // Currently do not track allocation id, use 0 mark this chunk in use.
-        chunk->allocation_id = 0;
-        return chunk->ptr;
-      }
-    }
+  // The bin of rounded_bytes may also hold smaller chunks. Its list is sorted
+  // by size, so the first chunk that fits is the best fit.
+  ChunkHandle h = BinFromIndex(bin_num)->head;
+  while (h != kInvalidChunkHandle && ChunkFromHandle(h)->size < rounded_bytes) {
+    h = ChunkFromHandle(h)->next_in_bin;
   }
-  return nullptr;
-}
+  // Otherwise every chunk of a larger bin fits, and the head of the first
+  // non-empty one is the best fit.
+  if (h == kInvalidChunkHandle && bin_num + 1 < kNumBins) {
+    BinNum next_bin = FindNonEmptyBin(bin_num + 1);
+    if (next_bin != kInvalidBinNum) h = BinFromIndex(next_bin)->head;
+  }
+  if (h == kInvalidChunkHandle) return nullptr;
 
-void BFCAllocator::RemoveFreeChunkIterFromBin(
-    BFCAllocator::Bin::FreeChunkSet* free_chunks,
-    const BFCAllocator::Bin::FreeChunkSet::iterator& citer) {
-  ChunkHandle h = *citer;
-  Chunk* c = ChunkFromHandle(h);
-  ITEX_CHECK(!c->in_use() && (c->bin_num != kInvalidBinNum));
-  free_chunks->erase(citer);
-  c->bin_num = kInvalidBinNum;
+  BFCAllocator::Chunk* chunk = ChunkFromHandle(h);
+  ITEX_DCHECK(!chunk->in_use());
+  if (chunk->prev == kInvalidChunkHandle &&
+      chunk->next == kInvalidChunkHandle) {
+    idle_regions_.erase(chunk->ptr);
+  }
+  // We found an existing chunk that fits us that wasn't in use, so remove
+  // it from the free bin structure prior to using.
+  RemoveFreeChunkFromBin(h);
+  // If we can break the size of the chunk into two reasonably large
+  // pieces, do so.  In any case don't waste more than a threshold of
+  // kMaxInternalFragmentation bytes on padding this alloc. Use 128MB
+  // as the default threshold.
+  const int64_t kMaxInternalFragmentation = 128 << 20;
+  if (chunk->size >= rounded_bytes * 2 ||
+      static_cast<int64_t>(chunk->size) - rounded_bytes >=
+          kMaxInternalFragmentation) {
+    SplitChunk(h, rounded_bytes);
+    chunk = ChunkFromHandle(h);  // Update chunk pointer in case it moved
+  }
+
+  // The requested size of the returned chunk is what the user
+  // has allocated.
+  chunk->requested_size = num_bytes;
+  // Assign a unique id and increment the id counter, marking the
+  // chunk as being in use.
+  chunk->allocation_id = next_allocation_id_++;
+
+  ++stats_.num_allocs;
+  stats_.bytes_in_use += chunk->size;
+  stats_.peak_bytes_in_use =
+      std::max(stats_.peak_bytes_in_use, stats_.bytes_in_use);
+  stats_.largest_alloc_size =
+      std::max<int64>(stats_.largest_alloc_size, chunk->size);
+  requested_bytes_in_use_ += num_bytes;
+  if (opts_.history_size > 0) RecordHistory(true, chunk);
+  return chunk->ptr;
 }
 
 void BFCAllocator::SplitChunk(BFCAllocator::ChunkHandle h, size_t num_bytes) {
@@ -232,26 +674,24 @@ void BFCAllocator::InsertFreeChunkIntoBin(BFCAllocator::ChunkHandle h) {
   BinNum bin_num = BinNumForSize(c->size);
   Bin* new_bin = BinFromIndex(bin_num);
   c->bin_num = bin_num;
-  new_bin->free_chunks.insert(h);
-}
 
-// This function set the upper bound of memory allocation size, the
-// actuall allocation size is the minimal value of this limit size
-// and the size want to get from system.
-size_t BFCAllocator::GetLimitAlloc() {
-  int64 limit_size = 4 * 1024;  // unit is MB
-  if (IsXeHPC(device_)) {
-    // Use a big value that means do not set limit.
-    limit_size = 1024 * 1024;
+  // Insert before the first chunk that is not smaller. A bin spans at most
+  // 1/8 of a power of two, so the walk is short.
+  ChunkHandle prev = kInvalidChunkHandle;
+  ChunkHandle next = new_bin->head;
+  while (next != kInvalidChunkHandle && ChunkFromHandle(next)->size < c->size) {
+    prev = next;
+    next = ChunkFromHandle(next)->next_in_bin;
   }
-  TF_ABORT_IF_ERROR(ReadInt64FromEnvVar("ITEX_LIMIT_MEMORY_SIZE_IN_MB",
-                                        limit_size, &limit_size));
-  return limit_size * 1024 * 1024;
-}
-
-size_t BFCAllocator::LimitAlloc() {
-  static size_t limit_alloc = GetLimitAlloc();
-  return limit_alloc;
+  c->prev_in_bin = prev;
+  c->next_in_bin = next;
+  if (prev == kInvalidChunkHandle) {
+    new_bin->head = h;
+  } else {
+    ChunkFromHandle(prev)->next_in_bin = h;
+  }
+  if (next != kInvalidChunkHandle) ChunkFromHandle(next)->prev_in_bin = h;
+  non_empty_bins_[bin_num >> 6] |= uint64{1} << (bin_num & 63);
 }
 
 bool BFCAllocator::Extend(size_t rounded_bytes) {
@@ -277,8 +717,8 @@ bool BFCAllocator::Extend(size_t rounded_bytes) {
   // Try allocating.
   size_t bytes = std::min(curr_region_allocation_bytes_, available_bytes);
 
-  bytes = std::min(bytes, LimitAlloc());
-  void* mem_addr = ITEX_GPUMalloc(device_, bytes);
+  bytes = std::min(bytes, opts_.region_size_limit);
+  void* mem_addr = sub_allocator_->Alloc(kMinAllocationSize, bytes);
   if (mem_addr == nullptr) {
     static constexpr float kBackpedalFactor = 0.9;
 
@@ -286,7 +726,7 @@ bool BFCAllocator::Extend(size_t rounded_bytes) {
     while (mem_addr == nullptr) {
       bytes = RoundedBytes(bytes * kBackpedalFactor);
       if (bytes < rounded_bytes) break;
-      mem_addr = ITEX_GPUMalloc(device_, bytes);
+      mem_addr = sub_allocator_->Alloc(kMinAllocationSize, bytes);
     }
   }
 
@@ -354,8 +794,21 @@ BFCAllocator::ChunkHandle BFCAllocator::TryToCoalesce(ChunkHandle h) {
 void BFCAllocator::RemoveFreeChunkFromBin(BFCAllocator::ChunkHandle h) {
   Chunk* c = ChunkFromHandle(h);
   ITEX_CHECK(!c->in_use() && (c->bin_num != kInvalidBinNum));
-  ITEX_CHECK_GT(BinFromIndex(c->bin_num)->free_chunks.erase(h), 0)
-      << "Could not find chunk in bin";
+  Bin* bin = BinFromIndex(c->bin_num);
+  if (c->prev_in_bin == kInvalidChunkHandle) {
+    ITEX_CHECK_EQ(bin->head, h) << "Could not find chunk in bin";
+    bin->head = c->next_in_bin;
+  } else {
+    ChunkFromHandle(c->prev_in_bin)->next_in_bin = c->next_in_bin;
+  }
+  if (c->next_in_bin != kInvalidChunkHandle) {
+    ChunkFromHandle(c->next_in_bin)->prev_in_bin = c->prev_in_bin;
+  }
+  if (bin->head == kInvalidChunkHandle) {
+    non_empty_bins_[c->bin_num >> 6] &= ~(uint64{1} << (c->bin_num & 63));
+  }
+  c->prev_in_bin = kInvalidChunkHandle;
+  c->next_in_bin = kInvalidChunkHandle;
   c->bin_num = kInvalidBinNum;
 }
 
@@ -417,4 +870,310 @@ const BFCAllocator::Chunk* BFCAllocator::ChunkFromHandle(ChunkHandle h) const {
   return &(chunks_[h]);
 }
 
+string BFCAllocator::Stats::DebugString() const {
+  return strings::StrCat(
+      "Limit:              ", bytes_limit, "\n",
+      "InUse:              ", bytes_in_use, "\n",
+      "MaxInUse:           ", peak_bytes_in_use, "\n",
+      "NumAllocs:          ", num_allocs, "\n",
+      "MaxAllocSize:       ", largest_alloc_size, "\n",
+      "Reserved:           ", bytes_reserved, "\n",
+      "NumRegions:         ", num_regions, "\n",
+      "LargestFreeBlock:   ", largest_free_block_bytes, "\n",
+      "InThreadCaches:     ", bytes_in_thread_caches, "\n",
+      "CentralLockAcqs:    ", num_central_lock_acquisitions, "\n",
+      "RegionsReleased:    ", num_regions_released, "\n",
+      "BytesReleased:      ", bytes_released, "\n",
+      "InternalFrag:       ", internal_fragmentation, "\n",
+      "ExternalFrag:       ", external_fragmentation, "\n");
+}
+
+int64 BFCAllocator::ThreadCachedBytes() {
+  int64 bytes = 0;
+  {
+    mutex_lock l(&thread_caches_lock_);
+    for (auto& cache : thread_caches_) {
+      mutex_lock cache_lock(&cache->mu);
+      bytes += cache->cached_bytes;
+    }
+  }
+  mutex_lock l(&transfer_cache_.mu);
+  return bytes + transfer_cache_.cached_bytes;
+}
+
+BFCAllocator::Stats BFCAllocator::GetStats() {
+  // The thread caches are read first, `lock_` is never held while taking
+  // their locks.
+  const int64 bytes_in_thread_caches = ThreadCachedBytes();
+  mutex_lock l(&lock_);
+  return GetStatsLocked(bytes_in_thread_caches);
+}
+
+BFCAllocator::Stats BFCAllocator::GetStatsLocked(
+    int64 bytes_in_thread_caches) {
+  Stats stats = stats_;
+  // Cached chunks may have been handed out again since they were counted.
+  stats.bytes_in_thread_caches =
+      std::min(bytes_in_thread_caches, stats_.bytes_in_use);
+  stats.bytes_in_use -= stats.bytes_in_thread_caches;
+  stats.bytes_reserved = total_region_allocated_bytes_;
+  stats.num_regions = region_manager_.regions().size();
+
+  // Free lists are sorted by size, so the largest free chunk is the tail of
+  // the highest non-empty bin.
+  for (BinNum b = kNumBins - 1; b >= 0; --b) {
+    ChunkHandle h = BinFromIndex(b)->head;
+    if (h == kInvalidChunkHandle) continue;
+    while (ChunkFromHandle(h)->next_in_bin != kInvalidChunkHandle) {
+      h = ChunkFromHandle(h)->next_in_bin;
+    }
+    stats.largest_free_block_bytes = ChunkFromHandle(h)->size;
+    break;
+  }
+
+  if (stats_.bytes_in_use > 0) {
+    stats.internal_fragmentation =
+        1.0 - static_cast<double>(requested_bytes_in_use_) /
+                  static_cast<double>(stats_.bytes_in_use);
+  }
+  const int64 free_bytes = stats.bytes_reserved - stats_.bytes_in_use;
+  if (free_bytes > 0) {
+    stats.external_fragmentation =
+        1.0 - static_cast<double>(stats.largest_free_block_bytes) /
+                  static_cast<double>(free_bytes);
+  }
+  return stats;
+}
+
+size_t BFCAllocator::ReleaseFreeRegions() {
+  FlushThreadCaches();
+  mutex_lock l(&lock_);
+  const int64 bytes_released = stats_.bytes_released;
+  absl::flat_hash_set<void*> free_region_ptrs;
+  for (const AllocationRegion& region : region_manager_.regions()) {
+    const Chunk* c = ChunkFromHandle(region_manager_.get_handle(region.ptr()));
+    if (!c->in_use() && c->next == kInvalidChunkHandle) {
+      free_region_ptrs.insert(region.ptr());
+    }
+  }
+  DeallocateRegions(free_region_ptrs);
+  return stats_.bytes_released - bytes_released;
+}
+
+bool BFCAllocator::DeallocateFreeRegions(size_t rounded_bytes) {
+  // Do nothing if garbage collection is off.
+  if (!opts_.garbage_collection) return false;
+
+  // Searching for free regions. A region is free if its first chunk is free
+  // and covers all of it.
+  absl::flat_hash_set<void*> free_region_ptrs;
+  size_t total_free_bytes = 0;
+  for (const AllocationRegion& region : region_manager_.regions()) {
+    const Chunk* c = ChunkFromHandle(region_manager_.get_handle(region.ptr()));
+    if (!c->in_use() && c->next == kInvalidChunkHandle) {
+      ITEX_VLOG(2) << "Found free region with ptr = " << region.ptr();
+      free_region_ptrs.insert(region.ptr());
+      total_free_bytes += region.memory_size();
+    }
+  }
+  if (total_free_bytes == 0) return false;
+
+  // Rough estimation to check whether deallocation can help.
+  size_t available_bytes =
+      memory_limit_ - total_region_allocated_bytes_ + total_free_bytes;
+  if (rounded_bytes > available_bytes) return false;
+
+  ITEX_LOG(WARNING) << "Garbage collection: deallocate free memory regions"
+                    << " (i.e., allocations) so that we can re-allocate a"
+                    << " larger region to avoid OOM due to memory"
+                    << " fragmentation. If you see this message frequently,"
+                    << " you are running near the threshold of the available"
+                    << " device memory and re-allocation may incur great"
+                    << " performance overhead. You may try smaller batch"
+                    << " sizes to observe the performance impact.";
+  DeallocateRegions(free_region_ptrs);
+  return true;
+}
+
+void BFCAllocator::DeallocateRegions(
+    const absl::flat_hash_set<void*>& region_ptrs) {
+  // Explicitly remove the const qualifier as some compilers disallow passing
+  // const_iterator to std::vector::erase(), which is used in
+  // RemoveAllocationRegion().
+  auto regions =
+      const_cast<std::vector<AllocationRegion>*>(&region_manager_.regions());
+  auto it = regions->begin();
+  while (it != regions->end()) {
+    if (!region_ptrs.contains(it->ptr())) {
+      ++it;
+      continue;
+    }
+
+    ITEX_VLOG(2) << "Deallocate region with ptr = " << it->ptr();
+    // Remove all chunk registrations from Bins.
+    ChunkHandle h = region_manager_.get_handle(it->ptr());
+    while (h != kInvalidChunkHandle) {
+      const Chunk* c = ChunkFromHandle(h);
+      if (c->bin_num != kInvalidBinNum) {
+        RemoveFreeChunkFromBin(h);
+      }
+      auto h_to_delete = h;
+      h = c->next;
+      DeleteChunk(h_to_delete);
+    }
+    idle_regions_.erase(it->ptr());
+
+    // Deallocate the memory.
+    sub_allocator_->Free(it->ptr(), it->memory_size());
+    total_region_allocated_bytes_ -= it->memory_size();
+    ++stats_.num_regions_released;
+    stats_.bytes_released += it->memory_size();
+    it = region_manager_.RemoveAllocationRegion(it);
+  }
+}
+
+void BFCAllocator::MaybeReleaseIdleRegions() {
+  if (idle_regions_.empty()) return;
+  const int64 now = NowMicros();
+  if (now < next_idle_check_us_) return;
+
+  const int64 idle_us = opts_.region_idle_release_ms * 1000;
+  absl::flat_hash_set<void*> idle_region_ptrs;
+  next_idle_check_us_ = INT64_MAX;
+  for (const auto& idle_region : idle_regions_) {
+    if (now - idle_region.second >= idle_us) {
+      idle_region_ptrs.insert(idle_region.first);
+    } else {
+      next_idle_check_us_ =
+          std::min(next_idle_check_us_, idle_region.second + idle_us);
+    }
+  }
+  if (idle_region_ptrs.empty()) return;
+  ITEX_VLOG(1) << "Releasing " << idle_region_ptrs.size()
+               << " idle regions of " << name_;
+  DeallocateRegions(idle_region_ptrs);
+}
+
+void BFCAllocator::RecordHistory(bool is_alloc, const Chunk* c) {
+  AllocationRecord record;
+  record.time_us = NowMicros();
+  record.is_alloc = is_alloc;
+  record.ptr = c->ptr;
+  record.requested_bytes = c->requested_size;
+  record.chunk_bytes = c->size;
+  record.bytes_in_use = stats_.bytes_in_use;
+  if (AnnotationStack::IsEnabled()) record.annotation = AnnotationStack::Get();
+
+  if (history_.size() < opts_.history_size) {
+    history_.push_back(std::move(record));
+  } else {
+    history_[history_next_] = std::move(record);
+  }
+  history_next_ = (history_next_ + 1) % opts_.history_size;
+}
+
+std::vector<BFCAllocator::AllocationRecord>
+BFCAllocator::GetAllocationHistory() {
+  mutex_lock l(&lock_);
+  return GetAllocationHistoryLocked();
+}
+
+std::vector<BFCAllocator::AllocationRecord>
+BFCAllocator::GetAllocationHistoryLocked() {
+  std::vector<AllocationRecord> history;
+  history.reserve(history_.size());
+  // Until the buffer wraps, the oldest record is at 0.
+  const size_t oldest =
+      history_.size() < opts_.history_size ? 0 : history_next_;
+  for (size_t i = 0; i < history_.size(); ++i) {
+    history.push_back(history_[(oldest + i) % history_.size()]);
+  }
+  return history;
+}
+
+void BFCAllocator::DumpMemoryLog() {
+  const int64 bytes_in_thread_caches = ThreadCachedBytes();
+  mutex_lock l(&lock_);
+  ITEX_LOG(INFO) << "Memory log of " << name_ << ":\n"
+                 << GetStatsLocked(bytes_in_thread_caches).DebugString();
+  DumpMemoryLogLocked();
+}
+
+void BFCAllocator::DumpMemoryLogLocked() {
+  // Chunks in use are accounted to the bin of their size, like free ones.
+  struct BinDebugInfo {
+    size_t total_bytes_in_use = 0;
+    size_t total_bytes_in_bin = 0;
+    size_t total_requested_bytes_in_use = 0;
+    size_t total_chunks_in_use = 0;
+    size_t total_chunks_in_bin = 0;
+  };
+  BinDebugInfo bin_infos[kNumBins];
+  for (const auto& region : region_manager_.regions()) {
+    ChunkHandle h = region_manager_.get_handle(region.ptr());
+    while (h != kInvalidChunkHandle) {
+      const Chunk* c = ChunkFromHandle(h);
+      BinDebugInfo& info = bin_infos[BinNumForSize(c->size)];
+      info.total_bytes_in_bin += c->size;
+      info.total_chunks_in_bin++;
+      if (c->in_use()) {
+        info.total_bytes_in_use += c->size;
+        info.total_requested_bytes_in_use += c->requested_size;
+        info.total_chunks_in_use++;
+      }
+      h = c->next;
+    }
+  }
+
+  for (BinNum b = 0; b < kNumBins; b++) {
+    const BinDebugInfo& info = bin_infos[b];
+    if (info.total_chunks_in_bin == 0) continue;
+    ITEX_LOG(INFO) << "Bin (" << BinNumToSize(b)
+                   << "): \tTotal Chunks: " << info.total_chunks_in_bin
+                   << ", Chunks in use: " << info.total_chunks_in_use << ". "
+                   << info.total_bytes_in_bin << " allocated for chunks. "
+                   << info.total_bytes_in_use << " in use in bin. "
+                   << info.total_requested_bytes_in_use
+                   << " client-requested in use in bin.";
+    string free_chunks;
+    for (ChunkHandle h = BinFromIndex(b)->head; h != kInvalidChunkHandle;
+         h = ChunkFromHandle(h)->next_in_bin) {
+      const Chunk* c = ChunkFromHandle(h);
+      strings::StrAppend(&free_chunks, " ", c->size, "@0x",
+                         strings::Hex(reinterpret_cast<uint64>(c->ptr)));
+    }
+    if (!free_chunks.empty()) {
+      ITEX_LOG(INFO) << "  Free chunks (size@address):" << free_chunks;
+    }
+  }
+
+  for (const auto& region : region_manager_.regions()) {
+    ITEX_LOG(INFO) << "Region " << region.ptr() << " of size "
+                   << region.memory_size();
+    ChunkHandle h = region_manager_.get_handle(region.ptr());
+    while (h != kInvalidChunkHandle) {
+      const Chunk* c = ChunkFromHandle(h);
+      if (c->in_use()) {
+        ITEX_LOG(INFO) << "  InUse at " << c->ptr << " of size " << c->size
+                       << " requested " << c->requested_size << " id "
+                       << c->allocation_id;
+      } else {
+        ITEX_LOG(INFO) << "  Free  at " << c->ptr << " of size " << c->size;
+      }
+      h = c->next;
+    }
+  }
+
+  if (!history_.empty()) {
+    ITEX_LOG(INFO) << "Last " << history_.size() << " allocations and frees:";
+    for (const AllocationRecord& r : GetAllocationHistoryLocked()) {
+      ITEX_LOG(INFO) << "  " << r.time_us << "us "
+                     << (r.is_alloc ? "alloc " : "free  ") << r.ptr << " "
+                     << r.requested_bytes << "/" << r.chunk_bytes
+                     << " bytes, in use " << r.bytes_in_use << " "
+                     << r.annotation;
+    }
+  }
+}
+
 }  // namespace itex
@@ -17,40 +17,158 @@ limitations under the License.
 #define ITEX_CORE_DEVICES_BFC_ALLOCATOR_H_
 
 #include <algorithm>
-#include <set>
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "itex/core/devices/allocator.h"
 #include "itex/core/utils/env_var.h"
 #include "itex/core/utils/hw_info.h"
 #include "itex/core/utils/logging.h"
 #include "itex/core/utils/mutex.h"
+#ifndef INTEL_CPU_ONLY
 #include "third_party/build_option/dpcpp/runtime/itex_gpu_runtime.h"
+#endif
 
 namespace itex {
 
 // Currently, the default strategy of itex custom device allocator is BFC
 class BFCAllocator : public Allocator {
  public:
+  struct Options {
+    // Upper bound of the bytes each thread keeps in its cache of small freed
+    // chunks, see ThreadCache, and of the bytes in transfer between the
+    // threads. 0 disables the thread caches.
+    size_t thread_cache_bytes = 0;
+    // Number of allocations and frees kept in the allocation history, see
+    // GetAllocationHistory. 0 disables the history. Every call has to reach
+    // the bins to be recorded, so the history disables the thread caches.
+    size_t history_size = 0;
+    // If true, regions that are entirely free are returned to the
+    // sub-allocator when a new region cannot be obtained, because of the
+    // memory limit or because the sub-allocator fails.
+    bool garbage_collection = false;
+    // If > 0, regions that stay entirely free for this many milliseconds are
+    // returned to the sub-allocator. The check runs when chunks are freed, so
+    // an allocator that sees no calls keeps its regions until
+    // ReleaseFreeRegions().
+    int64 region_idle_release_ms = 0;
+    // Upper bound of a single region requested from the sub-allocator.
+    size_t region_size_limit = SIZE_MAX;
+    // If true, the first region is 2MB instead of the whole memory limit, and
+    // every later one doubles, so that the pool grows with the demand.
+    bool allow_growth = false;
+  };
+
+  struct Stats {
+    int64 num_allocs = 0;
+    int64 bytes_in_use = 0;
+    int64 peak_bytes_in_use = 0;
+    int64 largest_alloc_size = 0;
+    int64 bytes_limit = 0;
+    // Bytes obtained from the sub-allocator, and the regions holding them.
+    int64 bytes_reserved = 0;
+    int64 num_regions = 0;
+    int64 largest_free_block_bytes = 0;
+    // Free chunks parked in the thread caches. They are not counted in
+    // bytes_in_use, but cannot be coalesced either.
+    int64 bytes_in_thread_caches = 0;
+    // Times AllocateRaw and DeallocateRaw took the central lock, once per
+    // call without the thread caches and once per batch with them.
+    int64 num_central_lock_acquisitions = 0;
+    // Regions returned to the sub-allocator before destruction.
+    int64 num_regions_released = 0;
+    int64 bytes_released = 0;
+    // Share of the bytes in use that the callers did not ask for, from
+    // rounding and from chunks too small to split.
+    double internal_fragmentation = 0;
+    // Share of the free bytes that a single allocation cannot use, i.e.
+    // 1 - largest_free_block_bytes / free bytes.
+    double external_fragmentation = 0;
+
+    string DebugString() const;
+  };
+
+  struct AllocationRecord {
+    int64 time_us = 0;
+    bool is_alloc = false;
+    void* ptr = nullptr;
+    size_t requested_bytes = 0;
+    size_t chunk_bytes = 0;
+    // Bytes in use after this call.
+    int64 bytes_in_use = 0;
+    // Annotation of the op running on the calling thread, if any.
+    string annotation;
+  };
+
+#ifndef INTEL_CPU_ONLY
   explicit BFCAllocator(ITEX_GPUDevice* device);
+#endif
+  BFCAllocator(std::unique_ptr<SubAllocator> sub_allocator,
+               size_t memory_limit, const string& name, const Options& opts);
   ~BFCAllocator() override;
+
+  // Reads the thread cache, history and garbage collection options from the
+  // ITEX_* environment variables.
+  static Options GetOptionsFromEnv();
+
   void* AllocateRaw(size_t num_bytes) override;
   void DeallocateRaw(void* ptr) override;
-  string Name() override { return "itex_device_bfc"; }
+  string Name() override { return name_; }
+
+  // Returns all chunks held by the thread caches to the bins, so that they can
+  // be coalesced and reused by any thread.
+  void FlushThreadCaches();
+
+  Stats GetStats();
+
+  // Returns the recorded allocations and frees, oldest first. Empty unless
+  // Options::history_size is set.
+  std::vector<AllocationRecord> GetAllocationHistory();
+
+  // Flushes the thread caches and returns every entirely free region to the
+  // sub-allocator. Returns the number of bytes released.
+  size_t ReleaseFreeRegions();
+
+  // Logs the chunks of every bin and region, the allocation history and the
+  // stats. Useful to tell fragmentation from true demand after an OOM.
+  void DumpMemoryLog();
 
  private:
-  ITEX_GPUDevice* device_;
+  std::unique_ptr<SubAllocator> sub_allocator_;
   size_t memory_limit_;
+  string name_;
+  Options opts_;
   static constexpr size_t kMinAllocationBits = 8;
   static constexpr size_t kMinAllocationSize = 1 << kMinAllocationBits;
   typedef int BinNum;
   static constexpr int kInvalidBinNum = -1;
-  // The following means that the largest bin'd chunk size is 256 << 21 = 512MB.
-  static constexpr int kNumBins = 21;
+  // Bins are indexed by two levels. The first level is the power of two of the
+  // chunk size, the following means that the largest bin'd chunk size is
+  // 256 << 21 = 512MB. The second level splits each power of two linearly
+  // into kNumSubBins bins, so that a bin covers at most 1/8 of its size.
+  static constexpr int kNumBinLevels = 21;
+  static constexpr int kSubBinBits = 3;
+  static constexpr int kNumSubBins = 1 << kSubBinBits;
+  static constexpr int kNumBins = kNumBinLevels * kNumSubBins;
+  static constexpr int kBinBitmapWords = (kNumBins + 63) / 64;
+
+  // Allocations up to this size are served by the thread caches, with one
+  // size class per kMinAllocationSize step.
+  static constexpr size_t kMaxThreadCacheChunkSize = 32 << 10;
+  static constexpr int kNumThreadCacheClasses =
+      kMaxThreadCacheChunkSize >> kMinAllocationBits;
+  // A thread returns the older half of a size class to the bins once it holds
+  // more than this many chunks of that class.
+  static constexpr size_t kThreadCacheClassCapacity = 32;
+  // Number of chunks a thread takes from the bins at once on a cache miss.
+  static constexpr int kThreadCacheBatchSize = 8;
 
   struct Bin;
 
@@ -102,6 +220,11 @@ class BFCAllocator : public Allocator {
     // What bin are we in?
     BinNum bin_num = kInvalidBinNum;
 
+    // If the chunk is in a bin, the neighbours in the bin's free list, which is
+    // sorted by size.
+    ChunkHandle prev_in_bin = kInvalidChunkHandle;
+    ChunkHandle next_in_bin = kInvalidChunkHandle;
+
     bool in_use() const { return allocation_id != -1; }
   };  // struct Chunk
 
@@ -111,31 +234,11 @@ class BFCAllocator : public Allocator {
     // All chunks in this bin have >= bin_size memory.
     size_t bin_size = 0;
 
-    class ChunkComparator {
-     public:
-      explicit ChunkComparator(BFCAllocator* allocator)
-          : allocator_(allocator) {}
-      // Sort first by size and then use pointer address as a tie breaker.
-      bool operator()(const ChunkHandle ha, const ChunkHandle hb) const {
-        const Chunk* a = allocator_->ChunkFromHandle(ha);
-        const Chunk* b = allocator_->ChunkFromHandle(hb);
-        if (a->size != b->size) {
-          return a->size < b->size;
-        }
-        return a->ptr < b->ptr;
-      }
-
-     private:
-      BFCAllocator* allocator_;  // The parent allocator
-    };
-
-    typedef std::set<ChunkHandle, ChunkComparator> FreeChunkSet;
-    // List of free chunks within the bin, sorted by chunk size.
-    // Chunk * not owned.
-    FreeChunkSet free_chunks;
-    Bin(BFCAllocator* allocator, size_t bs)
-        : bin_size(bs), free_chunks(ChunkComparator(allocator)) {}
-  };  // struck Bin
+    // Head of the intrusive list of free chunks within the bin, sorted by
+    // chunk size. Chunks of the same size are kept in LIFO order, so the most
+    // recently freed one is reused first.
+    ChunkHandle head = kInvalidChunkHandle;
+  };  // struct Bin
 
   // BFCAllocator allocates memory into a collection of disjoint
   // AllocationRegions.  Each AllocationRegion corresponds to one call to
@@ -294,6 +397,129 @@ class BFCAllocator : public Allocator {
     std::vector<AllocationRegion> regions_;
   };  // class RegionManager
 
+  // Per-thread front-end of the allocator. Small chunks freed by a thread are
+  // parked here, still marked in use in the bins, and handed out again without
+  // taking `lock_`. Chunks move between a cache and the bins in batches, so the
+  // central lock is taken once per batch instead of once per call. `mu` is
+  // only contended when FlushThreadCaches runs on another thread. When a
+  // thread exits, its caches return their chunks to the bins, see
+  // ThreadCacheOwner.
+  //
+  // The same structure holds the transfer cache, which is shared by all
+  // threads, like the transfer cache of tcmalloc. A thread that frees more
+  // chunks of a class than it allocates, e.g. because it releases tensors
+  // produced on other threads, parks the excess there, and a thread that runs
+  // out takes them back without reaching the bins.
+  struct ThreadCache {
+    mutex mu;
+    std::vector<void*> chunks[kNumThreadCacheClasses] TF_GUARDED_BY(mu);
+    size_t cached_bytes TF_GUARDED_BY(mu) = 0;
+    // The allocator of the cache, or nullptr once the cache was released or
+    // the allocator destroyed. Guarded by ThreadCacheOwnersLock().
+    BFCAllocator* allocator = nullptr;
+  };
+
+  // Thread-local owner of the caches of a thread, one per allocator the
+  // thread used. Its destructor runs when the thread exits and releases the
+  // caches of the allocators that are still alive.
+  struct ThreadCacheOwner;
+
+  // Size classes of the chunks owned by the thread caches, indexed by address
+  // in kMinAllocationSize steps, like the page map of tcmalloc. A free on any
+  // thread finds the class of its chunk with a few loads and no lock. The
+  // address space is split into spans of 2^kSpanBits bytes, found in a small
+  // open-addressed table, and each span into leaves of byte tags. Nodes are
+  // only added, by callers holding `lock_`, and kept until the allocator is
+  // destroyed, so that readers never see them go away. A leaf costs 64KB of
+  // host memory per 16MB of pool that serves small chunks.
+  class CachedChunkTags {
+   public:
+    CachedChunkTags() = default;
+    ~CachedChunkTags();
+
+    // Returns the size class of the cached chunk at `ptr`, or -1 if `ptr` is
+    // not owned by the thread caches.
+    int Get(const void* ptr) const;
+
+    // Tags `ptr` with `size_class`, or clears its tag if `size_class` is -1.
+    // Returns false if the span table is full, in which case the chunk must
+    // not be cached. Calls must be serialized by the caller.
+    bool Set(const void* ptr, int size_class);
+
+   private:
+    static constexpr int kSpanBits = 36;
+    static constexpr int kLeafBits = 16;
+    static constexpr int kMidBits = kSpanBits - kMinAllocationBits - kLeafBits;
+    static constexpr int kNumSpans = 64;
+
+    struct Leaf {
+      // Size class plus one, 0 if the chunk is not cached.
+      std::atomic<uint8_t> tags[1 << kLeafBits];
+    };
+    struct Mid {
+      std::atomic<Leaf*> leaves[1 << kMidBits];
+    };
+    struct Span {
+      // The span index plus one, 0 if the slot is empty. It is published after
+      // `mid`.
+      std::atomic<std::uintptr_t> key{0};
+      std::atomic<Mid*> mid{nullptr};
+    };
+
+    const Span* FindSpan(std::uintptr_t key) const;
+
+    static size_t MidIndex(std::uintptr_t p) {
+      return (p >> (kMinAllocationBits + kLeafBits)) & ((1 << kMidBits) - 1);
+    }
+    static size_t LeafIndex(std::uintptr_t p) {
+      return (p >> kMinAllocationBits) & ((1 << kLeafBits) - 1);
+    }
+
+    Span spans_[kNumSpans];
+
+    TF_DISALLOW_COPY_AND_ASSIGN(CachedChunkTags);
+  };
+
+  bool UseThreadCache(size_t rounded_bytes) const {
+    return opts_.thread_cache_bytes > 0 &&
+           rounded_bytes <= kMaxThreadCacheChunkSize;
+  }
+
+  static int ThreadCacheClass(size_t rounded_bytes) {
+    return static_cast<int>(rounded_bytes >> kMinAllocationBits) - 1;
+  }
+
+  static size_t ThreadCacheClassBytes(int size_class) {
+    return static_cast<size_t>(size_class + 1) << kMinAllocationBits;
+  }
+
+  // Returns the cache of the calling thread, creating it on first use, or
+  // nullptr if the thread is exiting and its caches were released.
+  ThreadCache* GetThreadCache();
+
+  // Forgets the cache of an exiting thread and frees its chunks to the bins.
+  // REQUIRES: ThreadCacheOwnersLock() is held.
+  void ReleaseThreadCache(ThreadCache* cache);
+
+  // Serves a small allocation from the calling thread's cache, refilling the
+  // cache with a batch from the bins on a miss. Returns nullptr if the bins
+  // have no free chunk of that size.
+  void* AllocateFromThreadCache(size_t rounded_bytes);
+
+  // Parks `ptr` in the calling thread's cache if it is owned by the thread
+  // caches. Returns false if `ptr` must be freed to the bins directly.
+  bool DeallocateToThreadCache(void* ptr);
+
+  // Takes the chunks out of the thread caches and frees them to the bins under
+  // a single acquisition of `lock_`.
+  void ReleaseToBins(const std::vector<void*>& ptrs);
+
+  // Allocates from the bins, extending the pool if needed.
+  void* AllocateFromBins(size_t rounded_bytes, size_t num_bytes);
+
+  // Marks the chunk at `ptr` as free and returns it to its bin.
+  void FreeToBins(void* ptr) TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
   ChunkHandle AllocateChunk() TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
   void DeallocateChunk(ChunkHandle h) TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
@@ -310,20 +536,34 @@ class BFCAllocator : public Allocator {
   static size_t RoundedBytes(size_t bytes);
 
   // Map from bin size to Bin
-  Bin* BinFromIndex(BinNum index) {
-    return reinterpret_cast<Bin*>(&(bins_space_[index * sizeof(Bin)]));
-  }
+  Bin* BinFromIndex(BinNum index) { return &bins_[index]; }
 
   size_t BinNumToSize(BinNum index) {
-    return static_cast<size_t>(256) << index;
+    const int level = index >> kSubBinBits;
+    const int sub_bin = index & (kNumSubBins - 1);
+    const size_t level_size = static_cast<size_t>(256) << level;
+    return level_size + sub_bin * (level_size >> kSubBinBits);
   }
 
   Bin* BinForSize(size_t bytes) { return BinFromIndex(BinNumForSize(bytes)); }
 
   BinNum BinNumForSize(size_t bytes) {
-    uint64 v = std::max<size_t>(bytes, 256) >> kMinAllocationBits;
-    int b = std::min(kNumBins - 1, Log2FloorNonZero(v));
-    return b;
+    uint64 v = std::max<size_t>(bytes, 256);
+    int level = Log2FloorNonZero(v) - kMinAllocationBits;
+    if (level >= kNumBinLevels) return kNumBins - 1;
+    int sub_bin = (v >> (level + kMinAllocationBits - kSubBinBits)) &
+                  (kNumSubBins - 1);
+    return (level << kSubBinBits) + sub_bin;
+  }
+
+  // Returns the first non-empty bin at or after `bin_num`, or kInvalidBinNum.
+  BinNum FindNonEmptyBin(BinNum bin_num) const {
+    for (int word = bin_num >> 6; word < kBinBitmapWords; ++word) {
+      uint64 bits = non_empty_bins_[word];
+      if (word == (bin_num >> 6)) bits &= ~uint64{0} << (bin_num & 63);
+      if (bits != 0) return (word << 6) + __builtin_ctzll(bits);
+    }
+    return kInvalidBinNum;
   }
 
   // Returns floor(log2(n)).
@@ -344,11 +584,6 @@ class BFCAllocator : public Allocator {
     return r - 1;
   }
 
-  // Removes the free chunk pointed to by 'c' from the set free_chunks.
-  void RemoveFreeChunkIterFromBin(Bin::FreeChunkSet* free_chunks,
-                                  const Bin::FreeChunkSet::iterator& c)
-      TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
-
   // Splits the chunk specified by 'h' into two chunks, one at least
   // of size 'num_bytes'.
   void SplitChunk(ChunkHandle h, size_t num_bytes)
@@ -374,7 +609,37 @@ class BFCAllocator : public Allocator {
   // Removes the chunk metadata represented by 'h'.
   void DeleteChunk(ChunkHandle h) TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
-  char bins_space_[sizeof(Bin) * kNumBins];
+  // Returns the regions that are entirely free to the sub-allocator if that
+  // leaves room for an allocation of 'rounded_bytes'. Returns true if any
+  // region was released.
+  bool DeallocateFreeRegions(size_t rounded_bytes)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Removes the regions starting at 'region_ptrs' and their chunks, and
+  // returns their memory to the sub-allocator.
+  void DeallocateRegions(const absl::flat_hash_set<void*>& region_ptrs)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Releases the regions that have been entirely free for longer than
+  // Options::region_idle_release_ms.
+  void MaybeReleaseIdleRegions() TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Appends the allocation or free of chunk 'c' to the history ring buffer.
+  void RecordHistory(bool is_alloc, const Chunk* c)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  Stats GetStatsLocked(int64 bytes_in_thread_caches)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  std::vector<AllocationRecord> GetAllocationHistoryLocked()
+      TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  void DumpMemoryLogLocked() TF_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  // Sums the bytes parked in all thread caches. Must not be called with
+  // `lock_` held.
+  int64 ThreadCachedBytes();
+
+  Bin bins_[kNumBins];
+  // Bit b is set iff bins_[b] is not empty.
+  uint64 non_empty_bins_[kBinBitmapWords] = {};
   mutable mutex lock_;
   RegionManager region_manager_ TF_GUARDED_BY(lock_);
 
@@ -388,11 +653,53 @@ class BFCAllocator : public Allocator {
   size_t total_region_allocated_bytes_ = 0;
 
   std::vector<Chunk> chunks_ TF_GUARDED_BY(lock_);
-  TF_DISALLOW_COPY_AND_ASSIGN(BFCAllocator);
 
-  size_t LimitAlloc();
-  size_t GetLimitAlloc();
+  // Counters behind GetStats. Chunks in the thread caches count as in use.
+  Stats stats_ TF_GUARDED_BY(lock_);
+  int64 requested_bytes_in_use_ TF_GUARDED_BY(lock_) = 0;
+  int64 next_allocation_id_ TF_GUARDED_BY(lock_) = 1;
+
+  // Entirely free regions, keyed by their start, with the time in
+  // microseconds they became free. Only kept if
+  // Options::region_idle_release_ms is set.
+  absl::flat_hash_map<void*, int64> idle_regions_ TF_GUARDED_BY(lock_);
+  // No region can reach the idle timeout before this time.
+  int64 next_idle_check_us_ TF_GUARDED_BY(lock_) = 0;
+
+  // Ring buffer of the last Options::history_size allocations and frees.
+  // history_next_ is the slot written next.
+  std::vector<AllocationRecord> history_ TF_GUARDED_BY(lock_);
+  size_t history_next_ TF_GUARDED_BY(lock_) = 0;
+
+  // Identifies this allocator in the thread-local cache maps. Unlike `this`,
+  // it is never reused by a later allocator.
+  const uint64 id_;
+  mutex thread_caches_lock_;
+  std::vector<std::shared_ptr<ThreadCache>> thread_caches_
+      TF_GUARDED_BY(thread_caches_lock_);
+  ThreadCache transfer_cache_;
+  // Written under `lock_`, read without it.
+  CachedChunkTags cached_chunk_tags_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(BFCAllocator);
 };  // class BFCAllocator
 
+#ifndef INTEL_CPU_ONLY
+// Allocates the regions of a device BFCAllocator from device memory.
+class ITEX_GPUSubAllocator : public SubAllocator {
+ public:
+  explicit ITEX_GPUSubAllocator(ITEX_GPUDevice* device) : device_(device) {}
+  void* Alloc(size_t alignment, size_t num_bytes) override {
+    return ITEX_GPUMalloc(device_, num_bytes);
+  }
+  void Free(void* ptr, size_t num_bytes) override {
+    ITEX_GPUFree(device_, ptr);
+  }
+
+ private:
+  ITEX_GPUDevice* device_;
+};
+#endif  // INTEL_CPU_ONLY
+
 }  // namespace itex
 #endif  // ITEX_CORE_DEVICES_BFC_ALLOCATOR_H_
@@ -0,0 +1,176 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Replays an allocation trace against BFCAllocator and reports the average
+// cost per operation.
+//
+// Usage: bfc_allocator_benchmark [trace_file] [repeats]
+//
+// A trace has one operation per line, "a <id> <bytes>" to allocate and
+// "f <id>" to free an earlier allocation. Lines starting with '#' are
+// ignored. Without a trace file a synthetic trace resembling a few training
+// steps is generated: long-lived weights, per-step activations of mixed
+// sizes freed in reverse order, and short-lived temporaries.
+
+#include <stdlib.h>
+
+#include <chrono>  // NOLINT(build/c++11)
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "itex/core/devices/bfc_allocator.h"
+
+namespace itex {
+namespace {
+
+class HostSubAllocator : public SubAllocator {
+ public:
+  void* Alloc(size_t alignment, size_t num_bytes) override {
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, alignment, num_bytes) != 0) return nullptr;
+    return ptr;
+  }
+  void Free(void* ptr, size_t num_bytes) override { free(ptr); }
+};
+
+struct TraceOp {
+  bool is_alloc;
+  int64 id;
+  size_t bytes;
+};
+
+bool ReadTrace(const char* path, std::vector<TraceOp>* trace) {
+  std::ifstream in(path);
+  if (!in) return false;
+  string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#') continue;
+    std::istringstream fields(line);
+    string kind;
+    TraceOp op{false, 0, 0};
+    fields >> kind >> op.id;
+    if (kind == "a") {
+      op.is_alloc = true;
+      fields >> op.bytes;
+    } else if (kind != "f") {
+      std::fprintf(stderr, "Bad trace line: %s\n", line.c_str());
+      return false;
+    }
+    trace->push_back(op);
+  }
+  return true;
+}
+
+std::vector<TraceOp> SyntheticTrace() {
+  std::vector<TraceOp> trace;
+  std::mt19937 rng(0);
+  int64 next_id = 0;
+  auto alloc = [&](size_t bytes) {
+    trace.push_back({true, next_id, bytes});
+    return next_id++;
+  };
+  auto dealloc = [&](int64 id) { trace.push_back({false, id, 0}); };
+  auto random_size = [&]() -> size_t {
+    // Mostly small tensors with a long tail of large ones.
+    const int shift = 6 + rng() % 18;
+    return (static_cast<size_t>(1) << shift) + rng() % (1 << shift);
+  };
+
+  std::vector<int64> weights;
+  for (int i = 0; i < 200; ++i) weights.push_back(alloc(random_size()));
+  for (int step = 0; step < 50; ++step) {
+    std::vector<int64> activations;
+    for (int layer = 0; layer < 400; ++layer) {
+      activations.push_back(alloc(random_size()));
+      const int64 temp = alloc(random_size());
+      if (layer % 3 == 0) activations.push_back(alloc(rng() % 4096 + 1));
+      dealloc(temp);
+    }
+    while (!activations.empty()) {
+      const int64 grad = alloc(random_size());
+      dealloc(activations.back());
+      activations.pop_back();
+      dealloc(grad);
+    }
+  }
+  for (int64 id : weights) dealloc(id);
+  return trace;
+}
+
+}  // namespace
+}  // namespace itex
+
+int main(int argc, char** argv) {
+  using itex::TraceOp;
+  std::vector<TraceOp> trace;
+  if (argc > 1) {
+    if (!itex::ReadTrace(argv[1], &trace)) {
+      std::fprintf(stderr, "Failed to read trace %s\n", argv[1]);
+      return 1;
+    }
+  } else {
+    trace = itex::SyntheticTrace();
+  }
+  const int repeats = argc > 2 ? std::atoi(argv[2]) : 20;
+
+  for (size_t thread_cache_bytes : {size_t{0}, size_t{4} << 20}) {
+    itex::BFCAllocator::Options opts;
+    opts.thread_cache_bytes = thread_cache_bytes;
+    itex::BFCAllocator allocator(std::make_unique<itex::HostSubAllocator>(),
+                                 size_t{4} << 30, "bfc_benchmark", opts);
+    std::unordered_map<itex::int64, void*> live;
+    live.reserve(trace.size());
+    size_t failed = 0;
+    auto replay = [&]() {
+      for (const TraceOp& op : trace) {
+        if (op.is_alloc) {
+          void* ptr = allocator.AllocateRaw(op.bytes);
+          if (ptr == nullptr) ++failed;
+          live[op.id] = ptr;
+        } else {
+          auto it = live.find(op.id);
+          if (it == live.end()) continue;
+          if (it->second != nullptr) allocator.DeallocateRaw(it->second);
+          live.erase(it);
+        }
+      }
+      for (auto& entry : live) {
+        if (entry.second != nullptr) allocator.DeallocateRaw(entry.second);
+      }
+      live.clear();
+    };
+
+    // The first pass extends the pool from the system and is not timed.
+    replay();
+    failed = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; ++r) replay();
+    const double seconds = std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - start)
+                               .count();
+    std::printf(
+        "thread cache %4zu MB: %zu ops x %d repeats, %.1f ns/op, %zu failed "
+        "allocations\n",
+        thread_cache_bytes >> 20, trace.size(), repeats,
+        seconds * 1e9 / (trace.size() * repeats), failed);
+  }
+  return 0;
+}
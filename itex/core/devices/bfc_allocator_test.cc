@@ -0,0 +1,428 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "itex/core/devices/bfc_allocator.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT(build/c++11)
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "itex/core/utils/annotation_stack.h"
+
+namespace itex {
+namespace {
+
+// Host memory stand-in for the device sub-allocator.
+class HostSubAllocator : public SubAllocator {
+ public:
+  void* Alloc(size_t alignment, size_t num_bytes) override {
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, alignment, num_bytes) != 0) return nullptr;
+    return ptr;
+  }
+  void Free(void* ptr, size_t /*num_bytes*/) override { free(ptr); }
+};
+
+// Host memory with a capacity, like a device shared with other consumers.
+// Allocations beyond the capacity fail.
+class LimitedSubAllocator : public HostSubAllocator {
+ public:
+  explicit LimitedSubAllocator(size_t* capacity) : capacity_(capacity) {}
+  void* Alloc(size_t alignment, size_t num_bytes) override {
+    if (live_bytes_ + num_bytes > *capacity_) return nullptr;
+    live_bytes_ += num_bytes;
+    return HostSubAllocator::Alloc(alignment, num_bytes);
+  }
+  void Free(void* ptr, size_t num_bytes) override {
+    live_bytes_ -= num_bytes;
+    HostSubAllocator::Free(ptr, num_bytes);
+  }
+
+ private:
+  size_t* capacity_;
+  size_t live_bytes_ = 0;
+};
+
+constexpr size_t kMemoryLimit = 256 << 20;
+
+std::unique_ptr<BFCAllocator> MakeAllocator(size_t thread_cache_bytes) {
+  BFCAllocator::Options opts;
+  opts.thread_cache_bytes = thread_cache_bytes;
+  return std::make_unique<BFCAllocator>(std::make_unique<HostSubAllocator>(),
+                                        kMemoryLimit, "host_bfc", opts);
+}
+
+struct Block {
+  uint64* ptr;
+  size_t words;
+  uint64 tag;
+};
+
+// Only the first and last words are tagged, so that the stress loop measures
+// the allocator rather than memory bandwidth.
+void FillBlock(const Block& b) {
+  b.ptr[0] = b.tag;
+  b.ptr[b.words - 1] = b.tag;
+}
+
+void CheckAndFree(BFCAllocator* allocator, const Block& b) {
+  // A block overlapping another live block would have been overwritten.
+  ITEX_CHECK_EQ(b.ptr[0], b.tag);
+  ITEX_CHECK_EQ(b.ptr[b.words - 1], b.tag);
+  allocator->DeallocateRaw(b.ptr);
+}
+
+// Each thread keeps a window of live small blocks and frees every other
+// retired block on its neighbour thread, like tensors produced by one
+// inter-op thread and released by another.
+double RunStress(BFCAllocator* allocator, int num_threads, int iterations) {
+  std::vector<std::vector<Block>> handoff(num_threads);
+  std::vector<mutex> handoff_locks(num_threads);
+  std::atomic<int> finished(0);
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&, t]() {
+      std::mt19937 rng(t);
+      std::vector<Block> live;
+      for (int i = 0; i < iterations; ++i) {
+        const size_t bytes = (rng() % 64 + 1) * 64;
+        Block b;
+        b.ptr = static_cast<uint64*>(allocator->AllocateRaw(bytes));
+        ITEX_CHECK(b.ptr != nullptr);
+        b.words = bytes / sizeof(uint64);
+        b.tag = (static_cast<uint64>(t) << 32) | i;
+        FillBlock(b);
+        live.push_back(b);
+
+        if (live.size() >= 64) {
+          const size_t victim = rng() % live.size();
+          Block old = live[victim];
+          live[victim] = live.back();
+          live.pop_back();
+          if (i % 2 == 0) {
+            CheckAndFree(allocator, old);
+          } else {
+            const int peer = (t + 1) % num_threads;
+            mutex_lock l(&handoff_locks[peer]);
+            handoff[peer].push_back(old);
+          }
+        }
+
+        if (i % 32 == 0) {
+          std::vector<Block> foreign;
+          {
+            mutex_lock l(&handoff_locks[t]);
+            foreign.swap(handoff[t]);
+          }
+          for (const Block& f : foreign) CheckAndFree(allocator, f);
+        }
+      }
+      for (const Block& b : live) CheckAndFree(allocator, b);
+
+      // Keep serving cross-thread frees until every thread is done, so that
+      // blocks handed to this thread do not pile up.
+      finished.fetch_add(1);
+      bool all_finished = false;
+      do {
+        all_finished = finished.load() == num_threads;
+        std::vector<Block> foreign;
+        {
+          mutex_lock l(&handoff_locks[t]);
+          foreign.swap(handoff[t]);
+        }
+        for (const Block& f : foreign) CheckAndFree(allocator, f);
+        std::this_thread::yield();
+      } while (!all_finished);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+// The thread caches take the central lock once per batch of chunks rather
+// than once per call. Only the lock acquisitions are checked, the timings
+// depend on the load of the machine and are printed for information. Each
+// configuration keeps its best time of a few runs.
+void TestStress() {
+  const int num_threads = std::max(4u, std::thread::hardware_concurrency());
+  const int iterations = 200000;
+  const int runs = 5;
+
+  double central_time = 0;
+  double cached_time = 0;
+  int64 central_acquisitions = 0;
+  int64 cached_acquisitions = 0;
+  for (int run = 0; run < runs; ++run) {
+    auto central = MakeAllocator(0);
+    const double central_run =
+        RunStress(central.get(), num_threads, iterations);
+    auto cached = MakeAllocator(4 << 20);
+    const double cached_run = RunStress(cached.get(), num_threads, iterations);
+    if (run == 0 || central_run < central_time) central_time = central_run;
+    if (run == 0 || cached_run < cached_time) cached_time = cached_run;
+
+    const BFCAllocator::Stats central_stats = central->GetStats();
+    const BFCAllocator::Stats cached_stats = cached->GetStats();
+    // One acquisition per allocation and one per free.
+    ITEX_CHECK_EQ(central_stats.num_central_lock_acquisitions,
+                  2 * central_stats.num_allocs);
+    central_acquisitions = central_stats.num_central_lock_acquisitions;
+    cached_acquisitions = cached_stats.num_central_lock_acquisitions;
+    ITEX_CHECK_LE(cached_acquisitions * 4, central_acquisitions);
+  }
+
+  std::printf(
+      "%d threads x %d small allocations: central lock %.3fs, %lld "
+      "acquisitions, thread cache %.3fs, %lld acquisitions (%.2fx)\n",
+      num_threads, iterations, central_time,
+      static_cast<long long>(central_acquisitions), cached_time,
+      static_cast<long long>(cached_acquisitions),
+      central_time / cached_time);
+}
+
+// Chunks parked in the thread caches pin fragments of the pool. A request
+// that only fits after coalescing must flush them instead of failing.
+void TestFlushOnPressure() {
+  auto allocator = MakeAllocator(64 << 20);
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 1024; ++i) ptrs.push_back(allocator->AllocateRaw(4096));
+  // Free every other block first, so cached chunks are spread over the pool.
+  for (size_t i = 0; i < ptrs.size(); i += 2) allocator->DeallocateRaw(ptrs[i]);
+  for (size_t i = 1; i < ptrs.size(); i += 2) allocator->DeallocateRaw(ptrs[i]);
+
+  void* big = allocator->AllocateRaw(kMemoryLimit - (1 << 20));
+  ITEX_CHECK(big != nullptr);
+  allocator->DeallocateRaw(big);
+}
+
+// Blocks freed on one thread are reused by the same thread and are still
+// returned correctly after an explicit flush.
+void TestReuseAndFlush() {
+  auto allocator = MakeAllocator(1 << 20);
+  void* a = allocator->AllocateRaw(1000);
+  allocator->DeallocateRaw(a);
+  void* b = allocator->AllocateRaw(1000);
+  ITEX_CHECK_EQ(a, b);
+  allocator->DeallocateRaw(b);
+
+  allocator->FlushThreadCaches();
+  void* big = allocator->AllocateRaw(kMemoryLimit - (1 << 20));
+  ITEX_CHECK(big != nullptr);
+  allocator->DeallocateRaw(big);
+}
+
+// The caches of a thread give their chunks back to the bins when the thread
+// exits, also when the thread outlives one of its allocators.
+void TestThreadExit() {
+  auto allocator = MakeAllocator(1 << 20);
+  auto short_lived = MakeAllocator(1 << 20);
+  std::thread thread([&allocator, &short_lived]() {
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 16; ++i) ptrs.push_back(allocator->AllocateRaw(1000));
+    for (void* ptr : ptrs) allocator->DeallocateRaw(ptr);
+    short_lived->DeallocateRaw(short_lived->AllocateRaw(1000));
+    ITEX_CHECK_GT(allocator->GetStats().bytes_in_thread_caches, 0);
+    short_lived.reset();
+  });
+  thread.join();
+  ITEX_CHECK_EQ(allocator->GetStats().bytes_in_thread_caches, 0);
+  ITEX_CHECK_EQ(allocator->GetStats().bytes_in_use, 0);
+}
+
+// Freed chunks are reused best-fit by size, and neighbours coalesce again
+// once everything is freed.
+void TestBestFitAndCoalesce() {
+  auto allocator = MakeAllocator(0);
+  std::vector<void*> holes;
+  std::vector<void*> spacers;
+  for (size_t pages : {48, 17, 80, 20, 33}) {
+    holes.push_back(allocator->AllocateRaw(pages * 4096));
+    spacers.push_back(allocator->AllocateRaw(256));
+  }
+  for (void* hole : holes) allocator->DeallocateRaw(hole);
+
+  // Each request gets the smallest hole it fits in, across bins.
+  void* a = allocator->AllocateRaw(18 * 4096);
+  ITEX_CHECK_EQ(a, holes[3]);
+  void* b = allocator->AllocateRaw(17 * 4096);
+  ITEX_CHECK_EQ(b, holes[1]);
+  void* c = allocator->AllocateRaw(34 * 4096);
+  ITEX_CHECK_EQ(c, holes[0]);
+  for (void* p : {a, b, c}) allocator->DeallocateRaw(p);
+  for (void* spacer : spacers) allocator->DeallocateRaw(spacer);
+
+  void* big = allocator->AllocateRaw(kMemoryLimit - (1 << 20));
+  ITEX_CHECK(big != nullptr);
+  allocator->DeallocateRaw(big);
+}
+
+// Stats follow allocations and frees, and the history keeps the most recent
+// records with the annotation of the calling op.
+void TestStatsAndHistory() {
+  BFCAllocator::Options opts;
+  opts.history_size = 4;
+  BFCAllocator allocator(std::make_unique<HostSubAllocator>(), kMemoryLimit,
+                         "host_bfc", opts);
+  void* a = allocator.AllocateRaw(1000);
+  void* spacer = allocator.AllocateRaw(256);
+  size_t old_length = AnnotationStack::PushAnnotation("MatMul");
+  void* b = allocator.AllocateRaw(4096);
+  AnnotationStack::PopAnnotation(old_length);
+
+  BFCAllocator::Stats stats = allocator.GetStats();
+  ITEX_CHECK_EQ(stats.num_allocs, 3);
+  ITEX_CHECK_EQ(stats.bytes_in_use, 1024 + 256 + 4096);
+  ITEX_CHECK_EQ(stats.largest_alloc_size, 4096);
+  ITEX_CHECK_EQ(stats.num_regions, 1);
+  ITEX_CHECK_EQ(stats.largest_free_block_bytes,
+                stats.bytes_reserved - stats.bytes_in_use);
+  ITEX_CHECK(stats.internal_fragmentation > 0);
+  ITEX_CHECK_EQ(stats.external_fragmentation, 0);
+
+  // Freeing `a` leaves a hole that cannot be merged with the large free
+  // chunk, which shows up as external fragmentation.
+  allocator.DeallocateRaw(a);
+  stats = allocator.GetStats();
+  ITEX_CHECK_EQ(stats.bytes_in_use, 256 + 4096);
+  ITEX_CHECK_EQ(stats.peak_bytes_in_use, 1024 + 256 + 4096);
+  ITEX_CHECK(stats.external_fragmentation > 0);
+  allocator.DeallocateRaw(b);
+  allocator.DeallocateRaw(spacer);
+
+  std::vector<BFCAllocator::AllocationRecord> history =
+      allocator.GetAllocationHistory();
+  ITEX_CHECK_EQ(history.size(), 4);
+  ITEX_CHECK(history[0].is_alloc);
+  ITEX_CHECK_EQ(history[0].ptr, b);
+  ITEX_CHECK_EQ(history[0].annotation, "MatMul");
+  ITEX_CHECK(!history[1].is_alloc);
+  ITEX_CHECK_EQ(history[1].ptr, a);
+  ITEX_CHECK(history[1].annotation.empty());
+  ITEX_CHECK_EQ(history[2].ptr, b);
+  ITEX_CHECK_EQ(history[3].ptr, spacer);
+  ITEX_CHECK_EQ(history[3].bytes_in_use, 0);
+  allocator.DumpMemoryLog();
+}
+
+std::unique_ptr<BFCAllocator> MakeLimitedAllocator(
+    size_t* capacity, const BFCAllocator::Options& opts) {
+  return std::make_unique<BFCAllocator>(
+      std::make_unique<LimitedSubAllocator>(capacity), kMemoryLimit,
+      "host_bfc", opts);
+}
+
+// A free region that is too small for a request is given back so that a
+// large enough region fits within the device capacity.
+void TestGarbageCollection() {
+  for (bool garbage_collection : {false, true}) {
+    size_t capacity = 100 << 20;
+    BFCAllocator::Options opts;
+    opts.garbage_collection = garbage_collection;
+    auto allocator = MakeLimitedAllocator(&capacity, opts);
+    // The first region is cut down to fit the capacity.
+    allocator->DeallocateRaw(allocator->AllocateRaw(10 << 20));
+    ITEX_CHECK_EQ(allocator->GetStats().num_regions, 1);
+
+    capacity = 200 << 20;
+    void* big = allocator->AllocateRaw(150 << 20);
+    ITEX_CHECK_EQ(big != nullptr, garbage_collection);
+    if (big == nullptr) continue;
+    BFCAllocator::Stats stats = allocator->GetStats();
+    ITEX_CHECK_EQ(stats.num_regions, 1);
+    ITEX_CHECK_EQ(stats.num_regions_released, 1);
+    allocator->DeallocateRaw(big);
+  }
+}
+
+// Regions are released once they have been free for the idle period, or on
+// request.
+void TestReleaseFreeRegions() {
+  size_t capacity = 100 << 20;
+  BFCAllocator::Options opts;
+  opts.region_idle_release_ms = 20;
+  auto allocator = MakeLimitedAllocator(&capacity, opts);
+  void* x = allocator->AllocateRaw(60 << 20);
+  capacity = 1 << 30;
+  void* y = allocator->AllocateRaw(60 << 20);
+  void* z = allocator->AllocateRaw(1 << 20);
+  ITEX_CHECK_EQ(allocator->GetStats().num_regions, 2);
+
+  allocator->DeallocateRaw(x);
+  std::this_thread::sleep_for(std::chrono::milliseconds(40));
+  // Only the region of `x` has been idle long enough.
+  allocator->DeallocateRaw(y);
+  BFCAllocator::Stats stats = allocator->GetStats();
+  ITEX_CHECK_EQ(stats.num_regions, 1);
+  ITEX_CHECK_EQ(stats.num_regions_released, 1);
+
+  // The region of `y` is still used by `z`.
+  ITEX_CHECK_EQ(allocator->ReleaseFreeRegions(), 0);
+  allocator->DeallocateRaw(z);
+  ITEX_CHECK(allocator->ReleaseFreeRegions() > 0);
+  stats = allocator->GetStats();
+  ITEX_CHECK_EQ(stats.num_regions, 0);
+  ITEX_CHECK_EQ(stats.bytes_reserved, 0);
+
+  // The allocator grows again after releasing everything.
+  void* p = allocator->AllocateRaw(1 << 20);
+  ITEX_CHECK(p != nullptr);
+  allocator->DeallocateRaw(p);
+}
+
+void TestAllowGrowth() {
+  BFCAllocator::Options opts;
+  opts.allow_growth = true;
+  BFCAllocator allocator(std::make_unique<HostSubAllocator>(), kMemoryLimit,
+                         "host_bfc", opts);
+  void* a = allocator.AllocateRaw(1 << 10);
+  ITEX_CHECK_EQ(allocator.GetStats().bytes_reserved, 2 << 20);
+  // Does not fit in the first region, so a second one of twice the size is
+  // added.
+  void* b = allocator.AllocateRaw(3 << 20);
+  BFCAllocator::Stats stats = allocator.GetStats();
+  ITEX_CHECK_EQ(stats.num_regions, 2);
+  ITEX_CHECK_EQ(stats.bytes_reserved, 6 << 20);
+  allocator.DeallocateRaw(a);
+  allocator.DeallocateRaw(b);
+}
+
+}  // namespace
+}  // namespace itex
+
+int main() {
+  itex::TestBestFitAndCoalesce();
+  itex::TestStatsAndHistory();
+  itex::TestGarbageCollection();
+  itex::TestReleaseFreeRegions();
+  itex::TestAllowGrowth();
+  itex::TestReuseAndFlush();
+  itex::TestFlushOnPressure();
+  itex::TestThreadExit();
+  itex::TestStress();
+  std::printf("PASSED\n");
+  return 0;
+}
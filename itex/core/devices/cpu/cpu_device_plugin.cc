@@ -0,0 +1,543 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "itex/core/devices/cpu/cpu_device_plugin.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT(build/c++11)
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "itex/core/devices/bfc_allocator.h"
+#include "itex/core/utils/env_var.h"
+#include "itex/core/utils/logging.h"
+#include "itex/core/utils/mem.h"
+#include "itex/core/utils/mutex.h"
+#include "itex/core/utils/numa.h"
+
+namespace itex {
+
+namespace {
+
+constexpr int kHostAlignment = 64;
+
+// Serves the regions of the host BFCAllocator. When NUMA is enabled and the
+// allocating thread is bound to a node, the region is placed on that node.
+class HostNUMASubAllocator : public SubAllocator {
+ public:
+  void* Alloc(size_t alignment, size_t num_bytes) override {
+    alignment = std::max<size_t>(alignment, kHostAlignment);
+    const int node = port::NUMAEnabled() ? port::NUMAGetThreadNodeAffinity()
+                                         : port::kNUMANoAffinity;
+    if (node == port::kNUMANoAffinity) {
+      return port::AlignedMalloc(num_bytes, alignment);
+    }
+    void* ptr = port::NUMAMalloc(node, num_bytes, alignment);
+    if (ptr != nullptr) {
+      mutex_lock l(&mu_);
+      numa_regions_.insert(ptr);
+    }
+    return ptr;
+  }
+
+  void Free(void* ptr, size_t num_bytes) override {
+    {
+      mutex_lock l(&mu_);
+      if (numa_regions_.erase(ptr) > 0) {
+        port::NUMAFree(ptr, num_bytes);
+        return;
+      }
+    }
+    port::AlignedFree(ptr);
+  }
+
+ private:
+  mutex mu_;
+  // Regions from NUMAMalloc, which have to go back through NUMAFree.
+  absl::flat_hash_set<void*> numa_regions_ TF_GUARDED_BY(mu_);
+};
+
+// Runs the work enqueued on a stream in order. Inline streams run it on the
+// calling thread before Enqueue returns; threaded streams hand it to their
+// own thread, so that the caller can go on while copies and callbacks run.
+class CPUStream {
+ public:
+  explicit CPUStream(bool threaded) {
+    if (threaded) thread_.reset(new std::thread([this]() { WorkLoop(); }));
+  }
+
+  ~CPUStream() {
+    if (!thread_) return;
+    {
+      mutex_lock l(&mu_);
+      shutdown_ = true;
+    }
+    work_cv_.notify_all();
+    thread_->join();
+  }
+
+  void Enqueue(std::function<void()> fn) {
+    if (!thread_) {
+      fn();
+      return;
+    }
+    {
+      mutex_lock l(&mu_);
+      work_.push_back(std::move(fn));
+      ++num_enqueued_;
+    }
+    work_cv_.notify_all();
+  }
+
+  // Blocks until the work enqueued so far has run.
+  void BlockUntilDone() {
+    if (!thread_) return;
+    mutex_lock l(&mu_);
+    const int64 target = num_enqueued_;
+    while (num_done_ < target) done_cv_.wait(&l);
+  }
+
+ private:
+  void WorkLoop() {
+    while (true) {
+      std::function<void()> fn;
+      {
+        mutex_lock l(&mu_);
+        while (work_.empty() && !shutdown_) work_cv_.wait(&l);
+        // Pending work is drained before the thread exits.
+        if (work_.empty()) return;
+        fn = std::move(work_.front());
+        work_.pop_front();
+      }
+      fn();
+      {
+        mutex_lock l(&mu_);
+        ++num_done_;
+      }
+      done_cv_.notify_all();
+    }
+  }
+
+  std::unique_ptr<std::thread> thread_;
+  mutex mu_;
+  condition_variable work_cv_;
+  condition_variable done_cv_;
+  std::deque<std::function<void()>> work_ TF_GUARDED_BY(mu_);
+  int64 num_enqueued_ TF_GUARDED_BY(mu_) = 0;
+  int64 num_done_ TF_GUARDED_BY(mu_) = 0;
+  bool shutdown_ TF_GUARDED_BY(mu_) = false;
+};
+
+// Completes when the stream it was last recorded on reaches it.
+class CPUEvent {
+ public:
+  void Reset() {
+    mutex_lock l(&mu_);
+    done_ = false;
+  }
+
+  // Notifies under the lock: a host thread woken by it may destroy the event
+  // as soon as it can take the lock.
+  void Complete() {
+    mutex_lock l(&mu_);
+    done_ = true;
+    cv_.notify_all();
+  }
+
+  bool IsDone() {
+    mutex_lock l(&mu_);
+    return done_;
+  }
+
+  void Wait() {
+    mutex_lock l(&mu_);
+    while (!done_) cv_.wait(&l);
+  }
+
+ private:
+  mutex mu_;
+  condition_variable cv_;
+  // A new event has not been recorded, so waiting on it does not block.
+  bool done_ TF_GUARDED_BY(mu_) = true;
+};
+
+struct CPUTimer {
+  std::chrono::steady_clock::time_point start;
+  std::chrono::steady_clock::time_point stop;
+};
+
+struct CPUDevice {
+  std::unique_ptr<BFCAllocator> allocator;
+  bool async_streams = false;
+  mutex mu;
+  // Live streams, drained by synchronize_all_activity. A stream destroyed
+  // while it is drained is deleted once the drain lets go of it.
+  absl::flat_hash_map<CPUStream*, std::shared_ptr<CPUStream>> streams
+      TF_GUARDED_BY(mu);
+};
+
+CPUDevice* ToCPUDevice(const SP_Device* device) {
+  return static_cast<CPUDevice*>(device->device_handle);
+}
+
+CPUStream* ToCPUStream(SP_Stream stream) {
+  return reinterpret_cast<CPUStream*>(stream);
+}
+
+CPUEvent* ToCPUEvent(SP_Event event) {
+  return reinterpret_cast<CPUEvent*>(event);
+}
+
+CPUTimer* ToCPUTimer(SP_Timer timer) {
+  return reinterpret_cast<CPUTimer*>(timer);
+}
+
+// The host backend shares ITEX_LIMIT_MEMORY_SIZE_IN_MB with the GPU one as
+// the upper bound of a single region, with a smaller default since host
+// regions are only committed on first touch anyway.
+size_t GetHostRegionSizeLimit() {
+  int64 limit_size = 1024;  // unit is MB
+  TF_ABORT_IF_ERROR(ReadInt64FromEnvVar("ITEX_LIMIT_MEMORY_SIZE_IN_MB",
+                                        limit_size, &limit_size));
+  return limit_size * 1024 * 1024;
+}
+
+uint64_t cpu_timer_nanoseconds(SP_Timer timer) {
+  CPUTimer* cpu_timer = ToCPUTimer(timer);
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(cpu_timer->stop -
+                                                              cpu_timer->start)
+      .count();
+}
+
+}  // namespace
+
+void cpu_device_count(const SP_Platform* platform, int* device_count,
+                      TF_Status* status) {
+  *device_count = 1;
+}
+
+void cpu_create_device(const SP_Platform* platform,
+                       SE_CreateDeviceParams* params, TF_Status* const status) {
+  BFCAllocator::Options opts = BFCAllocator::GetOptionsFromEnv();
+  opts.region_size_limit = GetHostRegionSizeLimit();
+  CPUDevice* device = new CPUDevice;
+  device->allocator.reset(
+      new BFCAllocator(std::make_unique<HostNUMASubAllocator>(),
+                       port::GetMemoryInfo().total, "itex_host_bfc", opts));
+  TF_ABORT_IF_ERROR(ReadBoolFromEnvVar("ITEX_CPU_ASYNC_STREAM", false,
+                                       &device->async_streams));
+
+  params->device->struct_size = SP_DEVICE_STRUCT_SIZE;
+  params->device->device_handle = static_cast<void*>(device);
+  params->device->ordinal = params->ordinal;
+  TF_SetStatus(status, TF_OK, "");
+}
+
+void cpu_destroy_device(const SP_Platform* platform, SP_Device* device) {
+  delete ToCPUDevice(device);
+  device->device_handle = nullptr;
+  device->ordinal = -1;
+}
+
+void cpu_create_device_fns(const SP_Platform* platform,
+                           SE_CreateDeviceFnsParams* params,
+                           TF_Status* status) {
+  TF_SetStatus(status, TF_OK, "");
+  params->device_fns->struct_size = {SP_DEVICE_FNS_STRUCT_SIZE};
+}
+void cpu_destroy_device_fns(const SP_Platform* platform,
+                            SP_DeviceFns* device_fns) {}
+
+/*StreamExecutor Backend Impl*/
+void cpu_allocate(const SP_Device* device, uint64_t size, int64_t memory_space,
+                  SP_DeviceMemoryBase* mem) {
+  mem->struct_size = SP_DEVICE_MEMORY_BASE_STRUCT_SIZE;
+  mem->opaque = ToCPUDevice(device)->allocator->AllocateRaw(size);
+  mem->size = size;
+}
+
+void cpu_deallocate(const SP_Device* device, SP_DeviceMemoryBase* mem) {
+  ToCPUDevice(device)->allocator->DeallocateRaw(mem->opaque);
+  mem->opaque = nullptr;
+  mem->size = 0;
+}
+
+void* cpu_host_memory_allocate(const SP_Device* device, uint64_t size) {
+  return port::AlignedMalloc(size, kHostAlignment);
+}
+
+void cpu_host_memory_deallocate(const SP_Device* device, void* mem) {
+  port::AlignedFree(mem);
+}
+
+TF_Bool cpu_get_allocator_stats(const SP_Device* device,
+                                SP_AllocatorStats* stats) {
+  BFCAllocator::Stats alloc_stats = ToCPUDevice(device)->allocator->GetStats();
+  stats->struct_size = SP_ALLOCATORSTATS_STRUCT_SIZE;
+  stats->num_allocs = alloc_stats.num_allocs;
+  stats->bytes_in_use = alloc_stats.bytes_in_use;
+  stats->peak_bytes_in_use = alloc_stats.peak_bytes_in_use;
+  stats->largest_alloc_size = alloc_stats.largest_alloc_size;
+  stats->has_bytes_limit = true;
+  stats->bytes_limit = alloc_stats.bytes_limit;
+  stats->bytes_reserved = alloc_stats.bytes_reserved;
+  stats->largest_free_block_bytes = alloc_stats.largest_free_block_bytes;
+  return true;
+}
+
+TF_Bool cpu_device_memory_usage(const SP_Device* device, int64_t* free,
+                                int64_t* total) {
+  port::MemoryInfo info = port::GetMemoryInfo();
+  *free = info.free;
+  *total = info.total;
+  return true;
+}
+
+void cpu_create_stream(const SP_Device* device, SP_Stream* stream,
+                       TF_Status* status) {
+  CPUDevice* cpu_device = ToCPUDevice(device);
+  auto cpu_stream = std::make_shared<CPUStream>(cpu_device->async_streams);
+  *stream = reinterpret_cast<SP_Stream>(cpu_stream.get());
+  mutex_lock l(&cpu_device->mu);
+  cpu_device->streams.emplace(cpu_stream.get(), std::move(cpu_stream));
+}
+
+// Destroys SP_Stream and deallocates any underlying resources.
+void cpu_destroy_stream(const SP_Device* device, SP_Stream stream) {
+  CPUDevice* cpu_device = ToCPUDevice(device);
+  std::shared_ptr<CPUStream> cpu_stream;
+  {
+    mutex_lock l(&cpu_device->mu);
+    auto it = cpu_device->streams.find(ToCPUStream(stream));
+    cpu_stream = std::move(it->second);
+    cpu_device->streams.erase(it);
+  }
+  // Joins the stream thread outside the lock, unless a drain still holds it.
+  cpu_stream.reset();
+}
+
+void cpu_create_stream_dependency(const SP_Device* device, SP_Stream dependent,
+                                  SP_Stream other, TF_Status* status) {
+  // `dependent` runs nothing new until the work enqueued on `other` so far
+  // has run.
+  auto event = std::make_shared<CPUEvent>();
+  event->Reset();
+  ToCPUStream(other)->Enqueue([event]() { event->Complete(); });
+  ToCPUStream(dependent)->Enqueue([event]() { event->Wait(); });
+}
+
+// Without blocking the device, retrieve the current stream status.
+void cpu_get_stream_status(const SP_Device* device, SP_Stream stream,
+                           TF_Status* status) {
+  TF_SetStatus(status, TF_OK, "");
+}
+
+void cpu_create_event(const SP_Device* device, SP_Event* event,
+                      TF_Status* status) {
+  *event = reinterpret_cast<SP_Event>(new CPUEvent);
+}
+
+// Destroy SE_Event and perform any platform-specific deallocation and
+// cleanup of an event.
+void cpu_destroy_event(const SP_Device* device, SP_Event event) {
+  delete ToCPUEvent(event);
+}
+
+// Requests the current status of the event from the underlying platform.
+SE_EventStatus cpu_get_event_status(const SP_Device* device, SP_Event event) {
+  return ToCPUEvent(event)->IsDone() ? SE_EVENT_COMPLETE : SE_EVENT_PENDING;
+}
+
+// Inserts the specified event at the end of the specified stream.
+void cpu_record_event(const SP_Device* device, SP_Stream stream, SP_Event event,
+                      TF_Status* status) {
+  CPUEvent* cpu_event = ToCPUEvent(event);
+  cpu_event->Reset();
+  ToCPUStream(stream)->Enqueue([cpu_event]() { cpu_event->Complete(); });
+}
+
+// Wait for the specified event at the end of the specified stream.
+void cpu_wait_for_event(const SP_Device* const device, SP_Stream stream,
+                        SP_Event event, TF_Status* const status) {
+  CPUEvent* cpu_event = ToCPUEvent(event);
+  ToCPUStream(stream)->Enqueue([cpu_event]() { cpu_event->Wait(); });
+}
+
+/*** TIMER CALLBACKS ***/
+void cpu_create_timer(const SP_Device* device, SP_Timer* timer,
+                      TF_Status* status) {
+  *timer = reinterpret_cast<SP_Timer>(new CPUTimer);
+}
+
+void cpu_destroy_timer(const SP_Device* device, SP_Timer timer) {
+  delete ToCPUTimer(timer);
+}
+
+// Records a start event for an interval timer.
+void cpu_start_timer(const SP_Device* device, SP_Stream stream, SP_Timer timer,
+                     TF_Status* status) {
+  CPUTimer* cpu_timer = ToCPUTimer(timer);
+  ToCPUStream(stream)->Enqueue(
+      [cpu_timer]() { cpu_timer->start = std::chrono::steady_clock::now(); });
+}
+
+// Records a stop event for an interval timer.
+void cpu_stop_timer(const SP_Device* device, SP_Stream stream, SP_Timer timer,
+                    TF_Status* status) {
+  CPUTimer* cpu_timer = ToCPUTimer(timer);
+  ToCPUStream(stream)->Enqueue(
+      [cpu_timer]() { cpu_timer->stop = std::chrono::steady_clock::now(); });
+}
+
+/*** MEMCPY CALLBACKS ***/
+// Device memory is host memory, so every copy is a plain memcpy run on the
+// stream, or directly for the synchronous variants.
+void cpu_memcpy_dtoh(const SP_Device* device, SP_Stream stream, void* host_dst,
+                     const SP_DeviceMemoryBase* device_src, uint64_t size,
+                     TF_Status* status) {
+  const void* src = device_src->opaque;
+  ToCPUStream(stream)->Enqueue(
+      [host_dst, src, size]() { std::memcpy(host_dst, src, size); });
+}
+
+void cpu_memcpy_htod(const SP_Device* device, SP_Stream stream,
+                     SP_DeviceMemoryBase* device_dst, const void* host_src,
+                     uint64_t size, TF_Status* status) {
+  void* dst = device_dst->opaque;
+  ToCPUStream(stream)->Enqueue(
+      [dst, host_src, size]() { std::memcpy(dst, host_src, size); });
+}
+
+void cpu_memcpy_dtod(const SP_Device* device, SP_Stream stream,
+                     SP_DeviceMemoryBase* device_dst,
+                     const SP_DeviceMemoryBase* device_src, uint64_t size,
+                     TF_Status* status) {
+  void* dst = device_dst->opaque;
+  const void* src = device_src->opaque;
+  ToCPUStream(stream)->Enqueue(
+      [dst, src, size]() { std::memmove(dst, src, size); });
+}
+
+void cpu_sync_memcpy_dtoh(const SP_Device* device, void* host_dst,
+                          const SP_DeviceMemoryBase* device_src, uint64_t size,
+                          TF_Status* status) {
+  std::memcpy(host_dst, device_src->opaque, size);
+}
+
+void cpu_sync_memcpy_htod(const SP_Device* device,
+                          SP_DeviceMemoryBase* device_dst, const void* host_src,
+                          uint64_t size, TF_Status* status) {
+  std::memcpy(device_dst->opaque, host_src, size);
+}
+
+void cpu_sync_memcpy_dtod(const SP_Device* device,
+                          SP_DeviceMemoryBase* device_dst,
+                          const SP_DeviceMemoryBase* device_src, uint64_t size,
+                          TF_Status* status) {
+  std::memmove(device_dst->opaque, device_src->opaque, size);
+}
+
+// Causes the host code to synchronously wait for the event to complete.
+void cpu_block_host_for_event(const SP_Device* device, SP_Event event,
+                              TF_Status* status) {
+  ToCPUEvent(event)->Wait();
+}
+
+void cpu_block_host_until_done(const SP_Device* device, SP_Stream stream,
+                               TF_Status* status) {
+  ToCPUStream(stream)->BlockUntilDone();
+}
+
+// Synchronizes all activity occurring in the StreamExecutor's context (most
+// likely a whole device).
+void cpu_synchronize_all_activity(const SP_Device* device, TF_Status* status) {
+  CPUDevice* cpu_device = ToCPUDevice(device);
+  // Blocks outside the lock, so that streams can be created and destroyed
+  // meanwhile.
+  std::vector<std::shared_ptr<CPUStream>> streams;
+  {
+    mutex_lock l(&cpu_device->mu);
+    streams.reserve(cpu_device->streams.size());
+    for (const auto& stream : cpu_device->streams) {
+      streams.push_back(stream.second);
+    }
+  }
+  for (const auto& stream : streams) stream->BlockUntilDone();
+}
+
+void cpu_mem_zero(const SP_Device* device, SP_Stream stream,
+                  SP_DeviceMemoryBase* location, uint64_t size,
+                  TF_Status* status) {
+  void* dst = location->opaque;
+  ToCPUStream(stream)->Enqueue([dst, size]() { std::memset(dst, 0, size); });
+}
+
+void cpu_memset(const SP_Device* device, SP_Stream stream,
+                SP_DeviceMemoryBase* location, uint8_t pattern, uint64_t size,
+                TF_Status* status) {
+  void* dst = location->opaque;
+  ToCPUStream(stream)->Enqueue(
+      [dst, pattern, size]() { std::memset(dst, pattern, size); });
+}
+
+// `size` is in bytes, as for the other memset callbacks.
+void cpu_memset32(const SP_Device* device, SP_Stream stream,
+                  SP_DeviceMemoryBase* location, uint32_t pattern,
+                  uint64_t size, TF_Status* status) {
+  uint32_t* dst = static_cast<uint32_t*>(location->opaque);
+  ToCPUStream(stream)->Enqueue([dst, pattern, size]() {
+    std::fill(dst, dst + size / sizeof(uint32_t), pattern);
+  });
+}
+
+// Enqueues on a stream a user-specified function to be run on the host.
+// `callback_arg` should be passed as the first argument to `callback_fn`.
+TF_Bool cpu_host_callback(const SP_Device* device, SP_Stream stream,
+                          SE_StatusCallbackFn callback_fn, void* callback_arg) {
+  ToCPUStream(stream)->Enqueue([callback_fn, callback_arg]() {
+    TF_Status* tf_status = TF_NewStatus();
+    callback_fn(callback_arg, tf_status);
+    if (TF_GetCode(tf_status) != TF_OK) {
+      ITEX_LOG(WARNING) << "Host callback failed: "
+                        << std::string(TF_Message(tf_status));
+    }
+    TF_DeleteStatus(tf_status);
+  });
+  return 1;
+}
+
+void cpu_create_timer_fns(const SP_Platform* platform, SP_TimerFns* timer_fns,
+                          TF_Status* const status) {
+  timer_fns->nanoseconds = cpu_timer_nanoseconds;
+}
+
+void cpu_destroy_timer_fns(const SP_Platform* platform,
+                           SP_TimerFns* timer_fns) {}
+
+void cpu_destroy_stream_executor(const SP_Platform* platform,
+                                 SP_StreamExecutor* stream_executor) {}
+
+void cpu_destroy_platform(SP_Platform* const platform) {}
+void cpu_destroy_platform_fns(SP_PlatformFns* const platform_fns) {}
+
+}  // namespace itex
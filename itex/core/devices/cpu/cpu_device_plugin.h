@@ -0,0 +1,111 @@
+/* Copyright (c) 2021-2022 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef ITEX_CORE_DEVICES_CPU_CPU_DEVICE_PLUGIN_H_
+#define ITEX_CORE_DEVICES_CPU_CPU_DEVICE_PLUGIN_H_
+
+#include "tensorflow/c/experimental/stream_executor/stream_executor.h"
+
+// Host backend of the XPU platform, selected with ITEX_BACKEND=CPU. Device
+// memory is host memory served by a BFCAllocator, and streams run their work
+// either inline on the calling thread or, with ITEX_CPU_ASYNC_STREAM=1, in
+// order on a dedicated thread per stream.
+namespace itex {
+void cpu_device_count(const SP_Platform* platform, int* device_count,
+                      TF_Status* status);
+void cpu_create_device(const SP_Platform* platform,
+                       SE_CreateDeviceParams* params, TF_Status* const status);
+void cpu_destroy_device(const SP_Platform* platform, SP_Device* device);
+void cpu_create_device_fns(const SP_Platform* platform,
+                           SE_CreateDeviceFnsParams* params, TF_Status* status);
+void cpu_destroy_device_fns(const SP_Platform* platform,
+                            SP_DeviceFns* device_fns);
+void cpu_destroy_stream_executor(const SP_Platform* platform,
+                                 SP_StreamExecutor* stream_executor);
+void cpu_create_timer_fns(const SP_Platform* platform, SP_TimerFns* timer_fns,
+                          TF_Status* const status);
+void cpu_destroy_timer_fns(const SP_Platform* platform, SP_TimerFns* timer_fns);
+void cpu_destroy_platform(SP_Platform* const platform);
+void cpu_destroy_platform_fns(SP_PlatformFns* const platform_fns);
+
+void cpu_allocate(const SP_Device* device, uint64_t size, int64_t memory_space,
+                  SP_DeviceMemoryBase* mem);
+void cpu_deallocate(const SP_Device* device, SP_DeviceMemoryBase* mem);
+void* cpu_host_memory_allocate(const SP_Device* device, uint64_t size);
+void cpu_host_memory_deallocate(const SP_Device* device, void* mem);
+TF_Bool cpu_get_allocator_stats(const SP_Device* device,
+                                SP_AllocatorStats* stats);
+TF_Bool cpu_device_memory_usage(const SP_Device* device, int64_t* free,
+                                int64_t* total);
+void cpu_create_stream(const SP_Device* device, SP_Stream* stream,
+                       TF_Status* status);
+void cpu_destroy_stream(const SP_Device* device, SP_Stream stream);
+void cpu_create_stream_dependency(const SP_Device* device, SP_Stream dependent,
+                                  SP_Stream other, TF_Status* status);
+void cpu_get_stream_status(const SP_Device* device, SP_Stream stream,
+                           TF_Status* status);
+void cpu_create_event(const SP_Device* device, SP_Event* event,
+                      TF_Status* status);
+void cpu_destroy_event(const SP_Device* device, SP_Event event);
+SE_EventStatus cpu_get_event_status(const SP_Device* device, SP_Event event);
+void cpu_record_event(const SP_Device* device, SP_Stream stream, SP_Event event,
+                      TF_Status* status);
+void cpu_wait_for_event(const SP_Device* const device, SP_Stream stream,
+                        SP_Event event, TF_Status* const status);
+void cpu_create_timer(const SP_Device* device, SP_Timer* timer,
+                      TF_Status* status);
+void cpu_destroy_timer(const SP_Device* device, SP_Timer timer);
+void cpu_start_timer(const SP_Device* device, SP_Stream stream, SP_Timer timer,
+                     TF_Status* status);
+void cpu_stop_timer(const SP_Device* device, SP_Stream stream, SP_Timer timer,
+                    TF_Status* status);
+void cpu_memcpy_dtoh(const SP_Device* device, SP_Stream stream, void* host_dst,
+                     const SP_DeviceMemoryBase* device_src, uint64_t size,
+                     TF_Status* status);
+void cpu_memcpy_htod(const SP_Device* device, SP_Stream stream,
+                     SP_DeviceMemoryBase* device_dst, const void* host_src,
+                     uint64_t size, TF_Status* status);
+void cpu_memcpy_dtod(const SP_Device* device, SP_Stream stream,
+                     SP_DeviceMemoryBase* device_dst,
+                     const SP_DeviceMemoryBase* device_src, uint64_t size,
+                     TF_Status* status);
+void cpu_sync_memcpy_dtoh(const SP_Device* device, void* host_dst,
+                          const SP_DeviceMemoryBase* device_src, uint64_t size,
+                          TF_Status* status);
+void cpu_sync_memcpy_htod(const SP_Device* device,
+                          SP_DeviceMemoryBase* device_dst, const void* host_src,
+                          uint64_t size, TF_Status* status);
+void cpu_sync_memcpy_dtod(const SP_Device* device,
+                          SP_DeviceMemoryBase* device_dst,
+                          const SP_DeviceMemoryBase* device_src, uint64_t size,
+                          TF_Status* status);
+void cpu_block_host_for_event(const SP_Device* device, SP_Event event,
+                              TF_Status* status);
+void cpu_block_host_until_done(const SP_Device* device, SP_Stream stream,
+                               TF_Status* status);
+void cpu_synchronize_all_activity(const SP_Device* device, TF_Status* status);
+void cpu_mem_zero(const SP_Device* device, SP_Stream stream,
+                  SP_DeviceMemoryBase* location, uint64_t size,
+                  TF_Status* status);
+void cpu_memset(const SP_Device* device, SP_Stream stream,
+                SP_DeviceMemoryBase* location, uint8_t pattern, uint64_t size,
+                TF_Status* status);
+void cpu_memset32(const SP_Device* device, SP_Stream stream,
+                  SP_DeviceMemoryBase* location, uint32_t pattern,
+                  uint64_t size, TF_Status* status);
+TF_Bool cpu_host_callback(const SP_Device* device, SP_Stream stream,
+                          SE_StatusCallbackFn callback_fn, void* callback_arg);
+}  // namespace itex
+#endif  // ITEX_CORE_DEVICES_CPU_CPU_DEVICE_PLUGIN_H_
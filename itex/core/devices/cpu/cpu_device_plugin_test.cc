@@ -0,0 +1,305 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "itex/core/devices/cpu/cpu_device_plugin.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "itex/core/utils/logging.h"
+#include "itex/core/utils/notification.h"
+#include "itex/core/utils/numa.h"
+
+namespace itex {
+namespace {
+
+constexpr size_t kBytes = 1 << 20;
+// Upper bound of the regions the host allocator obtains, in MB.
+constexpr char kRegionSizeLimitMB[] = "16";
+// More than half of a region, so that every such chunk takes a region.
+constexpr size_t kLargeBytes = 12 << 20;
+
+// A host backend device, with streams that run inline or on their own thread.
+class TestDevice {
+ public:
+  explicit TestDevice(bool threaded) : status_(TF_NewStatus()) {
+    setenv("ITEX_CPU_ASYNC_STREAM", threaded ? "1" : "0", 1);
+    setenv("ITEX_LIMIT_MEMORY_SIZE_IN_MB", kRegionSizeLimitMB, 1);
+    SE_CreateDeviceParams params{SE_CREATE_DEVICE_PARAMS_STRUCT_SIZE};
+    params.device = &device_;
+    params.ordinal = 0;
+    cpu_create_device(&platform_, &params, status_);
+    ITEX_CHECK_EQ(TF_GetCode(status_), TF_OK);
+  }
+
+  ~TestDevice() {
+    cpu_destroy_device(&platform_, &device_);
+    TF_DeleteStatus(status_);
+  }
+
+  const SP_Device* device() const { return &device_; }
+  TF_Status* status() { return status_; }
+
+  SP_Stream CreateStream() {
+    SP_Stream stream;
+    cpu_create_stream(&device_, &stream, status_);
+    return stream;
+  }
+
+  SP_DeviceMemoryBase Allocate(uint64_t size) {
+    SP_DeviceMemoryBase mem{SP_DEVICE_MEMORY_BASE_STRUCT_SIZE};
+    cpu_allocate(&device_, size, 0, &mem);
+    ITEX_CHECK(mem.opaque != nullptr);
+    ITEX_CHECK_EQ(reinterpret_cast<uintptr_t>(mem.opaque) % 64, 0);
+    return mem;
+  }
+
+ private:
+  SP_Platform platform_{SP_PLATFORM_STRUCT_SIZE};
+  SP_Device device_{SP_DEVICE_STRUCT_SIZE};
+  TF_Status* status_;
+};
+
+// Host callback that holds its stream until the test releases it.
+void WaitForRelease(void* arg, TF_Status* status) {
+  static_cast<Notification*>(arg)->WaitForNotification();
+  TF_SetStatus(status, TF_OK, "");
+}
+
+// Copies and memsets enqueued on one stream take effect in order, so each one
+// sees the bytes written by the ones before it.
+void TestStreamOrder(bool threaded) {
+  TestDevice dev(threaded);
+  SP_Stream stream = dev.CreateStream();
+  SP_DeviceMemoryBase a = dev.Allocate(kBytes);
+  SP_DeviceMemoryBase b = dev.Allocate(kBytes);
+  std::vector<uint8_t> host(kBytes, 7);
+  std::vector<uint8_t> out(kBytes, 0);
+
+  Notification release;
+  if (threaded) {
+    // Nothing below runs before the release, so the host buffer may still be
+    // changed and the stream must not be done.
+    cpu_host_callback(dev.device(), stream, WaitForRelease, &release);
+  }
+  cpu_memcpy_htod(dev.device(), stream, &a, host.data(), kBytes, dev.status());
+  cpu_memset(dev.device(), stream, &a, 1, kBytes / 2, dev.status());
+  cpu_memset32(dev.device(), stream, &a, 0x04030201u, 16, dev.status());
+  cpu_memcpy_dtod(dev.device(), stream, &b, &a, kBytes, dev.status());
+  cpu_mem_zero(dev.device(), stream, &a, kBytes, dev.status());
+  cpu_memcpy_dtoh(dev.device(), stream, out.data(), &b, kBytes, dev.status());
+  if (threaded) {
+    ITEX_CHECK_EQ(out[0], 0);
+    release.Notify();
+  }
+  cpu_block_host_until_done(dev.device(), stream, dev.status());
+
+  const uint8_t pattern[] = {1, 2, 3, 4};
+  for (size_t i = 0; i < 16; ++i) ITEX_CHECK_EQ(out[i], pattern[i % 4]);
+  for (size_t i = 16; i < kBytes / 2; ++i) ITEX_CHECK_EQ(out[i], 1);
+  for (size_t i = kBytes / 2; i < kBytes; ++i) ITEX_CHECK_EQ(out[i], 7);
+  std::vector<uint8_t> zeros(kBytes, 0);
+  cpu_sync_memcpy_dtoh(dev.device(), out.data(), &a, kBytes, dev.status());
+  ITEX_CHECK_EQ(std::memcmp(out.data(), zeros.data(), kBytes), 0);
+
+  cpu_deallocate(dev.device(), &a);
+  cpu_deallocate(dev.device(), &b);
+  cpu_destroy_stream(dev.device(), stream);
+}
+
+// An event completes when its stream reaches it, and a stream waiting on it
+// runs nothing enqueued after the wait until then.
+void TestEvents(bool threaded) {
+  TestDevice dev(threaded);
+  SP_Stream producer = dev.CreateStream();
+  SP_Stream consumer = dev.CreateStream();
+  SP_DeviceMemoryBase a = dev.Allocate(kBytes);
+  SP_DeviceMemoryBase b = dev.Allocate(kBytes);
+  std::vector<uint8_t> host(kBytes, 9);
+  std::vector<uint8_t> out(kBytes, 0);
+
+  SP_Event event;
+  cpu_create_event(dev.device(), &event, dev.status());
+  // An event that was never recorded does not block its waiters.
+  ITEX_CHECK_EQ(cpu_get_event_status(dev.device(), event), SE_EVENT_COMPLETE);
+
+  Notification release;
+  if (threaded) {
+    cpu_host_callback(dev.device(), producer, WaitForRelease, &release);
+  }
+  cpu_memcpy_htod(dev.device(), producer, &a, host.data(), kBytes,
+                  dev.status());
+  cpu_record_event(dev.device(), producer, event, dev.status());
+  cpu_wait_for_event(dev.device(), consumer, event, dev.status());
+  cpu_memcpy_dtod(dev.device(), consumer, &b, &a, kBytes, dev.status());
+  cpu_memcpy_dtoh(dev.device(), consumer, out.data(), &b, kBytes,
+                  dev.status());
+  if (threaded) {
+    ITEX_CHECK_EQ(cpu_get_event_status(dev.device(), event), SE_EVENT_PENDING);
+    ITEX_CHECK_EQ(out[0], 0);
+    release.Notify();
+  }
+  cpu_block_host_until_done(dev.device(), consumer, dev.status());
+  ITEX_CHECK_EQ(cpu_get_event_status(dev.device(), event), SE_EVENT_COMPLETE);
+  ITEX_CHECK_EQ(std::memcmp(out.data(), host.data(), kBytes), 0);
+
+  // Recording again resets the event until the stream reaches it once more.
+  Notification release_again;
+  if (threaded) {
+    cpu_host_callback(dev.device(), producer, WaitForRelease, &release_again);
+  }
+  cpu_record_event(dev.device(), producer, event, dev.status());
+  if (threaded) {
+    ITEX_CHECK_EQ(cpu_get_event_status(dev.device(), event), SE_EVENT_PENDING);
+    release_again.Notify();
+  }
+  cpu_block_host_for_event(dev.device(), event, dev.status());
+  ITEX_CHECK_EQ(cpu_get_event_status(dev.device(), event), SE_EVENT_COMPLETE);
+
+  cpu_destroy_event(dev.device(), event);
+  cpu_deallocate(dev.device(), &a);
+  cpu_deallocate(dev.device(), &b);
+  cpu_destroy_stream(dev.device(), producer);
+  cpu_destroy_stream(dev.device(), consumer);
+}
+
+// synchronize_all_activity returns once every stream of the device has run
+// its work, and stream dependencies order work across streams.
+void TestSynchronize(bool threaded) {
+  TestDevice dev(threaded);
+  std::vector<SP_Stream> streams;
+  std::vector<SP_DeviceMemoryBase> mems;
+  for (int i = 0; i < 4; ++i) {
+    streams.push_back(dev.CreateStream());
+    mems.push_back(dev.Allocate(kBytes));
+  }
+  for (int i = 0; i < 4; ++i) {
+    cpu_memset(dev.device(), streams[i], &mems[i], i + 1, kBytes,
+               dev.status());
+  }
+  // The last stream copies what the first one wrote only after it.
+  cpu_create_stream_dependency(dev.device(), streams[3], streams[0],
+                               dev.status());
+  cpu_memcpy_dtod(dev.device(), streams[3], &mems[3], &mems[0], kBytes / 2,
+                  dev.status());
+  cpu_synchronize_all_activity(dev.device(), dev.status());
+  ITEX_CHECK_EQ(TF_GetCode(dev.status()), TF_OK);
+
+  std::vector<uint8_t> out(kBytes);
+  for (int i = 0; i < 4; ++i) {
+    cpu_sync_memcpy_dtoh(dev.device(), out.data(), &mems[i], kBytes,
+                         dev.status());
+    for (size_t j = 0; j < kBytes; ++j) {
+      ITEX_CHECK_EQ(out[j], i == 3 && j < kBytes / 2 ? 1 : i + 1);
+    }
+  }
+  for (int i = 0; i < 4; ++i) {
+    cpu_deallocate(dev.device(), &mems[i]);
+    cpu_destroy_stream(dev.device(), streams[i]);
+  }
+}
+
+// Streams can be created and destroyed while synchronize_all_activity waits,
+// including the stream it waits for.
+void TestSynchronizeWhileStreamsChange() {
+  TestDevice dev(/*threaded=*/true);
+  SP_Stream blocked = dev.CreateStream();
+  Notification release;
+  cpu_host_callback(dev.device(), blocked, WaitForRelease, &release);
+  Notification synchronized;
+  std::thread synchronize([&dev, &synchronized]() {
+    TF_Status* status = TF_NewStatus();
+    cpu_synchronize_all_activity(dev.device(), status);
+    ITEX_CHECK_EQ(TF_GetCode(status), TF_OK);
+    TF_DeleteStatus(status);
+    synchronized.Notify();
+  });
+
+  SP_Stream other = dev.CreateStream();
+  SP_DeviceMemoryBase mem = dev.Allocate(kBytes);
+  cpu_memset(dev.device(), other, &mem, 7, kBytes, dev.status());
+  cpu_block_host_until_done(dev.device(), other, dev.status());
+  cpu_destroy_stream(dev.device(), other);
+  cpu_deallocate(dev.device(), &mem);
+  ITEX_CHECK(!synchronized.HasBeenNotified());
+
+  // Destroying the blocked stream waits for its work, like the drain does.
+  std::thread destroy(
+      [&dev, blocked]() { cpu_destroy_stream(dev.device(), blocked); });
+  release.Notify();
+  destroy.join();
+  synchronize.join();
+}
+
+// Device memory comes from the regions of HostNUMASubAllocator, also when the
+// allocating thread is bound to a NUMA node, and goes back to the allocator
+// when freed.
+void TestAllocate() {
+  TestDevice dev(/*threaded=*/false);
+  auto allocate_and_free = [&dev]() {
+    std::vector<SP_DeviceMemoryBase> mems;
+    for (uint64_t size : {uint64_t{64}, uint64_t{kBytes}, uint64_t{kLargeBytes},
+                          uint64_t{kLargeBytes}}) {
+      mems.push_back(dev.Allocate(size));
+      ITEX_CHECK_EQ(mems.back().size, size);
+      std::memset(mems.back().opaque, 0x5a, size);
+    }
+    for (SP_DeviceMemoryBase& mem : mems) {
+      cpu_deallocate(dev.device(), &mem);
+      ITEX_CHECK(mem.opaque == nullptr);
+    }
+  };
+  allocate_and_free();
+  if (port::NUMAEnabled()) {
+    for (int node = 0; node < port::NUMANumNodes(); ++node) {
+      std::thread thread([&allocate_and_free, node]() {
+        port::NUMASetThreadNodeAffinity(node);
+        allocate_and_free();
+      });
+      thread.join();
+    }
+  }
+
+  SP_AllocatorStats stats{SP_ALLOCATORSTATS_STRUCT_SIZE};
+  ITEX_CHECK(cpu_get_allocator_stats(dev.device(), &stats));
+  ITEX_CHECK_EQ(stats.bytes_in_use, 0);
+  ITEX_CHECK_GE(stats.peak_bytes_in_use, 2 * static_cast<int64_t>(kLargeBytes));
+  // Each large chunk needed a region of its own.
+  ITEX_CHECK_GE(stats.bytes_reserved, 2 * static_cast<int64_t>(kLargeBytes));
+
+  void* host = cpu_host_memory_allocate(dev.device(), kBytes);
+  ITEX_CHECK_EQ(reinterpret_cast<uintptr_t>(host) % 64, 0);
+  std::memset(host, 0, kBytes);
+  cpu_host_memory_deallocate(dev.device(), host);
+}
+
+}  // namespace
+}  // namespace itex
+
+int main(int argc, char** argv) {
+  for (bool threaded : {false, true}) {
+    itex::TestStreamOrder(threaded);
+    itex::TestEvents(threaded);
+    itex::TestSynchronize(threaded);
+  }
+  itex::TestSynchronizeWhileStreamsChange();
+  itex::TestAllocate();
+  std::printf("PASSED\n");
+  return 0;
+}
@@ -0,0 +1,231 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "itex/core/devices/cpu/huge_page_arena.h"
+
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "itex/core/utils/env_var.h"
+#include "itex/core/utils/logging.h"
+#include "itex/core/utils/strcat.h"
+
+namespace itex {
+
+namespace {
+
+// Transparent huge pages are 2MB on x86-64.
+constexpr size_t kTransparentHugePageBytes = size_t{2} << 20;
+
+size_t RoundUp(size_t bytes, size_t multiple) {
+  return (bytes + multiple - 1) / multiple * multiple;
+}
+
+int Log2(size_t value) {
+  int log = 0;
+  while (value >>= 1) ++log;
+  return log;
+}
+
+size_t PhysicalMemoryBytes() {
+  return static_cast<size_t>(sysconf(_SC_PHYS_PAGES)) *
+         static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+}  // namespace
+
+HugePageSubAllocator::HugePageSubAllocator(size_t huge_page_bytes,
+                                           bool use_hugetlb)
+    : huge_page_bytes_(huge_page_bytes), use_hugetlb_(use_hugetlb) {}
+
+void* HugePageSubAllocator::Alloc(size_t alignment, size_t num_bytes) {
+  // Every mapping is at least 2MB aligned, which covers any alignment the
+  // BFCAllocator asks for.
+  ITEX_CHECK_LE(alignment, kTransparentHugePageBytes);
+  Mapping mapping{0, Backing::kHugeTLB};
+  void* ptr = nullptr;
+  if (use_hugetlb_ && num_bytes >= huge_page_bytes_) {
+    ptr = MapHugeTLB(num_bytes);
+    mapping.bytes = RoundUp(num_bytes, huge_page_bytes_);
+  }
+  if (ptr == nullptr) {
+    ptr = MapTransparent(num_bytes, &mapping.backing);
+    mapping.bytes = RoundUp(num_bytes, kTransparentHugePageBytes);
+  }
+  if (ptr == nullptr) return nullptr;
+
+  mutex_lock l(&mu_);
+  mappings_[ptr] = mapping;
+  switch (mapping.backing) {
+    case Backing::kHugeTLB:
+      stats_.hugetlb_bytes += mapping.bytes;
+      break;
+    case Backing::kTransparent:
+      stats_.transparent_bytes += mapping.bytes;
+      break;
+    case Backing::kFallback:
+      stats_.fallback_bytes += mapping.bytes;
+      break;
+  }
+  ITEX_VLOG(1) << "Mapped " << mapping.bytes << " bytes of huge page arena, "
+               << stats_.hugetlb_bytes << " bytes from hugetlbfs, "
+               << stats_.transparent_bytes << " bytes transparent, "
+               << stats_.fallback_bytes << " bytes on default pages";
+  return ptr;
+}
+
+void HugePageSubAllocator::Free(void* ptr, size_t num_bytes) {
+  Mapping mapping;
+  {
+    mutex_lock l(&mu_);
+    auto it = mappings_.find(ptr);
+    ITEX_CHECK(it != mappings_.end()) << "Unknown huge page region " << ptr;
+    mapping = it->second;
+    mappings_.erase(it);
+    switch (mapping.backing) {
+      case Backing::kHugeTLB:
+        stats_.hugetlb_bytes -= mapping.bytes;
+        break;
+      case Backing::kTransparent:
+        stats_.transparent_bytes -= mapping.bytes;
+        break;
+      case Backing::kFallback:
+        stats_.fallback_bytes -= mapping.bytes;
+        break;
+    }
+  }
+  munmap(ptr, mapping.bytes);
+}
+
+HugePageSubAllocator::Stats HugePageSubAllocator::GetStats() {
+  mutex_lock l(&mu_);
+  return stats_;
+}
+
+void* HugePageSubAllocator::MapHugeTLB(size_t num_bytes) {
+#ifdef MAP_HUGETLB
+  const size_t bytes = RoundUp(num_bytes, huge_page_bytes_);
+  int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB;
+#ifdef MAP_HUGE_SHIFT
+  flags |= Log2(huge_page_bytes_) << MAP_HUGE_SHIFT;
+#endif
+  void* ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, flags, -1, 0);
+  if (ptr != MAP_FAILED) return ptr;
+
+  mutex_lock l(&mu_);
+  if (!logged_hugetlb_failure_) {
+    logged_hugetlb_failure_ = true;
+    ITEX_LOG(WARNING) << "Failed to map " << bytes << " bytes of "
+                      << (huge_page_bytes_ >> 20)
+                      << "MB huge pages: " << strerror(errno)
+                      << ". Check /proc/sys/vm/nr_hugepages. Falling back to "
+                         "transparent huge pages.";
+  }
+#endif  // MAP_HUGETLB
+  return nullptr;
+}
+
+void* HugePageSubAllocator::MapTransparent(size_t num_bytes,
+                                           Backing* backing) {
+  // Map 2MB more than needed and trim, so that the region starts on a huge
+  // page boundary and can be fully backed by huge pages.
+  const size_t bytes = RoundUp(num_bytes, kTransparentHugePageBytes);
+  const size_t mapped_bytes = bytes + kTransparentHugePageBytes;
+  void* mapped = mmap(nullptr, mapped_bytes, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mapped == MAP_FAILED) return nullptr;
+  char* begin = static_cast<char*>(mapped);
+  char* aligned = reinterpret_cast<char*>(
+      RoundUp(reinterpret_cast<uintptr_t>(begin), kTransparentHugePageBytes));
+  if (aligned > begin) munmap(begin, aligned - begin);
+  char* end = begin + mapped_bytes;
+  if (end > aligned + bytes) munmap(aligned + bytes, end - (aligned + bytes));
+
+  *backing = Backing::kFallback;
+#ifdef MADV_HUGEPAGE
+  if (madvise(aligned, bytes, MADV_HUGEPAGE) == 0) {
+    *backing = Backing::kTransparent;
+  }
+#endif
+  return aligned;
+}
+
+string HugePageArena::Stats::DebugString() const {
+  return strings::StrCat(
+      "hugetlb bytes: ", pages.hugetlb_bytes,
+      "\ntransparent huge page bytes: ", pages.transparent_bytes,
+      "\ndefault page bytes: ", pages.fallback_bytes, "\n",
+      allocator.DebugString());
+}
+
+HugePageArena::HugePageArena(const Options& opts) : opts_(opts) {
+  auto sub_allocator = std::make_unique<HugePageSubAllocator>(
+      opts_.huge_page_bytes, opts_.use_hugetlb);
+  sub_allocator_ = sub_allocator.get();
+  BFCAllocator::Options bfc_opts;
+  bfc_opts.allow_growth = true;
+  // Weights live until the graph is torn down, and the reserved hugetlbfs
+  // pool is small, so give back regions that are no longer used.
+  bfc_opts.garbage_collection = true;
+  allocator_ = std::make_unique<BFCAllocator>(std::move(sub_allocator),
+                                              PhysicalMemoryBytes(),
+                                              "itex_huge_page_bfc", bfc_opts);
+}
+
+HugePageArena* HugePageArena::Global() {
+  static HugePageArena* arena = []() -> HugePageArena* {
+    bool enabled = false;
+    TF_ABORT_IF_ERROR(
+        ReadBoolFromEnvVar("ITEX_HUGE_PAGE_ARENA", false, &enabled));
+    if (!enabled) return nullptr;
+
+    Options opts;
+    int64 huge_page_size = 2;  // unit is MB
+    TF_ABORT_IF_ERROR(ReadInt64FromEnvVar("ITEX_HUGE_PAGE_SIZE_IN_MB",
+                                          huge_page_size, &huge_page_size));
+    if (huge_page_size != 2 && huge_page_size != 1024) {
+      ITEX_LOG(WARNING) << "ITEX_HUGE_PAGE_SIZE_IN_MB must be 2 or 1024, got "
+                        << huge_page_size << ". Using 2MB huge pages.";
+      huge_page_size = 2;
+    }
+    opts.huge_page_bytes = static_cast<size_t>(huge_page_size) << 20;
+    TF_ABORT_IF_ERROR(ReadBoolFromEnvVar("ITEX_HUGE_PAGE_USE_HUGETLB", true,
+                                         &opts.use_hugetlb));
+    int64 min_temp_size = 16;  // unit is MB
+    TF_ABORT_IF_ERROR(ReadInt64FromEnvVar("ITEX_HUGE_PAGE_MIN_TEMP_SIZE_IN_MB",
+                                          min_temp_size, &min_temp_size));
+    opts.min_temp_bytes = static_cast<size_t>(std::max<int64>(min_temp_size, 0))
+                          << 20;
+    return new HugePageArena(opts);
+  }();
+  return arena;
+}
+
+void* HugePageArena::AllocateRaw(size_t num_bytes) {
+  return allocator_->AllocateRaw(num_bytes);
+}
+
+void HugePageArena::DeallocateRaw(void* ptr) { allocator_->DeallocateRaw(ptr); }
+
+HugePageArena::Stats HugePageArena::GetStats() {
+  Stats stats;
+  stats.pages = sub_allocator_->GetStats();
+  stats.allocator = allocator_->GetStats();
+  return stats;
+}
+
+}  // namespace itex
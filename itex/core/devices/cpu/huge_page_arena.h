@@ -0,0 +1,122 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef ITEX_CORE_DEVICES_CPU_HUGE_PAGE_ARENA_H_
+#define ITEX_CORE_DEVICES_CPU_HUGE_PAGE_ARENA_H_
+
+#include <memory>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "itex/core/devices/bfc_allocator.h"
+#include "itex/core/utils/mutex.h"
+
+namespace itex {
+
+// Maps the regions of a HugePageArena. Each region is first mapped from the
+// hugetlbfs pool with MAP_HUGETLB. If the pool is empty or too small, it is
+// mapped with the default page size, aligned to 2MB and advised with
+// MADV_HUGEPAGE so that transparent huge pages can back it. If that fails as
+// well, the region is left as it is.
+class HugePageSubAllocator : public SubAllocator {
+ public:
+  enum class Backing { kHugeTLB, kTransparent, kFallback };
+
+  struct Stats {
+    // Bytes mapped from the hugetlbfs pool, always on huge pages.
+    int64 hugetlb_bytes = 0;
+    // Bytes advised with MADV_HUGEPAGE. The kernel backs them with
+    // transparent huge pages when it can, see AnonHugePages in
+    // /proc/self/smaps.
+    int64 transparent_bytes = 0;
+    // Bytes on default pages.
+    int64 fallback_bytes = 0;
+  };
+
+  // `huge_page_bytes` is the page size asked for with MAP_HUGETLB, 2MB or
+  // 1GB. Regions smaller than a huge page, and all regions if `use_hugetlb`
+  // is false, skip the hugetlbfs pool.
+  HugePageSubAllocator(size_t huge_page_bytes, bool use_hugetlb);
+
+  void* Alloc(size_t alignment, size_t num_bytes) override;
+  void Free(void* ptr, size_t num_bytes) override;
+
+  Stats GetStats();
+
+ private:
+  struct Mapping {
+    size_t bytes;
+    Backing backing;
+  };
+
+  void* MapHugeTLB(size_t num_bytes);
+  void* MapTransparent(size_t num_bytes, Backing* backing);
+
+  const size_t huge_page_bytes_;
+  const bool use_hugetlb_;
+
+  mutex mu_;
+  absl::flat_hash_map<void*, Mapping> mappings_ TF_GUARDED_BY(mu_);
+  Stats stats_ TF_GUARDED_BY(mu_);
+  bool logged_hugetlb_failure_ TF_GUARDED_BY(mu_) = false;
+};
+
+// Host memory on huge pages for buffers that are read over and over, such as
+// the reordered weights of the oneDNN weight caches and large temporaries.
+// Streaming a multi-GB weight through 4KB pages misses the TLB on every
+// page; 2MB pages cut those misses by 512x. The regions come from a
+// HugePageSubAllocator and are carved up by a BFCAllocator that starts small
+// and doubles every region, see BFCAllocator::Options::allow_growth.
+class HugePageArena {
+ public:
+  struct Options {
+    // Page size of the regions mapped with MAP_HUGETLB, 2MB or 1GB.
+    size_t huge_page_bytes = size_t{2} << 20;
+    // If false, regions only use transparent huge pages.
+    bool use_hugetlb = true;
+    // Temporaries of at least this many bytes are taken from the arena.
+    // Smaller ones, and all of them if 0, stay with the framework allocator.
+    size_t min_temp_bytes = size_t{16} << 20;
+  };
+
+  struct Stats {
+    HugePageSubAllocator::Stats pages;
+    BFCAllocator::Stats allocator;
+
+    string DebugString() const;
+  };
+
+  explicit HugePageArena(const Options& opts);
+
+  // Returns the process wide arena, or nullptr unless ITEX_HUGE_PAGE_ARENA is
+  // set. The options are read from ITEX_HUGE_PAGE_SIZE_IN_MB,
+  // ITEX_HUGE_PAGE_USE_HUGETLB and ITEX_HUGE_PAGE_MIN_TEMP_SIZE_IN_MB.
+  static HugePageArena* Global();
+
+  const Options& options() const { return opts_; }
+
+  void* AllocateRaw(size_t num_bytes);
+  void DeallocateRaw(void* ptr);
+
+  Stats GetStats();
+
+ private:
+  const Options opts_;
+  HugePageSubAllocator* sub_allocator_;  // Owned by allocator_.
+  std::unique_ptr<BFCAllocator> allocator_;
+};
+
+}  // namespace itex
+#endif  // ITEX_CORE_DEVICES_CPU_HUGE_PAGE_ARENA_H_
@@ -0,0 +1,67 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "itex/core/devices/cpu/huge_page_arena.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include "itex/core/utils/logging.h"
+
+namespace itex {
+namespace {
+
+void CheckPagesCoverReservedBytes(HugePageArena* arena) {
+  HugePageArena::Stats stats = arena->GetStats();
+  ITEX_CHECK_EQ(stats.pages.hugetlb_bytes + stats.pages.transparent_bytes +
+                    stats.pages.fallback_bytes,
+                stats.allocator.bytes_reserved);
+}
+
+void TestAllocate(bool use_hugetlb) {
+  HugePageArena::Options opts;
+  opts.use_hugetlb = use_hugetlb;
+  HugePageArena arena(opts);
+
+  // Whatever the system provides, the memory is usable and every region is
+  // accounted to exactly one kind of page.
+  void* small = arena.AllocateRaw(1 << 10);
+  void* large = arena.AllocateRaw(64 << 20);
+  ITEX_CHECK(small != nullptr);
+  ITEX_CHECK(large != nullptr);
+  ITEX_CHECK_EQ(reinterpret_cast<uintptr_t>(large) % 64, 0);
+  memset(small, 1, 1 << 10);
+  memset(large, 2, 64 << 20);
+  CheckPagesCoverReservedBytes(&arena);
+
+  HugePageArena::Stats stats = arena.GetStats();
+  if (!use_hugetlb) ITEX_CHECK_EQ(stats.pages.hugetlb_bytes, 0);
+  ITEX_CHECK_EQ(stats.allocator.bytes_in_use, (64 << 20) + 1024);
+
+  arena.DeallocateRaw(small);
+  arena.DeallocateRaw(large);
+  ITEX_CHECK_EQ(arena.GetStats().allocator.bytes_in_use, 0);
+}
+
+}  // namespace
+}  // namespace itex
+
+int main(int argc, char** argv) {
+  itex::TestAllocate(/*use_hugetlb=*/true);
+  itex::TestAllocate(/*use_hugetlb=*/false);
+  std::printf("PASSED\n");
+  return 0;
+}
@@ -93,9 +93,22 @@ void gpu_host_memory_deallocate(const SP_Device* device, void* mem) {
 
 TF_Bool gpu_get_allocator_stats(const SP_Device* device,
                                 SP_AllocatorStats* stats) {
+  ITEX_GPUDevice* device_handle =
+      static_cast<ITEX_GPUDevice*>(device->device_handle);
+  std::shared_ptr<BFCAllocator> alloc;
+  auto status = ITEX_GPUGetAllocator(device_handle, &alloc);
+  if (status != ITEX_GPU_SUCCESS) return false;
+
+  BFCAllocator::Stats alloc_stats = alloc->GetStats();
   stats->struct_size = SP_ALLOCATORSTATS_STRUCT_SIZE;
-  stats->bytes_in_use = 123;
-  ITEX_LOG(ERROR) << "Get allocator stats not implemented!";
+  stats->num_allocs = alloc_stats.num_allocs;
+  stats->bytes_in_use = alloc_stats.bytes_in_use;
+  stats->peak_bytes_in_use = alloc_stats.peak_bytes_in_use;
+  stats->largest_alloc_size = alloc_stats.largest_alloc_size;
+  stats->has_bytes_limit = true;
+  stats->bytes_limit = alloc_stats.bytes_limit;
+  stats->bytes_reserved = alloc_stats.bytes_reserved;
+  stats->largest_free_block_bytes = alloc_stats.largest_free_block_bytes;
   return true;
 }
 
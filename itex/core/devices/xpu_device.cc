@@ -13,6 +13,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include "itex/core/devices/cpu/cpu_device_plugin.h"
 #include "itex/core/devices/device_backend_util.h"
 #include "itex/core/utils/types.h"
 #include "tensorflow/c/experimental/stream_executor/stream_executor.h"
@@ -36,7 +37,7 @@ void xpu_device_count(const SP_Platform* platform, int* device_count,
       itex::gpu_device_count(platform, device_count, status);
       return;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR) << "xpu_device_count BACKEND CPU is not support yet";
+      itex::cpu_device_count(platform, device_count, status);
       return;
     default:
       ITEX_LOG(ERROR) << "xpu_device_count BACKEND UNKOWN";
@@ -53,8 +54,7 @@ void xpu_create_device(const SP_Platform* platform,
       itex::gpu_create_device(platform, params, status);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR) << "xpu_create_device BACKEND CPU is not support yet";
-      REPORT_UNIMPLMENTED(status);
+      itex::cpu_create_device(platform, params, status);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_create_device BACKEND UNKOWN";
@@ -70,7 +70,7 @@ void xpu_destroy_device(const SP_Platform* platform, SP_Device* device) {
       itex::gpu_destroy_device(platform, device);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR) << "xpu_destroy_device BACKEND CPU is not support yet";
+      itex::cpu_destroy_device(platform, device);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_destroy_device BACKEND UNKOWN";
@@ -87,7 +87,7 @@ void xpu_create_device_fns(const SP_Platform* platform,
       itex::gpu_create_device_fns(platform, params, status);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR) << "xpu_create_device_fns BACKEND CPU is not support yet";
+      itex::cpu_create_device_fns(platform, params, status);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_create_device_fns BACKEND UNKOWN";
@@ -103,8 +103,7 @@ void xpu_destroy_device_fns(const SP_Platform* platform,
       itex::gpu_destroy_device_fns(platform, device_fns);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR)
-          << "xpu_destroy_device_fns BACKEND CPU is not support yet";
+      itex::cpu_destroy_device_fns(platform, device_fns);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_destroy_device_fns BACKEND UNKOWN";
@@ -120,7 +119,7 @@ void xpu_allocate(const SP_Device* device, uint64_t size, int64_t memory_space,
       itex::gpu_allocate(device, size, memory_space, mem);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR) << "xpu_allocate BACKEND CPU is not support yet";
+      itex::cpu_allocate(device, size, memory_space, mem);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_destroy_device_fns BACKEND UNKOWN";
@@ -135,7 +134,7 @@ void xpu_deallocate(const SP_Device* device, SP_DeviceMemoryBase* mem) {
       itex::gpu_deallocate(device, mem);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR) << "xpu_deallocate BACKEND CPU is not support yet";
+      itex::cpu_deallocate(device, mem);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_destroy_device_fns BACKEND UNKOWN";
@@ -149,9 +148,7 @@ void* xpu_host_memory_allocate(const SP_Device* device, uint64_t size) {
     case ITEX_BACKEND_GPU:
       return itex::gpu_host_memory_allocate(device, size);
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR)
-          << "xpu_host_memory_allocate BACKEND CPU is not support yet";
-      return nullptr;
+      return itex::cpu_host_memory_allocate(device, size);
     default:
       ITEX_LOG(ERROR) << "xpu_host_memory_allocate BACKEND UNKOWN";
       return nullptr;
@@ -165,8 +162,7 @@ void xpu_host_memory_deallocate(const SP_Device* device, void* mem) {
       itex::gpu_host_memory_deallocate(device, mem);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR)
-          << "xpu_host_memory_deallocate BACKEND CPU is not support yet";
+      itex::cpu_host_memory_deallocate(device, mem);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_host_memory_deallocate BACKEND UNKOWN";
@@ -181,9 +177,7 @@ TF_Bool xpu_get_allocator_stats(const SP_Device* device,
     case ITEX_BACKEND_GPU:
       return itex::gpu_get_allocator_stats(device, stats);
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR)
-          << "xpu_get_allocator_stats BACKEND CPU is not support yet";
-      return true;
+      return itex::cpu_get_allocator_stats(device, stats);
     default:
       ITEX_LOG(ERROR) << "xpu_get_allocator_stats BACKEND UNKOWN";
       return true;
@@ -197,9 +191,7 @@ TF_Bool xpu_device_memory_usage(const SP_Device* device, int64_t* free,
     case ITEX_BACKEND_GPU:
       return itex::gpu_device_memory_usage(device, free, total);
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR)
-          << "xpu_device_memory_usage BACKEND CPU is not support yet";
-      return true;
+      return itex::cpu_device_memory_usage(device, free, total);
     default:
       ITEX_LOG(ERROR) << "xpu_get_allocator_stats BACKEND UNKOWN";
       return true;
@@ -214,7 +206,7 @@ void xpu_create_stream(const SP_Device* device, SP_Stream* stream,
       itex::gpu_create_stream(device, stream, status);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR) << "xpu_create_stream BACKEND CPU is not support yet";
+      itex::cpu_create_stream(device, stream, status);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_create_stream BACKEND UNKOWN";
@@ -229,7 +221,7 @@ void xpu_destroy_stream(const SP_Device* device, SP_Stream stream) {
       itex::gpu_destroy_stream(device, stream);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR) << "xpu_destroy_stream BACKEND CPU is not support yet";
+      itex::cpu_destroy_stream(device, stream);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_destroy_stream BACKEND UNKOWN";
@@ -245,8 +237,7 @@ void xpu_create_stream_dependency(const SP_Device* device, SP_Stream dependent,
       itex::gpu_create_stream_dependency(device, dependent, other, status);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR)
-          << "xpu_create_stream_dependency BACKEND CPU is not support yet";
+      itex::cpu_create_stream_dependency(device, dependent, other, status);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_create_stream_dependency BACKEND UNKOWN";
@@ -262,7 +253,7 @@ void xpu_get_stream_status(const SP_Device* device, SP_Stream stream,
       itex::gpu_get_stream_status(device, stream, status);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR) << "xpu_get_stream_status BACKEND CPU is not support yet";
+      itex::cpu_get_stream_status(device, stream, status);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_get_stream_status BACKEND UNKOWN";
@@ -278,7 +269,7 @@ void xpu_create_event(const SP_Device* device, SP_Event* event,
       itex::gpu_create_event(device, event, status);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR) << "xpu_create_event BACKEND CPU is not support yet";
+      itex::cpu_create_event(device, event, status);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_create_event BACKEND UNKOWN";
@@ -293,7 +284,7 @@ void xpu_destroy_event(const SP_Device* device, SP_Event event) {
       itex::gpu_destroy_event(device, event);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR) << "xpu_destroy_event BACKEND CPU is not support yet";
+      itex::cpu_destroy_event(device, event);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_destroy_event  BACKEND UNKOWN";
@@ -307,8 +298,7 @@ SE_EventStatus xpu_get_event_status(const SP_Device* device, SP_Event event) {
     case ITEX_BACKEND_GPU:
       return itex::gpu_get_event_status(device, event);
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR) << "xpu_get_event_status BACKEND CPU is not support yet";
-      return SE_EVENT_COMPLETE;
+      return itex::cpu_get_event_status(device, event);
     default:
       ITEX_LOG(ERROR) << "xpu_get_event_status BACKEND UNKOWN";
       return SE_EVENT_COMPLETE;
@@ -323,7 +313,7 @@ void xpu_record_event(const SP_Device* device, SP_Stream stream, SP_Event event,
       itex::gpu_record_event(device, stream, event, status);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR) << "xpu_record_event BACKEND CPU is not support yet";
+      itex::cpu_record_event(device, stream, event, status);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_record_event BACKEND UNKOWN";
@@ -339,7 +329,7 @@ void xpu_wait_for_event(const SP_Device* const device, SP_Stream stream,
       itex::gpu_wait_for_event(device, stream, event, status);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR) << "xpu_wait_for_event BACKEND CPU is not support yet";
+      itex::cpu_wait_for_event(device, stream, event, status);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_wait_for_event BACKEND UNKOWN";
@@ -355,7 +345,7 @@ void xpu_create_timer(const SP_Device* device, SP_Timer* timer,
       itex::gpu_create_timer(device, timer, status);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR) << "xpu_create_timer BACKEND CPU is not support yet";
+      itex::cpu_create_timer(device, timer, status);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_create_timer BACKEND UNKOWN";
@@ -370,7 +360,7 @@ void xpu_destroy_timer(const SP_Device* device, SP_Timer timer) {
       itex::gpu_destroy_timer(device, timer);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR) << "xpu_destroy_timer BACKEND CPU is not support yet";
+      itex::cpu_destroy_timer(device, timer);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_destroy_timer BACKEND UNKOWN";
@@ -387,7 +377,7 @@ void xpu_start_timer(const SP_Device* device, SP_Stream stream, SP_Timer timer,
       itex::gpu_start_timer(device, stream, timer, status);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR) << "xpu_start_timer BACKEND CPU is not support yet";
+      itex::cpu_start_timer(device, stream, timer, status);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_start_timer BACKEND UNKOWN";
@@ -404,7 +394,7 @@ void xpu_stop_timer(const SP_Device* device, SP_Stream stream, SP_Timer timer,
       itex::gpu_stop_timer(device, stream, timer, status);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR) << "xpu_stop_timer BACKEND CPU is not support yet";
+      itex::cpu_stop_timer(device, stream, timer, status);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_stop_timer BACKEND UNKOWN";
@@ -421,7 +411,7 @@ void xpu_memcpy_dtoh(const SP_Device* device, SP_Stream stream, void* host_dst,
       itex::gpu_memcpy_dtoh(device, stream, host_dst, device_src, size, status);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR) << "xpu_memcpy_dtoh BACKEND CPU is not support yet";
+      itex::cpu_memcpy_dtoh(device, stream, host_dst, device_src, size, status);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_memcpy_dtoh BACKEND UNKOWN";
@@ -440,7 +430,7 @@ void xpu_memcpy_htod(const SP_Device* device, SP_Stream stream,
       itex::gpu_memcpy_htod(device, stream, device_dst, host_src, size, status);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR) << "xpu_memcpy_htod BACKEND CPU is not support yet";
+      itex::cpu_memcpy_htod(device, stream, device_dst, host_src, size, status);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_memcpy_htod BACKEND UNKOWN";
@@ -460,7 +450,8 @@ void xpu_memcpy_dtod(const SP_Device* device, SP_Stream stream,
                             status);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR) << "xpu_memcpy_dtoh BACKEND CPU is not support yet";
+      itex::cpu_memcpy_dtod(device, stream, device_dst, device_src, size,
+                            status);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_memcpy_dtoh BACKEND UNKOWN";
@@ -479,7 +470,7 @@ void xpu_sync_memcpy_dtoh(const SP_Device* device, void* host_dst,
       itex::gpu_sync_memcpy_dtoh(device, host_dst, device_src, size, status);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR) << "xpu_sync_memcpy_dtoh BACKEND CPU is not support yet";
+      itex::cpu_sync_memcpy_dtoh(device, host_dst, device_src, size, status);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_sync_memcpy_dtoh BACKEND UNKOWN";
@@ -498,7 +489,7 @@ void xpu_sync_memcpy_htod(const SP_Device* device,
       itex::gpu_sync_memcpy_htod(device, device_dst, host_src, size, status);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR) << "xpu_sync_memcpy_dtoh BACKEND CPU is not support yet";
+      itex::cpu_sync_memcpy_htod(device, device_dst, host_src, size, status);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_sync_memcpy_dtoh BACKEND UNKOWN";
@@ -518,7 +509,7 @@ void xpu_sync_memcpy_dtod(const SP_Device* device,
       itex::gpu_sync_memcpy_dtod(device, device_dst, device_src, size, status);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR) << "xpu_sync_memcpy_dtod BACKEND CPU is not support yet";
+      itex::cpu_sync_memcpy_dtod(device, device_dst, device_src, size, status);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_sync_memcpy_dtod BACKEND UNKOWN";
@@ -535,7 +526,7 @@ void xpu_block_host_for_event(const SP_Device* device, SP_Event event,
       itex::gpu_block_host_for_event(device, event, status);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR) << "xpu_sync_memcpy_dtod BACKEND CPU is not support yet";
+      itex::cpu_block_host_for_event(device, event, status);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_sync_memcpy_dtod BACKEND UNKOWN";
@@ -551,8 +542,7 @@ void xpu_block_host_until_done(const SP_Device* device, SP_Stream stream,
       itex::gpu_block_host_until_done(device, stream, status);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR)
-          << "xpu_block_host_until_done BACKEND CPU is not support yet";
+      itex::cpu_block_host_until_done(device, stream, status);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_block_host_until_done BACKEND UNKOWN";
@@ -569,8 +559,7 @@ void xpu_synchronize_all_activity(const SP_Device* device, TF_Status* status) {
       itex::gpu_synchronize_all_activity(device, status);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR)
-          << "xpu_synchronize_all_activity BACKEND CPU is not support yet";
+      itex::cpu_synchronize_all_activity(device, status);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_synchronize_all_activity BACKEND UNKOWN";
@@ -587,7 +576,7 @@ void xpu_mem_zero(const SP_Device* device, SP_Stream stream,
       itex::gpu_mem_zero(device, stream, location, size, status);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR) << "xpu_mem_zero BACKEND CPU is not support yet";
+      itex::cpu_mem_zero(device, stream, location, size, status);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_mem_zero BACKEND UNKOWN";
@@ -603,7 +592,7 @@ void xpu_memset(const SP_Device* device, SP_Stream stream,
       itex::gpu_memset(device, stream, location, size, pattern, status);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR) << "xpu_memset BACKEND CPU is not support yet";
+      itex::cpu_memset(device, stream, location, pattern, size, status);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_memset BACKEND UNKOWN";
@@ -619,7 +608,7 @@ void xpu_memset32(const SP_Device* device, SP_Stream stream,
       itex::gpu_memset32(device, stream, location, size, pattern, status);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR) << "xpu_memset32 BACKEND CPU is not support yet";
+      itex::cpu_memset32(device, stream, location, pattern, size, status);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_memset32 BACKEND UNKOWN";
@@ -635,8 +624,7 @@ TF_Bool xpu_host_callback(const SP_Device* device, SP_Stream stream,
     case ITEX_BACKEND_GPU:
       return itex::gpu_host_callback(device, stream, callback_fn, callback_arg);
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR) << "xpu_host_callback BACKEND CPU is not support yet";
-      return true;
+      return itex::cpu_host_callback(device, stream, callback_fn, callback_arg);
     default:
       ITEX_LOG(ERROR) << "xpu_host_callback BACKEND UNKOWN";
       return true;
@@ -691,8 +679,7 @@ void xpu_destroy_stream_executor(const SP_Platform* platform,
       itex::gpu_destroy_stream_executor(platform, stream_executor);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR)
-          << "xpu_destroy_stream_executor BACKEND CPU is not support yet";
+      itex::cpu_destroy_stream_executor(platform, stream_executor);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_destroy_stream_executor BACKEND UNKOWN";
@@ -707,7 +694,7 @@ void xpu_create_timer_fns(const SP_Platform* platform, SP_TimerFns* timer_fns,
       itex::gpu_create_timer_fns(platform, timer_fns, status);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR) << "xpu_create_timer_fns BACKEND CPU is not support yet";
+      itex::cpu_create_timer_fns(platform, timer_fns, status);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_create_timer_fns BACKEND UNKOWN";
@@ -723,7 +710,7 @@ void xpu_destroy_timer_fns(const SP_Platform* platform,
       itex::gpu_destroy_timer_fns(platform, timer_fns);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR) << "xpu_destroy_timer_fns BACKEND CPU is not support yet";
+      itex::cpu_destroy_timer_fns(platform, timer_fns);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_destroy_timer_fns BACKEND UNKOWN";
@@ -737,7 +724,7 @@ void xpu_destroy_platform(SP_Platform* const platform) {
       itex::gpu_destroy_platform(platform);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR) << "xpu_destroy_platform BACKEND CPU is not support yet";
+      itex::cpu_destroy_platform(platform);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_destroy_platform BACKEND UNKOWN";
@@ -751,8 +738,7 @@ void xpu_destroy_platform_fns(SP_PlatformFns* const platform_fns) {
       itex::gpu_destroy_platform_fns(platform_fns);
       break;
     case ITEX_BACKEND_CPU:
-      ITEX_LOG(ERROR)
-          << "xpu_destroy_platform_fns BACKEND CPU is not support yet";
+      itex::cpu_destroy_platform_fns(platform_fns);
       break;
     default:
       ITEX_LOG(ERROR) << "xpu_destroy_platform_fns BACKEND UNKOWN";
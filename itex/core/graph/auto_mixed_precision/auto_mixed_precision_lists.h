@@ -190,6 +190,8 @@ class AutoMixedPrecisionLists {
       "_ITEXPadWithConv3D",
       "_ITEXPadWithFusedConv2D",
       "_ITEXPadWithFusedConv3D",
+      "_ITEXWeightOnlyQuantMatMul",
+      "_ITEXFP8WeightMatMul",
       /*Below ops have more attrs compared to original TF ops.*/
       "_ITEXConv3D",
   };
@@ -0,0 +1,210 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "itex/core/graph/multi_tensor_apply/multi_tensor_apply.h"
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "itex/core/graph/utils/op_types.h"
+#include "itex/core/graph/utils/utils.h"
+#include "itex/core/utils/attr_value_util.h"
+#include "itex/core/utils/node_def_util.h"
+#include "itex/core/utils/strcat.h"
+
+namespace itex {
+namespace graph {
+
+namespace {
+
+// Describes the inputs of a single-variable apply op: the first `num_vars`
+// inputs are the variable and its slots, `scalar_inputs` are the shared
+// hyper-parameters in the order expected by `fused_op`.
+struct ApplyOpInfo {
+  const char* fused_op;
+  int num_vars;
+  std::vector<int> scalar_inputs;
+  int grad_input;
+  std::vector<string> attrs;
+};
+
+const std::unordered_map<string, ApplyOpInfo>& GetApplyOpInfos() {
+  static const auto* infos = new std::unordered_map<string, ApplyOpInfo>({
+      {"ResourceApplyAdam",
+       {"_ITEXMultiTensorApplyAdam",
+        3,
+        {3, 4, 5, 6, 7, 8},
+        9,
+        {"use_locking", "use_nesterov"}}},
+      {"ResourceApplyAdagradV2",
+       {"_ITEXMultiTensorApplyAdagrad",
+        2,
+        {2, 3},
+        4,
+        {"use_locking", "update_slots"}}},
+      {"ResourceApplyMomentum",
+       {"_ITEXMultiTensorApplyMomentum",
+        2,
+        {2, 4},
+        3,
+        {"use_locking", "use_nesterov"}}},
+      {"ResourceApplyRMSProp",
+       {"_ITEXMultiTensorApplyRMSProp", 3, {3, 4, 5, 6}, 7, {"use_locking"}}},
+  });
+  return *infos;
+}
+
+// Nodes can only be grouped when the fused kernel would see exactly the same
+// hyper-parameters and attrs for every variable.
+string GetGroupKey(const NodeDef& node, const ApplyOpInfo& info) {
+  string key = strings::StrCat(node.op(), ";", node.device(), ";",
+                               GetDataTypeFromAttr(node, "T"));
+  for (const string& attr : info.attrs) {
+    strings::StrAppend(&key, ";", attr, "=",
+                       node.attr().at(attr).b() ? "1" : "0");
+  }
+  for (int input : info.scalar_inputs) {
+    strings::StrAppend(&key, ";", node.input(input));
+  }
+  return key;
+}
+
+bool IsCandidate(const NodeDef& node) {
+  auto it = GetApplyOpInfos().find(node.op());
+  if (it == GetApplyOpInfos().end() || !NodeIsOnCpu(&node)) return false;
+  const DataType dtype = GetDataTypeFromAttr(node, "T");
+  if (dtype != DT_FLOAT && dtype != DT_BFLOAT16) return false;
+  for (const string& attr : it->second.attrs) {
+    if (!node.attr().count(attr)) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+Status RunMultiTensorApply(const char* device_name, const GrapplerItem& item,
+                           const GraphDef& graph_def,
+                           GraphDef* optimized_graph) {
+  *optimized_graph = graph_def;
+
+  Status status;
+  utils::MutableGraphView graph_view(optimized_graph, &status);
+  TF_RETURN_IF_ERROR(status);
+  TF_RETURN_IF_ERROR(graph_view.SortTopologically(/*ignore_cycles=*/false, {}));
+
+  // Merging two apply nodes is only safe when neither depends on the other,
+  // otherwise the fused node would feed itself. Walk the nodes in
+  // topological order and drop every candidate downstream of another one.
+  const int num_nodes = optimized_graph->node_size();
+  std::vector<bool> is_candidate(num_nodes, false);
+  std::vector<bool> after_candidate(num_nodes, false);
+  std::vector<string> group_keys;
+  std::unordered_map<string, std::vector<int>> groups;
+  for (int i = 0; i < num_nodes; ++i) {
+    auto* node_view = graph_view.GetNode(i);
+    for (const auto& fanin : node_view->GetRegularFanins()) {
+      const int j = fanin.node_index();
+      if (is_candidate[j] || after_candidate[j]) after_candidate[i] = true;
+    }
+    for (const auto& fanin : node_view->GetControllingFanins()) {
+      const int j = fanin.node_index();
+      if (is_candidate[j] || after_candidate[j]) after_candidate[i] = true;
+    }
+
+    const NodeDef* node = node_view->node();
+    if (!IsCandidate(*node)) continue;
+    is_candidate[i] = true;
+    if (after_candidate[i]) continue;
+
+    const ApplyOpInfo& info = GetApplyOpInfos().at(node->op());
+    const string key = GetGroupKey(*node, info);
+    auto& group = groups[key];
+    if (group.empty()) group_keys.push_back(key);
+    // The same variable twice in one group would be updated concurrently.
+    bool duplicated = false;
+    for (int member : group) {
+      if (graph_view.GetNode(member)->node()->input(0) == node->input(0)) {
+        duplicated = true;
+        break;
+      }
+    }
+    if (!duplicated) group.push_back(i);
+  }
+
+  utils::Mutation* mutation = graph_view.GetMutationBuilder();
+  for (const string& key : group_keys) {
+    const std::vector<int>& group = groups[key];
+    if (group.size() < 2) continue;
+
+    const NodeDef* first = graph_view.GetNode(group[0])->node();
+    const ApplyOpInfo& info = GetApplyOpInfos().at(first->op());
+    ITEX_VLOG(2) << "Group " << group.size() << " " << first->op()
+                 << " nodes into " << info.fused_op << " " << first->name();
+
+    NodeDef fused_op;
+    fused_op.set_name(first->name());
+    fused_op.set_op(info.fused_op);
+    fused_op.set_device(first->device());
+    for (int v = 0; v < info.num_vars; ++v) {
+      for (int member : group) {
+        fused_op.add_input(graph_view.GetNode(member)->node()->input(v));
+      }
+    }
+    for (int input : info.scalar_inputs) {
+      fused_op.add_input(first->input(input));
+    }
+    for (int member : group) {
+      fused_op.add_input(
+          graph_view.GetNode(member)->node()->input(info.grad_input));
+    }
+    std::unordered_set<string> control_inputs;
+    for (int member : group) {
+      for (const string& input : graph_view.GetNode(member)->node()->input()) {
+        if (IsControlInput(input) && control_inputs.insert(input).second) {
+          fused_op.add_input(input);
+        }
+      }
+    }
+
+    AddNodeAttr("T", GetDataTypeFromAttr(*first, "T"), &fused_op);
+    AddNodeAttr("N", static_cast<int>(group.size()), &fused_op);
+    for (const string& attr : info.attrs) {
+      AddNodeAttr(attr, first->attr().at(attr).b(), &fused_op);
+    }
+
+    // Keep the other node names alive for their control fanouts and fetches.
+    for (size_t m = 1; m < group.size(); ++m) {
+      const NodeDef* node = graph_view.GetNode(group[m])->node();
+      NodeDef no_op;
+      no_op.set_name(node->name());
+      no_op.set_op("NoOp");
+      no_op.set_device(node->device());
+      no_op.add_input(AsControlDependency(first->name()));
+      mutation->AddNode(std::move(no_op), &status);
+      TF_RETURN_IF_ERROR(status);
+    }
+    mutation->AddNode(std::move(fused_op), &status);
+    TF_RETURN_IF_ERROR(status);
+  }
+
+  TF_RETURN_IF_ERROR(mutation->Apply());
+  return Status::OK();
+}
+
+}  // namespace graph
+}  // namespace itex
@@ -0,0 +1,40 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef ITEX_CORE_GRAPH_MULTI_TENSOR_APPLY_MULTI_TENSOR_APPLY_H_
+#define ITEX_CORE_GRAPH_MULTI_TENSOR_APPLY_MULTI_TENSOR_APPLY_H_
+
+#include "itex/core/graph/utils/graph_view.h"
+#include "itex/core/graph/utils/grappler_item.h"
+#include "itex/core/utils/status.h"
+#include "protos/graph.pb.h"
+
+namespace itex {
+namespace graph {
+
+// Groups CPU ResourceApplyAdam / AdagradV2 / Momentum / RMSProp nodes that
+// share the same hyper-parameter inputs and attrs into one
+// _ITEXMultiTensorApply* node, so that thousands of small variables are
+// updated by a single parallel kernel instead of one kernel each. Grouped
+// nodes other than the first are replaced by NoOps controlled by the fused
+// node, which keeps their control fanouts valid.
+Status RunMultiTensorApply(const char* device_name, const GrapplerItem& item,
+                           const GraphDef& graph_def,
+                           GraphDef* optimized_graph);
+
+}  // namespace graph
+}  // namespace itex
+
+#endif  // ITEX_CORE_GRAPH_MULTI_TENSOR_APPLY_MULTI_TENSOR_APPLY_H_
@@ -24,6 +24,7 @@ limitations under the License.
 #include <utility>
 
 #include "itex/core/graph/optimizer_config.h"
+#include "itex/core/graph/utils/fusion_report.h"
 #include "itex/core/graph/utils/graph_common_utils.h"
 #include "itex/core/graph/utils/graph_properties.h"
 #include "itex/core/graph/utils/op_types.h"
@@ -3119,6 +3120,50 @@ Status RunPrePass(OneDnnGraphContext* ctx) {
   return Status::OK();
 }
 
+// Reports the nodes with an oneDNN Graph translation to the fusion report, as
+// matched if they were rewritten into an LLGA partition. "partitions" maps the
+// nodes of all partitions to whether oneDNN Graph supports their partition.
+// A non-null "graph_reason" is the reason of all nodes.
+void ReportLLGACandidates(OneDnnGraphContext* ctx, int num_nodes,
+                          const TranslationMap& translation_map,
+                          const std::unordered_set<std::string>& rewrite_nodes,
+                          const std::unordered_map<int, bool>& partitions,
+                          const std::vector<bool>& nodes_to_delete,
+                          bool onednn_graph_all_type_flag,
+                          const char* graph_reason) {
+  if (!FusionReportActive()) return;
+
+  for (int i = 0; i < num_nodes; ++i) {
+    const NodeDef* node_def = ctx->graph_view.GetNode(i)->node();
+    if (translation_map.find(node_def->op()) == translation_map.end()) continue;
+
+    BeginFusionCandidate("onednn_graph", *node_def);
+    const char* reason = nullptr;
+    auto partition = partitions.find(i);
+    if (graph_reason != nullptr) {
+      reason = graph_reason;
+    } else if (ctx->nodes_to_preserve.count(node_def->name()) > 0) {
+      reason = "fetch node is not rewritten";
+    } else if (!onednn_graph_all_type_flag &&
+               non_int8_candidate_set.count(node_def->op()) > 0) {
+      reason = "op is only selected with _ITEX_ONEDNN_GRAPH_ALL_TYPE";
+    } else if (!IsOneDnnGraphSupportedDataType(*node_def)) {
+      reason = "unsupported data type";
+    } else if (rewrite_nodes.count(node_def->name()) == 0) {
+      reason = "op translation declined the node";
+    } else if (partition == partitions.end()) {
+      reason = "node is not in any partition";
+    } else if (!partition->second) {
+      reason = "partition is not supported by oneDNN Graph";
+    } else if (!nodes_to_delete[i]) {
+      reason = "partition has no INT8 op";
+    }
+
+    if (reason != nullptr) FusionMiss(reason);
+    EndFusionAttempt("llga_partition", reason == nullptr);
+  }
+}
+
 Status RunRewritePass(OneDnnGraphContext* ctx) {
   TF_ABORT_IF_ERROR(ctx->node_type_map.Clear());
   TF_ABORT_IF_ERROR(ctx->node_type_map.Init(*ctx->graph_view.graph()));
@@ -3154,6 +3199,10 @@ Status RunRewritePass(OneDnnGraphContext* ctx) {
     if (!is_qdq_int8_graph) {
       ITEX_VLOG(2) << "Skip oneDNN Graph pass, since it is not INT8 graph and "
                       "oneDNN Graph all datatype is not enabled";
+      ReportLLGACandidates(ctx, num_nodes,
+                           tf_to_onednn_graph_op_translation_map, rewrite_nodes,
+                           {}, nodes_to_delete, onednn_graph_all_type_flag,
+                           "graph has no INT8 QuantizeV2/Dequantize pattern");
       return Status::OK();
     }
   }
@@ -3180,7 +3229,13 @@ Status RunRewritePass(OneDnnGraphContext* ctx) {
       graph_ctx.get_partitions(dnnl::graph::partition::policy::fusion);
   static int count = 0;
   LLGAEdgeManager edge_manager_tmp;
+  std::unordered_map<int, bool> partitioned_nodes;
   for (auto& it : l_partition_list) {
+    if (FusionReportActive()) {
+      for (auto node_index : it.get_ops()) {
+        partitioned_nodes[node_index] = it.is_supported();
+      }
+    }
     if (it.is_supported()) {
       count++;
       ITEX_VLOG(2) << "Number of Partitions = " << count;
@@ -3191,6 +3246,9 @@ Status RunRewritePass(OneDnnGraphContext* ctx) {
   }
 
   edge_manager.UpdateEdgeManager(edge_manager_tmp);
+  ReportLLGACandidates(ctx, num_nodes, tf_to_onednn_graph_op_translation_map,
+                       rewrite_nodes, partitioned_nodes, nodes_to_delete,
+                       onednn_graph_all_type_flag, nullptr);
 
   auto* mutation = ctx->graph_view.GetMutationBuilder();
   for (int i = 0; i < num_nodes; ++i) {
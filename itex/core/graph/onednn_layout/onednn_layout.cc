@@ -19,6 +19,7 @@ limitations under the License.
 #include <utility>
 
 #include "google/protobuf/text_format.h"
+#include "itex/core/graph/utils/fusion_report.h"
 #include "itex/core/graph/utils/graph_properties.h"
 #include "itex/core/graph/utils/graph_view.h"
 #include "itex/core/graph/utils/op_types.h"
@@ -111,7 +112,7 @@ bool RewriteWithBlockInput(const utils::MutableNodeView& node_view) {
     if (IsOneDnnLayoutDependentOp(input_node_op)) return true;
   }
 
-  return false;
+  return FusionMiss("no input is a oneDNN layout dependent op");
 }
 
 // Rewrite rule for binary ops
@@ -126,7 +127,7 @@ bool RewriteCast(const utils::MutableNodeView& node_view) {
   const NodeDef& node_def = *(node_view.node());
 
   // Do not rewrite on GPU
-  if (NodeIsOnGpu(&node_def)) return false;
+  ITEX_FUSION_MISS_IF(NodeIsOnGpu(&node_def));
 
   DataType T;
 
@@ -570,6 +571,18 @@ Status RewriteNode(OneDnnLayoutContext* ctx, const int node_index,
   return Status::OK();
 }
 
+// Reports the rewrite rules of the op of "node_def" as missed for "reason" to
+// the fusion report.
+static void ReportMissedRewrite(const NodeDef& node_def,
+                                absl::string_view reason) {
+  if (!FusionReportActive()) return;
+  for (const RewriteInfo& ri : *GetRewriteInfo()) {
+    if (node_def.op() != ri.name) continue;
+    FusionMiss(reason);
+    EndFusionAttempt(ri.new_name, false);
+  }
+}
+
 const RewriteInfo* CheckForNodeRewrite(
     const utils::MutableNodeView& node_view) {
   NodeDef& node_def = *(node_view.node());
@@ -578,7 +591,10 @@ const RewriteInfo* CheckForNodeRewrite(
     // First check if node along with its type is supported by OneDNN.
     // Do not rewrite an op if types are not supported.
     // E.g., OneDnnRelu does not support INT32.
-    if (!IsLayoutRewriteSupportedDataType(node_def)) return nullptr;
+    if (!IsLayoutRewriteSupportedDataType(node_def)) {
+      ReportMissedRewrite(node_def, "unsupported data type");
+      return nullptr;
+    }
   }
 
   // We now check if rewrite rule applies for this op. If rewrite rule passes
@@ -586,7 +602,9 @@ const RewriteInfo* CheckForNodeRewrite(
   // Find matching RewriteInfo and then check that rewrite rule applies.
   const std::vector<RewriteInfo>* rinfo = GetRewriteInfo();
   for (auto ri = rinfo->cbegin(); ri != rinfo->cend(); ++ri) {
-    if (node_def.op().compare(ri->name) == 0 && ri->rewrite_rule(node_view)) {
+    if (node_def.op().compare(ri->name) == 0 &&
+        EndFusionAttempt(ri->new_name, ri->rewrite_rule(node_view),
+                         "rewrite rule does not apply")) {
       return &*ri;
     }
   }
@@ -953,10 +971,15 @@ Status RunOneDnnLayout(const char* device_name, const GrapplerItem& item,
     // Check if node can run on current optimizer device.
     if (!NodeIsOnDevice(device_name, node_def)) continue;
 
+    BeginFusionCandidate("onednn_layout", *node_def);
+
     // Don't rewrite fetch node because layout will insert `OneDnnToTf` op
     // behind it and break the fetch node dependency.
     // TODO(itex): Rewrite fetch nodes if meeting performance regression.
-    if (ctx.nodes_to_preserve.count(node_def->name()) > 0) continue;
+    if (ctx.nodes_to_preserve.count(node_def->name()) > 0) {
+      ReportMissedRewrite(*node_def, "fetch node is not rewritten");
+      continue;
+    }
 
     const RewriteInfo* ri = nullptr;
     // We will first search if node is to be rewritten.
@@ -51,6 +51,12 @@ void SetOptimizerConfigFlags(OptimizerConfigFlags* opt_config_flags) {
   bool remapper_flag;
   bool auto_mixed_precision_flag;
   bool layout_opt_flag;
+  bool multi_tensor_apply_flag;
+  int64_t weight_only_quant_bits_value;
+  int64_t weight_only_quant_group_size_value;
+  std::string weight_fp8_format_value;
+  bool dynamic_quant_flag;
+  std::string fusion_report_dir_value;
 
   auto cfg_ = itex::itex_get_config();
 #define USER_IS_ON(CFG) cfg_.graph_options().CFG() == itex::Toggle::ON
@@ -140,6 +146,23 @@ void SetOptimizerConfigFlags(OptimizerConfigFlags* opt_config_flags) {
                                            &auto_mixed_precision_flag));
   }
 
+  ITEX_CHECK_OK(itex::ReadBoolFromEnvVar("ITEX_MULTI_TENSOR_APPLY",
+                                         enable_itex_multi_tensor_apply,
+                                         &multi_tensor_apply_flag));
+
+  ITEX_CHECK_OK(itex::ReadInt64FromEnvVar("ITEX_WEIGHT_ONLY_QUANT_BITS",
+                                          weight_only_quant_bits,
+                                          &weight_only_quant_bits_value));
+  ITEX_CHECK_OK(itex::ReadInt64FromEnvVar(
+      "ITEX_WEIGHT_ONLY_QUANT_GROUP_SIZE", weight_only_quant_group_size,
+      &weight_only_quant_group_size_value));
+  ITEX_CHECK_OK(itex::ReadStringFromEnvVar(
+      "ITEX_WEIGHT_FP8_FORMAT", weight_fp8_format, &weight_fp8_format_value));
+  ITEX_CHECK_OK(itex::ReadBoolFromEnvVar(
+      "ITEX_DYNAMIC_QUANT", enable_itex_dynamic_quant, &dynamic_quant_flag));
+  ITEX_CHECK_OK(itex::ReadStringFromEnvVar(
+      "ITEX_FUSION_REPORT_DIR", fusion_report_dir, &fusion_report_dir_value));
+
 #undef USER_IS_ON
 #undef USER_IS_OFF
 #undef USER_IS_SET
@@ -156,7 +179,14 @@ void SetOptimizerConfigFlags(OptimizerConfigFlags* opt_config_flags) {
   opt_config_flags->enable_remapper = remapper_flag;
   opt_config_flags->enable_auto_mixed_precision = auto_mixed_precision_flag;
   opt_config_flags->enable_layout_opt = layout_opt_flag;
+  opt_config_flags->enable_multi_tensor_apply = multi_tensor_apply_flag;
   opt_config_flags->remapper_run_pass = remapper_run_pass;
+  opt_config_flags->weight_only_quant_bits = weight_only_quant_bits_value;
+  opt_config_flags->weight_only_quant_group_size =
+      weight_only_quant_group_size_value;
+  opt_config_flags->weight_fp8_format = weight_fp8_format_value;
+  opt_config_flags->enable_dynamic_quant = dynamic_quant_flag;
+  opt_config_flags->fusion_report_dir = fusion_report_dir_value;
 }
 
 OptimizerConfigFlags GetOptimizerConfigFlags() {
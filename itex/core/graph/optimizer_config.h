@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef ITEX_CORE_GRAPH_OPTIMIZER_CONFIG_H_
 #define ITEX_CORE_GRAPH_OPTIMIZER_CONFIG_H_
 #include <memory>
+#include <string>
 
 #include "tensorflow/c/experimental/grappler/grappler.h"
 
@@ -32,7 +33,13 @@ constexpr static bool enable_itex_tf_constant_folding = true;
 constexpr static bool enable_itex_remapper = true;
 constexpr static bool enable_itex_auto_mixed_precision = false;
 constexpr static bool enable_itex_layout_opt = true;
+constexpr static bool enable_itex_multi_tensor_apply = false;
+constexpr static bool enable_itex_dynamic_quant = false;
 constexpr static int32_t remapper_run_pass = 2;
+constexpr static int32_t weight_only_quant_bits = 0;
+constexpr static int32_t weight_only_quant_group_size = 128;
+constexpr static char weight_fp8_format[] = "";
+constexpr static char fusion_report_dir[] = "";
 
 typedef struct _OptimizerConfigFlags {
   bool enable_sharding;
@@ -45,7 +52,21 @@ typedef struct _OptimizerConfigFlags {
   bool enable_auto_mixed_precision;
   // TODO(itex): To integrate DOC & GraphOptions
   bool enable_layout_opt;
+  // Group per-variable optimizer apply ops into multi-tensor kernels on CPU.
+  bool enable_multi_tensor_apply;
   int32_t remapper_run_pass;
+  // Bits of weight-only quantized MatMul weights, 0 means disabled.
+  int32_t weight_only_quant_bits;
+  int32_t weight_only_quant_group_size;
+  // FP8 format ("E4M3" or "E5M2") of stored MatMul weights, empty means
+  // disabled.
+  std::string weight_fp8_format;
+  // Store MatMul weights as per-channel INT8 and quantize the activation per
+  // token at run time.
+  bool enable_dynamic_quant;
+  // Directory to write the fusion coverage report of every optimized graph
+  // to, empty means disabled.
+  std::string fusion_report_dir;
 } OptimizerConfigFlags;
 
 OptimizerConfigFlags GetOptimizerConfigFlags();
@@ -20,8 +20,10 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "itex/core/graph/utils/fusion_report.h"
 #include "itex/core/graph/utils/pattern_utils.h"
 #include "itex/core/graph/utils/utils.h"
+#include "itex/core/utils/graph_metrics.h"
 
 namespace itex {
 namespace graph {
@@ -133,7 +135,8 @@ Status LaunchPatternMatcher(RemapperContext* ctx, int index,
     if (!is_full && !fusion->is_partial) continue;
     ITEX_VLOG(3) << "Start to run fusion pass: " << fusion->Name();
     auto properties = fusion->Check(ctx, index);
-    if (!properties.Empty()) {
+    if (EndFusionAttempt(fusion->Name(), !properties.Empty(),
+                         "pattern does not match")) {
       Status status = fusion->Update(ctx, properties);
 
       for (auto const& index : properties.invalidated) {
@@ -146,6 +149,7 @@ Status LaunchPatternMatcher(RemapperContext* ctx, int index,
       }
 
       ITEX_VLOG(3) << "Succeed to match fusion pass: " << fusion->Name();
+      if (status.ok()) metrics::RecordFusion(fusion->Name());
       return status;
     }
     ITEX_VLOG(3) << "Failed to match fusion pass: " << fusion->Name();
@@ -16,6 +16,7 @@ limitations under the License.
 #include "itex/core/graph/remapper/constant_names.h"
 #include "itex/core/graph/remapper/fusion.h"
 #include "itex/core/graph/remapper/remapper.h"
+#include "itex/core/graph/utils/fusion_report.h"
 #include "itex/core/graph/utils/pattern_utils.h"
 #include "itex/core/graph/utils/symbolic_shapes.h"
 #include "itex/core/graph/utils/utils.h"
@@ -365,7 +366,7 @@ class LayerNormFusionDistilBase : public Fusion {
     Tensor gamma_tensor, beta_tensor;
     gamma_tensor.FromProto(gamma_node->attr().at("value").tensor());
     beta_tensor.FromProto(beta_node->attr().at("value").tensor());
-    if (!gamma_tensor.IsSameSize(beta_tensor)) return false;
+    ITEX_FUSION_MISS_IF(!gamma_tensor.IsSameSize(beta_tensor));
 
     return true;
   }
@@ -376,14 +377,13 @@ class LayerNormFusionDistilBase : public Fusion {
     NodeDef* mean1_node = graph_view.GetNode(mean_index)->node();
 
     bool keep_dims = false;
-    if (!mean1_node || !TryGetNodeAttr(*mean1_node, "keep_dims", &keep_dims) ||
-        !keep_dims) {
-      return false;
-    }
+    ITEX_FUSION_MISS_IF(!mean1_node ||
+                        !TryGetNodeAttr(*mean1_node, "keep_dims", &keep_dims) ||
+                        !keep_dims);
     DataType dtype = GetDataTypeFromAttr(*mean1_node, "T");
     // Allow bfloat16 and float16 data type
-    if (dtype != DT_FLOAT && dtype != DT_BFLOAT16 && dtype != DT_HALF)
-      return false;
+    ITEX_FUSION_MISS_IF(dtype != DT_FLOAT && dtype != DT_BFLOAT16 &&
+                        dtype != DT_HALF);
 
     // Get the reduction axes for mean node to check if the
     // mean computation complies with layer normalization
@@ -396,7 +396,7 @@ class LayerNormFusionDistilBase : public Fusion {
     Tensor mean_axis_tensor;
     mean_axis_tensor.FromProto(mean_axis_node->attr().at("value").tensor());
     dtype = mean_axis_tensor.dtype();
-    if (dtype != DT_INT32 && dtype != DT_INT64) return false;
+    ITEX_FUSION_MISS_IF(dtype != DT_INT32 && dtype != DT_INT64);
 
     return (dtype == DT_INT32) ? IsLayerNormReduction<int32>(mean_axis_tensor)
                                : IsLayerNormReduction<int64>(mean_axis_tensor);
@@ -420,7 +420,7 @@ class LayerNormFusionDistilBase : public Fusion {
       }
     }
 
-    return false;
+    return FusionMiss("mean does not reduce the last axis of a 3-D input");
   }
 
   // Helper function for LayerNorm bfloat16/float16 fusion. Because gamma and
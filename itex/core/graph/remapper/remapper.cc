@@ -28,6 +28,7 @@ limitations under the License.
 #include "itex/core/graph/optimizer_config.h"
 #include "itex/core/graph/remapper/constant_names.h"
 #include "itex/core/graph/remapper/fusion.h"
+#include "itex/core/graph/utils/fusion_report.h"
 #include "itex/core/graph/utils/graph_common_utils.h"
 #include "itex/core/graph/utils/graph_properties.h"
 #include "itex/core/graph/utils/graph_view.h"
@@ -35,6 +36,7 @@ limitations under the License.
 #include "itex/core/graph/utils/op_types.h"
 #include "itex/core/graph/utils/pattern_utils.h"
 #include "itex/core/graph/utils/symbolic_shapes.h"
+#include "itex/core/utils/graph_metrics.h"
 #include "itex/core/utils/op_kernel.h"
 
 namespace itex {
@@ -766,14 +768,14 @@ bool FindKerasDenseLayerFwd(const RemapperContext& ctx, int node_index,
       IsInPreserveSet(ctx, node_view->node()))
     return false;
 
-  if (node_view->NumRegularFanouts() != 1) return false;
+  ITEX_FUSION_MISS_IF(node_view->NumRegularFanouts() != 1);
   const auto& reshape_fanout_0 = node_view->GetRegularFanouts()[0];
-  if (reshape_fanout_0.size() != 1) return false;
+  ITEX_FUSION_MISS_IF(reshape_fanout_0.size() != 1);
 
   const auto* biasadd = reshape_fanout_0[0].node_view();
-  if (!IsBiasAdd(*biasadd->node()) || HasControlFaninOrFanout(*biasadd) ||
-      IsInPreserveSet(ctx, biasadd->node()))
-    return false;
+  ITEX_FUSION_MISS_IF(!IsBiasAdd(*biasadd->node()) ||
+                      HasControlFaninOrFanout(*biasadd) ||
+                      IsInPreserveSet(ctx, biasadd->node()));
   bias_index = biasadd->node_index();
   if (biasadd->NumRegularFanouts() == 1) {
     const auto& biasadd_fanout_0 = biasadd->GetRegularFanouts()[0];
@@ -789,7 +791,7 @@ bool FindKerasDenseLayerFwd(const RemapperContext& ctx, int node_index,
 
   int bias_dim = 0;
   int weight_dim = 0;
-  if (biasadd->NumRegularFanins() != 2) return false;
+  ITEX_FUSION_MISS_IF(biasadd->NumRegularFanins() != 2);
   auto* readvariable = biasadd->GetRegularFanin(1).node_view();
   // if pb is frozen
   if (IsConstant(*readvariable->node())) {
@@ -804,31 +806,31 @@ bool FindKerasDenseLayerFwd(const RemapperContext& ctx, int node_index,
     if (IsCast(*readvariable->node())) {
       readvariable = readvariable->GetRegularFanin(0).node_view();
     }
-    if (!IsReadVariableOp(*readvariable->node())) return false;
+    ITEX_FUSION_MISS_IF(!IsReadVariableOp(*readvariable->node()));
     const auto* arg_bias = readvariable->GetRegularFanin(0).node_view()->node();
 
     if (IsArg(*arg_bias)) {
       const AttrValue attr_bshape = arg_bias->attr().at("_handle_shapes");
-      if (attr_bshape.list().shape().empty()) return false;
+      ITEX_FUSION_MISS_IF(attr_bshape.list().shape().empty());
       const TensorShapeProto& bshape_proto = attr_bshape.list().shape(0);
-      if (bshape_proto.unknown_rank()) return false;
+      ITEX_FUSION_MISS_IF(bshape_proto.unknown_rank());
       bias_dim = TensorShape(bshape_proto).dim_size(0);
     } else if (IsVarHandle(*arg_bias)) {
       const AttrValue attr_bshape = arg_bias->attr().at("shape");
 
       const TensorShapeProto& bshape_proto = attr_bshape.shape();
-      if (bshape_proto.unknown_rank() ||
-          IsUnknown(bshape_proto.dim(bshape_proto.dim_size() - 1)))
-        return false;
+      ITEX_FUSION_MISS_IF(
+          bshape_proto.unknown_rank() ||
+          IsUnknown(bshape_proto.dim(bshape_proto.dim_size() - 1)));
       bias_dim = TensorShape(bshape_proto).dim_size(0);
     } else {
       return false;
     }
   }
   // Arg -> ReadVariableOp -> (Cast) ->MatMul -> reshape
-  if (node_view->NumRegularFanins() != 2) return false;
+  ITEX_FUSION_MISS_IF(node_view->NumRegularFanins() != 2);
   const auto* matmul = node_view->GetRegularFanin(0).node_view();
-  if (!IsMatMul(*matmul->node())) return false;
+  ITEX_FUSION_MISS_IF(!IsMatMul(*matmul->node()));
   auto* readvariable2 = matmul->GetRegularFanin(1).node_view();
 
   // if pb is frozen
@@ -843,28 +845,28 @@ bool FindKerasDenseLayerFwd(const RemapperContext& ctx, int node_index,
     if (IsCast(*readvariable2->node())) {
       readvariable2 = readvariable2->GetRegularFanin(0).node_view();
     }
-    if (!IsReadVariableOp(*readvariable2->node())) return false;
+    ITEX_FUSION_MISS_IF(!IsReadVariableOp(*readvariable2->node()));
     const auto* arg_weight =
         readvariable2->GetRegularFanin(0).node_view()->node();
     if (IsArg(*arg_weight)) {
       const AttrValue attr_wshape = arg_weight->attr().at("_handle_shapes");
-      if (attr_wshape.list().shape().empty()) return false;
+      ITEX_FUSION_MISS_IF(attr_wshape.list().shape().empty());
       const TensorShapeProto& wshape_proto = attr_wshape.list().shape(0);
-      if (!Is2D(wshape_proto)) return false;
+      ITEX_FUSION_MISS_IF(!Is2D(wshape_proto));
       weight_dim = TensorShape(wshape_proto).dim_size(1);
     } else if (IsVarHandle(*arg_weight)) {
       const AttrValue attr_wshape = arg_weight->attr().at("shape");
       const TensorShapeProto& wshape_proto = attr_wshape.shape();
-      if (!Is2D(wshape_proto)) return false;
-      if (IsUnknown(wshape_proto.dim(wshape_proto.dim_size() - 1)))
-        return false;
+      ITEX_FUSION_MISS_IF(!Is2D(wshape_proto));
+      ITEX_FUSION_MISS_IF(
+          IsUnknown(wshape_proto.dim(wshape_proto.dim_size() - 1)));
       weight_dim = TensorShape(wshape_proto).dim_size(1);
     } else {
       return false;
     }
   }
 
-  if (bias_dim != weight_dim) return false;
+  ITEX_FUSION_MISS_IF(bias_dim != weight_dim);
 
   // For keras training, matmul will output to both reshape and shape (gradient)
   // We move the shape to BiasAdd or relu.
@@ -896,14 +898,14 @@ bool FindMatmulReshapeBiasadd(const RemapperContext& ctx, int node_index,
       IsInPreserveSet(ctx, node_view->node()))
     return false;
 
-  if (node_view->NumRegularFanouts() != 1) return false;
+  ITEX_FUSION_MISS_IF(node_view->NumRegularFanouts() != 1);
   const auto& reshape_fanout_0 = node_view->GetRegularFanouts()[0];
-  if (reshape_fanout_0.size() != 1) return false;
+  ITEX_FUSION_MISS_IF(reshape_fanout_0.size() != 1);
 
   const auto* biasadd = reshape_fanout_0[0].node_view();
-  if (!IsBiasAdd(*biasadd->node()) || HasControlFaninOrFanout(*biasadd) ||
-      IsInPreserveSet(ctx, biasadd->node()))
-    return false;
+  ITEX_FUSION_MISS_IF(!IsBiasAdd(*biasadd->node()) ||
+                      HasControlFaninOrFanout(*biasadd) ||
+                      IsInPreserveSet(ctx, biasadd->node()));
 
   bias_index = biasadd->node_index();
   if (biasadd->NumRegularFanouts() == 1) {
@@ -918,32 +920,33 @@ bool FindMatmulReshapeBiasadd(const RemapperContext& ctx, int node_index,
     }
   }
 
-  if (biasadd->NumRegularFanins() != 2) return false;
+  ITEX_FUSION_MISS_IF(biasadd->NumRegularFanins() != 2);
   auto* constant_b = biasadd->GetRegularFanin(1).node_view();
-  if (!IsConstant(*constant_b->node())) return false;
+  ITEX_FUSION_MISS_IF(!IsConstant(*constant_b->node()));
 
   // Qdq -> MatMul -> reshape
-  if (node_view->NumRegularFanins() != 2) return false;
+  ITEX_FUSION_MISS_IF(node_view->NumRegularFanins() != 2);
   auto* matmul = node_view->GetRegularFanin(0).node_view();
-  if (!IsMatMul(*matmul->node())) return false;
+  ITEX_FUSION_MISS_IF(!IsMatMul(*matmul->node()));
   auto* dequantize = matmul->GetRegularFanin(1).node_view();
-  if (!IsDequantize(*dequantize->node())) return false;
+  ITEX_FUSION_MISS_IF(!IsDequantize(*dequantize->node()));
   int bias_dim = 0;
   int weight_dim = 0;
 
   std::vector<OpInfo_TensorProperties> props_bias;
   TF_ABORT_IF_ERROR(ctx.graph_properties.GetInputProperties(
       biasadd->node()->name(), &props_bias));
-  if (props_bias.empty() || Rank(props_bias[1].shape()) < 1) return false;
+  ITEX_FUSION_MISS_IF(props_bias.empty() || Rank(props_bias[1].shape()) < 1);
   bias_dim = props_bias[1].shape().dim(0).size();
 
   std::vector<OpInfo_TensorProperties> props_weight;
   TF_ABORT_IF_ERROR(ctx.graph_properties.GetInputProperties(
       matmul->node()->name(), &props_weight));
-  if (props_weight.empty() || Rank(props_weight[1].shape()) < 2) return false;
+  ITEX_FUSION_MISS_IF(props_weight.empty() ||
+                      Rank(props_weight[1].shape()) < 2);
   weight_dim = props_weight[1].shape().dim(1).size();
 
-  if (bias_dim != weight_dim) return false;
+  ITEX_FUSION_MISS_IF(bias_dim != weight_dim);
 
   const MatmulReshapeBiasadd pattern{matmul->node_index(),
                                      node_view->node_index(), bias_index,
@@ -963,18 +966,18 @@ bool FindFusedAddN(const RemapperContext& ctx, int node_index,
 
   // TODO(itex): only support AddN+L2Loss fusion on GPU for now, will remove
   // this limitation once supported
-  if (!NodeIsOnGpu(addN)) return false;
+  ITEX_FUSION_MISS_IF(!NodeIsOnGpu(addN));
 
   int num = addN->attr().at("N").i();
   std::vector<int> inputs;
   for (int i = 0; i < num; ++i) {
     const auto* l2loss = node_view->GetRegularFanin(i).node_view();
     bool is_l2loss = l2loss->node() && (IsL2Loss(*(l2loss->node())));
-    if (!is_l2loss || !HaveSameDataType(addN, l2loss->node(), "T") ||
-        HasControlFaninOrFanout(*l2loss) ||
-        !HasAtMostOneFanoutAtPort0(*l2loss) ||
-        IsInPreserveSet(ctx, l2loss->node()))
-      return false;
+    ITEX_FUSION_MISS_IF(!is_l2loss ||
+                        !HaveSameDataType(addN, l2loss->node(), "T") ||
+                        HasControlFaninOrFanout(*l2loss) ||
+                        !HasAtMostOneFanoutAtPort0(*l2loss) ||
+                        IsInPreserveSet(ctx, l2loss->node()));
     inputs.push_back(l2loss->node_index());
   }
   const FusedAddN pattern{inputs, node_index};
@@ -996,13 +999,13 @@ bool FindContractionWithBias(const RemapperContext& ctx, int node_index,
     return false;
 
   // Input to the BiasAdd must be a Conv2D or a MatMul.
-  if (node_view->NumRegularFanins() < 1) return false;
+  ITEX_FUSION_MISS_IF(node_view->NumRegularFanins() < 1);
   const auto& regular_fanin_0 = node_view->GetRegularFanin(1 - bias_port);
   const auto* contraction_node_view = regular_fanin_0.node_view();
   const auto* contraction_node_def = contraction_node_view->node();
 
   // verify the input node has a control fanout edge or not.
-  if (HasControlFanout(*contraction_node_view)) return false;
+  ITEX_FUSION_MISS_IF(HasControlFanout(*contraction_node_view));
 
   if (IsAccMatMul(*contraction_node_def) &&
       GetDataTypeFromAttr(*node_def, "T") == DT_FLOAT &&
@@ -1010,8 +1013,8 @@ bool FindContractionWithBias(const RemapperContext& ctx, int node_index,
       !IsInPreserveSet(ctx, contraction_node_def)) {
     const ContractionWithBiasAdd pattern{contraction_node_view->node_index(),
                                          node_index, bias_port};
-    if (check_device_compatible && !IsDeviceCompatible(ctx, pattern))
-      return false;
+    ITEX_FUSION_MISS_IF(check_device_compatible &&
+                        !IsDeviceCompatible(ctx, pattern));
 
     // We successfully found a {BF16MatMul+CastFp32}+Fp32BiasAdd pattern.
     *matched = pattern;
@@ -1022,19 +1025,19 @@ bool FindContractionWithBias(const RemapperContext& ctx, int node_index,
   bool is_contraction = IsConvOrMatMul(*contraction_node_def) ||
                         IsAnyBatchMatMul(*contraction_node_def);
   // TODO(itex): oneDNN does not support double dtype currently
-  if (is_contraction && HasDataType(contraction_node_def, DT_DOUBLE))
-    return false;
+  ITEX_FUSION_MISS_IF(is_contraction &&
+                      HasDataType(contraction_node_def, DT_DOUBLE));
 
-  if (!is_contraction || !HaveSameDataType(node_def, contraction_node_def) ||
-      !HasAtMostOneFanoutAtPort0(*contraction_node_view) ||
-      IsInPreserveSet(ctx, contraction_node_def))
-    return false;
+  ITEX_FUSION_MISS_IF(!is_contraction ||
+                      !HaveSameDataType(node_def, contraction_node_def) ||
+                      !HasAtMostOneFanoutAtPort0(*contraction_node_view) ||
+                      IsInPreserveSet(ctx, contraction_node_def));
 
   // Check that data type and data format are supported on assigned device.
   const ContractionWithBiasAdd pattern{contraction_node_view->node_index(),
                                        node_index, bias_port};
-  if (check_device_compatible && !IsDeviceCompatible(ctx, pattern))
-    return false;
+  ITEX_FUSION_MISS_IF(check_device_compatible &&
+                      !IsDeviceCompatible(ctx, pattern));
 
   // We successfully found a {Conv2D, MatMul}+BiasAdd pattern.
   *matched = pattern;
@@ -1052,12 +1055,12 @@ bool FindContractionWithBiasAddGrad(const RemapperContext& ctx, int node_index,
   const auto* node_def = node_view->node();
   if (!IsBiasAddGrad(*node_def)) return false;
 
-  if (!(HasDataType(node_def, DT_FLOAT) || HasDataType(node_def, DT_BFLOAT16)))
-    return false;
+  ITEX_FUSION_MISS_IF(
+      !(HasDataType(node_def, DT_FLOAT) || HasDataType(node_def, DT_BFLOAT16)));
 
   // Don't do FP32 fusion on CPU since it has lower perf.
   // TODO(itex): Remove this limitation once oneDNN fixes it.
-  if (NodeIsOnCpu(node_def) && HasDataType(node_def, DT_FLOAT)) return false;
+  ITEX_FUSION_MISS_IF(NodeIsOnCpu(node_def) && HasDataType(node_def, DT_FLOAT));
 
   // BiasAddGrad, MatMulGradFilter and MatMulGradInput use the same input.
   //
@@ -1079,13 +1082,13 @@ bool FindContractionWithBiasAddGrad(const RemapperContext& ctx, int node_index,
   // be (m, n). So the transpose_b of MatMul to be fused must be false.
 
   const auto* dz = node_view->GetRegularFanin(0).node_view();
-  if (dz == nullptr) return false;
+  ITEX_FUSION_MISS_IF(dz == nullptr);
   // The node index for MatMulGradFilter if found.
   int matmul_grad_filter_idx = -1;
 
   // Limit this patter that dz only has 3 output, BiasAddGrad, MatMulGradFilter
   // and MatMulGradInput.
-  if (dz->NumRegularFanouts() != 3) return false;
+  ITEX_FUSION_MISS_IF(dz->NumRegularFanouts() != 3);
 
   std::vector<int> matmuls;
   for (const auto& dz_fanout_i : dz->GetRegularFanouts()) {
@@ -1096,14 +1099,14 @@ bool FindContractionWithBiasAddGrad(const RemapperContext& ctx, int node_index,
     }
   }
 
-  if (matmuls.size() != 2) return false;
+  ITEX_FUSION_MISS_IF(matmuls.size() != 2);
   if (IsLegalMatMulGrad(ctx, matmuls.at(0), dz->node_index())) {
     matmul_grad_filter_idx = matmuls.at(0);
   } else if (IsLegalMatMulGrad(ctx, matmuls.at(1), dz->node_index())) {
     matmul_grad_filter_idx = matmuls.at(1);
   }
 
-  if (matmul_grad_filter_idx < 0) return false;
+  ITEX_FUSION_MISS_IF(matmul_grad_filter_idx < 0);
 
   // We successfully found a BiasAddGrad and MatMulGradFilter pattern.
   matched->contraction = matmul_grad_filter_idx;
@@ -1129,11 +1132,11 @@ bool FindConvContractionWithBiasAddGrad(const RemapperContext& ctx,
   const auto* node_def = node_view->node();
   if (!IsBiasAddGrad(*node_def)) return false;
 
-  if (!(HasDataType(node_def, DT_FLOAT) || HasDataType(node_def, DT_BFLOAT16)))
-    return false;
+  ITEX_FUSION_MISS_IF(
+      !(HasDataType(node_def, DT_FLOAT) || HasDataType(node_def, DT_BFLOAT16)));
 
   const auto* dz = node_view->GetRegularFanin(0).node_view();
-  if (dz == nullptr) return false;
+  ITEX_FUSION_MISS_IF(dz == nullptr);
   int conv_grad_filter_idx = -1;
 
   int64_t out_port = -1;
@@ -1146,7 +1149,7 @@ bool FindConvContractionWithBiasAddGrad(const RemapperContext& ctx,
       }
     }
   }
-  if (out_port == -1) return false;
+  ITEX_FUSION_MISS_IF(out_port == -1);
 
   // 1. Conv2DBackpropFilter and BiasAddGrad should share the same out port of
   // dz since dz may have multiple output.
@@ -1164,7 +1167,7 @@ bool FindConvContractionWithBiasAddGrad(const RemapperContext& ctx,
     }
   }
 
-  if (conv_grad_filter_idx == -1) return false;
+  ITEX_FUSION_MISS_IF(conv_grad_filter_idx == -1);
   // We successfully found a BiasAddGrad and ContractionBackpropFilter pattern.
   matched->contraction = conv_grad_filter_idx;
   matched->bias_add_grad = node_view->node_index();
@@ -1185,19 +1188,18 @@ bool FindContractionWithBiasInPort(const RemapperContext& ctx,
                                    const NodeDef& add_node_def, int port_id,
                                    ContractionWithBiasAdd* base) {
   // Input to AddN must match ContractionWithBiasAdd pattern.
-  if (add_node_view.NumRegularFanins() < port_id + 1) return false;
+  ITEX_FUSION_MISS_IF(add_node_view.NumRegularFanins() < port_id + 1);
   const auto& bias_add_node_view =
       add_node_view.GetRegularFanin(port_id).node_view();
-  if (bias_add_node_view == nullptr) return false;
+  ITEX_FUSION_MISS_IF(bias_add_node_view == nullptr);
   const auto* bias_add_node_def = bias_add_node_view->node();
 
-  if (!FindContractionWithBias(ctx, bias_add_node_view->node_index(), base,
-                               /*check_device_compatible=*/false))
-    return false;
-  if (!HasAtMostOneFanoutAtPort0(*bias_add_node_view) ||
-      !HaveSameDataType(&add_node_def, bias_add_node_def) ||
-      IsInPreserveSet(ctx, bias_add_node_def))
-    return false;
+  ITEX_FUSION_MISS_IF(
+      !FindContractionWithBias(ctx, bias_add_node_view->node_index(), base,
+                               /*check_device_compatible=*/false));
+  ITEX_FUSION_MISS_IF(!HasAtMostOneFanoutAtPort0(*bias_add_node_view) ||
+                      !HaveSameDataType(&add_node_def, bias_add_node_def) ||
+                      IsInPreserveSet(ctx, bias_add_node_def));
   return true;
 }
 
@@ -1216,9 +1218,10 @@ bool FindContractionWithBiasAddAndAdd(const RemapperContext& ctx,
   if (!IsAddN(*node_def) && !IsAddWithNoBroadcast(ctx, *node_def)) return false;
 
   // OneDnn AddN ops only support float, float16 and bfloat16 data types on GPU.
-  if (!HasDataType(node_def, DT_FLOAT) && !HasDataType(node_def, DT_BFLOAT16) &&
-      !(HasDataType(node_def, DT_HALF) && NodeIsOnGpu(node_def)))
-    return false;
+  ITEX_FUSION_MISS_IF(
+      !HasDataType(node_def, DT_FLOAT) &&
+      !HasDataType(node_def, DT_BFLOAT16) &&
+      !(HasDataType(node_def, DT_HALF) && NodeIsOnGpu(node_def)));
 
   ContractionWithBiasAdd base;
   matched->port_id = 0;
@@ -1227,10 +1230,9 @@ bool FindContractionWithBiasAddAndAdd(const RemapperContext& ctx,
   if (!FindContractionWithBiasInPort(ctx, *node_view, *node_def,
                                      matched->port_id, &base)) {
     matched->port_id = 1;
-    if (!FindContractionWithBiasInPort(ctx, *node_view, *node_def,
-                                       matched->port_id, &base)) {
-      return false;
-    }
+    ITEX_FUSION_MISS_IF(
+        !FindContractionWithBiasInPort(ctx, *node_view, *node_def,
+                                       matched->port_id, &base));
   }
 
   // We successfully found a Conv2D+BiasAdd+{AddN,Add} pattern.
@@ -1251,23 +1253,23 @@ bool FindContractionWithBiasAndActivation(
   if (!IsSupportedActivation(*node_def)) return false;
 
   // verify the output node has control fanin edge or not.
-  if (HasControlFanin(*node_view)) return false;
+  ITEX_FUSION_MISS_IF(HasControlFanin(*node_view));
 
   // And input to the activation node must match ContractionWithBiasAdd pattern.
-  if (node_view->NumRegularFanins() < 1) return false;
+  ITEX_FUSION_MISS_IF(node_view->NumRegularFanins() < 1);
   const auto& regular_fanin_0 = node_view->GetRegularFanin(0);
   const auto* bias_add_node_view = regular_fanin_0.node_view();
   const auto* bias_add_node_def = bias_add_node_view->node();
 
   ContractionWithBiasAdd base;
-  if (!FindContractionWithBias(ctx, bias_add_node_view->node_index(), &base,
+  ITEX_FUSION_MISS_IF(
+      !FindContractionWithBias(ctx, bias_add_node_view->node_index(), &base,
                                /*check_device_compatible=*/false) ||
       !HasAtMostOneFanoutAtPort0(*bias_add_node_view) ||
       (!HaveSameDataType(node_def, bias_add_node_def) &&
        !(GetDataTypeFromAttr(*node_def, "T") == DT_FLOAT &&
          IsFusedAccMatMul(*bias_add_node_def))) ||
-      IsInPreserveSet(ctx, bias_add_node_def))
-    return false;
+      IsInPreserveSet(ctx, bias_add_node_def));
 
   // TODO(itex): Public TF doesn't have MatMul + LeakyRelu fusion, remove this
   //       limitation once it's supported.
@@ -1275,24 +1277,22 @@ bool FindContractionWithBiasAndActivation(
   const auto* contraction_def = contraction_node_view->node();
 
   // verify the inter node has control fanin&fanout or not.
-  if (HasControlFaninOrFanout(*bias_add_node_view)) {
-    return false;
-  }
+  ITEX_FUSION_MISS_IF(HasControlFaninOrFanout(*bias_add_node_view));
 
   // TODO(itex): oneDNN does not support double dtype currently
-  if (HasDataType(contraction_def, DT_DOUBLE)) return false;
-  if (IsLeakyRelu(*node_def) &&
+  ITEX_FUSION_MISS_IF(HasDataType(contraction_def, DT_DOUBLE));
+  ITEX_FUSION_MISS_IF(
+      IsLeakyRelu(*node_def) &&
       (IsMatMul(*contraction_def) || IsAccMatMul(*contraction_def) ||
-       IsAnyBatchMatMul(*contraction_def)))
-    return false;
+       IsAnyBatchMatMul(*contraction_def)));
 
   // Check that data type and data format are supported on assigned device.
   const ContractionWithBiasAddAndActivation pattern{
       base.contraction, base.bias_add, node_index, base.bias_port};
-  if (!IsDeviceCompatible(ctx, pattern)) return false;
+  ITEX_FUSION_MISS_IF(!IsDeviceCompatible(ctx, pattern));
 
   // verify the input node has a control fanout edge or not.
-  if (HasControlFanout(*contraction_node_view)) return false;
+  ITEX_FUSION_MISS_IF(HasControlFanout(*contraction_node_view));
 
   // We successfully found a {Conv2D, MatMul}+BiasAdd+Activation pattern.
   *matched = pattern;
@@ -1314,32 +1314,32 @@ bool FindContractionWithBiasAndAddActivation(
 
   // OneDnn activation op only supports float, float16 and bfloat16 data types
   // on GPU.
-  if (!HasDataType(node_def, DT_FLOAT) && !HasDataType(node_def, DT_BFLOAT16) &&
-      !(HasDataType(node_def, DT_HALF) && NodeIsOnGpu(node_def)))
-    return false;
+  ITEX_FUSION_MISS_IF(
+      !HasDataType(node_def, DT_FLOAT) &&
+      !HasDataType(node_def, DT_BFLOAT16) &&
+      !(HasDataType(node_def, DT_HALF) && NodeIsOnGpu(node_def)));
 
   // And input to activation must match ContractionWithBiasAddAndAdd pattern.
-  if (node_view->NumRegularFanins() < 1) return false;
+  ITEX_FUSION_MISS_IF(node_view->NumRegularFanins() < 1);
   const auto& regular_fanin_0 = node_view->GetRegularFanin(0);
   const auto* add_node_view = regular_fanin_0.node_view();
   const auto* add_node_def = add_node_view->node();
 
   ContractionWithBiasAddAndAdd base;
-  if (!FindContractionWithBiasAddAndAdd(ctx, add_node_view->node_index(),
+  ITEX_FUSION_MISS_IF(
+      !FindContractionWithBiasAddAndAdd(ctx, add_node_view->node_index(),
                                         &base) ||
       !HasAtMostOneFanoutAtPort0(*add_node_view) ||
       !HaveSameDataType(node_def, add_node_def) ||
-      IsInPreserveSet(ctx, add_node_def)) {
-    return false;
-  }
+      IsInPreserveSet(ctx, add_node_def));
 
   // TODO(itex): Public TF doesn't have MatMul + LeakyRelu fusion, remove this
   //       limitation once it's supported.
   const auto* contraction_def =
       ctx.graph_view.GetNode(base.contraction)->node();
-  if (IsLeakyRelu(*node_def) &&
-      (IsMatMul(*contraction_def) || IsAccMatMul(*contraction_def)))
-    return false;
+  ITEX_FUSION_MISS_IF(
+      IsLeakyRelu(*node_def) &&
+      (IsMatMul(*contraction_def) || IsAccMatMul(*contraction_def)));
 
   // We successfully found a Conv2D+BiasAdd+AddN+activation pattern.
   const ContractionWithBiasAndAddActivation pattern{
@@ -1353,19 +1353,15 @@ bool FindContractionWithBiasAndAddActivation(
 bool FindContractionWithBiasAndActivationInPort(
     const RemapperContext& ctx, const utils::MutableNodeView& add_node_view,
     const NodeDef& add_node_def, int port_id) {
-  if (add_node_view.NumRegularFanins() < port_id + 1) return false;
+  ITEX_FUSION_MISS_IF(add_node_view.NumRegularFanins() < port_id + 1);
 
   const auto& act_node_view =
       add_node_view.GetRegularFanin(port_id).node_view();
-  if (act_node_view == nullptr) return false;
+  ITEX_FUSION_MISS_IF(act_node_view == nullptr);
   const auto* act_node_def = act_node_view->node();
 
-  if (!IsSupportedActivation(*act_node_def)) {
-    return false;
-  }
-  if (!HasAtMostOneFanoutAtPort0(*act_node_view)) {
-    return false;
-  }
+  ITEX_FUSION_MISS_IF(!IsSupportedActivation(*act_node_def));
+  ITEX_FUSION_MISS_IF(!HasAtMostOneFanoutAtPort0(*act_node_view));
   return true;
 }
 
@@ -1381,31 +1377,30 @@ bool FindContractionWithBiasAndActivationAdd(
   if (!IsAdd(*node_def)) return false;
   // OneDnn activation op only supports float, float16 and bfloat16 data types
   // on GPU.
-  if (!HasDataType(node_def, DT_FLOAT) && !HasDataType(node_def, DT_BFLOAT16) &&
-      !(HasDataType(node_def, DT_HALF) && NodeIsOnGpu(node_def)))
-    return false;
+  ITEX_FUSION_MISS_IF(
+      !HasDataType(node_def, DT_FLOAT) &&
+      !HasDataType(node_def, DT_BFLOAT16) &&
+      !(HasDataType(node_def, DT_HALF) && NodeIsOnGpu(node_def)));
 
   ContractionWithBiasAddAndActivation base;
   if (!FindContractionWithBiasAndActivationInPort(ctx, *node_view, *node_def,
                                                   matched->port_id)) {
     matched->port_id = 1;
-    if (!FindContractionWithBiasAndActivationInPort(ctx, *node_view, *node_def,
-                                                    matched->port_id)) {
-      return false;
-    }
+    ITEX_FUSION_MISS_IF(
+        !FindContractionWithBiasAndActivationInPort(ctx, *node_view, *node_def,
+                                                    matched->port_id));
   }
   const auto& act_node_view =
       node_view->GetRegularFanin(matched->port_id).node_view();
-  if (!FindContractionWithBiasAndActivation(ctx, act_node_view->node_index(),
-                                            &base)) {
-    return false;
-  }
+  ITEX_FUSION_MISS_IF(
+      !FindContractionWithBiasAndActivation(ctx, act_node_view->node_index(),
+                                            &base));
 
   const auto* contraction_def =
       ctx.graph_view.GetNode(base.contraction)->node();
-  if (IsLeakyRelu(*node_def) &&
-      (IsMatMul(*contraction_def) || IsAccMatMul(*contraction_def)))
-    return false;
+  ITEX_FUSION_MISS_IF(
+      IsLeakyRelu(*node_def) &&
+      (IsMatMul(*contraction_def) || IsAccMatMul(*contraction_def)));
 
   // We successfully found a Conv2D+BiasAdd+AddN+activation pattern.
   const ContractionWithBiasAndActivationAdd pattern{
@@ -1454,7 +1449,7 @@ bool FindFusedBatchNormEx(const RemapperContext& ctx, int node_index,
     return true;
   };
 
-  if (node_view->NumRegularFanins() < 1) return false;
+  ITEX_FUSION_MISS_IF(node_view->NumRegularFanins() < 1);
   const auto& regular_fanin_0 = node_view->GetRegularFanin(0);
   const auto* relu_fanin_0_node_view = regular_fanin_0.node_view();
   const auto* relu_fanin_0_node_def = relu_fanin_0_node_view->node();
@@ -1470,23 +1465,22 @@ bool FindFusedBatchNormEx(const RemapperContext& ctx, int node_index,
   if (IsAdd(*relu_fanin_0_node_def)) {
     // Currently no CPU implementation for "FusedBatchNorm + SideInput +
     // <Activation>""
-    if (!NodeIsOnGpu(node_def)) return false;
+    ITEX_FUSION_MISS_IF(!NodeIsOnGpu(node_def));
 
     // Check that only Relu node consumes the output of an Add node.
-    if (HasControlFaninOrFanout(*relu_fanin_0_node_view) ||
-        !HasAtMostOneFanoutAtPort0(*relu_fanin_0_node_view) ||
-        IsInPreserveSet(ctx, relu_fanin_0_node_def))
-      return false;
+    ITEX_FUSION_MISS_IF(HasControlFaninOrFanout(*relu_fanin_0_node_view) ||
+                        !HasAtMostOneFanoutAtPort0(*relu_fanin_0_node_view) ||
+                        IsInPreserveSet(ctx, relu_fanin_0_node_def));
 
     // Add node supports broadcasting, FusedBatchNormEx does not.
     std::vector<OpInfo_TensorProperties> props;
     TF_ABORT_IF_ERROR(ctx.graph_properties.GetInputProperties(
         relu_fanin_0_node_def->name(), &props));
-    if (props.size() < 2 ||
-        !ShapesSymbolicallyEqual(props[0].shape(), props[1].shape()))
-      return false;
+    ITEX_FUSION_MISS_IF(
+        props.size() < 2 ||
+        !ShapesSymbolicallyEqual(props[0].shape(), props[1].shape()));
 
-    if (relu_fanin_0_node_view->NumRegularFanins() < 2) return false;
+    ITEX_FUSION_MISS_IF(relu_fanin_0_node_view->NumRegularFanins() < 2);
     const auto& add_regular_fanin_0 =
         relu_fanin_0_node_view->GetRegularFanin(0);
     const auto& add_regular_fanin_1 =
@@ -1521,13 +1515,11 @@ bool FindDequantizeWithShape(const RemapperContext& ctx, int node_index,
   auto* dequantize_node_view = node_view->GetRegularFanin(0).node_view();
   auto* dequantize_node_def = dequantize_node_view->node();
 
-  if (!IsDequantize(*dequantize_node_def)) return false;
+  ITEX_FUSION_MISS_IF(!IsDequantize(*dequantize_node_def));
 
-  if (HasControlFaninOrFanout(*dequantize_node_view) ||
-      !HasAtMostOneFanoutAtPort0(*dequantize_node_view) ||
-      IsInPreserveSet(ctx, dequantize_node_def)) {
-    return false;
-  }
+  ITEX_FUSION_MISS_IF(HasControlFaninOrFanout(*dequantize_node_view) ||
+                      !HasAtMostOneFanoutAtPort0(*dequantize_node_view) ||
+                      IsInPreserveSet(ctx, dequantize_node_def));
 
   const DequantizeWithShape pattern{dequantize_node_view->node_index(),
                                     node_view->node_index()};
@@ -1549,7 +1541,7 @@ bool FindDequantizeWithReshape(const RemapperContext& ctx, int node_index,
   auto* dequantize_node_view = node_view->GetRegularFanin(0).node_view();
   auto* dequantize_node_def = dequantize_node_view->node();
 
-  if (!IsDequantize(*dequantize_node_def)) return false;
+  ITEX_FUSION_MISS_IF(!IsDequantize(*dequantize_node_def));
 
   // diable this pattern when the father node of dequantize is quantizedConv2D
   auto* conv2d_node_view = dequantize_node_view->GetRegularFanin(0).node_view();
@@ -1561,11 +1553,9 @@ bool FindDequantizeWithReshape(const RemapperContext& ctx, int node_index,
     return false;
   }
 
-  if (HasControlFaninOrFanout(*dequantize_node_view) ||
-      !HasAtMostOneFanoutAtPort0(*dequantize_node_view) ||
-      IsInPreserveSet(ctx, dequantize_node_def)) {
-    return false;
-  }
+  ITEX_FUSION_MISS_IF(HasControlFaninOrFanout(*dequantize_node_view) ||
+                      !HasAtMostOneFanoutAtPort0(*dequantize_node_view) ||
+                      IsInPreserveSet(ctx, dequantize_node_def));
 
   const DequantizeWithReshape pattern{dequantize_node_view->node_index(),
                                       node_view->node_index()};
@@ -1585,13 +1575,11 @@ bool FindQuantizeV2WithQuantizedConv2D(const RemapperContext& ctx,
   auto* quantizev2_node_view = node_view->GetRegularFanin(0).node_view();
   auto* quantizev2_node_def = quantizev2_node_view->node();
 
-  if (!IsQuantizeV2(*quantizev2_node_def)) return false;
+  ITEX_FUSION_MISS_IF(!IsQuantizeV2(*quantizev2_node_def));
 
-  if (HasControlFaninOrFanout(*quantizev2_node_view) ||
-      !HasAtMostOneFanoutAtPort0(*quantizev2_node_view) ||
-      IsInPreserveSet(ctx, quantizev2_node_def)) {
-    return false;
-  }
+  ITEX_FUSION_MISS_IF(HasControlFaninOrFanout(*quantizev2_node_view) ||
+                      !HasAtMostOneFanoutAtPort0(*quantizev2_node_view) ||
+                      IsInPreserveSet(ctx, quantizev2_node_def));
 
   const QuantizeV2WithQuantizedConv2D pattern{
       quantizev2_node_view->node_index(), node_view->node_index()};
@@ -1611,7 +1599,7 @@ bool FindAddV2WithSoftmax(const RemapperContext& ctx, int node_index,
   auto* addv2_node_view = node_view->GetRegularFanin(0).node_view();
   auto* addv2_node_def = addv2_node_view->node();
 
-  if (!IsAdd(*addv2_node_def)) return false;
+  ITEX_FUSION_MISS_IF(!IsAdd(*addv2_node_def));
 
   // check the shape of input nodes of AddV2
   std::vector<OpInfo_TensorProperties> props;
@@ -1627,15 +1615,11 @@ bool FindAddV2WithSoftmax(const RemapperContext& ctx, int node_index,
       (left_shape.dim(0).size() != right_shape.dim(0).size()) ||
       (left_shape.dim(2).size() != right_shape.dim(2).size()) ||
       (left_shape.dim(3).size() != right_shape.dim(3).size());
-  if (is_non_supported_shape) {
-    return false;
-  }
+  ITEX_FUSION_MISS_IF(is_non_supported_shape);
 
-  if (HasControlFaninOrFanout(*addv2_node_view) ||
-      !HasAtMostOneFanoutAtPort0(*addv2_node_view) ||
-      IsInPreserveSet(ctx, addv2_node_def)) {
-    return false;
-  }
+  ITEX_FUSION_MISS_IF(HasControlFaninOrFanout(*addv2_node_view) ||
+                      !HasAtMostOneFanoutAtPort0(*addv2_node_view) ||
+                      IsInPreserveSet(ctx, addv2_node_def));
 
   const AddV2WithSoftmax pattern{addv2_node_view->node_index(),
                                  node_view->node_index()};
@@ -1660,13 +1644,12 @@ bool FindQuantizedConv2DWithDequantize(const RemapperContext& ctx,
   auto* conv2d_node_view = node_view->GetRegularFanin(0).node_view();
   auto* conv2d_node_def = conv2d_node_view->node();
 
-  if (!IsQuantizedConv2DWithBiasAndRequantize(*conv2d_node_def)) return false;
+  ITEX_FUSION_MISS_IF(
+      !IsQuantizedConv2DWithBiasAndRequantize(*conv2d_node_def));
 
-  if (HasControlFaninOrFanout(*conv2d_node_view) ||
-      !HasAtMostOneFanoutAtPort0(*conv2d_node_view) ||
-      IsInPreserveSet(ctx, conv2d_node_def)) {
-    return false;
-  }
+  ITEX_FUSION_MISS_IF(HasControlFaninOrFanout(*conv2d_node_view) ||
+                      !HasAtMostOneFanoutAtPort0(*conv2d_node_view) ||
+                      IsInPreserveSet(ctx, conv2d_node_def));
 
   const QuantizedConv2DWithDequantize pattern{conv2d_node_view->node_index(),
                                               node_view->node_index()};
@@ -1686,15 +1669,11 @@ bool FindQuantizedConv2DWithCast(const RemapperContext& ctx, int node_index,
   if (!IsCast(*node_def)) return false;
   auto* conv2d_node_view = node_view->GetRegularFanin(0).node_view();
   auto* conv2d_node_def = conv2d_node_view->node();
-  if (!IsQuantizedConv2DWithDequantize(*conv2d_node_def)) {
-    return false;
-  }
+  ITEX_FUSION_MISS_IF(!IsQuantizedConv2DWithDequantize(*conv2d_node_def));
 
-  if (HasControlFaninOrFanout(*conv2d_node_view) ||
-      !HasAtMostOneFanoutAtPort0(*conv2d_node_view) ||
-      IsInPreserveSet(ctx, conv2d_node_def)) {
-    return false;
-  }
+  ITEX_FUSION_MISS_IF(HasControlFaninOrFanout(*conv2d_node_view) ||
+                      !HasAtMostOneFanoutAtPort0(*conv2d_node_view) ||
+                      IsInPreserveSet(ctx, conv2d_node_def));
 
   const QuantizedConv2DWithCast pattern{conv2d_node_view->node_index(),
                                         node_view->node_index()};
@@ -1734,7 +1713,7 @@ bool FindFusedBatchNormGradEx(const RemapperContext& ctx, int node_index,
 
   if (!valid_batch_norm_grad(*node_view)) return false;
 
-  if (node_view->NumRegularFanins() < 1) return false;
+  ITEX_FUSION_MISS_IF(node_view->NumRegularFanins() < 1);
 
   const utils::MutableFanoutView& regular_fanin_0 =
       node_view->GetRegularFanin(0);
@@ -1743,10 +1722,10 @@ bool FindFusedBatchNormGradEx(const RemapperContext& ctx, int node_index,
   const NodeDef* relugrad_node_def = relugrad_node_view->node();
   bool is_relugrad = IsReluGrad(*relugrad_node_def);
 
-  if (!is_relugrad || HasControlFaninOrFanout(*relugrad_node_view))
-    return false;
+  ITEX_FUSION_MISS_IF(!is_relugrad ||
+                      HasControlFaninOrFanout(*relugrad_node_view));
 
-  if (relugrad_node_view->NumRegularFanins() < 1) return false;
+  ITEX_FUSION_MISS_IF(relugrad_node_view->NumRegularFanins() < 1);
   // Find its corresponding forward node. We need the node to determine if the
   // type is bn+add+act or bn+act. Also, we need to access its "offset" input.
   const utils::MutableFanoutView& fanin_1 =
@@ -1776,9 +1755,8 @@ bool FindFusedBatchNormGradEx(const RemapperContext& ctx, int node_index,
     // reserve space to get the directly corresponded forward BatchNorm node.
     const utils::MutableFanoutView& fwd_batch_norm_node =
         node_view->GetRegularFanin(5);
-    if (fwd_matched.fused_batch_norm != fwd_batch_norm_node.node_index()) {
-      return false;
-    }
+    ITEX_FUSION_MISS_IF(
+        fwd_matched.fused_batch_norm != fwd_batch_norm_node.node_index());
 
     const std::vector<utils::MutableFaninView>& fanouts_at_port_0 =
         relugrad_node_view->GetRegularFanouts()[0];
@@ -1791,7 +1769,7 @@ bool FindFusedBatchNormGradEx(const RemapperContext& ctx, int node_index,
     const NodeDef* node_def = node_view->node();
 
     // We fuse FusedBatchNormGrad with side input on GPU.
-    if (!NodeIsOnGpu(node_def)) return false;
+    ITEX_FUSION_MISS_IF(!NodeIsOnGpu(node_def));
 
     matched->activation_grad = regular_fanin_0.node_index();
     matched->fused_batch_norm_grad = node_index;
@@ -1828,41 +1806,40 @@ bool FindPadWithContraction(const RemapperContext& ctx, int node_index,
   }
 
   // Input to the contraction must be Pad.
-  if (node_view->NumRegularFanins() < 1) return false;
+  ITEX_FUSION_MISS_IF(node_view->NumRegularFanins() < 1);
   const auto& regular_fanin_0 = node_view->GetRegularFanin(0);
   const auto* pad_node_view = regular_fanin_0.node_view();
   const auto* pad_node_def = pad_node_view->node();
 
   // Only Pad is allowed, PadV2 will be prevented.
-  if (pad_node_def->op() != "Pad") return false;
+  ITEX_FUSION_MISS_IF(pad_node_def->op() != "Pad");
 
   // Only fuse contraction with `VALID` padding.
   // TODO(itex): Support more padding type in future.
   string padding_str;
   TF_ABORT_IF_ERROR(GetNodeAttr(*node_def, "padding", &padding_str));
-  if (padding_str != "VALID") return false;
+  ITEX_FUSION_MISS_IF(padding_str != "VALID");
 
   // Only fuse contraction with INT32 padding.
   // TODO(itex): support INT64 padding in future.
-  if (!HasDataType(pad_node_def, DT_INT32, "Tpaddings")) return false;
+  ITEX_FUSION_MISS_IF(!HasDataType(pad_node_def, DT_INT32, "Tpaddings"));
 
   // If contraction has been fused, only fuse it with Pad when only has Bias.
   if (node_def->op() == kFusedConv2D || node_def->op() == kFusedConv3D) {
     int num_args;
     TF_ABORT_IF_ERROR(GetNodeAttr(*node_def, "num_args", &num_args));
-    if (num_args != 1) return false;
+    ITEX_FUSION_MISS_IF(num_args != 1);
   }
 
-  if (!HaveSameDataType(node_def, pad_node_def) ||
-      HasControlFaninOrFanout(*pad_node_view) ||
-      !HasAtMostOneFanoutAtPort0(*pad_node_view) ||
-      IsInPreserveSet(ctx, pad_node_def))
-    return false;
+  ITEX_FUSION_MISS_IF(!HaveSameDataType(node_def, pad_node_def) ||
+                      HasControlFaninOrFanout(*pad_node_view) ||
+                      !HasAtMostOneFanoutAtPort0(*pad_node_view) ||
+                      IsInPreserveSet(ctx, pad_node_def));
 
   // Check that data type and data format are supported on assigned device.
   const PadWithContraction pattern{pad_node_view->node_index(), node_index};
-  if (check_device_compatible && !IsDeviceCompatible(ctx, pattern))
-    return false;
+  ITEX_FUSION_MISS_IF(check_device_compatible &&
+                      !IsDeviceCompatible(ctx, pattern));
 
   // We successfully found a Pad + Conv2D/_ITEXFusedConv2D pattern.
   *matched = pattern;
@@ -1886,27 +1863,24 @@ bool FindConvBackpropInputWithSlice(const RemapperContext& ctx, int node_index,
                IsConv3DBackpropInputV2(*conv_node_def);
   is_ok = is_ok && conv_node_view->NumRegularFanouts() == 1;
 
-  if (!is_ok) {
-    return false;
-  }
+  ITEX_FUSION_MISS_IF(!is_ok);
 
   // Only fuse contraction with `VALID` padding.
   // TODO(itex): Support more padding type in future.
   string padding_str;
   TF_ABORT_IF_ERROR(GetNodeAttr(*conv_node_def, "padding", &padding_str));
-  if (padding_str != "VALID") return false;
+  ITEX_FUSION_MISS_IF(padding_str != "VALID");
 
-  if (!HaveSameDataType(node_def, conv_node_def) ||
-      HasControlFaninOrFanout(*conv_node_view) ||
-      !HasAtMostOneFanoutAtPort0(*conv_node_view) ||
-      IsInPreserveSet(ctx, conv_node_def))
-    return false;
+  ITEX_FUSION_MISS_IF(!HaveSameDataType(node_def, conv_node_def) ||
+                      HasControlFaninOrFanout(*conv_node_view) ||
+                      !HasAtMostOneFanoutAtPort0(*conv_node_view) ||
+                      IsInPreserveSet(ctx, conv_node_def));
 
   // Check that data type and data format are supported on assigned device.
   const ConvBackpropInputWithSlice pattern{node_index,
                                            conv_node_view->node_index()};
-  if (check_device_compatible && !IsDeviceCompatible(ctx, pattern))
-    return false;
+  ITEX_FUSION_MISS_IF(check_device_compatible &&
+                      !IsDeviceCompatible(ctx, pattern));
 
   *matched = pattern;
 
@@ -1936,13 +1910,11 @@ bool FindConv2DBackpropInputWithSliceLLGA(const RemapperContext& ctx,
   bool is_ok = IsConv2DBackpropInput(*conv_node_def);
   is_ok = is_ok && conv_node_view->NumRegularFanouts() == 1;
 
-  if (!is_ok) {
-    return false;
-  }
+  ITEX_FUSION_MISS_IF(!is_ok);
 
   const auto* slice_start_node_view = node_view->GetRegularFanin(1).node_view();
   const auto* slice_start_node = slice_start_node_view->node();
-  if (!IsAnyConst(*slice_start_node)) return false;
+  ITEX_FUSION_MISS_IF(!IsAnyConst(*slice_start_node));
 
   Tensor slice_start_tensor;
   std::vector<int> slice_start_value;
@@ -1957,13 +1929,11 @@ bool FindConv2DBackpropInputWithSliceLLGA(const RemapperContext& ctx,
 
   // Specialized version for RN50 training
   // TODO(itex): Implement fusion with more relaxed shape checking
-  if (slice_start_value != std::vector<int>{0, 1, 1, 0}) {
-    return false;
-  }
+  ITEX_FUSION_MISS_IF(slice_start_value != std::vector<int>{0, 1, 1, 0});
 
   const auto* slice_size_node_view = node_view->GetRegularFanin(2).node_view();
   const auto* slice_size_node = slice_size_node_view->node();
-  if (!IsAnyConst(*slice_size_node)) return false;
+  ITEX_FUSION_MISS_IF(!IsAnyConst(*slice_size_node));
 
   Tensor slice_size_tensor;
   std::vector<int> slice_size_value;
@@ -1979,7 +1949,7 @@ bool FindConv2DBackpropInputWithSliceLLGA(const RemapperContext& ctx,
   const auto* input_size_node_view =
       conv_node_view->GetRegularFanin(0).node_view();
   const auto* input_size_node = input_size_node_view->node();
-  if (!IsAnyConst(*input_size_node)) return false;
+  ITEX_FUSION_MISS_IF(!IsAnyConst(*input_size_node));
 
   Tensor input_size_tensor;
   std::vector<int> input_size_value;
@@ -1994,26 +1964,25 @@ bool FindConv2DBackpropInputWithSliceLLGA(const RemapperContext& ctx,
 
   int length = input_size_tensor.NumElements();
   for (int i = 0; i < length; i++) {
-    if (slice_start_value[i] * 2 + slice_size_value[i] != input_size_value[i])
-      return false;
+    ITEX_FUSION_MISS_IF(
+        slice_start_value[i] * 2 + slice_size_value[i] != input_size_value[i]);
   }
 
   // Only fuse contraction with `VALID` padding.
   // TODO(itex): Support more padding type in future.
   string padding_str;
   TF_ABORT_IF_ERROR(GetNodeAttr(*conv_node_def, "padding", &padding_str));
-  if (padding_str != "VALID") return false;
+  ITEX_FUSION_MISS_IF(padding_str != "VALID");
 
-  if (!HaveSameDataType(node_def, conv_node_def) ||
-      !HasAtMostOneFanoutAtPort0(*conv_node_view) ||
-      IsInPreserveSet(ctx, conv_node_def))
-    return false;
+  ITEX_FUSION_MISS_IF(!HaveSameDataType(node_def, conv_node_def) ||
+                      !HasAtMostOneFanoutAtPort0(*conv_node_view) ||
+                      IsInPreserveSet(ctx, conv_node_def));
 
   // Check that data type and data format are supported on assigned device.
   const ConvBackpropInputWithSlice pattern{node_index,
                                            conv_node_view->node_index()};
-  if (check_device_compatible && !IsDeviceCompatible(ctx, pattern))
-    return false;
+  ITEX_FUSION_MISS_IF(check_device_compatible &&
+                      !IsDeviceCompatible(ctx, pattern));
 
   *matched = pattern;
 
@@ -2063,25 +2032,24 @@ bool FindFusedTrainingOp(const RemapperContext& ctx, int node_index,
     return false;
   }
   // TrainingOp has control output
-  if (HasControlFanin(*node_view)) return false;
+  ITEX_FUSION_MISS_IF(HasControlFanin(*node_view));
 
   const auto* input_node_view =
       node_view->GetRegularFanin(input_index).node_view();
   const auto* input_node_def = input_node_view->node();
 
-  if (!HasAtMostOneFanoutAtPort0(*input_node_view) ||
-      !HaveSameDataType(node_def, input_node_def) ||
-      IsInPreserveSet(ctx, input_node_def))
-    return false;
+  ITEX_FUSION_MISS_IF(!HasAtMostOneFanoutAtPort0(*input_node_view) ||
+                      !HaveSameDataType(node_def, input_node_def) ||
+                      IsInPreserveSet(ctx, input_node_def));
 
   if (IsAddN(*input_node_def)) {
     // Mul + AddN + Adam_op is not supported
-    if (IsApplyAdam(*node_def) || IsResourceApplyAdam(*node_def) ||
-        IsApplyAdamWithWeightDecay(*node_def) ||
-        IsResourceApplyAdamWithWeightDecay(*node_def))
-      return false;
+    ITEX_FUSION_MISS_IF(IsApplyAdam(*node_def) ||
+                        IsResourceApplyAdam(*node_def) ||
+                        IsApplyAdamWithWeightDecay(*node_def) ||
+                        IsResourceApplyAdamWithWeightDecay(*node_def));
     int input_num = input_node_def->attr().at("N").i();
-    if (input_num != 2) return false;
+    ITEX_FUSION_MISS_IF(input_num != 2);
 
     int input_mul_port = 0;
     auto* mul_node_view = input_node_view->GetRegularFanin(0).node_view();
@@ -2093,18 +2061,17 @@ bool FindFusedTrainingOp(const RemapperContext& ctx, int node_index,
       mul_node_index =
           FindFusedTrainingOpInPort(*mul_node_view, *input_node_def);
     }
-    if (mul_node_index == -1) return false;
+    ITEX_FUSION_MISS_IF(mul_node_index == -1);
 
     const auto* mul_node_def = mul_node_view->node();
-    if (!HasAtMostOneFanoutAtPort0(*mul_node_view) ||
-        !HaveSameDataType(node_def, mul_node_def) ||
-        IsInPreserveSet(ctx, mul_node_def))
-      return false;
+    ITEX_FUSION_MISS_IF(!HasAtMostOneFanoutAtPort0(*mul_node_view) ||
+                        !HaveSameDataType(node_def, mul_node_def) ||
+                        IsInPreserveSet(ctx, mul_node_def));
 
     // Mul has two inputs, at least one input should be scalar
     int scalar_input_index =
         GetMulScalarInputIndex(ctx, *mul_node_view->node());
-    if (scalar_input_index == -1) return false;
+    ITEX_FUSION_MISS_IF(scalar_input_index == -1);
 
     matched->mul = mul_node_index;
     matched->mul_port = input_mul_port;
@@ -2142,12 +2109,12 @@ bool FindFusedTrainingOp(const RemapperContext& ctx, int node_index,
   } else if (IsMul(*input_node_def)) {
     // Currently, we don't implement Mul + Momemtum fusion. Only Mul + AddN +
     // Momemtum is supported.
-    if (IsApplyMomentum(*node_def) || IsResourceApplyMomentum(*node_def))
-      return false;
+    ITEX_FUSION_MISS_IF(IsApplyMomentum(*node_def) ||
+                        IsResourceApplyMomentum(*node_def));
 
     // Mul has two inputs, at least one input should be scalar
     int scalar_input_index = GetMulScalarInputIndex(ctx, *input_node_def);
-    if (scalar_input_index == -1) return false;
+    ITEX_FUSION_MISS_IF(scalar_input_index == -1);
 
     matched->mul = input_node_view->node_index();
     matched->training_op = node_index;
@@ -2176,7 +2143,7 @@ bool FindContractionWithMul(const RemapperContext& ctx, int node_index,
 
   // Mul has two inputs, one input should be scalar
   int scalar_input_index = GetMulScalarInputIndex(ctx, *node_def);
-  if (scalar_input_index == -1) return false;
+  ITEX_FUSION_MISS_IF(scalar_input_index == -1);
 
   auto* const_node_view =
       node_view->GetRegularFanin(scalar_input_index).node_view();
@@ -2185,23 +2152,22 @@ bool FindContractionWithMul(const RemapperContext& ctx, int node_index,
 
   // Currently we only fuse BatchMatMul with Mul
   auto* contraction_node_def = contraction_node_view->node();
-  if (!IsAnyBatchMatMul(*contraction_node_def)) return false;
+  ITEX_FUSION_MISS_IF(!IsAnyBatchMatMul(*contraction_node_def));
 
   auto* const_node_def = const_node_view->node();
-  if (!IsAnyConst(*const_node_def)) return false;
+  ITEX_FUSION_MISS_IF(!IsAnyConst(*const_node_def));
 
   bool hasValidType = false;
   hasValidType =
       (HasDataType(node_def, DT_FLOAT) || HasDataType(node_def, DT_BFLOAT16) ||
        (HasDataType(node_def, DT_HALF) && NodeIsOnGpu(node_def)));
 
-  if (!hasValidType) return false;
+  ITEX_FUSION_MISS_IF(!hasValidType);
 
-  if (!HaveSameDataType(node_def, contraction_node_def) ||
-      HasControlFaninOrFanout(*contraction_node_view) ||
-      !HasAtMostOneFanoutAtPort0(*contraction_node_view) ||
-      IsInPreserveSet(ctx, contraction_node_def))
-    return false;
+  ITEX_FUSION_MISS_IF(!HaveSameDataType(node_def, contraction_node_def) ||
+                      HasControlFaninOrFanout(*contraction_node_view) ||
+                      !HasAtMostOneFanoutAtPort0(*contraction_node_view) ||
+                      IsInPreserveSet(ctx, contraction_node_def));
 
   const ContractionWithMul pattern{contraction_node_view->node_index(),
                                    node_index, const_node_view->node_index()};
@@ -2223,20 +2189,19 @@ bool FindBf16ContractionGradWithCastFp32(
 
   DataType dst_dtype = GetDataTypeFromAttr(*node_def, "DstT");
   DataType src_dtype = GetDataTypeFromAttr(*node_def, "SrcT");
-  if (dst_dtype != DT_FLOAT || src_dtype != DT_BFLOAT16) return false;
+  ITEX_FUSION_MISS_IF(dst_dtype != DT_FLOAT || src_dtype != DT_BFLOAT16);
 
-  if (node_view->NumRegularFanins() != 1) return false;
+  ITEX_FUSION_MISS_IF(node_view->NumRegularFanins() != 1);
   const auto& regular_fanin_0 = node_view->GetRegularFanin(0);
   const auto* contraction = regular_fanin_0.node_view();
   const auto* contraction_node_def = contraction->node();
-  if (!IsFusedMatmulGrad(*contraction_node_def)) return false;
+  ITEX_FUSION_MISS_IF(!IsFusedMatmulGrad(*contraction_node_def));
 
   const auto& contraction_fanout1 = contraction->GetRegularFanout(1);
 
-  if (contraction_fanout1.size() > 1 ||
-      IsInPreserveSet(ctx, contraction_node_def) ||
-      HasControlFaninOrFanout(*contraction))
-    return false;
+  ITEX_FUSION_MISS_IF(contraction_fanout1.size() > 1 ||
+                      IsInPreserveSet(ctx, contraction_node_def) ||
+                      HasControlFaninOrFanout(*contraction));
 
   const auto* cast1 = contraction_fanout1[0].node_view();
   if (cast1->node_index() == node_view->node_index()) {
@@ -2260,25 +2225,24 @@ bool FindBf16ContractionWithCastFp32(const RemapperContext& ctx, int node_index,
 
   if (!IsCast(*node_def) || HasControlFaninOrFanout(*node_view)) return false;
 
-  if (node_view->NumRegularFanins() != 1) return false;
+  ITEX_FUSION_MISS_IF(node_view->NumRegularFanins() != 1);
   const auto& regular_fanin_0 = node_view->GetRegularFanin(0);
   const auto* contraction = regular_fanin_0.node_view();
   const auto* contraction_node_def = contraction->node();
-  if (!IsMatMul(*contraction_node_def) && !IsFusedMatmul(*contraction_node_def))
-    return false;
+  ITEX_FUSION_MISS_IF(!IsMatMul(*contraction_node_def) &&
+                      !IsFusedMatmul(*contraction_node_def));
 
   DataType contraction_dtype = GetDataTypeFromAttr(*contraction_node_def, "T");
   DataType dst_dtype = GetDataTypeFromAttr(*node_def, "DstT");
 
   // Now, (Fused)Matmul + Cast fusion only support T is DT_BFLOAT16, DstT is
   // DT_FLOAT.
-  if ((contraction_dtype != DT_BFLOAT16) || (dst_dtype != DT_FLOAT))
-    return false;
+  ITEX_FUSION_MISS_IF((contraction_dtype != DT_BFLOAT16) ||
+                      (dst_dtype != DT_FLOAT));
 
-  if (!HasAtMostOneFanoutAtPort0(*contraction) ||
-      IsInPreserveSet(ctx, contraction_node_def) ||
-      HasControlFaninOrFanout(*contraction))
-    return false;
+  ITEX_FUSION_MISS_IF(!HasAtMostOneFanoutAtPort0(*contraction) ||
+                      IsInPreserveSet(ctx, contraction_node_def) ||
+                      HasControlFaninOrFanout(*contraction));
 
   if (IsMatMul(*contraction_node_def)) {
     bool is_BiasAddGrad = false;
@@ -2300,8 +2264,8 @@ bool FindBf16ContractionWithCastFp32(const RemapperContext& ctx, int node_index,
     }
 
     if (is_BiasAddGrad) {
-      if (IsLegalMatMulGrad(ctx, contraction->node_index(), dz_index))
-        return false;
+      ITEX_FUSION_MISS_IF(
+          IsLegalMatMulGrad(ctx, contraction->node_index(), dz_index));
     }
   }
 
@@ -2318,27 +2282,26 @@ bool FindComparisonWithCast(const RemapperContext& ctx, int node_index,
 
   if (!IsCast(*node_def) || HasControlFaninOrFanout(*node_view)) return false;
 
-  if (node_view->NumRegularFanins() != 1) return false;
+  ITEX_FUSION_MISS_IF(node_view->NumRegularFanins() != 1);
   const auto& regular_fanin_0 = node_view->GetRegularFanin(0);
   const auto* comparison = regular_fanin_0.node_view();
   const auto* comparison_node_def = comparison->node();
-  if (!IsComparison(*comparison_node_def) ||
-      HasControlFaninOrFanout(*comparison))
-    return false;
+  ITEX_FUSION_MISS_IF(!IsComparison(*comparison_node_def) ||
+                      HasControlFaninOrFanout(*comparison));
 
   DataType comparator_dtype = GetDataTypeFromAttr(*comparison_node_def, "T");
   DataType src_dtype = GetDataTypeFromAttr(*node_def, "SrcT");
   DataType dst_dtype = GetDataTypeFromAttr(*node_def, "DstT");
 
-  if ((comparator_dtype != DT_FLOAT) && (comparator_dtype != DT_BFLOAT16) &&
-      !(comparator_dtype == DT_HALF && NodeIsOnGpu(comparison_node_def)))
-    return false;
-  if ((comparator_dtype != dst_dtype) || (src_dtype != DT_BOOL)) return false;
+  ITEX_FUSION_MISS_IF(
+      (comparator_dtype != DT_FLOAT) && (comparator_dtype != DT_BFLOAT16) &&
+      !(comparator_dtype == DT_HALF && NodeIsOnGpu(comparison_node_def)));
+  ITEX_FUSION_MISS_IF((comparator_dtype != dst_dtype) ||
+                      (src_dtype != DT_BOOL));
 
   // Check that only one node consumes the 0-th output of a comparison.
-  if (!HasAtMostOneFanoutAtPort0(*comparison) ||
-      IsInPreserveSet(ctx, comparison_node_def))
-    return false;
+  ITEX_FUSION_MISS_IF(!HasAtMostOneFanoutAtPort0(*comparison) ||
+                      IsInPreserveSet(ctx, comparison_node_def));
 
   matched->cast = node_index;
   matched->comparison = regular_fanin_0.node_index();
@@ -2358,9 +2321,9 @@ bool FindRandomWithComparisonAndCast(const RemapperContext& ctx, int node_index,
   const auto* node_view =
       ctx.graph_view.GetNode(comparison_with_cast.comparison);
 
-  if (node_view->NumRegularFanins() != 2) return false;
+  ITEX_FUSION_MISS_IF(node_view->NumRegularFanins() != 2);
   const auto* node_def = node_view->node();
-  if (!IsGreaterEqual(*node_def)) return false;
+  ITEX_FUSION_MISS_IF(!IsGreaterEqual(*node_def));
 
   std::vector<OpInfo_TensorProperties> props;
   TF_ABORT_IF_ERROR(
@@ -2374,28 +2337,26 @@ bool FindRandomWithComparisonAndCast(const RemapperContext& ctx, int node_index,
   };
 
   matched->direction = 0;
-  if (!HasRandom(matched->direction)) {
-    return false;
-  }
+  ITEX_FUSION_MISS_IF(!HasRandom(matched->direction));
   auto compare_shape = props[1 - matched->direction].shape();
-  if (Rank(compare_shape) != 0) return false;
+  ITEX_FUSION_MISS_IF(Rank(compare_shape) != 0);
 
   const auto& regular_fanin = node_view->GetRegularFanin(matched->direction);
   const auto* random = regular_fanin.node_view();
   const auto* random_node_def = random->node();
 
-  if (HasControlFaninOrFanout(*random)) return false;
+  ITEX_FUSION_MISS_IF(HasControlFaninOrFanout(*random));
 
   DataType random_dtype = GetDataTypeFromAttr(*random_node_def, "dtype");
 
-  if ((random_dtype != DT_FLOAT) && (random_dtype != DT_BFLOAT16) &&
-      !(random_dtype == DT_HALF && NodeIsOnGpu(random_node_def)))
-    return false;
+  ITEX_FUSION_MISS_IF(
+      (random_dtype != DT_FLOAT) && (random_dtype != DT_BFLOAT16) &&
+      !(random_dtype == DT_HALF && NodeIsOnGpu(random_node_def)));
 
   // Check that only one node consumes the 0-th output of a random.
-  if (!HasAtMostOneFanoutAtPort0(*random) ||
-      IsInPreserveSet(ctx, random_node_def) || HasControlFaninOrFanout(*random))
-    return false;
+  ITEX_FUSION_MISS_IF(!HasAtMostOneFanoutAtPort0(*random) ||
+                      IsInPreserveSet(ctx, random_node_def) ||
+                      HasControlFaninOrFanout(*random));
 
   matched->cast = comparison_with_cast.cast;
   matched->comparison = comparison_with_cast.comparison;
@@ -2476,7 +2437,7 @@ bool FindMulWithMaximum(const RemapperContext& ctx, int node_index,
     matched->alpha = alpha_value;
     return true;
   }
-  return false;
+  return FusionMiss("no Mul fanin by a scalar alpha <= 1 of the same input");
 }
 
 // Find Const + Cast pattern.
@@ -2487,12 +2448,12 @@ bool FindConstWithCast(const RemapperContext& ctx, int node_index,
 
   if (!IsCast(*node_def) || HasControlFaninOrFanout(*node_view)) return false;
 
-  if (node_view->NumRegularFanins() != 1) return false;
+  ITEX_FUSION_MISS_IF(node_view->NumRegularFanins() != 1);
   const auto& regular_fanin_0 = node_view->GetRegularFanin(0);
   const auto* constant = regular_fanin_0.node_view();
   const auto* constant_node_def = constant->node();
-  if (!IsConstant(*constant_node_def) || HasControlFaninOrFanout(*constant))
-    return false;
+  ITEX_FUSION_MISS_IF(!IsConstant(*constant_node_def) ||
+                      HasControlFaninOrFanout(*constant));
 
   DataType constant_dtype = GetDataTypeFromAttr(*constant_node_def, "dtype");
   DataType src_dtype = GetDataTypeFromAttr(*node_def, "SrcT");
@@ -2501,9 +2462,8 @@ bool FindConstWithCast(const RemapperContext& ctx, int node_index,
 
   // Now, Const + Cast fusion only support SrcT is DT_FLOAT, DstT is DT_BFLOAT16
   // or DT_HALF, and truncate is false.
-  if ((constant_dtype != DT_FLOAT) || (src_dtype == dst_dtype) ||
-      (truncate == true))
-    return false;
+  ITEX_FUSION_MISS_IF((constant_dtype != DT_FLOAT) ||
+                      (src_dtype == dst_dtype) || (truncate == true));
 
   // As Const + Cast fusion will create a new tensor, it requires the tensor
   // size is valid
@@ -2511,13 +2471,12 @@ bool FindConstWithCast(const RemapperContext& ctx, int node_index,
   const TensorShape shape(raw_val.tensor_shape());
   const int64_t num_tensor_values = shape.num_elements();
 
-  if (num_tensor_values <= 0) return false;
+  ITEX_FUSION_MISS_IF(num_tensor_values <= 0);
 
-  if ((dst_dtype != DT_BFLOAT16) && (dst_dtype != DT_HALF)) return false;
+  ITEX_FUSION_MISS_IF((dst_dtype != DT_BFLOAT16) && (dst_dtype != DT_HALF));
 
-  if (!HasAtMostOneFanoutAtPort0(*constant) ||
-      IsInPreserveSet(ctx, constant_node_def))
-    return false;
+  ITEX_FUSION_MISS_IF(!HasAtMostOneFanoutAtPort0(*constant) ||
+                      IsInPreserveSet(ctx, constant_node_def));
 
   matched->cast = node_index;
   matched->constant = regular_fanin_0.node_index();
@@ -2549,21 +2508,20 @@ bool FindPadConvFwdBwd(const RemapperContext& ctx, int node_index,
 
   const auto& pad_node_view = node_view->GetRegularFanin(0).node_view();
   const auto* pad_node_def = pad_node_view->node();
-  if (!IsPad(*pad_node_def) || HasControlFanin(*pad_node_view)) return false;
+  ITEX_FUSION_MISS_IF(!IsPad(*pad_node_def) || HasControlFanin(*pad_node_view));
 
   matched->pad = pad_node_view->node_index();
 
   const auto& bn_node_view = pad_node_view->GetRegularFanin(0).node_view();
-  if (HasControlFanout(*bn_node_view)) return false;
+  ITEX_FUSION_MISS_IF(HasControlFanout(*bn_node_view));
 
   matched->input_bn = bn_node_view->node_index();
 
   const auto& const_pad_val_node_view =
       pad_node_view->GetRegularFanin(1).node_view();
   const auto* const_pad_val_node_def = const_pad_val_node_view->node();
-  if (!IsAnyConst(*const_pad_val_node_def) ||
-      HasControlFaninOrFanout(*const_pad_val_node_view))
-    return false;
+  ITEX_FUSION_MISS_IF(!IsAnyConst(*const_pad_val_node_def) ||
+                      HasControlFaninOrFanout(*const_pad_val_node_view));
 
   matched->input_pad_val = const_pad_val_node_view->node_index();
 
@@ -2572,25 +2530,23 @@ bool FindPadConvFwdBwd(const RemapperContext& ctx, int node_index,
     if (pad_out_node_view->node_index() == node_view->node_index()) {
       continue;
     } else if (IsConv2D(*(pad_out_node_view->node()))) {
-      if (HasControlFanin(*pad_out_node_view)) {
-        return false;
-      }
+      ITEX_FUSION_MISS_IF(HasControlFanin(*pad_out_node_view));
       matched->conv2d = pad_out_node_view->node_index();
     } else {
       return false;
     }
   }
 
-  if (pad_node_view->GetControlledFanouts().size() != 2) return false;
+  ITEX_FUSION_MISS_IF(pad_node_view->GetControlledFanouts().size() != 2);
 
   auto* const_shape_0_node_view =
       pad_node_view->GetControlledFanouts()[0].node_view();
-  if (!IsAnyConst(*const_shape_0_node_view->node())) return false;
+  ITEX_FUSION_MISS_IF(!IsAnyConst(*const_shape_0_node_view->node()));
   matched->const_shape_0 = const_shape_0_node_view->node_index();
 
   auto* const_shape_1_node_view =
       pad_node_view->GetControlledFanouts()[1].node_view();
-  if (!IsAnyConst(*const_shape_1_node_view->node())) return false;
+  ITEX_FUSION_MISS_IF(!IsAnyConst(*const_shape_1_node_view->node()));
   matched->const_shape_1 = const_shape_1_node_view->node_index();
 
   return true;
@@ -2611,9 +2567,10 @@ bool FindFusedBinary(const RemapperContext& ctx, int node_index,
   // Only support Add/Mul/Sub now because they satisfy the commutative law.
   if (!IsAdd(*node_def) && !IsMul(*node_def) && !IsSub(*node_def)) return false;
 
-  if (!HasDataType(node_def, DT_FLOAT) && !HasDataType(node_def, DT_BFLOAT16) &&
-      !(HasDataType(node_def, DT_HALF) && NodeIsOnGpu(node_def)))
-    return false;
+  ITEX_FUSION_MISS_IF(
+      !HasDataType(node_def, DT_FLOAT) &&
+      !HasDataType(node_def, DT_BFLOAT16) &&
+      !(HasDataType(node_def, DT_HALF) && NodeIsOnGpu(node_def)));
 
   // Returns true iff the node is a compatible FusedBatchNorm node.
   const auto valid_shape = [&](const utils::MutableNodeView& binary) -> bool {
@@ -2631,7 +2588,7 @@ bool FindFusedBinary(const RemapperContext& ctx, int node_index,
     return true;
   };
 
-  if (!valid_shape(*node_view)) return false;
+  ITEX_FUSION_MISS_IF(!valid_shape(*node_view));
 
   // Initialize root node.
   matched->root_ = node_index;
@@ -2693,12 +2650,13 @@ bool FindDropout(const RemapperContext& ctx, int node_index, Dropout* matched) {
 
   if (!IsSelect(*node_def) || HasControlFanin(*node_view)) return false;
 
-  if (!HasDataType(node_def, DT_FLOAT) && !HasDataType(node_def, DT_BFLOAT16) &&
-      !(HasDataType(node_def, DT_HALF) && NodeIsOnGpu(node_def)))
-    return false;
+  ITEX_FUSION_MISS_IF(
+      !HasDataType(node_def, DT_FLOAT) &&
+      !HasDataType(node_def, DT_BFLOAT16) &&
+      !(HasDataType(node_def, DT_HALF) && NodeIsOnGpu(node_def)));
 
   // SelectOp has 3 input, condition, t and e
-  if (node_view->NumRegularFanins() != 3) return false;
+  ITEX_FUSION_MISS_IF(node_view->NumRegularFanins() != 3);
 
   // Returns true iff the select is meet dropout op shape.
   const auto valid_shape = [&](const utils::MutableNodeView& select) -> bool {
@@ -2716,20 +2674,19 @@ bool FindDropout(const RemapperContext& ctx, int node_index, Dropout* matched) {
     return false;
   };
 
-  if (!valid_shape(*node_view)) return false;
+  ITEX_FUSION_MISS_IF(!valid_shape(*node_view));
 
   const auto& regular_fanin_0 = node_view->GetRegularFanin(0);
   const auto* greater_equal = regular_fanin_0.node_view();
   const auto* greater_equal_node_def = greater_equal->node();
-  if (!IsGreaterEqual(*greater_equal_node_def) ||
-      HasControlFanout(*greater_equal))
-    return false;
+  ITEX_FUSION_MISS_IF(!IsGreaterEqual(*greater_equal_node_def) ||
+                      HasControlFanout(*greater_equal));
 
   const auto& regular_fanin_2 = node_view->GetRegularFanin(2);
   const auto* constant = regular_fanin_2.node_view();
   const auto* constant_node_def = constant->node();
-  if (!IsConstant(*constant_node_def) || HasControlFaninOrFanout(*constant))
-    return false;
+  ITEX_FUSION_MISS_IF(!IsConstant(*constant_node_def) ||
+                      HasControlFaninOrFanout(*constant));
 
   // Returns true iff the const value is 0.
   const auto valid_value = [&](const utils::MutableNodeView& constant) -> bool {
@@ -2756,10 +2713,10 @@ bool FindDropout(const RemapperContext& ctx, int node_index, Dropout* matched) {
     return true;
   };
 
-  if (!valid_value(*constant)) return false;
+  ITEX_FUSION_MISS_IF(!valid_value(*constant));
 
   // GreaterEqual has 2 output, fwd and bwd select
-  if (!(greater_equal->GetRegularFanout(0).size() == 2)) return false;
+  ITEX_FUSION_MISS_IF(!(greater_equal->GetRegularFanout(0).size() == 2));
 
   int select_1_index =
       greater_equal->GetRegularFanout(0)[0].node_index() == node_index
@@ -2768,20 +2725,20 @@ bool FindDropout(const RemapperContext& ctx, int node_index, Dropout* matched) {
 
   const auto* select_1_node_view = ctx.graph_view.GetNode(select_1_index);
   const auto* select_1_node_def = select_1_node_view->node();
-  if (!IsSelect(*select_1_node_def) || HasControlFanin(*select_1_node_view))
-    return false;
-  if (!HasDataType(select_1_node_def, DT_FLOAT) &&
+  ITEX_FUSION_MISS_IF(!IsSelect(*select_1_node_def) ||
+                      HasControlFanin(*select_1_node_view));
+  ITEX_FUSION_MISS_IF(
+      !HasDataType(select_1_node_def, DT_FLOAT) &&
       !HasDataType(select_1_node_def, DT_BFLOAT16) &&
       !(HasDataType(select_1_node_def, DT_HALF) &&
-        NodeIsOnGpu(select_1_node_def)))
-    return false;
+        NodeIsOnGpu(select_1_node_def)));
 
   // SelectOp has 3 input, condition, t and e
-  if (select_1_node_view->NumRegularFanins() != 3) return false;
-  if (!valid_shape(*select_1_node_view)) return false;
+  ITEX_FUSION_MISS_IF(select_1_node_view->NumRegularFanins() != 3);
+  ITEX_FUSION_MISS_IF(!valid_shape(*select_1_node_view));
 
-  if (!valid_value(*(select_1_node_view->GetRegularFanin(2).node_view())))
-    return false;
+  ITEX_FUSION_MISS_IF(
+      !valid_value(*(select_1_node_view->GetRegularFanin(2).node_view())));
 
   matched->select_0 = node_index;
   matched->select_1 = select_1_index;
@@ -2808,10 +2765,9 @@ bool FindResNeXtGroupConv2DBlock(const RemapperContext& ctx, int node_index,
   auto* concat_node_view = ctx.graph_view.GetNode(node_index);
   auto* concat_node_def = concat_node_view->node();
   if (!IsConcat(*concat_node_def)) return false;
-  if (!HasDataType(concat_node_def, DT_FLOAT) &&
-      !HasDataType(concat_node_def, DT_BFLOAT16) &&
-      !(HasDataType(concat_node_def, DT_HALF)))
-    return false;
+  ITEX_FUSION_MISS_IF(!HasDataType(concat_node_def, DT_FLOAT) &&
+                      !HasDataType(concat_node_def, DT_BFLOAT16) &&
+                      !(HasDataType(concat_node_def, DT_HALF)));
 
   int64 N;
   TF_ABORT_IF_ERROR(GetNodeAttr(*concat_node_view->node(), "N", &N));
@@ -2837,9 +2793,7 @@ bool FindResNeXtGroupConv2DBlock(const RemapperContext& ctx, int node_index,
   // Do simple pre-check for Conv & Split first.
   auto* conv0_node_view = concat_fanin_0.node_view();
   NodeDef* conv0_node = conv0_node_view->node();
-  if (!IsConv2D(*conv0_node)) {
-    return false;
-  }
+  ITEX_FUSION_MISS_IF(!IsConv2D(*conv0_node));
 
   std::string data_format_0;
   TF_ABORT_IF_ERROR(GetNodeAttr(*conv0_node, "data_format", &data_format_0));
@@ -2848,26 +2802,21 @@ bool FindResNeXtGroupConv2DBlock(const RemapperContext& ctx, int node_index,
   auto* split0_node_def = split0_node_view->node();
   int split0_index = split0_node_view->node_index();
   int64 num_split;
-  if (!IsSplit(*split0_node_def)) {
-    return false;
-  }
+  ITEX_FUSION_MISS_IF(!IsSplit(*split0_node_def));
   TF_ABORT_IF_ERROR(GetNodeAttr(*split0_node_def, "num_split", &num_split));
   int32 split_axis = getAxis(*split0_node_view, 0);
 
-  if (num_split != N || split_axis != concat_axis) {
-    return false;
-  }
+  ITEX_FUSION_MISS_IF(num_split != N || split_axis != concat_axis);
 
-  if (HasControlFaninOrFanout(*split0_node_view) ||
-      !HasAtMostOneFanoutAtPort0(*split0_node_view) ||
-      IsInPreserveSet(ctx, split0_node_def))
-    return false;
+  ITEX_FUSION_MISS_IF(HasControlFaninOrFanout(*split0_node_view) ||
+                      !HasAtMostOneFanoutAtPort0(*split0_node_view) ||
+                      IsInPreserveSet(ctx, split0_node_def));
 
   if (data_format_0 == "NCHW") {
-    if (split_axis != 1) return false;
+    ITEX_FUSION_MISS_IF(split_axis != 1);
   } else if (data_format_0 == "NHWC") {
     bool wrong_nhwc_axis = (split_axis != -1 && split_axis != 3);
-    if (wrong_nhwc_axis) return false;
+    ITEX_FUSION_MISS_IF(wrong_nhwc_axis);
   } else {
     ITEX_CHECK(false) << "Unsupported format in GroupConv fusion";
   }
@@ -2889,10 +2838,8 @@ bool FindResNeXtGroupConv2DBlock(const RemapperContext& ctx, int node_index,
   };
   TensorShape first_conv_shape = getWeightShape(*conv0_node_view);
 
-  if (!TensorShapeUtils::IsVector(first_conv_shape) ||
-      !first_conv_shape.IsValid()) {
-    return false;
-  }
+  ITEX_FUSION_MISS_IF(!TensorShapeUtils::IsVector(first_conv_shape) ||
+                      !first_conv_shape.IsValid());
   // Finished simple check, process N * Conv.
   std::vector<int> conv_indexs;
   for (int i = 0; i < N; i++) {
@@ -2901,36 +2848,24 @@ bool FindResNeXtGroupConv2DBlock(const RemapperContext& ctx, int node_index,
     NodeDef* conv_node_def = conv_node_view->node();
     string data_format;
 
-    if (!IsConv2D(*conv_node_def)) {
-      return false;
-    }
+    ITEX_FUSION_MISS_IF(!IsConv2D(*conv_node_def));
 
     TF_ABORT_IF_ERROR(GetNodeAttr(*conv_node_def, "data_format", &data_format));
-    if (data_format != data_format_0) {
-      return false;
-    }
+    ITEX_FUSION_MISS_IF(data_format != data_format_0);
 
     conv_indexs.push_back(conv_node_view->node_index());
 
-    if (HasControlFaninOrFanout(*conv_node_view) ||
-        IsInPreserveSet(ctx, conv_node_def)) {
-      return false;
-    }
+    ITEX_FUSION_MISS_IF(HasControlFaninOrFanout(*conv_node_view) ||
+                        IsInPreserveSet(ctx, conv_node_def));
 
     TensorShape conv_shape = getWeightShape(*conv_node_view);
-    if (first_conv_shape != conv_shape) {
-      return false;
-    }
+    ITEX_FUSION_MISS_IF(first_conv_shape != conv_shape);
     const auto& conv_fanin_0 = conv_node_view->GetRegularFanin(0);
     const auto* split_node_view = conv_fanin_0.node_view();
     const auto* split_node_def = split_node_view->node();
-    if (!IsSplit(*split_node_def)) {
-      return false;
-    }
+    ITEX_FUSION_MISS_IF(!IsSplit(*split_node_def));
     int splitx_index = split_node_view->node_index();
-    if (splitx_index != split0_index) {
-      return false;
-    }
+    ITEX_FUSION_MISS_IF(splitx_index != split0_index);
   }
 
   const GroupConv2DBlock pattern{split0_node_view->node_index(), conv_indexs,
@@ -4861,19 +4796,19 @@ bool FindGelu(RemapperContext* ctx, int node_index,
   if (found_gelu_exact) {
     std::map<string, float> values_map = {
         {"square_root_one_half", 0.707106}, {"one", 1.0}, {"one_half", 0.5}};
-    if (!VerifyConstants(ctx, matched_nodes_map, &values_map)) return false;
+    ITEX_FUSION_MISS_IF(!VerifyConstants(ctx, matched_nodes_map, &values_map));
   } else if (found_gelu_approximate) {
     std::map<string, float> values_map = {{"square_root_two_over_pi", 0.797884},
                                           {"one", 1.0},
                                           {"one_half", 0.5},
                                           {"exponent", 3}};
-    if (!VerifyConstants(ctx, matched_nodes_map, &values_map)) return false;
+    ITEX_FUSION_MISS_IF(!VerifyConstants(ctx, matched_nodes_map, &values_map));
   } else if (found_gelu_approximate_on_cpu) {
     std::map<string, float> values_map = {{"square_root_two_over_pi", 0.797884},
                                           {"one", 1.0},
                                           {"one_half", 0.5},
                                           {"empirical_const", 0.044715}};
-    if (!VerifyConstants(ctx, matched_nodes_map, &values_map)) return false;
+    ITEX_FUSION_MISS_IF(!VerifyConstants(ctx, matched_nodes_map, &values_map));
   } else {
     return false;
   }
@@ -5120,6 +5055,53 @@ Status AddDropout(RemapperContext* ctx, const Dropout& matched,
   return Status::OK();
 }
 
+// Estimates the FLOPs of a contraction for the fusion report, as 2 * output
+// elements * reduction size. Returns 0 for other nodes or unknown shapes.
+int64 ContractionFlops(const RemapperContext& ctx, const NodeDef& node_def) {
+  const bool is_batch_matmul = IsAnyBatchMatMul(node_def);
+  const bool is_depthwise = IsDepthwiseConv2dNative(node_def);
+  if (!IsMatMul(node_def) && !is_batch_matmul && !is_depthwise &&
+      !IsConv2D(node_def) && !IsConv3D(node_def))
+    return 0;
+
+  std::vector<OpInfo_TensorProperties> inputs, outputs;
+  if (!ctx.graph_properties.GetInputProperties(node_def.name(), &inputs)
+           .ok() ||
+      !ctx.graph_properties.GetOutputProperties(node_def.name(), &outputs)
+           .ok() ||
+      inputs.size() < 2 || outputs.empty())
+    return 0;
+
+  const TensorShapeProto& output_shape = outputs[0].shape();
+  const TensorShapeProto& rhs_shape = inputs[1].shape();
+  if (output_shape.unknown_rank() || rhs_shape.unknown_rank() ||
+      rhs_shape.dim_size() < 2)
+    return 0;
+
+  int64 output_elements = 1;
+  for (const auto& dim : output_shape.dim()) {
+    if (dim.size() < 0) return 0;
+    output_elements *= dim.size();
+  }
+
+  // MatMul reduces over the rows of the weight (columns if transposed),
+  // BatchMatMul likewise over its last two dims, Conv over the whole filter
+  // but the output channels and DepthwiseConv over the filter window.
+  const int rank = rhs_shape.dim_size();
+  int64 reduction = 1;
+  if (IsMatMul(node_def) || is_batch_matmul) {
+    bool transpose = false;
+    TryGetNodeAttr(node_def, is_batch_matmul ? "adj_y" : "transpose_b",
+                   &transpose);
+    reduction = rhs_shape.dim(transpose ? rank - 1 : rank - 2).size();
+  } else {
+    for (int i = 0; i < rank - (is_depthwise ? 2 : 1); ++i) {
+      reduction *= rhs_shape.dim(i).size();
+    }
+  }
+  return reduction < 0 ? 0 : 2 * output_elements * reduction;
+}
+
 }  // namespace
 
 // `is_full` is true by default. It will be set as false if this pass runs
@@ -5166,6 +5148,14 @@ Status RunRemapper(const char* device_name, const GrapplerItem& item,
   // Infer statically first and only once.
   ctx.GetGraphProperties();
 
+  if (FusionReportActive()) {
+    for (int i = 0; i < num_nodes; ++i) {
+      const NodeDef* node_def = ctx.graph_view.GetNode(i)->node();
+      const int64 flops = ContractionFlops(ctx, *node_def);
+      if (flops > 0) RecordContractionFlops(*node_def, flops);
+    }
+  }
+
   bool is_visited = false;
   string last_op;
   for (int i = num_nodes - 1; i >= 0;) {
@@ -5213,14 +5203,17 @@ Status RunRemapper(const char* device_name, const GrapplerItem& item,
       continue;
     }
 
+    BeginFusionCandidate("remapper", *node_def);
+
     // Put the fusions that always need to be enabled here no matter `is_full`
     // is true or false.
     {
       // Remap TF2.11 dropout select to TF2.10 cast+mul.
       Dropout dropout;
-      if (FindDropout(ctx, i, &dropout)) {
+      if (EndFusionAttempt("Dropout", FindDropout(ctx, i, &dropout))) {
         TF_ABORT_IF_ERROR(
             AddDropout(&ctx, dropout, &invalidated_nodes, &nodes_to_delete));
+        metrics::RecordFusion("Dropout");
         continue;
       }
 
@@ -5228,19 +5221,25 @@ Status RunRemapper(const char* device_name, const GrapplerItem& item,
       std::map<string, int> matched_nodes_map;
       std::set<int> remove_node_indices;
       bool is_gelu_approximate = false;
-      if (FindGelu(&ctx, i, &matched_nodes_map, &remove_node_indices,
-                   &is_gelu_approximate)) {
+      if (EndFusionAttempt("Gelu",
+                           FindGelu(&ctx, i, &matched_nodes_map,
+                                    &remove_node_indices,
+                                    &is_gelu_approximate))) {
         TF_ABORT_IF_ERROR(AddGelu(&ctx, &matched_nodes_map,
                                   &remove_node_indices, &invalidated_nodes,
                                   &nodes_to_delete, is_gelu_approximate));
+        metrics::RecordFusion("Gelu");
         continue;
       }
 
       MatmulReshapeBiasadd matmul_reshape_biasadd;
-      if (FindMatmulReshapeBiasadd(ctx, i, &matmul_reshape_biasadd)) {
+      if (EndFusionAttempt("MatmulReshapeBiasadd",
+                           FindMatmulReshapeBiasadd(ctx, i,
+                                                    &matmul_reshape_biasadd))) {
         TF_ABORT_IF_ERROR(AddMatmulReshapeBiasadd(&ctx, matmul_reshape_biasadd,
                                                   &invalidated_nodes,
                                                   &nodes_to_delete));
+        metrics::RecordFusion("MatmulReshapeBiasadd");
         continue;
       }
     }
@@ -5252,254 +5251,328 @@ Status RunRemapper(const char* device_name, const GrapplerItem& item,
     if (is_full) {
       // keras Dense layer fwd
       KerasDenseLayerFwd keras_dense_layer_fwd;
-      if (FindKerasDenseLayerFwd(ctx, i, &keras_dense_layer_fwd)) {
+      if (EndFusionAttempt("KerasDenseLayerFwd",
+                           FindKerasDenseLayerFwd(ctx, i,
+                                                  &keras_dense_layer_fwd))) {
         TF_ABORT_IF_ERROR(AddKerasDenseLayerFwd(
             &ctx, keras_dense_layer_fwd, &invalidated_nodes, &nodes_to_delete));
+        metrics::RecordFusion("KerasDenseLayerFwd");
         continue;
       }
 
       // Remap Conv2D+BiasAdd+Activation+Add into the _ITEXFusedConv2D.
       ContractionWithBiasAndActivationAdd contract_with_bias_and_activation_add;
-      if (FindContractionWithBiasAndActivationAdd(
-              ctx, i, &contract_with_bias_and_activation_add)) {
+      if (EndFusionAttempt(
+              "ContractionWithBiasAndActivationAdd",
+              FindContractionWithBiasAndActivationAdd(
+                  ctx, i, &contract_with_bias_and_activation_add))) {
         TF_ABORT_IF_ERROR(
             AddFusedContractionNode(&ctx, contract_with_bias_and_activation_add,
                                     &invalidated_nodes, &nodes_to_delete));
+        metrics::RecordFusion("ContractionWithBiasAndActivationAdd");
         continue;
       }
 
       GroupConv2DBlock group_conv;
-      if (FindResNeXtGroupConv2DBlock(ctx, i, &group_conv)) {
+      if (EndFusionAttempt("ResNeXtGroupConv2DBlock",
+                           FindResNeXtGroupConv2DBlock(ctx, i, &group_conv))) {
         TF_ABORT_IF_ERROR(AddGroupConv2DNode(
             &ctx, group_conv, &invalidated_nodes, &nodes_to_delete));
+        metrics::RecordFusion("ResNeXtGroupConv2DBlock");
         continue;
       }
 
       // Remap Conv2D+BiasAdd+Add+Activation into the _ITEXFusedConv2D.
       ContractionWithBiasAndAddActivation contract_with_bias_and_add_activation;
-      if (FindContractionWithBiasAndAddActivation(
-              ctx, i, &contract_with_bias_and_add_activation)) {
+      if (EndFusionAttempt(
+              "ContractionWithBiasAndAddActivation",
+              FindContractionWithBiasAndAddActivation(
+                  ctx, i, &contract_with_bias_and_add_activation))) {
         TF_ABORT_IF_ERROR(
             AddFusedContractionNode(&ctx, contract_with_bias_and_add_activation,
                                     &invalidated_nodes, &nodes_to_delete));
+        metrics::RecordFusion("ContractionWithBiasAndAddActivation");
         continue;
       }
 
       // Remap Conv2D+BiasAdd+Add into the _ITEXFusedConv2D.
       ContractionWithBiasAddAndAdd contract_with_bias_and_add;
-      if (FindContractionWithBiasAddAndAdd(ctx, i,
-                                           &contract_with_bias_and_add)) {
+      if (EndFusionAttempt("ContractionWithBiasAddAndAdd",
+                           FindContractionWithBiasAddAndAdd(
+                               ctx, i, &contract_with_bias_and_add))) {
         TF_ABORT_IF_ERROR(
             AddFusedContractionNode(&ctx, contract_with_bias_and_add,
                                     &invalidated_nodes, &nodes_to_delete));
+        metrics::RecordFusion("ContractionWithBiasAddAndAdd");
         continue;
       }
 
       // Remap {Conv2D,DepthwiseConv2D,Conv3D,MatMul}+BiasAdd into the
       // _ITEXFused{Conv2D,DepthwiseConv2dNative,Conv3D,MatMul}
       ContractionWithBiasAdd contract_with_bias;
-      if (FindContractionWithBias(ctx, i, &contract_with_bias)) {
+      if (EndFusionAttempt("ContractionWithBias",
+                           FindContractionWithBias(ctx, i,
+                                                   &contract_with_bias))) {
         TF_ABORT_IF_ERROR(AddFusedContractionNode(
             &ctx, contract_with_bias, &invalidated_nodes, &nodes_to_delete));
+        metrics::RecordFusion("ContractionWithBias");
         continue;
       }
 
       // Remap MatMul+BiasAddGrad into the _fusedMatMulGrad
       ContractionWithBiasAddGrad contract_with_bias_grad;
-      if (FindContractionWithBiasAddGrad(ctx, i, &contract_with_bias_grad)) {
+      if (EndFusionAttempt("ContractionWithBiasAddGrad",
+                           FindContractionWithBiasAddGrad(
+                               ctx, i, &contract_with_bias_grad))) {
         TF_ABORT_IF_ERROR(
             AddFusedContractionGradNode(&ctx, contract_with_bias_grad,
                                         &invalidated_nodes, &nodes_to_delete));
+        metrics::RecordFusion("ContractionWithBiasAddGrad");
         continue;
       }
 
       // Remap {Conv2DBackpropFilter,Conv3DBackpropFilter}+BiasAddGrad into
       // FusedContractionBackpropFiler.
       ContractionWithBiasAddGrad conv_contract_with_bias_grad;
-      if (FindConvContractionWithBiasAddGrad(ctx, i,
-                                             &conv_contract_with_bias_grad)) {
+      if (EndFusionAttempt("ConvContractionWithBiasAddGrad",
+                           FindConvContractionWithBiasAddGrad(
+                               ctx, i, &conv_contract_with_bias_grad))) {
         TF_ABORT_IF_ERROR(
             AddFusedContractionGradNode(&ctx, conv_contract_with_bias_grad,
                                         &invalidated_nodes, &nodes_to_delete));
+        metrics::RecordFusion("ConvContractionWithBiasAddGrad");
         continue;
       }
       // Remap {Conv2D,Conv3D,MatMul}+BiasAdd+Activation into
       // _ITEXFused{Conv2D,Conv3D,MatMul}.
       ContractionWithBiasAddAndActivation contract_with_bias_and_activation;
-      if (FindContractionWithBiasAndActivation(
-              ctx, i, &contract_with_bias_and_activation)) {
+      if (EndFusionAttempt("ContractionWithBiasAndActivation",
+                           FindContractionWithBiasAndActivation(
+                               ctx, i, &contract_with_bias_and_activation))) {
         TF_ABORT_IF_ERROR(
             AddFusedContractionNode(&ctx, contract_with_bias_and_activation,
                                     &invalidated_nodes, &nodes_to_delete));
+        metrics::RecordFusion("ContractionWithBiasAndActivation");
         continue;
       }
 
       // Remap FusedBatchNorm+<SideInput>+<Activation> into the
       // _FusedBatchNormEx.
       FusedBatchNormEx fused_batch_norm_ex;
-      if (FindFusedBatchNormEx(ctx, i, &fused_batch_norm_ex)) {
+      if (EndFusionAttempt("FusedBatchNormEx",
+                           FindFusedBatchNormEx(ctx, i,
+                                                &fused_batch_norm_ex))) {
         TF_ABORT_IF_ERROR(AddFusedBatchNormExNode(
             &ctx, fused_batch_norm_ex, &invalidated_nodes, &nodes_to_delete));
+        metrics::RecordFusion("FusedBatchNormEx");
         continue;
       }
 
       FusedBatchNormGradEx fused_batch_norm_grad_ex;
-      if (FindFusedBatchNormGradEx(ctx, i, &fused_batch_norm_grad_ex)) {
+      if (EndFusionAttempt("FusedBatchNormGradEx",
+                           FindFusedBatchNormGradEx(
+                               ctx, i, &fused_batch_norm_grad_ex))) {
         TF_ABORT_IF_ERROR(
             AddFusedBatchNormGradExNode(&ctx, fused_batch_norm_grad_ex,
                                         &invalidated_nodes, &nodes_to_delete));
+        metrics::RecordFusion("FusedBatchNormGradEx");
         continue;
       }
 
       // Remap Pad+{Conv2D, _ITEXFusedConv2D} into the _FusedPadConv2D.
       PadWithContraction pad_with_contract;
-      if (FindPadWithContraction(ctx, i, &pad_with_contract)) {
+      if (EndFusionAttempt("PadWithContraction",
+                           FindPadWithContraction(ctx, i,
+                                                  &pad_with_contract))) {
         TF_ABORT_IF_ERROR(AddPadWithContractionNode(
             &ctx, pad_with_contract, &invalidated_nodes, &nodes_to_delete));
+        metrics::RecordFusion("PadWithContraction");
         continue;
       }
 
       ConvBackpropInputWithSlice conv_with_slice;
-      if (FindConvBackpropInputWithSlice(ctx, i, &conv_with_slice)) {
+      if (EndFusionAttempt("ConvBackpropInputWithSlice",
+                           FindConvBackpropInputWithSlice(ctx, i,
+                                                          &conv_with_slice))) {
         TF_ABORT_IF_ERROR(AddConvBackpropInputWithSliceNode(
             &ctx, conv_with_slice, &invalidated_nodes, &nodes_to_delete));
+        metrics::RecordFusion("ConvBackpropInputWithSlice");
         continue;
       }
 
       // Remap Mul + AddN + TrainingOp into the _FusedTrainingOp.
       FusedTrainingOp fused_training_op;
       if (level == default_level &&
-          FindFusedTrainingOp(ctx, i, &fused_training_op)) {
+          EndFusionAttempt("FusedTrainingOp",
+                           FindFusedTrainingOp(ctx, i, &fused_training_op))) {
         TF_ABORT_IF_ERROR(AddFusedTrainingNode(
             &ctx, fused_training_op, &invalidated_nodes, &nodes_to_delete));
+        metrics::RecordFusion("FusedTrainingOp");
         continue;
       }
 
       // Remap BatchMatMul+Mul into the _FusedBatchMatMul.
       ContractionWithMul contract_with_mul;
-      if (FindContractionWithMul(ctx, i, &contract_with_mul)) {
+      if (EndFusionAttempt("ContractionWithMul",
+                           FindContractionWithMul(ctx, i,
+                                                  &contract_with_mul))) {
         TF_ABORT_IF_ERROR(AddFusedContractionNode(
             &ctx, contract_with_mul, &invalidated_nodes, &nodes_to_delete));
+        metrics::RecordFusion("ContractionWithMul");
         continue;
       }
 
       // delete dequantize node if it finds dequantize_with_shape pattern
       DequantizeWithShape dequantize_with_shape;
       if (level == default_level &&
-          FindDequantizeWithShape(ctx, i, &dequantize_with_shape)) {
+          EndFusionAttempt("DequantizeWithShape",
+                           FindDequantizeWithShape(ctx, i,
+                                                   &dequantize_with_shape))) {
         TF_ABORT_IF_ERROR(AddFusedDequantizeWithShape(
             &ctx, dequantize_with_shape, &invalidated_nodes, &nodes_to_delete));
+        metrics::RecordFusion("DequantizeWithShape");
         continue;
       }
 
       // delete dequantize node if it finds dequantize_with_reshape pattern
       DequantizeWithReshape dequantize_with_reshape;
       if (is_layout_opt && level == default_level &&
-          FindDequantizeWithReshape(ctx, i, &dequantize_with_reshape)) {
+          EndFusionAttempt("DequantizeWithReshape",
+                           FindDequantizeWithReshape(
+                               ctx, i, &dequantize_with_reshape))) {
         TF_ABORT_IF_ERROR(AddFusedDequantizeWithReshape(
             &ctx, dequantize_with_reshape, &invalidated_nodes,
             &nodes_to_delete));
+        metrics::RecordFusion("DequantizeWithReshape");
         continue;
       }
 
       // Remap QuantizeV2+QuantizedConv2D into the
       // _ITEXQuantizeV2WithQuantizedConv2D
       QuantizeV2WithQuantizedConv2D quantizev2_with_quantizedconv;
-      if (is_layout_opt && FindQuantizeV2WithQuantizedConv2D(
-                               ctx, i, &quantizev2_with_quantizedconv)) {
+      if (is_layout_opt &&
+          EndFusionAttempt("QuantizeV2WithQuantizedConv2D",
+                           FindQuantizeV2WithQuantizedConv2D(
+                               ctx, i, &quantizev2_with_quantizedconv))) {
         TF_ABORT_IF_ERROR(AddQuantizeV2WithQuantizedConv2DNode(
             &ctx, quantizev2_with_quantizedconv, &invalidated_nodes,
             &nodes_to_delete));
+        metrics::RecordFusion("QuantizeV2WithQuantizedConv2D");
         continue;
       }
 
       QuantizedConv2DWithDequantize conv2d_with_dequantize;
-      if (is_layout_opt && (FindQuantizedConv2DWithDequantize(
+      if (is_layout_opt &&
+          EndFusionAttempt("QuantizedConv2DWithDequantize",
+                           FindQuantizedConv2DWithDequantize(
                                ctx, i, &conv2d_with_dequantize))) {
         TF_ABORT_IF_ERROR(AddQuantizedConv2DWithDequantizeNode(
             &ctx, conv2d_with_dequantize, &invalidated_nodes,
             &nodes_to_delete));
+        metrics::RecordFusion("QuantizedConv2DWithDequantize");
         continue;
       }
 
       QuantizedConv2DWithCast conv2d_with_cast;
       if (is_layout_opt &&
-          (FindQuantizedConv2DWithCast(ctx, i, &conv2d_with_cast))) {
+          EndFusionAttempt("QuantizedConv2DWithCast",
+                           FindQuantizedConv2DWithCast(ctx, i,
+                                                       &conv2d_with_cast))) {
         TF_ABORT_IF_ERROR(AddQuantizedConv2DWithCastNode(
             &ctx, conv2d_with_cast, &invalidated_nodes, &nodes_to_delete));
+        metrics::RecordFusion("QuantizedConv2DWithCast");
         continue;
       }
 
       // Remap L2loss+AddN into the _FusedAddN
       FusedAddN fused_addn;
-      if (level == default_level && FindFusedAddN(ctx, i, &fused_addn)) {
+      if (level == default_level &&
+          EndFusionAttempt("FusedAddN", FindFusedAddN(ctx, i, &fused_addn))) {
         TF_ABORT_IF_ERROR(AddFusedAddN(&ctx, fused_addn, &invalidated_nodes,
                                        &nodes_to_delete));
+        metrics::RecordFusion("FusedAddN");
         continue;
       }
 
       AddV2WithSoftmax fused_addv2_with_softmax;
       if (level == default_level &&
-          FindAddV2WithSoftmax(ctx, i, &fused_addv2_with_softmax)) {
+          EndFusionAttempt("AddV2WithSoftmax",
+                           FindAddV2WithSoftmax(ctx, i,
+                                                &fused_addv2_with_softmax))) {
         TF_ABORT_IF_ERROR(
             AddFusedAddV2WithSoftmaxNode(&ctx, fused_addv2_with_softmax,
                                          &invalidated_nodes, &nodes_to_delete));
+        metrics::RecordFusion("AddV2WithSoftmax");
         continue;
       }
 
       // Remap Bf16(Fused)Matmul+CastFp32 into the _ITEX(Fused)AccMatMul.
       Bf16ContractionWithCastFp32 contraction_with_cast;
-      if (FindBf16ContractionWithCastFp32(ctx, i, &contraction_with_cast)) {
+      if (EndFusionAttempt("Bf16ContractionWithCastFp32",
+                           FindBf16ContractionWithCastFp32(
+                               ctx, i, &contraction_with_cast))) {
         TF_ABORT_IF_ERROR(AddBf16ContractionWithCastFp32Node(
             &ctx, contraction_with_cast, &invalidated_nodes, &nodes_to_delete));
+        metrics::RecordFusion("Bf16ContractionWithCastFp32");
         continue;
       }
 
       // Remap Random Comparison+Cast into the RandomWithComparisonAndCast.
       RandomWithComparisonAndCast random_with_compare_and_cast;
       if (level == default_level &&
-          FindRandomWithComparisonAndCast(ctx, i,
-                                          &random_with_compare_and_cast)) {
+          EndFusionAttempt("RandomWithComparisonAndCast",
+                           FindRandomWithComparisonAndCast(
+                               ctx, i, &random_with_compare_and_cast))) {
         TF_ABORT_IF_ERROR(AddRandomWithComparisonAndCastNode(
             &ctx, random_with_compare_and_cast, &invalidated_nodes,
             &nodes_to_delete));
+        metrics::RecordFusion("RandomWithComparisonAndCast");
         continue;
       }
 
       // Remap Bf16FusedMatmulGrad+CastFp32 into the _ITEXFusedAccMatMulGrad.
       Bf16ContractionGradWithCastFp32 contraction_grad_with_cast;
-      if (FindBf16ContractionGradWithCastFp32(ctx, i,
-                                              &contraction_grad_with_cast)) {
+      if (EndFusionAttempt("Bf16ContractionGradWithCastFp32",
+                           FindBf16ContractionGradWithCastFp32(
+                               ctx, i, &contraction_grad_with_cast))) {
         TF_ABORT_IF_ERROR(AddFusedContractionGradWithCastNode(
             &ctx, contraction_grad_with_cast, &invalidated_nodes,
             &nodes_to_delete));
+        metrics::RecordFusion("Bf16ContractionGradWithCastFp32");
         continue;
       }
 
       // Remap Comparison+Cast into the ComparisonWithCast.
       ComparisonWithCast comparison_with_cast;
       if (level == default_level &&
-          FindComparisonWithCast(ctx, i, &comparison_with_cast)) {
+          EndFusionAttempt("ComparisonWithCast",
+                           FindComparisonWithCast(ctx, i,
+                                                  &comparison_with_cast))) {
         TF_ABORT_IF_ERROR(AddComparisonWithCastNode(
             &ctx, comparison_with_cast, &invalidated_nodes, &nodes_to_delete));
+        metrics::RecordFusion("ComparisonWithCast");
         continue;
       }
 
       // Remap Mul+Max into the LeakyRelu.
       MulWithMaximum mul_with_maximum;
       if (level == default_level &&
-          FindMulWithMaximum(ctx, i, &mul_with_maximum)) {
+          EndFusionAttempt("MulWithMaximum",
+                           FindMulWithMaximum(ctx, i, &mul_with_maximum))) {
         TF_ABORT_IF_ERROR(AddMulWithMaximumNode(
             &ctx, mul_with_maximum, &invalidated_nodes, &nodes_to_delete));
+        metrics::RecordFusion("MulWithMaximum");
         continue;
       }
 
       // Remap Const+Cast into the Const. this fusion aims to reduce the number
       // of Cast which were produced by auto mixed precision.
       ConstWithCast const_with_cast;
-      if (FindConstWithCast(ctx, i, &const_with_cast)) {
+      if (EndFusionAttempt("ConstWithCast",
+                           FindConstWithCast(ctx, i, &const_with_cast))) {
         TF_ABORT_IF_ERROR(AddConstWithCastNode(
             &ctx, const_with_cast, &invalidated_nodes, &nodes_to_delete));
+        metrics::RecordFusion("ConstWithCast");
         continue;
       }
 
@@ -5507,9 +5580,12 @@ Status RunRemapper(const char* device_name, const GrapplerItem& item,
       // Disable it in 1st remapper since it may break other high priority
       // fusions.
       FusedBinary seq_binary;
-      if (level != default_level && FindFusedBinary(ctx, i, &seq_binary)) {
+      if (level != default_level &&
+          EndFusionAttempt("FusedBinary",
+                           FindFusedBinary(ctx, i, &seq_binary))) {
         TF_ABORT_IF_ERROR(AddFusedBinaryNode(
             &ctx, seq_binary, &invalidated_nodes, &nodes_to_delete));
+        metrics::RecordFusion("FusedBinary");
       }
     } else {
       // Only run in llga mode
@@ -5523,16 +5599,21 @@ Status RunRemapper(const char* device_name, const GrapplerItem& item,
       }
 
       ConvBackpropInputWithSlice conv_with_slice;
-      if (FindConv2DBackpropInputWithSliceLLGA(ctx, i, &conv_with_slice)) {
+      if (EndFusionAttempt("Conv2DBackpropInputWithSliceLLGA",
+                           FindConv2DBackpropInputWithSliceLLGA(
+                               ctx, i, &conv_with_slice))) {
         TF_ABORT_IF_ERROR(AddConv2DBackpropInputWithSliceNodeLLGA(
             &ctx, conv_with_slice, &invalidated_nodes, &nodes_to_delete));
+        metrics::RecordFusion("Conv2DBackpropInputWithSliceLLGA");
         continue;
       }
 
       PadConvFwdBwd pad_conv_fwd_bwd;
-      if (FindPadConvFwdBwd(ctx, i, &pad_conv_fwd_bwd)) {
+      if (EndFusionAttempt("PadConvFwdBwd",
+                           FindPadConvFwdBwd(ctx, i, &pad_conv_fwd_bwd))) {
         TF_ABORT_IF_ERROR(AddPadConvFwdBwd(
             &ctx, pad_conv_fwd_bwd, &invalidated_nodes, &nodes_to_delete));
+        metrics::RecordFusion("PadConvFwdBwd");
         continue;
       }
     }
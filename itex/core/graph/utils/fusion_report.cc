@@ -0,0 +1,362 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "itex/core/graph/utils/fusion_report.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <set>
+#include <tuple>
+
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/strip.h"
+#include "itex/core/utils/errors.h"
+#include "itex/core/utils/logging.h"
+#include "itex/core/utils/str_util.h"
+
+namespace itex {
+namespace graph {
+
+namespace {
+
+thread_local FusionReport* current_report = nullptr;
+
+// Ops whose FLOPs are counted as unfused while they are still in the
+// optimized graph, with or without the ITEX prefixes of the layout passes.
+const std::set<string>& UnfusedContractionOps() {
+  static const std::set<string> ops = {
+      "BatchMatMul", "BatchMatMulV2",         "Conv2D",
+      "Conv3D",      "DepthwiseConv2dNative", "MatMul",
+  };
+  return ops;
+}
+
+absl::string_view StripItexPrefix(absl::string_view op) {
+  for (absl::string_view prefix : {"_ITEX", "_OneDnn"}) {
+    if (absl::ConsumePrefix(&op, prefix)) break;
+  }
+  return op;
+}
+
+// Collapses the whitespace of stringified multi-line conditions.
+string OneLine(absl::string_view text) {
+  string result;
+  bool space = false;
+  for (char c : text) {
+    if (c == ' ' || c == '\n' || c == '\t') {
+      space = !result.empty();
+      continue;
+    }
+    if (space) result += ' ';
+    space = false;
+    result += c;
+  }
+  return result;
+}
+
+double Percent(int64 part, int64 total) {
+  return total > 0 ? 100.0 * part / total : 0.0;
+}
+
+}  // namespace
+
+bool FusionReport::Candidate::Fused() const {
+  return std::any_of(attempts.begin(), attempts.end(),
+                     [](const Attempt& attempt) { return attempt.matched; });
+}
+
+void FusionReport::BeginCandidate(absl::string_view pass,
+                                  const NodeDef& node) {
+  current_pass_ = string(pass);
+  current_node_ = node.name();
+  current_op_ = node.op();
+  current_ = -1;
+  reason_.clear();
+}
+
+void FusionReport::Miss(absl::string_view reason) {
+  if (reason_.empty()) reason_ = OneLine(reason);
+}
+
+void FusionReport::EndAttempt(absl::string_view pattern, bool matched,
+                              const char* default_reason) {
+  string reason = std::move(reason_);
+  reason_.clear();
+  if (current_node_.empty()) return;
+  if (!matched && reason.empty()) {
+    if (default_reason == nullptr) return;
+    reason = default_reason;
+  }
+
+  if (current_ < 0) {
+    auto key = std::make_pair(current_pass_, current_node_);
+    auto it = candidate_index_.find(key);
+    if (it == candidate_index_.end()) {
+      it = candidate_index_.emplace(key, candidates_.size()).first;
+      candidates_.push_back({current_pass_, current_node_, current_op_, {}});
+    }
+    current_ = it->second;
+  }
+
+  std::vector<Attempt>& attempts = candidates_[current_].attempts;
+  auto attempt = std::find_if(
+      attempts.begin(), attempts.end(),
+      [&](const Attempt& other) { return other.pattern == pattern; });
+  if (attempt == attempts.end()) {
+    attempts.push_back({string(pattern), matched, matched ? "" : reason});
+  } else if (matched && !attempt->matched) {
+    attempt->matched = true;
+    attempt->reason.clear();
+  }
+}
+
+void FusionReport::RecordContractionFlops(const NodeDef& node, int64 flops) {
+  if (contraction_index_.count(node.name())) return;
+  contraction_index_.emplace(node.name(), contractions_.size());
+  contractions_.push_back({node.name(), node.op(), flops});
+}
+
+int64 FusionReport::TotalContractionFlops() const {
+  int64 total = 0;
+  for (const Contraction& contraction : contractions_) {
+    total += contraction.flops;
+  }
+  return total;
+}
+
+std::vector<FusionReport::Contraction> FusionReport::UnfusedContractions(
+    const GraphDef& optimized_graph) const {
+  std::vector<Contraction> unfused;
+  for (const NodeDef& node : optimized_graph.node()) {
+    auto it = contraction_index_.find(node.name());
+    if (it == contraction_index_.end()) continue;
+    if (!UnfusedContractionOps().count(string(StripItexPrefix(node.op())))) {
+      continue;
+    }
+    unfused.push_back(contractions_[it->second]);
+    unfused.back().op = node.op();
+  }
+  std::stable_sort(unfused.begin(), unfused.end(),
+                   [](const Contraction& a, const Contraction& b) {
+                     return a.flops > b.flops;
+                   });
+  return unfused;
+}
+
+string FusionReport::ToJson(const GraphDef& optimized_graph) const {
+  const std::vector<Contraction> unfused =
+      UnfusedContractions(optimized_graph);
+  int64 fused = 0;
+  int64 unfused_flops = 0;
+  for (const Candidate& candidate : candidates_) fused += candidate.Fused();
+  for (const Contraction& contraction : unfused) {
+    unfused_flops += contraction.flops;
+  }
+
+  string json = "{\n";
+  absl::StrAppend(&json, "  \"summary\": {\"candidates\": ", candidates_.size(),
+                  ", \"fused\": ", fused,
+                  ", \"missed\": ", candidates_.size() - fused,
+                  ", \"contraction_flops\": ", TotalContractionFlops(),
+                  ", \"unfused_contraction_flops\": ", unfused_flops, "},\n");
+
+  absl::StrAppend(&json, "  \"candidates\": [");
+  for (size_t i = 0; i < candidates_.size(); ++i) {
+    const Candidate& candidate = candidates_[i];
+    absl::StrAppend(&json, i ? "," : "", "\n    {\"pass\": ",
+                    str_util::JsonString(candidate.pass),
+                    ", \"node\": ", str_util::JsonString(candidate.node),
+                    ", \"op\": ", str_util::JsonString(candidate.op),
+                    ", \"fused\": ", candidate.Fused() ? "true" : "false",
+                    ", \"attempts\": [");
+    for (size_t j = 0; j < candidate.attempts.size(); ++j) {
+      const Attempt& attempt = candidate.attempts[j];
+      absl::StrAppend(&json, j ? ", " : "",
+                      "{\"pattern\": ", str_util::JsonString(attempt.pattern),
+                      ", \"matched\": ", attempt.matched ? "true" : "false");
+      if (!attempt.matched) {
+        absl::StrAppend(&json, ", \"reason\": ",
+                        str_util::JsonString(attempt.reason));
+      }
+      absl::StrAppend(&json, "}");
+    }
+    absl::StrAppend(&json, "]}");
+  }
+  absl::StrAppend(&json, candidates_.empty() ? "" : "\n  ", "],\n");
+
+  absl::StrAppend(&json, "  \"unfused_contractions\": [");
+  for (size_t i = 0; i < unfused.size(); ++i) {
+    absl::StrAppend(&json, i ? "," : "",
+                    "\n    {\"node\": ", str_util::JsonString(unfused[i].node),
+                    ", \"op\": ", str_util::JsonString(unfused[i].op),
+                    ", \"flops\": ", unfused[i].flops, "}");
+  }
+  absl::StrAppend(&json, unfused.empty() ? "" : "\n  ", "]\n}\n");
+  return json;
+}
+
+string FusionReport::ToTable(const GraphDef& optimized_graph) const {
+  const std::vector<Contraction> unfused =
+      UnfusedContractions(optimized_graph);
+  int64 unfused_flops = 0;
+  for (const Contraction& contraction : unfused) {
+    unfused_flops += contraction.flops;
+  }
+  const int64 total_flops = TotalContractionFlops();
+
+  // pass -> (candidates, fused).
+  std::map<string, std::pair<int64, int64>> passes;
+  // (pass, pattern, reason) -> failed attempts.
+  std::map<std::tuple<string, string, string>, int64> reasons;
+  for (const Candidate& candidate : candidates_) {
+    auto& pass = passes[candidate.pass];
+    ++pass.first;
+    if (candidate.Fused()) {
+      ++pass.second;
+      continue;
+    }
+    for (const Attempt& attempt : candidate.attempts) {
+      ++reasons[std::make_tuple(candidate.pass, attempt.pattern,
+                                attempt.reason)];
+    }
+  }
+
+  string table = "ITEX fusion coverage report\n\n";
+  absl::StrAppendFormat(&table, "%-16s %10s %10s %10s %8s\n", "pass",
+                        "candidates", "fused", "missed", "fused %");
+  for (const auto& pass : passes) {
+    const int64 candidates = pass.second.first;
+    const int64 fused = pass.second.second;
+    absl::StrAppendFormat(&table, "%-16s %10d %10d %10d %7.1f%%\n", pass.first,
+                          candidates, fused, candidates - fused,
+                          Percent(fused, candidates));
+  }
+  absl::StrAppendFormat(&table,
+                        "\nContraction GFLOPs: %.3f, unfused: %.3f (%.1f%%)\n",
+                        total_flops / 1e9, unfused_flops / 1e9,
+                        Percent(unfused_flops, total_flops));
+
+  if (!reasons.empty()) {
+    std::vector<std::pair<int64, std::tuple<string, string, string>>> sorted;
+    for (const auto& reason : reasons) {
+      sorted.emplace_back(reason.second, reason.first);
+    }
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [](const auto& a, const auto& b) {
+                       return a.first > b.first;
+                     });
+    absl::StrAppendFormat(&table, "\nMiss reasons\n%8s  %-16s %-40s %s\n",
+                          "count", "pass", "pattern",
+                          "first failing predicate");
+    for (const auto& reason : sorted) {
+      absl::StrAppendFormat(&table, "%8d  %-16s %-40s %s\n", reason.first,
+                            std::get<0>(reason.second),
+                            std::get<1>(reason.second),
+                            std::get<2>(reason.second));
+    }
+  }
+
+  bool missed_header = false;
+  for (const Candidate& candidate : candidates_) {
+    if (candidate.Fused()) continue;
+    if (!missed_header) {
+      absl::StrAppendFormat(&table, "\nMissed candidates\n%-16s %-24s %s\n",
+                            "pass", "op", "node");
+      missed_header = true;
+    }
+    absl::StrAppendFormat(&table, "%-16s %-24s %s\n", candidate.pass,
+                          candidate.op, candidate.node);
+    for (const Attempt& attempt : candidate.attempts) {
+      absl::StrAppendFormat(&table, "%-16s   %s: %s\n", "", attempt.pattern,
+                            attempt.reason);
+    }
+  }
+
+  if (!unfused.empty()) {
+    absl::StrAppendFormat(&table, "\nUnfused contractions\n%12s  %-24s %s\n",
+                          "GFLOPs", "op", "node");
+    for (const Contraction& contraction : unfused) {
+      absl::StrAppendFormat(&table, "%12.3f  %-24s %s\n",
+                            contraction.flops / 1e9, contraction.op,
+                            contraction.node);
+    }
+  }
+  return table;
+}
+
+Status FusionReport::Write(const string& dirname,
+                           const GraphDef& optimized_graph) const {
+  // Numbered like the graph dumps, one report per optimized graph.
+  static std::atomic<int> count(0);
+  const int index = count++;
+  string name = absl::StrCat(dirname, "/itex_fusion_report");
+  if (index > 0) absl::StrAppend(&name, "_", index);
+
+  for (const auto& file :
+       {std::make_pair(absl::StrCat(name, ".json"), ToJson(optimized_graph)),
+        std::make_pair(absl::StrCat(name, ".txt"),
+                       ToTable(optimized_graph))}) {
+    std::ofstream output(file.first, std::ios::out);
+    if (!output.is_open()) {
+      return errors::Internal("Unable to create fusion report '", file.first,
+                              "'.");
+    }
+    output << file.second;
+    if (!output.good()) {
+      return errors::Internal("Failed to write fusion report '", file.first,
+                              "'.");
+    }
+  }
+  ITEX_LOG(INFO) << "Wrote fusion report to " << name << ".{json,txt}";
+  return Status::OK();
+}
+
+ScopedFusionReport::ScopedFusionReport(FusionReport* report)
+    : previous_(current_report) {
+  current_report = report;
+}
+
+ScopedFusionReport::~ScopedFusionReport() { current_report = previous_; }
+
+FusionReport* CurrentFusionReport() { return current_report; }
+
+void BeginFusionCandidate(absl::string_view pass, const NodeDef& node) {
+  if (current_report != nullptr) current_report->BeginCandidate(pass, node);
+}
+
+bool FusionMiss(absl::string_view reason) {
+  if (current_report != nullptr) current_report->Miss(reason);
+  return false;
+}
+
+bool EndFusionAttempt(absl::string_view pattern, bool matched,
+                      const char* default_reason) {
+  if (current_report != nullptr) {
+    current_report->EndAttempt(pattern, matched, default_reason);
+  }
+  return matched;
+}
+
+void RecordContractionFlops(const NodeDef& node, int64 flops) {
+  if (current_report != nullptr) {
+    current_report->RecordContractionFlops(node, flops);
+  }
+}
+
+}  // namespace graph
+}  // namespace itex
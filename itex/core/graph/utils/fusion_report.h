@@ -0,0 +1,165 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef ITEX_CORE_GRAPH_UTILS_FUSION_REPORT_H_
+#define ITEX_CORE_GRAPH_UTILS_FUSION_REPORT_H_
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "itex/core/utils/macros.h"
+#include "itex/core/utils/status.h"
+#include "itex/core/utils/types.h"
+#include "protos/graph.pb.h"
+
+namespace itex {
+namespace graph {
+
+// Fusion coverage report of one graph optimization, enabled by
+// ITEX_FUSION_REPORT_DIR.
+//
+// The remapper, oneDNN Graph and oneDNN layout passes report every candidate
+// anchor node they look at together with the patterns they attempted on it.
+// An attempt either matched or failed, and a failed attempt carries the first
+// predicate of the pattern that did not hold. Attempts that fail without a
+// reason did not get past the anchor check of the pattern and are dropped, so
+// that a node is only a candidate for the patterns that start from its op.
+//
+// The report also estimates the FLOPs of contractions (MatMul, Conv and
+// friends) from the statically inferred shapes, so that it can tell how many
+// FLOPs are left in contractions without any fused post-op.
+class FusionReport {
+ public:
+  FusionReport() = default;
+
+  // Starts the attempts of "pass" on "node".
+  void BeginCandidate(absl::string_view pass, const NodeDef& node);
+
+  // Records "reason" as the failing predicate of the running attempt, unless
+  // an earlier predicate already failed.
+  void Miss(absl::string_view reason);
+
+  // Ends the running attempt of "pattern" on the current candidate.
+  // "default_reason" is the reason of a failed attempt which did not record
+  // one; nullptr drops such an attempt.
+  void EndAttempt(absl::string_view pattern, bool matched,
+                  const char* default_reason);
+
+  // Records the FLOPs of a contraction node of the graph. The first record of
+  // a node wins, later passes see a partly fused graph.
+  void RecordContractionFlops(const NodeDef& node, int64 flops);
+
+  // Renders the report. "optimized_graph" is the output of the optimizer, to
+  // find the contractions that are left unfused.
+  string ToJson(const GraphDef& optimized_graph) const;
+  string ToTable(const GraphDef& optimized_graph) const;
+
+  // Writes the JSON report and the table to "<dirname>/itex_fusion_report_*",
+  // with the suffixes ".json" and ".txt".
+  Status Write(const string& dirname, const GraphDef& optimized_graph) const;
+
+ private:
+  struct Attempt {
+    string pattern;
+    bool matched = false;
+    string reason;
+  };
+
+  struct Candidate {
+    string pass;
+    string node;
+    string op;
+    std::vector<Attempt> attempts;
+
+    bool Fused() const;
+  };
+
+  struct Contraction {
+    string node;
+    string op;
+    int64 flops = 0;
+  };
+
+  // Contractions of the original graph that are still unfused in
+  // "optimized_graph", in descending order of FLOPs.
+  std::vector<Contraction> UnfusedContractions(
+      const GraphDef& optimized_graph) const;
+
+  int64 TotalContractionFlops() const;
+
+  std::vector<Candidate> candidates_;
+  // (pass, node) -> index into candidates_. A node is visited by several runs
+  // of a pass, the attempts of all of them are merged.
+  std::map<std::pair<string, string>, int> candidate_index_;
+  std::vector<Contraction> contractions_;
+  std::map<string, int> contraction_index_;
+
+  // The candidate being attempted. It is only added to candidates_ by its
+  // first recorded attempt, current_ is -1 until then.
+  string current_pass_;
+  string current_node_;
+  string current_op_;
+  int current_ = -1;
+  string reason_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(FusionReport);
+};
+
+// Makes "report" the fusion report of the calling thread for the lifetime of
+// the object. A nullptr report disables the reporting.
+class ScopedFusionReport {
+ public:
+  explicit ScopedFusionReport(FusionReport* report);
+  ~ScopedFusionReport();
+
+ private:
+  FusionReport* previous_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(ScopedFusionReport);
+};
+
+// Hooks for the passes, all no-ops when the calling thread has no report.
+FusionReport* CurrentFusionReport();
+
+inline bool FusionReportActive() { return CurrentFusionReport() != nullptr; }
+
+void BeginFusionCandidate(absl::string_view pass, const NodeDef& node);
+
+// Always returns false, to be used as "return FusionMiss(...)" in the
+// predicates of a pattern.
+bool FusionMiss(absl::string_view reason);
+
+// Returns "matched", to wrap the match function of a pattern:
+//   if (EndFusionAttempt("Pattern", FindPattern(ctx, i, &matched))) ...
+bool EndFusionAttempt(absl::string_view pattern, bool matched,
+                      const char* default_reason = nullptr);
+
+void RecordContractionFlops(const NodeDef& node, int64 flops);
+
+}  // namespace graph
+}  // namespace itex
+
+// Returns false from a pattern predicate if the condition holds, recording it
+// as the reason of the failed attempt. Variadic so that the condition may
+// contain commas outside of parentheses, e.g. in braced initializers.
+#define ITEX_FUSION_MISS_IF(...)                                     \
+  do {                                                               \
+    if (__VA_ARGS__) return ::itex::graph::FusionMiss(#__VA_ARGS__); \
+  } while (0)
+
+#endif  // ITEX_CORE_GRAPH_UTILS_FUSION_REPORT_H_
@@ -15,7 +15,9 @@ limitations under the License.
 
 #include "itex/core/graph/utils/graph_properties.h"
 
+#include "itex/core/utils/env_time.h"
 #include "itex/core/utils/errors.h"
+#include "itex/core/utils/graph_metrics.h"
 #include "itex/core/utils/tf_buffer.h"
 #include "protos/op_performance_data.pb.h"
 
@@ -31,6 +33,7 @@ Status GraphProperties::InferStatically(bool assume_valid_feeds,
                                         bool aggressive_shape_inference,
                                         bool include_input_tensor_values,
                                         bool include_output_tensor_values) {
+  const uint64 start_us = EnvTime::NowMicros();
   TF_Status* tf_status = TF_NewStatus();
   TF_InferStatically(graph_prop_, static_cast<TF_Bool>(assume_valid_feeds),
                      static_cast<TF_Bool>(aggressive_shape_inference),
@@ -39,6 +42,8 @@ Status GraphProperties::InferStatically(bool assume_valid_feeds,
                      tf_status);
   Status status = StatusFromTF_Status(tf_status);
   TF_DeleteStatus(tf_status);
+  metrics::RecordShapeInference(metrics::CurrentGraphPass(),
+                                EnvTime::NowMicros() - start_us);
   return status;
 }
 
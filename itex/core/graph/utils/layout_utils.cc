@@ -20,6 +20,7 @@ limitations under the License.
 #include <vector>
 
 #include "itex/core/graph/optimizer_config.h"
+#include "itex/core/graph/utils/fusion_report.h"
 #include "itex/core/graph/utils/op_types.h"
 #include "itex/core/graph/utils/utils.h"
 #include "itex/core/utils/onednn/onednn_post_op_util.h"
@@ -64,18 +65,18 @@ bool RewriteLayerNorm(const utils::MutableNodeView& node_view) {
   // for layernorm, it only supports LDNC(NHWC)
   ITEX_CHECK_OK(GetNodeAttr(node_def, "data_format", &data_format));
 
-  if (data_format == "NCHW") return false;
+  ITEX_FUSION_MISS_IF(data_format == "NCHW");
   return true;
 }
 
 bool RewriteLayerNormGrad(const utils::MutableNodeView& node_view) {
-  if (!RewriteLayerNorm(node_view)) return false;
-  if (!RewriteBackwardDataType(node_view)) return false;
+  ITEX_FUSION_MISS_IF(!RewriteLayerNorm(node_view));
+  ITEX_FUSION_MISS_IF(!RewriteBackwardDataType(node_view));
   return true;
 }
 
 bool RewriteFusedBatchNormEx(const utils::MutableNodeView& node_view) {
-  if (!RewriteFusedBatchNormV3(node_view)) return false;
+  ITEX_FUSION_MISS_IF(!RewriteFusedBatchNormV3(node_view));
 
   const NodeDef& node_def = *(node_view.node());
   int num_side_inputs;
@@ -91,19 +92,19 @@ bool RewriteFusedBatchNormEx(const utils::MutableNodeView& node_view) {
 }
 
 bool RewriteFusedBatchNormGradV3(const utils::MutableNodeView& node_view) {
-  if (!RewriteFusedBatchNormV3(node_view)) return false;
-  if (!RewriteBackwardDataType(node_view)) return false;
+  ITEX_FUSION_MISS_IF(!RewriteFusedBatchNormV3(node_view));
+  ITEX_FUSION_MISS_IF(!RewriteBackwardDataType(node_view));
   return true;
 }
 
 bool RewriteFusedBatchNormExGrad(const utils::MutableNodeView& node_view) {
-  if (!RewriteFusedBatchNormV3(node_view)) return false;
-  if (!RewriteBackwardDataType(node_view)) return false;
+  ITEX_FUSION_MISS_IF(!RewriteFusedBatchNormV3(node_view));
+  ITEX_FUSION_MISS_IF(!RewriteBackwardDataType(node_view));
 
   const NodeDef& node_def = *(node_view.node());
   string activation_mode;
   ITEX_CHECK_OK(GetNodeAttr(node_def, "activation_mode", &activation_mode));
-  if (activation_mode != "ReluGrad") return false;
+  ITEX_FUSION_MISS_IF(activation_mode != "ReluGrad");
   return true;
 }
 
@@ -127,26 +128,26 @@ bool RewriteMatMul(const utils::MutableNodeView& node_view) {
   // TODO(itex): Remove this condition once MatMul blocked format is
   // supported on CPU.
   if (NodeIsOnCpu(&node_def)) return true;
-  if (NodeIsOnGpu(&node_def)) return false;
+  ITEX_FUSION_MISS_IF(NodeIsOnGpu(&node_def));
 
   // Deal with input data
   bool trans_a;
   ITEX_CHECK_OK(GetNodeAttr(node_def, "transpose_a", &trans_a));
-  if (trans_a) return false;
+  ITEX_FUSION_MISS_IF(trans_a);
 
   bool trans_b;
   ITEX_CHECK_OK(GetNodeAttr(node_def, "transpose_b", &trans_b));
-  if (trans_b) return false;
+  ITEX_FUSION_MISS_IF(trans_b);
 
   return true;
 }
 
 // _FusedMatMulGrad is not rewritten when trans_a/trans_b is true.
 bool RewriteFusedMatMulGrad(const utils::MutableNodeView& node_view) {
-  if (!RewriteBackwardDataType(node_view)) return false;
+  ITEX_FUSION_MISS_IF(!RewriteBackwardDataType(node_view));
 
   // Disable GPU rewrite for better perf.
-  if (RewriteForGPU(node_view)) return false;
+  ITEX_FUSION_MISS_IF(RewriteForGPU(node_view));
 
   return true;
 }
@@ -158,9 +159,9 @@ bool RewriteConv2DBackprop(const utils::MutableNodeView& node_view) {
   // TODO(itex): Remove this limitation once it's supported.
   string padding;
   ITEX_CHECK_OK(GetNodeAttr(node_def, "padding", &padding));
-  if (padding == "EXPLICIT") return false;
+  ITEX_FUSION_MISS_IF(padding == "EXPLICIT");
 
-  if (!RewriteBackwardDataType(node_view)) return false;
+  ITEX_FUSION_MISS_IF(!RewriteBackwardDataType(node_view));
 
   return true;
 }
@@ -191,14 +192,14 @@ bool RewriteMaxPoolGrad(const utils::MutableNodeView& node_view) {
   // rewrite
   const auto& regular_fanin_1 = node_view.GetRegularFanin(1);
   const auto* maxpool_node_view = regular_fanin_1.node_view();
-  if (!IsAnyMaxPool(*maxpool_node_view->node())) return false;
-  if (!RewritePool(*maxpool_node_view)) return false;
+  ITEX_FUSION_MISS_IF(!IsAnyMaxPool(*maxpool_node_view->node()));
+  ITEX_FUSION_MISS_IF(!RewritePool(*maxpool_node_view));
 
   // Output0 of _OneDnnMaxPool/MaxPool should be MaxPoolGrad.
   for (auto fanout : maxpool_node_view->GetRegularFanout(0)) {
     if (fanout.node_view()->node_index() == node_view.node_index()) return true;
   }
-  return false;
+  return FusionMiss("MaxPool output 0 does not feed this MaxPoolGrad");
 }
 
 bool RewriteQuantize(const utils::MutableNodeView& node_view) {
@@ -216,14 +217,14 @@ bool RewriteQuantize(const utils::MutableNodeView& node_view) {
   ITEX_CHECK_OK(GetNodeAttr(node_def, "mode", &mode_string));
   if (mode_string == "MIN_COMBINED") {
     ITEX_VLOG(2) << "MIN_COMBINED are not supported yet";
-    return false;
+    return FusionMiss("MIN_COMBINED mode is not supported");
   }
 
   // oneDNN doesn't support reorder primitive with zeropoint attributes
   if (mode_string == "MIN_FIRST" && node_def.op() == "Dequantize" &&
       NodeIsOnGpu(node_view.node())) {
     ITEX_VLOG(2) << "GPU Dequantize with MIN_FRIST mode are not supported yet";
-    return false;
+    return FusionMiss("MIN_FIRST Dequantize is not supported on GPU");
   }
 
   // Round mode check
@@ -235,7 +236,7 @@ bool RewriteQuantize(const utils::MutableNodeView& node_view) {
           << "SCALED mode only supports HALF_TO_EVEN round mode"
           << "This case is not optimized by OneDnn, thus using Eigen op"
           << "for Quantize op ";
-      return false;
+      return FusionMiss("SCALED mode only supports HALF_TO_EVEN round mode");
     }
   }
 
@@ -283,7 +284,7 @@ bool RewriteQuantizeReshape(const utils::MutableNodeView& node_view) {
   DataType T;
 
   ITEX_CHECK_OK(GetNodeAttr(node_def, "T", &T));
-  if (T != DataType::DT_QINT8) return false;
+  ITEX_FUSION_MISS_IF(T != DataType::DT_QINT8);
 
   return true;
 }
@@ -23,6 +23,8 @@ limitations under the License.
 #include <utility>
 
 #include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_cat.h"
+#include "itex/core/graph/utils/fusion_report.h"
 
 namespace itex {
 namespace graph {
@@ -104,6 +106,10 @@ template <>
 bool SubGraphMatcher<MatchingDirection::kFollowInputs>::DoesOpTypePatternMatch(
     const OpTypePattern& pattern, MutableNodeView* node_view,
     NodeViewMatch* match, bool fanin_checking) {
+  // A mismatch at the root only means the node is not an anchor of the
+  // pattern, it is not reported as a fusion miss.
+  const bool is_root = match == match_.get();
+
   // Currently no control inputs and outputs are allowed.
   // But there's a situation that if a node is remained with controlling
   // fanins, we can continue to the matching.
@@ -111,12 +117,18 @@ bool SubGraphMatcher<MatchingDirection::kFollowInputs>::DoesOpTypePatternMatch(
       (fanin_checking || pattern.node_status != NodeStatus::kRemain)) {
     ITEX_VLOG(3) << pattern.op << "[" << pattern.label
                  << "] failed due to controlling fanins";
+    if (!is_root && FusionReportActive()) {
+      FusionMiss(absl::StrCat(pattern.label, " has controlling fanins"));
+    }
     return false;
   }
 
   if (node_view->NumControlledFanouts() > 0) {
     ITEX_VLOG(3) << pattern.op << "[" << pattern.label
                  << "] failed due to controlled fanouts";
+    if (!is_root && FusionReportActive()) {
+      FusionMiss(absl::StrCat(pattern.label, " has controlled fanouts"));
+    }
     return false;
   }
 
@@ -179,6 +191,10 @@ bool SubGraphMatcher<MatchingDirection::kFollowInputs>::DoesOpTypePatternMatch(
       auto name2 = node_view->node()->name();
       ITEX_VLOG(3) << "The exsiting name is " << name1;
       ITEX_VLOG(3) << "Current name is " << name2;
+      if (FusionReportActive()) {
+        FusionMiss(
+            absl::StrCat(label, " is bound to ", name1, ", not ", name2));
+      }
       return false;  // label constraint could not be satisfied.
     } else {
       ITEX_DCHECK(node_label_to_index_[label] == node_view->node_index());
@@ -186,6 +202,10 @@ bool SubGraphMatcher<MatchingDirection::kFollowInputs>::DoesOpTypePatternMatch(
   } else {
     ITEX_VLOG(3) << "The op type is not match " << node_view->node()->op()
                  << " vs. " << pattern.op;
+    if (!is_root && FusionReportActive()) {
+      FusionMiss(absl::StrCat(pattern.label, " is ", node_view->node()->op(),
+                              ", expected ", pattern.op));
+    }
     return false;
   }
   // Current root of the pattern syntax is matched with the current node.
@@ -201,6 +221,10 @@ bool SubGraphMatcher<MatchingDirection::kFollowInputs>::DoesOpTypePatternMatch(
       ITEX_VLOG(3) << "The " << pattern.label
                    << "'s children size is not consistent (" << num_children
                    << " vs. " << pattern.children.size() << ")";
+      if (FusionReportActive()) {
+        FusionMiss(absl::StrCat(pattern.label, " has ", num_children,
+                                " inputs, expected ", pattern.children.size()));
+      }
       return false;
     } else {
       // A pattern is a graph that we would like to match with a subgraph of
@@ -273,6 +297,7 @@ bool SubGraphMatcher<MatchingDirection::kFollowInputs>::GetMatchedNodes(
       *remove_node_indices = this->remove_node_indices_;
     } else {
       ITEX_VLOG(3) << "Some nodes in preserve set";
+      FusionMiss("nodes to remove are preserved or used outside the pattern");
     }
   } else {
     found_match = false;
@@ -0,0 +1,396 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "itex/core/graph/weight_only_quant/weight_only_quant.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "itex/core/graph/utils/op_types.h"
+#include "itex/core/graph/utils/utils.h"
+#include "itex/core/utils/attr_value_util.h"
+#include "itex/core/utils/float8.h"
+#include "itex/core/utils/node_def_util.h"
+#include "itex/core/utils/plugin_tensor.h"
+#include "itex/core/utils/types.h"
+
+namespace itex {
+namespace graph {
+
+namespace {
+
+constexpr char kWeightOnlyQuantMatMul[] = "_ITEXWeightOnlyQuantMatMul";
+constexpr char kFP8WeightMatMul[] = "_ITEXFP8WeightMatMul";
+constexpr char kDynamicQuantizedMatMul[] = "_ITEXDynamicQuantizedMatMul";
+
+// Small weights stay in cache anyway, so the decompression overhead is not
+// paid back by the saved memory bandwidth.
+constexpr int64_t kMinWeightElements = 64 * 1024;
+
+struct QuantizedWeight {
+  Tensor weight;
+  Tensor scales;
+  Tensor zero_points;
+};
+
+// Reads N and K of the [K, N] (or [N, K] if `transpose_b`) `dtype` weight of
+// `const_node` from its shape, without decoding the values.
+bool GetWeightDims(const NodeDef& const_node, DataType dtype, bool transpose_b,
+                   int64_t* N, int64_t* K) {
+  const TensorProto& proto = const_node.attr().at("value").tensor();
+  const TensorShapeProto& shape = proto.tensor_shape();
+  if (proto.dtype() != dtype || shape.dim_size() != 2) return false;
+
+  *K = shape.dim(transpose_b ? 1 : 0).size();
+  *N = shape.dim(transpose_b ? 0 : 1).size();
+  return true;
+}
+
+// Reads the weight of `const_node` and returns it as a row-major [N, K] float
+// matrix.
+bool GetTransposedWeight(const NodeDef& const_node, DataType dtype,
+                         bool transpose_b, std::vector<float>* weight) {
+  Tensor tensor;
+  if (!tensor.FromProto(const_node.attr().at("value").tensor())) return false;
+  if (tensor.dims() != 2 || tensor.dtype() != dtype) return false;
+
+  const int64_t K = tensor.dim_size(transpose_b ? 1 : 0);
+  weight->resize(tensor.NumElements());
+  for (int64_t i = 0; i < tensor.dim_size(0); ++i) {
+    for (int64_t j = 0; j < tensor.dim_size(1); ++j) {
+      const int64_t src = i * tensor.dim_size(1) + j;
+      const int64_t dst = transpose_b ? src : j * K + i;
+      (*weight)[dst] = dtype == DT_FLOAT
+                           ? tensor.flat<float>()(src)
+                           : static_cast<float>(
+                                 tensor.flat<Eigen::bfloat16>()(src));
+    }
+  }
+  return true;
+}
+
+// Quantizes each group of `group_size` elements along K. INT8 is symmetric,
+// INT4 is asymmetric with an unsigned [0, 15] range, two values per byte with
+// the even k in the low nibble.
+QuantizedWeight QuantizeWeight(const std::vector<float>& weight, int64_t N,
+                               int64_t K, int weight_bits, int group_size) {
+  const int64_t num_groups = (K + group_size - 1) / group_size;
+  const int64_t row_bytes = weight_bits == 8 ? K : (K + 1) / 2;
+  QuantizedWeight quantized{
+      Tensor(weight_bits == 8 ? DT_INT8 : DT_UINT8,
+             TensorShape({N, row_bytes})),
+      Tensor(DT_FLOAT, TensorShape({N, num_groups})),
+      Tensor(DT_INT8, TensorShape({N, num_groups}))};
+  uint8* q = static_cast<uint8*>(quantized.weight.data());
+  float* scales = quantized.scales.flat<float>().data();
+  int8* zero_points = quantized.zero_points.flat<int8>().data();
+  std::fill(q, q + N * row_bytes, 0);
+
+  for (int64_t n = 0; n < N; ++n) {
+    const float* w_row = weight.data() + n * K;
+    uint8* q_row = q + n * row_bytes;
+    for (int64_t g = 0; g < num_groups; ++g) {
+      const int64_t k_begin = g * group_size;
+      const int64_t k_end = std::min<int64_t>(k_begin + group_size, K);
+      float min_val = 0.0f, max_val = 0.0f;
+      for (int64_t k = k_begin; k < k_end; ++k) {
+        min_val = std::min(min_val, w_row[k]);
+        max_val = std::max(max_val, w_row[k]);
+      }
+
+      float scale;
+      int32 zero = 0;
+      if (weight_bits == 8) {
+        scale = std::max(std::abs(min_val), std::abs(max_val)) / 127.0f;
+      } else {
+        scale = (max_val - min_val) / 15.0f;
+      }
+      if (scale == 0.0f) scale = 1.0f;
+      if (weight_bits == 4) {
+        zero = std::min(15, std::max(0, static_cast<int32>(
+                                            std::round(-min_val / scale))));
+      }
+      scales[n * num_groups + g] = scale;
+      zero_points[n * num_groups + g] = static_cast<int8>(zero);
+
+      for (int64_t k = k_begin; k < k_end; ++k) {
+        const int32 value = static_cast<int32>(std::round(w_row[k] / scale));
+        if (weight_bits == 8) {
+          q_row[k] = static_cast<uint8>(
+              static_cast<int8>(std::min(127, std::max(-127, value))));
+        } else {
+          const int32 nibble = std::min(15, std::max(0, value + zero));
+          q_row[k >> 1] |= static_cast<uint8>(nibble << ((k & 1) << 2));
+        }
+      }
+    }
+  }
+  return quantized;
+}
+
+// Stores the whole weight with one scale, chosen so that its absolute maximum
+// maps to the largest finite value of the FP8 format.
+template <typename Tfp8>
+void QuantizeWeightToFP8(const std::vector<float>& weight, float fp8_max,
+                         Tensor* fp8_weight, Tensor* scale) {
+  float amax = 0.0f;
+  for (float w : weight) amax = std::max(amax, std::abs(w));
+  const float weight_scale = amax > 0.0f ? amax / fp8_max : 1.0f;
+  scale->scalar<float>()() = weight_scale;
+
+  uint8* bits = fp8_weight->flat<uint8>().data();
+  for (size_t i = 0; i < weight.size(); ++i) {
+    bits[i] = Tfp8(weight[i] / weight_scale).rep();
+  }
+}
+
+void QuantizeWeightToFP8(const std::vector<float>& weight, bool is_e5m2,
+                         Tensor* fp8_weight, Tensor* scale) {
+  if (is_e5m2) {
+    QuantizeWeightToFP8<float8_e5m2>(weight, 57344.0f, fp8_weight, scale);
+  } else {
+    QuantizeWeightToFP8<float8_e4m3fn>(weight, 448.0f, fp8_weight, scale);
+  }
+}
+
+// Quantizes each row n of the [N, K] weight to SCALED narrow-range qint8
+// with the range [-max(|w[n, :]|), max(|w[n, :]|)].
+void QuantizeWeightPerChannel(const std::vector<float>& weight, int64_t N,
+                              int64_t K, Tensor* q_weight, Tensor* min_weight,
+                              Tensor* max_weight) {
+  int8* q = static_cast<int8*>(q_weight->data());
+  float* min_data = min_weight->flat<float>().data();
+  float* max_data = max_weight->flat<float>().data();
+  for (int64_t n = 0; n < N; ++n) {
+    const float* w_row = weight.data() + n * K;
+    float amax = 0.0f;
+    for (int64_t k = 0; k < K; ++k) amax = std::max(amax, std::abs(w_row[k]));
+    min_data[n] = -amax;
+    max_data[n] = amax;
+    const float scale = amax > 0.0f ? amax / 127.0f : 1.0f;
+    for (int64_t k = 0; k < K; ++k) {
+      const int32 value = static_cast<int32>(std::round(w_row[k] / scale));
+      q[n * K + k] = static_cast<int8>(std::min(127, std::max(-127, value)));
+    }
+  }
+}
+
+NodeDef MakeConstNode(const string& name, const string& device,
+                      const Tensor& value) {
+  NodeDef const_node;
+  const_node.set_name(name);
+  const_node.set_op("Const");
+  const_node.set_device(device);
+  AttrValue attr_value;
+  value.AsProtoTensorContent(attr_value.mutable_tensor());
+  AddNodeAttr("dtype", value.dtype(), &const_node);
+  const_node.mutable_attr()->insert({"value", attr_value});
+  return const_node;
+}
+
+// Appends the compressed weight Consts to `consts` and sets the op-specific
+// attrs of `fused_op`, given the row-major [N, K] float weight.
+using WeightCompressor = std::function<void(
+    const std::vector<float>& weight, int64_t N, int64_t K,
+    std::vector<std::pair<string, Tensor>>* consts, NodeDef* fused_op)>;
+
+// Rewrites every CPU MatMul (+ BiasAdd) with a large float or bfloat16 Const
+// weight into `fused_op_name`, whose inputs are the activation, the Consts
+// produced by `compressor` and the optional bias.
+Status RewriteConstWeightMatMul(const GrapplerItem& item,
+                                GraphDef* optimized_graph,
+                                const string& fused_op_name,
+                                const string& const_prefix,
+                                const WeightCompressor& compressor) {
+  Status status;
+  utils::MutableGraphView graph_view(optimized_graph, &status);
+  TF_RETURN_IF_ERROR(status);
+  const std::unordered_set<string> nodes_to_preserve = item.NodesToPreserve();
+  utils::Mutation* mutation = graph_view.GetMutationBuilder();
+
+  const int num_nodes = optimized_graph->node_size();
+  for (int i = 0; i < num_nodes; ++i) {
+    auto* node_view = graph_view.GetNode(i);
+    const NodeDef* matmul = node_view->node();
+    if (!IsMatMul(*matmul) || !NodeIsOnCpu(matmul)) continue;
+
+    const DataType dtype = GetDataTypeFromAttr(*matmul, "T");
+    if (dtype != DT_FLOAT && dtype != DT_BFLOAT16) continue;
+    if (matmul->attr().at("transpose_a").b()) continue;
+    const bool transpose_b = matmul->attr().at("transpose_b").b();
+
+    auto* weight_view = node_view->GetRegularFanin(1).node_view();
+    if (weight_view == nullptr) continue;
+    const NodeDef* weight_node = weight_view->node();
+    if (!IsConstant(*weight_node)) continue;
+
+    // Skip the small weights before decoding and transposing the large ones.
+    int64_t N, K;
+    if (!GetWeightDims(*weight_node, dtype, transpose_b, &N, &K) ||
+        N * K < kMinWeightElements)
+      continue;
+    std::vector<float> weight;
+    if (!GetTransposedWeight(*weight_node, dtype, transpose_b, &weight)) {
+      continue;
+    }
+
+    // Fold a following BiasAdd when the MatMul result has no other consumer.
+    const NodeDef* bias_add = nullptr;
+    const auto& fanouts = node_view->GetRegularFanout(0);
+    if (fanouts.size() == 1 && node_view->NumControlledFanouts() == 0 &&
+        !nodes_to_preserve.count(matmul->name())) {
+      const auto* fanout_view = fanouts[0].node_view();
+      if (IsBiasAdd(*fanout_view->node()) && fanouts[0].index() == 0 &&
+          fanout_view->NumControllingFanins() == 0) {
+        bias_add = fanout_view->node();
+      }
+    }
+
+    ITEX_VLOG(2) << "Rewrite " << matmul->name() << " to " << fused_op_name
+                 << ", weight shape [" << N << ", " << K << "]";
+
+    NodeDef fused_op;
+    fused_op.set_name(bias_add ? bias_add->name() : matmul->name());
+    fused_op.set_op(fused_op_name);
+    fused_op.set_device(matmul->device());
+    fused_op.add_input(matmul->input(0));
+
+    std::vector<std::pair<string, Tensor>> consts;
+    compressor(weight, N, K, &consts, &fused_op);
+    const string prefix = matmul->name() + "/" + const_prefix;
+    for (const auto& const_item : consts) {
+      const string const_name = prefix + "/" + const_item.first;
+      mutation->AddNode(
+          MakeConstNode(const_name, weight_node->device(), const_item.second),
+          &status);
+      TF_RETURN_IF_ERROR(status);
+      fused_op.add_input(const_name);
+    }
+    if (bias_add) fused_op.add_input(bias_add->input(1));
+    for (const string& input : matmul->input()) {
+      if (IsControlInput(input)) fused_op.add_input(input);
+    }
+
+    AddNodeAttr("T", dtype, &fused_op);
+    AddNodeAttr("num_args", bias_add ? 1 : 0, &fused_op);
+    std::vector<string> fused_ops;
+    if (bias_add) fused_ops.push_back("BiasAdd");
+    AddNodeAttr("fused_ops", fused_ops, &fused_op);
+
+    mutation->AddNode(std::move(fused_op), &status);
+    TF_RETURN_IF_ERROR(status);
+    if (bias_add) mutation->RemoveNode(node_view);
+
+    // Drop the original float weight once nothing else reads it.
+    if (weight_view->NumRegularFanouts() == 1 &&
+        weight_view->NumControlledFanouts() == 0 &&
+        !nodes_to_preserve.count(weight_node->name())) {
+      mutation->RemoveNode(weight_view);
+    }
+  }
+
+  TF_RETURN_IF_ERROR(mutation->Apply());
+  return Status::OK();
+}
+
+}  // namespace
+
+Status RunWeightOnlyQuant(const char* device_name, const GrapplerItem& item,
+                          const GraphDef& graph_def, GraphDef* optimized_graph,
+                          int weight_bits, int group_size) {
+  *optimized_graph = graph_def;
+  if (weight_bits != 4 && weight_bits != 8) {
+    if (weight_bits != 0) {
+      ITEX_LOG(WARNING) << "Weight-only quantization supports 4 or 8 bits, "
+                        << "but got " << weight_bits << ", skipped.";
+    }
+    return Status::OK();
+  }
+  if (group_size < 2 || group_size % 2 != 0) {
+    ITEX_LOG(WARNING) << "Weight-only quantization group size must be a "
+                      << "positive even number, but got " << group_size
+                      << ", skipped.";
+    return Status::OK();
+  }
+
+  auto compressor = [weight_bits, group_size](
+                        const std::vector<float>& weight, int64_t N, int64_t K,
+                        std::vector<std::pair<string, Tensor>>* consts,
+                        NodeDef* fused_op) {
+    QuantizedWeight quantized =
+        QuantizeWeight(weight, N, K, weight_bits, group_size);
+    consts->emplace_back("weight", quantized.weight);
+    consts->emplace_back("scales", quantized.scales);
+    consts->emplace_back("zero_points", quantized.zero_points);
+    AddNodeAttr("Tweight", weight_bits == 8 ? DT_INT8 : DT_UINT8, fused_op);
+    AddNodeAttr("weight_bits", weight_bits, fused_op);
+    AddNodeAttr("group_size", group_size, fused_op);
+  };
+  return RewriteConstWeightMatMul(item, optimized_graph, kWeightOnlyQuantMatMul,
+                                  "weight_only_quant", compressor);
+}
+
+Status RunFP8WeightQuant(const char* device_name, const GrapplerItem& item,
+                         const GraphDef& graph_def, GraphDef* optimized_graph,
+                         const string& fp8_format) {
+  *optimized_graph = graph_def;
+  if (fp8_format != "E4M3" && fp8_format != "E5M2") {
+    if (!fp8_format.empty()) {
+      ITEX_LOG(WARNING) << "FP8 weight storage supports E4M3 or E5M2, "
+                        << "but got " << fp8_format << ", skipped.";
+    }
+    return Status::OK();
+  }
+
+  auto compressor = [&fp8_format](
+                        const std::vector<float>& weight, int64_t N, int64_t K,
+                        std::vector<std::pair<string, Tensor>>* consts,
+                        NodeDef* fused_op) {
+    consts->emplace_back("weight", Tensor(DT_UINT8, TensorShape({N, K})));
+    consts->emplace_back("scale", Tensor(DT_FLOAT, TensorShape({})));
+    QuantizeWeightToFP8(weight, fp8_format == "E5M2", &(*consts)[0].second,
+                        &(*consts)[1].second);
+    AddNodeAttr("fp8_format", fp8_format, fused_op);
+  };
+  return RewriteConstWeightMatMul(item, optimized_graph, kFP8WeightMatMul,
+                                  "fp8_weight", compressor);
+}
+
+Status RunDynamicQuant(const char* device_name, const GrapplerItem& item,
+                       const GraphDef& graph_def, GraphDef* optimized_graph) {
+  *optimized_graph = graph_def;
+  auto compressor = [](const std::vector<float>& weight, int64_t N, int64_t K,
+                       std::vector<std::pair<string, Tensor>>* consts,
+                       NodeDef* fused_op) {
+    consts->emplace_back("weight", Tensor(DT_QINT8, TensorShape({N, K})));
+    consts->emplace_back("min", Tensor(DT_FLOAT, TensorShape({N})));
+    consts->emplace_back("max", Tensor(DT_FLOAT, TensorShape({N})));
+    QuantizeWeightPerChannel(weight, N, K, &(*consts)[0].second,
+                             &(*consts)[1].second, &(*consts)[2].second);
+    AddNodeAttr("transpose_b", true, fused_op);
+    AddNodeAttr("is_weight_const", true, fused_op);
+  };
+  return RewriteConstWeightMatMul(item, optimized_graph,
+                                  kDynamicQuantizedMatMul, "dynamic_quant",
+                                  compressor);
+}
+
+}  // namespace graph
+}  // namespace itex
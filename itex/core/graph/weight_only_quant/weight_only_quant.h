@@ -0,0 +1,53 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef ITEX_CORE_GRAPH_WEIGHT_ONLY_QUANT_WEIGHT_ONLY_QUANT_H_
+#define ITEX_CORE_GRAPH_WEIGHT_ONLY_QUANT_WEIGHT_ONLY_QUANT_H_
+
+#include <string>
+
+#include "itex/core/graph/utils/graph_view.h"
+#include "itex/core/graph/utils/grappler_item.h"
+#include "itex/core/utils/status.h"
+#include "protos/graph.pb.h"
+
+namespace itex {
+namespace graph {
+
+// Rewrites CPU MatMul (+ BiasAdd) nodes whose weight is a float or bfloat16
+// Const into _ITEXWeightOnlyQuantMatMul. The weight is quantized offline to
+// `weight_bits` (4 or 8) with one scale and zero point per `group_size`
+// consecutive elements along K, and stored transposed as [N, K].
+Status RunWeightOnlyQuant(const char* device_name, const GrapplerItem& item,
+                          const GraphDef& graph_def, GraphDef* optimized_graph,
+                          int weight_bits, int group_size);
+
+// Rewrites the same pattern into _ITEXFP8WeightMatMul, storing the weight as
+// [N, K] FP8 bits in `fp8_format` ("E4M3" or "E5M2") with one float scale.
+Status RunFP8WeightQuant(const char* device_name, const GrapplerItem& item,
+                         const GraphDef& graph_def, GraphDef* optimized_graph,
+                         const string& fp8_format);
+
+// Rewrites the same pattern into _ITEXDynamicQuantizedMatMul, storing the
+// weight as [N, K] qint8 with one symmetric range per output channel. The
+// activation is quantized per token by the kernel, so no calibration is
+// needed.
+Status RunDynamicQuant(const char* device_name, const GrapplerItem& item,
+                       const GraphDef& graph_def, GraphDef* optimized_graph);
+
+}  // namespace graph
+}  // namespace itex
+
+#endif  // ITEX_CORE_GRAPH_WEIGHT_ONLY_QUANT_WEIGHT_ONLY_QUANT_H_
@@ -67,6 +67,7 @@ void InitGlobalSetting(const OptimizerConfigFlags& config) {
                << itex_version->patch << ", commit: " << itex_version->hash;
 
 #ifdef INTEL_CPU_ONLY
+#ifndef ITEX_ONEDNN_THREADPOOL
   const int32_t cpu_num = itex::port::MaxParallelism();
 
   // OneDNN library executes ops in parallel using OMP threads.
@@ -89,6 +90,10 @@ void InitGlobalSetting(const OptimizerConfigFlags& config) {
 
   // Set inter_op_parallelism_threads if it's not initialized.
   setenv("TF_NUM_INTEROP_THREADS", std::to_string(itex_inter_num).c_str(), 0);
+#else
+  // OneDNN runs the primitives of concurrent ops on the shared threads of
+  // OneDnnThreadPool, so inter_op is left to TensorFlow.
+#endif  // ITEX_ONEDNN_THREADPOOL
 
   // Initialize CPU allocator:
   //   For stock TF version >= 2.9, stock TF will enable MklCPUAllocator by
@@ -12,16 +12,24 @@ limitations under the License.
 
 #include "itex/core/graph/xpu_optimizer.h"
 
+#include <memory>
+
 #include "itex/core/graph/auto_mixed_precision/auto_mixed_precision.h"
 #include "itex/core/graph/generic_layout_optimizer/generic_layout_optimizer.h"
 #include "itex/core/graph/memory_opt_pass/memory_opt_pass.h"
+#include "itex/core/graph/multi_tensor_apply/multi_tensor_apply.h"
 #include "itex/core/graph/native_layout/native_layout.h"
 #include "itex/core/graph/onednn_graph/onednn_graph.h"
 #include "itex/core/graph/onednn_layout/onednn_layout.h"
 #include "itex/core/graph/optimizer_config.h"
 #include "itex/core/graph/remapper/remapper.h"
+#include "itex/core/graph/utils/fusion_report.h"
 #include "itex/core/graph/utils/utils.h"
+#include "itex/core/graph/weight_only_quant/weight_only_quant.h"
+#include "itex/core/utils/env_time.h"
 #include "itex/core/utils/errors.h"
+#include "itex/core/utils/execution_domain.h"
+#include "itex/core/utils/graph_metrics.h"
 #include "itex/core/utils/op_kernel.h"
 #include "tensorflow/c/experimental/grappler/grappler.h"
 
@@ -50,6 +58,46 @@ void Optimizer_Destroy(void* optimizer) {
   if (optimizer) delete reinterpret_cast<Optimizer*>(optimizer);
 }
 
+namespace {
+
+// Binds the kernels of the graph, including those of its functions, to the
+// execution domain of the optimizing thread, so they run in it on whichever
+// thread TF executes them.
+void BindToExecutionDomain(int id, GraphDef* graph_def) {
+  for (NodeDef& node : *graph_def->mutable_node()) {
+    (*node.mutable_attr())[kExecutionDomainAttr].set_i(id);
+  }
+  for (FunctionDef& function :
+       *graph_def->mutable_library()->mutable_function()) {
+    for (NodeDef& node : *function.mutable_node_def()) {
+      (*node.mutable_attr())[kExecutionDomainAttr].set_i(id);
+    }
+  }
+}
+
+metrics::GraphSize SizeOf(const GraphDef& graph_def) {
+  metrics::GraphSize size;
+  size.nodes = graph_def.node_size();
+  for (const NodeDef& node : graph_def.node()) size.edges += node.input_size();
+  return size;
+}
+
+// Runs "pass", which rewrites "graph_def" into "optimized_graph_def", and
+// records its time and the graph size before and after it in the graph
+// metrics. Shape inference within the pass is attributed to it.
+template <typename Pass>
+Status RunPass(const char* name, const GraphDef& graph_def,
+               const GraphDef* optimized_graph_def, Pass&& pass) {
+  metrics::ScopedGraphPass pass_scope(name);
+  const uint64 start_us = EnvTime::NowMicros();
+  TF_RETURN_IF_ERROR(pass());
+  metrics::RecordGraphPass(name, EnvTime::NowMicros() - start_us,
+                           SizeOf(graph_def), SizeOf(*optimized_graph_def));
+  return Status::OK();
+}
+
+}  // namespace
+
 void Optimizer_Optimize(void* optimizer, const TF_Buffer* graph_buf,
                         const TF_GrapplerItem* tf_item,
                         TF_Buffer* optimized_graph_buf, TF_Status* tf_status) {
@@ -57,10 +105,7 @@ void Optimizer_Optimize(void* optimizer, const TF_Buffer* graph_buf,
   const char* device_name = (static_cast<Optimizer*>(optimizer))->device_name;
 
   // Used for calculating time consumption of ITEX graph optimization.
-  std::chrono::steady_clock::time_point start, end;
-  if (IsVerboseEnabled()) {
-    start = std::chrono::steady_clock::now();
-  }
+  const uint64 start_us = EnvTime::NowMicros();
 
   // Get GrapplerItem.
   GrapplerItem item(tf_item);
@@ -71,6 +116,11 @@ void Optimizer_Optimize(void* optimizer, const TF_Buffer* graph_buf,
   GraphDef optimized_graph_def = graph_def;
   auto config = GetOptimizerConfigFlags();
 
+  // Passes report their fusion candidates to it, see fusion_report.h.
+  std::unique_ptr<FusionReport> fusion_report;
+  if (!config.fusion_report_dir.empty()) fusion_report.reset(new FusionReport);
+  ScopedFusionReport fusion_report_scope(fusion_report.get());
+
   if (config.enable_sharding) {
     optimized_graph_def.Swap(&graph_def);
     // TODO(itex): enable the pass when the PR is merged.
@@ -82,76 +132,151 @@ void Optimizer_Optimize(void* optimizer, const TF_Buffer* graph_buf,
 
   optimized_graph_def.Swap(&graph_def);
   GenericLayoutOptimizer generic_layout_opt;
-  SET_STATUS_IF_ERROR(tf_status,
-                      generic_layout_opt.Optimize(device_name, item, graph_def,
-                                                  &optimized_graph_def));
+  SET_STATUS_IF_ERROR(
+      tf_status,
+      RunPass("generic_layout_optimizer", graph_def, &optimized_graph_def, [&] {
+        return generic_layout_opt.Optimize(device_name, item, graph_def,
+                                           &optimized_graph_def);
+      }));
+
+  // Run before remapper, which would otherwise fuse MatMul + BiasAdd into
+  // _ITEXFusedMatMul and hide the constant weight.
+  if (config.weight_only_quant_bits != 0) {
+    optimized_graph_def.Swap(&graph_def);
+    SET_STATUS_IF_ERROR(
+        tf_status,
+        RunPass("weight_only_quant", graph_def, &optimized_graph_def, [&] {
+          return RunWeightOnlyQuant(device_name, item, graph_def,
+                                    &optimized_graph_def,
+                                    config.weight_only_quant_bits,
+                                    config.weight_only_quant_group_size);
+        }));
+  }
+  if (!config.weight_fp8_format.empty()) {
+    optimized_graph_def.Swap(&graph_def);
+    SET_STATUS_IF_ERROR(
+        tf_status,
+        RunPass("fp8_weight_quant", graph_def, &optimized_graph_def, [&] {
+          return RunFP8WeightQuant(device_name, item, graph_def,
+                                   &optimized_graph_def,
+                                   config.weight_fp8_format);
+        }));
+  }
+  if (config.enable_dynamic_quant) {
+    optimized_graph_def.Swap(&graph_def);
+    SET_STATUS_IF_ERROR(
+        tf_status,
+        RunPass("dynamic_quant", graph_def, &optimized_graph_def, [&] {
+          return RunDynamicQuant(device_name, item, graph_def,
+                                 &optimized_graph_def);
+        }));
+  }
 
   if (config.enable_remapper) {
     // We don't want full scope remapper here if oneDNN graph is enabled.
     for (int i = 0; i < config.remapper_run_pass; ++i) {
       optimized_graph_def.Swap(&graph_def);
       SET_STATUS_IF_ERROR(
-          tf_status,
-          RunRemapper(device_name, item, graph_def, &optimized_graph_def,
-                      !config.enable_onednn_graph, i));
+          tf_status, RunPass("remapper", graph_def, &optimized_graph_def, [&] {
+            return RunRemapper(device_name, item, graph_def,
+                               &optimized_graph_def,
+                               !config.enable_onednn_graph, i);
+          }));
     }
   }
 
   if (config.enable_auto_mixed_precision) {
     optimized_graph_def.Swap(&graph_def);
-    SET_STATUS_IF_ERROR(tf_status,
-                        RunAutoMixedPrecision(device_name, item, graph_def,
-                                              &optimized_graph_def));
+    SET_STATUS_IF_ERROR(
+        tf_status,
+        RunPass("auto_mixed_precision", graph_def, &optimized_graph_def, [&] {
+          return RunAutoMixedPrecision(device_name, item, graph_def,
+                                       &optimized_graph_def);
+        }));
     // Because after running auto_mixed_precision, it will insert Cast op
     // before Const op. So run remapper Const + Cast fusion will remove
     // these overhead.
     // We don't want ITEX remapper pass change graph before LLGA pass
     if (config.enable_remapper) {
       optimized_graph_def.Swap(&graph_def);
-      SET_STATUS_IF_ERROR(tf_status, RunRemapper(device_name, item, graph_def,
-                                                 &optimized_graph_def,
-                                                 !config.enable_onednn_graph));
+      SET_STATUS_IF_ERROR(
+          tf_status, RunPass("remapper", graph_def, &optimized_graph_def, [&] {
+            return RunRemapper(device_name, item, graph_def,
+                               &optimized_graph_def,
+                               !config.enable_onednn_graph);
+          }));
     }
   }
 
   if (config.enable_onednn_graph) {
     optimized_graph_def.Swap(&graph_def);
-    SET_STATUS_IF_ERROR(tf_status,
-                        RunOneDnnGraph(item, graph_def, &optimized_graph_def));
+    SET_STATUS_IF_ERROR(
+        tf_status,
+        RunPass("onednn_graph", graph_def, &optimized_graph_def, [&] {
+          return RunOneDnnGraph(item, graph_def, &optimized_graph_def);
+        }));
 
     // Run the full scope remapper here since only got partial remapper before
     // if oneDNN graph is enabled.
     if (config.enable_remapper) {
       for (int i = 0; i < config.remapper_run_pass; ++i) {
         optimized_graph_def.Swap(&graph_def);
-        SET_STATUS_IF_ERROR(tf_status,
-                            RunRemapper(device_name, item, graph_def,
-                                        &optimized_graph_def, true, i));
+        SET_STATUS_IF_ERROR(
+            tf_status,
+            RunPass("remapper", graph_def, &optimized_graph_def, [&] {
+              return RunRemapper(device_name, item, graph_def,
+                                 &optimized_graph_def, true, i);
+            }));
       }
     }
   }
 
+  if (config.enable_multi_tensor_apply) {
+    optimized_graph_def.Swap(&graph_def);
+    SET_STATUS_IF_ERROR(
+        tf_status,
+        RunPass("multi_tensor_apply", graph_def, &optimized_graph_def, [&] {
+          return RunMultiTensorApply(device_name, item, graph_def,
+                                     &optimized_graph_def);
+        }));
+  }
+
   if (config.enable_layout_opt) {
     optimized_graph_def.Swap(&graph_def);
-    SET_STATUS_IF_ERROR(tf_status, RunOneDnnLayout(device_name, item, graph_def,
-                                                   &optimized_graph_def));
+    SET_STATUS_IF_ERROR(
+        tf_status,
+        RunPass("onednn_layout", graph_def, &optimized_graph_def, [&] {
+          return RunOneDnnLayout(device_name, item, graph_def,
+                                 &optimized_graph_def);
+        }));
   }
 
   // Put post Native Format rewrite pass for better co-working with oneDNN
   // layout.
   optimized_graph_def.Swap(&graph_def);
-  SET_STATUS_IF_ERROR(tf_status, RunNativeLayout(device_name, item, graph_def,
-                                                 &optimized_graph_def));
+  SET_STATUS_IF_ERROR(
+      tf_status, RunPass("native_layout", graph_def, &optimized_graph_def, [&] {
+        return RunNativeLayout(device_name, item, graph_def,
+                               &optimized_graph_def);
+      }));
 
   // Memory Optimization
   optimized_graph_def.Swap(&graph_def);
-  SET_STATUS_IF_ERROR(tf_status, RunMemoryOptPass(device_name, item, graph_def,
-                                                  &optimized_graph_def));
+  SET_STATUS_IF_ERROR(
+      tf_status, RunPass("memory_opt", graph_def, &optimized_graph_def, [&] {
+        return RunMemoryOptPass(device_name, item, graph_def,
+                                &optimized_graph_def);
+      }));
+
+  const ExecutionDomain* execution_domain = ExecutionDomain::Current();
+  if (execution_domain != nullptr) {
+    BindToExecutionDomain(execution_domain->id(), &optimized_graph_def);
+  }
 
+  const uint64 duration_us = EnvTime::NowMicros() - start_us;
+  metrics::RecordGraphOptimization(duration_us);
   if (IsVerboseEnabled()) {
-    end = std::chrono::steady_clock::now();
-    std::chrono::duration<double> duration = end - start;
-    ITEX_VLOG(0) << "Time for graph optimize costs " << duration.count()
+    ITEX_VLOG(0) << "Time for graph optimize costs " << duration_us / 1e6
                  << " sec\n";
   }
 
@@ -159,6 +284,15 @@ void Optimizer_Optimize(void* optimizer, const TF_Buffer* graph_buf,
     DumpGraphDefToFile("itex_optimizer", optimized_graph_def, "./");
   }
 
+  if (fusion_report != nullptr) {
+    Status report_status =
+        fusion_report->Write(config.fusion_report_dir, optimized_graph_def);
+    if (!report_status.ok()) {
+      ITEX_LOG(WARNING) << "Failed to write fusion report: "
+                        << report_status.ToString();
+    }
+  }
+
   // Serialize output GraphDef into optimized_graph_buf.
   SET_STATUS_IF_ERROR(
       tf_status, MessageToBuffer(optimized_graph_def, optimized_graph_buf));
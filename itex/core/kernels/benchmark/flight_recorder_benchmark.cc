@@ -0,0 +1,156 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Measures the cost of the flight recorder on a kernel-heavy step: the
+// MatMul and Relu kernels of an MLP, computed through KernelHarness so that
+// every run goes through ScopedFlightRecord like in TensorFlow.
+//
+// Usage: flight_recorder_benchmark [--batch=64] [--width=1024] [--layers=8]
+//                                  [--min_time=2]
+//
+// The binary prints the median time of a step, the cost of recording one
+// kernel run and the share of the step spent recording. The recorder reads
+// ITEX_FLIGHT_RECORDER once, so compare the step time of a run with
+// ITEX_FLIGHT_RECORDER=0 against one with the default. Nothing is asserted,
+// the numbers depend on the machine.
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "itex/core/kernels/benchmark/kernel_harness.h"
+#include "itex/core/utils/command_line_flags.h"
+#include "itex/core/utils/env_time.h"
+#include "itex/core/utils/flight_recorder.h"
+#include "itex/core/utils/node_def_util.h"
+#include "itex/core/utils/strcat.h"
+#include "itex/core/utils/types.h"
+
+namespace itex {
+namespace {
+
+constexpr int kWarmupSteps = 3;
+constexpr int kRecordIterations = 1000000;
+
+Tensor RandomTensor(const TensorShape& shape, std::mt19937* rng) {
+  Tensor tensor(DT_FLOAT, shape);
+  std::normal_distribution<float> normal;
+  auto flat = tensor.flat<float>();
+  for (int64 i = 0; i < flat.size(); ++i) flat(i) = normal(*rng);
+  return tensor;
+}
+
+Status CreateKernel(const std::string& op, const std::string& name,
+                    std::vector<Tensor> inputs,
+                    std::vector<std::unique_ptr<KernelHarness>>* kernels) {
+  NodeDef node_def;
+  node_def.set_op(op);
+  node_def.set_name(name);
+  AddNodeAttr("T", DT_FLOAT, &node_def);
+  if (op == "_ITEXMatMul") {
+    AddNodeAttr("transpose_a", false, &node_def);
+    AddNodeAttr("transpose_b", false, &node_def);
+    AddNodeAttr("is_filter_const", true, &node_def);
+  }
+  std::unique_ptr<KernelHarness> harness;
+  TF_RETURN_IF_ERROR(KernelHarness::Create(node_def, std::move(inputs),
+                                           {DT_FLOAT}, &harness));
+  kernels->push_back(std::move(harness));
+  return Status::OK();
+}
+
+// Nanoseconds to record one kernel run as ScopedFlightRecord does, 0 if the
+// recorder is off.
+double RecordNanos() {
+  const int32 op_id =
+      flight_recorder::InternOp("flight_recorder_benchmark", "Record");
+  if (op_id < 0) return 0;
+  const uint64 start = EnvTime::NowNanos();
+  for (int i = 0; i < kRecordIterations; ++i) {
+    const uint64 run_start = EnvTime::NowNanos();
+    flight_recorder::Record(op_id, i, run_start, EnvTime::NowNanos());
+  }
+  return static_cast<double>(EnvTime::NowNanos() - start) / kRecordIterations;
+}
+
+int Main(int argc, char** argv) {
+  int32 batch = 64;
+  int32 width = 1024;
+  int32 layers = 8;
+  float min_time = 2;
+  std::vector<Flag> flag_list = {
+      Flag("batch", &batch, "Rows of the activations."),
+      Flag("width", &width, "Width of every layer."),
+      Flag("layers", &layers, "MatMul and Relu layers of the step."),
+      Flag("min_time", &min_time, "Minimum seconds to run the steps."),
+  };
+  const std::string usage = Flags::Usage(argv[0], flag_list);
+  if (!Flags::Parse(&argc, argv, flag_list) || argc != 1) {
+    std::fprintf(stderr, "%s", usage.c_str());
+    return 2;
+  }
+
+  std::mt19937 rng(301);
+  const Tensor activation = RandomTensor(TensorShape({batch, width}), &rng);
+  std::vector<std::unique_ptr<KernelHarness>> kernels;
+  for (int l = 0; l < layers; ++l) {
+    Status s = CreateKernel(
+        "_ITEXMatMul", strings::StrCat("dense_", l, "/MatMul"),
+        {activation, RandomTensor(TensorShape({width, width}), &rng)},
+        &kernels);
+    if (s.ok()) {
+      s = CreateKernel("_ITEXRelu", strings::StrCat("dense_", l, "/Relu"),
+                       {activation}, &kernels);
+    }
+    if (!s.ok()) {
+      std::fprintf(stderr, "%s\n", s.ToString().c_str());
+      return 1;
+    }
+  }
+
+  auto run_step = [&kernels]() {
+    for (auto& kernel : kernels) ITEX_CHECK_OK(kernel->Run());
+  };
+  for (int i = 0; i < kWarmupSteps; ++i) run_step();
+  std::vector<double> usecs;
+  const uint64 start = EnvTime::NowNanos();
+  while (usecs.size() < 10 ||
+         EnvTime::NowNanos() - start < static_cast<uint64>(min_time * 1e9)) {
+    const uint64 step_start = EnvTime::NowNanos();
+    run_step();
+    usecs.push_back((EnvTime::NowNanos() - step_start) / 1e3);
+  }
+  std::sort(usecs.begin(), usecs.end());
+  const double step_usecs = usecs[usecs.size() / 2];
+
+  const double record_nanos = RecordNanos();
+  const double recorded_usecs = kernels.size() * record_nanos / 1e3;
+  std::printf("flight recorder: %s\n",
+              flight_recorder::IsEnabled() ? "on" : "off");
+  std::printf("step of %zu kernels: %.1f us (median of %zu)\n",
+              kernels.size(), step_usecs, usecs.size());
+  std::printf("record of one kernel run: %.1f ns\n", record_nanos);
+  std::printf("recording per step: %.2f us, %.3f%% of the step\n",
+              recorded_usecs, 100 * recorded_usecs / step_usecs);
+  return 0;
+}
+
+}  // namespace
+}  // namespace itex
+
+int main(int argc, char** argv) { return itex::Main(argc, argv); }
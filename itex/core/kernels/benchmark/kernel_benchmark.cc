@@ -0,0 +1,445 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Benchmarks the ITEX CPU kernels, both the plain ones of kernels/cpu and
+// the oneDNN block layout ones of kernels/onednn/block, by calling their
+// Compute directly through KernelHarness. Shapes and dtypes (float,
+// bfloat16, int8) are swept, and every kernel reports the median time of a
+// Compute call with the resulting GFLOP/s and GB/s.
+//
+// Usage: kernel_benchmark [--filter=MatMul] [--dtypes=float,bfloat16,int8]
+//                         [--min_time=0.5] [--output=results.json]
+//                         [--baseline=baseline.json] [--tolerance=0.1]
+//                         [--update_baseline]
+//
+// With --baseline the results are compared against a stored run of the same
+// binary on the same machine: a kernel whose GFLOP/s (GB/s for memory-bound
+// kernels) dropped by more than --tolerance is reported as a regression and
+// the binary exits with status 1. --update_baseline writes the results as the
+// new baseline instead. Warm-up runs create the oneDNN primitives and fill
+// the weight caches first, so only the steady state is measured.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/match.h"
+#include "absl/strings/str_split.h"
+#include "itex/core/kernels/benchmark/kernel_benchmark.pb.h"
+#include "itex/core/kernels/benchmark/kernel_harness.h"
+#include "itex/core/utils/command_line_flags.h"
+#include "itex/core/utils/cpu_info.h"
+#include "itex/core/utils/env.h"
+#include "itex/core/utils/env_time.h"
+#include "itex/core/utils/errors.h"
+#include "itex/core/utils/human_readable_json.h"
+#include "itex/core/utils/node_def_util.h"
+#include "itex/core/utils/strcat.h"
+#include "itex/core/utils/types.h"
+
+namespace itex {
+namespace {
+
+constexpr int kWarmupRuns = 3;
+constexpr size_t kMinRuns = 10;
+constexpr size_t kMaxRuns = 100000;
+
+struct BenchmarkCase {
+  std::string name;
+  std::string dtype;
+  NodeDef node_def;
+  std::vector<Tensor> inputs;
+  std::vector<DataType> output_types;
+  // Work of one Compute call. Kernels with no flops are memory-bound and
+  // compared on bytes.
+  double flops = 0;
+  double bytes = 0;
+};
+
+Tensor RandomTensor(DataType dtype, const TensorShape& shape,
+                    std::mt19937* rng) {
+  Tensor tensor(dtype, shape);
+  std::normal_distribution<float> normal;
+  std::uniform_int_distribution<int> int8(-127, 127);
+  switch (dtype) {
+    case DT_FLOAT:
+      for (auto& v : tensor.flat<float>()) v = normal(*rng);
+      break;
+    case DT_BFLOAT16:
+      for (auto& v : tensor.flat<Eigen::bfloat16>()) {
+        v = Eigen::bfloat16(normal(*rng));
+      }
+      break;
+    case DT_QINT8:
+      for (auto& v : tensor.flat<qint8>()) v = qint8(int8(*rng));
+      break;
+    default:
+      ITEX_LOG(FATAL) << "Unsupported benchmark dtype "
+                      << DataTypeString(dtype);
+  }
+  return tensor;
+}
+
+NodeDef MakeNodeDef(const std::string& op, const std::string& name) {
+  NodeDef node_def;
+  node_def.set_op(op);
+  node_def.set_name(name);
+  return node_def;
+}
+
+std::string ShapeString(std::initializer_list<int64> dims) {
+  std::string result;
+  for (int64 dim : dims) {
+    strings::StrAppend(&result, result.empty() ? "" : "x", dim);
+  }
+  return result;
+}
+
+// C[M, N] = A[M, K] * B[K, N], with B a constant weight as in inference.
+void AddMatMulCases(DataType dtype, std::mt19937* rng,
+                    std::vector<BenchmarkCase>* cases) {
+  const int64 shapes[][3] = {
+      {32, 4096, 4096}, {128, 1024, 1024}, {512, 1024, 1024},
+      {1024, 4096, 1024}};
+  const int size = DataTypeSize(dtype);
+  for (const auto& shape : shapes) {
+    const int64 M = shape[0], K = shape[1], N = shape[2];
+    for (bool block_layout : {false, true}) {
+      BenchmarkCase c;
+      c.dtype = DataTypeString(dtype);
+      c.name = strings::StrCat(block_layout ? "OneDnnMatMul/" : "MatMul/",
+                               c.dtype, "/", ShapeString({M, K, N}));
+      c.node_def = MakeNodeDef(block_layout ? "_OneDnnMatMul" : "_ITEXMatMul",
+                               c.name);
+      AddNodeAttr("T", dtype, &c.node_def);
+      AddNodeAttr("transpose_a", false, &c.node_def);
+      AddNodeAttr("transpose_b", false, &c.node_def);
+      AddNodeAttr("is_filter_const", true, &c.node_def);
+      c.inputs.push_back(RandomTensor(dtype, TensorShape({M, K}), rng));
+      c.inputs.push_back(RandomTensor(dtype, TensorShape({K, N}), rng));
+      c.output_types = {dtype};
+      if (block_layout) AppendPlainLayoutMetaData(&c.inputs, &c.output_types);
+      c.flops = 2.0 * M * N * K;
+      c.bytes = static_cast<double>(M * K + K * N + M * N) * size;
+      cases->push_back(std::move(c));
+    }
+  }
+}
+
+// NHWC convolution with a constant filter, ResNet-50 like layers.
+void AddConv2DCases(DataType dtype, std::mt19937* rng,
+                    std::vector<BenchmarkCase>* cases) {
+  struct ConvShape {
+    int64 n, h, w, c, k, oc, stride;
+  };
+  const ConvShape shapes[] = {{32, 224, 224, 3, 7, 64, 2},
+                              {32, 56, 56, 64, 3, 64, 1},
+                              {32, 56, 56, 256, 1, 64, 1},
+                              {32, 28, 28, 128, 3, 128, 1}};
+  const int size = DataTypeSize(dtype);
+  for (const ConvShape& s : shapes) {
+    const int64 oh = (s.h + s.stride - 1) / s.stride;
+    const int64 ow = (s.w + s.stride - 1) / s.stride;
+    for (bool block_layout : {false, true}) {
+      BenchmarkCase c;
+      c.dtype = DataTypeString(dtype);
+      c.name = strings::StrCat(block_layout ? "OneDnnConv2D/" : "Conv2D/",
+                               c.dtype, "/", ShapeString({s.n, s.h, s.w, s.c}),
+                               "_k", s.k, "_oc", s.oc, "_s", s.stride);
+      c.node_def = MakeNodeDef(block_layout ? "_OneDnnConv2D" : "_ITEXConv2D",
+                               c.name);
+      AddNodeAttr("T", dtype, &c.node_def);
+      const int32 stride = static_cast<int32>(s.stride);
+      AddNodeAttr("strides", std::vector<int32>{1, stride, stride, 1},
+                  &c.node_def);
+      AddNodeAttr("dilations", std::vector<int32>{1, 1, 1, 1}, &c.node_def);
+      AddNodeAttr("padding", "SAME", &c.node_def);
+      AddNodeAttr("data_format", "NHWC", &c.node_def);
+      AddNodeAttr("is_filter_const", true, &c.node_def);
+      c.inputs.push_back(
+          RandomTensor(dtype, TensorShape({s.n, s.h, s.w, s.c}), rng));
+      c.inputs.push_back(
+          RandomTensor(dtype, TensorShape({s.k, s.k, s.c, s.oc}), rng));
+      c.output_types = {dtype};
+      if (block_layout) AppendPlainLayoutMetaData(&c.inputs, &c.output_types);
+      c.flops = 2.0 * s.n * oh * ow * s.oc * s.k * s.k * s.c;
+      c.bytes = static_cast<double>(s.n * s.h * s.w * s.c +
+                                    s.k * s.k * s.c * s.oc +
+                                    s.n * oh * ow * s.oc) *
+                size;
+      cases->push_back(std::move(c));
+    }
+  }
+}
+
+// Memory-bound kernels: Relu, Softmax and, for bfloat16, the Cast from float.
+void AddMemoryBoundCases(DataType dtype, std::mt19937* rng,
+                         std::vector<BenchmarkCase>* cases) {
+  const int size = DataTypeSize(dtype);
+  for (int64 n : {int64{1} << 20, int64{1} << 24}) {
+    BenchmarkCase c;
+    c.dtype = DataTypeString(dtype);
+    c.name = strings::StrCat("Relu/", c.dtype, "/", n);
+    c.node_def = MakeNodeDef("_ITEXRelu", c.name);
+    AddNodeAttr("T", dtype, &c.node_def);
+    c.inputs.push_back(RandomTensor(dtype, TensorShape({n}), rng));
+    c.output_types = {dtype};
+    c.bytes = 2.0 * n * size;
+    cases->push_back(std::move(c));
+  }
+  const int64 softmax_shapes[][2] = {{1024, 1000}, {65536, 128}};
+  for (const auto& shape : softmax_shapes) {
+    BenchmarkCase c;
+    c.dtype = DataTypeString(dtype);
+    c.name = strings::StrCat("Softmax/", c.dtype, "/",
+                             ShapeString({shape[0], shape[1]}));
+    c.node_def = MakeNodeDef("_ITEXSoftmax", c.name);
+    AddNodeAttr("T", dtype, &c.node_def);
+    c.inputs.push_back(
+        RandomTensor(dtype, TensorShape({shape[0], shape[1]}), rng));
+    c.output_types = {dtype};
+    c.bytes = 2.0 * shape[0] * shape[1] * size;
+    cases->push_back(std::move(c));
+  }
+  if (dtype == DT_BFLOAT16) {
+    const int64 n = int64{1} << 24;
+    BenchmarkCase c;
+    c.dtype = "float->bfloat16";
+    c.name = strings::StrCat("Cast/", c.dtype, "/", n);
+    c.node_def = MakeNodeDef("_ITEXCast", c.name);
+    AddNodeAttr("SrcT", DT_FLOAT, &c.node_def);
+    AddNodeAttr("DstT", DT_BFLOAT16, &c.node_def);
+    AddNodeAttr("Truncate", false, &c.node_def);
+    c.inputs.push_back(RandomTensor(DT_FLOAT, TensorShape({n}), rng));
+    c.output_types = {DT_BFLOAT16};
+    c.bytes = static_cast<double>(n) * (sizeof(float) + size);
+    cases->push_back(std::move(c));
+  }
+}
+
+// INT8 MatMul of a float activation, quantized per token, with a per-channel
+// quantized weight.
+void AddInt8MatMulCases(std::mt19937* rng, std::vector<BenchmarkCase>* cases) {
+  const int64 shapes[][3] = {{32, 4096, 4096}, {512, 1024, 1024}};
+  for (const auto& shape : shapes) {
+    const int64 M = shape[0], K = shape[1], N = shape[2];
+    BenchmarkCase c;
+    c.dtype = "int8";
+    c.name = strings::StrCat("DynamicQuantizedMatMul/", c.dtype, "/",
+                             ShapeString({M, K, N}));
+    c.node_def = MakeNodeDef("_ITEXDynamicQuantizedMatMul", c.name);
+    AddNodeAttr("T", DT_FLOAT, &c.node_def);
+    AddNodeAttr("transpose_b", false, &c.node_def);
+    AddNodeAttr("is_weight_const", true, &c.node_def);
+    AddNodeAttr("fused_ops", gtl::ArraySlice<string>{}, &c.node_def);
+    AddNodeAttr("num_args", 0, &c.node_def);
+    c.inputs.push_back(RandomTensor(DT_FLOAT, TensorShape({M, K}), rng));
+    c.inputs.push_back(RandomTensor(DT_QINT8, TensorShape({K, N}), rng));
+    Tensor min_weight(DT_FLOAT, TensorShape({N}));
+    Tensor max_weight(DT_FLOAT, TensorShape({N}));
+    min_weight.flat<float>().setConstant(-1.0f);
+    max_weight.flat<float>().setConstant(1.0f);
+    c.inputs.push_back(std::move(min_weight));
+    c.inputs.push_back(std::move(max_weight));
+    c.output_types = {DT_FLOAT};
+    c.flops = 2.0 * M * N * K;
+    c.bytes = static_cast<double>(M * K * sizeof(float) + K * N +
+                                  M * N * sizeof(float));
+    cases->push_back(std::move(c));
+  }
+}
+
+Status RunCase(const BenchmarkCase& c, float min_time,
+               KernelBenchmarkEntry* entry) {
+  std::unique_ptr<KernelHarness> harness;
+  TF_RETURN_IF_ERROR(
+      KernelHarness::Create(c.node_def, c.inputs, c.output_types, &harness));
+  for (int i = 0; i < kWarmupRuns; ++i) TF_RETURN_IF_ERROR(harness->Run());
+
+  std::vector<double> usecs;
+  const uint64 start = EnvTime::NowNanos();
+  const uint64 min_nanos = static_cast<uint64>(min_time * 1e9);
+  while (usecs.size() < kMinRuns ||
+         (EnvTime::NowNanos() - start < min_nanos &&
+          usecs.size() < kMaxRuns)) {
+    const uint64 run_start = EnvTime::NowNanos();
+    TF_RETURN_IF_ERROR(harness->Run());
+    usecs.push_back((EnvTime::NowNanos() - run_start) / 1e3);
+  }
+  std::sort(usecs.begin(), usecs.end());
+  const double median = usecs[usecs.size() / 2];
+
+  entry->set_name(c.name);
+  entry->set_op(c.node_def.op());
+  entry->set_dtype(c.dtype);
+  entry->set_iterations(usecs.size());
+  entry->set_median_usecs(median);
+  entry->set_min_usecs(usecs.front());
+  entry->set_gflops(c.flops / (median * 1e3));
+  entry->set_gbytes_per_sec(c.bytes / (median * 1e3));
+  return Status::OK();
+}
+
+double Rate(const KernelBenchmarkEntry& entry, bool compute_bound) {
+  return compute_bound ? entry.gflops() : entry.gbytes_per_sec();
+}
+
+// Returns the number of kernels that got slower than "baseline" by more than
+// "tolerance".
+int CompareWithBaseline(const KernelBenchmarkResults& results,
+                        const KernelBenchmarkResults& baseline,
+                        float tolerance) {
+  const std::map<std::string, std::string> context(
+      results.context().begin(), results.context().end());
+  if (context != std::map<std::string, std::string>(
+                     baseline.context().begin(), baseline.context().end())) {
+    std::fprintf(stderr,
+                 "Warning: the baseline was measured on another machine or "
+                 "configuration, results may not be comparable.\n");
+  }
+  std::map<std::string, const KernelBenchmarkEntry*> baseline_entries;
+  for (const auto& entry : baseline.entries()) {
+    baseline_entries[entry.name()] = &entry;
+  }
+  int regressions = 0;
+  for (const auto& entry : results.entries()) {
+    auto it = baseline_entries.find(entry.name());
+    if (it == baseline_entries.end()) {
+      std::printf("%-56s not in baseline\n", entry.name().c_str());
+      continue;
+    }
+    const bool compute_bound = it->second->gflops() > 0;
+    const double base = Rate(*it->second, compute_bound);
+    const double ratio = base > 0 ? Rate(entry, compute_bound) / base : 1.0;
+    const bool regressed = ratio < 1.0 - tolerance;
+    regressions += regressed;
+    std::printf("%-56s %8.2f %s vs %8.2f baseline (%+.1f%%)%s\n",
+                entry.name().c_str(), Rate(entry, compute_bound),
+                compute_bound ? "GFLOP/s" : "GB/s   ", base,
+                (ratio - 1.0) * 100, regressed ? "  REGRESSION" : "");
+  }
+  return regressions;
+}
+
+void FillContext(KernelBenchmarkResults* results) {
+  auto& context = *results->mutable_context();
+  context["cpu"] = strings::StrCat(port::CPUVendorIDString(), " family ",
+                                   port::CPUFamily(), " model ",
+                                   port::CPUModelNum());
+  context["num_schedulable_cpus"] =
+      strings::StrCat(port::NumSchedulableCPUs());
+  context["avx512_bf16"] =
+      port::TestCPUFeature(port::AVX512_BF16) ? "true" : "false";
+  context["amx_bf16"] = port::TestCPUFeature(port::AMX_BF16) ? "true" : "false";
+  const char* omp_threads = getenv("OMP_NUM_THREADS");
+  context["omp_num_threads"] = omp_threads == nullptr ? "" : omp_threads;
+}
+
+int Main(int argc, char** argv) {
+  std::string filter;
+  std::string dtypes = "float,bfloat16,int8";
+  float min_time = 0.5;
+  std::string output;
+  std::string baseline_path;
+  float tolerance = 0.1;
+  bool update_baseline = false;
+  std::vector<Flag> flag_list = {
+      Flag("filter", &filter, "Only run kernels whose name contains this."),
+      Flag("dtypes", &dtypes, "Comma separated dtypes to sweep."),
+      Flag("min_time", &min_time, "Minimum seconds to run each kernel."),
+      Flag("output", &output, "File to write the results to as JSON."),
+      Flag("baseline", &baseline_path, "JSON results to compare against."),
+      Flag("tolerance", &tolerance,
+           "Relative slowdown against the baseline that is a regression."),
+      Flag("update_baseline", &update_baseline,
+           "Write the results to --baseline instead of comparing."),
+  };
+  const std::string usage = Flags::Usage(argv[0], flag_list);
+  if (!Flags::Parse(&argc, argv, flag_list) || argc != 1) {
+    std::fprintf(stderr, "%s", usage.c_str());
+    return 2;
+  }
+
+  std::mt19937 rng(301);
+  std::vector<BenchmarkCase> cases;
+  for (absl::string_view dtype : absl::StrSplit(dtypes, ',')) {
+    if (dtype == "float" || dtype == "bfloat16") {
+      const DataType type = dtype == "float" ? DT_FLOAT : DT_BFLOAT16;
+      AddMatMulCases(type, &rng, &cases);
+      AddConv2DCases(type, &rng, &cases);
+      AddMemoryBoundCases(type, &rng, &cases);
+    } else if (dtype == "int8") {
+      AddInt8MatMulCases(&rng, &cases);
+    } else {
+      std::fprintf(stderr, "Unknown dtype %s\n", std::string(dtype).c_str());
+      return 2;
+    }
+  }
+
+  KernelBenchmarkResults results;
+  FillContext(&results);
+  int failures = 0;
+  for (const BenchmarkCase& c : cases) {
+    if (!absl::StrContains(c.name, filter)) continue;
+    KernelBenchmarkEntry entry;
+    Status s = RunCase(c, min_time, &entry);
+    if (!s.ok()) {
+      std::fprintf(stderr, "%s failed: %s\n", c.name.c_str(),
+                   s.ToString().c_str());
+      ++failures;
+      continue;
+    }
+    std::printf("%-56s %10.1f us %10.2f GFLOP/s %8.2f GB/s\n",
+                entry.name().c_str(), entry.median_usecs(), entry.gflops(),
+                entry.gbytes_per_sec());
+    *results.add_entries() = entry;
+  }
+
+  std::string json;
+  ITEX_CHECK_OK(ProtoToHumanReadableJson(results, &json,
+                                         /*ignore_accuracy_loss=*/true));
+  if (!output.empty()) {
+    ITEX_CHECK_OK(WriteStringToFile(Env::Default(), output, json));
+  }
+  if (baseline_path.empty()) return failures > 0 ? 1 : 0;
+
+  if (update_baseline) {
+    ITEX_CHECK_OK(WriteStringToFile(Env::Default(), baseline_path, json));
+    std::printf("Wrote baseline %s\n", baseline_path.c_str());
+    return failures > 0 ? 1 : 0;
+  }
+  std::string baseline_json;
+  KernelBenchmarkResults baseline;
+  ITEX_CHECK_OK(ReadFileToString(Env::Default(), baseline_path,
+                                 &baseline_json));
+  ITEX_CHECK_OK(HumanReadableJsonToProto(baseline_json, &baseline));
+  const int regressions = CompareWithBaseline(results, baseline, tolerance);
+  if (regressions > 0) {
+    std::printf("%d kernels regressed by more than %.0f%%\n", regressions,
+                tolerance * 100);
+  }
+  return regressions > 0 || failures > 0 ? 1 : 0;
+}
+
+}  // namespace
+}  // namespace itex
+
+int main(int argc, char** argv) { return itex::Main(argc, argv); }
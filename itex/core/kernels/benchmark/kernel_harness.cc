@@ -0,0 +1,548 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "itex/core/kernels/benchmark/kernel_harness.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>  // NOLINT(build/c++11)
+#include <string>
+#include <utility>
+
+#include "absl/types/optional.h"
+#include "itex/core/utils/errors.h"
+#include "itex/core/utils/logging.h"
+#include "itex/core/utils/onednn/onednn_layout_util.h"
+#include "itex/core/utils/op_kernel.h"
+#include "itex/core/utils/status.h"
+#include "protos/attr_value.pb.h"
+
+// The C API structs the kernels get handles of. TensorFlow only declares
+// them, so the harness is free to define them.
+
+struct TF_KernelBuilder {
+  std::string op_name;
+  std::string device_name;
+  void* (*create_func)(TF_OpKernelConstruction*);
+  void (*compute_func)(void*, TF_OpKernelContext*);
+  void (*delete_func)(void*);
+  std::vector<std::pair<std::string, TF_DataType>> type_constraints;
+  int32_t priority = 0;
+};
+
+struct TF_OpKernelConstruction {
+  const itex::NodeDef* node_def;
+  TF_Status* status;
+};
+
+struct TF_OpKernelContext {
+  std::vector<itex::Tensor> inputs;
+  std::vector<itex::DataType> output_types;
+  std::vector<absl::optional<itex::Tensor>> outputs;
+  int64_t step_id = 0;
+  TF_Status* status;
+};
+
+namespace itex {
+
+namespace {
+
+std::vector<std::unique_ptr<TF_KernelBuilder>>* RegisteredKernels() {
+  static auto* kernels = new std::vector<std::unique_ptr<TF_KernelBuilder>>;
+  return kernels;
+}
+
+void RegisterKernelsOnce() {
+  static std::once_flag once;
+  std::call_once(once, [] { register_kernel::RegisterCPUKernels(DEVICE_CPU); });
+}
+
+// Returns the registered kernel for node_def with the highest priority.
+const TF_KernelBuilder* FindKernel(const NodeDef& node_def) {
+  const TF_KernelBuilder* found = nullptr;
+  for (const auto& kernel : *RegisteredKernels()) {
+    if (kernel->op_name != node_def.op()) continue;
+    const bool matches = std::all_of(
+        kernel->type_constraints.begin(), kernel->type_constraints.end(),
+        [&node_def](const std::pair<std::string, TF_DataType>& constraint) {
+          auto it = node_def.attr().find(constraint.first);
+          return it != node_def.attr().end() &&
+                 it->second.type() ==
+                     static_cast<DataType>(constraint.second);
+        });
+    if (matches && (found == nullptr || kernel->priority > found->priority)) {
+      found = kernel.get();
+    }
+  }
+  return found;
+}
+
+// Returns a new handle to the buffer of "tensor", which the caller owns like
+// the handles TensorFlow returns.
+TF_Tensor* ShareTensor(const TF_Tensor* tensor, TF_Status* status) {
+  const TF_DataType dtype = TF_TensorType(tensor);
+  const int64_t one[1] = {1};
+  TF_Tensor* shared = TF_AllocateTensor(dtype, one, 1, TF_DataTypeSize(dtype));
+  std::vector<int64_t> dims(TF_NumDims(tensor));
+  for (size_t i = 0; i < dims.size(); ++i) dims[i] = TF_Dim(tensor, i);
+  TF_TensorBitcastFrom(tensor, dtype, shared, dims.data(),
+                       static_cast<int>(dims.size()), status);
+  return shared;
+}
+
+TensorShape MakeShape(const int64_t* dims, int num_dims) {
+  TensorShape shape;
+  for (int i = 0; i < num_dims; ++i) shape.AddDim(dims[i]);
+  return shape;
+}
+
+void SetStatus(TF_Status* status, const Status& s) {
+  TF_StatusFromStatus(s, status);
+}
+
+// Returns the attr, or nullptr after setting "status" if it is missing or not
+// of kind "value_case".
+const AttrValue* GetAttr(TF_OpKernelConstruction* ctx, const char* attr_name,
+                         AttrValue::ValueCase value_case, TF_Status* status) {
+  auto it = ctx->node_def->attr().find(attr_name);
+  if (it == ctx->node_def->attr().end()) {
+    SetStatus(status, errors::InvalidArgument("Operation '",
+                                              ctx->node_def->name(),
+                                              "' has no attr named '",
+                                              attr_name, "'."));
+    return nullptr;
+  }
+  if (it->second.value_case() != value_case) {
+    SetStatus(status, errors::InvalidArgument("Attr '", attr_name,
+                                              "' has an unexpected type"));
+    return nullptr;
+  }
+  TF_SetStatus(status, TF_OK, "");
+  return &it->second;
+}
+
+template <typename T, typename List>
+void CopyList(const List& list, T* vals, int max_vals) {
+  const int n = std::min(max_vals, static_cast<int>(list.size()));
+  for (int i = 0; i < n; ++i) vals[i] = static_cast<T>(list.Get(i));
+}
+
+}  // namespace
+
+struct KernelHarness::Context {
+  NodeDef node_def;
+  const TF_KernelBuilder* kernel_builder = nullptr;
+  void* kernel = nullptr;
+  TF_OpKernelContext ctx;
+};
+
+KernelHarness::KernelHarness() : context_(new Context) {
+  context_->ctx.status = TF_NewStatus();
+}
+
+KernelHarness::~KernelHarness() {
+  if (context_->kernel != nullptr) {
+    context_->kernel_builder->delete_func(context_->kernel);
+  }
+  TF_DeleteStatus(context_->ctx.status);
+}
+
+/* static */ Status KernelHarness::Create(
+    const NodeDef& node_def, std::vector<Tensor> inputs,
+    std::vector<DataType> output_types,
+    std::unique_ptr<KernelHarness>* harness) {
+  RegisterKernelsOnce();
+  // The C API functions of this file are all in one object, so either all of
+  // them or none of them took precedence over the TensorFlow ones.
+  if (RegisteredKernels()->empty()) {
+    return errors::FailedPrecondition(
+        "No kernel registration reached the harness: the kernel C API of the "
+        "TensorFlow library took precedence over the one of kernel_harness. "
+        "Link kernel_harness into the executable, not into a shared library.");
+  }
+  const TF_KernelBuilder* kernel_builder = FindKernel(node_def);
+  if (kernel_builder == nullptr) {
+    return errors::NotFound("No CPU kernel registered for ", node_def.op(),
+                            " with the type attrs of ", node_def.name());
+  }
+
+  std::unique_ptr<KernelHarness> result(new KernelHarness);
+  Context* context = result->context_.get();
+  context->node_def = node_def;
+  context->kernel_builder = kernel_builder;
+  context->ctx.inputs = std::move(inputs);
+  context->ctx.output_types = std::move(output_types);
+  context->ctx.outputs.resize(context->ctx.output_types.size());
+
+  TF_OpKernelConstruction construction{&context->node_def,
+                                       context->ctx.status};
+  void* kernel = kernel_builder->create_func(&construction);
+  Status s = StatusFromTF_Status(context->ctx.status);
+  if (!s.ok()) {
+    kernel_builder->delete_func(kernel);
+    return s;
+  }
+  context->kernel = kernel;
+  *harness = std::move(result);
+  return Status::OK();
+}
+
+Status KernelHarness::Run() {
+  TF_OpKernelContext* ctx = &context_->ctx;
+  for (auto& output : ctx->outputs) output.reset();
+  TF_SetStatus(ctx->status, TF_OK, "");
+  ++ctx->step_id;
+  context_->kernel_builder->compute_func(context_->kernel, ctx);
+  return StatusFromTF_Status(ctx->status);
+}
+
+int KernelHarness::num_outputs() const {
+  return context_->ctx.outputs.size();
+}
+
+const Tensor& KernelHarness::output(int index) const {
+  ITEX_CHECK(context_->ctx.outputs[index].has_value())
+      << "Output " << index << " of " << context_->node_def.name()
+      << " was not produced";
+  return *context_->ctx.outputs[index];
+}
+
+void AppendPlainLayoutMetaData(std::vector<Tensor>* inputs,
+                               std::vector<DataType>* output_types) {
+  OneDnnShape plain_shape;
+  plain_shape.SetOneDnnTensor(false);
+  TensorShape meta_shape;
+  meta_shape.AddDim(plain_shape.GetSerializeBufferSize());
+  const size_t num_data_inputs = inputs->size();
+  for (size_t i = 0; i < num_data_inputs; ++i) {
+    Tensor meta(DT_UINT8, meta_shape);
+    plain_shape.SerializeOneDnnShape(meta.flat<uint8>().data(),
+                                     meta.flat<uint8>().size());
+    inputs->push_back(std::move(meta));
+  }
+  output_types->resize(output_types->size() * 2, DT_UINT8);
+}
+
+}  // namespace itex
+
+// Kernel C API -------------------------------------------------------------
+
+extern "C" {
+
+TF_KernelBuilder* TF_NewKernelBuilder(
+    const char* op_name, const char* device_name,
+    void* (*create_func)(TF_OpKernelConstruction*),
+    void (*compute_func)(void*, TF_OpKernelContext*),
+    void (*delete_func)(void*)) {
+  TF_KernelBuilder* builder = new TF_KernelBuilder;
+  builder->op_name = op_name;
+  builder->device_name = device_name;
+  builder->create_func = create_func;
+  builder->compute_func = compute_func;
+  builder->delete_func = delete_func;
+  return builder;
+}
+
+void TF_KernelBuilder_TypeConstraint(TF_KernelBuilder* kernel_builder,
+                                     const char* attr_name,
+                                     const TF_DataType type,
+                                     TF_Status* status) {
+  kernel_builder->type_constraints.emplace_back(attr_name, type);
+  TF_SetStatus(status, TF_OK, "");
+}
+
+void TF_KernelBuilder_HostMemory(TF_KernelBuilder* kernel_builder,
+                                 const char* arg_name) {}
+
+void TF_KernelBuilder_Priority(TF_KernelBuilder* kernel_builder,
+                               int32_t priority_number) {
+  kernel_builder->priority = priority_number;
+}
+
+void TF_RegisterKernelBuilder(const char* kernel_name,
+                              TF_KernelBuilder* builder, TF_Status* status) {
+  itex::RegisteredKernels()->emplace_back(builder);
+  TF_SetStatus(status, TF_OK, "");
+}
+
+void TF_DeleteKernelBuilder(TF_KernelBuilder* builder) { delete builder; }
+
+// TF_OpKernelConstruction.
+
+TF_StringView TF_OpKernelConstruction_GetName(TF_OpKernelConstruction* ctx) {
+  const std::string& name = ctx->node_def->name();
+  return TF_StringView{name.data(), name.size()};
+}
+
+bool TF_OpKernelConstruction_HasAttr(TF_OpKernelConstruction* ctx,
+                                     const char* attr_name,
+                                     TF_Status* status) {
+  TF_SetStatus(status, TF_OK, "");
+  return ctx->node_def->attr().count(attr_name) > 0;
+}
+
+void TF_OpKernelConstruction_GetAttrSize(TF_OpKernelConstruction* ctx,
+                                         const char* attr_name,
+                                         int32_t* list_size,
+                                         int32_t* total_size,
+                                         TF_Status* status) {
+  auto it = ctx->node_def->attr().find(attr_name);
+  if (it == ctx->node_def->attr().end()) {
+    itex::SetStatus(status, itex::errors::InvalidArgument(
+                                "Operation '", ctx->node_def->name(),
+                                "' has no attr named '", attr_name, "'."));
+    return;
+  }
+  TF_SetStatus(status, TF_OK, "");
+  const itex::AttrValue& attr = it->second;
+  *list_size = -1;
+  *total_size = -1;
+  if (attr.value_case() == itex::AttrValue::kList) {
+    const itex::AttrValue::ListValue& list = attr.list();
+    *list_size = std::max({list.s_size(), list.i_size(), list.f_size(),
+                           list.b_size(), list.type_size(),
+                           list.shape_size()});
+    // ITEX reads string lists, and empty lists of any type, as one buffer.
+    if (list.s_size() > 0 || *list_size == 0) {
+      *total_size = 0;
+      for (const std::string& s : list.s()) *total_size += s.size();
+    }
+  } else if (attr.value_case() == itex::AttrValue::kS) {
+    *total_size = attr.s().size();
+  } else if (attr.value_case() == itex::AttrValue::kShape) {
+    *total_size = attr.shape().unknown_rank() ? -1 : attr.shape().dim_size();
+  }
+}
+
+void TF_OpKernelConstruction_GetAttrType(TF_OpKernelConstruction* ctx,
+                                         const char* attr_name,
+                                         TF_DataType* val, TF_Status* status) {
+  const itex::AttrValue* attr =
+      itex::GetAttr(ctx, attr_name, itex::AttrValue::kType, status);
+  if (attr != nullptr) *val = static_cast<TF_DataType>(attr->type());
+}
+
+void TF_OpKernelConstruction_GetAttrInt32(TF_OpKernelConstruction* ctx,
+                                          const char* attr_name, int32_t* val,
+                                          TF_Status* status) {
+  const itex::AttrValue* attr =
+      itex::GetAttr(ctx, attr_name, itex::AttrValue::kI, status);
+  if (attr != nullptr) *val = static_cast<int32_t>(attr->i());
+}
+
+void TF_OpKernelConstruction_GetAttrInt64(TF_OpKernelConstruction* ctx,
+                                          const char* attr_name, int64_t* val,
+                                          TF_Status* status) {
+  const itex::AttrValue* attr =
+      itex::GetAttr(ctx, attr_name, itex::AttrValue::kI, status);
+  if (attr != nullptr) *val = attr->i();
+}
+
+void TF_OpKernelConstruction_GetAttrFloat(TF_OpKernelConstruction* ctx,
+                                          const char* attr_name, float* val,
+                                          TF_Status* status) {
+  const itex::AttrValue* attr =
+      itex::GetAttr(ctx, attr_name, itex::AttrValue::kF, status);
+  if (attr != nullptr) *val = attr->f();
+}
+
+void TF_OpKernelConstruction_GetAttrBool(TF_OpKernelConstruction* ctx,
+                                         const char* attr_name, TF_Bool* val,
+                                         TF_Status* status) {
+  const itex::AttrValue* attr =
+      itex::GetAttr(ctx, attr_name, itex::AttrValue::kB, status);
+  if (attr != nullptr) *val = attr->b();
+}
+
+void TF_OpKernelConstruction_GetAttrString(TF_OpKernelConstruction* ctx,
+                                           const char* attr_name, char* val,
+                                           size_t max_length,
+                                           TF_Status* status) {
+  const itex::AttrValue* attr =
+      itex::GetAttr(ctx, attr_name, itex::AttrValue::kS, status);
+  if (attr != nullptr) {
+    std::memcpy(val, attr->s().data(), std::min(max_length, attr->s().size()));
+  }
+}
+
+void TF_OpKernelConstruction_GetAttrTypeList(TF_OpKernelConstruction* ctx,
+                                             const char* attr_name,
+                                             TF_DataType* vals, int max_vals,
+                                             TF_Status* status) {
+  const itex::AttrValue* attr =
+      itex::GetAttr(ctx, attr_name, itex::AttrValue::kList, status);
+  if (attr != nullptr) itex::CopyList(attr->list().type(), vals, max_vals);
+}
+
+void TF_OpKernelConstruction_GetAttrInt32List(TF_OpKernelConstruction* ctx,
+                                              const char* attr_name,
+                                              int32_t* vals, int max_vals,
+                                              TF_Status* status) {
+  const itex::AttrValue* attr =
+      itex::GetAttr(ctx, attr_name, itex::AttrValue::kList, status);
+  if (attr != nullptr) itex::CopyList(attr->list().i(), vals, max_vals);
+}
+
+void TF_OpKernelConstruction_GetAttrInt64List(TF_OpKernelConstruction* ctx,
+                                              const char* attr_name,
+                                              int64_t* vals, int max_vals,
+                                              TF_Status* status) {
+  const itex::AttrValue* attr =
+      itex::GetAttr(ctx, attr_name, itex::AttrValue::kList, status);
+  if (attr != nullptr) itex::CopyList(attr->list().i(), vals, max_vals);
+}
+
+void TF_OpKernelConstruction_GetAttrFloatList(TF_OpKernelConstruction* ctx,
+                                              const char* attr_name,
+                                              float* vals, int max_vals,
+                                              TF_Status* status) {
+  const itex::AttrValue* attr =
+      itex::GetAttr(ctx, attr_name, itex::AttrValue::kList, status);
+  if (attr != nullptr) itex::CopyList(attr->list().f(), vals, max_vals);
+}
+
+void TF_OpKernelConstruction_GetAttrBoolList(TF_OpKernelConstruction* ctx,
+                                             const char* attr_name,
+                                             TF_Bool* vals, int max_vals,
+                                             TF_Status* status) {
+  const itex::AttrValue* attr =
+      itex::GetAttr(ctx, attr_name, itex::AttrValue::kList, status);
+  if (attr != nullptr) itex::CopyList(attr->list().b(), vals, max_vals);
+}
+
+void TF_OpKernelConstruction_GetAttrStringList(
+    TF_OpKernelConstruction* ctx, const char* attr_name, char** vals,
+    size_t* lengths, int max_values, void* storage, size_t storage_size,
+    TF_Status* status) {
+  const itex::AttrValue* attr =
+      itex::GetAttr(ctx, attr_name, itex::AttrValue::kList, status);
+  if (attr == nullptr) return;
+  char* dst = static_cast<char*>(storage);
+  const int n = std::min(max_values, attr->list().s_size());
+  for (int i = 0; i < n; ++i) {
+    const std::string& s = attr->list().s(i);
+    if (s.size() > storage_size) {
+      itex::SetStatus(status, itex::errors::InvalidArgument(
+                                  "Not enough storage for attr ", attr_name));
+      return;
+    }
+    std::memcpy(dst, s.data(), s.size());
+    vals[i] = dst;
+    lengths[i] = s.size();
+    dst += s.size();
+    storage_size -= s.size();
+  }
+}
+
+void TF_OpKernelConstruction_GetAttrTensorShape(TF_OpKernelConstruction* ctx,
+                                                const char* attr_name,
+                                                int64_t* dims, size_t num_dims,
+                                                TF_Status* status) {
+  const itex::AttrValue* attr =
+      itex::GetAttr(ctx, attr_name, itex::AttrValue::kShape, status);
+  if (attr == nullptr) return;
+  const size_t n = std::min<size_t>(num_dims, attr->shape().dim_size());
+  for (size_t i = 0; i < n; ++i) dims[i] = attr->shape().dim(i).size();
+}
+
+void TF_OpKernelConstruction_Failure(TF_OpKernelConstruction* ctx,
+                                     TF_Status* status) {
+  if (status != ctx->status) {
+    TF_SetStatus(ctx->status, TF_GetCode(status), TF_Message(status));
+  }
+}
+
+// TF_OpKernelContext.
+
+int TF_NumInputs(TF_OpKernelContext* ctx) { return ctx->inputs.size(); }
+
+int TF_NumOutputs(TF_OpKernelContext* ctx) { return ctx->outputs.size(); }
+
+void TF_GetInput(TF_OpKernelContext* ctx, int i, TF_Tensor** tensor,
+                 TF_Status* status) {
+  if (i < 0 || i >= static_cast<int>(ctx->inputs.size())) {
+    itex::SetStatus(status, itex::errors::OutOfRange("Input index ", i,
+                                                     " is out of range"));
+    return;
+  }
+  *tensor = itex::ShareTensor(ctx->inputs[i].GetTFTensor(), status);
+}
+
+void TF_GetInputByName(TF_OpKernelContext* ctx, const char* inputName,
+                       TF_Tensor** tensor, TF_Status* status) {
+  itex::SetStatus(status, itex::errors::Unimplemented(
+                              "Inputs by name are not supported: ", inputName));
+}
+
+bool TF_IsRefInput(TF_OpKernelContext* ctx, int i, TF_Status* status) {
+  TF_SetStatus(status, TF_OK, "");
+  return false;
+}
+
+TF_DataType TF_ExpectedOutputDataType(TF_OpKernelContext* ctx, int i) {
+  return static_cast<TF_DataType>(ctx->output_types[i]);
+}
+
+int64_t TF_StepId(TF_OpKernelContext* ctx) { return ctx->step_id; }
+
+void TF_SetOutput(TF_OpKernelContext* ctx, int i, const TF_Tensor* tensor,
+                  TF_Status* status) {
+  if (i < 0 || i >= static_cast<int>(ctx->outputs.size())) {
+    itex::SetStatus(status, itex::errors::OutOfRange("Output index ", i,
+                                                     " is out of range"));
+    return;
+  }
+  ctx->outputs[i].emplace(itex::ShareTensor(tensor, status));
+}
+
+TF_Tensor* TF_AllocateOutput(TF_OpKernelContext* context, int index,
+                             TF_DataType dtype, const int64_t* dims,
+                             int num_dims, size_t len, TF_Status* status) {
+  itex::Tensor& output = context->outputs[index].emplace(
+      static_cast<itex::DataType>(dtype), itex::MakeShape(dims, num_dims));
+  TF_SetStatus(status, TF_OK, "");
+  return itex::ShareTensor(output.GetTFTensor(), status);
+}
+
+// Inputs are never forwarded, so that every run sees the same inputs.
+TF_Tensor* TF_ForwardInputOrAllocateOutput(
+    TF_OpKernelContext* context, const int* candidate_input_indices,
+    int num_candidate_input_indices, int output_index,
+    const int64_t* output_dims, int output_num_dims, int* forwarded_input,
+    TF_Status* status) {
+  if (forwarded_input != nullptr) *forwarded_input = -1;
+  const itex::DataType dtype = context->output_types[output_index];
+  return TF_AllocateOutput(context, output_index,
+                           static_cast<TF_DataType>(dtype), output_dims,
+                           output_num_dims, 0, status);
+}
+
+TF_Tensor* TF_AllocateTemp(TF_OpKernelContext* context, TF_DataType dtype,
+                           const int64_t* dims, int num_dims,
+                           TF_AllocatorAttributes* alloc_attrs,
+                           TF_Status* status) {
+  size_t len = TF_DataTypeSize(dtype);
+  for (int i = 0; i < num_dims; ++i) len *= dims[i];
+  TF_SetStatus(status, TF_OK, "");
+  return TF_AllocateTensor(dtype, dims, num_dims, len);
+}
+
+void TF_OpKernelContext_Failure(TF_OpKernelContext* ctx, TF_Status* status) {
+  if (status != ctx->status) {
+    TF_SetStatus(ctx->status, TF_GetCode(status), TF_Message(status));
+  }
+}
+
+}  // extern "C"
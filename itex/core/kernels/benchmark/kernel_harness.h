@@ -0,0 +1,88 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef ITEX_CORE_KERNELS_BENCHMARK_KERNEL_HARNESS_H_
+#define ITEX_CORE_KERNELS_BENCHMARK_KERNEL_HARNESS_H_
+
+#include <memory>
+#include <vector>
+
+#include "itex/core/utils/macros.h"
+#include "itex/core/utils/plugin_tensor.h"
+#include "itex/core/utils/status.h"
+#include "itex/core/utils/types.h"
+#include "protos/node_def.pb.h"
+#include "tensorflow/c/kernels.h"
+
+namespace itex {
+
+// Runs one ITEX CPU kernel without the TensorFlow runtime.
+//
+// The harness implements the part of the TensorFlow kernel C API the ITEX
+// kernels call, i.e. kernel registration, TF_OpKernelConstruction and
+// TF_OpKernelContext, on top of plain structs. Its definitions take
+// precedence over the ones of the TensorFlow library the binary links for
+// TF_Tensor and TF_Status, so REGISTER_KERNEL_BUILDER kernels are created
+// from a NodeDef and computed in a loop with nothing but the kernel itself
+// on the path: no executor, no graph, no Python.
+//
+// This relies on symbol interposition: the kernels reach the kernel C API
+// through the dynamic linker, which binds them to the first definition in
+// the lookup order. The harness therefore has to be linked into the
+// executable itself, with alwayslink, and never into a shared library loaded
+// after the TensorFlow one, or the kernels would register with TensorFlow and
+// get TensorFlow's TF_OpKernelContext. Create() fails with
+// FailedPrecondition when the registrations did not reach the harness.
+//
+// Inputs are never forwarded to outputs, so a kernel sees the same inputs in
+// every run. Ref and resource inputs are not supported.
+class KernelHarness {
+ public:
+  // Creates the CPU kernel registered for node_def.op() whose type
+  // constraints match the attrs of node_def. Attrs are not defaulted from the
+  // op definition, so node_def has to set every attr the kernel reads.
+  static Status Create(const NodeDef& node_def, std::vector<Tensor> inputs,
+                       std::vector<DataType> output_types,
+                       std::unique_ptr<KernelHarness>* harness);
+
+  ~KernelHarness();
+
+  // Computes the kernel once. The outputs of the previous run are released
+  // first.
+  Status Run();
+
+  int num_outputs() const;
+  // REQUIRES: the last Run() succeeded.
+  const Tensor& output(int index) const;
+
+ private:
+  struct Context;
+
+  KernelHarness();
+
+  std::unique_ptr<Context> context_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(KernelHarness);
+};
+
+// Appends the meta tensors of the oneDNN block layout ops (_OneDnn*) to the
+// inputs and output types: one meta input per data input, marking it as a
+// plain TensorFlow tensor, and one meta output per data output.
+void AppendPlainLayoutMetaData(std::vector<Tensor>* inputs,
+                               std::vector<DataType>* output_types);
+
+}  // namespace itex
+
+#endif  // ITEX_CORE_KERNELS_BENCHMARK_KERNEL_HARNESS_H_
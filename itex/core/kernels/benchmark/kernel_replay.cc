@@ -0,0 +1,322 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Replays a node captured from a live model with ITEX_REPLAY_CAPTURE, see
+// itex/core/utils/replay_capture.h, by creating its ITEX CPU kernel through
+// KernelHarness and computing it in a loop, without TensorFlow running the
+// model or a GPU.
+//
+// Usage: kernel_replay --capture=/tmp/itex_replay_<node>_<pid>.pb
+//                      [--iterations=100] [--warmup=3] [--seed=-1]
+//                      [--apply_env=true]
+//
+// The environment variables of the capture, e.g. ITEX_CACHE_ONEDNN_OBJECT or
+// OMP_NUM_THREADS, are set before the kernel is created, except the ones
+// already set for the replay, so the kernel runs in the configuration of the
+// capture unless overridden on the command line. Inputs captured without
+// their data are filled from the seed of the capture, the same in every
+// replay.
+//
+// The first run, which creates the oneDNN primitives and fills the weight
+// caches, is reported apart from the latency distribution of the steady
+// state. A traced run then lists the oneDNN primitives the kernel executes
+// with their implementation, e.g. brg:avx512_core_amx, followed by the kernel
+// metrics of the primitive creations, reorders and caches.
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/match.h"
+#include "absl/strings/str_split.h"
+#include "itex/core/kernels/benchmark/kernel_harness.h"
+#include "itex/core/utils/command_line_flags.h"
+#include "itex/core/utils/env.h"
+#include "itex/core/utils/env_time.h"
+#include "itex/core/utils/errors.h"
+#include "itex/core/utils/kernel_metrics.h"
+#include "itex/core/utils/replay_capture.h"
+#include "itex/core/utils/traceme_recorder.h"
+#include "itex/core/utils/types.h"
+#include "protos/graph.pb.h"
+
+namespace itex {
+namespace {
+
+struct Replay {
+  NodeDef node_def;
+  std::vector<Tensor> inputs;
+  std::vector<DataType> output_types;
+};
+
+template <typename T, typename Distribution>
+void Fill(Tensor* tensor, Distribution distribution, std::mt19937* rng) {
+  for (auto& v : tensor->flat<T>()) v = T(distribution(*rng));
+}
+
+Status SeededTensor(const TensorProto& proto, std::mt19937* rng,
+                    Tensor* tensor) {
+  *tensor = Tensor(proto.dtype(), TensorShape(proto.tensor_shape()));
+  std::normal_distribution<float> normal;
+  std::uniform_int_distribution<int> small_int(-8, 8);
+  std::uniform_int_distribution<int> byte(0, 255);
+  switch (proto.dtype()) {
+    case DT_FLOAT:
+      Fill<float>(tensor, normal, rng);
+      break;
+    case DT_DOUBLE:
+      Fill<double>(tensor, normal, rng);
+      break;
+    case DT_BFLOAT16:
+      Fill<Eigen::bfloat16>(tensor, normal, rng);
+      break;
+    case DT_HALF:
+      Fill<Eigen::half>(tensor, normal, rng);
+      break;
+    case DT_INT32:
+      Fill<int32>(tensor, small_int, rng);
+      break;
+    case DT_INT64:
+      Fill<int64>(tensor, small_int, rng);
+      break;
+    case DT_INT8:
+      Fill<int8>(tensor, small_int, rng);
+      break;
+    case DT_UINT8:
+      Fill<uint8>(tensor, byte, rng);
+      break;
+    case DT_QINT8:
+      Fill<qint8>(tensor, small_int, rng);
+      break;
+    case DT_QUINT8:
+      Fill<quint8>(tensor, byte, rng);
+      break;
+    case DT_QINT32:
+      Fill<qint32>(tensor, small_int, rng);
+      break;
+    case DT_BOOL:
+      Fill<bool>(tensor, byte, rng);
+      break;
+    default:
+      return errors::Unimplemented("Cannot seed an input of type ",
+                                   DataTypeString(proto.dtype()));
+  }
+  return Status::OK();
+}
+
+const AttrValue& MetaAttr(const NodeDef& meta, const std::string& name) {
+  static const AttrValue* empty = new AttrValue();
+  auto it = meta.attr().find(name);
+  return it == meta.attr().end() ? *empty : it->second;
+}
+
+// Prints the environment variables of the capture, and sets the ones that
+// are not set yet if "apply" is true.
+void ApplyEnv(const NodeDef& meta, bool apply) {
+  std::printf("Environment of the capture:\n");
+  for (const std::string& entry : MetaAttr(meta, "env").list().s()) {
+    const size_t eq = entry.find('=');
+    if (eq == std::string::npos) continue;
+    const std::string name = entry.substr(0, eq);
+    const char* note = "";
+    if (!apply) {
+      note = "  (not applied)";
+    } else if (getenv(name.c_str()) != nullptr) {
+      note = "  (overridden)";
+    } else {
+      setenv(name.c_str(), entry.substr(eq + 1).c_str(), 0);
+    }
+    std::printf("  %s%s\n", entry.c_str(), note);
+  }
+}
+
+Status LoadReplay(const std::string& path, int64_t seed, bool apply_env,
+                  Replay* replay) {
+  GraphDef graph;
+  TF_RETURN_IF_ERROR(ReadBinaryProto(Env::Default(), path, &graph));
+  std::map<std::string, const NodeDef*> nodes;
+  const NodeDef* node = nullptr;
+  for (const NodeDef& n : graph.node()) {
+    nodes[n.name()] = &n;
+    if (n.name() != replay_capture::kMetaNodeName &&
+        !absl::StartsWith(n.name(), replay_capture::kInputNodePrefix)) {
+      node = &n;
+    }
+  }
+  auto meta_it = nodes.find(replay_capture::kMetaNodeName);
+  if (node == nullptr || meta_it == nodes.end()) {
+    return errors::InvalidArgument(path, " is not a replay capture");
+  }
+  const NodeDef& meta = *meta_it->second;
+  std::printf("Node %s of op %s, captured at run %s of step %s\n",
+              node->name().c_str(), node->op().c_str(),
+              std::to_string(MetaAttr(meta, "run").i()).c_str(),
+              std::to_string(MetaAttr(meta, "step_id").i()).c_str());
+  ApplyEnv(meta, apply_env);
+
+  std::vector<bool> seeded(node->input_size(), false);
+  for (int64 i : MetaAttr(meta, "seeded_inputs").list().i()) {
+    if (i >= 0 && i < node->input_size()) seeded[i] = true;
+  }
+  std::mt19937 rng(seed >= 0 ? seed : MetaAttr(meta, "seed").i());
+  for (int i = 0; i < node->input_size(); ++i) {
+    auto it = nodes.find(node->input(i));
+    if (it == nodes.end()) {
+      return errors::InvalidArgument("Input ", node->input(i), " of ",
+                                     node->name(), " is not in the capture");
+    }
+    const TensorProto& value = MetaAttr(*it->second, "value").tensor();
+    Tensor tensor;
+    if (seeded[i]) {
+      TF_RETURN_IF_ERROR(SeededTensor(value, &rng, &tensor));
+    } else if (!tensor.FromProto(value)) {
+      return errors::InvalidArgument("Cannot parse input ", i, " of ",
+                                     node->name());
+    }
+    std::printf("Input %d: %s %s%s\n", i,
+                DataTypeString(tensor.dtype()).c_str(),
+                tensor.shape().DebugString().c_str(),
+                seeded[i] ? " (seeded)" : "");
+    replay->inputs.push_back(std::move(tensor));
+  }
+  replay->node_def = *node;
+  replay->node_def.clear_input();
+  for (int type : MetaAttr(meta, "output_types").list().type()) {
+    replay->output_types.push_back(static_cast<DataType>(type));
+  }
+  return Status::OK();
+}
+
+// Returns the oneDNN primitives of one run of "harness", e.g.
+// "onednn::matmul impl=brg:avx512_core,src=128x1024,...", with their count.
+Status TracePrimitives(KernelHarness* harness,
+                       std::map<std::string, int>* primitives) {
+  TraceMeRecorder::Start(/*level=*/2);
+  Status s = harness->Run();
+  TraceMeRecorder::Events events = TraceMeRecorder::Stop();
+  TF_RETURN_IF_ERROR(s);
+  for (const auto& thread : events) {
+    for (const auto& event : thread.events) {
+      if (event.IsEnd() || !absl::StartsWith(event.name, "onednn::")) {
+        continue;
+      }
+      std::string name = event.name;
+      if (!name.empty() && name.back() == '#') name.pop_back();
+      std::replace(name.begin(), name.end(), '#', ' ');
+      ++(*primitives)[name];
+    }
+  }
+  return Status::OK();
+}
+
+void PrintLatencies(std::vector<double> usecs) {
+  std::sort(usecs.begin(), usecs.end());
+  auto percentile = [&usecs](double p) {
+    return usecs[std::min(usecs.size() - 1,
+                          static_cast<size_t>(p * usecs.size()))];
+  };
+  double sum = 0;
+  for (double u : usecs) sum += u;
+  const double mean = sum / usecs.size();
+  double variance = 0;
+  for (double u : usecs) variance += (u - mean) * (u - mean);
+  std::printf(
+      "Steady state over %zu runs, usecs: min %.1f  p50 %.1f  p90 %.1f  "
+      "p99 %.1f  max %.1f  mean %.1f  stddev %.1f\n",
+      usecs.size(), usecs.front(), percentile(0.5), percentile(0.9),
+      percentile(0.99), usecs.back(), mean, std::sqrt(variance / usecs.size()));
+}
+
+int Main(int argc, char** argv) {
+  std::string capture;
+  int32 iterations = 100;
+  int32 warmup = 3;
+  int64_t seed = -1;
+  bool apply_env = true;
+  std::vector<Flag> flag_list = {
+      Flag("capture", &capture, "Capture file written by ITEX_REPLAY_CAPTURE."),
+      Flag("iterations", &iterations, "Timed runs of the kernel."),
+      Flag("warmup", &warmup, "Untimed runs after the first one."),
+      Flag("seed", &seed,
+           "Seed of the inputs captured without data, -1 for the captured."),
+      Flag("apply_env", &apply_env,
+           "Set the environment variables of the capture."),
+  };
+  const std::string usage = Flags::Usage(argv[0], flag_list);
+  if (!Flags::Parse(&argc, argv, flag_list) || argc != 1 || capture.empty() ||
+      iterations <= 0) {
+    std::fprintf(stderr, "%s", usage.c_str());
+    return 2;
+  }
+
+  Replay replay;
+  Status s = LoadReplay(capture, seed, apply_env, &replay);
+  std::unique_ptr<KernelHarness> harness;
+  if (s.ok()) {
+    s = KernelHarness::Create(replay.node_def, std::move(replay.inputs),
+                              replay.output_types, &harness);
+  }
+
+  std::vector<double> usecs;
+  if (s.ok()) {
+    const uint64 start = EnvTime::NowNanos();
+    s = harness->Run();
+    std::printf("First run: %.1f usecs\n", (EnvTime::NowNanos() - start) / 1e3);
+  }
+  for (int i = 0; s.ok() && i < warmup; ++i) s = harness->Run();
+  for (int i = 0; s.ok() && i < iterations; ++i) {
+    const uint64 start = EnvTime::NowNanos();
+    s = harness->Run();
+    usecs.push_back((EnvTime::NowNanos() - start) / 1e3);
+  }
+  std::map<std::string, int> primitives;
+  if (s.ok()) s = TracePrimitives(harness.get(), &primitives);
+  if (!s.ok()) {
+    std::fprintf(stderr, "Replay of %s failed: %s\n", capture.c_str(),
+                 s.ToString().c_str());
+    return 1;
+  }
+
+  PrintLatencies(usecs);
+  std::printf("oneDNN primitives of one run:%s\n",
+              primitives.empty() ? " none" : "");
+  for (const auto& primitive : primitives) {
+    std::printf("  %dx %s\n", primitive.second, primitive.first.c_str());
+  }
+  std::printf("Kernel metrics:\n");
+  for (absl::string_view line :
+       absl::StrSplit(metrics::MetricsText(), '\n', absl::SkipEmpty())) {
+    if (absl::StartsWith(line, "#")) continue;
+    if (absl::StrContains(line, "primitive_creations") ||
+        absl::StrContains(line, "reorders") ||
+        absl::StrContains(line, "cache_lookups")) {
+      std::printf("  %s\n", std::string(line).c_str());
+    }
+  }
+  return 0;
+}
+
+}  // namespace
+}  // namespace itex
+
+int main(int argc, char** argv) { return itex::Main(argc, argv); }
@@ -0,0 +1,107 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Checks OpKernelConstruction::GetAttr<TensorShape> through KernelHarness,
+// which replay_capture relies on to capture the shape attrs of any name.
+
+#include <cstdio>
+#include <memory>
+
+#include "itex/core/kernels/benchmark/kernel_harness.h"
+#include "itex/core/utils/errors.h"
+#include "itex/core/utils/logging.h"
+#include "itex/core/utils/op_kernel.h"
+#include "itex/core/utils/op_requires.h"
+#include "itex/core/utils/plugin_tensor.h"
+#include "itex/core/utils/types.h"
+#include "protos/node_def.pb.h"
+
+namespace itex {
+namespace {
+
+// Outputs the dims of its "element_shape" attr.
+class ShapeAttrTestOp : public OpKernel {
+ public:
+  explicit ShapeAttrTestOp(OpKernelConstruction* context) : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("element_shape", &shape_));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    Tensor* output = nullptr;
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(
+                       0, TensorShape({shape_.dims()}), &output));
+    for (int i = 0; i < shape_.dims(); ++i) {
+      output->flat<int64>()(i) = shape_.dim_size(i);
+    }
+  }
+
+ private:
+  TensorShape shape_;
+};
+
+REGISTER_KERNEL_BUILDER(Name("_ITEXShapeAttrTest").Device(DEVICE_CPU),
+                        ShapeAttrTestOp);
+
+Status CreateKernel(const TensorShapeProto& shape,
+                    std::unique_ptr<KernelHarness>* harness) {
+  NodeDef node_def;
+  node_def.set_name("shape_attr_test");
+  node_def.set_op("_ITEXShapeAttrTest");
+  *(*node_def.mutable_attr())["element_shape"].mutable_shape() = shape;
+  return KernelHarness::Create(node_def, {}, {DT_INT64}, harness);
+}
+
+void TestNamedAttr() {
+  // There is no attr named "shape", which GetAttr used to read instead.
+  TensorShapeProto shape;
+  shape.add_dim()->set_size(3);
+  shape.add_dim()->set_size(1);
+  shape.add_dim()->set_size(7);
+  std::unique_ptr<KernelHarness> harness;
+  ITEX_CHECK_OK(CreateKernel(shape, &harness));
+  ITEX_CHECK_OK(harness->Run());
+  const Tensor& dims = harness->output(0);
+  ITEX_CHECK_EQ(dims.NumElements(), 3);
+  ITEX_CHECK_EQ(dims.flat<int64>()(0), 3);
+  ITEX_CHECK_EQ(dims.flat<int64>()(1), 1);
+  ITEX_CHECK_EQ(dims.flat<int64>()(2), 7);
+}
+
+void TestScalar() {
+  std::unique_ptr<KernelHarness> harness;
+  ITEX_CHECK_OK(CreateKernel(TensorShapeProto(), &harness));
+  ITEX_CHECK_OK(harness->Run());
+  ITEX_CHECK_EQ(harness->output(0).NumElements(), 0);
+}
+
+void TestUnknownRank() {
+  TensorShapeProto shape;
+  shape.set_unknown_rank(true);
+  std::unique_ptr<KernelHarness> harness;
+  Status s = CreateKernel(shape, &harness);
+  ITEX_CHECK(errors::IsInvalidArgument(s)) << s;
+}
+
+}  // namespace
+}  // namespace itex
+
+int main(int argc, char** argv) {
+  itex::TestNamedAttr();
+  itex::TestScalar();
+  itex::TestUnknownRank();
+  std::printf("PASSED\n");
+  return 0;
+}
@@ -109,7 +109,8 @@ class AvgPoolGradOp : public PoolingBackwardOpBase<T> {
           dnnl::memory(pooling_bwd_pd.scratchpad_desc(), onednn_engine,
                        GetTensorBuffer<T>(&scratchpad_tensor));
 
-      dnnl::pooling_backward pooling_bwd_primitive(pooling_bwd_pd);
+      dnnl::pooling_backward pooling_bwd_primitive =
+          CreatePrimitive<dnnl::pooling_backward>(pooling_bwd_pd);
 
       Tensor* output_tensor = nullptr;
       this->AllocateOutputTensor(context, &orig_input_shape, &output_tensor);
@@ -133,7 +134,7 @@ class AvgPoolGradOp : public PoolingBackwardOpBase<T> {
            {DNNL_ARG_SCRATCHPAD, scratchpad_mem}});
 
       auto onednn_stream = CreateDnnlStream(*context, onednn_engine);
-      pooling_bwd_primitive.execute(onednn_stream, bwd_net_args);
+      ExecutePrimitive(pooling_bwd_primitive, onednn_stream, bwd_net_args);
     } catch (dnnl::error& e) {
       string error_msg = "Status: " + std::to_string(e.status) +
                          ", message: " + string(e.message) + ", in file " +
@@ -172,7 +172,7 @@ class BatchMatMulOp : public OpKernel {
       // Create matmul forward primitive
       auto fwd_pd =
           GetPrimitiveDesc(ctx, src_md, wei_md_prefer, bias_md, dst_md);
-      matmul_primitive_ = matmul(fwd_pd);
+      matmul_primitive_ = CreatePrimitive<matmul>(fwd_pd);
 
       // Create src memory, check if src needs to be reordered
       src_mem_ = CreateDnnlMemory(src_md, onednn_engine_,
@@ -316,7 +316,7 @@ class BatchMatMulOp : public OpKernel {
 
     // Skip primitive execution if the calculation is meaningless.
     if (!is_input_zero_) {
-      matmul_primitive_.execute(onednn_stream_, fwd_primitive_args_);
+      ExecutePrimitive(matmul_primitive_, onednn_stream_, fwd_primitive_args_);
     }
 
     scratchpad_tensor_.reset();
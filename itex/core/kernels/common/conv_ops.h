@@ -727,7 +727,7 @@ class ConvOpBase : public OpKernel {
       if (!is_filter_const_) {
         filter_mem_input_.set_data_handle(context->tensor_data(kFilterIndex_));
         filter_mem_.set_data_handle(GetTensorBuffer<Tfilter>(&tmp_weight_));
-        weight_reorder_.execute(onednn_stream_, weight_reorder_args_);
+        ExecutePrimitive(weight_reorder_, onednn_stream_, weight_reorder_args_);
       }
     } else {
       filter_mem_.set_data_handle(context->tensor_data(kFilterIndex_));
@@ -778,7 +778,7 @@ class ConvOpBase : public OpKernel {
     }
 
     if (!is_format_reordered_) {
-      fwd_primitive_.execute(onednn_stream_, fwd_primitives_args_);
+      ExecutePrimitive(fwd_primitive_, onednn_stream_, fwd_primitives_args_);
     }
     scratchpad_tensor_.reset();
   }
@@ -986,7 +986,7 @@ class ConvOpBase : public OpKernel {
           dnnl::memory(fwd_pd_.scratchpad_desc(), onednn_engine_,
                        GetTensorBuffer<Tinput>(scratchpad_tensor_.get()));
 
-      fwd_primitive_ = convolution_forward(fwd_pd_);
+      fwd_primitive_ = CreatePrimitive<convolution_forward>(fwd_pd_);
 
       src_mem_ = CreateDnnlMemory(src_md, onednn_engine_,
                                   GetTensorBuffer<Tinput>(&src_tensor));
@@ -1008,8 +1008,8 @@ class ConvOpBase : public OpKernel {
 
         src_reorder_args.insert({DNNL_ARG_SRC, src_mem_});
         src_reorder_args.insert({DNNL_ARG_DST, src_mem_opt_});
-        src_reorder = dnnl::reorder(src_mem_, src_mem_opt_);
-        src_reorder.execute(onednn_stream_, src_reorder_args);
+        src_reorder = CreatePrimitive<dnnl::reorder>(src_mem_, src_mem_opt_);
+        ExecutePrimitive(src_reorder, onednn_stream_, src_reorder_args);
 
         dst_mem_opt_ =
             CreateDnnlMemory(dst_md_opt, onednn_engine_,
@@ -1017,7 +1017,7 @@ class ConvOpBase : public OpKernel {
 
         dst_reorder_args.insert({DNNL_ARG_SRC, dst_mem_opt_});
         dst_reorder_args.insert({DNNL_ARG_DST, dst_mem_});
-        dst_reorder = dnnl::reorder(dst_mem_opt_, dst_mem_);
+        dst_reorder = CreatePrimitive<dnnl::reorder>(dst_mem_opt_, dst_mem_);
       }
 
       // Check filter reorder and do cache if filter is const.
@@ -1054,8 +1054,10 @@ class ConvOpBase : public OpKernel {
           weight_reorder_args_.clear();
           weight_reorder_args_.insert({DNNL_ARG_SRC, filter_mem_input_});
           weight_reorder_args_.insert({DNNL_ARG_DST, filter_mem_});
-          weight_reorder_ = dnnl::reorder(filter_mem_input_, filter_mem_);
-          weight_reorder_.execute(onednn_stream_, weight_reorder_args_);
+          weight_reorder_ =
+              CreatePrimitive<dnnl::reorder>(filter_mem_input_, filter_mem_);
+          ExecutePrimitive(weight_reorder_, onednn_stream_,
+                           weight_reorder_args_);
         }
       } else {
         filter_mem_ = filter_mem_input_;
@@ -1083,8 +1085,8 @@ class ConvOpBase : public OpKernel {
 
       // reorder back if needed
       if (is_format_reordered_) {
-        fwd_primitive_.execute(onednn_stream_, fwd_primitives_args_);
-        dst_reorder.execute(onednn_stream_, dst_reorder_args);
+        ExecutePrimitive(fwd_primitive_, onednn_stream_, fwd_primitives_args_);
+        ExecutePrimitive(dst_reorder, onednn_stream_, dst_reorder_args);
       }
 
       is_init_ = true;
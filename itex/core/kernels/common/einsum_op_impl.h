@@ -695,7 +695,7 @@ struct EinsumHelper {
           dnnl::memory(matmul_pd.scratchpad_desc(), dnnl_engine,
                        GetTensorBuffer<T>(&scratchpad_tensor));
 
-      auto matmul_primitive = dnnl::matmul(matmul_pd);
+      auto matmul_primitive = CreatePrimitive<dnnl::matmul>(matmul_pd);
 
       auto dnnl_stream = CreateDnnlStream(*ctx, dnnl_engine);
       std::unordered_map<int, memory> fwd_primitive_args = {
@@ -703,7 +703,7 @@ struct EinsumHelper {
           {DNNL_ARG_WEIGHTS, weights_mem},
           {DNNL_ARG_DST, dst_mem},
           {DNNL_ARG_SCRATCHPAD, scratchpad_mem}};
-      matmul_primitive.execute(dnnl_stream, fwd_primitive_args);
+      ExecutePrimitive(matmul_primitive, dnnl_stream, fwd_primitive_args);
     } catch (dnnl::error& e) {
       string error_msg = "Status: " + std::to_string(e.status) +
                          ", message: " + string(e.message) + ", in file " +
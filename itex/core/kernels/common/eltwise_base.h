@@ -94,7 +94,7 @@ class EltwiseBaseOp : public OpKernel {
           dnnl::memory(fwd_pd.scratchpad_desc(), onednn_engine,
                        GetTensorBuffer<T>(&scratchpad_tensor));
 
-      primitive fwd_primitive(fwd_pd);
+      primitive fwd_primitive = CreatePrimitive<primitive>(fwd_pd);
 
       // Create memory primitive
       T* src_data =
@@ -116,7 +116,7 @@ class EltwiseBaseOp : public OpKernel {
           {DNNL_ARG_SRC, src_mem},
           {DNNL_ARG_DST, dst_mem},
           {DNNL_ARG_SCRATCHPAD, scratchpad_mem}};
-      fwd_primitive.execute(onednn_stream, fwd_primitive_args);
+      ExecutePrimitive(fwd_primitive, onednn_stream, fwd_primitive_args);
     } catch (dnnl::error& e) {
       string error_msg = "Status: " + std::to_string(e.status) +
                          ", message: " + string(e.message) + ", in file " +
@@ -214,7 +214,7 @@ class EltwiseGradBaseOp : public OpKernel {
           dnnl::memory(bwd_pd.scratchpad_desc(), onednn_engine_,
                        GetTensorBuffer<T>(&scratchpad_tensor));
 
-      primitive bwd_primitive(bwd_pd);
+      primitive bwd_primitive = CreatePrimitive<primitive>(bwd_pd);
 
       T* src_data =
           static_cast<T*>(const_cast<T*>(src_tensor.flat<T>().data()));
@@ -243,7 +243,7 @@ class EltwiseGradBaseOp : public OpKernel {
           {DNNL_ARG_DIFF_DST, diff_dst_mem},
           {DNNL_ARG_DIFF_SRC, diff_src_mem},
           {DNNL_ARG_SCRATCHPAD, scratchpad_mem}};
-      bwd_primitive.execute(onednn_stream, bwd_primitive_args);
+      ExecutePrimitive(bwd_primitive, onednn_stream, bwd_primitive_args);
     } catch (dnnl::error& e) {
       string error_msg = "Status: " + std::to_string(e.status) +
                          ", message: " + string(e.message) + ", in file " +
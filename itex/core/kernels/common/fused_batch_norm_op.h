@@ -210,7 +210,8 @@ class FusedBatchNormOp : public OpKernel {
           dnnl::memory(bn_fwd_pd.scratchpad_desc(), onednn_engine,
                        GetTensorBuffer<T>(&scratchpad_tensor));
 
-      dnnl::batch_normalization_forward bn_fwd_primitive(bn_fwd_pd);
+      dnnl::batch_normalization_forward bn_fwd_primitive =
+          CreatePrimitive<dnnl::batch_normalization_forward>(bn_fwd_pd);
 
       if (is_batch_norm_ex_) {
         dnnl::memory::desc workspace_md = bn_fwd_pd.workspace_desc();
@@ -314,7 +315,7 @@ class FusedBatchNormOp : public OpKernel {
         args.insert({DNNL_ARG_SRC_1, src1_mem});
       }
 
-      bn_fwd_primitive.execute(onednn_stream, args);
+      ExecutePrimitive(bn_fwd_primitive, onednn_stream, args);
 
       // For inference, we don't need to calculate running mean/var.
       if (!is_training_) return;
@@ -577,7 +578,7 @@ class QuantizedFusedBatchNormOp
         engine, output_scale_ptr);
 #endif
     dnnl::reorder reorder_pd =
-        dnnl::reorder(input_mem, scaled_input_mem, scale_attr);
+        CreatePrimitive<dnnl::reorder>(input_mem, scaled_input_mem, scale_attr);
     std::unordered_map<int, dnnl::memory> reorder_args = {
         {DNNL_ARG_SRC, input_mem},
         {DNNL_ARG_DST, scaled_input_mem},
@@ -585,7 +586,7 @@ class QuantizedFusedBatchNormOp
         {DNNL_ARG_ATTR_SCALES | DNNL_ARG_SRC, scale_mem},
 #endif
     };
-    reorder_pd.execute(stream, reorder_args);
+    ExecutePrimitive(reorder_pd, stream, reorder_args);
   }
 
   void AllocateTFOutputs(OpKernelContext* context, TensorShape tf_shape_scale,
@@ -798,7 +799,8 @@ class FusedBatchNormGradOp : public OpKernel {
           dnnl::memory(bn_bwd_pd.scratchpad_desc(), onednn_engine,
                        GetTensorBuffer<T>(&scratchpad_tensor));
 
-      dnnl::batch_normalization_backward bn_bwd_primitive(bn_bwd_pd);
+      dnnl::batch_normalization_backward bn_bwd_primitive =
+          CreatePrimitive<dnnl::batch_normalization_backward>(bn_bwd_pd);
 #ifndef ITEX_ONEDNN_3_0
       // OneDnn requests an empty shift tensor.
       Tensor shift_tensor;
@@ -871,7 +873,7 @@ class FusedBatchNormGradOp : public OpKernel {
       if (is_batch_norm_ex_) args.insert({DNNL_ARG_WORKSPACE, ws_mem});
       if (has_side_input_) args.insert({DNNL_ARG_DIFF_SRC_1, diff_src1_mem});
 
-      bn_bwd_primitive.execute(onednn_stream, args);
+      ExecutePrimitive(bn_bwd_primitive, onednn_stream, args);
 
       if (!reserved_space) delete reserved_space_tensor;
     } catch (dnnl::error& e) {
@@ -378,7 +378,7 @@ class OneDnnGRUForwardOp : public OpKernel {
       augru_args.insert({DNNL_ARG_AUGRU_ATTENTION, attention_mem});
 
     // Primitive execution: AUGRU.
-    augru_prim.execute(dnnl_stream, augru_args);
+    ExecutePrimitive(augru_prim, dnnl_stream, augru_args);
 
     // Wait for the computation to finalize.
     dnnl_stream.wait();
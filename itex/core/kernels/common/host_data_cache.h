@@ -24,6 +24,7 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "itex/core/utils/kernel_metrics.h"
 #include "itex/core/utils/op_kernel.h"
 #include "itex/core/utils/op_requires.h"
 #include "itex/core/utils/tensor_types.h"
@@ -61,6 +62,7 @@ class HostDataCache {
                        T** out_ptr) {
     if (!IsSame(host_data, count)) {
       last_host_data_ = std::move(std::vector<T>(host_data, host_data + count));
+      metrics::RecordHostDataCopy(count * sizeof(T));
     }
     *out_ptr = last_host_data_.data();
   }
@@ -86,6 +88,7 @@ class HostDataCache {
       ctx->GetDeviceStream()
           ->memcpy(gpu_data_ptr, last_host_data_.data(), count * sizeof(T))
           .wait();
+      metrics::RecordHostDataCopy(count * sizeof(T));
     }
     *out_ptr = gpu_data_ptr;
   }
@@ -177,7 +177,8 @@ class InstanceNormOp : public OpKernel {
           bn_fwd_desc, attr, onednn_engine);
 #endif
 
-      dnnl::batch_normalization_forward bn_fwd_primitive(bn_fwd_pd);
+      dnnl::batch_normalization_forward bn_fwd_primitive =
+          CreatePrimitive<dnnl::batch_normalization_forward>(bn_fwd_pd);
 
       void* scale_data = GetTensorBuffer<U>(&scale_tensor);
       void* shift_data = GetTensorBuffer<U>(&shift_tensor);
@@ -219,7 +220,7 @@ class InstanceNormOp : public OpKernel {
             const_cast<T*>(src_buf_batch + i * elems_per_batch)));
         dst_mem.set_data_handle(static_cast<void*>(
             const_cast<T*>(dst_buf_batch + i * elems_per_batch)));
-        bn_fwd_primitive.execute(onednn_stream, args);
+        ExecutePrimitive(bn_fwd_primitive, onednn_stream, args);
       }
     } catch (dnnl::error& e) {
       string error_msg = "Status:" + std::to_string(e.status) +
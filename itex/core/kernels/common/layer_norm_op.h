@@ -139,7 +139,8 @@ class LayerNormOp : public OpKernel {
       dnnl::layer_normalization_forward::primitive_desc ln_fwd_pd(
           ln_fwd_desc, attr, onednn_engine);
 #endif
-      dnnl::layer_normalization_forward ln_fwd_primitive(ln_fwd_pd);
+      dnnl::layer_normalization_forward ln_fwd_primitive =
+          CreatePrimitive<dnnl::layer_normalization_forward>(ln_fwd_pd);
 
       // Allocate output dst tensor.
       OP_REQUIRES_OK(context, context->forward_input_or_allocate_output(
@@ -238,7 +239,7 @@ class LayerNormOp : public OpKernel {
                        GetTensorBuffer<U>(&scratchpad_tensor));
       args.insert({DNNL_ARG_SCRATCHPAD, scratchpad_mem});
 
-      ln_fwd_primitive.execute(onednn_stream, args);
+      ExecutePrimitive(ln_fwd_primitive, onednn_stream, args);
     } catch (dnnl::error& e) {
       string error_msg = "Status:" + std::to_string(e.status) +
                          ", message: " + string(e.message) + ", in file " +
@@ -405,7 +406,8 @@ class LayerNormGradOp : public OpKernel {
       dnnl::layer_normalization_backward::primitive_desc ln_bwd_pd(
           ln_bwd_desc, attr, onednn_engine, ln_fwd_pd);
 #endif
-      dnnl::layer_normalization_backward ln_bwd_primitive(ln_bwd_pd);
+      dnnl::layer_normalization_backward ln_bwd_primitive =
+          CreatePrimitive<dnnl::layer_normalization_backward>(ln_bwd_pd);
 
       AllocateTFOutputs(context, scale_tensor.shape(), &diff_scale_tensor,
                         &diff_shift_tensor);
@@ -467,7 +469,7 @@ class LayerNormGradOp : public OpKernel {
           dnnl::memory(ln_bwd_pd.scratchpad_desc(), onednn_engine,
                        GetTensorBuffer<U>(&scratchpad_tensor));
       args.insert({DNNL_ARG_SCRATCHPAD, scratchpad_mem});
-      ln_bwd_primitive.execute(onednn_stream, args);
+      ExecutePrimitive(ln_bwd_primitive, onednn_stream, args);
     } catch (dnnl::error& e) {
       string error_msg = "Status:" + std::to_string(e.status) +
                          ", message: " + string(e.message) + ", in file " +
@@ -567,7 +567,7 @@ class MatMulOp : public OpKernel {
           dnnl::memory(matmul_pd.scratchpad_desc(), dnnl_engine_,
                        GetTensorBuffer<T>(scratchpad_tensor_.get()));
 
-      matmul_primitive_ = dnnl::matmul(matmul_pd);
+      matmul_primitive_ = CreatePrimitive<dnnl::matmul>(matmul_pd);
       src_mem_ = CreateDnnlMemory(src_md, dnnl_engine_,
                                   GetTensorBuffer<T>(&src_tensor));
       dst_mem_ = CreateDnnlMemory(dst_md, dnnl_engine_,
@@ -607,7 +607,7 @@ class MatMulOp : public OpKernel {
       return;
     }
 
-    matmul_primitive_.execute(dnnl_stream_, fwd_primitive_args_);
+    ExecutePrimitive(matmul_primitive_, dnnl_stream_, fwd_primitive_args_);
     scratchpad_tensor_.reset();
   }
 
@@ -939,7 +939,7 @@ class MatMulFunctor {
           dnnl::memory(matmul_pd.scratchpad_desc(), dnnl_engine_,
                        GetTensorBuffer<T>(scratchpad_tensor_.get()));
 
-      matmul_primitive_ = dnnl::matmul(matmul_pd);
+      matmul_primitive_ = CreatePrimitive<dnnl::matmul>(matmul_pd);
       src_mem_ = CreateDnnlMemory(src_md, dnnl_engine_, input_tensor_data);
       dst_mem_ = CreateDnnlMemory(dst_md, dnnl_engine_, output_tensor_data);
       fwd_primitive_args_.emplace(DNNL_ARG_SRC, src_mem_);
@@ -988,7 +988,7 @@ class MatMulFunctor {
       return;
     }
 
-    matmul_primitive_.execute(dnnl_stream_, fwd_primitive_args_);
+    ExecutePrimitive(matmul_primitive_, dnnl_stream_, fwd_primitive_args_);
 
     scratchpad_tensor_.reset();
   }
@@ -1182,7 +1182,7 @@ class FusedMatMulGradOp : public OpKernel {
           bwd_desc, attr, onednn_engine_, fwd_pd);
 #endif
       matmul_bwd_primitive_ =
-          dnnl::inner_product_backward_weights(matmul_bwd_pd);
+          CreatePrimitive<dnnl::inner_product_backward_weights>(matmul_bwd_pd);
 
       // Allocate output tensors.
       Tensor* diff_weight_tensor = nullptr;
@@ -1255,7 +1255,8 @@ class FusedMatMulGradOp : public OpKernel {
     onednn_stream_ = CreateDnnlStream(*context, onednn_engine_);
     scratchpad_tensor_ = std::make_shared<Tensor>();
     InitOrSetMemory(context);
-    matmul_bwd_primitive_.execute(onednn_stream_, fwd_primitive_args_);
+    ExecutePrimitive(matmul_bwd_primitive_, onednn_stream_,
+                     fwd_primitive_args_);
 
     scratchpad_tensor_.reset();
     // Reorder diff weight to plain format if it's reordered.
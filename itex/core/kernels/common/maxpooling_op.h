@@ -144,7 +144,8 @@ class MaxPoolGradOp : public PoolingBackwardOpBase<T> {
           dnnl::memory(pooling_bwd_pd.scratchpad_desc(), onednn_engine,
                        GetTensorBuffer<T>(&scratchpad_tensor_bwd));
 
-      dnnl::pooling_backward pooling_bwd_primitive(pooling_bwd_pd);
+      dnnl::pooling_backward pooling_bwd_primitive =
+          CreatePrimitive<dnnl::pooling_backward>(pooling_bwd_pd);
       Tensor* output_tensor = nullptr;
       this->AllocateOutputTensor(context, &orig_input_shape, &output_tensor);
       ITEX_DCHECK(output_tensor);
@@ -184,7 +185,8 @@ class MaxPoolGradOp : public PoolingBackwardOpBase<T> {
       std::unordered_map<int, dnnl::memory> fwd_net_args(
           {{DNNL_ARG_SRC, fwd_src_mem}, {DNNL_ARG_DST, fwd_dst_mem}});
 
-      dnnl::pooling_forward pooling_fwd_primitive(pooling_fwd_pd);
+      dnnl::pooling_forward pooling_fwd_primitive =
+          CreatePrimitive<dnnl::pooling_forward>(pooling_fwd_pd);
       Tensor ws_tensor;
       TensorShape ws_tensor_shape;
       dnnl::memory::desc ws_desc = pooling_fwd_pd.workspace_desc();
@@ -198,10 +200,10 @@ class MaxPoolGradOp : public PoolingBackwardOpBase<T> {
 
       fwd_net_args.insert({DNNL_ARG_WORKSPACE, ws_mem});
       fwd_net_args.insert({DNNL_ARG_SCRATCHPAD, scratchpad_mem_fwd});
-      pooling_fwd_primitive.execute(onednn_stream, fwd_net_args);
+      ExecutePrimitive(pooling_fwd_primitive, onednn_stream, fwd_net_args);
       bwd_net_args.insert({DNNL_ARG_WORKSPACE, ws_mem});
       bwd_net_args.insert({DNNL_ARG_SCRATCHPAD, scratchpad_mem_bwd});
-      pooling_bwd_primitive.execute(onednn_stream, bwd_net_args);
+      ExecutePrimitive(pooling_bwd_primitive, onednn_stream, bwd_net_args);
     } catch (dnnl::error& e) {
       string error_msg = "Status: " + std::to_string(e.status) +
                          ", message: " + string(e.message) + ", in file " +
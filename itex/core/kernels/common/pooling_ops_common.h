@@ -25,6 +25,7 @@ limitations under the License.
 #include "itex/core/utils/common_shape_fns.h"
 #include "itex/core/utils/onednn/onednn_layout_util.h"
 #include "itex/core/utils/onednn/onednn_util.h"
+#include "itex/core/utils/op_cost.h"
 #include "itex/core/utils/op_kernel.h"
 #include "itex/core/utils/op_requires.h"
 #include "itex/core/utils/padding.h"
@@ -305,6 +306,13 @@ class PoolingOpBase : public OpKernel {
 
   void Compute(OpKernelContext* context) override = 0;
 
+  OpCost Cost(const OpKernelContext& ctx) const override {
+    // ksize_ has 1 for N and C. It is empty for MaxPoolV2 until its first run.
+    int64 window_size = this->ksize_.empty() ? 0 : 1;
+    for (int32 size : this->ksize_) window_size *= size;
+    return PoolingOpCost(ctx, window_size);
+  }
+
  protected:
   // Calculate output shape of pooling op in oneDNN and TensorFlow order.
   // OneDNN uses NCHW(Pool2D) or NCDHW(Pool3D) for output order.
@@ -620,7 +628,8 @@ class PoolingOp : public PoolingForwardOpBase<T> {
           dnnl::memory(fwd_pd.scratchpad_desc(), onednn_engine,
                        GetTensorBuffer<T>(&scratchpad_tensor));
 
-      dnnl::pooling_forward fwd(fwd_pd);
+      dnnl::pooling_forward fwd =
+          CreatePrimitive<dnnl::pooling_forward>(fwd_pd);
 
       const T* src_data = input_tensor.flat<T>().data();
       T* dst_data = output_tensor->flat<T>().data();
@@ -635,7 +644,7 @@ class PoolingOp : public PoolingForwardOpBase<T> {
           {{DNNL_ARG_SRC, src_mem},
            {DNNL_ARG_DST, dst_mem},
            {DNNL_ARG_SCRATCHPAD, scratchpad_mem}});
-      fwd.execute(onednn_stream, net_args);
+      ExecutePrimitive(fwd, onednn_stream, net_args);
 
       bool int8_forward_inference =
           std::is_same<T, qint8>::value || std::is_same<T, quint8>::value;
@@ -719,6 +728,13 @@ class OneDnnPoolOpBase : public OpKernel {
   }
   void Compute(OpKernelContext* context) override = 0;
 
+  OpCost Cost(const OpKernelContext& ctx) const override {
+    // ksize_ has 1 for N and C. It is empty for MaxPoolV2 until its first run.
+    int64 window_size = this->ksize_.empty() ? 0 : 1;
+    for (int32 size : this->ksize_) window_size *= size;
+    return PoolingOpCost(ctx, window_size);
+  }
+
  protected:
   // Calculate output shape in OneDNN and TensorFlow order.
   // OneDNN uses NCHW(Pool2D) or NCDHW(Pool3D) for output order.
@@ -475,7 +475,7 @@ class QuantizeV2Op : public OpKernel {
         };
       }
 
-      fwd_primitive->execute(onednn_stream, fwd_primitive_args);
+      ExecutePrimitive(*fwd_primitive, onednn_stream, fwd_primitive_args);
 
       // Set data for output_min and output_max tensor
       if (std::is_same<T, quint8>::value && mode_ == QuantizeMode::SCALED) {
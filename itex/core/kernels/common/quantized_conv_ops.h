@@ -746,7 +746,7 @@ class LegacyQuantizedConvOpBase
                                       this->onednn_engine_, dst_buf);
 
     dnnl::reorder summand_scaled_primitive =
-        dnnl::reorder(summand_mem, dst_mem, reorder_attr);
+        CreatePrimitive<dnnl::reorder>(summand_mem, dst_mem, reorder_attr);
     std::unordered_map<int, dnnl::memory> reorder_args = {
         {DNNL_ARG_SRC, summand_mem},
         {DNNL_ARG_DST, dst_mem},
@@ -755,7 +755,7 @@ class LegacyQuantizedConvOpBase
 #endif
     };
     auto onednn_stream = CreateDnnlStream(*context, this->onednn_engine_);
-    summand_scaled_primitive.execute(onednn_stream, reorder_args);
+    ExecutePrimitive(summand_scaled_primitive, onednn_stream, reorder_args);
   }
 
  protected:
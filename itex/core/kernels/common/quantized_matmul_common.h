@@ -31,6 +31,7 @@ limitations under the License.
 #include "itex/core/kernels/onednn/block/quantized_ops.h"
 #include "itex/core/utils/errors.h"
 #include "itex/core/utils/logging.h"
+#include "itex/core/utils/memory_profiler.h"
 #include "itex/core/utils/onednn/onednn_layout_util.h"
 #include "itex/core/utils/onednn/onednn_post_op_util.h"
 #include "itex/core/utils/onednn/onednn_util.h"
@@ -87,7 +88,7 @@ class LegacyQuantizedMatMulOpBase : public OpKernel {
       return;
     }
 
-    fwd_primitive_.execute(onednn_stream_, fwd_primitive_args_);
+    ExecutePrimitive(fwd_primitive_, onednn_stream_, fwd_primitive_args_);
     scratchpad_tensor_.reset();
 
     const float min_input = context->input(kSrcMinRangeIndex).flat<float>()(0);
@@ -229,7 +230,7 @@ class LegacyQuantizedMatMulOpBase : public OpKernel {
       fwd_pd_ = dnnl::inner_product_forward::primitive_desc(
           fwd_desc, post_ops_attr, onednn_engine_);
 #endif
-      fwd_primitive_ = dnnl::inner_product_forward(fwd_pd_);
+      fwd_primitive_ = CreatePrimitive<dnnl::inner_product_forward>(fwd_pd_);
 
       // Allocate output Tensor.
       dst_shape_ = TensorShape({batch, channel});
@@ -443,6 +444,7 @@ class LegacyQuantizedMatMulOpBase : public OpKernel {
     if (bias_cached_data_.IsInitialized()) {
       return;
     }
+    ScopedMemoryKind cache_kind(MemoryKind::kCache);
     Tensor* bias_cached_tensor = nullptr;
     OP_REQUIRES_OK(context, context->allocate_persistent(
                                 temp_scaled_bias_tensor.dtype(),
@@ -644,7 +646,8 @@ class LegacyQuantizedMatMulOpBase : public OpKernel {
             onednn_engine_, reinterpret_cast<void*>(bias_scales_ptr));
 #endif
         auto reorder_prim =
-            dnnl::reorder(input_bias_mem, scaled_bias_mem, bias_attr);
+            CreatePrimitive<dnnl::reorder>(input_bias_mem, scaled_bias_mem,
+                                           bias_attr);
         std::unordered_map<int, memory> reorder_net_args = {
             {DNNL_ARG_SRC, input_bias_mem},
             {DNNL_ARG_DST, scaled_bias_mem},
@@ -653,7 +656,7 @@ class LegacyQuantizedMatMulOpBase : public OpKernel {
 #endif
         };
         auto onednn_stream = CreateDnnlStream(*context, onednn_engine_);
-        reorder_prim.execute(onednn_stream, reorder_net_args);
+        ExecutePrimitive(reorder_prim, onednn_stream, reorder_net_args);
       }
 
       // Cache the scaled bias
@@ -803,7 +806,7 @@ class LegacyQuantizedMatMulOpBase<Device, Tinput, Tweight, qint32, Toutput>
       return;
     }
 
-    fwd_primitive_.execute(onednn_stream_, fwd_primitive_args_);
+    ExecutePrimitive(fwd_primitive_, onednn_stream_, fwd_primitive_args_);
     scratchpad_tensor_.reset();
 
     const float min_input = context->input(kSrcMinRangeIndex).flat<float>()(0);
@@ -939,7 +942,7 @@ class LegacyQuantizedMatMulOpBase<Device, Tinput, Tweight, qint32, Toutput>
           onednn_engine_, dnnl::prop_kind::forward_inference, src_md,
           weight_exec_md, bias_md, dst_md, post_ops_attr);
 
-      fwd_primitive_ = dnnl::inner_product_forward(fwd_pd_);
+      fwd_primitive_ = CreatePrimitive<dnnl::inner_product_forward>(fwd_pd_);
 
       // Allocate output Tensor.
       dst_shape_ = TensorShape({batch, channel});
@@ -1146,6 +1149,7 @@ class LegacyQuantizedMatMulOpBase<Device, Tinput, Tweight, qint32, Toutput>
     if (bias_cached_data_.IsInitialized()) {
       return;
     }
+    ScopedMemoryKind cache_kind(MemoryKind::kCache);
     Tensor* bias_cached_tensor = nullptr;
     OP_REQUIRES_OK(context, context->allocate_persistent(
                                 temp_scaled_bias_tensor.dtype(),
@@ -1318,7 +1322,8 @@ class LegacyQuantizedMatMulOpBase<Device, Tinput, Tweight, qint32, Toutput>
              dnnl::memory::format_tag::x},
             onednn_engine_, reinterpret_cast<void*>(bias_scales_ptr));
         auto reorder_prim =
-            dnnl::reorder(input_bias_mem, scaled_bias_mem, bias_attr);
+            CreatePrimitive<dnnl::reorder>(input_bias_mem, scaled_bias_mem,
+                                           bias_attr);
 
         std::unordered_map<int, memory> reorder_net_args = {
             {DNNL_ARG_SRC, input_bias_mem},
@@ -1326,7 +1331,7 @@ class LegacyQuantizedMatMulOpBase<Device, Tinput, Tweight, qint32, Toutput>
             {DNNL_ARG_ATTR_SCALES | DNNL_ARG_SRC, bias_scales_mem},
         };
         auto onednn_stream = CreateDnnlStream(*context, onednn_engine_);
-        reorder_prim.execute(onednn_stream, reorder_net_args);
+        ExecutePrimitive(reorder_prim, onednn_stream, reorder_net_args);
       }
 
       // Cache the scaled bias
@@ -94,13 +94,13 @@ class SoftmaxOp : public OpKernel {
           dnnl::memory(fwd_pd.scratchpad_desc(), onednn_engine,
                        GetTensorBuffer<T>(&scratchpad_tensor));
 
-      auto softmax_fwd = dnnl::softmax_forward(fwd_pd);
-      softmax_fwd.execute(onednn_stream,
-                          {
-                              {DNNL_ARG_SRC, src_mem},
-                              {DNNL_ARG_DST, dst_mem},
-                              {DNNL_ARG_SCRATCHPAD, scratchpad_mem},
-                          });
+      auto softmax_fwd = CreatePrimitive<dnnl::softmax_forward>(fwd_pd);
+      ExecutePrimitive(softmax_fwd, onednn_stream,
+                       {
+                           {DNNL_ARG_SRC, src_mem},
+                           {DNNL_ARG_DST, dst_mem},
+                           {DNNL_ARG_SCRATCHPAD, scratchpad_mem},
+                       });
     } catch (dnnl::error& e) {
       string error_msg = "Status: " + std::to_string(e.status) +
                          ", message: " + string(e.message) + ", in file " +
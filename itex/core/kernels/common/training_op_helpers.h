@@ -0,0 +1,120 @@
+/* Copyright (c) 2021-2023 Intel Corporation
+
+Copyright 2017 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef ITEX_CORE_KERNELS_COMMON_TRAINING_OP_HELPERS_H_
+#define ITEX_CORE_KERNELS_COMMON_TRAINING_OP_HELPERS_H_
+
+#include <vector>
+
+#include "itex/core/utils/errors.h"
+#include "itex/core/utils/op_kernel.h"
+#include "itex/core/utils/plugin_tensor.h"
+#include "itex/core/utils/status.h"
+
+// Device-independent helpers to lock and look up the variables a kernel
+// updates. The copy functor that does copy-on-write of resource variables is
+// given by the caller; itex/core/kernels/gpu/training_op_helpers.h builds it
+// from functor::DenseUpdate.
+
+namespace itex {
+
+// Wrapper struct for TF_VariableInputLockHolder
+struct VariableInputLockHolderWrapper {
+ public:
+  explicit VariableInputLockHolderWrapper(
+      TF_VariableInputLockHolder* lockHolder)
+      : lockHolder_(lockHolder) {}
+  // Must be contructed with an acquired TF_VariableInputLockHolder
+  VariableInputLockHolderWrapper() = delete;
+
+  ~VariableInputLockHolderWrapper() {
+    TF_ReleaseVariableInputLockHolder(lockHolder_);
+  }
+
+ private:
+  TF_VariableInputLockHolder* lockHolder_;
+};
+
+inline VariableInputLockHolderWrapper
+MaybeLockVariableInputMutexesInOrderHelper(
+    OpKernelContext* ctx, bool do_lock, bool sparse,
+    const std::vector<int>& input_ids,
+    void (*copyFunc)(TF_OpKernelContext* ctx, TF_Tensor* source,
+                     TF_Tensor* dest)) {
+  TF_Status* tf_status = TF_NewStatus();
+  TF_OpKernelContext* tf_ctx = ctx->Get();
+  TF_VariableInputLockHolder* lockHolder = nullptr;
+  TF_MaybeLockVariableInputMutexesInOrder(tf_ctx, do_lock, sparse,
+                                          input_ids.data(), input_ids.size(),
+                                          copyFunc, &lockHolder, tf_status);
+
+  Status status = StatusFromTF_Status(tf_status);
+  ITEX_CHECK_OK(status);
+  TF_DeleteStatus(tf_status);
+
+  VariableInputLockHolderWrapper lock_wrapper(lockHolder);
+  return lock_wrapper;
+}
+
+inline VariableInputLockHolderWrapper MaybeLockVariableInputMutexesInOrder(
+    OpKernelContext* ctx, bool do_lock, bool sparse,
+    const std::vector<int>& input_ids) {
+  return MaybeLockVariableInputMutexesInOrderHelper(
+      ctx, do_lock, sparse, input_ids, EmptyCopyFunctor);
+}
+
+inline Status GetInputTensorFromVariableHelper(
+    OpKernelContext* ctx, int input, bool lock_held, bool sparse, Tensor* out,
+    void (*copyFunc)(TF_OpKernelContext* ctx, TF_Tensor* source,
+                     TF_Tensor* dest)) {
+  // TODO(itex): Currently, ITEX actually doesn't support Variant DataType.
+  // Add this check when we support such datatype.
+  bool is_variant_type = false;
+  TF_Status* tf_status = TF_NewStatus();
+  TF_OpKernelContext* tf_ctx = ctx->Get();
+  TF_Tensor* tf_tensor = nullptr;
+
+  // For ref tensor or dense tensor, the 3th, 4th, 5th arguments are actually
+  // useless.
+  TF_GetInputTensorFromVariable(tf_ctx, input, lock_held, is_variant_type,
+                                sparse, copyFunc, &tf_tensor, tf_status);
+  Status status = StatusFromTF_Status(tf_status);
+  TF_DeleteStatus(tf_status);
+  // The tensor is not set when the variable cannot be found.
+  TF_RETURN_IF_ERROR(status);
+
+  TensorShape shape;
+  auto dims = TF_NumDims(tf_tensor);
+  for (auto j = 0; j < dims; ++j) {
+    shape.AddDim(TF_Dim(tf_tensor, j));
+  }
+
+  *out =
+      Tensor(static_cast<DataType>(TF_TensorType(tf_tensor)), shape, tf_tensor);
+  return Status::OK();
+}
+
+inline Status GetInputTensorFromVariable(OpKernelContext* ctx, int input,
+                                         bool lock_held, bool sparse,
+                                         Tensor* out) {
+  return GetInputTensorFromVariableHelper(ctx, input, lock_held, sparse, out,
+                                          EmptyCopyFunctor);
+}
+
+}  // namespace itex
+
+#endif  // ITEX_CORE_KERNELS_COMMON_TRAINING_OP_HELPERS_H_
@@ -60,10 +60,12 @@ Status TransposeND(OpKernelContext* context, const Tensor& in, Tensor* out,
         out_md, onednn_engine,
         const_cast<void*>(static_cast<const void*>(out->flat<T>().data())));
 
-    auto transpose_reorder_primitive = dnnl::reorder(in_mem, out_mem);
+    auto transpose_reorder_primitive =
+        CreatePrimitive<dnnl::reorder>(in_mem, out_mem);
     std::unordered_map<int, dnnl::memory> transpose_reorder_args = {
         {DNNL_ARG_SRC, in_mem}, {DNNL_ARG_DST, out_mem}};
-    transpose_reorder_primitive.execute(onednn_stream, transpose_reorder_args);
+    ExecutePrimitive(transpose_reorder_primitive, onednn_stream,
+                     transpose_reorder_args);
     return Status::OK();
   } catch (dnnl::error& e) {
     string error_msg = "Status: " + std::to_string(e.status) +
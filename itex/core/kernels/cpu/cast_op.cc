@@ -75,7 +75,7 @@ class CastOp : public OpKernel {
       dst_md = CreatePlainMemDescWithFormatTag<DstT>(src_dims);
       auto reorder_pd = dnnl::reorder::primitive_desc(onednn_engine, src_md,
                                                       onednn_engine, dst_md);
-      auto reorder_primitive = dnnl::reorder(reorder_pd);
+      auto reorder_primitive = CreatePrimitive<dnnl::reorder>(reorder_pd);
 
       OneDnnShape output_onednn_shape;
       TensorShape output_tf_shape = src_tf_shape;
@@ -89,7 +89,7 @@ class CastOp : public OpKernel {
       dnnl::stream onednn_stream = CreateDnnlStream(*context, onednn_engine);
       std::unordered_map<int, dnnl::memory> reorder_args = {
           {DNNL_ARG_SRC, src_mem}, {DNNL_ARG_DST, dst_mem}};
-      reorder_primitive.execute(onednn_stream, reorder_args);
+      ExecutePrimitive(reorder_primitive, onednn_stream, reorder_args);
 #endif
     } catch (dnnl::error& e) {
       string error_msg = "Status: " + std::to_string(e.status) +
@@ -0,0 +1,314 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "itex/core/utils/errors.h"
+#include "itex/core/utils/onednn/onednn_util.h"
+#include "itex/core/utils/op_kernel.h"
+#include "itex/core/utils/op_requires.h"
+#include "itex/core/utils/plugin_tensor.h"
+#include "itex/core/utils/register_types.h"
+#include "itex/core/utils/strcat.h"
+#include "itex/core/utils/types.h"
+
+namespace itex {
+
+using memory = dnnl::memory;
+
+namespace functor {
+
+// Symmetric per-row (per-token) INT8 quantization of a row-major [M, K]
+// activation in a single pass over each row:
+//   scales[m] = max(|a[m, :]|) / 127,  q[m, k] = round(a[m, k] / scales[m])
+template <typename T>
+void QuantizeRowsPerToken(OpKernelContext* context, const T* a, int64 M,
+                          int64 K, int8* q, float* scales) {
+  const Eigen::TensorOpCost cost(/*bytes_loaded=*/K * sizeof(T),
+                                 /*bytes_stored=*/K + sizeof(float),
+                                 /*compute_cycles=*/4.0 * K);
+  context->eigen_device<CPUDevice>().parallelFor(
+      M, cost, [a, K, q, scales](Eigen::Index begin, Eigen::Index end) {
+        for (Eigen::Index m = begin; m < end; ++m) {
+          const T* a_row = a + m * K;
+          int8* q_row = q + m * K;
+          float amax = 0.0f;
+          for (int64 k = 0; k < K; ++k) {
+            amax = std::max(amax, std::abs(static_cast<float>(a_row[k])));
+          }
+          const float scale = amax > 0.0f ? amax / 127.0f : 1.0f;
+          const float inv_scale = 1.0f / scale;
+          for (int64 k = 0; k < K; ++k) {
+            const float value =
+                std::nearbyint(static_cast<float>(a_row[k]) * inv_scale);
+            q_row[k] =
+                static_cast<int8>(std::min(127.0f, std::max(-127.0f, value)));
+          }
+          scales[m] = scale;
+        }
+      });
+}
+
+}  // namespace functor
+
+// INT8 MatMul with dynamic per-token activation quantization. The activation
+// is quantized row by row on the fly, multiplied with a per-channel quantized
+// INT8 weight, and dequantized in the oneDNN post-ops:
+//   out[m, n] = (q_a[m, :] * q_b[:, n]) * b_scale[n] * a_scale[m] + bias[n]
+// Unlike the static-range INT8 MatMul, the bias is added after
+// dequantization, so it never has to be rescaled into the INT32 domain and
+// no scaled bias cache is needed when activation scales change every step.
+template <typename Device, typename T>
+class DynamicQuantizedMatMulOp : public OpKernel {
+ public:
+  explicit DynamicQuantizedMatMulOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("transpose_b", &transpose_b_));
+    OP_REQUIRES_OK(context,
+                   context->GetAttr("is_weight_const", &is_weight_const_));
+
+    std::vector<string> fused_ops;
+    OP_REQUIRES_OK(context, context->GetAttr("fused_ops", &fused_ops));
+    OP_REQUIRES_OK(context, context->GetAttr("num_args", &num_args_));
+    OP_REQUIRES(context,
+                fused_ops.empty() ||
+                    (fused_ops.size() == 1 && fused_ops[0] == "BiasAdd"),
+                errors::InvalidArgument(
+                    "Found unsupported fusion in DynamicQuantizedMatMul."));
+    has_bias_ = !fused_ops.empty();
+    OP_REQUIRES(context, num_args_ == (has_bias_ ? 1 : 0),
+                errors::InvalidArgument(
+                    "DynamicQuantizedMatMul with BiasAdd requires 1 arg."));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& a = context->input(kSrcIndex_);
+    const Tensor& weight = context->input(kWeightIndex_);
+    const Tensor& min_weight = context->input(kWeightMinIndex_);
+    const Tensor& max_weight = context->input(kWeightMaxIndex_);
+
+    OP_REQUIRES(context, a.dims() >= 2,
+                errors::InvalidArgument("In[0] ndims must be >= 2: ",
+                                        a.dims()));
+    OP_REQUIRES(context, weight.dims() == 2,
+                errors::InvalidArgument("In[1] must be 2D: ",
+                                        weight.shape().DebugString()));
+
+    const int64 K = a.dim_size(a.dims() - 1);
+    int64 M = 1;
+    for (int i = 0; i < a.dims() - 1; ++i) M *= a.dim_size(i);
+    const int64 k_weight = weight.dim_size(transpose_b_ ? 1 : 0);
+    const int64 N = weight.dim_size(transpose_b_ ? 0 : 1);
+    OP_REQUIRES(context, K == k_weight,
+                errors::InvalidArgument("Matrix size-incompatible: In[0]: ",
+                                        a.shape().DebugString(), ", In[1]: ",
+                                        weight.shape().DebugString()));
+
+    const int64 num_weight_scales = min_weight.NumElements();
+    OP_REQUIRES(
+        context,
+        (num_weight_scales == 1 || num_weight_scales == N) &&
+            max_weight.NumElements() == num_weight_scales,
+        errors::InvalidArgument("min_b and max_b must have 1 or ", N,
+                                " elements, but got ",
+                                min_weight.shape().DebugString(), " and ",
+                                max_weight.shape().DebugString()));
+
+    const Tensor* bias_tensor = nullptr;
+    if (has_bias_) {
+      bias_tensor = &context->input(kBiasIndex_);
+      OP_REQUIRES(context, bias_tensor->NumElements() == N,
+                  errors::InvalidArgument("Bias must have ", N,
+                                          " elements, but got ",
+                                          bias_tensor->shape().DebugString()));
+    }
+
+    TensorShape dst_shape = a.shape();
+    dst_shape.set_dim(dst_shape.dims() - 1, N);
+    Tensor* dst_tensor = nullptr;
+    OP_REQUIRES_OK(
+        context, context->allocate_output(kDstIndex_, dst_shape, &dst_tensor));
+    if (dst_shape.num_elements() == 0) return;
+
+    T* dst_data = dst_tensor->flat<T>().data();
+    if (K == 0) {
+      for (int64 m = 0; m < M; ++m) {
+        for (int64 n = 0; n < N; ++n) {
+          dst_data[m * N + n] =
+              has_bias_ ? bias_tensor->flat<T>()(n) : static_cast<T>(0);
+        }
+      }
+      return;
+    }
+
+    // Quantize the activation and collect its per-token scales.
+    Tensor src_q, src_scales;
+    OP_REQUIRES_OK(context, context->allocate_temp(
+                                DT_INT8, TensorShape({M, K}), &src_q));
+    OP_REQUIRES_OK(context, context->allocate_temp(
+                                DT_FLOAT, TensorShape({M, 1}), &src_scales));
+    functor::QuantizeRowsPerToken<T>(context, a.flat<T>().data(), M, K,
+                                     src_q.flat<int8>().data(),
+                                     src_scales.flat<float>().data());
+
+    // Per-channel weight scales of the SCALED narrow-range weight.
+    std::vector<float> weight_scales(N);
+    for (int64 n = 0; n < N; ++n) {
+      const int64 i = num_weight_scales == 1 ? 0 : n;
+      weight_scales[n] = std::max(std::abs(min_weight.flat<float>()(i)),
+                                  std::abs(max_weight.flat<float>()(i))) /
+                         127.0f;
+    }
+
+    try {
+      auto onednn_engine = CreateDnnlEngine<Device>(*context);
+      auto onednn_stream = CreateDnnlStream(*context, onednn_engine);
+
+      auto src_md = memory::desc({M, K}, memory::data_type::s8,
+                                 memory::format_tag::ab);
+      auto weight_md =
+          memory::desc({K, N}, OneDnnType<qint8>(),
+                       transpose_b_ ? memory::dims{1, K} : memory::dims{N, 1});
+      auto weight_exec_md =
+          is_weight_const_ ? memory::desc({K, N}, OneDnnType<qint8>(),
+                                          memory::format_tag::any)
+                           : weight_md;
+      auto dst_md =
+          memory::desc({M, N}, OneDnnType<T>(), memory::format_tag::ab);
+      auto src_scales_md = memory::desc({M, 1}, memory::data_type::f32,
+                                        memory::format_tag::ab);
+      auto bias_md =
+          memory::desc({1, N}, OneDnnType<T>(), memory::format_tag::ab);
+
+      // Dequantize: per-channel weight scales go to the primitive, per-token
+      // activation scales and the bias are applied as binary post-ops.
+      dnnl::post_ops post_ops;
+      post_ops.append_binary(dnnl::algorithm::binary_mul, src_scales_md);
+      if (has_bias_) {
+        post_ops.append_binary(dnnl::algorithm::binary_add, bias_md);
+      }
+      dnnl::primitive_attr attr;
+      attr.set_post_ops(post_ops);
+      attr.set_scratchpad_mode(dnnl::scratchpad_mode::user);
+#ifdef ITEX_ONEDNN_3_0
+      attr.set_scales_mask(DNNL_ARG_WEIGHTS, 1 << 1);
+      auto matmul_pd = dnnl::matmul::primitive_desc(
+          onednn_engine, src_md, weight_exec_md, dst_md, attr);
+#else
+      attr.set_output_scales(1 << 1, weight_scales);
+      auto matmul_desc = dnnl::matmul::desc(src_md, weight_exec_md, dst_md);
+      auto matmul_pd =
+          dnnl::matmul::primitive_desc(matmul_desc, attr, onednn_engine);
+#endif
+      auto matmul_primitive = CreatePrimitive<dnnl::matmul>(matmul_pd);
+
+      void* weight_data = GetTensorBuffer<qint8>(&weight);
+      memory weight_mem =
+          CreateDnnlMemory(weight_md, onednn_engine, weight_data);
+      Tensor tmp_weight;
+      const memory::desc& expected_md = matmul_pd.weights_desc();
+      if (weight_md != expected_md) {
+        qint8* weight_cached_data = nullptr;
+        if (is_weight_const_) {
+          if (weight_cache_manager_.IsEmpty()) {
+            weight_cache_manager_.SetCache(context, weight_md, expected_md,
+                                           weight_data, onednn_engine);
+          }
+          weight_cached_data =
+              weight_cache_manager_.GetCache(context, expected_md);
+        }
+        if (weight_cached_data != nullptr) {
+          weight_mem = CreateDnnlMemory(expected_md, onednn_engine,
+                                        weight_cached_data);
+        } else {
+          const int64 reorder_size = expected_md.get_size() / sizeof(qint8);
+          OP_REQUIRES_OK(context, context->allocate_temp(
+                                      DT_QINT8, TensorShape({reorder_size}),
+                                      &tmp_weight));
+          memory weight_reorder_mem =
+              CreateDnnlMemory(expected_md, onednn_engine,
+                               GetTensorBuffer<qint8>(&tmp_weight));
+          ReorderMemory(*context, &weight_mem, &weight_reorder_mem,
+                        onednn_engine);
+          weight_mem = weight_reorder_mem;
+        }
+      }
+
+      Tensor scratchpad_tensor;
+      const int64 scratchpad_size = matmul_pd.scratchpad_desc().get_size();
+      OP_REQUIRES_OK(context, context->allocate_temp(
+                                  DT_UINT8, TensorShape({scratchpad_size}),
+                                  &scratchpad_tensor));
+
+      std::unordered_map<int, memory> args = {
+          {DNNL_ARG_SRC, CreateDnnlMemory(src_md, onednn_engine,
+                                          GetTensorBuffer<int8>(&src_q))},
+          {DNNL_ARG_WEIGHTS, weight_mem},
+          {DNNL_ARG_DST, CreateDnnlMemory(dst_md, onednn_engine, dst_data)},
+          {DNNL_ARG_SCRATCHPAD,
+           CreateDnnlMemory(matmul_pd.scratchpad_desc(), onednn_engine,
+                            GetTensorBuffer<uint8>(&scratchpad_tensor))},
+          {DNNL_ARG_ATTR_MULTIPLE_POST_OP(0) | DNNL_ARG_SRC_1,
+           CreateDnnlMemory(src_scales_md, onednn_engine,
+                            GetTensorBuffer<float>(&src_scales))}};
+      if (has_bias_) {
+        args.insert({DNNL_ARG_ATTR_MULTIPLE_POST_OP(1) | DNNL_ARG_SRC_1,
+                     CreateDnnlMemory(bias_md, onednn_engine,
+                                      GetTensorBuffer<T>(bias_tensor))});
+      }
+#ifdef ITEX_ONEDNN_3_0
+      args.insert(
+          {DNNL_ARG_ATTR_SCALES | DNNL_ARG_WEIGHTS,
+           CreateDnnlMemory(memory::desc({N}, memory::data_type::f32,
+                                         memory::format_tag::x),
+                            onednn_engine, weight_scales.data())});
+#endif
+      ExecutePrimitive(matmul_primitive, onednn_stream, args);
+    } catch (dnnl::error& e) {
+      string error_msg = itex::strings::StrCat(
+          "Status: ", e.status, ", message: ", string(e.message), ", in file ",
+          __FILE__, ":", __LINE__);
+      OP_REQUIRES_OK(
+          context,
+          errors::Aborted("Operation received an exception:", error_msg));
+    }
+  }
+
+ private:
+  bool transpose_b_ = false;
+  bool is_weight_const_ = false;
+  bool has_bias_ = false;
+  int num_args_ = 0;
+  WeightCacheManager<qint8> weight_cache_manager_;
+  static const int kSrcIndex_ = 0, kDstIndex_ = 0, kWeightIndex_ = 1,
+                   kWeightMinIndex_ = 2, kWeightMaxIndex_ = 3,
+                   kBiasIndex_ = 4;
+};
+
+#define REGISTER_KERNEL(T)                                    \
+  REGISTER_KERNEL_BUILDER(Name("_ITEXDynamicQuantizedMatMul") \
+                              .Device(DEVICE_CPU)             \
+                              .TypeConstraint<T>("T"),        \
+                          DynamicQuantizedMatMulOp<CPUDevice, T>);
+
+TF_CALL_float(REGISTER_KERNEL);
+TF_CALL_bfloat16(REGISTER_KERNEL);
+#undef REGISTER_KERNEL
+
+}  // namespace itex
@@ -0,0 +1,274 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "itex/core/kernels/cpu/weight_decompress_matmul.h"
+#include "itex/core/utils/errors.h"
+#include "itex/core/utils/float8.h"
+#include "itex/core/utils/op_kernel.h"
+#include "itex/core/utils/op_requires.h"
+#include "itex/core/utils/plugin_tensor.h"
+#include "itex/core/utils/register_types.h"
+#include "itex/core/utils/types.h"
+
+namespace itex {
+
+namespace functor {
+namespace {
+
+// FP8 tensors are carried as uint8 bit patterns; `fp8_format` selects how the
+// bits are interpreted.
+Status ParseFP8Format(OpKernelConstruction* context, bool* is_e5m2) {
+  string fp8_format;
+  TF_RETURN_IF_ERROR(context->GetAttr("fp8_format", &fp8_format));
+  if (fp8_format != "E4M3" && fp8_format != "E5M2") {
+    return errors::InvalidArgument("Unsupported fp8_format: ", fp8_format);
+  }
+  *is_e5m2 = fp8_format == "E5M2";
+  return Status::OK();
+}
+
+// Fills `lut` with the 256 possible FP8 values multiplied by `scale`, so that
+// upconversion is a single table lookup.
+template <typename Tfp8>
+void BuildFP8Table(float scale, float* lut) {
+  for (int bits = 0; bits < 256; ++bits) {
+    lut[bits] =
+        static_cast<float>(Tfp8::FromRep(static_cast<uint8>(bits))) * scale;
+  }
+}
+
+void BuildFP8Table(bool is_e5m2, float scale, float* lut) {
+  if (is_e5m2) {
+    BuildFP8Table<float8_e5m2>(scale, lut);
+  } else {
+    BuildFP8Table<float8_e4m3fn>(scale, lut);
+  }
+}
+
+// Saturating round-to-nearest conversion of `x / scale` to FP8 bits.
+template <typename T, typename Tfp8>
+struct ToFP8Bits {
+  float inv_scale;
+  EIGEN_DEVICE_FUNC uint8 operator()(const T& x) const {
+    return Tfp8(static_cast<float>(x) * inv_scale).rep();
+  }
+};
+
+template <typename T>
+struct FromFP8Bits {
+  const float* lut;
+  EIGEN_DEVICE_FUNC T operator()(const uint8& bits) const {
+    return static_cast<T>(lut[bits]);
+  }
+};
+
+// Upconverts tiles of an [N, K] FP8 weight through a scaled lookup table.
+struct FP8WeightDecompressor {
+  const uint8* weight;
+  const float* lut;
+  int64 K;
+
+  void operator()(int64 n0, int64 nb, int64 k0, int64 kb, float* tile) const {
+    for (int64 n = 0; n < nb; ++n) {
+      const uint8* w_row = weight + (n0 + n) * K + k0;
+      float* tile_row = tile + n * kb;
+      for (int64 k = 0; k < kb; ++k) tile_row[k] = lut[w_row[k]];
+    }
+  }
+};
+
+}  // namespace
+}  // namespace functor
+
+namespace {
+
+Status GetFP8Scale(OpKernelContext* context, int index, float* scale) {
+  const Tensor& scale_tensor = context->input(index);
+  if (scale_tensor.NumElements() != 1) {
+    return errors::InvalidArgument(
+        "FP8 scale must be a scalar, but got shape ",
+        scale_tensor.shape().DebugString());
+  }
+  *scale = scale_tensor.flat<float>()(0);
+  if (!(*scale > 0.0f) || !std::isfinite(*scale)) {
+    return errors::InvalidArgument(
+        "FP8 scale must be positive and finite, but got ", *scale);
+  }
+  return Status::OK();
+}
+
+}  // namespace
+
+template <typename Device, typename T>
+class FP8QuantizeOp : public OpKernel {
+ public:
+  explicit FP8QuantizeOp(OpKernelConstruction* context) : OpKernel(context) {
+    OP_REQUIRES_OK(context, functor::ParseFP8Format(context, &is_e5m2_));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& input = context->input(0);
+    float scale;
+    OP_REQUIRES_OK(context, GetFP8Scale(context, 1, &scale));
+
+    Tensor* output = nullptr;
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(0, input.shape(), &output));
+    if (input.NumElements() == 0) return;
+
+    const Device& d = context->eigen_device<Device>();
+    if (is_e5m2_) {
+      output->flat<uint8>().device(d) = input.flat<T>().unaryExpr(
+          functor::ToFP8Bits<T, float8_e5m2>{1.0f / scale});
+    } else {
+      output->flat<uint8>().device(d) = input.flat<T>().unaryExpr(
+          functor::ToFP8Bits<T, float8_e4m3fn>{1.0f / scale});
+    }
+  }
+
+ private:
+  bool is_e5m2_ = false;
+};
+
+template <typename Device, typename T>
+class FP8DequantizeOp : public OpKernel {
+ public:
+  explicit FP8DequantizeOp(OpKernelConstruction* context) : OpKernel(context) {
+    OP_REQUIRES_OK(context, functor::ParseFP8Format(context, &is_e5m2_));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& input = context->input(0);
+    float scale;
+    OP_REQUIRES_OK(context, GetFP8Scale(context, 1, &scale));
+
+    Tensor* output = nullptr;
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(0, input.shape(), &output));
+    if (input.NumElements() == 0) return;
+
+    float lut[256];
+    functor::BuildFP8Table(is_e5m2_, scale, lut);
+    output->flat<T>().device(context->eigen_device<Device>()) =
+        input.flat<uint8>().unaryExpr(functor::FromFP8Bits<T>{lut});
+  }
+
+ private:
+  bool is_e5m2_ = false;
+};
+
+template <typename Device, typename T>
+class FP8WeightMatMulOp : public OpKernel {
+ public:
+  explicit FP8WeightMatMulOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, functor::ParseFP8Format(context, &is_e5m2_));
+
+    std::vector<string> fused_ops;
+    OP_REQUIRES_OK(context, context->GetAttr("fused_ops", &fused_ops));
+    OP_REQUIRES_OK(context, context->GetAttr("num_args", &num_args_));
+    OP_REQUIRES(context,
+                fused_ops.empty() ||
+                    (fused_ops.size() == 1 && fused_ops[0] == "BiasAdd"),
+                errors::InvalidArgument(
+                    "Found unsupported fusion in FP8WeightMatMul."));
+    has_bias_ = !fused_ops.empty();
+    OP_REQUIRES(context, num_args_ == (has_bias_ ? 1 : 0),
+                errors::InvalidArgument(
+                    "FP8WeightMatMul with BiasAdd requires 1 arg."));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& a = context->input(kSrcIndex_);
+    const Tensor& weight = context->input(kWeightIndex_);
+    float scale;
+    OP_REQUIRES_OK(context, GetFP8Scale(context, kScaleIndex_, &scale));
+
+    OP_REQUIRES(context, a.dims() >= 2,
+                errors::InvalidArgument("In[0] ndims must be >= 2: ",
+                                        a.dims()));
+    OP_REQUIRES(context, weight.dims() == 2,
+                errors::InvalidArgument("FP8 weight must be 2D: ",
+                                        weight.shape().DebugString()));
+
+    const int64 K = a.dim_size(a.dims() - 1);
+    int64 M = 1;
+    for (int i = 0; i < a.dims() - 1; ++i) M *= a.dim_size(i);
+    const int64 N = weight.dim_size(0);
+    OP_REQUIRES(context, weight.dim_size(1) == K,
+                errors::InvalidArgument("Matrix size-incompatible: In[0]: ",
+                                        a.shape().DebugString(), ", In[1]: ",
+                                        weight.shape().DebugString()));
+
+    const T* bias = nullptr;
+    if (has_bias_) {
+      const Tensor& bias_tensor = context->input(kBiasIndex_);
+      OP_REQUIRES(context, bias_tensor.NumElements() == N,
+                  errors::InvalidArgument("Bias must have ", N,
+                                          " elements, but got ",
+                                          bias_tensor.shape().DebugString()));
+      bias = bias_tensor.flat<T>().data();
+    }
+
+    TensorShape dst_shape = a.shape();
+    dst_shape.set_dim(dst_shape.dims() - 1, N);
+    Tensor* dst_tensor = nullptr;
+    OP_REQUIRES_OK(
+        context, context->allocate_output(kDstIndex_, dst_shape, &dst_tensor));
+    if (dst_shape.num_elements() == 0) return;
+
+    Tensor a_fp32;
+    const float* a_data = functor::GetFloatActivation<T>(context, a, &a_fp32);
+    if (!context->status().ok()) return;
+
+    float lut[256];
+    functor::BuildFP8Table(is_e5m2_, scale, lut);
+    functor::FP8WeightDecompressor decompressor{weight.flat<uint8>().data(),
+                                                lut, K};
+    functor::WeightDecompressMatMul<T>(context, a_data, M, K, N, decompressor,
+                                       bias, dst_tensor->flat<T>().data());
+  }
+
+ private:
+  bool is_e5m2_ = false;
+  bool has_bias_ = false;
+  int num_args_ = 0;
+  static const int kSrcIndex_ = 0, kDstIndex_ = 0, kWeightIndex_ = 1,
+                   kScaleIndex_ = 2, kBiasIndex_ = 3;
+};
+
+#define REGISTER_KERNEL(T)                                                \
+  REGISTER_KERNEL_BUILDER(                                                \
+      Name("_ITEXFP8Quantize").Device(DEVICE_CPU).TypeConstraint<T>("T"), \
+      FP8QuantizeOp<CPUDevice, T>);                                       \
+  REGISTER_KERNEL_BUILDER(Name("_ITEXFP8Dequantize")                      \
+                              .Device(DEVICE_CPU)                         \
+                              .TypeConstraint<T>("dtype"),                \
+                          FP8DequantizeOp<CPUDevice, T>);                 \
+  REGISTER_KERNEL_BUILDER(Name("_ITEXFP8WeightMatMul")                    \
+                              .Device(DEVICE_CPU)                         \
+                              .TypeConstraint<T>("T"),                    \
+                          FP8WeightMatMulOp<CPUDevice, T>);
+
+TF_CALL_float(REGISTER_KERNEL);
+TF_CALL_bfloat16(REGISTER_KERNEL);
+#undef REGISTER_KERNEL
+
+}  // namespace itex
@@ -0,0 +1,338 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include "itex/core/kernels/common/training_op_helpers.h"
+#include "itex/core/utils/errors.h"
+#include "itex/core/utils/op_kernel.h"
+#include "itex/core/utils/op_requires.h"
+#include "itex/core/utils/plugin_tensor.h"
+#include "itex/core/utils/register_types.h"
+#include "itex/core/utils/types.h"
+
+namespace itex {
+
+namespace functor {
+
+// Each update rule owns `kNumSlots` slot variables besides `var` and reads
+// `kNumScalars` scalar hyper-parameters, in the op's input order. The rules
+// follow the single-variable ResourceApply* ops and are evaluated on one
+// contiguous chunk at a time.
+template <typename T>
+struct MultiTensorAdam {
+  static constexpr int kNumSlots = 2;
+  static constexpr int kNumScalars = 6;
+
+  Status Init(OpKernelConstruction* context) {
+    return context->GetAttr("use_nesterov", &use_nesterov);
+  }
+
+  // beta1_power, beta2_power, lr, beta1, beta2, epsilon
+  void SetScalars(const T* scalars) {
+    const T one = T(1);
+    lr_t = scalars[2] * Eigen::numext::sqrt(one - scalars[1]) /
+           (one - scalars[0]);
+    beta1 = scalars[3];
+    beta2 = scalars[4];
+    epsilon = scalars[5];
+  }
+
+  void operator()(int64 size, T* var_ptr, T* const* slot_ptrs,
+                  const T* grad_ptr) const {
+    typename TTypes<T>::Flat var(var_ptr, size);
+    typename TTypes<T>::ConstFlat grad(grad_ptr, size);
+    typename TTypes<T>::Flat m(slot_ptrs[0], size);
+    typename TTypes<T>::Flat v(slot_ptrs[1], size);
+    const T one = T(1);
+    m += (grad - m) * (one - beta1);
+    v += (grad.square() - v) * (one - beta2);
+    if (use_nesterov) {
+      var -= ((grad * (one - beta1) + m * beta1) * lr_t) /
+             (v.sqrt() + epsilon);
+    } else {
+      var -= (m * lr_t) / (v.sqrt() + epsilon);
+    }
+  }
+
+  bool use_nesterov = false;
+  T lr_t, beta1, beta2, epsilon;
+};
+
+template <typename T>
+struct MultiTensorAdagrad {
+  static constexpr int kNumSlots = 1;
+  static constexpr int kNumScalars = 2;
+
+  Status Init(OpKernelConstruction* context) {
+    return context->GetAttr("update_slots", &update_slots);
+  }
+
+  // lr, epsilon
+  void SetScalars(const T* scalars) {
+    lr = scalars[0];
+    epsilon = scalars[1];
+  }
+
+  void operator()(int64 size, T* var_ptr, T* const* slot_ptrs,
+                  const T* grad_ptr) const {
+    typename TTypes<T>::Flat var(var_ptr, size);
+    typename TTypes<T>::ConstFlat grad(grad_ptr, size);
+    typename TTypes<T>::Flat accum(slot_ptrs[0], size);
+    if (update_slots) accum += grad.square();
+    var -= grad * lr / (accum.sqrt() + epsilon);
+  }
+
+  bool update_slots = true;
+  T lr, epsilon;
+};
+
+template <typename T>
+struct MultiTensorMomentum {
+  static constexpr int kNumSlots = 1;
+  static constexpr int kNumScalars = 2;
+
+  Status Init(OpKernelConstruction* context) {
+    return context->GetAttr("use_nesterov", &use_nesterov);
+  }
+
+  // lr, momentum
+  void SetScalars(const T* scalars) {
+    lr = scalars[0];
+    momentum = scalars[1];
+  }
+
+  void operator()(int64 size, T* var_ptr, T* const* slot_ptrs,
+                  const T* grad_ptr) const {
+    typename TTypes<T>::Flat var(var_ptr, size);
+    typename TTypes<T>::ConstFlat grad(grad_ptr, size);
+    typename TTypes<T>::Flat accum(slot_ptrs[0], size);
+    accum = accum * momentum + grad;
+    if (use_nesterov) {
+      var -= grad * lr + accum * momentum * lr;
+    } else {
+      var -= accum * lr;
+    }
+  }
+
+  bool use_nesterov = false;
+  T lr, momentum;
+};
+
+template <typename T>
+struct MultiTensorRMSProp {
+  static constexpr int kNumSlots = 2;
+  static constexpr int kNumScalars = 4;
+
+  Status Init(OpKernelConstruction* context) { return Status::OK(); }
+
+  // lr, rho, momentum, epsilon
+  void SetScalars(const T* scalars) {
+    lr = scalars[0];
+    rho = scalars[1];
+    momentum = scalars[2];
+    epsilon = scalars[3];
+  }
+
+  void operator()(int64 size, T* var_ptr, T* const* slot_ptrs,
+                  const T* grad_ptr) const {
+    typename TTypes<T>::Flat var(var_ptr, size);
+    typename TTypes<T>::ConstFlat grad(grad_ptr, size);
+    typename TTypes<T>::Flat ms(slot_ptrs[0], size);
+    typename TTypes<T>::Flat mom(slot_ptrs[1], size);
+    ms += (grad.square() - ms) * (T(1) - rho);
+    mom = mom * momentum + (ms + epsilon).rsqrt() * lr * grad;
+    var -= mom;
+  }
+
+  T lr, rho, momentum, epsilon;
+};
+
+}  // namespace functor
+
+namespace {
+
+// Copies the variable buffer when it is shared, so that the update does not
+// leak into other readers (copy-on-write of resource variables).
+template <typename T>
+void CopyVariableTensor(TF_OpKernelContext* tf_ctx, TF_Tensor* tf_source,
+                        TF_Tensor* tf_dest) {
+  OpKernelContext ctx(tf_ctx);
+  const Tensor source(tf_source);
+  Tensor dest(tf_dest);
+  dest.flat<T>().device(ctx.eigen_device<CPUDevice>()) = source.flat<T>();
+}
+
+// Large variables are split so that a few huge tensors still spread across
+// all threads, while many small ones are batched into one task each.
+constexpr int64 kChunkSize = 32 * 1024;
+
+struct Chunk {
+  int tensor;
+  int64 begin;
+  int64 end;
+};
+
+}  // namespace
+
+// Applies one optimizer step to N variables in a single kernel. Inputs are
+// laid out as N vars, N of each slot, the shared scalars and N grads. All
+// (variable, chunk) pairs are flattened into one work list that is processed
+// by the intra-op thread pool.
+template <typename Device, typename T, typename Updater>
+class MultiTensorApplyOp : public OpKernel {
+ public:
+  explicit MultiTensorApplyOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("N", &num_tensors_));
+    OP_REQUIRES_OK(context, context->GetAttr("use_locking", &use_locking_));
+    OP_REQUIRES_OK(context, updater_.Init(context));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    constexpr int kNumVars = 1 + Updater::kNumSlots;
+    const int num_resources = kNumVars * num_tensors_;
+    const int scalar_start = num_resources;
+    const int grad_start = scalar_start + Updater::kNumScalars;
+
+    std::vector<int> resource_ids(num_resources);
+    std::iota(resource_ids.begin(), resource_ids.end(), 0);
+    auto locks = MaybeLockVariableInputMutexesInOrderHelper(
+        context, use_locking_, /*sparse=*/false, resource_ids,
+        CopyVariableTensor<T>);
+
+    // vars[s * N + i] is the i-th variable (s == 0) or its s-th slot.
+    std::vector<Tensor> vars(num_resources);
+    for (int r = 0; r < num_resources; ++r) {
+      OP_REQUIRES_OK(context, GetVariable(context, r, &vars[r]));
+      const Tensor& var = vars[r % num_tensors_];
+      OP_REQUIRES(
+          context, vars[r].shape().IsSameSize(var.shape()),
+          errors::InvalidArgument("var and slot ", r / num_tensors_,
+                                  " of tensor ", r % num_tensors_,
+                                  " do not have the same shape ",
+                                  var.shape().DebugString(), " ",
+                                  vars[r].shape().DebugString()));
+    }
+
+    T scalars[Updater::kNumScalars];
+    for (int s = 0; s < Updater::kNumScalars; ++s) {
+      const Tensor& scalar = context->input(scalar_start + s);
+      OP_REQUIRES(context, TensorShapeUtils::IsScalar(scalar.shape()),
+                  errors::InvalidArgument("Input ", scalar_start + s,
+                                          " is not a scalar: ",
+                                          scalar.shape().DebugString()));
+      scalars[s] = scalar.scalar<T>()();
+    }
+    Updater updater = updater_;
+    updater.SetScalars(scalars);
+
+    std::vector<Chunk> chunks;
+    int64 total_elements = 0;
+    for (int i = 0; i < num_tensors_; ++i) {
+      const Tensor& grad = context->input(grad_start + i);
+      OP_REQUIRES(
+          context, vars[i].shape().IsSameSize(grad.shape()),
+          errors::InvalidArgument("var and grad of tensor ", i,
+                                  " do not have the same shape ",
+                                  vars[i].shape().DebugString(), " ",
+                                  grad.shape().DebugString()));
+      const int64 num_elements = grad.NumElements();
+      for (int64 begin = 0; begin < num_elements; begin += kChunkSize) {
+        chunks.push_back(
+            {i, begin, std::min(begin + kChunkSize, num_elements)});
+      }
+      total_elements += num_elements;
+    }
+    if (chunks.empty()) return;
+
+    auto work = [&](int64 start, int64 limit) {
+      T* slot_ptrs[Updater::kNumSlots];
+      for (int64 c = start; c < limit; ++c) {
+        const Chunk& chunk = chunks[c];
+        for (int s = 0; s < Updater::kNumSlots; ++s) {
+          slot_ptrs[s] = vars[(s + 1) * num_tensors_ + chunk.tensor]
+                             .flat<T>()
+                             .data() +
+                         chunk.begin;
+        }
+        const Tensor& grad = context->input(grad_start + chunk.tensor);
+        updater(chunk.end - chunk.begin,
+                vars[chunk.tensor].flat<T>().data() + chunk.begin, slot_ptrs,
+                grad.flat<T>().data() + chunk.begin);
+      }
+    };
+
+    // Every element reads var, slots and grad and writes var and slots.
+    const double elements_per_chunk =
+        static_cast<double>(total_elements) / chunks.size();
+    const Eigen::TensorOpCost cost(
+        elements_per_chunk * (kNumVars + 1) * sizeof(T),
+        elements_per_chunk * kNumVars * sizeof(T), elements_per_chunk * 10);
+    context->eigen_device<Device>().parallelFor(chunks.size(), cost, work);
+  }
+
+ private:
+  Status GetVariable(OpKernelContext* context, int input, Tensor* out) {
+    TF_RETURN_IF_ERROR(GetInputTensorFromVariableHelper(
+        context, input, use_locking_, /*sparse=*/false, out,
+        CopyVariableTensor<T>));
+    if (!out->IsInitialized()) {
+      return errors::FailedPrecondition(
+          "Attempting to use uninitialized variables");
+    }
+    if (out->dtype() != DataTypeToEnum<T>::v()) {
+      return errors::InvalidArgument("Variable ", input, " has dtype ",
+                                     DataTypeString(out->dtype()),
+                                     ", expected ",
+                                     DataTypeString(DataTypeToEnum<T>::v()));
+    }
+    return Status::OK();
+  }
+
+  int num_tensors_ = 0;
+  bool use_locking_ = false;
+  Updater updater_;
+};
+
+#define REGISTER_KERNEL(T)                                                \
+  REGISTER_KERNEL_BUILDER(                                                \
+      Name("_ITEXMultiTensorApplyAdam")                                   \
+          .Device(DEVICE_CPU)                                             \
+          .TypeConstraint<T>("T"),                                        \
+      MultiTensorApplyOp<CPUDevice, T, functor::MultiTensorAdam<T>>);     \
+  REGISTER_KERNEL_BUILDER(                                                \
+      Name("_ITEXMultiTensorApplyAdagrad")                                \
+          .Device(DEVICE_CPU)                                             \
+          .TypeConstraint<T>("T"),                                        \
+      MultiTensorApplyOp<CPUDevice, T, functor::MultiTensorAdagrad<T>>);  \
+  REGISTER_KERNEL_BUILDER(                                                \
+      Name("_ITEXMultiTensorApplyMomentum")                               \
+          .Device(DEVICE_CPU)                                             \
+          .TypeConstraint<T>("T"),                                        \
+      MultiTensorApplyOp<CPUDevice, T, functor::MultiTensorMomentum<T>>); \
+  REGISTER_KERNEL_BUILDER(                                                \
+      Name("_ITEXMultiTensorApplyRMSProp")                                \
+          .Device(DEVICE_CPU)                                             \
+          .TypeConstraint<T>("T"),                                        \
+      MultiTensorApplyOp<CPUDevice, T, functor::MultiTensorRMSProp<T>>);
+
+TF_CALL_float(REGISTER_KERNEL);
+TF_CALL_bfloat16(REGISTER_KERNEL);
+#undef REGISTER_KERNEL
+
+}  // namespace itex
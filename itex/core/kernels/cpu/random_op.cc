@@ -29,8 +29,8 @@ namespace itex {
           .Device(DEVICE_CPU)             \
           .TypeConstraint<int32>("T")     \
           .TypeConstraint<TYPE>("dtype"), \
-      PCGRandomOp<CPUDevice,              \
-                  random::UniformDistribution<random::PCGRandom, TYPE>>);
+      PhiloxRandomOp<CPUDevice,           \
+                     random::UniformDistribution<random::PhiloxRandom, TYPE>>);
 
 TF_CALL_CPU_NUMBER_TYPES(REGISTER_RANDOM_KERNEL);
 #undef REGISTER_RANDOM_KERNEL
@@ -21,6 +21,7 @@ limitations under the License.
 #include <algorithm>
 #include <cmath>
 #include <memory>
+#include <type_traits>
 
 #include "itex/core/kernels/common/random_ops_util.h"
 #include "itex/core/utils/lib/random/guarded_philox_random.h"
@@ -34,8 +35,13 @@ namespace itex {
 namespace functor {
 using random::PCGRandom;
 using random::PhiloxRandom;
+using random::PhiloxRandomVec;
 using random::SingleSampleAdapter;
 
+// Number of Philox counters computed per invocation on CPU. 16 lanes fill one
+// AVX-512 register (or two AVX2 registers) per 32-bit word of the counter.
+constexpr int kPhiloxLanes = 16;
+
 // The default implementation of the functor, which should never be invoked
 // But we still need to provide implementation for now for the linker to work,
 // since we do not support all the distributions yet.
@@ -92,17 +98,18 @@ class DistributionVec {
 
     // PhiloxRandom returns a 128-bit random bits each invocation, which cannot
     // directly use AVX2/AVX512. Thus post vectorized ops will be executed after
-    // all random bits are generated. For other generators, such as PCGRandom
-    // (1024*8-bit), it is better to execute post vectorized ops immediately
-    // after each invocation.
+    // all random bits are generated. For wide generators, such as
+    // PhiloxRandomVec (16*128-bit) and PCGRandom (1024*32-bit), it is better to
+    // execute post vectorized ops immediately after each invocation while the
+    // samples are still in registers/L1, so the output is written only once.
     InnerVecPost(&result[0], Distribution::kResultElementCount);
 
     return result;
   }
 
-  // Skip the outer VecPost for PCGRandom.
+  // Skip the outer VecPost for wide generators.
   void VecPost(RealType* data, int64 length) {
-    if (std::is_same<Generator, PCGRandom>::value) return;
+    if (kInnerVecPost) return;
 
     VecPostImpl(data, length);
   }
@@ -124,13 +131,16 @@ class DistributionVec {
     }
   }
 
-  // Currently, only PCGRandom is supported.
   void InnerVecPost(RealType* data, int64 length) {
-    if (!std::is_same<Generator, PCGRandom>::value) return;
+    if (!kInnerVecPost) return;
 
     VecPostImpl(data, length);
   }
 
+  // Generators returning at least one AVX-512 register of samples per
+  // invocation run the post ops per invocation.
+  static constexpr bool kInnerVecPost = Generator::kResultElementCount >= 16;
+
   Distribution* dist;
   bool has_fused_cmp;
   RealType real_thr;
@@ -153,6 +163,7 @@ struct FillRandomTask<Generator, Distribution, false> {
     // * `1 = (4 + 3) / 4` for normal Distribution.
     // * `1 = (2 + 3) / 4` for double/int64 Distribution.
     // * `4 = (16 + 3) / 4` for vectorized float/bfloat16 Distribution.
+    // * `1 = (64 + 63) / 64` for PhiloxRandomVec<16> generator.
     // * `1 = (1024 + 1023) / 1024` for PCG generator.
     const int skip_strides =
         (kGroupSize + gen.kResultElementCount - 1) / gen.kResultElementCount;
@@ -272,21 +283,38 @@ void FillRandom(
 // This functor can take the PhiloxRandom input from either device memory `key`
 // and `counter` or a stack value `gen`. If both `key` and `counter` are not
 // nullptr, they provide the input; otherwise `gen` provides the input.
+//
+// The random bits are produced by PhiloxRandomVec, which gives the same stream
+// as PhiloxRandom but computes `kPhiloxLanes` counters per invocation. Only
+// the uniform float/bfloat16 distributions are supported, same as
+// DistributionVec.
 template <class Distribution>
 struct FillPhiloxRandom<CPUDevice, Distribution> {
+  typedef typename Distribution::ResultElementType T;
+  typedef PhiloxRandomVec<kPhiloxLanes> VecGenerator;
+  typedef random::UniformDistribution<VecGenerator, T> VecDistribution;
+  // `dist` is replaced by VecDistribution, so any other distribution would
+  // silently produce uniform samples.
+  static_assert(
+      std::is_same<Distribution,
+                   random::UniformDistribution<PhiloxRandom, T>>::value &&
+          (std::is_same<T, float>::value ||
+           std::is_same<T, Eigen::bfloat16>::value),
+      "FillPhiloxRandom on CPU only supports the uniform float/bfloat16 "
+      "distributions.");
+
   // Partial specialization for CPU to fill the entire region with randoms
   // It splits the work into several tasks and run them in parallel
-  void operator()(
-      OpKernelContext* ctx, const CPUDevice& d, PhiloxRandom gen,
-      typename Distribution::ResultElementType* data, int64 size,
-      Distribution dist, const uint64* key = nullptr,
-      const uint64* counter = nullptr,
-      const typename Distribution::ResultElementType* cmp_data = nullptr) {
+  void operator()(OpKernelContext* ctx, const CPUDevice& d, PhiloxRandom gen,
+                  T* data, int64 size, Distribution dist,
+                  const uint64* key = nullptr, const uint64* counter = nullptr,
+                  const T* cmp_data = nullptr) {
     if (key != nullptr && counter != nullptr) {
       gen = GetPhiloxRandomFromCounterKeyMem(counter, key);
     }
 
-    FillRandom(ctx, d, gen, data, size, dist, cmp_data);
+    FillRandom(ctx, d, VecGenerator(gen), data, size, VecDistribution(),
+               cmp_data);
   }
 };
 
@@ -106,7 +106,7 @@ class ResizeBilinearOp : public OpKernel {
       scratchpad_mem = dnnl::memory(fwd_pd.scratchpad_desc(), onednn_engine,
                                     GetTensorBuffer<T>(&scratchpad_tensor));
 
-      auto fwd_primitive = dnnl::resampling_forward(fwd_pd);
+      auto fwd_primitive = CreatePrimitive<dnnl::resampling_forward>(fwd_pd);
 
       dnnl::memory src_mem =
           dnnl::memory(src_md, onednn_engine, GetTensorBuffer<T>(&src_tensor));
@@ -144,7 +144,7 @@ class ResizeBilinearOp : public OpKernel {
           {DNNL_ARG_DST, dst_mem},
           {DNNL_ARG_SCRATCHPAD, scratchpad_mem}};
 
-      fwd_primitive.execute(onednn_stream, fwd_primitive_args);
+      ExecutePrimitive(fwd_primitive, onednn_stream, fwd_primitive_args);
     } catch (dnnl::error& e) {
       string error_msg = "Status: " + std::to_string(e.status) +
                          ", message: " + string(e.message) + ", in file " +
@@ -289,8 +289,8 @@ class ResizeBilinearGradOp : public OpKernel {
           {DNNL_ARG_DIFF_SRC, diff_src_mem},
           {DNNL_ARG_SCRATCHPAD, scratchpad_mem}};
 
-      auto bwd_primitive = dnnl::resampling_backward(bwd_pd);
-      bwd_primitive.execute(onednn_stream, bwd_primitive_args);
+      auto bwd_primitive = CreatePrimitive<dnnl::resampling_backward>(bwd_pd);
+      ExecutePrimitive(bwd_primitive, onednn_stream, bwd_primitive_args);
     } catch (dnnl::error& e) {
       string error_msg = "Status: " + std::to_string(e.status) +
                          ", message: " + string(e.message) + ", in file " +
@@ -81,7 +81,7 @@ class SliceOp : public OpKernel {
       memory::desc src_sub_md = src_md.submemory_desc(size_dims, begin_dims);
       dnnl::reorder::primitive_desc reorder_pd(onednn_engine, src_sub_md,
                                                onednn_engine, dst_md);
-      dnnl::reorder reorder_prim(reorder_pd);
+      dnnl::reorder reorder_prim = CreatePrimitive<dnnl::reorder>(reorder_pd);
 
       Tensor* dst_tensor = nullptr;
       OP_REQUIRES_OK(context, context->allocate_output(kDstIndex, dst_tf_shape,
@@ -109,7 +109,7 @@ class SliceOp : public OpKernel {
           {DNNL_ARG_SRC, src_mem},
           {DNNL_ARG_DST, dst_mem},
           {DNNL_ARG_SCRATCHPAD, scratchpad_mem}};
-      reorder_prim.execute(onednn_stream, reorder_primitive_args);
+      ExecutePrimitive(reorder_prim, onednn_stream, reorder_primitive_args);
     } catch (dnnl::error& e) {
       string error_msg = "Status:" + std::to_string(e.status) +
                          ", message: " + string(e.message) + ". in file " +
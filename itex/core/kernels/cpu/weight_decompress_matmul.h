@@ -0,0 +1,122 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef ITEX_CORE_KERNELS_CPU_WEIGHT_DECOMPRESS_MATMUL_H_
+#define ITEX_CORE_KERNELS_CPU_WEIGHT_DECOMPRESS_MATMUL_H_
+
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+
+#include "itex/core/utils/op_kernel.h"
+#include "itex/core/utils/op_requires.h"
+#include "itex/core/utils/plugin_tensor.h"
+#include "itex/core/utils/types.h"
+#include "third_party/eigen3/Eigen/Core"
+
+namespace itex {
+
+typedef Eigen::ThreadPoolDevice CPUDevice;
+
+namespace functor {
+
+// Tile sizes of the weight-decompression GEMM. One weight tile holds
+// kDecompressBlockN x kDecompressBlockK fp32 values (32 KB), so it stays in
+// L1/L2 while it is multiplied with the activation panel. The compressed
+// weight is the only operand streamed from memory for every tile, which is
+// what makes low-bit weight storage pay off for memory-bound LLM decoding.
+constexpr int kDecompressBlockN = 32;
+constexpr int kDecompressBlockK = 256;
+
+using RowMajorMatrix =
+    Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+using ConstStridedMap =
+    Eigen::Map<const RowMajorMatrix, Eigen::Unaligned, Eigen::OuterStride<>>;
+
+// Computes out[M, N] = a[M, K] * W^T + bias, where W[N, K] is never
+// materialized: `decompressor(n0, nb, k0, kb, tile)` must write the fp32 values
+// of W[n0 : n0 + nb, k0 : k0 + kb] into `tile` as a row-major [nb, kb] matrix.
+// Output columns are split into blocks of kDecompressBlockN and distributed
+// over the intra-op thread pool, each block accumulating in fp32.
+template <typename T, typename Decompressor>
+void WeightDecompressMatMul(OpKernelContext* context, const float* a, int64 M,
+                            int64 K, int64 N, const Decompressor& decompressor,
+                            const T* bias, T* out) {
+  const int64 num_n_blocks = (N + kDecompressBlockN - 1) / kDecompressBlockN;
+  // Cost of one block: dequantize a [kDecompressBlockN, K] slice and run a
+  // [M, K] x [K, kDecompressBlockN] product on it.
+  const Eigen::TensorOpCost cost(
+      /*bytes_loaded=*/K * kDecompressBlockN + M * K * sizeof(float),
+      /*bytes_stored=*/M * kDecompressBlockN * sizeof(T),
+      /*compute_cycles=*/2.0 * M * K * kDecompressBlockN +
+          4.0 * K * kDecompressBlockN);
+
+  const CPUDevice& d = context->eigen_device<CPUDevice>();
+  d.parallelFor(
+      num_n_blocks, cost,
+      [&decompressor, a, M, K, N, bias, out](Eigen::Index begin,
+                                             Eigen::Index end) {
+        alignas(64) float tile[kDecompressBlockN * kDecompressBlockK];
+        RowMajorMatrix acc(M, kDecompressBlockN);
+        for (Eigen::Index blk = begin; blk < end; ++blk) {
+          const int64 n0 = blk * kDecompressBlockN;
+          const int64 nb = std::min<int64>(kDecompressBlockN, N - n0);
+          auto acc_block = acc.leftCols(nb);
+          acc_block.setZero();
+          for (int64 k0 = 0; k0 < K; k0 += kDecompressBlockK) {
+            const int64 kb = std::min<int64>(kDecompressBlockK, K - k0);
+            decompressor(n0, nb, k0, kb, tile);
+            Eigen::Map<const RowMajorMatrix> w_tile(tile, nb, kb);
+            ConstStridedMap a_panel(a + k0, M, kb, Eigen::OuterStride<>(K));
+            acc_block.noalias() += a_panel * w_tile.transpose();
+          }
+          for (int64 m = 0; m < M; ++m) {
+            T* out_row = out + m * N + n0;
+            const float* acc_row = acc.data() + m * kDecompressBlockN;
+            if (bias != nullptr) {
+              for (int64 n = 0; n < nb; ++n) {
+                out_row[n] = static_cast<T>(
+                    acc_row[n] + static_cast<float>(bias[n0 + n]));
+              }
+            } else {
+              for (int64 n = 0; n < nb; ++n) {
+                out_row[n] = static_cast<T>(acc_row[n]);
+              }
+            }
+          }
+        }
+      });
+}
+
+// Returns an fp32 view of `a`. Floats are used in place, other types are
+// converted into `a_fp32`, which must outlive the returned pointer.
+template <typename T>
+const float* GetFloatActivation(OpKernelContext* context, const Tensor& a,
+                                Tensor* a_fp32) {
+  if (std::is_same<T, float>::value) {
+    return reinterpret_cast<const float*>(a.flat<T>().data());
+  }
+  OP_REQUIRES_OK_PTR(context, context->allocate_temp(
+                                  DT_FLOAT, TensorShape({a.NumElements()}),
+                                  a_fp32));
+  a_fp32->flat<float>().device(context->eigen_device<CPUDevice>()) =
+      a.flat<T>().template cast<float>();
+  return a_fp32->flat<float>().data();
+}
+
+}  // namespace functor
+}  // namespace itex
+
+#endif  // ITEX_CORE_KERNELS_CPU_WEIGHT_DECOMPRESS_MATMUL_H_
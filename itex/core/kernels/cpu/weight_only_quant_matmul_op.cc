@@ -0,0 +1,219 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <algorithm>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "itex/core/kernels/cpu/weight_decompress_matmul.h"
+#include "itex/core/utils/errors.h"
+#include "itex/core/utils/op_kernel.h"
+#include "itex/core/utils/op_requires.h"
+#include "itex/core/utils/plugin_tensor.h"
+#include "itex/core/utils/register_types.h"
+#include "itex/core/utils/types.h"
+
+namespace itex {
+
+namespace functor {
+
+// Dequantizes tiles of a weight stored as [N, K] int8, or as [N, ceil(K / 2)]
+// uint8 holding two unsigned 4-bit values per byte, with per-group scales and
+// zero points of shape [N, ceil(K / group_size)]:
+//   W[n, k] = (q[n, k] - zero_points[n, k / group_size]) *
+//             scales[n, k / group_size]
+template <int kBits>
+struct WeightOnlyQuantDecompressor {
+  const uint8* weight;
+  const float* scales;
+  const int8* zero_points;
+  int64 row_bytes;
+  int64 num_groups;
+  int64 group_size;
+
+  inline int32 Load(const uint8* row, int64 k) const {
+    if (kBits == 8) return static_cast<int8>(row[k]);
+    return (row[k >> 1] >> ((k & 1) << 2)) & 0xF;
+  }
+
+  void operator()(int64 n0, int64 nb, int64 k0, int64 kb, float* tile) const {
+    for (int64 n = 0; n < nb; ++n) {
+      const uint8* q_row = weight + (n0 + n) * row_bytes;
+      const float* s_row = scales + (n0 + n) * num_groups;
+      const int8* z_row = zero_points + (n0 + n) * num_groups;
+      float* tile_row = tile + n * kb;
+      // Walk the tile group by group so that scale and zero point are loop
+      // invariant in the innermost loop.
+      int64 k = k0;
+      while (k < k0 + kb) {
+        const int64 g = k / group_size;
+        const int64 seg_end = std::min((g + 1) * group_size, k0 + kb);
+        const float scale = s_row[g];
+        const int32 zero = z_row[g];
+        for (; k < seg_end; ++k) {
+          tile_row[k - k0] = static_cast<float>(Load(q_row, k) - zero) * scale;
+        }
+      }
+    }
+  }
+};
+
+}  // namespace functor
+
+template <typename Device, typename T, typename Tweight>
+class WeightOnlyQuantMatMulOp : public OpKernel {
+ public:
+  explicit WeightOnlyQuantMatMulOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("weight_bits", &weight_bits_));
+    OP_REQUIRES_OK(context, context->GetAttr("group_size", &group_size_));
+    OP_REQUIRES(context, weight_bits_ == 4 || weight_bits_ == 8,
+                errors::InvalidArgument(
+                    "_ITEXWeightOnlyQuantMatMul supports 4 or 8 weight bits, "
+                    "but got ",
+                    weight_bits_));
+    OP_REQUIRES(
+        context, (weight_bits_ == 8) == std::is_same<Tweight, int8>::value,
+        errors::InvalidArgument("8-bit weight must be stored as int8 and "
+                                "4-bit weight must be packed into uint8."));
+    OP_REQUIRES(context, weight_bits_ == 8 || group_size_ % 2 == 0,
+                errors::InvalidArgument(
+                    "group_size must be even for 4-bit weight, but got ",
+                    group_size_));
+
+    std::vector<string> fused_ops;
+    OP_REQUIRES_OK(context, context->GetAttr("fused_ops", &fused_ops));
+    OP_REQUIRES_OK(context, context->GetAttr("num_args", &num_args_));
+    OP_REQUIRES(context,
+                fused_ops.empty() ||
+                    (fused_ops.size() == 1 && fused_ops[0] == "BiasAdd"),
+                errors::InvalidArgument(
+                    "Found unsupported fusion in WeightOnlyQuantMatMul."));
+    has_bias_ = !fused_ops.empty();
+    OP_REQUIRES(context, num_args_ == (has_bias_ ? 1 : 0),
+                errors::InvalidArgument(
+                    "WeightOnlyQuantMatMul with BiasAdd requires 1 arg."));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& a = context->input(kSrcIndex_);
+    const Tensor& weight = context->input(kWeightIndex_);
+    const Tensor& scales = context->input(kScaleIndex_);
+    const Tensor& zero_points = context->input(kZeroPointIndex_);
+
+    OP_REQUIRES(context, a.dims() >= 2,
+                errors::InvalidArgument("In[0] ndims must be >= 2: ",
+                                        a.dims()));
+    OP_REQUIRES(context, weight.dims() == 2,
+                errors::InvalidArgument("Quantized weight must be 2D: ",
+                                        weight.shape().DebugString()));
+
+    const int64 K = a.dim_size(a.dims() - 1);
+    int64 M = 1;
+    for (int i = 0; i < a.dims() - 1; ++i) M *= a.dim_size(i);
+    const int64 N = weight.dim_size(0);
+    const int64 row_bytes = weight_bits_ == 8 ? K : (K + 1) / 2;
+    const int64 num_groups = (K + group_size_ - 1) / group_size_;
+    OP_REQUIRES(
+        context, weight.dim_size(1) == row_bytes,
+        errors::InvalidArgument("Matrix size-incompatible: In[0]: ",
+                                a.shape().DebugString(),
+                                ", In[1]: ", weight.shape().DebugString(),
+                                " with ", weight_bits_, "-bit weight"));
+    OP_REQUIRES(
+        context,
+        scales.NumElements() == N * num_groups &&
+            zero_points.NumElements() == N * num_groups,
+        errors::InvalidArgument(
+            "Scales and zero points must have shape [", N, ", ", num_groups,
+            "], but got ", scales.shape().DebugString(), " and ",
+            zero_points.shape().DebugString()));
+
+    const T* bias = nullptr;
+    if (has_bias_) {
+      const Tensor& bias_tensor = context->input(kBiasIndex_);
+      OP_REQUIRES(context, bias_tensor.NumElements() == N,
+                  errors::InvalidArgument("Bias must have ", N,
+                                          " elements, but got ",
+                                          bias_tensor.shape().DebugString()));
+      bias = bias_tensor.flat<T>().data();
+    }
+
+    TensorShape dst_shape = a.shape();
+    dst_shape.set_dim(dst_shape.dims() - 1, N);
+    Tensor* dst_tensor = nullptr;
+    OP_REQUIRES_OK(
+        context, context->allocate_output(kDstIndex_, dst_shape, &dst_tensor));
+    if (dst_shape.num_elements() == 0) return;
+
+    Tensor a_fp32;
+    const float* a_data = functor::GetFloatActivation<T>(context, a, &a_fp32);
+    if (!context->status().ok()) return;
+
+    T* dst_data = dst_tensor->flat<T>().data();
+    if (weight_bits_ == 8) {
+      functor::WeightDecompressMatMul<T>(
+          context, a_data, M, K, N,
+          MakeDecompressor<8>(weight, scales, zero_points, row_bytes,
+                              num_groups),
+          bias, dst_data);
+    } else {
+      functor::WeightDecompressMatMul<T>(
+          context, a_data, M, K, N,
+          MakeDecompressor<4>(weight, scales, zero_points, row_bytes,
+                              num_groups),
+          bias, dst_data);
+    }
+  }
+
+ private:
+  template <int kBits>
+  functor::WeightOnlyQuantDecompressor<kBits> MakeDecompressor(
+      const Tensor& weight, const Tensor& scales, const Tensor& zero_points,
+      int64 row_bytes, int64 num_groups) const {
+    functor::WeightOnlyQuantDecompressor<kBits> decompressor;
+    decompressor.weight =
+        reinterpret_cast<const uint8*>(weight.flat<Tweight>().data());
+    decompressor.scales = scales.flat<float>().data();
+    decompressor.zero_points = zero_points.flat<int8>().data();
+    decompressor.row_bytes = row_bytes;
+    decompressor.num_groups = num_groups;
+    decompressor.group_size = group_size_;
+    return decompressor;
+  }
+
+  int weight_bits_ = 8;
+  int64 group_size_ = 128;
+  int num_args_ = 0;
+  bool has_bias_ = false;
+  static const int kSrcIndex_ = 0, kDstIndex_ = 0, kWeightIndex_ = 1,
+                   kScaleIndex_ = 2, kZeroPointIndex_ = 3, kBiasIndex_ = 4;
+};
+
+#define REGISTER_KERNEL(T, Tweight)                                \
+  REGISTER_KERNEL_BUILDER(Name("_ITEXWeightOnlyQuantMatMul")       \
+                              .Device(DEVICE_CPU)                  \
+                              .TypeConstraint<T>("T")              \
+                              .TypeConstraint<Tweight>("Tweight"), \
+                          WeightOnlyQuantMatMulOp<CPUDevice, T, Tweight>);
+
+REGISTER_KERNEL(float, int8);
+REGISTER_KERNEL(float, uint8);
+REGISTER_KERNEL(Eigen::bfloat16, int8);
+REGISTER_KERNEL(Eigen::bfloat16, uint8);
+#undef REGISTER_KERNEL
+
+}  // namespace itex
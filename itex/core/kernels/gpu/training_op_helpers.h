@@ -20,6 +20,7 @@ limitations under the License.
 
 #include <vector>
 
+#include "itex/core/kernels/common/training_op_helpers.h"
 #include "itex/core/kernels/gpu/dense_update_functor.h"
 #include "itex/core/utils/op_kernel.h"
 #include "itex/core/utils/plugin_tensor.h"
@@ -33,23 +34,6 @@ enum AssignUpdateType {
   Sub = 2,
 };
 
-// Wrapper struct for TF_VariableInputLockHolder
-struct VariableInputLockHolderWrapper {
- public:
-  explicit VariableInputLockHolderWrapper(
-      TF_VariableInputLockHolder* lockHolder)
-      : lockHolder_(lockHolder) {}
-  // Must be contructed with an acquired TF_VariableInputLockHolder
-  VariableInputLockHolderWrapper() = delete;
-
-  ~VariableInputLockHolderWrapper() {
-    TF_ReleaseVariableInputLockHolder(lockHolder_);
-  }
-
- private:
-  TF_VariableInputLockHolder* lockHolder_;
-};
-
 // TODO(itex): move the DenseAssginWrapper and DenseUpdateWrapper to the
 // op_kernel.h, together with EmptyCopyFunctor, after we fix the issue "No
 // kernel name provided without -fsycl-unnamed-lambda enabled"
@@ -88,27 +72,6 @@ void DenseUpdateWrapper(TF_OpKernelContext* tf_ctx, TF_Tensor* tf_source,
   }
 }
 
-inline VariableInputLockHolderWrapper
-MaybeLockVariableInputMutexesInOrderHelper(
-    OpKernelContext* ctx, bool do_lock, bool sparse,
-    const std::vector<int>& input_ids,
-    void (*copyFunc)(TF_OpKernelContext* ctx, TF_Tensor* source,
-                     TF_Tensor* dest)) {
-  TF_Status* tf_status = TF_NewStatus();
-  TF_OpKernelContext* tf_ctx = ctx->Get();
-  TF_VariableInputLockHolder* lockHolder = nullptr;
-  TF_MaybeLockVariableInputMutexesInOrder(tf_ctx, do_lock, sparse,
-                                          input_ids.data(), input_ids.size(),
-                                          copyFunc, &lockHolder, tf_status);
-
-  Status status = StatusFromTF_Status(tf_status);
-  ITEX_CHECK_OK(status);
-  TF_DeleteStatus(tf_status);
-
-  VariableInputLockHolderWrapper lock_wrapper(lockHolder);
-  return lock_wrapper;
-}
-
 // MaybeLockVariableInputMutexesInOrder is a helper function to acquire mutexes
 // in address order to mitigate deadlock.  Returns a structure that, when
 // deleted, will release the acquired mutexes. Safe to pass duplicates - will
@@ -136,44 +99,6 @@ VariableInputLockHolderWrapper MaybeLockVariableInputMutexesInOrder(
       ctx, do_lock, sparse, input_ids, DenseAssignWrapper<Device, T>);
 }
 
-inline VariableInputLockHolderWrapper MaybeLockVariableInputMutexesInOrder(
-    OpKernelContext* ctx, bool do_lock, bool sparse,
-    const std::vector<int>& input_ids) {
-  return MaybeLockVariableInputMutexesInOrderHelper(
-      ctx, do_lock, sparse, input_ids, EmptyCopyFunctor);
-}
-
-inline Status GetInputTensorFromVariableHelper(
-    OpKernelContext* ctx, int input, bool lock_held, bool sparse, Tensor* out,
-    void (*copyFunc)(TF_OpKernelContext* ctx, TF_Tensor* source,
-                     TF_Tensor* dest)) {
-  // TODO(itex): Currently, ITEX actually doesn't support Variant DataType.
-  // Add this check when we support such datatype.
-  bool is_variant_type = false;
-  TF_Status* tf_status = TF_NewStatus();
-  TF_OpKernelContext* tf_ctx = ctx->Get();
-  TF_Tensor* tf_tensor = nullptr;
-
-  // For ref tensor or dense tensor, the 3th, 4th, 5th arguments are actually
-  // useless.
-  TF_GetInputTensorFromVariable(tf_ctx, input, lock_held, is_variant_type,
-                                sparse, copyFunc, &tf_tensor, tf_status);
-
-  TensorShape shape;
-  auto dims = TF_NumDims(tf_tensor);
-  for (auto j = 0; j < dims; ++j) {
-    shape.AddDim(TF_Dim(tf_tensor, j));
-  }
-
-  *out =
-      Tensor(static_cast<DataType>(TF_TensorType(tf_tensor)), shape, tf_tensor);
-
-  Status status = StatusFromTF_Status(tf_status);
-  ITEX_CHECK_OK(status);
-  TF_DeleteStatus(tf_status);
-  return status;
-}
-
 // This gives you `*out`, a tensor you can update, corresponding to a variable
 // passed as input index `input`.  This handles the differences between
 // reference and resource variables. For reference variables we can just grab
@@ -193,13 +118,6 @@ Status GetInputTensorFromVariable(OpKernelContext* ctx, int input,
                                           DenseAssignWrapper<Device, T>);
 }
 
-inline Status GetInputTensorFromVariable(OpKernelContext* ctx, int input,
-                                         bool lock_held, bool sparse,
-                                         Tensor* out) {
-  return GetInputTensorFromVariableHelper(ctx, input, lock_held, sparse, out,
-                                          EmptyCopyFunctor);
-}
-
 void MaybeForwardRefInputToRefOutput(OpKernelContext* ctx, int input,
                                      int output);
 
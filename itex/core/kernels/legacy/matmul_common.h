@@ -28,6 +28,7 @@ limitations under the License.
 #include "itex/core/kernels/onednn/block/quantized_ops.h"
 #include "itex/core/utils/errors.h"
 #include "itex/core/utils/logging.h"
+#include "itex/core/utils/memory_profiler.h"
 #include "itex/core/utils/onednn/onednn_layout_util.h"
 #include "itex/core/utils/onednn/onednn_post_op_util.h"
 #include "itex/core/utils/onednn/onednn_util.h"
@@ -131,7 +132,7 @@ class LegacyOneDnnQuantizedMatMulOpBase : public OpKernel {
       auto fwd_pd = dnnl::inner_product_forward::primitive_desc(
           fwd_desc, post_ops_attr, onednn_engine);
 #endif
-      auto fwd_primitive = dnnl::inner_product_forward(fwd_pd);
+      auto fwd_primitive = CreatePrimitive<dnnl::inner_product_forward>(fwd_pd);
 
       // Allocate output Tensor.
       OneDnnShape dst_onednn_shape;
@@ -261,7 +262,7 @@ class LegacyOneDnnQuantizedMatMulOpBase : public OpKernel {
 
       fwd_primitive_args.emplace(DNNL_ARG_BIAS, bias_mem);
 
-      fwd_primitive.execute(onednn_stream, fwd_primitive_args);
+      ExecutePrimitive(fwd_primitive, onednn_stream, fwd_primitive_args);
     } catch (dnnl::error& e) {
       string error_msg = itex::strings::StrCat(
           "Status: ", e.status, ", message: ", string(e.message), ", in file ",
@@ -393,6 +394,7 @@ class LegacyOneDnnQuantizedMatMulOpBase : public OpKernel {
     if (bias_cached_data_.IsInitialized()) {
       return;
     }
+    ScopedMemoryKind cache_kind(MemoryKind::kCache);
     Tensor* bias_cached_tensor = nullptr;
     OP_REQUIRES_OK(context, context->allocate_persistent(
                                 temp_scaled_bias_tensor.dtype(),
@@ -596,7 +598,8 @@ class LegacyOneDnnQuantizedMatMulOpBase : public OpKernel {
             dnnl::memory(scaled_bias_md, onednn_engine, scaled_bias_buf);
 
         auto reorder_prim =
-            dnnl::reorder(input_bias_mem, scaled_bias_mem, bias_attr);
+            CreatePrimitive<dnnl::reorder>(input_bias_mem, scaled_bias_mem,
+                                           bias_attr);
         std::unordered_map<int, memory> reorder_net_args = {
             {DNNL_ARG_SRC, input_bias_mem},
             {DNNL_ARG_DST, scaled_bias_mem},
@@ -606,7 +609,7 @@ class LegacyOneDnnQuantizedMatMulOpBase : public OpKernel {
 #endif
         };
         auto onednn_stream = CreateDnnlStream(*context, onednn_engine);
-        reorder_prim.execute(onednn_stream, reorder_net_args);
+        ExecutePrimitive(reorder_prim, onednn_stream, reorder_net_args);
       }
 
       // Cache the scaled bias
@@ -761,7 +764,7 @@ class LegacyOneDnnQuantizedMatMulOpBase<Device, Tinput, Tweight, qint32,
       auto fwd_pd = dnnl::inner_product_forward::primitive_desc(
           onednn_engine, dnnl::prop_kind::forward_inference, src_exec_md,
           weight_exec_md, bias_exec_md, dst_exec_md, post_ops_attr);
-      auto fwd_primitive = dnnl::inner_product_forward(fwd_pd);
+      auto fwd_primitive = CreatePrimitive<dnnl::inner_product_forward>(fwd_pd);
 
       // Allocate output Tensor.
       OneDnnShape dst_onednn_shape;
@@ -891,7 +894,7 @@ class LegacyOneDnnQuantizedMatMulOpBase<Device, Tinput, Tweight, qint32,
 
       fwd_primitive_args.emplace(DNNL_ARG_BIAS, bias_mem);
 
-      fwd_primitive.execute(onednn_stream, fwd_primitive_args);
+      ExecutePrimitive(fwd_primitive, onednn_stream, fwd_primitive_args);
     } catch (dnnl::error& e) {
       string error_msg = itex::strings::StrCat(
           "Status: ", e.status, ", message: ", string(e.message), ", in file ",
@@ -1023,6 +1026,7 @@ class LegacyOneDnnQuantizedMatMulOpBase<Device, Tinput, Tweight, qint32,
     if (bias_cached_data_.IsInitialized()) {
       return;
     }
+    ScopedMemoryKind cache_kind(MemoryKind::kCache);
     Tensor* bias_cached_tensor = nullptr;
     OP_REQUIRES_OK(context, context->allocate_persistent(
                                 temp_scaled_bias_tensor.dtype(),
@@ -1212,13 +1216,14 @@ class LegacyOneDnnQuantizedMatMulOpBase<Device, Tinput, Tweight, qint32,
             dnnl::memory(scaled_bias_md, onednn_engine, scaled_bias_buf);
 
         auto reorder_prim =
-            dnnl::reorder(input_bias_mem, scaled_bias_mem, bias_attr);
+            CreatePrimitive<dnnl::reorder>(input_bias_mem, scaled_bias_mem,
+                                           bias_attr);
         std::unordered_map<int, memory> reorder_net_args = {
             {DNNL_ARG_SRC, input_bias_mem},
             {DNNL_ARG_DST, scaled_bias_mem},
             {DNNL_ARG_ATTR_SCALES | DNNL_ARG_SRC, bias_scales_mem}};
         auto onednn_stream = CreateDnnlStream(*context, onednn_engine);
-        reorder_prim.execute(onednn_stream, reorder_net_args);
+        ExecutePrimitive(reorder_prim, onednn_stream, reorder_net_args);
       }
 
       // Cache the scaled bias
@@ -270,7 +270,7 @@ class OneDnnAddNOp : public OpKernel {
                                    output_tf_shape, output_onednn_shape);
 
       // Create Sum op, and submit for execution.
-      dnnl::sum sum_op(sum_pd);
+      dnnl::sum sum_op = CreatePrimitive<dnnl::sum>(sum_pd);
       dnnl::memory dst_mem = CreateDnnlMemory(sum_pd.dst_desc(), onednn_engine,
                                               GetTensorBuffer<T>(dst_tensor));
       std::unordered_map<int, dnnl::memory> net_args = {
@@ -301,7 +301,7 @@ class OneDnnAddNOp : public OpKernel {
       }
 
       auto onednn_stream = CreateDnnlStream(*context, onednn_engine);
-      sum_op.execute(onednn_stream, net_args);
+      ExecutePrimitive(sum_op, onednn_stream, net_args);
     } catch (dnnl::error& e) {
       string error_msg = "Status: " + std::to_string(e.status) +
                          ", message: " + string(e.message) + ", in file " +
@@ -181,7 +181,7 @@ class OneDnnBatchMatMulV2Op : public OneDnnMatMulBaseOp<Device, Trhs> {
       auto fwd_pd =
           GetPrimitiveDesc(context, src_fwd_md, wei_fwd_md, bias_md, dst_fwd_md,
                            &fwd_primitive_args, onednn_engine);
-      auto fwd_primitive = matmul(fwd_pd);
+      auto fwd_primitive = CreatePrimitive<matmul>(fwd_pd);
 
       // Create src memory, check if src needs to be reordered
       memory src_mem = CreateDnnlMemory(src_md, onednn_engine,
@@ -310,7 +310,7 @@ class OneDnnBatchMatMulV2Op : public OneDnnMatMulBaseOp<Device, Trhs> {
                                    scale_mem);
       }
 #endif
-      fwd_primitive.execute(onednn_stream, fwd_primitive_args);
+      ExecutePrimitive(fwd_primitive, onednn_stream, fwd_primitive_args);
     } catch (dnnl::error& e) {
       string error_msg = "Status: " + std::to_string(e.status) +
                          ", message: " + string(e.message) + ", in file " +
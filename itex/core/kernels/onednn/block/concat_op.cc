@@ -335,7 +335,7 @@ class OneDnnConcatOp : public OpKernel {
                                    output_tf_shape, output_onednn_shape);
 
       // Create Concat op, and submit for execution.
-      dnnl::concat concat_prim = dnnl::concat(concat_pd);
+      dnnl::concat concat_prim = CreatePrimitive<dnnl::concat>(concat_pd);
       dnnl::memory dst_mem = CreateDnnlMemory(
           concat_pd.dst_desc(), onednn_engine, GetTensorBuffer<T>(dst_tensor));
       std::unordered_map<int, dnnl::memory> net_args = {
@@ -349,7 +349,7 @@ class OneDnnConcatOp : public OpKernel {
       }
 
       auto onednn_stream = CreateDnnlStream(*context, onednn_engine);
-      concat_prim.execute(onednn_stream, net_args);
+      ExecutePrimitive(concat_prim, onednn_stream, net_args);
     } catch (dnnl::error& e) {
       string error_msg = "Status: " + std::to_string(e.status) +
                          ", message: " + string(e.message) + ", in file " +
@@ -382,7 +382,8 @@ class OneDnnConvBackpropFilterOp
       bwd_filter_primitive_args.insert({DNNL_ARG_SCRATCHPAD, scratchpad_mem});
 
       primitive bwd_filter_primitive = ConvBwdFilterPrimitive(bwd_filter_pd);
-      bwd_filter_primitive.execute(onednn_stream, bwd_filter_primitive_args);
+      ExecutePrimitive(bwd_filter_primitive, onednn_stream,
+                       bwd_filter_primitive_args);
 
       // Reorder diff_weight.
       auto diff_filter_mem =
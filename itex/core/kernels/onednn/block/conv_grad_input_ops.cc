@@ -269,7 +269,8 @@ class OneDnnConvBackpropInputOp
 
       // Create convolution backward input primitive and add it to the net.
       primitive bwd_input_primitive = ConvBwdInputPrimitive(bwd_input_pd);
-      bwd_input_primitive.execute(onednn_stream, bwd_input_primitive_args);
+      ExecutePrimitive(bwd_input_primitive, onednn_stream,
+                       bwd_input_primitive_args);
     } catch (dnnl::error& e) {
       string error_msg = "Status: " + std::to_string(e.status) +
                          ", message: " + string(e.message) + ", in file " +
@@ -156,7 +156,7 @@ class OneDnnConvOp : public OpKernel {
       src_mem_input_.set_data_handle(context->tensor_data(kSrcIndex_));
       src_mem_.set_data_handle(
           GetTensorBuffer<Tinput>(this->src_data_output_.get()));
-      src_reorder_.execute(onednn_stream_, src_reorder_args_);
+      ExecutePrimitive(src_reorder_, onednn_stream_, src_reorder_args_);
     } else {
       src_mem_.set_data_handle(context->tensor_data(kSrcIndex_));
     }
@@ -166,7 +166,7 @@ class OneDnnConvOp : public OpKernel {
         filter_mem_input_.set_data_handle(context->tensor_data(kFilterIndex_));
         filter_mem_.set_data_handle(GetTensorBuffer<Tfilter>(&tmp_weight_));
 
-        weight_reorder_.execute(onednn_stream_, weight_reorder_args_);
+        ExecutePrimitive(weight_reorder_, onednn_stream_, weight_reorder_args_);
       }
     } else {
       filter_mem_.set_data_handle(context->tensor_data(kFilterIndex_));
@@ -223,7 +223,7 @@ class OneDnnConvOp : public OpKernel {
           DNNL_ARG_ATTR_SCALES | DNNL_ARG_WEIGHTS, scales_mem);
     }
 #endif
-    fwd_primitive_.execute(onednn_stream_, fwd_primitives_args_);
+    ExecutePrimitive(fwd_primitive_, onednn_stream_, fwd_primitives_args_);
     src_data_output_.reset();
     scratchpad_tensor_.reset();
   }
@@ -432,7 +432,7 @@ class OneDnnConvOp : public OpKernel {
                             post_ops_attr);
 #endif
       }
-      fwd_primitive_ = dnnl::convolution_forward(fwd_pd_);
+      fwd_primitive_ = CreatePrimitive<dnnl::convolution_forward>(fwd_pd_);
 
       // Create a temp conv primitve desc to get real add md.
 #ifdef ITEX_ONEDNN_3_0
@@ -473,9 +473,9 @@ class OneDnnConvOp : public OpKernel {
         src_reorder_args_.clear();
         src_reorder_args_.insert({DNNL_ARG_SRC, src_mem_input_});
         src_reorder_args_.insert({DNNL_ARG_DST, src_mem_});
-        src_reorder_ = dnnl::reorder(src_mem_input_, src_mem_);
+        src_reorder_ = CreatePrimitive<dnnl::reorder>(src_mem_input_, src_mem_);
 
-        src_reorder_.execute(onednn_stream_, src_reorder_args_);
+        ExecutePrimitive(src_reorder_, onednn_stream_, src_reorder_args_);
       } else {
         src_mem_ = src_mem_input_;
       }
@@ -513,8 +513,10 @@ class OneDnnConvOp : public OpKernel {
           weight_reorder_args_.clear();
           weight_reorder_args_.insert({DNNL_ARG_SRC, filter_mem_input_});
           weight_reorder_args_.insert({DNNL_ARG_DST, filter_mem_});
-          weight_reorder_ = dnnl::reorder(filter_mem_input_, filter_mem_);
-          weight_reorder_.execute(onednn_stream_, weight_reorder_args_);
+          weight_reorder_ =
+              CreatePrimitive<dnnl::reorder>(filter_mem_input_, filter_mem_);
+          ExecutePrimitive(weight_reorder_, onednn_stream_,
+                           weight_reorder_args_);
         }
       } else {
         filter_mem_ = filter_mem_input_;
@@ -1282,7 +1284,7 @@ class OneDnnQuantizedConvSumReluOp
                                       this->onednn_engine_, dst_buf);
 
     dnnl::reorder summand_scaled_primitive =
-        dnnl::reorder(summand_mem, dst_mem, reorder_attr);
+        CreatePrimitive<dnnl::reorder>(summand_mem, dst_mem, reorder_attr);
     std::unordered_map<int, dnnl::memory> reorder_args = {
         {DNNL_ARG_SRC, summand_mem},
         {DNNL_ARG_DST, dst_mem},
@@ -1291,7 +1293,7 @@ class OneDnnQuantizedConvSumReluOp
 #endif
     };
     auto onednn_stream = CreateDnnlStream(*context, this->onednn_engine_);
-    summand_scaled_primitive.execute(onednn_stream, reorder_args);
+    ExecutePrimitive(summand_scaled_primitive, onednn_stream, reorder_args);
   }
 
  protected:
@@ -1463,7 +1465,8 @@ class OneDnnQuantizeV2WithQuantizedConv2DOp
       this->src_mem_.set_data_handle(
           GetTensorBuffer<qint8>(this->src_data_output_.get()));
 
-      this->src_reorder_.execute(this->onednn_stream_, this->src_reorder_args_);
+      ExecutePrimitive(this->src_reorder_, this->onednn_stream_,
+                       this->src_reorder_args_);
     } else {
       this->src_mem_.set_data_handle(context->tensor_data(this->kSrcIndex_));
     }
@@ -1475,8 +1478,8 @@ class OneDnnQuantizeV2WithQuantizedConv2DOp
         this->filter_mem_.set_data_handle(
             GetTensorBuffer<qint8>(&this->tmp_weight_));
 
-        this->weight_reorder_.execute(this->onednn_stream_,
-                                      this->weight_reorder_args_);
+        ExecutePrimitive(this->weight_reorder_, this->onednn_stream_,
+                         this->weight_reorder_args_);
       }
     } else {
       this->filter_mem_.set_data_handle(
@@ -1680,7 +1683,8 @@ class OneDnnQuantizeV2WithQuantizedConv2DOp
 #endif
       }
 
-      this->fwd_primitive_ = dnnl::convolution_forward(this->fwd_pd_);
+      this->fwd_primitive_ =
+          CreatePrimitive<dnnl::convolution_forward>(this->fwd_pd_);
 
       // Create a temp conv primitve desc to get real add dst md.
 #ifdef ITEX_ONEDNN_3_0
@@ -1798,10 +1802,10 @@ class OneDnnQuantizeV2WithQuantizedConv2DOp
             dnnl::reorder::primitive_desc(
                 this->onednn_engine_, src_md, this->onednn_engine_,
                 this->fwd_pd_.src_desc(), reorder_post_ops_attr);
-        this->src_reorder_ = dnnl::reorder(reorder_pd);
+        this->src_reorder_ = CreatePrimitive<dnnl::reorder>(reorder_pd);
 
-        this->src_reorder_.execute(this->onednn_stream_,
-                                   this->src_reorder_args_);
+        ExecutePrimitive(this->src_reorder_, this->onednn_stream_,
+                         this->src_reorder_args_);
       } else {
         this->src_mem_ = this->src_mem_input_;
       }
@@ -1844,10 +1848,11 @@ class OneDnnQuantizeV2WithQuantizedConv2DOp
               {DNNL_ARG_SRC, this->filter_mem_input_});
           this->weight_reorder_args_.insert({DNNL_ARG_DST, this->filter_mem_});
           this->weight_reorder_ =
-              dnnl::reorder(this->filter_mem_input_, this->filter_mem_);
+              CreatePrimitive<dnnl::reorder>(
+                  this->filter_mem_input_, this->filter_mem_);
 
-          this->weight_reorder_.execute(this->onednn_stream_,
-                                        this->weight_reorder_args_);
+          ExecutePrimitive(this->weight_reorder_, this->onednn_stream_,
+                           this->weight_reorder_args_);
         }
       } else {
         this->filter_mem_ = this->filter_mem_input_;
@@ -1919,8 +1924,8 @@ class OneDnnQuantizeV2WithQuantizedConv2DOp
     }
 #endif
 
-    this->fwd_primitive_.execute(this->onednn_stream_,
-                                 this->fwd_primitives_args_);
+    ExecutePrimitive(this->fwd_primitive_, this->onednn_stream_,
+                     this->fwd_primitives_args_);
 
     this->scratchpad_tensor_.reset();
     float min_input = min_range[0];
@@ -169,7 +169,7 @@ class OneDnnBinaryOp : public BinaryOp<Device, Functor> {
         auto binary_pd =
             dnnl::binary::primitive_desc(binary_d, attr, onednn_engine);
 #endif
-        auto binary_prim = dnnl::binary(binary_pd);
+        auto binary_prim = CreatePrimitive<dnnl::binary>(binary_pd);
 
         Tensor scratchpad_tensor;
         int64 scratchpad_size =
@@ -190,7 +190,7 @@ class OneDnnBinaryOp : public BinaryOp<Device, Functor> {
         binary_args.insert({DNNL_ARG_SCRATCHPAD, scratchpad_mem});
 
         // primitive execution
-        binary_prim.execute(onednn_stream, binary_args);
+        ExecutePrimitive(binary_prim, onednn_stream, binary_args);
       } catch (dnnl::error& e) {
         string error_msg = "Status: " + std::to_string(e.status) +
                            ", message: " + string(e.message) + ", in file " +
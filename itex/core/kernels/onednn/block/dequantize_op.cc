@@ -174,7 +174,7 @@ class OneDnnDequantizeOp : public OpKernel {
       // Create Reorder primitive
       auto fwd_pd = reorder::primitive_desc(
           onednn_engine, src_md, onednn_engine, dst_md, post_ops_attr);
-      auto fwd_primitive = reorder(fwd_pd);
+      auto fwd_primitive = CreatePrimitive<reorder>(fwd_pd);
 
       // Set output OneDnn shape
       OneDnnShape dst_onednn_shape;
@@ -205,7 +205,7 @@ class OneDnnDequantizeOp : public OpKernel {
           {DNNL_ARG_ATTR_ZERO_POINTS | DNNL_ARG_SRC, zero_points_mem},
 #endif
       };
-      fwd_primitive.execute(onednn_stream, fwd_primitive_args);
+      ExecutePrimitive(fwd_primitive, onednn_stream, fwd_primitive_args);
     } catch (dnnl::error& e) {
       string error_msg = "Status: " + std::to_string(e.status) +
                          ", message: " + string(e.message) + ", in file " +
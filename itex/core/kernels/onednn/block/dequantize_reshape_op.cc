@@ -170,7 +170,7 @@ class OneDnnDequantizeReshapeOp : public OpKernel {
       // Create Reorder primitive
       auto fwd_pd = reorder::primitive_desc(
           onednn_engine, src_md, onednn_engine, dst_md, post_ops_attr);
-      auto fwd_primitive = reorder(fwd_pd);
+      auto fwd_primitive = CreatePrimitive<reorder>(fwd_pd);
 
       // Compute the output shape.  Determine product of specified
       // dimensions, and find the index of the unspecified one.
@@ -248,7 +248,7 @@ class OneDnnDequantizeReshapeOp : public OpKernel {
 #endif
       };
 
-      fwd_primitive.execute(onednn_stream, fwd_primitive_args);
+      ExecutePrimitive(fwd_primitive, onednn_stream, fwd_primitive_args);
     } catch (dnnl::error& e) {
       string error_msg = "Status: " + std::to_string(e.status) +
                          ", message: " + string(e.message) + ", in file " +
@@ -95,7 +95,7 @@ class OneDnnEltwiseBaseOp : public OpKernel {
       auto fwd_pd =
           eltwise_forward::primitive_desc(fwd_desc, attr, onednn_engine);
 #endif
-      auto fwd_primitive = eltwise_forward(fwd_pd);
+      auto fwd_primitive = CreatePrimitive<eltwise_forward>(fwd_pd);
 
       // Create src memory, check if src needs to be reordered
       const T* src_data = src_tensor.flat<T>().data();
@@ -156,7 +156,7 @@ class OneDnnEltwiseBaseOp : public OpKernel {
           {DNNL_ARG_SRC, is_src_reordered ? reorder_mem : src_mem},
           {DNNL_ARG_DST, dst_mem},
           {DNNL_ARG_SCRATCHPAD, scratchpad_mem}};
-      fwd_primitive.execute(onednn_stream, fwd_primitive_args);
+      ExecutePrimitive(fwd_primitive, onednn_stream, fwd_primitive_args);
     } catch (dnnl::error& e) {
       string error_msg = "Status: " + std::to_string(e.status) +
                          ", message: " + string(e.message) + ", in file " +
@@ -346,7 +346,8 @@ class OneDnnEltwiseGradBaseOp : public OpKernel {
       auto eltwise_bwd_pd = eltwise_backward::primitive_desc(
           bwd_desc, attr, onednn_engine, fwd_pd);
 #endif
-      auto eltwise_bwd_primitive = eltwise_backward(eltwise_bwd_pd);
+      auto eltwise_bwd_primitive =
+          CreatePrimitive<eltwise_backward>(eltwise_bwd_pd);
 
       dnnl::memory src_mem = CreateDnnlMemory(src_md, onednn_engine,
                                               GetTensorBuffer<T>(&src_tensor));
@@ -435,7 +436,8 @@ class OneDnnEltwiseGradBaseOp : public OpKernel {
            is_diff_dst_reordered ? diff_dst_reorder_mem : diff_dst_mem},
           {DNNL_ARG_DIFF_SRC, diff_src_mem},
           {DNNL_ARG_SCRATCHPAD, scratchpad_mem}};
-      eltwise_bwd_primitive.execute(onednn_stream, bwd_primitives_args);
+      ExecutePrimitive(eltwise_bwd_primitive, onednn_stream,
+                       bwd_primitives_args);
     } catch (dnnl::error& e) {
       string error_msg = "Status: " + std::to_string(e.status) +
                          ", message: " + string(e.message) + ", in file " +
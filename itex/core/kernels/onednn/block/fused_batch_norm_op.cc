@@ -209,7 +209,8 @@ class OneDnnFusedBatchNormOp : public OpKernel {
       dnnl::batch_normalization_forward::primitive_desc bn_fwd_pd(
           bn_fwd_desc, attr, onednn_engine);
 #endif
-      dnnl::batch_normalization_forward bn_fwd_primitive(bn_fwd_pd);
+      dnnl::batch_normalization_forward bn_fwd_primitive =
+          CreatePrimitive<dnnl::batch_normalization_forward>(bn_fwd_pd);
 
       // Allocate output dst tensor.
       TensorShape dst_tf_shape;
@@ -355,7 +356,7 @@ class OneDnnFusedBatchNormOp : public OpKernel {
                        GetTensorBuffer<U>(&scratchpad_tensor));
       args.insert({DNNL_ARG_SCRATCHPAD, scratchpad_mem});
 
-      bn_fwd_primitive.execute(onednn_stream, args);
+      ExecutePrimitive(bn_fwd_primitive, onednn_stream, args);
       float adjust_factor = 1.0;
       if (is_training_) {
         size_t orig_size = src_dims[0] * src_dims[2] * src_dims[3];
@@ -747,7 +748,8 @@ class OneDnnFusedBatchNormGradOp : public OpKernel {
       dnnl::batch_normalization_backward::primitive_desc bn_bwd_pd(
           bn_bwd_desc, attr, onednn_engine, bn_fwd_pd);
 #endif
-      dnnl::batch_normalization_backward bn_bwd_primitive(bn_bwd_pd);
+      dnnl::batch_normalization_backward bn_bwd_primitive =
+          CreatePrimitive<dnnl::batch_normalization_backward>(bn_bwd_pd);
 
       // Allocate diff_src tensor.
       TensorShape diff_src_tf_shape;
@@ -883,7 +885,7 @@ class OneDnnFusedBatchNormGradOp : public OpKernel {
           dnnl::memory(bn_bwd_pd.scratchpad_desc(), onednn_engine,
                        GetTensorBuffer<U>(&scratchpad_tensor));
       args.insert({DNNL_ARG_SCRATCHPAD, scratchpad_mem});
-      bn_bwd_primitive.execute(onednn_stream, args);
+      ExecutePrimitive(bn_bwd_primitive, onednn_stream, args);
     } catch (dnnl::error& e) {
       string error_msg = "Status:" + std::to_string(e.status) +
                          ", message: " + string(e.message) + ", in file " +
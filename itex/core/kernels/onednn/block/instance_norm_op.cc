@@ -250,7 +250,8 @@ class OneDnnInstanceNormOp : public OpKernel {
 #endif
       }
 
-      dnnl::batch_normalization_forward bn_fwd_primitive(bn_fwd_pd);
+      dnnl::batch_normalization_forward bn_fwd_primitive =
+          CreatePrimitive<dnnl::batch_normalization_forward>(bn_fwd_pd);
 
       // Allocate output dst tensor.
       TensorShape dst_tf_shape = src_tf_shape;
@@ -302,7 +303,7 @@ class OneDnnInstanceNormOp : public OpKernel {
             const_cast<T*>(src_buf_batch + i * elems_per_batch)));
         dst_mem.set_data_handle(static_cast<void*>(
             const_cast<T*>(dst_buf_batch + i * elems_per_batch)));
-        bn_fwd_primitive.execute(onednn_stream, args);
+        ExecutePrimitive(bn_fwd_primitive, onednn_stream, args);
       }
     } catch (dnnl::error& e) {
       string error_msg = "Status:" + std::to_string(e.status) +
@@ -177,7 +177,8 @@ class OneDnnLayerNormOp : public OpKernel {
       dnnl::layer_normalization_forward::primitive_desc ln_fwd_pd(
           ln_fwd_desc, attr, onednn_engine);
 #endif
-      dnnl::layer_normalization_forward ln_fwd_primitive(ln_fwd_pd);
+      dnnl::layer_normalization_forward ln_fwd_primitive =
+          CreatePrimitive<dnnl::layer_normalization_forward>(ln_fwd_pd);
 
       // Allocate output dst tensor.
       TensorShape dst_tf_shape = src_tensor.shape();
@@ -297,7 +298,7 @@ class OneDnnLayerNormOp : public OpKernel {
                        GetTensorBuffer<U>(&scratchpad_tensor));
       args.insert({DNNL_ARG_SCRATCHPAD, scratchpad_mem});
 
-      ln_fwd_primitive.execute(onednn_stream, args);
+      ExecutePrimitive(ln_fwd_primitive, onednn_stream, args);
     } catch (dnnl::error& e) {
       string error_msg = "Status:" + std::to_string(e.status) +
                          ", message: " + string(e.message) + ", in file " +
@@ -504,7 +505,8 @@ class OneDnnLayerNormGradOp : public OpKernel {
       dnnl::layer_normalization_backward::primitive_desc ln_bwd_pd(
           ln_bwd_desc, attr, onednn_engine, ln_fwd_pd);
 #endif
-      dnnl::layer_normalization_backward ln_bwd_primitive(ln_bwd_pd);
+      dnnl::layer_normalization_backward ln_bwd_primitive =
+          CreatePrimitive<dnnl::layer_normalization_backward>(ln_bwd_pd);
 
       bool set_onednn_tensor = true;
       if (diff_dst_shape_dims == 4 && !src_onednn_shape.IsOneDnnTensor())
@@ -614,7 +616,7 @@ class OneDnnLayerNormGradOp : public OpKernel {
                        GetTensorBuffer<U>(&scratchpad_tensor));
       args.insert({DNNL_ARG_SCRATCHPAD, scratchpad_mem});
 
-      ln_bwd_primitive.execute(onednn_stream, args);
+      ExecutePrimitive(ln_bwd_primitive, onednn_stream, args);
     } catch (dnnl::error& e) {
       string error_msg = "Status:" + std::to_string(e.status) +
                          ", message: " + string(e.message) + ", in file " +
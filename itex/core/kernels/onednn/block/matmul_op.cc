@@ -296,7 +296,7 @@ class OneDnnMatMulOp : public OneDnnMatMulBaseOp<Device, T> {
             matmul::primitive_desc(matmul_d, post_op_attr, onednn_engine_);
 #endif
       }
-      fwd_primitive_ = matmul(fwd_pd_);
+      fwd_primitive_ = CreatePrimitive<matmul>(fwd_pd_);
       // Create src memory, check if src needs to be reordered
       src_mem_ = CreateDnnlMemory(src_md, onednn_engine_,
                                   GetTensorBuffer<T>(&src_tensor));
@@ -468,7 +468,7 @@ class OneDnnMatMulOp : public OneDnnMatMulBaseOp<Device, T> {
       return;
     }
 
-    fwd_primitive_.execute(onednn_stream_, fwd_primitive_args_);
+    ExecutePrimitive(fwd_primitive_, onednn_stream_, fwd_primitive_args_);
     scratchpad_tensor_.reset();
   }
 
@@ -620,7 +620,7 @@ class OneDnnFusedMatMulGradOp : public OpKernel {
           bwd_desc, attr, onednn_engine, fwd_pd);
 #endif
       auto matmul_bwd_primitive =
-          dnnl::inner_product_backward_weights(matmul_bwd_pd);
+          CreatePrimitive<dnnl::inner_product_backward_weights>(matmul_bwd_pd);
 
       // Allocate output tensors.
       Tensor* diff_weight_tensor = nullptr;
@@ -729,7 +729,7 @@ class OneDnnFusedMatMulGradOp : public OpKernel {
            is_diff_weight_reordered ? diff_weight_mem_tmp : diff_weight_mem},
           {DNNL_ARG_DIFF_BIAS, diff_bias_mem},
           {DNNL_ARG_SCRATCHPAD, scratchpad_mem}};
-      matmul_bwd_primitive.execute(onednn_stream, bwd_primitive_args);
+      ExecutePrimitive(matmul_bwd_primitive, onednn_stream, bwd_primitive_args);
 
       if (is_diff_weight_reordered) {
         ReorderMemory(*context, &diff_weight_mem_tmp, &diff_weight_mem,
@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 
 #include "itex/core/utils/errors.h"
+#include "itex/core/utils/kernel_metrics.h"
 #include "itex/core/utils/onednn/onednn_layout_util.h"
 #include "itex/core/utils/onednn/onednn_util.h"
 #include "itex/core/utils/op_kernel.h"
@@ -88,6 +89,7 @@ class OneDnnToTfOp : public OpKernel {
       auto reorder_mem = CreateDnnlMemory(src_tf_md, onednn_engine,
                                           static_cast<void*>(dst_data));
       ReorderMemory(*context, &src_mem, &reorder_mem, onednn_engine);
+      metrics::RecordOneDnnToTf(dst_tensor->TotalBytes());
     } catch (dnnl::error& e) {
       OP_REQUIRES_OK(
           context,
@@ -138,7 +138,7 @@ class OneDnnPoolOp : public OneDnnPoolOpBase<T> {
           dnnl::memory(fwd_pd.scratchpad_desc(), onednn_engine,
                        GetTensorBuffer<T>(&scratchpad_tensor));
 
-      auto fwd_primitive = pooling_forward(fwd_pd);
+      auto fwd_primitive = CreatePrimitive<pooling_forward>(fwd_pd);
 
       // Allocate output.
       // MaxPool may prefer plain format as its primitive format.
@@ -175,13 +175,13 @@ class OneDnnPoolOp : public OneDnnPoolOpBase<T> {
             {DNNL_ARG_DST, dst_mem},
             {DNNL_ARG_WORKSPACE, ws_mem},
             {DNNL_ARG_SCRATCHPAD, scratchpad_mem}};
-        fwd_primitive.execute(onednn_stream, fwd_primitive_args);
+        ExecutePrimitive(fwd_primitive, onednn_stream, fwd_primitive_args);
       } else if (alg == dnnl::algorithm::pooling_avg_exclude_padding) {
         std::unordered_map<int, memory> fwd_primitive_args = {
             {DNNL_ARG_SRC, src_mem},
             {DNNL_ARG_DST, dst_mem},
             {DNNL_ARG_SCRATCHPAD, scratchpad_mem}};
-        fwd_primitive.execute(onednn_stream, fwd_primitive_args);
+        ExecutePrimitive(fwd_primitive, onednn_stream, fwd_primitive_args);
       } else {
         ITEX_LOG(FATAL) << "Unsupported pooling algorithm";
       }
@@ -321,7 +321,7 @@ class OneDnnPoolGradOp : public OneDnnPoolOpBase<T> {
           dnnl::memory(pooling_bwd_pd.scratchpad_desc(), onednn_engine,
                        GetTensorBuffer<T>(&scratchpad_tensor));
 
-      auto bwd_primitive = pooling_backward(pooling_bwd_pd);
+      auto bwd_primitive = CreatePrimitive<pooling_backward>(pooling_bwd_pd);
 
       // Allocate output tensor.
       Tensor* diff_src_tensor = nullptr;
@@ -374,14 +374,14 @@ class OneDnnPoolGradOp : public OneDnnPoolOpBase<T> {
              {DNNL_ARG_WORKSPACE, ws_mem},
              {DNNL_ARG_DIFF_SRC, diff_src_mem},
              {DNNL_ARG_SCRATCHPAD, scratchpad_mem}}};
-        bwd_primitive.execute(onednn_stream, bwd_primitive_args);
+        ExecutePrimitive(bwd_primitive, onednn_stream, bwd_primitive_args);
       } else if (alg == dnnl::algorithm::pooling_avg_exclude_padding) {
         std::unordered_map<int, memory> bwd_primitive_args = {
             {{DNNL_ARG_DIFF_DST,
               is_diff_dst_reordered ? diff_dst_reorder_mem : diff_dst_mem},
              {DNNL_ARG_DIFF_SRC, diff_src_mem},
              {DNNL_ARG_SCRATCHPAD, scratchpad_mem}}};
-        bwd_primitive.execute(onednn_stream, bwd_primitive_args);
+        ExecutePrimitive(bwd_primitive, onednn_stream, bwd_primitive_args);
       } else {
         ITEX_LOG(FATAL) << "Unsupported pooling algorithm";
       }
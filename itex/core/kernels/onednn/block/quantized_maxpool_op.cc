@@ -117,7 +117,7 @@ class OneDnnQuantizedMaxPoolOp : public OneDnnPoolOpBase<T> {
           dnnl::memory(fwd_pd.scratchpad_desc(), onednn_engine,
                        GetTensorBuffer<T>(&scratchpad_tensor));
 
-      auto fwd_primitive = pooling_forward(fwd_pd);
+      auto fwd_primitive = CreatePrimitive<pooling_forward>(fwd_pd);
 
       // Allocate output.
       SetOutputTensorShape(fwd_pd.dst_desc(), this->tensor_format_onednn_,
@@ -136,7 +136,7 @@ class OneDnnQuantizedMaxPoolOp : public OneDnnPoolOpBase<T> {
           {DNNL_ARG_SRC, src_mem},
           {DNNL_ARG_DST, dst_mem},
           {DNNL_ARG_SCRATCHPAD, scratchpad_mem}};
-      fwd_primitive.execute(onednn_stream, fwd_primitive_args);
+      ExecutePrimitive(fwd_primitive, onednn_stream, fwd_primitive_args);
 
       // Pass min, max from input to output.
       const Tensor& min_input_t = context->input(1);
@@ -136,7 +136,7 @@ class OneDnnRequantizePerChannelOp : public OpKernel {
       auto dst_mem = CreateDnnlMemory(output_md, onednn_engine, output_buf);
 
       dnnl::reorder reorder_prim =
-          dnnl::reorder(src_mem, dst_mem, reorder_attr);
+          CreatePrimitive<dnnl::reorder>(src_mem, dst_mem, reorder_attr);
       auto onednn_stream = CreateDnnlStream(*context, onednn_engine);
       std::unordered_map<int, memory> reorder_args = {
           {DNNL_ARG_SRC, src_mem},
@@ -145,7 +145,7 @@ class OneDnnRequantizePerChannelOp : public OpKernel {
           {DNNL_ARG_ATTR_SCALES | DNNL_ARG_SRC, output_scales_mem},
 #endif
       };
-      reorder_prim.execute(onednn_stream, reorder_args);
+      ExecutePrimitive(reorder_prim, onednn_stream, reorder_args);
 
       Tensor* output_min = nullptr;
       Tensor* output_max = nullptr;
@@ -147,7 +147,7 @@ class OneDnnResizeOp : public OpKernel {
           dnnl::memory(fwd_pd.scratchpad_desc(), onednn_engine,
                        GetTensorBuffer<InputT>(&scratchpad_tensor));
 
-      auto fwd_primitive = dnnl::resampling_forward(fwd_pd);
+      auto fwd_primitive = CreatePrimitive<dnnl::resampling_forward>(fwd_pd);
 
       dnnl::memory src_mem = dnnl::memory(src_md, onednn_engine,
                                           GetTensorBuffer<InputT>(&src_tensor));
@@ -187,7 +187,7 @@ class OneDnnResizeOp : public OpKernel {
           {DNNL_ARG_DST, dst_mem},
           {DNNL_ARG_SCRATCHPAD, scratchpad_mem}};
 
-      fwd_primitive.execute(onednn_stream, fwd_primitive_args);
+      ExecutePrimitive(fwd_primitive, onednn_stream, fwd_primitive_args);
     } catch (dnnl::error& e) {
       string error_msg = "Status: " + std::to_string(e.status) +
                          ", message: " + string(e.message) + ", in file " +
@@ -409,8 +409,8 @@ class OneDnnResizeGradOp : public OpKernel {
         bwd_primitive_args.insert({DNNL_ARG_SRC, src_mem});
       }
 
-      auto bwd_primitive = dnnl::resampling_backward(bwd_pd);
-      bwd_primitive.execute(onednn_stream, bwd_primitive_args);
+      auto bwd_primitive = CreatePrimitive<dnnl::resampling_backward>(bwd_pd);
+      ExecutePrimitive(bwd_primitive, onednn_stream, bwd_primitive_args);
     } catch (dnnl::error& e) {
       string error_msg = "Status: " + std::to_string(e.status) +
                          ", message: " + string(e.message) + ", in file " +
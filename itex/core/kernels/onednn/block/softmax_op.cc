@@ -81,7 +81,7 @@ class OneDnnSoftmaxOp : public OpKernel {
       auto fwd_pd =
           softmax_forward::primitive_desc(fwd_desc, attr, onednn_engine);
 #endif
-      auto fwd_primitive = softmax_forward(fwd_pd);
+      auto fwd_primitive = CreatePrimitive<softmax_forward>(fwd_pd);
 
       // Create src memory
       T* src_data =
@@ -129,7 +129,7 @@ class OneDnnSoftmaxOp : public OpKernel {
           {DNNL_ARG_SRC, src_mem},
           {DNNL_ARG_DST, dst_mem},
           {DNNL_ARG_SCRATCHPAD, scratchpad_mem}};
-      fwd_primitive.execute(onednn_stream, fwd_primitive_args);
+      ExecutePrimitive(fwd_primitive, onednn_stream, fwd_primitive_args);
     } catch (dnnl::error& e) {
       string error_msg = "Status: " + std::to_string(e.status) +
                          ", message: " + string(e.message) + ", in file " +
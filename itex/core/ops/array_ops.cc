@@ -48,3 +48,46 @@ void Register_ITEXFusedDequantizeWithReshapeOp() {
         << "_ITEXFusedDequantizeWithReshape op registration failed: ";
   }
 }
+
+void Register_ITEXFP8QuantizeOp() {
+  itex::StatusUniquePtr status(TF_NewStatus());
+  {
+    TF_OpDefinitionBuilder* op_builder =
+        TF_NewOpDefinitionBuilder("_ITEXFP8Quantize");
+    TF_OpDefinitionBuilderAddInput(op_builder, "input: T");
+    // Per-tensor scale, output = fp8(input / scale).
+    TF_OpDefinitionBuilderAddInput(op_builder, "scale: float");
+    // FP8 values are carried as their uint8 bit patterns.
+    TF_OpDefinitionBuilderAddOutput(op_builder, "output: uint8");
+    TF_OpDefinitionBuilderAddAttr(op_builder,
+                                  "T: {bfloat16, float} = DT_FLOAT");
+    TF_OpDefinitionBuilderAddAttr(op_builder,
+                                  "fp8_format: {'E4M3', 'E5M2'} = 'E4M3'");
+    TF_OpDefinitionBuilderSetShapeInferenceFunction(op_builder,
+                                                    &unchanged_shape_fn);
+    TF_RegisterOpDefinition(op_builder, status.get());
+    ITEX_CHECK_EQ(TF_OK, TF_GetCode(status.get()))
+        << "_ITEXFP8Quantize op registration failed: ";
+  }
+}
+
+void Register_ITEXFP8DequantizeOp() {
+  itex::StatusUniquePtr status(TF_NewStatus());
+  {
+    TF_OpDefinitionBuilder* op_builder =
+        TF_NewOpDefinitionBuilder("_ITEXFP8Dequantize");
+    TF_OpDefinitionBuilderAddInput(op_builder, "input: uint8");
+    // Per-tensor scale, output = float(input) * scale.
+    TF_OpDefinitionBuilderAddInput(op_builder, "scale: float");
+    TF_OpDefinitionBuilderAddOutput(op_builder, "output: dtype");
+    TF_OpDefinitionBuilderAddAttr(op_builder,
+                                  "dtype: {bfloat16, float} = DT_FLOAT");
+    TF_OpDefinitionBuilderAddAttr(op_builder,
+                                  "fp8_format: {'E4M3', 'E5M2'} = 'E4M3'");
+    TF_OpDefinitionBuilderSetShapeInferenceFunction(op_builder,
+                                                    &unchanged_shape_fn);
+    TF_RegisterOpDefinition(op_builder, status.get());
+    ITEX_CHECK_EQ(TF_OK, TF_GetCode(status.get()))
+        << "_ITEXFP8Dequantize op registration failed: ";
+  }
+}
@@ -371,6 +371,92 @@ void Register_ITEXFusedMatMulOp() {
   }
 }
 
+void Register_ITEXWeightOnlyQuantMatMulOp() {
+  itex::StatusUniquePtr status(TF_NewStatus());
+  {
+    TF_OpDefinitionBuilder* op_builder =
+        TF_NewOpDefinitionBuilder("_ITEXWeightOnlyQuantMatMul");
+    // Activation in bf16/fp32 with shape [..., K].
+    TF_OpDefinitionBuilderAddInput(op_builder, "a: T");
+    // Quantized weight stored as [N, K] int8 or as [N, ceil(K / 2)] uint8
+    // with two unsigned 4-bit values per byte (low nibble holds even k).
+    TF_OpDefinitionBuilderAddInput(op_builder, "b: Tweight");
+    // Per-group scales and zero points with shape [N, ceil(K / group_size)].
+    TF_OpDefinitionBuilderAddInput(op_builder, "scales: float");
+    TF_OpDefinitionBuilderAddInput(op_builder, "zero_points: int8");
+    TF_OpDefinitionBuilderAddInput(op_builder, "args: num_args * T");
+    TF_OpDefinitionBuilderAddOutput(op_builder, "product: T");
+    TF_OpDefinitionBuilderAddAttr(op_builder,
+                                  "T: {bfloat16, float} = DT_FLOAT");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "Tweight: {int8, uint8}");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "weight_bits: int = 8");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "group_size: int >= 2 = 128");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "num_args: int >= 0");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "fused_ops: list(string) = []");
+    TF_OpDefinitionBuilderSetShapeInferenceFunction(op_builder,
+                                                    &unknown_shape_fn);
+    TF_RegisterOpDefinition(op_builder, status.get());
+    ITEX_CHECK_EQ(TF_OK, TF_GetCode(status.get()))
+        << "_ITEXWeightOnlyQuantMatMul op registration failed: ";
+  }
+}
+
+void Register_ITEXDynamicQuantizedMatMulOp() {
+  itex::StatusUniquePtr status(TF_NewStatus());
+  {
+    TF_OpDefinitionBuilder* op_builder =
+        TF_NewOpDefinitionBuilder("_ITEXDynamicQuantizedMatMul");
+    // Emitted for Const-weight MatMuls by the dynamic_quant graph pass when
+    // ITEX_DYNAMIC_QUANT=1.
+    // Activation in bf16/fp32 with shape [..., K], quantized per token inside
+    // the kernel.
+    TF_OpDefinitionBuilderAddInput(op_builder, "a: T");
+    // SCALED narrow-range weight with per-tensor or per-channel range.
+    TF_OpDefinitionBuilderAddInput(op_builder, "b: qint8");
+    TF_OpDefinitionBuilderAddInput(op_builder, "min_b: float");
+    TF_OpDefinitionBuilderAddInput(op_builder, "max_b: float");
+    TF_OpDefinitionBuilderAddInput(op_builder, "args: num_args * T");
+    TF_OpDefinitionBuilderAddOutput(op_builder, "product: T");
+    TF_OpDefinitionBuilderAddAttr(op_builder,
+                                  "T: {bfloat16, float} = DT_FLOAT");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "transpose_b: bool = false");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "is_weight_const: bool = false");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "num_args: int >= 0");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "fused_ops: list(string) = []");
+    TF_OpDefinitionBuilderSetShapeInferenceFunction(op_builder,
+                                                    &unknown_shape_fn);
+    TF_RegisterOpDefinition(op_builder, status.get());
+    ITEX_CHECK_EQ(TF_OK, TF_GetCode(status.get()))
+        << "_ITEXDynamicQuantizedMatMul op registration failed: ";
+  }
+}
+
+void Register_ITEXFP8WeightMatMulOp() {
+  itex::StatusUniquePtr status(TF_NewStatus());
+  {
+    TF_OpDefinitionBuilder* op_builder =
+        TF_NewOpDefinitionBuilder("_ITEXFP8WeightMatMul");
+    // Activation in bf16/fp32 with shape [..., K].
+    TF_OpDefinitionBuilderAddInput(op_builder, "a: T");
+    // FP8 weight bit patterns stored as [N, K] with a per-tensor scale.
+    TF_OpDefinitionBuilderAddInput(op_builder, "b: uint8");
+    TF_OpDefinitionBuilderAddInput(op_builder, "scale: float");
+    TF_OpDefinitionBuilderAddInput(op_builder, "args: num_args * T");
+    TF_OpDefinitionBuilderAddOutput(op_builder, "product: T");
+    TF_OpDefinitionBuilderAddAttr(op_builder,
+                                  "T: {bfloat16, float} = DT_FLOAT");
+    TF_OpDefinitionBuilderAddAttr(op_builder,
+                                  "fp8_format: {'E4M3', 'E5M2'} = 'E4M3'");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "num_args: int >= 0");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "fused_ops: list(string) = []");
+    TF_OpDefinitionBuilderSetShapeInferenceFunction(op_builder,
+                                                    &unknown_shape_fn);
+    TF_RegisterOpDefinition(op_builder, status.get());
+    ITEX_CHECK_EQ(TF_OK, TF_GetCode(status.get()))
+        << "_ITEXFP8WeightMatMul op registration failed: ";
+  }
+}
+
 void Register_QuantizedFusedMatMulOp() {
   itex::StatusUniquePtr status(TF_NewStatus());
   {
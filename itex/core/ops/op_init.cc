@@ -80,6 +80,10 @@ void RegisterOps() {
   Register_FusedResourceApplyAdamOp();
   Register_FusedApplyAdamWithWeightDecayOp();
   Register_FusedResourceApplyAdamWithWeightDecayOp();
+  Register_ITEXMultiTensorApplyAdagradOp();
+  Register_ITEXMultiTensorApplyAdamOp();
+  Register_ITEXMultiTensorApplyMomentumOp();
+  Register_ITEXMultiTensorApplyRMSPropOp();
 
   Register_QuantizedConv2DV2Op();
   Register_QuantizedConv3DV2Op();
@@ -226,6 +230,11 @@ void RegisterOps() {
   Register_ITEXSliceOp();
   Register_ITEXSoftmaxOp();
   Register_ITEXTransposeOp();
+  Register_ITEXWeightOnlyQuantMatMulOp();
+  Register_ITEXDynamicQuantizedMatMulOp();
+  Register_ITEXFP8DequantizeOp();
+  Register_ITEXFP8QuantizeOp();
+  Register_ITEXFP8WeightMatMulOp();
 
   Register_ITEXQuantizedConcatV2Op();
   Register_ITEXQuantizedConv2DV2Op();
@@ -28,6 +28,10 @@ void Register_FusedApplyMomentumOp();
 void Register_FusedResourceApplyAdamOp();
 void Register_FusedResourceApplyAdamWithWeightDecayOp();
 void Register_FusedResourceApplyMomentumOp();
+void Register_ITEXMultiTensorApplyAdagradOp();
+void Register_ITEXMultiTensorApplyAdamOp();
+void Register_ITEXMultiTensorApplyMomentumOp();
+void Register_ITEXMultiTensorApplyRMSPropOp();
 void Register_ResourceApplyAdamWithWeightDecayOp();
 
 // Unupstreamed ops. These ops are only available in spr-base branch, not in
@@ -200,6 +204,11 @@ void Register_ITEXSliceOp();
 void Register_ITEXSoftmaxOp();
 void Register_ITEXSwishOp();
 void Register_ITEXTransposeOp();
+void Register_ITEXWeightOnlyQuantMatMulOp();
+void Register_ITEXDynamicQuantizedMatMulOp();
+void Register_ITEXFP8DequantizeOp();
+void Register_ITEXFP8QuantizeOp();
+void Register_ITEXFP8WeightMatMulOp();
 
 // BF32 native kernels
 void Register_ITEXAccMatMul();
@@ -310,3 +310,106 @@ void RegisterRMSPropVarUpdateOp() {
         << "RMSPropVarUpdate op registration failed: ";
   }
 }
+
+void Register_ITEXMultiTensorApplyAdamOp() {
+  itex::StatusUniquePtr status(TF_NewStatus());
+  {
+    TF_OpDefinitionBuilder* op_builder =
+        TF_NewOpDefinitionBuilder("_ITEXMultiTensorApplyAdam");
+
+    TF_OpDefinitionBuilderAddInput(op_builder, "var: N * resource");
+    TF_OpDefinitionBuilderAddInput(op_builder, "m: N * resource");
+    TF_OpDefinitionBuilderAddInput(op_builder, "v: N * resource");
+    TF_OpDefinitionBuilderAddInput(op_builder, "beta1_power: T");
+    TF_OpDefinitionBuilderAddInput(op_builder, "beta2_power: T");
+    TF_OpDefinitionBuilderAddInput(op_builder, "lr: T");
+    TF_OpDefinitionBuilderAddInput(op_builder, "beta1: T");
+    TF_OpDefinitionBuilderAddInput(op_builder, "beta2: T");
+    TF_OpDefinitionBuilderAddInput(op_builder, "epsilon: T");
+    TF_OpDefinitionBuilderAddInput(op_builder, "grad: N * T");
+
+    TF_OpDefinitionBuilderAddAttr(op_builder, "T: {bfloat16, float}");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "N: int >= 1");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "use_locking: bool = false");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "use_nesterov: bool = false");
+    TF_OpDefinitionBuilderSetShapeInferenceFunction(op_builder,
+                                                    &empty_shape_fn);
+    TF_RegisterOpDefinition(op_builder, status.get());
+    ITEX_CHECK_EQ(TF_OK, TF_GetCode(status.get()))
+        << "_ITEXMultiTensorApplyAdam op registration failed: ";
+  }
+}
+
+void Register_ITEXMultiTensorApplyAdagradOp() {
+  itex::StatusUniquePtr status(TF_NewStatus());
+  {
+    TF_OpDefinitionBuilder* op_builder =
+        TF_NewOpDefinitionBuilder("_ITEXMultiTensorApplyAdagrad");
+
+    TF_OpDefinitionBuilderAddInput(op_builder, "var: N * resource");
+    TF_OpDefinitionBuilderAddInput(op_builder, "accum: N * resource");
+    TF_OpDefinitionBuilderAddInput(op_builder, "lr: T");
+    TF_OpDefinitionBuilderAddInput(op_builder, "epsilon: T");
+    TF_OpDefinitionBuilderAddInput(op_builder, "grad: N * T");
+
+    TF_OpDefinitionBuilderAddAttr(op_builder, "T: {bfloat16, float}");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "N: int >= 1");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "use_locking: bool = false");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "update_slots: bool = true");
+    TF_OpDefinitionBuilderSetShapeInferenceFunction(op_builder,
+                                                    &empty_shape_fn);
+    TF_RegisterOpDefinition(op_builder, status.get());
+    ITEX_CHECK_EQ(TF_OK, TF_GetCode(status.get()))
+        << "_ITEXMultiTensorApplyAdagrad op registration failed: ";
+  }
+}
+
+void Register_ITEXMultiTensorApplyMomentumOp() {
+  itex::StatusUniquePtr status(TF_NewStatus());
+  {
+    TF_OpDefinitionBuilder* op_builder =
+        TF_NewOpDefinitionBuilder("_ITEXMultiTensorApplyMomentum");
+
+    TF_OpDefinitionBuilderAddInput(op_builder, "var: N * resource");
+    TF_OpDefinitionBuilderAddInput(op_builder, "accum: N * resource");
+    TF_OpDefinitionBuilderAddInput(op_builder, "lr: T");
+    TF_OpDefinitionBuilderAddInput(op_builder, "momentum: T");
+    TF_OpDefinitionBuilderAddInput(op_builder, "grad: N * T");
+
+    TF_OpDefinitionBuilderAddAttr(op_builder, "T: {bfloat16, float}");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "N: int >= 1");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "use_locking: bool = false");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "use_nesterov: bool = false");
+    TF_OpDefinitionBuilderSetShapeInferenceFunction(op_builder,
+                                                    &empty_shape_fn);
+    TF_RegisterOpDefinition(op_builder, status.get());
+    ITEX_CHECK_EQ(TF_OK, TF_GetCode(status.get()))
+        << "_ITEXMultiTensorApplyMomentum op registration failed: ";
+  }
+}
+
+void Register_ITEXMultiTensorApplyRMSPropOp() {
+  itex::StatusUniquePtr status(TF_NewStatus());
+  {
+    TF_OpDefinitionBuilder* op_builder =
+        TF_NewOpDefinitionBuilder("_ITEXMultiTensorApplyRMSProp");
+
+    TF_OpDefinitionBuilderAddInput(op_builder, "var: N * resource");
+    TF_OpDefinitionBuilderAddInput(op_builder, "ms: N * resource");
+    TF_OpDefinitionBuilderAddInput(op_builder, "mom: N * resource");
+    TF_OpDefinitionBuilderAddInput(op_builder, "lr: T");
+    TF_OpDefinitionBuilderAddInput(op_builder, "rho: T");
+    TF_OpDefinitionBuilderAddInput(op_builder, "momentum: T");
+    TF_OpDefinitionBuilderAddInput(op_builder, "epsilon: T");
+    TF_OpDefinitionBuilderAddInput(op_builder, "grad: N * T");
+
+    TF_OpDefinitionBuilderAddAttr(op_builder, "T: {bfloat16, float}");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "N: int >= 1");
+    TF_OpDefinitionBuilderAddAttr(op_builder, "use_locking: bool = false");
+    TF_OpDefinitionBuilderSetShapeInferenceFunction(op_builder,
+                                                    &empty_shape_fn);
+    TF_RegisterOpDefinition(op_builder, status.get());
+    ITEX_CHECK_EQ(TF_OK, TF_GetCode(status.get()))
+        << "_ITEXMultiTensorApplyRMSProp op registration failed: ";
+  }
+}
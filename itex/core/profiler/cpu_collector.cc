@@ -0,0 +1,92 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "itex/core/profiler/cpu_collector.h"
+
+#include <utility>
+
+#include "itex/core/profiler/utils/parse_annotation.h"
+#include "itex/core/profiler/utils/xplane_builder.h"
+#include "itex/core/profiler/utils/xplane_schema.h"
+#include "itex/core/profiler/utils/xplane_utils.h"
+#include "itex/core/utils/logging.h"
+#include "itex/core/utils/strcat.h"
+#include "itex/core/utils/time_utils.h"
+
+namespace itex {
+namespace profiler {
+
+namespace {
+
+// Level 1 records the kernels, level 2 adds the oneDNN primitives.
+constexpr int kCpuTraceLevel = 2;
+
+}  // namespace
+
+std::string CpuPlaneName() {
+  return strings::StrCat(kCustomPlanePrefix, "ITEX CPU");
+}
+
+/* static */ CpuCollector* CpuCollector::Get() {
+  static CpuCollector* collector = new CpuCollector;
+  return collector;
+}
+
+bool CpuCollector::Start() {
+  mutex_lock l(&mu_);
+  if (recording_ || !TraceMeRecorder::Start(kCpuTraceLevel)) {
+    ITEX_LOG(WARNING) << "ITEX CPU collector is already recording";
+    return false;
+  }
+  recording_ = true;
+  start_walltime_ns_ = GetCurrentTimeNanos();
+  events_.clear();
+  return true;
+}
+
+void CpuCollector::Stop() {
+  mutex_lock l(&mu_);
+  if (!recording_) return;
+  events_ = TraceMeRecorder::Stop();
+  recording_ = false;
+}
+
+void CpuCollector::Collect(XSpace* space) {
+  mutex_lock l(&mu_);
+  if (events_.empty()) return;
+  XPlaneBuilder plane(FindOrAddMutablePlaneWithName(space, CpuPlaneName()));
+  for (const TraceMeRecorder::ThreadEvents& thread : events_) {
+    XLineBuilder line = plane.GetOrCreateLine(thread.thread.tid);
+    line.SetNameIfEmpty(thread.thread.name);
+    line.SetTimestampNs(start_walltime_ns_);
+    for (const TraceMeRecorder::Event& event : thread.events) {
+      // Events cut by Start or Stop are dropped.
+      if (!event.IsComplete()) continue;
+      if (event.start_time < start_walltime_ns_) continue;
+      Annotation annotation = ParseAnnotation(event.name);
+      XEventBuilder xevent = line.AddEvent(
+          *plane.GetOrCreateEventMetadata(std::string(annotation.name)));
+      xevent.SetTimestampNs(event.start_time);
+      xevent.SetEndTimestampNs(event.end_time);
+      for (const Annotation::Metadata& metadata : annotation.metadata) {
+        xevent.ParseAndAddStatValue(
+            *plane.GetOrCreateStatMetadata(metadata.key), metadata.value);
+      }
+    }
+  }
+}
+
+}  // namespace profiler
+}  // namespace itex
@@ -0,0 +1,61 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef ITEX_CORE_PROFILER_CPU_COLLECTOR_H_
+#define ITEX_CORE_PROFILER_CPU_COLLECTOR_H_
+
+#include <string>
+
+#include "itex/core/utils/mutex.h"
+#include "itex/core/utils/traceme_recorder.h"
+#include "itex/core/utils/types.h"
+#include "protos/xplane.pb.h"
+
+namespace itex {
+namespace profiler {
+
+// Name of the plane with the host activity of ITEX.
+std::string CpuPlaneName();
+
+// Collects the TraceMe events ITEX records on the host: the kernels run by
+// OpKernel::Compute and, at level 2, the oneDNN primitives they execute with
+// their kind, shapes and implementation.
+class CpuCollector {
+ public:
+  // Returns the process wide collector.
+  static CpuCollector* Get();
+
+  // Starts the TraceMeRecorder. Returns false if it is already recording.
+  bool Start();
+  // Stops the TraceMeRecorder and keeps the events until the next Start.
+  void Stop();
+  // Adds the events to a plane of "space", one line per thread. TF collects
+  // twice, once for the size of the space and once to serialize it, so the
+  // events are not consumed.
+  void Collect(XSpace* space);
+
+ private:
+  CpuCollector() = default;
+
+  mutex mu_;
+  bool recording_ TF_GUARDED_BY(mu_) = false;
+  int64_t start_walltime_ns_ TF_GUARDED_BY(mu_) = 0;
+  TraceMeRecorder::Events events_ TF_GUARDED_BY(mu_);
+};
+
+}  // namespace profiler
+}  // namespace itex
+
+#endif  // ITEX_CORE_PROFILER_CPU_COLLECTOR_H_
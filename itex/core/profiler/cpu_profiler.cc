@@ -0,0 +1,59 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "itex/core/profiler/cpu_collector.h"
+#include "protos/xplane.pb.h"
+#include "tensorflow/c/experimental/pluggable_profiler/pluggable_profiler.h"
+
+// Profiler of the CPU only build. The XPU build collects the host activity
+// in gpu_profiler.cc.
+
+void cpu_start(const TP_Profiler* profiler, TF_Status* status) {
+  itex::profiler::CpuCollector::Get()->Start();
+}
+
+void cpu_stop(const TP_Profiler* profiler, TF_Status* status) {
+  itex::profiler::CpuCollector::Get()->Stop();
+}
+
+void cpu_collect_data_xspace(const TP_Profiler* profiler, uint8_t* buffer,
+                             size_t* size_in_bytes, TF_Status* status) {
+  itex::XSpace space;
+  itex::profiler::CpuCollector::Get()->Collect(&space);
+
+  *size_in_bytes = space.ByteSizeLong();
+  if (buffer == nullptr) {
+    return;
+  }
+  space.SerializeToArray(buffer, space.ByteSizeLong());
+}
+
+void cpu_destroy_profiler(TP_Profiler* profiler) {}
+
+void cpu_destroy_profiler_fns(TP_ProfilerFns* profiler_fns) {}
+
+void TF_InitProfiler(TF_ProfilerRegistrationParams* params, TF_Status* status) {
+  params->struct_size = TF_PROFILER_REGISTRATION_PARAMS_STRUCT_SIZE;
+  params->profiler->struct_size = TP_PROFILER_STRUCT_SIZE;
+  params->profiler_fns->struct_size = TP_PROFILER_FNS_STRUCT_SIZE;
+
+  params->profiler->device_type = "CPU";
+
+  params->profiler_fns->start = cpu_start;
+  params->profiler_fns->stop = cpu_stop;
+  params->profiler_fns->collect_data_xspace = cpu_collect_data_xspace;
+  params->destroy_profiler = cpu_destroy_profiler;
+  params->destroy_profiler_fns = cpu_destroy_profiler_fns;
+}
@@ -13,6 +13,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include "itex/core/profiler/cpu_collector.h"
 #include "itex/core/profiler/gpu_collector.h"
 #include "itex/core/profiler/utils.h"
 #include "itex/core/profiler/utils/xplane_utils.h"
@@ -79,11 +80,13 @@ void gpu_start(const TP_Profiler* profiler, TF_Status* status) {
   if (tracer != nullptr) {
     tracer->Start();
   }
+  itex::profiler::CpuCollector::Get()->Start();
 }
 void gpu_stop(const TP_Profiler* profiler, TF_Status* status) {
   if (tracer != nullptr) {
     tracer->Stop();
   }
+  itex::profiler::CpuCollector::Get()->Stop();
 }
 
 static void NormalizeTimeStamps(itex::profiler::XPlaneBuilder* plane,
@@ -113,6 +116,7 @@ void gpu_collect_data_xspace(const TP_Profiler* profiler, uint8_t* buffer,
       NormalizeTimeStamps(&device_plane, tracer->GetStartWallTime());
     }
   }
+  itex::profiler::CpuCollector::Get()->Collect(&space);
 
   *size_in_bytes = space.ByteSizeLong();
   if (buffer == nullptr) {
@@ -53,6 +53,10 @@ struct AllocationAttributes {
   // a memory chunk whose freed_at_count is at this value or earlier may be
   // returned.
   std::function<uint64()>* freed_by_func = nullptr;  // Not owned.
+  // On CPU, take the memory from the huge page arena if it is enabled, see
+  // HugePageArena. Meant for buffers that are read many times, like cached
+  // weights.
+  bool prefer_huge_pages = false;
 
   TF_DISALLOW_COPY_AND_ASSIGN(AllocationAttributes);
 };
@@ -51,6 +51,19 @@ class AnnotatedTraceMe {
     }
   }
 
+  // Whether the TraceMe is recorded, i.e. the profiler is tracing.
+  bool IsTracing() const { return trace_me_.has_value(); }
+
+  // Appends metadata to the name of the TraceMe, see
+  // TraceMe::AppendMetadata(). The annotation is not changed.
+  template <typename MetadataGeneratorT>
+  void AppendMetadata(MetadataGeneratorT&& metadata_generator) {
+    if (trace_me_.has_value()) {
+      trace_me_->AppendMetadata(
+          std::forward<MetadataGeneratorT>(metadata_generator));
+    }
+  }
+
  private:
   absl::optional<TraceMe> trace_me_;
   absl::optional<ScopedAnnotation> scoped_annotation_;
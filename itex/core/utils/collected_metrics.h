@@ -92,7 +92,7 @@ struct Point {
   int64_t int64_value;
   std::string string_value;
   bool bool_value;
-  // HistogramProto histogram_value;
+  Histogram histogram_value;
   Percentiles percentiles_value;
 
   // start_timestamp and end_timestamp indicate the time period over which this
@@ -263,14 +263,11 @@ inline void CollectValue(std::function<bool()> value_fn, Point* const point) {
   point->bool_value = value_fn();
 }
 
-// template <>
-// inline void CollectValue(HistogramProto value, Point* const point) {
-//   point->value_type = ValueType::kHistogram;
-//   // This is inefficient. If and when we hit snags, we can change the API to
-//   do
-//   // this more efficiently.
-//   point->histogram_value = std::move(value);
-// }
+template <>
+inline void CollectValue(Histogram value, Point* const point) {
+  point->value_type = ValueType::kHistogram;
+  point->histogram_value = std::move(value);
+}
 
 template <>
 inline void CollectValue(Percentiles value, Point* const point) {
@@ -0,0 +1,189 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Copyright 2016 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef ITEX_CORE_UTILS_COUNTER_H_
+#define ITEX_CORE_UTILS_COUNTER_H_
+
+// clang-format off
+#include "itex/core/utils/platform.h"
+// clang-format on
+
+#include <array>    //NOLINT
+#include <atomic>   //NOLINT
+#include <map>      //NOLINT
+#include <memory>   //NOLINT
+#include <string>   //NOLINT
+#include <utility>  //NOLINT
+
+#include "itex/core/utils/collection_registry.h"
+#include "itex/core/utils/logging.h"
+#include "itex/core/utils/macros.h"
+#include "itex/core/utils/metric_def.h"
+#include "itex/core/utils/mutex.h"
+#include "itex/core/utils/status.h"
+#include "itex/core/utils/thread_annotations.h"
+#include "itex/core/utils/types.h"
+
+namespace itex {
+namespace monitoring {
+
+// CounterCell stores each value of an Counter.
+//
+// A cell can be passed off to a module which may repeatedly update it without
+// needing further map-indexing computations. This improves both encapsulation
+// (separate modules can own a cell each, without needing to know about the map
+// to which both cells belong) and performance (since map indexing and
+// associated locking are both avoided).
+//
+// This class is thread-safe.
+class CounterCell {
+ public:
+  explicit CounterCell(int64_t value) : value_(value) {}
+  ~CounterCell() {}
+
+  // Atomically increments the value by step.
+  // REQUIRES: Step be non-negative.
+  void IncrementBy(int64_t step);
+
+  // Retrieves the current value.
+  int64_t value() const;
+
+ private:
+  std::atomic<int64_t> value_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(CounterCell);
+};
+
+// A stateful class for updating a cumulative integer metric.
+//
+// This class encapsulates a set of values (or a single value for a label-less
+// metric). Each value is identified by a tuple of labels. The class allows the
+// user to increment each value.
+//
+// Counter allocates storage and maintains a cell for each value. You can
+// retrieve an individual cell using a label-tuple and update it separately.
+// This improves performance since operations related to retrieval, like
+// map-indexing and locking, are avoided.
+//
+// This class is thread-safe.
+template <int NumLabels>
+class Counter {
+ public:
+  ~Counter() {
+    // Deleted here, before the metric_def is destroyed.
+    registration_handle_.reset();
+  }
+
+  // Creates the metric based on the metric-definition arguments.
+  //
+  // Example;
+  // auto* counter_with_label = Counter<1>::New("/itex/counter",
+  //   "ITEX counter", "MyLabelName");
+  template <typename... MetricDefArgs>
+  static Counter* New(MetricDefArgs&&... metric_def_args);
+
+  // Retrieves the cell for the specified labels, creating it on demand if
+  // not already present.
+  template <typename... Labels>
+  CounterCell* GetCell(const Labels&... labels) TF_LOCKS_EXCLUDED(mu_);
+
+  Status GetStatus() { return status_; }
+
+ private:
+  explicit Counter(
+      const MetricDef<MetricKind::kCumulative, int64_t, NumLabels>& metric_def)
+      : metric_def_(metric_def),
+        registration_handle_(CollectionRegistry::Default()->Register(
+            &metric_def_, [&](MetricCollectorGetter getter) {
+              auto metric_collector = getter.Get(&metric_def_);
+
+              mutex_lock l(&mu_);
+              for (const auto& cell : cells_) {
+                metric_collector.CollectValue(cell.first, cell.second.value());
+              }
+            })) {
+    if (registration_handle_) {
+      status_ = Status::OK();
+    } else {
+      status_ = Status(TF_ALREADY_EXISTS,
+                       "Another metric with the same name already exists.");
+    }
+  }
+
+  mutable mutex mu_;
+
+  Status status_;
+
+  // The metric definition. This will be used to identify the metric when we
+  // register it for collection.
+  const MetricDef<MetricKind::kCumulative, int64_t, NumLabels> metric_def_;
+
+  std::unique_ptr<CollectionRegistry::RegistrationHandle> registration_handle_;
+
+  using LabelArray = std::array<std::string, NumLabels>;
+  std::map<LabelArray, CounterCell> cells_ TF_GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(Counter);
+};
+
+////
+//  Implementation details follow. API readers may skip.
+////
+
+inline void CounterCell::IncrementBy(const int64_t step) {
+  ITEX_DCHECK_LE(0, step) << "Must not decrement cumulative metrics.";
+  value_ += step;
+}
+
+inline int64_t CounterCell::value() const { return value_; }
+
+template <int NumLabels>
+template <typename... MetricDefArgs>
+Counter<NumLabels>* Counter<NumLabels>::New(
+    MetricDefArgs&&... metric_def_args) {
+  return new Counter<NumLabels>(
+      MetricDef<MetricKind::kCumulative, int64_t, NumLabels>(
+          std::forward<MetricDefArgs>(metric_def_args)...));
+}
+
+template <int NumLabels>
+template <typename... Labels>
+CounterCell* Counter<NumLabels>::GetCell(const Labels&... labels)
+    TF_LOCKS_EXCLUDED(mu_) {
+  // Provides a more informative error message than the one during array
+  // construction below.
+  static_assert(sizeof...(Labels) == NumLabels,
+                "Mismatch between Counter<NumLabels> and number of labels "
+                "provided in GetCell(...).");
+
+  const LabelArray& label_array = {{labels...}};
+  mutex_lock l(&mu_);
+  const auto found_it = cells_.find(label_array);
+  if (found_it != cells_.end()) {
+    return &(found_it->second);
+  }
+  return &(cells_
+               .emplace(std::piecewise_construct,
+                        std::forward_as_tuple(label_array),
+                        std::forward_as_tuple(0))
+               .first->second);
+}
+
+}  // namespace monitoring
+}  // namespace itex
+
+#endif  // ITEX_CORE_UTILS_COUNTER_H_
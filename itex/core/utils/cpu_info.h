@@ -19,6 +19,7 @@ limitations under the License.
 #define ITEX_CORE_UTILS_CPU_INFO_H_
 
 #include <string>
+#include <vector>
 
 // TODO(ahentz): This is not strictly required here but, for historical
 // reasons, many people depend on cpu_info.h in order to use kLittleEndian.
@@ -70,6 +71,14 @@ int GetCurrentCPU();
 // on the CPU
 int NumHyperthreadsPerCore();
 
+// Returns the CPUs the calling thread may run on, empty if they cannot be
+// determined.
+std::vector<int> GetThreadCPUAffinity();
+
+// Restricts the calling thread to "cpus". Returns false if the affinity
+// cannot be set.
+bool SetThreadCPUAffinity(const std::vector<int>& cpus);
+
 // Mostly ISA related features that we care about
 enum CPUFeature {
   // Do not change numeric assignments.
@@ -598,6 +598,9 @@ struct ThreadOptions {
   /// Guard area size to use near thread stacks to use (in bytes)
   size_t guard_size = 0;  // 0: use system default value
   int numa_node = port::kNUMANoAffinity;
+  /// CPUs to pin the thread to, after numa_node is applied. Empty means no
+  /// further restriction.
+  std::vector<int> cpus;
 };
 
 /// A utility routine: copy contents of `src` in file system `src_fs`
@@ -0,0 +1,221 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "itex/core/utils/execution_domain.h"
+
+#include <dirent.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <utility>
+
+#include "absl/strings/str_join.h"
+#include "itex/core/utils/cpu_info.h"
+#include "itex/core/utils/env.h"
+#include "itex/core/utils/errors.h"
+#include "itex/core/utils/logging.h"
+#include "itex/core/utils/mutex.h"
+#include "itex/core/utils/numa.h"
+#include "itex/core/utils/strcat.h"
+#include "itex/core/utils/threadpool.h"
+#include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
+
+namespace itex {
+
+namespace {
+
+struct Core {
+  int node;
+  int cpu;
+};
+
+constexpr char kSysCpuDir[] = "/sys/devices/system/cpu/cpu";
+
+// Returns the integer in a sysfs file, -1 if it cannot be read.
+int ReadSysfsInt(const std::string& path) {
+  std::ifstream in(path);
+  int value = -1;
+  if (!(in >> value)) return -1;
+  return value;
+}
+
+// Returns the NUMA node of "cpu", 0 if it is unknown.
+int CpuNode(int cpu) {
+  DIR* dir = opendir(strings::StrCat(kSysCpuDir, cpu).c_str());
+  if (dir == nullptr) return 0;
+  int node = 0;
+  while (struct dirent* entry = readdir(dir)) {
+    if (strncmp(entry->d_name, "node", 4) == 0 &&
+        isdigit(static_cast<unsigned char>(entry->d_name[4]))) {
+      node = atoi(entry->d_name + 4);
+      break;
+    }
+  }
+  closedir(dir);
+  return node;
+}
+
+// Returns the first CPU of every physical core the calling thread may run on,
+// ordered by NUMA node. Hyperthreads are left out, as in launch.py.
+std::vector<Core> PhysicalCores() {
+  std::map<std::pair<int, int>, Core> cores;
+  for (int cpu : port::GetThreadCPUAffinity()) {
+    const std::string topology = strings::StrCat(kSysCpuDir, cpu, "/topology/");
+    const int package = ReadSysfsInt(topology + "physical_package_id");
+    const int core_id = ReadSysfsInt(topology + "core_id");
+    // Without topology every CPU counts as a core.
+    const std::pair<int, int> key =
+        core_id < 0 ? std::make_pair(-1, cpu) : std::make_pair(package, core_id);
+    cores.emplace(key, Core{CpuNode(cpu), cpu});
+  }
+  std::vector<Core> result;
+  for (const auto& core : cores) result.push_back(core.second);
+  std::stable_sort(result.begin(), result.end(),
+                   [](const Core& a, const Core& b) {
+                     return a.node != b.node ? a.node < b.node : a.cpu < b.cpu;
+                   });
+  return result;
+}
+
+mutex registry_mu(LINKER_INITIALIZED);
+// Filled once by Create, before num_domains is published.
+std::vector<ExecutionDomain*>* domains = new std::vector<ExecutionDomain*>;
+std::atomic<int> num_domains{0};
+
+thread_local ExecutionDomain* current_domain = nullptr;
+
+// What Enter replaced, restored by the matching Exit.
+struct EnteredDomain {
+  ExecutionDomain* previous_domain;
+  std::vector<int> previous_cpus;
+};
+
+std::vector<EnteredDomain>* EnteredDomains() {
+  static thread_local std::vector<EnteredDomain> entered;
+  return &entered;
+}
+
+}  // namespace
+
+ExecutionDomain::ExecutionDomain(int id, std::vector<int> cpus, int numa_node)
+    : id_(id), cpus_(std::move(cpus)), numa_node_(numa_node) {
+  ThreadOptions thread_options;
+  thread_options.cpus = cpus_;
+  threadpool_.reset(new thread::ThreadPool(
+      Env::Default(), thread_options, strings::StrCat("itex_domain_", id_),
+      cpus_.size()));
+  eigen_cpu_device_.reset(new Eigen::ThreadPoolDevice(
+      threadpool_->AsEigenThreadPool(), threadpool_->NumThreads()));
+}
+
+ExecutionDomain::~ExecutionDomain() {}
+
+/* static */ Status ExecutionDomain::Create(int num_domains_to_create,
+                                            int cores_per_domain) {
+  if (num_domains_to_create < 1 || cores_per_domain < 0) {
+    return errors::InvalidArgument("Invalid number of execution domains ",
+                                   num_domains_to_create, " or cores ",
+                                   cores_per_domain);
+  }
+  mutex_lock l(&registry_mu);
+  if (!domains->empty()) {
+    return errors::AlreadyExists(domains->size(),
+                                 " execution domains were already created");
+  }
+
+  const std::vector<Core> cores = PhysicalCores();
+  if (cores_per_domain == 0) {
+    cores_per_domain = cores.size() / num_domains_to_create;
+  }
+  if (cores_per_domain == 0 ||
+      num_domains_to_create * cores_per_domain > cores.size()) {
+    return errors::InvalidArgument(
+        "Cannot create ", num_domains_to_create, " execution domains of ",
+        cores_per_domain, " cores on ", cores.size(), " physical cores");
+  }
+
+  for (int id = 0; id < num_domains_to_create; ++id) {
+    std::vector<int> cpus;
+    int numa_node = cores[id * cores_per_domain].node;
+    for (int i = id * cores_per_domain; i < (id + 1) * cores_per_domain; ++i) {
+      cpus.push_back(cores[i].cpu);
+      if (cores[i].node != numa_node) numa_node = port::kNUMANoAffinity;
+    }
+    ITEX_VLOG(1) << "Execution domain " << id << " runs on CPUs "
+                 << absl::StrJoin(cpus, ",") << " of NUMA node " << numa_node;
+    domains->push_back(new ExecutionDomain(id, std::move(cpus), numa_node));
+  }
+  num_domains.store(domains->size(), std::memory_order_release);
+  return Status::OK();
+}
+
+/* static */ int ExecutionDomain::NumDomains() {
+  return num_domains.load(std::memory_order_acquire);
+}
+
+/* static */ ExecutionDomain* ExecutionDomain::Get(int id) {
+  ITEX_DCHECK_GE(id, 0);
+  ITEX_DCHECK_LT(id, NumDomains());
+  return (*domains)[id];
+}
+
+/* static */ ExecutionDomain* ExecutionDomain::Current() {
+  return current_domain;
+}
+
+/* static */ ExecutionDomain* ExecutionDomain::SetCurrent(
+    ExecutionDomain* domain) {
+  ExecutionDomain* previous = current_domain;
+  current_domain = domain;
+  return previous;
+}
+
+/* static */ Status ExecutionDomain::Enter(int id) {
+  if (id < 0 || id >= NumDomains()) {
+    return errors::InvalidArgument("Execution domain ", id,
+                                   " does not exist, there are ",
+                                   NumDomains(), " domains");
+  }
+  ExecutionDomain* domain = Get(id);
+  std::vector<int> previous_cpus = port::GetThreadCPUAffinity();
+  if (!port::SetThreadCPUAffinity(domain->cpus())) {
+    return errors::Internal("Could not pin the thread to execution domain ",
+                            id);
+  }
+  EnteredDomains()->push_back({SetCurrent(domain), std::move(previous_cpus)});
+  return Status::OK();
+}
+
+/* static */ Status ExecutionDomain::Exit() {
+  std::vector<EnteredDomain>* entered = EnteredDomains();
+  if (entered->empty()) {
+    return errors::FailedPrecondition(
+        "The thread has not entered an execution domain");
+  }
+  SetCurrent(entered->back().previous_domain);
+  if (!entered->back().previous_cpus.empty()) {
+    port::SetThreadCPUAffinity(entered->back().previous_cpus);
+  }
+  entered->pop_back();
+  return Status::OK();
+}
+
+}  // namespace itex
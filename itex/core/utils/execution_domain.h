@@ -0,0 +1,124 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef ITEX_CORE_UTILS_EXECUTION_DOMAIN_H_
+#define ITEX_CORE_UTILS_EXECUTION_DOMAIN_H_
+
+#include <memory>
+#include <vector>
+
+#include "itex/core/utils/macros.h"
+#include "itex/core/utils/status.h"
+
+namespace Eigen {
+struct ThreadPoolDevice;
+}  // namespace Eigen
+
+namespace itex {
+
+namespace thread {
+class ThreadPool;
+}  // namespace thread
+
+// Int attr with which the graph optimizer binds every node of a graph to the
+// execution domain that was current on the thread optimizing it.
+constexpr char kExecutionDomainAttr[] = "_itex_execution_domain";
+
+// A set of physical cores of the process with its own thread pool, used for
+// the intra-op parallelism of the CPU kernels and oneDNN primitives run in
+// the domain. Several domains serve independent requests side by side, like
+// the instances started by launch.py, but share the process, the runtime and
+// the weights.
+//
+// A thread runs its ops in the domain it has entered. Graphs are bound to the
+// domain that was current when they were optimized, i.e. when a tf.function
+// is traced or a Session first runs it, whichever thread executes them later.
+class ExecutionDomain {
+ public:
+  ~ExecutionDomain();
+
+  // Splits the physical cores the calling thread may run on into
+  // "num_domains" domains of "cores_per_domain" cores each, or of an equal
+  // share of the cores if cores_per_domain is 0. Cores are handed out in NUMA
+  // node order, so a domain only spans nodes if its cores do not fit in one.
+  // The domains live until the process exits, so they can only be created
+  // once.
+  static Status Create(int num_domains, int cores_per_domain);
+
+  // Number of domains, 0 before Create.
+  static int NumDomains();
+
+  // REQUIRES: 0 <= id < NumDomains().
+  static ExecutionDomain* Get(int id);
+
+  // Returns the domain of the calling thread, nullptr if it has none.
+  static ExecutionDomain* Current();
+
+  // Makes domain "id" the domain of the calling thread and pins the thread to
+  // its cores until the matching Exit. Calls nest.
+  static Status Enter(int id);
+  static Status Exit();
+
+  int id() const { return id_; }
+  const std::vector<int>& cpus() const { return cpus_; }
+  // NUMA node of the cores, port::kNUMANoAffinity if they span nodes. The
+  // threads of the domain first touch the memory they produce, so it is
+  // placed on this node.
+  int numa_node() const { return numa_node_; }
+
+  // One thread per core, pinned to it.
+  thread::ThreadPool* threadpool() const { return threadpool_.get(); }
+  const Eigen::ThreadPoolDevice& eigen_cpu_device() const {
+    return *eigen_cpu_device_;
+  }
+
+ private:
+  friend class ScopedExecutionDomain;
+
+  ExecutionDomain(int id, std::vector<int> cpus, int numa_node);
+
+  // Sets the domain of the calling thread and returns the previous one.
+  static ExecutionDomain* SetCurrent(ExecutionDomain* domain);
+
+  const int id_;
+  const std::vector<int> cpus_;
+  const int numa_node_;
+  std::unique_ptr<thread::ThreadPool> threadpool_;
+  std::unique_ptr<Eigen::ThreadPoolDevice> eigen_cpu_device_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(ExecutionDomain);
+};
+
+// Runs the calling thread in "domain" for the lifetime of the object, without
+// pinning it. Does nothing if domain is nullptr.
+class ScopedExecutionDomain {
+ public:
+  explicit ScopedExecutionDomain(ExecutionDomain* domain) : domain_(domain) {
+    if (domain_ != nullptr) previous_ = ExecutionDomain::SetCurrent(domain_);
+  }
+  ~ScopedExecutionDomain() {
+    if (domain_ != nullptr) ExecutionDomain::SetCurrent(previous_);
+  }
+
+ private:
+  ExecutionDomain* const domain_;
+  ExecutionDomain* previous_ = nullptr;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(ScopedExecutionDomain);
+};
+
+}  // namespace itex
+
+#endif  // ITEX_CORE_UTILS_EXECUTION_DOMAIN_H_
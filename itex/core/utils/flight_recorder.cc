@@ -0,0 +1,470 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "itex/core/utils/flight_recorder.h"
+
+#include <semaphore.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>   // NOLINT(build/c++11)
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "itex/core/utils/env.h"
+#include "itex/core/utils/env_time.h"
+#include "itex/core/utils/env_var.h"
+#include "itex/core/utils/errors.h"
+#include "itex/core/utils/mutex.h"
+#include "itex/core/utils/op_kernel.h"
+#include "itex/core/utils/str_util.h"
+
+namespace itex {
+namespace flight_recorder {
+
+namespace {
+
+constexpr int64 kDefaultEventsPerThread = 4096;
+
+// Steps in flight are tracked in a small table indexed by the step id. Steps
+// that collide replace each other, which only delays the detection of a slow
+// step.
+constexpr int kNumStepSlots = 64;
+constexpr int64 kNoStep = std::numeric_limits<int64>::min();
+constexpr int64 kClaimedStep = kNoStep + 1;
+
+struct Config {
+  bool enabled = true;
+  int64 events_per_thread = kDefaultEventsPerThread;
+  string dir;
+  uint64 step_threshold_nsecs = 0;
+  int64 signal = 0;
+};
+
+void StartDumpThread(const Config& config);
+
+const Config& GetConfig() {
+  static const Config* config = [] {
+    auto* config = new Config();
+    int64 step_ms = 0;
+    ITEX_CHECK_OK(
+        ReadBoolFromEnvVar("ITEX_FLIGHT_RECORDER", true, &config->enabled));
+    ITEX_CHECK_OK(ReadInt64FromEnvVar("ITEX_FLIGHT_RECORDER_EVENTS",
+                                      kDefaultEventsPerThread,
+                                      &config->events_per_thread));
+    ITEX_CHECK_OK(
+        ReadStringFromEnvVar("ITEX_FLIGHT_RECORDER_DIR", "/tmp", &config->dir));
+    ITEX_CHECK_OK(
+        ReadInt64FromEnvVar("ITEX_FLIGHT_RECORDER_STEP_MS", 0, &step_ms));
+    ITEX_CHECK_OK(
+        ReadInt64FromEnvVar("ITEX_FLIGHT_RECORDER_SIGNAL", 0, &config->signal));
+    if (config->events_per_thread <= 0) config->enabled = false;
+    config->step_threshold_nsecs =
+        step_ms > 0 ? static_cast<uint64>(step_ms) * 1000000 : 0;
+    if (config->enabled) StartDumpThread(*config);
+    return config;
+  }();
+  return *config;
+}
+
+// Names of the interned ops. They are never removed, so that the events of
+// deleted kernels can still be dumped.
+class OpTable {
+ public:
+  int32 Intern(absl::string_view name, absl::string_view type)
+      TF_LOCKS_EXCLUDED(mu_) {
+    const string key = absl::StrCat(name, "\n", type);
+    mutex_lock l(&mu_);
+    auto it = index_.find(key);
+    if (it != index_.end()) return it->second;
+    const int32 id = ops_.size();
+    ops_.push_back({string(name), string(type)});
+    index_.emplace(key, id);
+    return id;
+  }
+
+  mutex* mu() TF_LOCK_RETURNED(mu_) { return &mu_; }
+
+  // Name and type of the op "id".
+  const std::pair<string, string>& op(int32 id) const
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    return ops_[id];
+  }
+
+ private:
+  mutex mu_;
+  std::deque<std::pair<string, string>> ops_ TF_GUARDED_BY(mu_);
+  absl::flat_hash_map<string, int32> index_ TF_GUARDED_BY(mu_);
+};
+
+OpTable* GetOpTable() {
+  static OpTable* table = new OpTable();
+  return table;
+}
+
+struct Event {
+  int32 op_id;
+  int64 step_id;
+  uint64 start_nsecs;
+  uint64 end_nsecs;
+};
+
+// Ring buffer of the runs of one thread. Only the owner thread writes, while
+// the dump reads concurrently: the fields are relaxed atomics, which are plain
+// loads and stores on x86, and the dump drops the slots the owner may have
+// overwritten while they were copied.
+class Ring {
+ public:
+  Ring(int32 tid, string thread_name, size_t capacity)
+      : tid_(tid),
+        thread_name_(std::move(thread_name)),
+        mask_(capacity - 1),
+        slots_(new Slot[capacity]) {}
+
+  void Record(int32 op_id, int64 step_id, uint64 start_nsecs,
+              uint64 end_nsecs) {
+    const uint64 position = next_.load(std::memory_order_relaxed);
+    // Keeps the publication of the previous run before the stores below.
+    std::atomic_thread_fence(std::memory_order_release);
+    Slot& slot = slots_[position & mask_];
+    slot.op_id.store(op_id, std::memory_order_relaxed);
+    slot.step_id.store(step_id, std::memory_order_relaxed);
+    slot.start_nsecs.store(start_nsecs, std::memory_order_relaxed);
+    slot.end_nsecs.store(end_nsecs, std::memory_order_relaxed);
+    next_.store(position + 1, std::memory_order_release);
+  }
+
+  // Appends the runs in the ring to "events", oldest first.
+  void Snapshot(std::vector<Event>* events) const {
+    const uint64 capacity = mask_ + 1;
+    const uint64 end = next_.load(std::memory_order_acquire);
+    const uint64 begin = end > capacity ? end - capacity : 0;
+    std::vector<Event> copied;
+    copied.reserve(end - begin);
+    for (uint64 position = begin; position < end; ++position) {
+      const Slot& slot = slots_[position & mask_];
+      copied.push_back({slot.op_id.load(std::memory_order_relaxed),
+                        slot.step_id.load(std::memory_order_relaxed),
+                        slot.start_nsecs.load(std::memory_order_relaxed),
+                        slot.end_nsecs.load(std::memory_order_relaxed)});
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    // The owner may be writing the run at "now", into the slot of the run at
+    // now - capacity.
+    const uint64 now = next_.load(std::memory_order_relaxed);
+    const uint64 valid = now >= capacity ? now - capacity + 1 : 0;
+    for (uint64 position = std::max(begin, valid); position < end;
+         ++position) {
+      events->push_back(copied[position - begin]);
+    }
+  }
+
+  int32 tid() const { return tid_; }
+  const string& thread_name() const { return thread_name_; }
+
+ private:
+  struct Slot {
+    std::atomic<int32> op_id{-1};
+    std::atomic<int64> step_id{0};
+    std::atomic<uint64> start_nsecs{0};
+    std::atomic<uint64> end_nsecs{0};
+  };
+
+  const int32 tid_;
+  const string thread_name_;
+  const uint64 mask_;
+  std::unique_ptr<Slot[]> slots_;
+  std::atomic<uint64> next_{0};
+};
+
+class RingRegistry {
+ public:
+  void Register(std::shared_ptr<Ring> ring) TF_LOCKS_EXCLUDED(mu_) {
+    mutex_lock l(&mu_);
+    rings_.push_back(std::move(ring));
+  }
+
+  void Unregister(const Ring* ring) TF_LOCKS_EXCLUDED(mu_) {
+    mutex_lock l(&mu_);
+    rings_.erase(std::remove_if(rings_.begin(), rings_.end(),
+                                [ring](const std::shared_ptr<Ring>& r) {
+                                  return r.get() == ring;
+                                }),
+                 rings_.end());
+  }
+
+  std::vector<std::shared_ptr<Ring>> Rings() TF_LOCKS_EXCLUDED(mu_) {
+    mutex_lock l(&mu_);
+    return rings_;
+  }
+
+ private:
+  mutex mu_;
+  std::vector<std::shared_ptr<Ring>> rings_ TF_GUARDED_BY(mu_);
+};
+
+RingRegistry* GetRingRegistry() {
+  static RingRegistry* registry = new RingRegistry();
+  return registry;
+}
+
+// Unregisters the ring of a thread when the thread exits, the ring of an
+// exited thread is not dumped.
+struct RingOwner {
+  ~RingOwner() {
+    if (ring != nullptr) GetRingRegistry()->Unregister(ring.get());
+  }
+  std::shared_ptr<Ring> ring;
+};
+
+thread_local Ring* current_ring = nullptr;
+thread_local RingOwner ring_owner;
+
+Ring* CurrentRing() {
+  if (ITEX_PREDICT_TRUE(current_ring != nullptr)) return current_ring;
+  uint64 capacity = 1;
+  while (capacity < static_cast<uint64>(GetConfig().events_per_thread)) {
+    capacity <<= 1;
+  }
+  Env* env = Env::Default();
+  string thread_name;
+  env->GetCurrentThreadName(&thread_name);
+  ring_owner.ring = std::make_shared<Ring>(env->GetCurrentThreadId(),
+                                           std::move(thread_name), capacity);
+  GetRingRegistry()->Register(ring_owner.ring);
+  current_ring = ring_owner.ring.get();
+  return current_ring;
+}
+
+struct StepSlot {
+  std::atomic<int64> step_id{kNoStep};
+  std::atomic<uint64> start_nsecs{0};
+  std::atomic<bool> dumped{false};
+};
+
+StepSlot step_slots[kNumStepSlots];
+std::atomic<uint64> last_step_dump_nsecs{0};
+
+// Dumps are written by a background thread, woken up by a semaphore which the
+// signal handler can post to.
+sem_t dump_semaphore;
+std::atomic<int64> slow_step_id{kNoStep};
+std::atomic<uint64> slow_step_nsecs{0};
+
+void HandleDumpSignal(int /*signum*/) { sem_post(&dump_semaphore); }
+
+void DumpLoop() {
+  while (true) {
+    if (sem_wait(&dump_semaphore) != 0) continue;  // EINTR
+    const int64 step_id = slow_step_id.exchange(kNoStep);
+    string path;
+    Status status = Dump("", &path);
+    if (!status.ok()) {
+      ITEX_LOG(ERROR) << "Failed to dump the flight recorder: " << status;
+    } else if (step_id != kNoStep) {
+      ITEX_LOG(WARNING) << "Step " << step_id << " ran for "
+                        << slow_step_nsecs.load() / 1000000
+                        << " ms, dumped the flight recorder to " << path;
+    } else {
+      ITEX_LOG(WARNING) << "Dumped the flight recorder to " << path;
+    }
+  }
+}
+
+void StartDumpThread(const Config& config) {
+  if (config.signal <= 0 && config.step_threshold_nsecs == 0) return;
+  if (sem_init(&dump_semaphore, 0, 0) != 0) {
+    ITEX_LOG(ERROR) << "Unable to create the flight recorder dump semaphore.";
+    return;
+  }
+  std::thread(DumpLoop).detach();
+  if (config.signal > 0) {
+    struct sigaction action = {};
+    action.sa_handler = HandleDumpSignal;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(config.signal, &action, nullptr) != 0) {
+      ITEX_LOG(ERROR) << "Unable to install the flight recorder handler of "
+                      << "signal " << config.signal;
+    }
+  }
+}
+
+// Tracks the start of "step_id" and requests a dump when it has run for longer
+// than the threshold at "end_nsecs".
+void TrackStep(uint64 threshold_nsecs, int64 step_id, uint64 start_nsecs,
+               uint64 end_nsecs) {
+  StepSlot& slot = step_slots[static_cast<uint64>(step_id) % kNumStepSlots];
+  int64 current = slot.step_id.load(std::memory_order_acquire);
+  uint64 first_nsecs = start_nsecs;
+  if (current != step_id) {
+    // The first kernel of the step seen here claims the slot.
+    if (current == kClaimedStep ||
+        !slot.step_id.compare_exchange_strong(current, kClaimedStep,
+                                              std::memory_order_acquire)) {
+      return;
+    }
+    slot.start_nsecs.store(start_nsecs, std::memory_order_relaxed);
+    slot.dumped.store(false, std::memory_order_relaxed);
+    slot.step_id.store(step_id, std::memory_order_release);
+  } else {
+    first_nsecs =
+        std::min(first_nsecs, slot.start_nsecs.load(std::memory_order_relaxed));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    // The slot was claimed by another step while it was read.
+    if (slot.step_id.load(std::memory_order_relaxed) != step_id) return;
+  }
+
+  const uint64 step_nsecs = end_nsecs - first_nsecs;
+  if (step_nsecs <= threshold_nsecs ||
+      slot.dumped.load(std::memory_order_relaxed) ||
+      slot.dumped.exchange(true)) {
+    return;
+  }
+  uint64 last = last_step_dump_nsecs.load();
+  if (last != 0 && end_nsecs - last < kMinStepDumpIntervalSecs * 1000000000) {
+    return;
+  }
+  if (!last_step_dump_nsecs.compare_exchange_strong(last, end_nsecs)) return;
+  slow_step_nsecs.store(step_nsecs);
+  slow_step_id.store(step_id);
+  sem_post(&dump_semaphore);
+}
+
+}  // namespace
+
+bool IsEnabled() { return GetConfig().enabled; }
+
+int32 InternOp(absl::string_view name, absl::string_view type) {
+  if (!IsEnabled()) return -1;
+  return GetOpTable()->Intern(name, type);
+}
+
+void Record(int32 op_id, int64 step_id, uint64 start_nsecs, uint64 end_nsecs) {
+  CurrentRing()->Record(op_id, step_id, start_nsecs, end_nsecs);
+  const uint64 threshold_nsecs = GetConfig().step_threshold_nsecs;
+  if (threshold_nsecs > 0) {
+    TrackStep(threshold_nsecs, step_id, start_nsecs, end_nsecs);
+  }
+}
+
+std::string ChromeTrace() {
+  struct ThreadEvents {
+    std::shared_ptr<Ring> ring;
+    std::vector<Event> events;
+  };
+  std::vector<ThreadEvents> threads;
+  uint64 base_nsecs = std::numeric_limits<uint64>::max();
+  for (auto& ring : GetRingRegistry()->Rings()) {
+    threads.push_back({std::move(ring), {}});
+    threads.back().ring->Snapshot(&threads.back().events);
+    for (const Event& event : threads.back().events) {
+      base_nsecs = std::min(base_nsecs, event.start_nsecs);
+    }
+  }
+  if (base_nsecs == std::numeric_limits<uint64>::max()) base_nsecs = 0;
+
+  // Times are relative to the first run, microseconds since the epoch do not
+  // fit the precision of a double with nanoseconds.
+  const int pid = getpid();
+  string json;
+  absl::StrAppend(&json, "{\"displayTimeUnit\": \"ns\", \"otherData\": ",
+                  "{\"base_unix_nsecs\": ", base_nsecs,
+                  "}, \"traceEvents\": [");
+  bool first = true;
+  auto append = [&json, &first](const string& event) {
+    absl::StrAppend(&json, first ? "\n" : ",\n", event);
+    first = false;
+  };
+  OpTable* table = GetOpTable();
+  mutex_lock l(table->mu());
+  for (const ThreadEvents& thread : threads) {
+    append(absl::StrCat("{\"name\": \"thread_name\", \"ph\": \"M\", ",
+                        "\"pid\": ", pid, ", \"tid\": ", thread.ring->tid(),
+                        ", \"args\": {\"name\": ",
+                        str_util::JsonString(thread.ring->thread_name()),
+                        "}}"));
+    for (const Event& event : thread.events) {
+      if (event.op_id < 0 || event.end_nsecs < event.start_nsecs) continue;
+      const auto& op = table->op(event.op_id);
+      append(absl::StrFormat(
+          "{\"name\": %s, \"cat\": %s, \"ph\": \"X\", \"pid\": %d, "
+          "\"tid\": %d, \"ts\": %.3f, \"dur\": %.3f, "
+          "\"args\": {\"step_id\": %d}}",
+          str_util::JsonString(op.first), str_util::JsonString(op.second), pid,
+          thread.ring->tid(), (event.start_nsecs - base_nsecs) / 1000.0,
+          (event.end_nsecs - event.start_nsecs) / 1000.0, event.step_id));
+    }
+  }
+  absl::StrAppend(&json, "\n]}\n");
+  return json;
+}
+
+Status Dump(const std::string& path, std::string* written_path) {
+  string file = path;
+  if (file.empty()) {
+    static std::atomic<int> count(0);
+    file = absl::StrCat(GetConfig().dir, "/itex_flight_recorder_", getpid(),
+                        "_", count++, ".json");
+  }
+  std::ofstream output(file, std::ios::out);
+  if (!output.is_open()) {
+    return errors::Internal("Unable to create flight recorder dump '", file,
+                            "'.");
+  }
+  output << ChromeTrace();
+  if (!output.good()) {
+    return errors::Internal("Failed to write flight recorder dump '", file,
+                            "'.");
+  }
+  if (written_path != nullptr) *written_path = file;
+  return Status::OK();
+}
+
+}  // namespace flight_recorder
+
+ScopedFlightRecord::ScopedFlightRecord(const OpKernel* op,
+                                       OpKernelContext* context)
+    : op_id_(op->flight_op_id()),
+      context_(context),
+      start_nsecs_(op_id_ < 0 ? 0 : EnvTime::NowNanos()) {}
+
+ScopedFlightRecord::~ScopedFlightRecord() {
+  if (op_id_ < 0) return;
+  flight_recorder::Record(op_id_, context_->step_id(), start_nsecs_,
+                          EnvTime::NowNanos());
+}
+
+}  // namespace itex
+
+int itex_dump_flight_recorder(const char* path) {
+  itex::Status status =
+      itex::flight_recorder::Dump(path == nullptr ? "" : path, nullptr);
+  if (!status.ok()) {
+    ITEX_LOG(ERROR) << "Failed to dump the flight recorder: " << status;
+    return -1;
+  }
+  return 0;
+}
@@ -0,0 +1,78 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef ITEX_CORE_UTILS_FLIGHT_RECORDER_H_
+#define ITEX_CORE_UTILS_FLIGHT_RECORDER_H_
+
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "itex/core/utils/status.h"
+#include "itex/core/utils/types.h"
+
+namespace itex {
+namespace flight_recorder {
+
+// Always-on flight recorder of the kernel runs, for tail latency debugging.
+//
+// Unlike TraceMeRecorder, which records the events of a profiling session, the
+// flight recorder never stops: every thread that runs kernels keeps its most
+// recent ITEX_FLIGHT_RECORDER_EVENTS runs in a ring buffer, with the node, the
+// step id and the start and end time. Recording a run takes two clock reads
+// and a few stores to memory owned by the thread, without locks or
+// allocations, so the recorder stays on unless ITEX_FLIGHT_RECORDER=0.
+// kernels/benchmark:flight_recorder_benchmark measures the cost on a
+// kernel-heavy step.
+//
+// The rings are dumped in Chrome trace format, for chrome://tracing or
+// Perfetto:
+//   - on demand, with Dump() or itex_dump_flight_recorder(),
+//   - on the signal ITEX_FLIGHT_RECORDER_SIGNAL,
+//   - when a step runs for longer than ITEX_FLIGHT_RECORDER_STEP_MS. The step
+//     is timed from the start of its first kernel to the end of its latest
+//     kernel, and such dumps are at most one every kMinStepDumpIntervalSecs.
+// The dumps of the last two are written to ITEX_FLIGHT_RECORDER_DIR by a
+// background thread.
+
+constexpr int64 kMinStepDumpIntervalSecs = 10;
+
+// Whether ITEX_FLIGHT_RECORDER is on, which is the default.
+bool IsEnabled();
+
+// Returns the id of the node "name" of op "type" for Record(), or -1 if the
+// recorder is disabled. Kernels of the same node share their id.
+int32 InternOp(absl::string_view name, absl::string_view type);
+
+// Records a run of the op "op_id" in "step_id" on the calling thread.
+void Record(int32 op_id, int64 step_id, uint64 start_nsecs, uint64 end_nsecs);
+
+// Returns the runs in the rings of all threads in Chrome trace format.
+std::string ChromeTrace();
+
+// Writes ChromeTrace() to "path", or to a new file in ITEX_FLIGHT_RECORDER_DIR
+// if "path" is empty. Returns the path of the file in "written_path" if it is
+// not nullptr.
+Status Dump(const std::string& path, std::string* written_path);
+
+}  // namespace flight_recorder
+}  // namespace itex
+
+extern "C" {
+// Dumps the flight recorder to "path", or to ITEX_FLIGHT_RECORDER_DIR if "path"
+// is nullptr or empty. Returns 0 on success, -1 on failure.
+int itex_dump_flight_recorder(const char* path);
+}
+
+#endif  // ITEX_CORE_UTILS_FLIGHT_RECORDER_H_
@@ -0,0 +1,106 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "itex/core/utils/graph_metrics.h"
+
+#include <string>
+
+#include "itex/core/utils/counter.h"
+#include "itex/core/utils/gauge.h"
+#include "itex/core/utils/sampler.h"
+
+namespace itex {
+namespace metrics {
+
+namespace {
+
+using monitoring::Buckets;
+using monitoring::Counter;
+using monitoring::Gauge;
+using monitoring::Sampler;
+
+// 10us to ~170s.
+auto* optimize_usecs = Sampler<0>::New(
+    {"/itex/graph/optimize_usecs",
+     "Time of the whole ITEX graph optimization of a graph, in microseconds."},
+    Buckets::Exponential(10, 4, 13));
+
+auto* pass_usecs = Sampler<1>::New(
+    {"/itex/graph/pass_usecs",
+     "Time of one ITEX graph optimizer pass, in microseconds.", "pass"},
+    Buckets::Exponential(10, 4, 13));
+
+auto* pass_nodes = Gauge<int64, 2>::New(
+    "/itex/graph/pass_nodes",
+    "Nodes of the graph before and after the last run of a pass.", "pass",
+    "stage");
+
+auto* pass_edges = Gauge<int64, 2>::New(
+    "/itex/graph/pass_edges",
+    "Data and control edges of the graph before and after the last run of a "
+    "pass.",
+    "pass", "stage");
+
+auto* shape_inference_usecs = Sampler<1>::New(
+    {"/itex/graph/shape_inference_usecs",
+     "Time of static shape inference in a pass, in microseconds.", "pass"},
+    Buckets::Exponential(10, 4, 13));
+
+auto* fusions = Counter<1>::New("/itex/graph/fusions",
+                                "Number of fusions applied by the remapper.",
+                                "pattern");
+
+thread_local absl::string_view current_graph_pass;
+
+std::string Label(absl::string_view value) {
+  return value.empty() ? std::string("unknown") : std::string(value);
+}
+
+}  // namespace
+
+void RecordGraphOptimization(uint64 usecs) {
+  static monitoring::SamplerCell* const cell = optimize_usecs->GetCell();
+  cell->Add(usecs);
+}
+
+void RecordGraphPass(absl::string_view pass, uint64 usecs,
+                     const GraphSize& before, const GraphSize& after) {
+  const std::string label = Label(pass);
+  pass_usecs->GetCell(label)->Add(usecs);
+  pass_nodes->GetCell(label, "before")->Set(before.nodes);
+  pass_nodes->GetCell(label, "after")->Set(after.nodes);
+  pass_edges->GetCell(label, "before")->Set(before.edges);
+  pass_edges->GetCell(label, "after")->Set(after.edges);
+}
+
+void RecordShapeInference(absl::string_view pass, uint64 usecs) {
+  shape_inference_usecs->GetCell(Label(pass))->Add(usecs);
+}
+
+void RecordFusion(absl::string_view pattern) {
+  fusions->GetCell(Label(pattern))->IncrementBy(1);
+}
+
+absl::string_view CurrentGraphPass() { return current_graph_pass; }
+
+ScopedGraphPass::ScopedGraphPass(absl::string_view pass)
+    : previous_(current_graph_pass) {
+  current_graph_pass = pass;
+}
+
+ScopedGraphPass::~ScopedGraphPass() { current_graph_pass = previous_; }
+
+}  // namespace metrics
+}  // namespace itex
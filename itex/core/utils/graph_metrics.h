@@ -0,0 +1,70 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef ITEX_CORE_UTILS_GRAPH_METRICS_H_
+#define ITEX_CORE_UTILS_GRAPH_METRICS_H_
+
+#include "absl/strings/string_view.h"
+#include "itex/core/utils/macros.h"
+#include "itex/core/utils/types.h"
+
+namespace itex {
+namespace metrics {
+
+// Metrics of the ITEX graph optimizer, exported with the other metrics of the
+// CollectionRegistry:
+//
+//   /itex/graph/optimize_usecs                 histogram of whole pipeline runs
+//   /itex/graph/pass_usecs{pass}               histogram of each pass
+//   /itex/graph/pass_nodes{pass,stage}         nodes before/after the last run
+//   /itex/graph/pass_edges{pass,stage}         edges before/after the last run
+//   /itex/graph/shape_inference_usecs{pass}    histogram of InferStatically
+//   /itex/graph/fusions{pattern}               remapper fusions applied
+
+struct GraphSize {
+  int64 nodes = 0;
+  // Data and control inputs of all nodes.
+  int64 edges = 0;
+};
+
+void RecordGraphOptimization(uint64 usecs);
+
+void RecordGraphPass(absl::string_view pass, uint64 usecs,
+                     const GraphSize& before, const GraphSize& after);
+
+void RecordShapeInference(absl::string_view pass, uint64 usecs);
+
+void RecordFusion(absl::string_view pattern);
+
+// Name of the graph pass the calling thread is running, empty outside of one.
+// Lets shared helpers such as shape inference attribute their time to it.
+absl::string_view CurrentGraphPass();
+
+// Makes "pass" the current graph pass for the lifetime of the object.
+class ScopedGraphPass {
+ public:
+  explicit ScopedGraphPass(absl::string_view pass);
+  ~ScopedGraphPass();
+
+ private:
+  absl::string_view previous_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(ScopedGraphPass);
+};
+
+}  // namespace metrics
+}  // namespace itex
+
+#endif  // ITEX_CORE_UTILS_GRAPH_METRICS_H_
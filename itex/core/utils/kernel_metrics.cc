@@ -0,0 +1,274 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "itex/core/utils/kernel_metrics.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "absl/strings/str_replace.h"
+#ifdef INTEL_CPU_ONLY
+#include "itex/core/devices/cpu/huge_page_arena.h"
+#endif  // INTEL_CPU_ONLY
+#include "itex/core/utils/collection_registry.h"
+#include "itex/core/utils/counter.h"
+#include "itex/core/utils/gauge.h"
+#include "itex/core/utils/sampler.h"
+#include "itex/core/utils/strcat.h"
+
+namespace itex {
+namespace metrics {
+
+namespace {
+
+using monitoring::Buckets;
+using monitoring::Counter;
+using monitoring::CounterCell;
+using monitoring::Gauge;
+using monitoring::Sampler;
+
+auto* primitive_creations = Counter<1>::New(
+    "/itex/kernels/primitive_creations",
+    "Number of oneDNN primitives created by ITEX kernels.", "op_type");
+
+// 1us to ~4s.
+auto* primitive_creation_usecs = Sampler<1>::New(
+    {"/itex/kernels/primitive_creation_usecs",
+     "Time to create a oneDNN primitive, in microseconds.", "op_type"},
+    Buckets::Exponential(1, 4, 12));
+
+auto* reorders = Counter<0>::New("/itex/kernels/reorders",
+                                 "Number of ReorderMemory calls.");
+
+auto* reorder_bytes = Counter<0>::New(
+    "/itex/kernels/reorder_bytes", "Bytes written by ReorderMemory calls.");
+
+auto* cache_lookups = Counter<2>::New(
+    "/itex/kernels/cache_lookups",
+    "Hits and misses of the weight and bias caches of oneDNN kernels.",
+    "cache", "result");
+
+auto* host_data_copies = Counter<0>::New(
+    "/itex/kernels/host_data_copies",
+    "Number of host buffers copied again by a HostDataCache.");
+
+auto* host_data_copy_bytes =
+    Counter<0>::New("/itex/kernels/host_data_copy_bytes",
+                    "Bytes copied again by HostDataCaches.");
+
+auto* onednn_to_tf_bytes = Counter<0>::New(
+    "/itex/kernels/onednn_to_tf_bytes",
+    "Bytes converted from oneDNN block layout to TF layout by _OneDnnToTf.");
+
+auto* op_runs = Counter<1>::New(
+    "/itex/kernels/op_runs", "Runs of ITEX kernels, with ITEX_OP_COST set.",
+    "op_type");
+
+auto* op_nsecs = Counter<1>::New(
+    "/itex/kernels/op_nsecs",
+    "Host time of ITEX kernel runs, in nanoseconds, with ITEX_OP_COST set.",
+    "op_type");
+
+auto* op_flops = Counter<1>::New(
+    "/itex/kernels/op_flops",
+    "Analytical FLOPs of ITEX kernel runs, with ITEX_OP_COST set.", "op_type");
+
+auto* op_bytes = Counter<1>::New(
+    "/itex/kernels/op_bytes",
+    "Bytes of the inputs and outputs of ITEX kernel runs, with ITEX_OP_COST "
+    "set.",
+    "op_type");
+
+auto* huge_page_bytes = Gauge<int64, 1>::New(
+    "/itex/kernels/huge_page_bytes",
+    "Bytes mapped by the huge page arena, by the pages backing them.",
+    "backing");
+
+CounterCell* CacheCell(CacheKind cache, bool hit) {
+  static CounterCell* const cells[2][2] = {
+      {cache_lookups->GetCell("weight", "miss"),
+       cache_lookups->GetCell("weight", "hit")},
+      {cache_lookups->GetCell("bias", "miss"),
+       cache_lookups->GetCell("bias", "hit")}};
+  return cells[cache == CacheKind::kBias][hit];
+}
+
+// Sets the huge page gauges from the arena, whose counts change with every
+// region it maps.
+void UpdateHugePageBytes() {
+#ifdef INTEL_CPU_ONLY
+  HugePageArena* arena = HugePageArena::Global();
+  if (arena == nullptr) return;
+  const HugePageSubAllocator::Stats pages = arena->GetStats().pages;
+  huge_page_bytes->GetCell("hugetlb")->Set(pages.hugetlb_bytes);
+  huge_page_bytes->GetCell("transparent")->Set(pages.transparent_bytes);
+  huge_page_bytes->GetCell("fallback")->Set(pages.fallback_bytes);
+#endif  // INTEL_CPU_ONLY
+}
+
+// "/itex/kernels/reorders" -> "itex_kernels_reorders".
+std::string PrometheusName(const std::string& name) {
+  std::string result = absl::StrReplaceAll(name, {{"/", "_"}, {"-", "_"}});
+  if (!result.empty() && result[0] == '_') result.erase(0, 1);
+  return result;
+}
+
+// Returns {name="value",...}, with "extra" appended, or nothing if there are
+// no labels.
+std::string PrometheusLabels(const monitoring::Point& point,
+                             const std::string& extra = "") {
+  std::vector<std::string> labels;
+  for (const auto& label : point.labels) {
+    labels.push_back(strings::StrCat(
+        label.name, "=\"",
+        absl::StrReplaceAll(label.value, {{"\\", "\\\\"}, {"\"", "\\\""}}),
+        "\""));
+  }
+  if (!extra.empty()) labels.push_back(extra);
+  if (labels.empty()) return "";
+  std::string result = "{";
+  for (size_t i = 0; i < labels.size(); ++i) {
+    strings::StrAppend(&result, i == 0 ? "" : ",", labels[i]);
+  }
+  return strings::StrCat(result, "}");
+}
+
+void AppendPoint(const std::string& name, const monitoring::Point& point,
+                 std::string* text) {
+  switch (point.value_type) {
+    case monitoring::ValueType::kInt64:
+      strings::StrAppend(text, name, PrometheusLabels(point), " ",
+                         point.int64_value, "\n");
+      break;
+    case monitoring::ValueType::kBool:
+      strings::StrAppend(text, name, PrometheusLabels(point), " ",
+                         point.bool_value ? 1 : 0, "\n");
+      break;
+    case monitoring::ValueType::kHistogram: {
+      const monitoring::Histogram& histogram = point.histogram_value;
+      double cumulative = 0;
+      for (size_t i = 0; i < histogram.bucket.size(); ++i) {
+        cumulative += histogram.bucket[i];
+        const std::string le =
+            histogram.bucket_limit[i] == DBL_MAX
+                ? std::string("+Inf")
+                : strings::StrCat(histogram.bucket_limit[i]);
+        strings::StrAppend(text, name, "_bucket",
+                           PrometheusLabels(point, "le=\"" + le + "\""), " ",
+                           cumulative, "\n");
+      }
+      strings::StrAppend(text, name, "_sum", PrometheusLabels(point), " ",
+                         histogram.sum, "\n");
+      strings::StrAppend(text, name, "_count", PrometheusLabels(point), " ",
+                         histogram.num, "\n");
+      break;
+    }
+    default:
+      // Strings and percentiles have no Prometheus counterpart.
+      break;
+  }
+}
+
+const char* PrometheusType(const monitoring::MetricDescriptor& descriptor) {
+  if (descriptor.value_type == monitoring::ValueType::kHistogram) {
+    return "histogram";
+  }
+  return descriptor.metric_kind == monitoring::MetricKind::kCumulative
+             ? "counter"
+             : "gauge";
+}
+
+}  // namespace
+
+void RecordPrimitiveCreation(absl::string_view op_type, uint64 usecs) {
+  const std::string label =
+      op_type.empty() ? std::string("unknown") : std::string(op_type);
+  primitive_creations->GetCell(label)->IncrementBy(1);
+  primitive_creation_usecs->GetCell(label)->Add(usecs);
+}
+
+void RecordReorder(uint64 bytes) {
+  static CounterCell* const count = reorders->GetCell();
+  static CounterCell* const total_bytes = reorder_bytes->GetCell();
+  count->IncrementBy(1);
+  total_bytes->IncrementBy(bytes);
+}
+
+void RecordCacheHit(CacheKind cache) {
+  CacheCell(cache, /*hit=*/true)->IncrementBy(1);
+}
+
+void RecordCacheMiss(CacheKind cache) {
+  CacheCell(cache, /*hit=*/false)->IncrementBy(1);
+}
+
+void RecordHostDataCopy(uint64 bytes) {
+  static CounterCell* const count = host_data_copies->GetCell();
+  static CounterCell* const total_bytes = host_data_copy_bytes->GetCell();
+  count->IncrementBy(1);
+  total_bytes->IncrementBy(bytes);
+}
+
+void RecordOneDnnToTf(uint64 bytes) {
+  static CounterCell* const total_bytes = onednn_to_tf_bytes->GetCell();
+  total_bytes->IncrementBy(bytes);
+}
+
+void RecordOpCost(absl::string_view op_type, int64 flops, int64 bytes,
+                  uint64 nsecs) {
+  const std::string label =
+      op_type.empty() ? std::string("unknown") : std::string(op_type);
+  op_runs->GetCell(label)->IncrementBy(1);
+  op_nsecs->GetCell(label)->IncrementBy(nsecs);
+  op_flops->GetCell(label)->IncrementBy(flops);
+  op_bytes->GetCell(label)->IncrementBy(bytes);
+}
+
+std::string MetricsText() {
+  UpdateHugePageBytes();
+  std::unique_ptr<monitoring::CollectedMetrics> collected =
+      monitoring::CollectionRegistry::Default()->CollectMetrics({});
+  std::string text;
+  for (const auto& entry : collected->point_set_map) {
+    const std::string name = PrometheusName(entry.first);
+    auto descriptor = collected->metric_descriptor_map.find(entry.first);
+    if (descriptor != collected->metric_descriptor_map.end()) {
+      strings::StrAppend(&text, "# HELP ", name, " ",
+                         descriptor->second->description, "\n");
+      strings::StrAppend(&text, "# TYPE ", name, " ",
+                         PrometheusType(*descriptor->second), "\n");
+    }
+    for (const auto& point : entry.second->points) {
+      AppendPoint(name, *point, &text);
+    }
+  }
+  return text;
+}
+
+}  // namespace metrics
+}  // namespace itex
+
+size_t itex_get_kernel_metrics(char* buffer, size_t size) {
+  const std::string text = itex::metrics::MetricsText();
+  if (buffer != nullptr && size > 0) {
+    const size_t length = std::min(text.size(), size - 1);
+    memcpy(buffer, text.data(), length);
+    buffer[length] = '\0';
+  }
+  return text.size() + 1;
+}
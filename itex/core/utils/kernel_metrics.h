@@ -0,0 +1,85 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef ITEX_CORE_UTILS_KERNEL_METRICS_H_
+#define ITEX_CORE_UTILS_KERNEL_METRICS_H_
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "itex/core/utils/types.h"
+
+namespace itex {
+namespace metrics {
+
+// Cumulative metrics of the work ITEX kernels do besides computing, exported
+// with the other metrics of the CollectionRegistry:
+//
+//   /itex/kernels/primitive_creations{op_type}          oneDNN primitives built
+//   /itex/kernels/primitive_creation_usecs{op_type}     histogram of their time
+//   /itex/kernels/reorders, /itex/kernels/reorder_bytes ReorderMemory calls
+//   /itex/kernels/cache_lookups{cache,result}           weight and bias caches
+//   /itex/kernels/host_data_copies, ..._bytes           HostDataCache copies
+//   /itex/kernels/onednn_to_tf_bytes                    _OneDnnToTf conversions
+//
+// the current bytes of the huge page arena, with ITEX_HUGE_PAGE_ARENA set:
+//
+//   /itex/kernels/huge_page_bytes{backing}    hugetlb, transparent, fallback
+//
+// and, with ITEX_OP_COST set, the analytical cost of every kernel run:
+//
+//   /itex/kernels/op_runs{op_type}, /itex/kernels/op_nsecs{op_type}
+//   /itex/kernels/op_flops{op_type}, /itex/kernels/op_bytes{op_type}
+
+void RecordPrimitiveCreation(absl::string_view op_type, uint64 usecs);
+
+void RecordReorder(uint64 bytes);
+
+enum class CacheKind { kWeight, kBias };
+// A hit is a lookup served from the cache. A miss is a fill of the cache, or
+// a lookup that found it in another format, both of which cost a reorder.
+void RecordCacheHit(CacheKind cache);
+void RecordCacheMiss(CacheKind cache);
+
+void RecordHostDataCopy(uint64 bytes);
+
+void RecordOneDnnToTf(uint64 bytes);
+
+void RecordOpCost(absl::string_view op_type, int64 flops, int64 bytes,
+                  uint64 nsecs);
+
+// Returns every metric of the CollectionRegistry in the Prometheus text
+// format, with names like itex_kernels_reorders.
+std::string MetricsText();
+
+}  // namespace metrics
+}  // namespace itex
+
+extern "C" {
+#endif  // __cplusplus
+
+// Writes the metrics in the Prometheus text format, NUL terminated, into
+// "buffer" of "size" bytes, truncating them if they do not fit. Returns the
+// size needed for all of them, including the NUL.
+size_t itex_get_kernel_metrics(char* buffer, size_t size);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // ITEX_CORE_UTILS_KERNEL_METRICS_H_
@@ -0,0 +1,109 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "itex/core/utils/lib/random/philox_random.h"
+
+#include <cstdio>
+
+#include "itex/core/utils/logging.h"
+#include "itex/core/utils/types.h"
+
+// PhiloxRandomVec must produce the same stream as PhiloxRandom, since the CPU
+// random kernels switched to it without changing their outputs.
+
+namespace itex {
+namespace random {
+namespace {
+
+constexpr int kInvocations = 5;
+
+// Checks kInvocations calls of PhiloxRandomVec<Lanes> against the scalar
+// generator started from the same counter and key.
+template <int Lanes>
+void CheckSameStream(const PhiloxRandom& gen) {
+  PhiloxRandom scalar = gen;
+  PhiloxRandomVec<Lanes> vec(gen);
+  for (int i = 0; i < kInvocations; ++i) {
+    const typename PhiloxRandomVec<Lanes>::ResultType lanes = vec();
+    for (int l = 0; l < Lanes; ++l) {
+      const PhiloxRandom::ResultType expected = scalar();
+      for (int j = 0; j < PhiloxRandom::kResultElementCount; ++j) {
+        ITEX_CHECK_EQ(lanes[PhiloxRandom::kResultElementCount * l + j],
+                      expected[j])
+            << "invocation " << i << ", lane " << l << ", element " << j;
+      }
+    }
+  }
+}
+
+template <int Lanes>
+void CheckSameStream(PhiloxRandom::ResultType counter,
+                     PhiloxRandom::Key key) {
+  CheckSameStream<Lanes>(PhiloxRandom(counter, key));
+}
+
+void TestSeeds() {
+  for (uint64 seed : {0ull, 1ull, 301ull, 0x0123456789abcdefull}) {
+    CheckSameStream<16>(PhiloxRandom(seed));
+    CheckSameStream<8>(PhiloxRandom(seed, ~seed));
+    CheckSameStream<1>(PhiloxRandom(seed));
+  }
+}
+
+// The lanes add their index to the 128-bit counter, so the carries across the
+// 32-bit words must match the scalar Skip.
+void TestCounterCarry() {
+  const uint32 kMax = 0xffffffffu;
+  PhiloxRandom::Key key;
+  key[0] = 0x9e3779b9u;
+  key[1] = 0x7f4a7c15u;
+  PhiloxRandom::ResultType counter;
+  const uint32 words[][4] = {{kMax - 3, 0, 0, 0},
+                             {kMax - 3, kMax, 0, 7},
+                             {kMax - 3, kMax, kMax, 7},
+                             {kMax - 3, kMax, kMax, kMax},
+                             {kMax, kMax - 1, kMax, kMax}};
+  for (const auto& w : words) {
+    for (int i = 0; i < 4; ++i) counter[i] = w[i];
+    CheckSameStream<16>(counter, key);
+    CheckSameStream<8>(counter, key);
+  }
+}
+
+void TestSkip() {
+  for (uint64 count : {1ull, 3ull, 1000ull, 0x100000000ull}) {
+    PhiloxRandom scalar(301, 7);
+    PhiloxRandomVec<16> vec(scalar);
+    vec.Skip(count);
+    scalar.Skip(count * 16);
+    const PhiloxRandomVec<16>::ResultType lanes = vec();
+    const PhiloxRandom::ResultType expected = scalar();
+    for (int j = 0; j < PhiloxRandom::kResultElementCount; ++j) {
+      ITEX_CHECK_EQ(lanes[j], expected[j]) << "skip " << count;
+    }
+  }
+}
+
+}  // namespace
+}  // namespace random
+}  // namespace itex
+
+int main() {
+  itex::random::TestSeeds();
+  itex::random::TestCounterCarry();
+  itex::random::TestSkip();
+  std::printf("PASSED\n");
+  return 0;
+}
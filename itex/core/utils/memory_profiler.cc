@@ -0,0 +1,431 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "itex/core/utils/memory_profiler.h"
+
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <mutex>  // NOLINT(build/c++11)
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
+#include "itex/core/utils/env_time.h"
+#include "itex/core/utils/env_var.h"
+#include "itex/core/utils/mutex.h"
+#include "itex/core/utils/op_kernel.h"
+#include "itex/core/utils/str_util.h"
+#include "itex/core/utils/tensor_shape.h"
+
+namespace itex {
+
+namespace {
+
+constexpr int kNumKinds = 4;
+constexpr const char* kKindNames[kNumKinds] = {"output", "temp", "persistent",
+                                               "cache"};
+
+// Steps whose peak is kept for the report, and the most recent steps that an
+// allocation looks for its own among. More steps than that run concurrently
+// only with inter-op parallelism over many graphs.
+constexpr size_t kMaxSteps = 1024;
+constexpr size_t kMaxConcurrentSteps = 8;
+
+// Samples of the timeline that are kept, the oldest are dropped, and nodes
+// with the most live bytes listed in each sample.
+constexpr size_t kMaxTimelineSamples = 4096;
+constexpr size_t kTimelineTopNodes = 8;
+
+thread_local int current_memory_kind = -1;
+
+class MemoryProfiler {
+ public:
+  // A tracked buffer, the argument of its deallocator.
+  struct Allocation {
+    int node;
+    MemoryKind kind;
+    int64 bytes;
+    void (*deallocator)(void*, size_t, void*);
+    void* deallocator_arg;
+  };
+
+  // Returns the profiler, nullptr if it is disabled.
+  static MemoryProfiler* Get() {
+    static MemoryProfiler* profiler =
+        IsMemoryProfileEnabled() ? new MemoryProfiler() : nullptr;
+    return profiler;
+  }
+
+  Allocation* Allocate(MemoryKind kind, int64 step_id, int64 bytes,
+                       void (*deallocator)(void*, size_t, void*),
+                       void* deallocator_arg) TF_LOCKS_EXCLUDED(mu_) {
+    mutex_lock l(&mu_);
+    const int node = CurrentNode();
+    NodeStats& stats = nodes_[node];
+    stats.live[static_cast<int>(kind)] += bytes;
+    stats.live_bytes += bytes;
+    stats.peak_bytes = std::max(stats.peak_bytes, stats.live_bytes);
+    stats.allocated_bytes += bytes;
+    ++stats.allocations;
+
+    live_bytes_ += bytes;
+    StepPeak& step = Step(step_id);
+    step.peak_bytes = std::max(step.peak_bytes, live_bytes_);
+    if (live_bytes_ > peak_bytes_) {
+      peak_bytes_ = live_bytes_;
+      peak_step_ = step_id;
+      peak_node_ = node;
+      SnapshotPeak();
+    }
+    MaybeSample();
+    return new Allocation{node, kind, bytes, deallocator, deallocator_arg};
+  }
+
+  void Release(const Allocation& allocation) TF_LOCKS_EXCLUDED(mu_) {
+    mutex_lock l(&mu_);
+    NodeStats& stats = nodes_[allocation.node];
+    stats.live[static_cast<int>(allocation.kind)] -= allocation.bytes;
+    stats.live_bytes -= allocation.bytes;
+    live_bytes_ -= allocation.bytes;
+    MaybeSample();
+  }
+
+  void RecordUntracked(int64 bytes) TF_LOCKS_EXCLUDED(mu_) {
+    mutex_lock l(&mu_);
+    NodeStats& stats = nodes_[CurrentNode()];
+    stats.untracked_bytes += bytes;
+    ++stats.untracked_allocations;
+  }
+
+  string ToJson(int top_n) TF_LOCKS_EXCLUDED(mu_) {
+    mutex_lock l(&mu_);
+    const size_t limit = std::max(top_n, 0);
+    string json;
+    absl::StrAppend(&json, "{\n  \"live_bytes\": ", live_bytes_,
+                    ",\n  \"peak_bytes\": ", peak_bytes_,
+                    ",\n  \"peak_step\": ", peak_step_, ",\n  \"peak_node\": ",
+                    str_util::JsonString(
+                        peak_node_ < 0 ? "" : nodes_[peak_node_].name),
+                    ",\n");
+
+    std::vector<std::pair<int, Bytes>> at_peak = at_peak_;
+    std::sort(at_peak.begin(), at_peak.end(),
+              [](const std::pair<int, Bytes>& a,
+                 const std::pair<int, Bytes>& b) {
+                return Total(a.second) > Total(b.second);
+              });
+    absl::StrAppend(&json, "  \"top_at_peak\": [");
+    for (size_t i = 0; i < at_peak.size() && i < limit; ++i) {
+      const NodeStats& stats = nodes_[at_peak[i].first];
+      absl::StrAppend(&json, i ? "," : "",
+                      "\n    {\"node\": ", str_util::JsonString(stats.name),
+                      ", \"op\": ", str_util::JsonString(stats.op),
+                      ", \"bytes\": ", Total(at_peak[i].second));
+      for (int kind = 0; kind < kNumKinds; ++kind) {
+        absl::StrAppend(&json, ", \"", kKindNames[kind],
+                        "\": ", at_peak[i].second[kind]);
+      }
+      absl::StrAppend(&json, "}");
+    }
+    absl::StrAppend(&json, at_peak.empty() ? "" : "\n  ", "],\n");
+
+    std::vector<int> by_peak;
+    for (int node = 0; node < static_cast<int>(nodes_.size()); ++node) {
+      if (nodes_[node].allocations || nodes_[node].untracked_allocations ||
+          nodes_[node].live_bytes) {
+        by_peak.push_back(node);
+      }
+    }
+    std::sort(by_peak.begin(), by_peak.end(), [this](int a, int b) {
+      return nodes_[a].peak_bytes > nodes_[b].peak_bytes;
+    });
+    absl::StrAppend(&json, "  \"top_nodes\": [");
+    for (size_t i = 0; i < by_peak.size() && i < limit; ++i) {
+      const NodeStats& stats = nodes_[by_peak[i]];
+      absl::StrAppend(
+          &json, i ? "," : "", "\n    {\"node\": ",
+          str_util::JsonString(stats.name), ", \"op\": ",
+          str_util::JsonString(stats.op),
+          ", \"live_bytes\": ", stats.live_bytes,
+          ", \"peak_bytes\": ", stats.peak_bytes,
+          ", \"allocated_bytes\": ", stats.allocated_bytes,
+          ", \"allocations\": ", stats.allocations,
+          ", \"untracked_bytes\": ", stats.untracked_bytes,
+          ", \"untracked_allocations\": ", stats.untracked_allocations, "}");
+    }
+    absl::StrAppend(&json, by_peak.empty() ? "" : "\n  ", "],\n");
+
+    absl::StrAppend(&json, "  \"steps\": [");
+    for (size_t i = 0; i < steps_.size(); ++i) {
+      absl::StrAppend(&json, i ? "," : "",
+                      "\n    {\"step\": ", steps_[i].step_id,
+                      ", \"peak_bytes\": ", steps_[i].peak_bytes, "}");
+    }
+    absl::StrAppend(&json, steps_.empty() ? "" : "\n  ", "],\n");
+
+    absl::StrAppend(&json, "  \"timeline\": [");
+    for (size_t i = 0; i < timeline_.size(); ++i) {
+      const Sample& sample = timeline_[i];
+      absl::StrAppend(&json, i ? "," : "", "\n    {\"usecs\": ", sample.usecs,
+                      ", \"live_bytes\": ", sample.live_bytes,
+                      ", \"nodes\": [");
+      for (size_t j = 0; j < sample.nodes.size(); ++j) {
+        const NodeStats& stats = nodes_[sample.nodes[j].first];
+        absl::StrAppend(&json, j ? ", " : "", "{\"node\": ",
+                        str_util::JsonString(stats.name), ", \"bytes\": ",
+                        sample.nodes[j].second, "}");
+      }
+      absl::StrAppend(&json, "]}");
+    }
+    absl::StrAppend(&json, timeline_.empty() ? "" : "\n  ", "]\n}\n");
+    return json;
+  }
+
+  void Reset() TF_LOCKS_EXCLUDED(mu_) {
+    mutex_lock l(&mu_);
+    for (NodeStats& stats : nodes_) {
+      stats.peak_bytes = stats.live_bytes;
+      stats.allocated_bytes = 0;
+      stats.allocations = 0;
+      stats.untracked_bytes = 0;
+      stats.untracked_allocations = 0;
+    }
+    peak_bytes_ = live_bytes_;
+    peak_step_ = -1;
+    peak_node_ = -1;
+    steps_.clear();
+    timeline_.clear();
+    start_nanos_ = EnvTime::NowNanos();
+    SnapshotPeak();
+  }
+
+ private:
+  using Bytes = std::array<int64, kNumKinds>;
+
+  struct NodeStats {
+    string name;
+    string op;
+    // Live bytes per MemoryKind.
+    Bytes live = {};
+    int64 live_bytes = 0;
+    int64 peak_bytes = 0;
+    int64 allocated_bytes = 0;
+    int64 allocations = 0;
+    int64 untracked_bytes = 0;
+    int64 untracked_allocations = 0;
+  };
+
+  struct StepPeak {
+    int64 step_id;
+    int64 peak_bytes;
+  };
+
+  // Live bytes of the process and of its top nodes, at "usecs" since the
+  // profiler started or was reset.
+  struct Sample {
+    int64 usecs;
+    int64 live_bytes;
+    std::vector<std::pair<int, int64>> nodes;
+  };
+
+  MemoryProfiler() : start_nanos_(EnvTime::NowNanos()) {
+    int64 sample_usecs;
+    ITEX_CHECK_OK(ReadInt64FromEnvVar("ITEX_MEMORY_PROFILE_SAMPLE_USECS",
+                                      1000, &sample_usecs));
+    sample_nanos_ = std::max<int64>(sample_usecs, 0) * 1000;
+  }
+
+  static int64 Total(const Bytes& bytes) {
+    int64 total = 0;
+    for (int64 kind_bytes : bytes) total += kind_bytes;
+    return total;
+  }
+
+  // Index of the node the calling thread computes, "" outside of kernels.
+  int CurrentNode() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    const absl::string_view name = CurrentOpName();
+    auto it = node_index_.find(name);
+    if (it != node_index_.end()) return it->second;
+    const int node = nodes_.size();
+    nodes_.emplace_back();
+    nodes_.back().name = string(name);
+    nodes_.back().op = string(CurrentOpType());
+    node_index_.emplace(nodes_.back().name, node);
+    return node;
+  }
+
+  StepPeak& Step(int64 step_id) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    for (size_t i = 0; i < steps_.size() && i < kMaxConcurrentSteps; ++i) {
+      StepPeak& step = steps_[steps_.size() - 1 - i];
+      if (step.step_id == step_id) return step;
+    }
+    if (steps_.size() == kMaxSteps) steps_.pop_front();
+    steps_.push_back({step_id, 0});
+    return steps_.back();
+  }
+
+  // Appends a sample to the timeline unless the last one is more recent than
+  // the sampling period.
+  void MaybeSample() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    const uint64 now = EnvTime::NowNanos();
+    if (!timeline_.empty() &&
+        now - last_sample_nanos_ < static_cast<uint64>(sample_nanos_)) {
+      return;
+    }
+    last_sample_nanos_ = now;
+    Sample sample{static_cast<int64>((now - start_nanos_) / 1000), live_bytes_,
+                  {}};
+    for (int node = 0; node < static_cast<int>(nodes_.size()); ++node) {
+      if (nodes_[node].live_bytes > 0) {
+        sample.nodes.emplace_back(node, nodes_[node].live_bytes);
+      }
+    }
+    const size_t top = std::min(sample.nodes.size(), kTimelineTopNodes);
+    std::partial_sort(
+        sample.nodes.begin(), sample.nodes.begin() + top, sample.nodes.end(),
+        [](const std::pair<int, int64>& a, const std::pair<int, int64>& b) {
+          return a.second > b.second;
+        });
+    sample.nodes.resize(top);
+    if (timeline_.size() == kMaxTimelineSamples) timeline_.pop_front();
+    timeline_.push_back(std::move(sample));
+  }
+
+  void SnapshotPeak() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    at_peak_.clear();
+    for (int node = 0; node < static_cast<int>(nodes_.size()); ++node) {
+      if (nodes_[node].live_bytes > 0) {
+        at_peak_.emplace_back(node, nodes_[node].live);
+      }
+    }
+  }
+
+  mutex mu_;
+  std::vector<NodeStats> nodes_ TF_GUARDED_BY(mu_);
+  absl::flat_hash_map<string, int> node_index_ TF_GUARDED_BY(mu_);
+  int64 live_bytes_ TF_GUARDED_BY(mu_) = 0;
+  int64 peak_bytes_ TF_GUARDED_BY(mu_) = 0;
+  int64 peak_step_ TF_GUARDED_BY(mu_) = -1;
+  // The node whose allocation reached the peak.
+  int peak_node_ TF_GUARDED_BY(mu_) = -1;
+  // Live bytes of the nodes at the peak.
+  std::vector<std::pair<int, Bytes>> at_peak_ TF_GUARDED_BY(mu_);
+  std::deque<StepPeak> steps_ TF_GUARDED_BY(mu_);
+  std::deque<Sample> timeline_ TF_GUARDED_BY(mu_);
+  int64 sample_nanos_;
+  uint64 start_nanos_ TF_GUARDED_BY(mu_);
+  uint64 last_sample_nanos_ TF_GUARDED_BY(mu_) = 0;
+};
+
+void DeallocateProfiled(void* data, size_t len, void* arg) {
+  auto* allocation = static_cast<MemoryProfiler::Allocation*>(arg);
+  MemoryProfiler::Get()->Release(*allocation);
+  allocation->deallocator(data, len, allocation->deallocator_arg);
+  delete allocation;
+}
+
+// Drops the reference to the TensorFlow tensor that owns the buffer, which
+// returns it to the TensorFlow allocator.
+void DeleteTFTensor(void* data, size_t len, void* arg) {
+  TF_DeleteTensor(static_cast<TF_Tensor*>(arg));
+}
+
+}  // namespace
+
+bool IsMemoryProfileEnabled() {
+  static std::once_flag memory_profile_flag;
+  static bool memory_profile_enabled;
+  std::call_once(memory_profile_flag, [&]() {
+    ITEX_CHECK_OK(ReadBoolFromEnvVar("ITEX_MEMORY_PROFILE", false,
+                                     &memory_profile_enabled));
+#ifndef INTEL_CPU_ONLY
+    if (memory_profile_enabled) {
+      ITEX_LOG(WARNING) << "ITEX_MEMORY_PROFILE is only supported on CPU.";
+      memory_profile_enabled = false;
+    }
+#endif  // INTEL_CPU_ONLY
+  });
+
+  return memory_profile_enabled;
+}
+
+MemoryKind ResolveMemoryKind(MemoryKind kind) {
+  return current_memory_kind < 0 ? kind
+                                 : static_cast<MemoryKind>(current_memory_kind);
+}
+
+ScopedMemoryKind::ScopedMemoryKind(MemoryKind kind)
+    : previous_(current_memory_kind) {
+  current_memory_kind = static_cast<int>(kind);
+}
+
+ScopedMemoryKind::~ScopedMemoryKind() { current_memory_kind = previous_; }
+
+TF_Tensor* AllocateProfiledTensor(TF_OpKernelContext* ctx, DataType type,
+                                  const TensorShape& shape,
+                                  TF_AllocatorAttributes* attr,
+                                  MemoryKind kind, int64 step_id,
+                                  TF_Status* status) {
+  TF_SetStatus(status, TF_OK, "");
+  if (MemoryProfiler::Get() == nullptr || type == DT_STRING ||
+      type == DT_RESOURCE || type == DT_VARIANT ||
+      shape.num_elements() == 0) {
+    return nullptr;
+  }
+  TF_Tensor* tensor =
+      TF_AllocateTemp(ctx, static_cast<TF_DataType>(type),
+                      shape.dim_sizes().data(), shape.dims(), attr, status);
+  if (TF_GetCode(status) != TF_OK) return nullptr;
+  // The profiled tensor holds the only reference to "tensor", so the buffer
+  // goes back to the allocator when the last reference to the profiled
+  // tensor is released, as it would without the profiler.
+  return NewProfiledTensor(type, shape, TF_TensorData(tensor),
+                           TF_TensorByteSize(tensor), DeleteTFTensor, tensor,
+                           kind, step_id);
+}
+
+TF_Tensor* NewProfiledTensor(DataType type, const TensorShape& shape,
+                             void* data, size_t len,
+                             void (*deallocator)(void*, size_t, void*),
+                             void* deallocator_arg, MemoryKind kind,
+                             int64 step_id) {
+  MemoryProfiler* profiler = MemoryProfiler::Get();
+  if (profiler != nullptr) {
+    deallocator_arg = profiler->Allocate(ResolveMemoryKind(kind), step_id, len,
+                                         deallocator, deallocator_arg);
+    deallocator = DeallocateProfiled;
+  }
+  return TF_NewTensor(static_cast<TF_DataType>(type), shape.dim_sizes().data(),
+                      shape.dims(), data, len, deallocator, deallocator_arg);
+}
+
+void RecordUntrackedAllocation(int64 bytes) {
+  MemoryProfiler* profiler = MemoryProfiler::Get();
+  if (profiler != nullptr && bytes > 0) profiler->RecordUntracked(bytes);
+}
+
+std::string MemoryProfileJson(int top_n) {
+  MemoryProfiler* profiler = MemoryProfiler::Get();
+  return profiler == nullptr ? "{}\n" : profiler->ToJson(top_n);
+}
+
+void ResetMemoryProfile() {
+  MemoryProfiler* profiler = MemoryProfiler::Get();
+  if (profiler != nullptr) profiler->Reset();
+}
+
+}  // namespace itex
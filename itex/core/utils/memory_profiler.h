@@ -0,0 +1,114 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef ITEX_CORE_UTILS_MEMORY_PROFILER_H_
+#define ITEX_CORE_UTILS_MEMORY_PROFILER_H_
+
+#include <string>
+
+#include "itex/core/utils/macros.h"
+#include "itex/core/utils/types.h"
+#include "tensorflow/c/kernels.h"
+#include "tensorflow/c/tf_tensor.h"
+
+namespace itex {
+
+class TensorShape;
+
+// Memory profiler of the CPU kernels, enabled by ITEX_MEMORY_PROFILE.
+//
+// When enabled, allocate_output, allocate_temp and allocate_persistent of
+// OpKernelContext still take their buffers from the TensorFlow allocator, with
+// TF_AllocateTemp, but hand out a tensor that wraps the buffer and tags it
+// with the node that runs, its step id and the kind of the allocation. The
+// deallocator of the wrapper tells the profiler when the buffer is released,
+// wherever the last reference goes away, and only then returns it to
+// TensorFlow, so the sizes and lifetimes the allocator sees are the same as
+// without the profiler. Outputs come from TF_AllocateTemp too, which is the
+// same allocator on CPU, and appear as temps in TensorFlow's own allocation
+// records. Every allocation and release takes the lock of the profiler.
+//
+// The profiler knows the live bytes of every node at any time. Whenever the
+// live bytes of the process reach a new peak, it snapshots the live bytes per
+// node, which are the top contributors of the report. At most every
+// ITEX_MEMORY_PROFILE_SAMPLE_USECS (1000 by default), on an allocation or a
+// release, it also samples the live bytes of the process and of the nodes
+// with the most live bytes into a timeline.
+//
+// Outputs which TensorFlow allocates in forward_input_or_allocate_output, when
+// no input can be forwarded, are counted as untracked bytes of the node: the
+// plugin never learns when they are released.
+enum class MemoryKind {
+  kOutput,
+  kTemp,
+  kPersistent,
+  // Persistent tensors of the weight and bias caches of oneDNN kernels.
+  kCache,
+};
+
+// Whether ITEX_MEMORY_PROFILE is set. Only CPU builds profile.
+bool IsMemoryProfileEnabled();
+
+// Returns the kind set by the innermost ScopedMemoryKind of the calling
+// thread, or "kind" if there is none.
+MemoryKind ResolveMemoryKind(MemoryKind kind);
+
+// Makes the allocations of the calling thread count as "kind" for the
+// lifetime of the object.
+class ScopedMemoryKind {
+ public:
+  explicit ScopedMemoryKind(MemoryKind kind);
+  ~ScopedMemoryKind();
+
+ private:
+  int previous_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(ScopedMemoryKind);
+};
+
+// Allocates a tensor of "type" and "shape" with TF_AllocateTemp of "ctx",
+// whose buffer is tracked and attributed to the current op as "kind", unless a
+// ScopedMemoryKind is set. Returns nullptr if the profiler is disabled, the
+// tensor is empty, "type" needs construction, e.g. DT_STRING, or the
+// allocation failed, in which case "status" has the error.
+TF_Tensor* AllocateProfiledTensor(TF_OpKernelContext* ctx, DataType type,
+                                  const TensorShape& shape,
+                                  TF_AllocatorAttributes* attr,
+                                  MemoryKind kind, int64 step_id,
+                                  TF_Status* status);
+
+// Like TF_NewTensor, tracking "data" as "kind" until "deallocator" releases
+// it if the profiler is enabled.
+TF_Tensor* NewProfiledTensor(DataType type, const TensorShape& shape,
+                             void* data, size_t len,
+                             void (*deallocator)(void*, size_t, void*),
+                             void* deallocator_arg, MemoryKind kind,
+                             int64 step_id);
+
+// Counts "bytes" allocated by TensorFlow for the current op, whose release is
+// not visible to the plugin.
+void RecordUntrackedAllocation(int64 bytes);
+
+// Returns the report of the profiler as JSON, with the "top_n" largest
+// contributors at the peak, nodes by their own peak and the timeline.
+std::string MemoryProfileJson(int top_n);
+
+// Restarts the peak, the per-step peaks and the per-node counters from the
+// bytes that are live now.
+void ResetMemoryProfile();
+
+}  // namespace itex
+
+#endif  // ITEX_CORE_UTILS_MEMORY_PROFILER_H_
@@ -68,10 +68,10 @@ inline ValueType GetValueType<std::function<int64_t()>>() {
   return ValueType::kInt64;
 }
 
-// template <>
-// inline ValueType GetValueType<HistogramProto>() {
-//   return ValueType::kHistogram;
-// }
+template <>
+inline ValueType GetValueType<Histogram>() {
+  return ValueType::kHistogram;
+}
 
 template <>
 inline ValueType GetValueType<Percentiles>() {
@@ -52,6 +52,19 @@ struct Percentiles {
   std::vector<PercentilePoint> points;
 };
 
+// Distribution of the values added to a Sampler, with the fields of TF's
+// HistogramProto. bucket[i] counts the values up to bucket_limit[i] and above
+// bucket_limit[i - 1]. The last limit is DBL_MAX.
+struct Histogram {
+  double min = 0.0;
+  double max = 0.0;
+  double num = 0.0;
+  double sum = 0.0;
+  double sum_squares = 0.0;
+  std::vector<double> bucket_limit;
+  std::vector<double> bucket;
+};
+
 }  // namespace monitoring
 }  // namespace itex
 
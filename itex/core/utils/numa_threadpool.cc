@@ -0,0 +1,190 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "itex/core/utils/numa_threadpool.h"
+
+#include <utility>
+
+#include "itex/core/utils/denormal.h"
+#include "itex/core/utils/logging.h"
+#include "itex/core/utils/numa.h"
+#include "itex/core/utils/setround.h"
+
+namespace itex {
+namespace thread {
+
+namespace {
+
+// The pool and id of the calling thread, if it is a thread of a pool.
+struct PerThread {
+  const NUMAThreadPool* pool = nullptr;
+  int thread_id = -1;
+  int node = port::kNUMANoAffinity;
+};
+
+PerThread* GetPerThread() {
+  static thread_local PerThread per_thread;
+  return &per_thread;
+}
+
+}  // namespace
+
+NUMAThreadPool::NUMAThreadPool(Env* env, const ThreadOptions& thread_options,
+                               const string& name,
+                               const std::vector<int>& threads_per_node)
+    : num_threads_([&threads_per_node]() {
+        int num_threads = 0;
+        for (int threads : threads_per_node) num_threads += threads;
+        return num_threads;
+      }()) {
+  ITEX_CHECK_GE(num_threads_, 1);
+  for (int node = 0; node < static_cast<int>(threads_per_node.size());
+       ++node) {
+    ITEX_CHECK_GE(threads_per_node[node], 0);
+    nodes_.emplace_back(new Node);
+    nodes_.back()->first_thread = thread_nodes_.size();
+    nodes_.back()->num_threads = threads_per_node[node];
+    thread_nodes_.insert(thread_nodes_.end(), threads_per_node[node], node);
+  }
+  for (int i = 0; i < num_threads_; ++i) {
+    const int node = thread_nodes_[i];
+    threads_.emplace_back(env->StartThread(
+        thread_options, name, [this, node, i]() { WorkerLoop(node, i); }));
+  }
+}
+
+NUMAThreadPool::~NUMAThreadPool() {
+  for (auto& node : nodes_) {
+    mutex_lock l(&node->mu);
+    node->stopping = true;
+    node->cv.notify_all();
+  }
+  // Joins the threads.
+  threads_.clear();
+}
+
+void NUMAThreadPool::Schedule(std::function<void()> fn) {
+  const PerThread* per_thread = GetPerThread();
+  if (per_thread->pool == this) {
+    ScheduleOnNode(per_thread->node, std::move(fn));
+  } else {
+    ScheduleOnNode(thread_nodes_[next_thread_++ % num_threads_],
+                   std::move(fn));
+  }
+}
+
+void NUMAThreadPool::ScheduleWithHint(std::function<void()> fn, int start,
+                                      int limit) {
+  ITEX_DCHECK_LT(start, limit);
+  ScheduleOnNode(thread_nodes_[start], std::move(fn));
+}
+
+void NUMAThreadPool::ScheduleOnNode(int node, std::function<void()> fn,
+                                    bool pinned) {
+  ITEX_CHECK_GT(NumThreadsOnNode(node), 0) << "No threads on NUMA node "
+                                           << node;
+  Node* target = nodes_[node].get();
+  {
+    mutex_lock l(&target->mu);
+    (pinned ? target->pinned_tasks : target->tasks).push_back(std::move(fn));
+    if (target->num_idle > 0) {
+      target->cv.notify_one();
+      return;
+    }
+  }
+  if (pinned) return;
+  // All threads of the node are busy, so wake a thread of another node to
+  // steal the closure. A thread that is not waiting yet sees the new epoch
+  // before it does.
+  steal_epoch_.fetch_add(1);
+  for (int i = 1; i < NumNodes(); ++i) {
+    Node* other = nodes_[(node + i) % NumNodes()].get();
+    mutex_lock l(&other->mu);
+    if (other->num_idle > 0) {
+      other->cv.notify_one();
+      return;
+    }
+  }
+}
+
+int NUMAThreadPool::CurrentThreadId() const {
+  const PerThread* per_thread = GetPerThread();
+  return per_thread->pool == this ? per_thread->thread_id : -1;
+}
+
+int NUMAThreadPool::CurrentNode() const {
+  const PerThread* per_thread = GetPerThread();
+  return per_thread->pool == this ? per_thread->node : port::kNUMANoAffinity;
+}
+
+bool NUMAThreadPool::Steal(int node, std::function<void()>* task) {
+  for (int i = 1; i < NumNodes(); ++i) {
+    Node* other = nodes_[(node + i) % NumNodes()].get();
+    mutex_lock l(&other->mu);
+    // Leave the work of a node with idle threads to them.
+    if (other->num_idle > 0 || other->tasks.empty()) continue;
+    // The owners take from the front, thieves from the back.
+    *task = std::move(other->tasks.back());
+    other->tasks.pop_back();
+    return true;
+  }
+  return false;
+}
+
+void NUMAThreadPool::WorkerLoop(int node, int thread_id) {
+  // Set the processor flag to flush denormals to zero.
+  port::ScopedFlushDenormal flush;
+  // Set the processor rounding mode to ROUND TO NEAREST.
+  port::ScopedSetRound round(FE_TONEAREST);
+  port::NUMASetThreadNodeAffinity(node);
+  PerThread* per_thread = GetPerThread();
+  per_thread->pool = this;
+  per_thread->thread_id = thread_id;
+  per_thread->node = node;
+
+  Node* own = nodes_[node].get();
+  while (true) {
+    const uint64_t steal_epoch = steal_epoch_.load();
+    std::function<void()> task;
+    {
+      mutex_lock l(&own->mu);
+      if (!own->pinned_tasks.empty()) {
+        task = std::move(own->pinned_tasks.front());
+        own->pinned_tasks.pop_front();
+      } else if (!own->tasks.empty()) {
+        task = std::move(own->tasks.front());
+        own->tasks.pop_front();
+      }
+    }
+    if (task || Steal(node, &task)) {
+      task();
+      continue;
+    }
+
+    mutex_lock l(&own->mu);
+    if (!own->tasks.empty() || !own->pinned_tasks.empty()) continue;
+    if (own->stopping) break;
+    // Closures that became stealable after the Steal above were queued by
+    // threads that saw this thread busy, so look again instead of waiting.
+    if (steal_epoch_.load() != steal_epoch) continue;
+    ++own->num_idle;
+    own->cv.wait(&l);
+    --own->num_idle;
+  }
+  per_thread->pool = nullptr;
+}
+
+}  // namespace thread
+}  // namespace itex
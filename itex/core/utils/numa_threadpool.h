@@ -0,0 +1,118 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef ITEX_CORE_UTILS_NUMA_THREADPOOL_H_
+#define ITEX_CORE_UTILS_NUMA_THREADPOOL_H_
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "itex/core/utils/env.h"
+#include "itex/core/utils/macros.h"
+#include "itex/core/utils/mutex.h"
+#include "itex/core/utils/threadpool_interface.h"
+
+namespace itex {
+namespace thread {
+
+// A thread pool with a queue group per NUMA node. The threads of a node are
+// pinned to it and run the closures queued on it. A thread whose node has no
+// work steals from the other nodes, but only from nodes whose threads are all
+// busy, so work stays on its node unless that node is saturated.
+//
+// Threads are numbered node by node: the threads of node n have the ids
+// [FirstThreadOnNode(n), FirstThreadOnNode(n) + NumThreadsOnNode(n)).
+class NUMAThreadPool : public ThreadPoolInterface {
+ public:
+  // Starts threads_per_node[n] threads pinned to NUMA node n.
+  // REQUIRES: threads_per_node has at least one non-zero entry.
+  NUMAThreadPool(Env* env, const ThreadOptions& thread_options,
+                 const std::string& name,
+                 const std::vector<int>& threads_per_node);
+
+  // Runs the queued closures, then joins the threads.
+  ~NUMAThreadPool() override;
+
+  // Queues fn on the node of the calling thread if it is a thread of the
+  // pool. Otherwise the nodes take turns, in proportion to their threads.
+  void Schedule(std::function<void()> fn) override;
+
+  // Queues fn on the node of thread "start".
+  void ScheduleWithHint(std::function<void()> fn, int start,
+                        int limit) override;
+
+  // Queues fn on "node". Unless "pinned", a thread of another node may steal
+  // it when all threads of "node" are busy.
+  // REQUIRES: NumThreadsOnNode(node) > 0.
+  void ScheduleOnNode(int node, std::function<void()> fn, bool pinned = false);
+
+  int NumThreads() const override { return num_threads_; }
+
+  // Returns the id of the calling thread, -1 if it is not a thread of the
+  // pool.
+  int CurrentThreadId() const override;
+
+  int NumNodes() const { return nodes_.size(); }
+  int NumThreadsOnNode(int node) const { return nodes_[node]->num_threads; }
+  int FirstThreadOnNode(int node) const {
+    return nodes_[node]->first_thread;
+  }
+
+  // Returns the node of the calling thread, port::kNUMANoAffinity if it is
+  // not a thread of the pool.
+  int CurrentNode() const;
+
+ private:
+  struct Node {
+    int first_thread = 0;
+    int num_threads = 0;
+    mutex mu;
+    condition_variable cv;
+    std::deque<std::function<void()>> tasks TF_GUARDED_BY(mu);
+    // Closures that only the threads of the node may run.
+    std::deque<std::function<void()>> pinned_tasks TF_GUARDED_BY(mu);
+    // Threads of the node waiting for work.
+    int num_idle TF_GUARDED_BY(mu) = 0;
+    bool stopping TF_GUARDED_BY(mu) = false;
+  };
+
+  void WorkerLoop(int node, int thread_id);
+
+  // Takes a closure from a node other than "node" whose threads are all busy.
+  bool Steal(int node, std::function<void()>* task);
+
+  const int num_threads_;
+  std::vector<std::unique_ptr<Node>> nodes_;
+  // Node of each thread.
+  std::vector<int> thread_nodes_;
+  // Round robin over the threads for Schedule from outside the pool.
+  std::atomic<unsigned> next_thread_{0};
+  // Bumped whenever a closure is queued on a node without idle threads, so
+  // that a thread about to wait notices work it could steal.
+  std::atomic<uint64_t> steal_epoch_{0};
+  std::vector<std::unique_ptr<Thread>> threads_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(NUMAThreadPool);
+};
+
+}  // namespace thread
+}  // namespace itex
+
+#endif  // ITEX_CORE_UTILS_NUMA_THREADPOOL_H_
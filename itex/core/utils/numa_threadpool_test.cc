@@ -0,0 +1,181 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "itex/core/utils/numa_threadpool.h"
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "itex/core/utils/blocking_counter.h"
+#include "itex/core/utils/env.h"
+#include "itex/core/utils/logging.h"
+#include "itex/core/utils/notification.h"
+#include "itex/core/utils/numa.h"
+#include "itex/core/utils/threadpool.h"
+
+// The nodes of these pools are only queue groups, so the tests do not need a
+// NUMA machine: pinning a thread to a node the machine lacks is a no-op.
+
+namespace itex {
+namespace thread {
+namespace {
+
+// Large enough for every loop to be split into several blocks.
+constexpr int64_t kCostPerUnit = 10000;
+
+std::unique_ptr<ThreadPool> MakePool(const std::vector<int>& threads_per_node) {
+  return std::make_unique<ThreadPool>(Env::Default(), ThreadOptions(),
+                                      "numa_test", threads_per_node);
+}
+
+// Every index is visited exactly once, also when the range does not split
+// evenly over the nodes and their threads, and with a node without threads.
+void TestParallelForCoversRange() {
+  for (const std::vector<int>& threads_per_node :
+       std::vector<std::vector<int>>{{1}, {3, 2}, {2, 0, 3}}) {
+    auto pool = MakePool(threads_per_node);
+    for (int64_t total : {0, 1, 5, 7, 100, 1001, 100003}) {
+      std::vector<std::atomic<int>> visits(total);
+      for (auto& v : visits) v = 0;
+      pool->ParallelFor(total, kCostPerUnit, [&](int64_t first, int64_t last) {
+        ITEX_CHECK_LE(0, first);
+        ITEX_CHECK_LT(first, last);
+        ITEX_CHECK_LE(last, total);
+        for (int64_t i = first; i < last; ++i) visits[i].fetch_add(1);
+      });
+      for (int64_t i = 0; i < total; ++i) ITEX_CHECK_EQ(visits[i].load(), 1);
+
+      for (auto& v : visits) v = 0;
+      pool->ParallelForWithWorkerId(
+          total, kCostPerUnit, [&](int64_t first, int64_t last, int id) {
+            ITEX_CHECK_LE(0, id);
+            ITEX_CHECK_LE(id, pool->NumThreads());
+            for (int64_t i = first; i < last; ++i) visits[i].fetch_add(1);
+          });
+      for (int64_t i = 0; i < total; ++i) ITEX_CHECK_EQ(visits[i].load(), 1);
+    }
+  }
+}
+
+// ParallelForOnNode from outside the pool runs every block on a thread of
+// that node.
+void TestParallelForOnNode() {
+  auto pool = MakePool({2, 3, 1});
+  ITEX_CHECK_EQ(pool->NumThreadsOnNode(0), 2);
+  ITEX_CHECK_EQ(pool->NumThreadsOnNode(1), 3);
+  ITEX_CHECK_EQ(pool->NumThreadsOnNode(3), 0);
+  ITEX_CHECK_EQ(pool->CurrentNUMANode(), port::kNUMANoAffinity);
+  for (int node = 0; node < 3; ++node) {
+    const int64_t total = 1001;
+    std::vector<std::atomic<int>> visits(total);
+    for (auto& v : visits) v = 0;
+    std::atomic<int> blocks(0);
+    pool->ParallelForOnNode(
+        node, total, kCostPerUnit, [&](int64_t first, int64_t last) {
+          ITEX_CHECK_EQ(pool->CurrentNUMANode(), node);
+          ITEX_CHECK_NE(pool->CurrentThreadId(), -1);
+          blocks.fetch_add(1);
+          for (int64_t i = first; i < last; ++i) visits[i].fetch_add(1);
+        });
+    ITEX_CHECK_GT(blocks.load(), 1);
+    for (int64_t i = 0; i < total; ++i) ITEX_CHECK_EQ(visits[i].load(), 1);
+  }
+}
+
+// Loops started from the blocks of other loops finish, also when every thread
+// of a node waits on a loop of another node.
+void TestNestedParallelFor() {
+  for (const std::vector<int>& threads_per_node :
+       std::vector<std::vector<int>>{{1, 1}, {2, 1}}) {
+    auto pool = MakePool(threads_per_node);
+    const int64_t outer = 64;
+    const int64_t inner = 256;
+    std::atomic<int64_t> visits(0);
+    pool->ParallelFor(outer, kCostPerUnit, [&](int64_t first, int64_t last) {
+      for (int64_t i = first; i < last; ++i) {
+        pool->ParallelFor(inner, kCostPerUnit,
+                          [&](int64_t inner_first, int64_t inner_last) {
+                            visits.fetch_add(inner_last - inner_first);
+                          });
+        const int other_node = (pool->CurrentNUMANode() + 1) % 2;
+        pool->ParallelForOnNode(other_node, inner, kCostPerUnit,
+                                [&](int64_t inner_first, int64_t inner_last) {
+                                  visits.fetch_add(inner_last - inner_first);
+                                });
+      }
+    });
+    ITEX_CHECK_EQ(visits.load(), 2 * outer * inner);
+  }
+}
+
+// A closure queued on a node whose threads are all busy is stolen by an idle
+// thread of another node, while pinned closures wait for their node.
+void TestWorkStealing() {
+  NUMAThreadPool pool(Env::Default(), ThreadOptions(), "numa_test", {1, 1});
+  ITEX_CHECK_EQ(pool.NumThreads(), 2);
+  ITEX_CHECK_EQ(pool.NumThreadsOnNode(0), 1);
+  ITEX_CHECK_EQ(pool.FirstThreadOnNode(1), 1);
+
+  Notification started;
+  Notification release;
+  std::atomic<bool> pinned_ran(false);
+  BlockingCounter finished(3);
+  pool.ScheduleOnNode(
+      0,
+      [&]() {
+        ITEX_CHECK_EQ(pool.CurrentNode(), 0);
+        started.Notify();
+        release.WaitForNotification();
+        finished.DecrementCount();
+      },
+      /*pinned=*/true);
+  started.WaitForNotification();
+  pool.ScheduleOnNode(
+      0,
+      [&]() {
+        ITEX_CHECK_EQ(pool.CurrentNode(), 0);
+        pinned_ran = true;
+        finished.DecrementCount();
+      },
+      /*pinned=*/true);
+  // The only thread of node 0 is blocked, so node 1 takes the closure.
+  Notification stolen;
+  int ran_on = port::kNUMANoAffinity;
+  pool.ScheduleOnNode(0, [&]() {
+    ran_on = pool.CurrentNode();
+    stolen.Notify();
+    finished.DecrementCount();
+  });
+  stolen.WaitForNotification();
+  ITEX_CHECK_EQ(ran_on, 1);
+  ITEX_CHECK(!pinned_ran);
+  release.Notify();
+  finished.Wait();
+}
+
+}  // namespace
+}  // namespace thread
+}  // namespace itex
+
+int main() {
+  itex::thread::TestParallelForCoversRange();
+  itex::thread::TestParallelForOnNode();
+  itex::thread::TestNestedParallelFor();
+  itex::thread::TestWorkStealing();
+  std::printf("PASSED\n");
+  return 0;
+}
@@ -0,0 +1,91 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifdef ITEX_ONEDNN_THREADPOOL
+#include "itex/core/utils/onednn/onednn_threadpool.h"
+
+#include <memory>
+#include <vector>
+
+#include "itex/core/utils/cpu_info.h"
+#include "itex/core/utils/env.h"
+#include "itex/core/utils/env_var.h"
+#include "itex/core/utils/execution_domain.h"
+#include "itex/core/utils/logging.h"
+
+namespace itex {
+
+namespace {
+
+// A job is a thread's share of a primitive, so every job becomes its own
+// shard of ParallelFor.
+constexpr int64_t kJobCost = int64_t{1} << 30;
+
+}  // namespace
+
+/* static */ OneDnnThreadPool* OneDnnThreadPool::Global() {
+  static OneDnnThreadPool* onednn_threadpool = []() {
+    const int64_t num_cores =
+        (port::NumSchedulableCPUs() + port::NumHyperthreadsPerCore() - 1) /
+        port::NumHyperthreadsPerCore();
+    int64_t num_threads;
+    TF_ABORT_IF_ERROR(ReadInt64FromEnvVar("ITEX_ONEDNN_NUM_THREADS", num_cores,
+                                          &num_threads));
+    if (num_threads < 1) num_threads = num_cores;
+    ITEX_VLOG(1) << "Running oneDNN CPU primitives on " << num_threads
+                 << " threads";
+
+    const std::vector<int> threads_per_node =
+        thread::ThreadPool::ThreadsPerNUMANode(num_threads);
+    thread::ThreadPool* pool;
+    if (threads_per_node.size() > 1) {
+      pool = new thread::ThreadPool(Env::Default(), ThreadOptions(), "onednn",
+                                    threads_per_node);
+    } else {
+      pool = new thread::ThreadPool(Env::Default(), "onednn", num_threads);
+    }
+    return new OneDnnThreadPool(pool);
+  }();
+  return onednn_threadpool;
+}
+
+/* static */ OneDnnThreadPool* OneDnnThreadPool::Current() {
+  const ExecutionDomain* domain = ExecutionDomain::Current();
+  if (domain == nullptr) return Global();
+  // Only reached once the domains exist, and they are created once.
+  static std::vector<std::unique_ptr<OneDnnThreadPool>>* domain_pools = []() {
+    auto* pools = new std::vector<std::unique_ptr<OneDnnThreadPool>>;
+    for (int id = 0; id < ExecutionDomain::NumDomains(); ++id) {
+      pools->emplace_back(
+          new OneDnnThreadPool(ExecutionDomain::Get(id)->threadpool()));
+    }
+    return pools;
+  }();
+  return (*domain_pools)[domain->id()].get();
+}
+
+void OneDnnThreadPool::parallel_for(int n,
+                                    const std::function<void(int, int)>& fn) {
+  if (n <= 1 || get_in_parallel()) {
+    for (int i = 0; i < n; ++i) fn(i, n);
+    return;
+  }
+  pool_->ParallelFor(n, kJobCost, [n, &fn](int64_t first, int64_t last) {
+    for (int64_t i = first; i < last; ++i) fn(i, n);
+  });
+}
+
+}  // namespace itex
+#endif  // ITEX_ONEDNN_THREADPOOL
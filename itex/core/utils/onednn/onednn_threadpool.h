@@ -0,0 +1,67 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef ITEX_CORE_UTILS_ONEDNN_ONEDNN_THREADPOOL_H_
+#define ITEX_CORE_UTILS_ONEDNN_ONEDNN_THREADPOOL_H_
+
+#ifdef ITEX_ONEDNN_THREADPOOL
+
+#include <functional>
+
+#include "dnnl_threadpool.hpp"  // NOLINT(build/include_subdir)
+#include "itex/core/utils/threadpool.h"
+
+namespace itex {
+
+// Runs the parallel sections of oneDNN CPU primitives on an
+// itex::thread::ThreadPool. It is used when oneDNN is built with the
+// threadpool CPU runtime (--config=onednn_threadpool) instead of OpenMP, so
+// that ops running concurrently on TF inter-op threads share one set of
+// compute threads rather than each starting an OpenMP team.
+class OneDnnThreadPool : public dnnl::threadpool_interop::threadpool_iface {
+ public:
+  // Does not take ownership of `pool`.
+  explicit OneDnnThreadPool(thread::ThreadPool* pool) : pool_(pool) {}
+
+  // Returns the process wide instance. Its pool has ITEX_ONEDNN_NUM_THREADS
+  // threads, one per physical core by default, spread over the NUMA nodes.
+  static OneDnnThreadPool* Global();
+
+  // Returns the instance over the pool of the execution domain of the calling
+  // thread, Global() if it has none.
+  static OneDnnThreadPool* Current();
+
+  int get_num_threads() const override { return pool_->NumThreads(); }
+
+  // A primitive executed from a thread of the pool, e.g. by a nested
+  // ParallelFor, runs its parallel sections on that thread.
+  bool get_in_parallel() const override {
+    return pool_->CurrentThreadId() != -1;
+  }
+
+  // parallel_for returns once all jobs are done.
+  uint64_t get_flags() const override { return 0; }
+
+  // Calls fn(i, n) for every i in [0, n).
+  void parallel_for(int n, const std::function<void(int, int)>& fn) override;
+
+ private:
+  thread::ThreadPool* pool_;
+};
+
+}  // namespace itex
+
+#endif  // ITEX_ONEDNN_THREADPOOL
+#endif  // ITEX_CORE_UTILS_ONEDNN_ONEDNN_THREADPOOL_H_
@@ -16,20 +16,71 @@ limitations under the License.
 #ifndef ITEX_BUILD_JAX
 #include "itex/core/utils/onednn/onednn_util.h"
 
+#include <atomic>
 #include <unordered_map>
 
+#include "absl/strings/str_join.h"
+#include "dnnl_debug.h"  // NOLINT(build/include_subdir)
+#include "itex/core/utils/memory_profiler.h"
 #include "itex/core/utils/register_types.h"
+#include "itex/core/utils/traceme_encode.h"
 
 namespace itex {
 
+namespace {
+
+// Returns the dims of argument "arg" as "AxBxC", empty if there is none.
+std::string ArgDims(const std::unordered_map<int, dnnl::memory>& args,
+                    int arg) {
+  auto it = args.find(arg);
+  if (it == args.end()) return "";
+#ifdef ITEX_ONEDNN_3_0
+  return absl::StrJoin(it->second.get_desc().get_dims(), "x");
+#else
+  return absl::StrJoin(it->second.get_desc().dims(), "x");
+#endif
+}
+
+// Returns whether a read of a cache is a hit. Kernels read a cache right after
+// filling it, so the first read after SetCache is part of its miss. Whichever
+// thread makes that read, hits always add up to the reads minus the fills.
+bool IsCacheHit(std::atomic<bool>* fill_unread) {
+  // Only load on the hit path, to keep the cache line shared.
+  if (!fill_unread->load(std::memory_order_relaxed)) return true;
+  return !fill_unread->exchange(false, std::memory_order_relaxed);
+}
+
+}  // namespace
+
+std::string OneDnnPrimitiveTraceString(
+    const dnnl::primitive& primitive,
+    const std::unordered_map<int, dnnl::memory>& args) {
+  const char* impl_info = nullptr;
+  if (dnnl_primitive_desc_query(primitive.get_primitive_desc(),
+                                dnnl_query_impl_info_str, 0,
+                                &impl_info) != dnnl_success ||
+      impl_info == nullptr) {
+    impl_info = "unknown";
+  }
+  const char* kind = dnnl_prim_kind2str(
+      static_cast<dnnl_primitive_kind_t>(primitive.get_kind()));
+  return TraceMeEncode(strings::StrCat("onednn::", kind),
+                       {{"impl", impl_info},
+                        {"src", ArgDims(args, DNNL_ARG_SRC)},
+                        {"weights", ArgDims(args, DNNL_ARG_WEIGHTS)},
+                        {"dst", ArgDims(args, DNNL_ARG_DST)}});
+}
+
 void ReorderMemory(const OpKernelContext& context,
                    const dnnl::memory* src_memory, dnnl::memory* reorder_memory,
                    const dnnl::engine& onednn_engine) {
   dnnl::stream onednn_stream = CreateDnnlStream(context, onednn_engine);
-  dnnl::reorder reorder_primitive = dnnl::reorder(*src_memory, *reorder_memory);
+  dnnl::reorder reorder_primitive =
+      CreatePrimitive<dnnl::reorder>(*src_memory, *reorder_memory);
   std::unordered_map<int, dnnl::memory> reorder_args = {
       {DNNL_ARG_SRC, *src_memory}, {DNNL_ARG_DST, *reorder_memory}};
-  reorder_primitive.execute(onednn_stream, reorder_args);
+  ExecutePrimitive(reorder_primitive, onednn_stream, reorder_args);
+  metrics::RecordReorder(reorder_memory->get_desc().get_size());
 }
 
 // TF datatype and shape is meaningless for some tensors, such as scratchpad
@@ -56,6 +107,8 @@ void WeightCacheManager<T>::SetCache(
   if (weight_cached_data_.IsInitialized()) {
     return;
   }
+  metrics::RecordCacheMiss(metrics::CacheKind::kWeight);
+  ScopedMemoryKind cache_kind(MemoryKind::kCache);
 
   // Create original memory
   dnnl::memory weight_mem =
@@ -66,9 +119,14 @@ void WeightCacheManager<T>::SetCache(
   size_t weight_size = weight_expected_md.get_size();
   TensorShape weight_tf_shape;
   weight_tf_shape.AddDim(weight_size / sizeof(T));
-  OP_REQUIRES_OK(context, context->allocate_persistent(
-                              DataTypeToEnum<T>::value, weight_tf_shape,
-                              &weight_cached_data_, &weight_cached_tensor));
+  // The cached weight is streamed through by every later run of the kernel.
+  AllocationAttributes weight_alloc_attr;
+  weight_alloc_attr.prefer_huge_pages = true;
+  OP_REQUIRES_OK(context,
+                 context->allocate_persistent(
+                     DataTypeToEnum<T>::value, weight_tf_shape,
+                     &weight_cached_data_, &weight_cached_tensor,
+                     AllocatorAttributes(), weight_alloc_attr));
 
   // Create cached weight memory
   void* weight_cached_data = const_cast<void*>(
@@ -99,6 +157,7 @@ void WeightCacheManager<T>::SetCache(
   *reinterpret_cast<dnnl::memory::desc*>(
       weight_md_cached_tensor->flat<ShortDT>().data()) = weight_expected_md;
 #endif
+  fill_unread_.store(true, std::memory_order_relaxed);
 }
 
 template <typename T>
@@ -108,6 +167,7 @@ T* WeightCacheManager<T>::GetCache(OpKernelContext* context,
   tf_shared_lock lock(&mu_);
   const Tensor* weight_cached_data = weight_cached_data_.AccessTensor(context);
   const Tensor* weight_cached_md = weight_cached_md_.AccessTensor(context);
+  const bool is_hit = IsCacheHit(&fill_unread_);
 
   // Check if the memory descriptor of the cached weight is same as
   // expected_md. if so use the cached memory, else return nullptr
@@ -115,9 +175,11 @@ T* WeightCacheManager<T>::GetCache(OpKernelContext* context,
     dnnl::memory::desc* cached_md = reinterpret_cast<dnnl::memory::desc*>(
         const_cast<ShortDT*>(weight_cached_md->flat<ShortDT>().data()));
     if (*cached_md == expected_md) {
+      if (is_hit) metrics::RecordCacheHit(metrics::CacheKind::kWeight);
       return reinterpret_cast<T*>(
           const_cast<T*>(weight_cached_data->flat<T>().data()));
     } else {
+      metrics::RecordCacheMiss(metrics::CacheKind::kWeight);
       return nullptr;
       // TODO(itex): Weight cache format can change in the case that matmul
       // src has dymanic shape. Is it possible to cache weights with different
@@ -172,6 +234,8 @@ void BiasCacheManager<T>::SetCache(OpKernelContext* context,
   if (bias_cached_data_.IsInitialized()) {
     return;
   }
+  metrics::RecordCacheMiss(metrics::CacheKind::kBias);
+  ScopedMemoryKind cache_kind(MemoryKind::kCache);
 
   // Create original bias memory
   dnnl::memory bias_mem = CreateDnnlMemory(bias_md, onednn_engine, bias_data);
@@ -181,9 +245,12 @@ void BiasCacheManager<T>::SetCache(OpKernelContext* context,
   size_t bias_size = bias_md.get_size();
   TensorShape bias_tf_shape;
   bias_tf_shape.AddDim(bias_size / sizeof(T));
+  AllocationAttributes bias_alloc_attr;
+  bias_alloc_attr.prefer_huge_pages = true;
   OP_REQUIRES_OK(context, context->allocate_persistent(
                               DataTypeToEnum<T>::value, bias_tf_shape,
-                              &bias_cached_data_, &bias_cached_tensor));
+                              &bias_cached_data_, &bias_cached_tensor,
+                              AllocatorAttributes(), bias_alloc_attr));
 
   // Create cached bias memory
   void* bias_cached_data = const_cast<void*>(
@@ -193,7 +260,7 @@ void BiasCacheManager<T>::SetCache(OpKernelContext* context,
 
   // Bias scaling attributes
   dnnl::reorder reorder_primitive =
-      dnnl::reorder(bias_mem, bias_scaled_mem, bias_attr);
+      CreatePrimitive<dnnl::reorder>(bias_mem, bias_scaled_mem, bias_attr);
   std::unordered_map<int, dnnl::memory> reorder_args = {
       {DNNL_ARG_SRC, bias_mem}, {DNNL_ARG_DST, bias_scaled_mem}};
 #ifdef ITEX_ONEDNN_3_0
@@ -203,7 +270,8 @@ void BiasCacheManager<T>::SetCache(OpKernelContext* context,
 
   // Execute reorder
   auto onednn_stream = CreateDnnlStream(*context, onednn_engine);
-  reorder_primitive.execute(onednn_stream, reorder_args);
+  ExecutePrimitive(reorder_primitive, onednn_stream, reorder_args);
+  fill_unread_.store(true, std::memory_order_relaxed);
 }
 
 template <typename T>
@@ -211,6 +279,9 @@ T* BiasCacheManager<T>::GetCache(OpKernelContext* context)
     TF_LOCKS_EXCLUDED(mu_) {
   tf_shared_lock lock(&mu_);
   const Tensor* bias_cached_data = bias_cached_data_.AccessTensor(context);
+  if (IsCacheHit(&fill_unread_)) {
+    metrics::RecordCacheHit(metrics::CacheKind::kBias);
+  }
   return reinterpret_cast<T*>(
       const_cast<T*>(bias_cached_data->flat<T>().data()));
 }
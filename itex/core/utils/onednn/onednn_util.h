@@ -16,8 +16,10 @@ limitations under the License.
 #ifndef ITEX_CORE_UTILS_ONEDNN_ONEDNN_UTIL_H_
 #define ITEX_CORE_UTILS_ONEDNN_ONEDNN_UTIL_H_
 
+#include <atomic>
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -27,13 +29,17 @@ limitations under the License.
 #include "dnnl_sycl.hpp"  // NOLINT(build/include_subdir)
 #endif                    // INTEL_CPU_ONLY
 
+#include "itex/core/utils/env_time.h"
+#include "itex/core/utils/kernel_metrics.h"
 #include "itex/core/utils/logging.h"
+#include "itex/core/utils/onednn/onednn_threadpool.h"
 #include "itex/core/utils/op_kernel.h"
 #include "itex/core/utils/op_requires.h"
 #include "itex/core/utils/status.h"
 #include "itex/core/utils/strcat.h"
 #include "itex/core/utils/tensor_format.h"
 #include "itex/core/utils/tensor_shape.h"
+#include "itex/core/utils/traceme.h"
 
 namespace itex {
 
@@ -207,7 +213,10 @@ inline dnnl::engine& CreateDnnlEngine<CPUDevice>(const OpKernelContext& ctx) {
   // Right now ITEX doesn't own proper TF CPU device and NUMA info is
   // unavailable, so simply consider ITEX only have 1 CPU device.
   // TODO(itex): Check NUMA after integrating new CPU device.
-  ITEX_CHECK(&(ctx.eigen_cpu_device()) == &(ctx.eigen_cpu_device_singleton()))
+  // Execution domains share the engine too, it holds no threads. They only
+  // differ in the stream, see CreateDnnlStream.
+  ITEX_CHECK(ExecutionDomain::Current() != nullptr ||
+             &(ctx.eigen_cpu_device()) == &(ctx.eigen_cpu_device_singleton()))
       << "Global oneDNN CPU engine mismatched with current context";
   static dnnl::engine cpu_engine = dnnl::engine(dnnl::engine::kind::cpu, 0);
   return cpu_engine;
@@ -225,7 +234,42 @@ inline dnnl::stream CreateDnnlStream(const OpKernelContext& ctx,
   // Default path, always assume it's CPU engine.
   ITEX_CHECK(engine.get_kind() == dnnl::engine::kind::cpu)
       << "Create oneDNN stream for unsupported engine.";
+#ifdef ITEX_ONEDNN_THREADPOOL
+  return dnnl::threadpool_interop::make_stream(engine,
+                                               OneDnnThreadPool::Current());
+#else
   return dnnl::stream(engine);
+#endif  // ITEX_ONEDNN_THREADPOOL
+}
+
+// Returns "onednn::<primitive kind>" with the implementation, e.g.
+// jit:avx512_core, and the src, weights and dst dims as TraceMe metadata.
+std::string OneDnnPrimitiveTraceString(
+    const dnnl::primitive& primitive,
+    const std::unordered_map<int, dnnl::memory>& args);
+
+// Creates a primitive like Primitive(args...), recording the creation and its
+// time in the kernel metrics of the current op.
+template <typename Primitive, typename... Args>
+inline Primitive CreatePrimitive(Args&&... args) {
+  const uint64 start_us = EnvTime::NowMicros();
+  Primitive primitive(std::forward<Args>(args)...);
+  metrics::RecordPrimitiveCreation(CurrentOpType(),
+                                   EnvTime::NowMicros() - start_us);
+  return primitive;
+}
+
+// Executes "primitive" like primitive.execute(stream, args), recording a
+// TraceMe span for it while the profiler is active.
+inline void ExecutePrimitive(
+    const dnnl::primitive& primitive, const dnnl::stream& stream,
+    const std::unordered_map<int, dnnl::memory>& args) {
+  TraceMe trace_me(
+      [&primitive, &args] {
+        return OneDnnPrimitiveTraceString(primitive, args);
+      },
+      /*level=*/2);
+  primitive.execute(stream, args);
 }
 #endif
 inline dnnl::memory CreateDnnlMemory(const dnnl::memory::desc& md,
@@ -532,6 +576,8 @@ class WeightCacheManager {
   mutex mu_;
   PersistentTensor weight_cached_data_ TF_GUARDED_BY(mu_);
   PersistentTensor weight_cached_md_ TF_GUARDED_BY(mu_);
+  // Set by SetCache until the next GetCache, which is not a hit.
+  std::atomic<bool> fill_unread_{false};
 };
 
 // Bias cache is used to avoid scale the bias tensor repetitively in INT8 kernel
@@ -565,6 +611,8 @@ class BiasCacheManager {
 
   mutex mu_;
   PersistentTensor bias_cached_data_ TF_GUARDED_BY(mu_);
+  // Set by SetCache until the next GetCache, which is not a hit.
+  std::atomic<bool> fill_unread_{false};
 };
 #endif
 
@@ -0,0 +1,230 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "itex/core/utils/op_cost.h"
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+
+#include "absl/strings/match.h"
+#include "absl/strings/strip.h"
+#include "itex/core/utils/env_time.h"
+#include "itex/core/utils/kernel_metrics.h"
+#include "itex/core/utils/traceme_encode.h"
+
+namespace itex {
+
+namespace {
+
+// FLOPs per input element of a normalization: the mean and variance, the
+// normalization and the affine transform. The gradients compute about twice
+// as much.
+constexpr int64 kNormFlopsPerElement = 8;
+constexpr int64 kNormGradFlopsPerElement = 16;
+
+// Returns the input "index" if it is a dense tensor with data.
+const Tensor* DenseInput(const OpKernelContext& ctx, int index) {
+  if (index >= ctx.num_inputs() || ctx.input_is_ref(index)) return nullptr;
+  const DataType dtype = ctx.input_dtype(index);
+  if (dtype == DT_RESOURCE || dtype == DT_VARIANT || IsRefType(dtype)) {
+    return nullptr;
+  }
+  const Tensor& tensor = ctx.input(index);
+  return tensor.GetTFTensor() == nullptr ? nullptr : &tensor;
+}
+
+const Tensor* Output(const OpKernelContext& ctx, int index) {
+  return index < ctx.num_outputs() ? ctx.output(index) : nullptr;
+}
+
+// "_ITEXFusedMatMul" -> "FusedMatMul", "_OneDnnPadWithConv2D" -> "Conv2D".
+absl::string_view BaseOpType(absl::string_view op_type) {
+  if (!absl::ConsumePrefix(&op_type, "_ITEX")) {
+    absl::ConsumePrefix(&op_type, "_OneDnn");
+  }
+  absl::ConsumePrefix(&op_type, "PadWith");
+  return op_type;
+}
+
+// 2 * output elements * K, with K the elements of the last two dims of the
+// lhs over the rows of the output, which holds whether the lhs is transposed
+// or not.
+int64 MatMulFlops(const OpKernelContext& ctx) {
+  const Tensor* lhs = DenseInput(ctx, 0);
+  const Tensor* output = Output(ctx, 0);
+  if (lhs == nullptr || output == nullptr || lhs->dims() < 2 ||
+      output->dims() < 2) {
+    return 0;
+  }
+  const int64 lhs_matrix =
+      lhs->dim_size(lhs->dims() - 1) * lhs->dim_size(lhs->dims() - 2);
+  const int64 rows = output->dim_size(output->dims() - 2);
+  if (rows == 0 || lhs_matrix % rows != 0) return 0;
+  return 2 * output->NumElements() * (lhs_matrix / rows);
+}
+
+// 2 * elements of the forward output * reduction size of one output element.
+// The filter is HWIO (DHWIO for 3-D), or HWCM for depthwise convolutions.
+int64 ConvFlops(absl::string_view base_type, const OpKernelContext& ctx) {
+  const bool backprop_filter = absl::StrContains(base_type, "BackpropFilter");
+  const bool backprop_input = absl::StrContains(base_type, "BackpropInput");
+  const Tensor* output = backprop_filter || backprop_input
+                             ? DenseInput(ctx, 2)
+                             : Output(ctx, 0);
+  const Tensor* filter =
+      backprop_filter ? Output(ctx, 0) : DenseInput(ctx, 1);
+  if (output == nullptr || filter == nullptr || filter->dims() < 4 ||
+      output->dims() != filter->dims()) {
+    return 0;
+  }
+
+  const int rank = filter->dims();
+  int64 output_channels = filter->dim_size(rank - 1);
+  if (absl::StrContains(base_type, "Depthwise")) {
+    output_channels *= filter->dim_size(rank - 2);
+  }
+  if (output_channels == 0) return 0;
+  return 2 * output->NumElements() *
+         (filter->NumElements() / output_channels);
+}
+
+// FLOPs per output element of element-wise ops.
+int64 ElementwiseFlopsPerElement(absl::string_view base_type,
+                                 const OpKernelContext& ctx) {
+  static const auto* const flops = new std::unordered_map<std::string, int64>{
+      {"Add", 1},        {"AddV2", 1},      {"Sub", 1},
+      {"Mul", 1},        {"Div", 1},        {"RealDiv", 1},
+      {"Maximum", 1},    {"Minimum", 1},    {"BiasAdd", 1},
+      {"Relu", 1},       {"Relu6", 2},      {"LeakyRelu", 2},
+      {"ReluGrad", 1},   {"Relu6Grad", 2},  {"LeakyReluGrad", 2},
+      {"Square", 1},     {"Rsqrt", 2},      {"Sqrt", 2},
+      {"Elu", 4},        {"EluGrad", 2},    {"Sigmoid", 4},
+      {"Tanh", 6},       {"Swish", 5},      {"SwishGrad", 8},
+      {"Gelu", 8},       {"GeluGrad", 12},  {"Mish", 10},
+      {"Softmax", 5},    {"Cast", 1},       {"QuantizeV2", 2},
+      {"Dequantize", 2},
+  };
+  // AddN and FusedBinary add up all of their data inputs.
+  if (base_type == "AddN" || base_type == "FusedBinary") {
+    int data_inputs = 0;
+    for (int i = 0; i < ctx.num_inputs(); ++i) {
+      if (DenseInput(ctx, i) != nullptr &&
+          ctx.input_dtype(i) != DT_UINT8) {
+        ++data_inputs;
+      }
+    }
+    return std::max(data_inputs - 1, 1);
+  }
+  auto it = flops->find(std::string(base_type));
+  return it == flops->end() ? 0 : it->second;
+}
+
+}  // namespace
+
+int64 OpCostBytes(const OpKernelContext& ctx) {
+  int64 bytes = 0;
+  for (int i = 0; i < ctx.num_inputs(); ++i) {
+    const Tensor* input = DenseInput(ctx, i);
+    if (input != nullptr) bytes += input->TotalBytes();
+  }
+  for (int i = 0; i < ctx.num_outputs(); ++i) {
+    const Tensor* output = ctx.output(i);
+    if (output != nullptr) bytes += output->TotalBytes();
+  }
+  return bytes;
+}
+
+OpCost PoolingOpCost(const OpKernelContext& ctx, int64 window_size) {
+  OpCost cost;
+  cost.bytes = OpCostBytes(ctx);
+
+  // The pooled tensor is the smallest data tensor: the output of the forward
+  // ops, the original output or its gradient for the backward ops.
+  int64 pooled = -1;
+  int64 largest = 0;
+  auto visit = [&](const Tensor* tensor) {
+    if (tensor == nullptr || tensor->dims() < 4) return;
+    const int64 elements = tensor->NumElements();
+    if (pooled < 0 || elements < pooled) pooled = elements;
+    largest = std::max(largest, elements);
+  };
+  for (int i = 0; i < ctx.num_inputs(); ++i) visit(DenseInput(ctx, i));
+  visit(Output(ctx, 0));
+  if (pooled <= 0) return cost;
+
+  if (window_size <= 0) window_size = std::max<int64>(largest / pooled, 1);
+  cost.flops = pooled * window_size;
+  return cost;
+}
+
+OpCost EstimateOpCost(absl::string_view op_type, const OpKernelContext& ctx) {
+  const absl::string_view base_type = BaseOpType(op_type);
+  if (absl::StrContains(base_type, "Pool")) return PoolingOpCost(ctx, 0);
+
+  OpCost cost;
+  cost.bytes = OpCostBytes(ctx);
+  if (absl::StrContains(base_type, "MatMul")) {
+    if (!absl::StrContains(base_type, "Grad")) cost.flops = MatMulFlops(ctx);
+  } else if (absl::StrContains(base_type, "Conv")) {
+    cost.flops = ConvFlops(base_type, ctx);
+  } else if (absl::StrContains(base_type, "BatchNorm") ||
+             absl::StrContains(base_type, "LayerNorm") ||
+             absl::StrContains(base_type, "InstanceNorm")) {
+    const Tensor* input = DenseInput(ctx, 0);
+    if (input != nullptr) {
+      cost.flops = input->NumElements() *
+                   (absl::StrContains(base_type, "Grad")
+                        ? kNormGradFlopsPerElement
+                        : kNormFlopsPerElement);
+    }
+  } else {
+    const Tensor* output = Output(ctx, 0);
+    if (output != nullptr) {
+      cost.flops =
+          output->NumElements() * ElementwiseFlopsPerElement(base_type, ctx);
+    }
+  }
+  return cost;
+}
+
+OpCost OpKernel::Cost(const OpKernelContext& ctx) const {
+  return EstimateOpCost(type(), ctx);
+}
+
+ScopedOpCost::ScopedOpCost(const OpKernel* op, const OpKernelContext* context,
+                           AnnotatedTraceMe* activity)
+    : op_(op),
+      context_(context),
+      activity_(activity),
+      record_metrics_(IsOpCostEnabled()) {
+  if (record_metrics_) start_nsecs_ = EnvTime::NowNanos();
+}
+
+ScopedOpCost::~ScopedOpCost() {
+  if (!record_metrics_ && !activity_->IsTracing()) return;
+  const uint64 nsecs = record_metrics_ ? EnvTime::NowNanos() - start_nsecs_ : 0;
+  if (!context_->status().ok()) return;
+
+  const OpCost cost = op_->Cost(*context_);
+  activity_->AppendMetadata([&cost] {
+    return TraceMeEncode({{"flops", cost.flops}, {"bytes", cost.bytes}});
+  });
+  if (record_metrics_) {
+    metrics::RecordOpCost(op_->type(), cost.flops, cost.bytes, nsecs);
+  }
+}
+
+}  // namespace itex
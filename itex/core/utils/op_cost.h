@@ -0,0 +1,53 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef ITEX_CORE_UTILS_OP_COST_H_
+#define ITEX_CORE_UTILS_OP_COST_H_
+
+#include "absl/strings/string_view.h"
+#include "itex/core/utils/op_kernel.h"
+#include "itex/core/utils/types.h"
+
+namespace itex {
+
+// Analytical cost models of ITEX kernels, evaluated on the actual shapes of a
+// run. FLOPs are those of the unfused reference computation:
+//
+//   contractions   2 * output elements * reduction size, for MatMul,
+//                  BatchMatMul and Conv, including their fusions and the
+//                  Conv backprops
+//   normalizations a fixed number of FLOPs per input element for BatchNorm,
+//                  LayerNorm and InstanceNorm
+//   pooling        output elements * window size
+//   element-wise   a fixed number of FLOPs per output element, more for
+//                  transcendental activations
+//
+// Other ops, e.g. data movement, only report their bytes. So do ops whose
+// inputs are in oneDNN block layout, their shapes are in the meta tensors.
+
+// Returns the cost of the run of an "op_type" kernel that just finished in
+// "ctx". "op_type" may have the _ITEX or _OneDnn prefix.
+OpCost EstimateOpCost(absl::string_view op_type, const OpKernelContext& ctx);
+
+// Returns the bytes of the inputs and outputs of the run in "ctx".
+int64 OpCostBytes(const OpKernelContext& ctx);
+
+// Returns the cost of a pooling run in "ctx" with a window of "window_size"
+// elements. A window size of 0 is estimated from the shapes.
+OpCost PoolingOpCost(const OpKernelContext& ctx, int64 window_size);
+
+}  // namespace itex
+
+#endif  // ITEX_CORE_UTILS_OP_COST_H_
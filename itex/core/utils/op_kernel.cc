@@ -24,8 +24,12 @@ limitations under the License.
 #include "itex/core/graph/config_util.h"
 #ifndef INTEL_CPU_ONLY
 #include "itex/core/utils/gpu_resource_mgr_pool.h"
+#else
+#include "itex/core/devices/cpu/huge_page_arena.h"
 #endif
+#include "itex/core/utils/flight_recorder.h"
 #include "itex/core/utils/kernel_def_util.h"
+#include "itex/core/utils/memory_profiler.h"
 #include "itex/core/utils/op_requires.h"
 #include "itex/core/utils/padding.h"
 #include "itex/core/utils/plugin_tensor.h"
@@ -72,15 +76,84 @@ void EmptyCopyFunctor(TF_OpKernelContext* tf_ctx, TF_Tensor* tf_source,
   return;
 }
 
-int OpKernelContext::num_inputs() const { return TF_NumInputs(ctx_); }
+namespace {
+// Statuses of finished contexts. A thread runs one kernel at a time, plus
+// the odd nested context, so a handful of them covers it.
+class StatusFreeList {
+ public:
+  ~StatusFreeList() {
+    for (TF_Status* status : statuses_) TF_DeleteStatus(status);
+  }
+
+  TF_Status* Get() {
+    if (statuses_.empty()) return TF_NewStatus();
+    TF_Status* status = statuses_.back();
+    statuses_.pop_back();
+    TF_SetStatus(status, TF_OK, "");
+    return status;
+  }
+
+  void Put(TF_Status* status) {
+    if (statuses_.size() < kMaxSize) {
+      statuses_.push_back(status);
+    } else {
+      TF_DeleteStatus(status);
+    }
+  }
+
+ private:
+  static constexpr size_t kMaxSize = 4;
+  gtl::InlinedVector<TF_Status*, kMaxSize> statuses_;
+};
+
+thread_local StatusFreeList status_free_list;
+
+thread_local absl::string_view current_op_type;
+thread_local absl::string_view current_op_name;
+}  // namespace
+
+absl::string_view CurrentOpType() { return current_op_type; }
+
+absl::string_view CurrentOpName() { return current_op_name; }
+
+ScopedCurrentOp::ScopedCurrentOp(absl::string_view type,
+                                 absl::string_view name)
+    : previous_type_(current_op_type), previous_name_(current_op_name) {
+  current_op_type = type;
+  current_op_name = name;
+}
+
+ScopedCurrentOp::~ScopedCurrentOp() {
+  current_op_type = previous_type_;
+  current_op_name = previous_name_;
+}
+
+/* static */ TF_Status* OpKernelContext::AcquireStatus() {
+  return status_free_list.Get();
+}
+
+/* static */ void OpKernelContext::ReleaseStatus(TF_Status* status) {
+  status_free_list.Put(status);
+}
+
+Tensor& OpKernelContext::SetInput(int index, TF_Tensor* tensor) const {
+  gtl::InlinedVector<int64, 4> dims(TF_NumDims(tensor));
+  for (size_t j = 0; j < dims.size(); ++j) {
+    dims[j] = TF_Dim(tensor, j);
+  }
+  return inputs_[index].emplace(static_cast<DataType>(TF_TensorType(tensor)),
+                                TensorShape(dims), tensor);
+}
+
+int OpKernelContext::num_inputs() const { return inputs_.size(); }
 
 bool OpKernelContext::input_is_ref(int index) const {
   return TF_IsRefInput(ctx_, index, status_);
 }
 
 DataType OpKernelContext::input_dtype(int index) const {
-  if (inputs_ != nullptr && inputs_->at(index) != nullptr) {
-    return inputs_->at(index)->dtype();
+  if (inputs_[index].has_value()) {
+    return inputs_[index]->dtype();
   } else {
     ITEX_CHECK(false)
         << "please call ctx.input_dtype() after calling ctx.input() or "
@@ -105,24 +178,12 @@ DataType OpKernelContext::expected_output_dtype(int index) const {
 const Tensor& OpKernelContext::input(int index) const {
   ITEX_CHECK_GE(index, 0);
   ITEX_CHECK_LT(index, num_inputs());
-  if (inputs_ == nullptr) {
-    inputs_ = new gtl::InlinedVector<std::shared_ptr<Tensor>, 4>(num_inputs());
-  }
-
-  if (!inputs_->at(index)) {
+  if (!inputs_[index].has_value()) {
     TF_Tensor* tensor = nullptr;
     TF_GetInput(ctx_, index, &tensor, status_);
-    TensorShape shape;
-    auto dims = TF_NumDims(tensor);
-    for (auto j = 0; j < dims; ++j) {
-      shape.AddDim(TF_Dim(tensor, j));
-    }
-    std::shared_ptr<Tensor> ptr = std::make_shared<Tensor>(
-        static_cast<DataType>(TF_TensorType(tensor)), shape, tensor);
-    inputs_->at(index) = std::move(ptr);
+    return SetInput(index, tensor);
   }
-  ITEX_CHECK_NE(inputs_, nullptr);
-  return *inputs_->at(index);
+  return *inputs_[index];
 }
 
 #ifndef INTEL_CPU_ONLY
@@ -157,31 +218,14 @@ Status OpKernelContext::input(StringPiece name, const Tensor** tensor) {
   return cc_status;
 }
 
-void* OpKernelContext::tensor_data(int index) {
-  TF_Tensor* tensor = nullptr;
-  TF_GetInput(ctx_, index, &tensor, status_);
-  void* data = TF_TensorData(tensor);
-  TF_DeleteTensor(tensor);
-  return data;
-}
+void* OpKernelContext::tensor_data(int index) { return input(index).data(); }
 
 bool OpKernelContext::is_input_same(int index, std::vector<int64> shape) {
-  TF_Tensor* tensor = nullptr;
-  TF_GetInput(ctx_, index, &tensor, status_);
-  int dims = TF_NumDims(tensor);
-  if (dims != static_cast<int>(shape.size())) {
-    TF_DeleteTensor(tensor);
-    return false;
-  }
-
-  for (int i = 0; i < dims; ++i) {
-    if (shape[i] != TF_Dim(tensor, i)) {
-      TF_DeleteTensor(tensor);
-      return false;
-    }
+  const TensorShape& input_shape = input(index).shape();
+  if (input_shape.dims() != static_cast<int>(shape.size())) return false;
+  for (int i = 0; i < input_shape.dims(); ++i) {
+    if (shape[i] != input_shape.dim_size(i)) return false;
   }
-
-  TF_DeleteTensor(tensor);
   return true;
 }
 
@@ -199,15 +243,13 @@ int64_t OpKernelContext::step_id() const { return TF_StepId(ctx_); }
 // }
 
 bool OpKernelContext::ValidateInputsAreSameShape() {
-  OpKernelContext ctx(ctx_);
-
-  const size_t kNumInputs = ctx.num_inputs();
+  const size_t kNumInputs = num_inputs();
   for (size_t i = 1; i < kNumInputs; ++i) {
-    if (!ctx.input(0).IsSameSize(ctx.input(i))) {
-      ctx.CtxFailure(errors::InvalidArgument(
+    if (!input(0).IsSameSize(input(i))) {
+      CtxFailure(errors::InvalidArgument(
           "Inputs must have the same size and shape. Input 0: ",
-          ctx.input(0).shape().DebugString(), " != input ", std::to_string(i),
-          ": ", ctx.input(i).shape().DebugString()));
+          input(0).shape().DebugString(), " != input ", std::to_string(i),
+          ": ", input(i).shape().DebugString()));
       return false;
     }
   }
@@ -220,19 +262,26 @@ Status OpKernelContext::forward_input_or_allocate_output(
     const TensorShape& output_shape, Tensor** output, int* forwarded_input) {
   ITEX_CHECK_GE(output_index, 0);
   ITEX_CHECK_LT(output_index, num_outputs());
+  int forwarded = -1;
   TF_Tensor* tensor = TF_ForwardInputOrAllocateOutput(
       ctx_, const_cast<int*>(candidate_input_indices.data()),
       candidate_input_indices.size(), output_index,
-      output_shape.dim_sizes().data(), output_shape.dims(), forwarded_input,
+      output_shape.dim_sizes().data(), output_shape.dims(), &forwarded,
       status_);
-  if (outputs_[output_index] == nullptr) {
-    std::shared_ptr<Tensor> ptr = std::make_shared<Tensor>(
+  if (forwarded_input != nullptr) *forwarded_input = forwarded;
+#ifdef INTEL_CPU_ONLY
+  if (forwarded < 0 && TF_GetCode(status_) == TF_OK &&
+      IsMemoryProfileEnabled()) {
+    RecordUntrackedAllocation(TF_TensorByteSize(tensor));
+  }
+#endif  // INTEL_CPU_ONLY
+  if (!outputs_[output_index].has_value()) {
+    outputs_[output_index].emplace(
         static_cast<DataType>(expected_output_dtype(output_index)),
         output_shape, tensor);
-    outputs_[output_index] = std::move(ptr);
   }
 
-  *output = outputs_[output_index].get();
+  *output = &*outputs_[output_index];
   return StatusFromTF_Status(status_);
 }
 
@@ -246,17 +295,20 @@ Tensor* OpKernelContext::mutable_output(int index) {
   ITEX_DCHECK_GE(index, 0);
   ITEX_DCHECK_LT(index, num_outputs());
 
-  return outputs_[index].get();
+  return outputs_[index].has_value() ? &*outputs_[index] : nullptr;
+}
+
+const Tensor* OpKernelContext::output(int index) const {
+  ITEX_DCHECK_GE(index, 0);
+  ITEX_DCHECK_LT(index, num_outputs());
+
+  return outputs_[index].has_value() ? &*outputs_[index] : nullptr;
 }
 
 Tensor& OpKernelContext::mutable_input(int index, bool lock_held) {
   ITEX_CHECK_GE(index, 0);
   ITEX_CHECK_LT(index, num_inputs());
-  if (inputs_ == nullptr) {
-    inputs_ = new gtl::InlinedVector<std::shared_ptr<Tensor>, 4>(num_inputs());
-  }
-
-  if (!inputs_->at(index)) {
+  if (!inputs_[index].has_value()) {
     TF_Tensor* tensor = nullptr;
     TF_GetInputTensorFromVariable(
         ctx_, index, lock_held, /* isVariantType unused */ false,
@@ -264,18 +316,9 @@ Tensor& OpKernelContext::mutable_input(int index, bool lock_held) {
         status_);
     Status s = StatusFromTF_Status(status_);
     ITEX_CHECK_EQ(Status::OK(), s);
-    TensorShape shape;
-    auto dims = TF_NumDims(tensor);
-    for (auto j = 0; j < dims; ++j) {
-      shape.AddDim(TF_Dim(tensor, j));
-    }
-    std::shared_ptr<Tensor> ptr = std::make_shared<Tensor>(
-        static_cast<DataType>(TF_TensorType(tensor)), shape, tensor);
-    inputs_->at(index) = std::move(ptr);
+    return SetInput(index, tensor);
   }
-
-  ITEX_CHECK_NE(inputs_, nullptr);
-  return *inputs_->at(index);
+  return *inputs_[index];
 }
 
 Status OpKernelContext::output_list(StringPiece name, OpOutputList* list) {
@@ -289,39 +332,102 @@ Status OpKernelContext::output_list(StringPiece name, OpOutputList* list) {
 Status OpKernelContext::allocate_output(int index, const TensorShape& shape,
                                         Tensor** tensor) {
   DataType out_type = static_cast<DataType>(expected_output_dtype(index));
-  TF_Tensor* output = TF_AllocateOutput(
-      ctx_, index, static_cast<TF_DataType>(out_type), shape.dim_sizes().data(),
-      shape.dims(), shape.num_elements() * DataTypeSize(out_type), status_);
-  if (outputs_[index] == nullptr) {
-    std::shared_ptr<Tensor> ptr = std::make_shared<Tensor>(
+  TF_Tensor* output = nullptr;
+#ifdef INTEL_CPU_ONLY
+  if (IsMemoryProfileEnabled()) {
+    AllocatorAttributes attr;
+    output = AllocateProfiledTensor(ctx_, out_type, shape, &attr.plugin_attr(),
+                                    MemoryKind::kOutput, step_id(), status_);
+    if (TF_GetCode(status_) != TF_OK) return StatusFromTF_Status(status_);
+  }
+  if (output != nullptr) {
+    TF_SetOutput(ctx_, index, output, status_);
+    if (TF_GetCode(status_) != TF_OK) {
+      TF_DeleteTensor(output);
+      return StatusFromTF_Status(status_);
+    }
+  }
+#endif  // INTEL_CPU_ONLY
+  if (output == nullptr) {
+    output = TF_AllocateOutput(ctx_, index, static_cast<TF_DataType>(out_type),
+                               shape.dim_sizes().data(), shape.dims(),
+                               shape.num_elements() * DataTypeSize(out_type),
+                               status_);
+  }
+  if (!outputs_[index].has_value()) {
+    outputs_[index].emplace(
         static_cast<DataType>(expected_output_dtype(index)), shape, output);
-    outputs_[index] = std::move(ptr);
   }
-  *tensor = outputs_[index].get();
+  *tensor = &*outputs_[index];
 
   return StatusFromTF_Status(status_);
 }
 
+#ifdef INTEL_CPU_ONLY
+namespace {
+void DeallocateHugePageTensor(void* data, size_t len, void* arg) {
+  static_cast<HugePageArena*>(arg)->DeallocateRaw(data);
+}
+
+// Returns a tensor on huge pages if the arena is enabled and the tensor is
+// asked to be there or is large enough, nullptr otherwise.
+TF_Tensor* MaybeAllocateOnHugePages(
+    DataType type, const TensorShape& shape,
+    const AllocationAttributes& allocation_attr, int64 step_id) {
+  HugePageArena* arena = HugePageArena::Global();
+  if (arena == nullptr || type == DT_STRING) return nullptr;
+  const size_t bytes = shape.num_elements() * DataTypeSize(type);
+  const size_t min_temp_bytes = arena->options().min_temp_bytes;
+  const bool large_temp = min_temp_bytes > 0 && bytes >= min_temp_bytes;
+  if (bytes == 0 || !(allocation_attr.prefer_huge_pages || large_temp)) {
+    return nullptr;
+  }
+  void* data = arena->AllocateRaw(bytes);
+  if (data == nullptr) return nullptr;
+  return NewProfiledTensor(type, shape, data, bytes, DeallocateHugePageTensor,
+                           arena, MemoryKind::kTemp, step_id);
+}
+}  // namespace
+#endif  // INTEL_CPU_ONLY
+
 Status OpKernelContext::allocate_temp(
     DataType type, const TensorShape& shape, Tensor* out_temp,
     AllocatorAttributes allocator_attr,
     const AllocationAttributes& allocation_attr) {
-  TF_Tensor* tmp = TF_AllocateTemp(ctx_, static_cast<TF_DataType>(type),
-                                   shape.dim_sizes().data(), shape.dims(),
-                                   &allocator_attr.plugin_attr(), status_);
+  TF_Tensor* tmp = nullptr;
+#ifdef INTEL_CPU_ONLY
+  const bool profile_memory = IsMemoryProfileEnabled();
+  const int64 step = profile_memory ? step_id() : 0;
+  tmp = MaybeAllocateOnHugePages(type, shape, allocation_attr, step);
+  if (tmp == nullptr && profile_memory) {
+    tmp = AllocateProfiledTensor(ctx_, type, shape,
+                                 &allocator_attr.plugin_attr(),
+                                 MemoryKind::kTemp, step, status_);
+    if (TF_GetCode(status_) != TF_OK) return StatusFromTF_Status(status_);
+  }
+  if (tmp != nullptr) TF_SetStatus(status_, TF_OK, "");
+#endif  // INTEL_CPU_ONLY
+  if (tmp == nullptr) {
+    tmp = TF_AllocateTemp(ctx_, static_cast<TF_DataType>(type),
+                          shape.dim_sizes().data(), shape.dims(),
+                          &allocator_attr.plugin_attr(), status_);
+  }
   Tensor t(type, shape, tmp);
   *out_temp = std::move(t);
 
   return StatusFromTF_Status(status_);
 }
 
-Status OpKernelContext::allocate_persistent(DataType type,
-                                            const TensorShape& shape,
-                                            PersistentTensor* out_persistent,
-                                            Tensor** out_tensor,
-                                            AllocatorAttributes attr) {
+Status OpKernelContext::allocate_persistent(
+    DataType type, const TensorShape& shape, PersistentTensor* out_persistent,
+    Tensor** out_tensor, AllocatorAttributes attr,
+    const AllocationAttributes& allocation_attr) {
   Tensor persistent;
-  TF_ABORT_IF_ERROR(allocate_temp(type, shape, &persistent, attr));
+  {
+    ScopedMemoryKind kind(ResolveMemoryKind(MemoryKind::kPersistent));
+    TF_ABORT_IF_ERROR(
+        allocate_temp(type, shape, &persistent, attr, allocation_attr));
+  }
 
   // TODO(itex): proper use copy for persistent, plugin use move.
   // Investigate the result caused by different implementation.
@@ -339,9 +445,8 @@ void OpKernelContext::set_output(int index, const Tensor& tensor) {
       << " Index out of range while setting output";
   TF_SetOutput(ctx_, index, tensor.GetTFTensor(), status_);
   ITEX_CHECK_EQ(TF_OK, TF_GetCode(status_)) << " Error while setting output";
-  ITEX_CHECK_EQ(outputs_[index], nullptr);
-  std::shared_ptr<Tensor> ptr = std::make_shared<Tensor>(tensor);
-  outputs_[index] = std::move(ptr);
+  ITEX_CHECK(!outputs_[index].has_value());
+  outputs_[index].emplace(tensor);
   return;
 }
 
@@ -562,12 +667,20 @@ Status OpKernelConstruction::GetAttr<TensorShape>(StringPiece attr_name,
   int32_t list_size = 0;
   int32_t total_size = 0;
   std::vector<int64_t> shape_list;
+  std::string name(attr_name.data(), attr_name.size());
 
-  TF_OpKernelConstruction_GetAttrSize(ctx_, "shape", &list_size, &total_size,
-                                      status_);
+  TF_OpKernelConstruction_GetAttrSize(ctx_, name.c_str(), &list_size,
+                                      &total_size, status_);
+  Status s = StatusFromTF_Status(status_);
+  if (!s.ok()) return s;
+  // The size is -1 for a shape of unknown rank.
+  if (total_size < 0) {
+    return errors::InvalidArgument("Attr '", name, "' has an unknown rank");
+  }
   shape_list.resize(total_size);
-  TF_OpKernelConstruction_GetAttrTensorShape(ctx_, "shape", shape_list.data(),
-                                             total_size, status_);
+  TF_OpKernelConstruction_GetAttrTensorShape(ctx_, name.c_str(),
+                                             shape_list.data(), total_size,
+                                             status_);
   for (auto dim : shape_list) {
     shape->AddDim(dim);
   }
@@ -605,10 +718,30 @@ const char* OpKernelConstruction::OpName() const {
 }
 
 OpKernel::OpKernel(OpKernelConstruction* context)
-    : op_name(context->OpName()) {}
+    : op_name(context->OpName()) {
+  if (context->HasAttr(kExecutionDomainAttr)) {
+    int32_t id;
+    OP_REQUIRES_OK(context, context->GetAttr(kExecutionDomainAttr, &id));
+    OP_REQUIRES(context, id >= 0 && id < ExecutionDomain::NumDomains(),
+                errors::InvalidArgument("Node ", op_name,
+                                        " is bound to execution domain ", id,
+                                        " which does not exist"));
+    execution_domain_ = ExecutionDomain::Get(id);
+  }
+}
 
 OpKernel::~OpKernel() {}
 
+void OpKernel::set_type(absl::string_view type) {
+  op_type = type;
+  flight_op_id_ = flight_recorder::InternOp(op_name, op_type);
+}
+
+void OpKernel::RegisterReplayCapture(OpKernelConstruction* context) {
+  replay_capture_id_ =
+      replay_capture::RegisterKernel(op_name, op_type, context);
+}
+
 string OpKernel::ShapeTraceString(const OpKernelContext& ctx) const {
   int num_inputs = ctx.num_inputs();
   if (num_inputs == 0) return "";
@@ -779,6 +912,16 @@ bool IsVerboseEnabled() {
   return verbose_enabled != 0;
 }
 
+bool IsOpCostEnabled() {
+  static std::once_flag op_cost_flag;
+  static bool op_cost_enabled;
+  std::call_once(op_cost_flag, [&]() {
+    ITEX_CHECK_OK(ReadBoolFromEnvVar("ITEX_OP_COST", false, &op_cost_enabled));
+  });
+
+  return op_cost_enabled;
+}
+
 bool IsSyncExecEnabled() {
   static std::once_flag sync_exec_flag;
   static bool sync_exec_enabled;
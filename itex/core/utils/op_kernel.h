@@ -26,14 +26,17 @@ limitations under the License.
 #include <vector>
 
 #include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
 #include "itex/core/utils/allocator.h"
 #include "itex/core/utils/annotated_traceme.h"
 #include "itex/core/utils/cpu_info.h"
 #include "itex/core/utils/env_var.h"
+#include "itex/core/utils/execution_domain.h"
 #include "itex/core/utils/kernel_def_util.h"
 #include "itex/core/utils/logging.h"
 #include "itex/core/utils/mutex.h"
 #include "itex/core/utils/plugin_tensor.h"
+#include "itex/core/utils/replay_capture.h"
 #include "itex/core/utils/types.h"
 #include "protos/node_def.pb.h"
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
@@ -177,24 +180,22 @@ class OpKernelContext {
 #ifndef INTEL_CPU_ONLY
   explicit OpKernelContext(TF_OpKernelContext* ctx)
       : ctx_(ctx),
+        inputs_(TF_NumInputs(ctx_)),
         outputs_(TF_NumOutputs(ctx_)),
-        status_(TF_NewStatus()),
+        status_(AcquireStatus()),
         device_(ctx_, status_),
         resource_mgr(nullptr) {}
 #else
   explicit OpKernelContext(TF_OpKernelContext* ctx)
       : ctx_(ctx),
+        inputs_(TF_NumInputs(ctx_)),
         outputs_(TF_NumOutputs(ctx_)),
-        status_(TF_NewStatus()),
+        status_(AcquireStatus()),
         device_(ctx_, status_) {}
 #endif
 
   ~OpKernelContext() {
-    if (inputs_ != nullptr) {
-      delete inputs_;
-    }
-
-    TF_DeleteStatus(status_);
+    ReleaseStatus(status_);
     status_ = nullptr;
   }
 
@@ -305,7 +306,14 @@ class OpKernelContext {
 
   Status allocate_persistent(DataType type, const TensorShape& shape,
                              PersistentTensor* out_persistent,
-                             Tensor** out_tensor, AllocatorAttributes attr);
+                             Tensor** out_tensor, AllocatorAttributes attr,
+                             const AllocationAttributes& allocation_attr);
+  Status allocate_persistent(DataType type, const TensorShape& shape,
+                             PersistentTensor* out_persistent,
+                             Tensor** out_tensor, AllocatorAttributes attr) {
+    return allocate_persistent(type, shape, out_persistent, out_tensor, attr,
+                               AllocationAttributes());
+  }
   Status allocate_persistent(DataType type, const TensorShape& shape,
                              PersistentTensor* out_persistent,
                              Tensor** out_tensor) {
@@ -323,6 +331,8 @@ class OpKernelContext {
 
   // Status mutable_output(StringPiece name, Tensor** tensor);
   Tensor* mutable_output(int index);
+  // Output "index" set by the kernel so far, nullptr if there is none.
+  const Tensor* output(int index) const;
 
   static const Eigen::ThreadPoolDevice& eigen_cpu_device_singleton() {
     static Eigen::ThreadPool threadpool(port::NumSchedulableCPUs());
@@ -337,6 +347,8 @@ class OpKernelContext {
     // TODO(itex): CPU should get thread pool device from local device:
     // *device()->eigen_cpu_device();
     // This helps to identity NUMA affinity.
+    const ExecutionDomain* domain = ExecutionDomain::Current();
+    if (domain != nullptr) return domain->eigen_cpu_device();
     return eigen_cpu_device_singleton();
   }
 
@@ -383,11 +395,21 @@ class OpKernelContext {
   OpKernelContext() = delete;
   OpKernelContext(const OpKernelContext&) = delete;
   const OpKernelContext& operator=(const OpKernelContext&) = delete;
+  // A context lives for one Compute call, so its TF_Status comes from a
+  // per-thread free list instead of TF_NewStatus.
+  static TF_Status* AcquireStatus();
+  static void ReleaseStatus(TF_Status* status);
+
+  // Wraps `tensor`, just fetched from TensorFlow, as input `index`.
+  Tensor& SetInput(int index, TF_Tensor* tensor) const;
+
   TF_OpKernelContext* ctx_;
   // We use single vector inputs_ to store all kinds of input tensors:
-  // normal/ref/resource
-  mutable gtl::InlinedVector<std::shared_ptr<Tensor>, 4>* inputs_ = nullptr;
-  gtl::InlinedVector<std::shared_ptr<Tensor>, 4> outputs_;
+  // normal/ref/resource. Each one is fetched from TensorFlow at most once,
+  // and the tensors are constructed in place, so that ops with up to 4
+  // inputs and outputs allocate no wrapper on the heap.
+  mutable gtl::InlinedVector<absl::optional<Tensor>, 4> inputs_;
+  gtl::InlinedVector<absl::optional<Tensor>, 4> outputs_;
   std::map<StringPiece, std::shared_ptr<Tensor>> inputsMap_;
   TF_Status* status_;
   class InternalDevice {
@@ -562,12 +584,25 @@ class OpKernelConstruction {
   //  friend class OpKernel;
 };
 
+// Analytical work of one run of a kernel, for roofline analysis.
+struct OpCost {
+  // Floating point or integer arithmetic operations, 0 if unknown.
+  int64 flops = 0;
+  // Bytes of all inputs and outputs, the compulsory memory traffic.
+  int64 bytes = 0;
+};
+
 class OpKernel {
  public:
   explicit OpKernel(OpKernelConstruction* context);
   virtual ~OpKernel() = 0;
   virtual void Compute(OpKernelContext* context) = 0;
 
+  // Cost of the run that just finished in "ctx". The default estimates it
+  // from the op type and the shapes of the inputs and outputs, see
+  // EstimateOpCost(). Kernels override it when their attributes matter.
+  virtual OpCost Cost(const OpKernelContext& ctx) const;
+
   bool IsLegacyScalar(const TensorShape& shape) const {
     return shape.dims() == 0;
   }
@@ -580,15 +615,95 @@ class OpKernel {
 
   const absl::string_view type() const { return op_type; }
 
-  void set_type(absl::string_view type) { op_type = type; }
+  // Also registers the node with the flight recorder, see flight_op_id().
+  void set_type(absl::string_view type);
+
+  // Id of the node in the flight recorder, -1 if it is disabled.
+  int32 flight_op_id() const { return flight_op_id_; }
+
+  // Registers the node for a replay capture if it is one of the nodes of
+  // ITEX_REPLAY_CAPTURE. REQUIRES: set_type() was called.
+  void RegisterReplayCapture(OpKernelConstruction* context);
+
+  // Id of the replay capture of the node, -1 if it is not captured.
+  int32 replay_capture_id() const { return replay_capture_id_; }
 
   std::string ShapeTraceString(const OpKernelContext& ctx) const;
 
   std::string TraceString(const OpKernelContext& ctx) const;
 
+  // Domain the node was bound to by the graph optimizer, see
+  // kExecutionDomainAttr. nullptr if it runs in the domain of the calling
+  // thread.
+  ExecutionDomain* execution_domain() const { return execution_domain_; }
+
  private:
   absl::string_view op_name;
   absl::string_view op_type;
+  ExecutionDomain* execution_domain_ = nullptr;
+  int32 flight_op_id_ = -1;
+  int32 replay_capture_id_ = -1;
+};
+
+// Type and node name of the op whose kernel the calling thread is computing,
+// empty outside of OpKernel::Compute. Lets shared helpers attribute their work
+// to an op.
+absl::string_view CurrentOpType();
+absl::string_view CurrentOpName();
+
+// Makes "type" and "name" the current op for the lifetime of the object.
+class ScopedCurrentOp {
+ public:
+  ScopedCurrentOp(absl::string_view type, absl::string_view name);
+  ~ScopedCurrentOp();
+
+ private:
+  absl::string_view previous_type_;
+  absl::string_view previous_name_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(ScopedCurrentOp);
+};
+
+// Records the run of "op" in the flight recorder, see flight_recorder.h.
+class ScopedFlightRecord {
+ public:
+  ScopedFlightRecord(const OpKernel* op, OpKernelContext* context);
+  ~ScopedFlightRecord();
+
+ private:
+  const int32 op_id_;
+  OpKernelContext* context_;
+  const uint64 start_nsecs_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(ScopedFlightRecord);
+};
+
+// Writes the inputs of "op" for a replay if it is one of the nodes of
+// ITEX_REPLAY_CAPTURE, see replay_capture.h.
+inline void MaybeCaptureForReplay(const OpKernel* op,
+                                  OpKernelContext* context) {
+  if (ITEX_PREDICT_FALSE(op->replay_capture_id() >= 0)) {
+    replay_capture::Capture(op->replay_capture_id(), context);
+  }
+}
+
+// Attaches the cost of one run of "op" to its TraceMe event when the profiler
+// is tracing, and records it with the run time in the kernel metrics when
+// ITEX_OP_COST is set.
+class ScopedOpCost {
+ public:
+  ScopedOpCost(const OpKernel* op, const OpKernelContext* context,
+               AnnotatedTraceMe* activity);
+  ~ScopedOpCost();
+
+ private:
+  const OpKernel* op_;
+  const OpKernelContext* context_;
+  AnnotatedTraceMe* activity_;
+  bool record_metrics_;
+  uint64 start_nsecs_ = 0;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(ScopedOpCost);
 };
 
 class KernelDefBuilder {
@@ -718,6 +833,8 @@ class Registrar {
 // types of implementation.
 bool IsSyncExecEnabled();
 bool IsVerboseEnabled();
+// Whether ITEX_OP_COST is set, see ScopedOpCost.
+bool IsOpCostEnabled();
 
 #ifndef INTEL_CPU_ONLY
 const char* const USES_FP64_MATH = "uses-fp64-math";
@@ -826,6 +943,7 @@ class OpTypeFactory {
     absl::string_view op_type =                                             \
         OpTypeFactory::GetForKernelCreateFunc(&Create_##ctr);               \
     kernel->set_type(op_type);                                              \
+    kernel->RegisterReplayCapture(&context);                                \
     return kernel;                                                          \
   }                                                                         \
   static void Delete_##ctr(void* kernel) {                                  \
@@ -840,6 +958,11 @@ class OpTypeFactory {
                  << op->type();                                             \
     AnnotatedTraceMe activity(                                              \
         [op, &context] { return op->TraceString(context); });               \
+    ScopedExecutionDomain domain_scope(op->execution_domain());             \
+    ScopedCurrentOp current_op_scope(op->type(), op->name());               \
+    ScopedOpCost op_cost(op, &context, &activity);                          \
+    MaybeCaptureForReplay(op, &context);                                    \
+    ScopedFlightRecord flight_record(op, &context);                         \
     RunOrWaitUntilFinish(&context, op);                                     \
   }                                                                         \
   static void Register##ctr(const char* device_name, const char* backend) { \
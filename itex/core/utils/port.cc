@@ -125,6 +125,33 @@ int NumHyperthreadsPerCore() {
   return (ht_per_core > 0) ? ht_per_core : 1;
 }
 
+std::vector<int> GetThreadCPUAffinity() {
+  std::vector<int> cpus;
+#if defined(__linux__)
+  cpu_set_t cpuset;
+  if (sched_getaffinity(0, sizeof(cpu_set_t), &cpuset) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &cpuset)) cpus.push_back(cpu);
+    }
+  }
+#endif
+  return cpus;
+}
+
+bool SetThreadCPUAffinity(const std::vector<int>& cpus) {
+#if defined(__linux__)
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  for (int cpu : cpus) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+    CPU_SET(cpu, &cpuset);
+  }
+  return sched_setaffinity(0, sizeof(cpu_set_t), &cpuset) == 0;
+#else
+  return false;
+#endif
+}
+
 #ifdef TENSORFLOW_USE_NUMA
 namespace {
 static hwloc_topology_t hwloc_topology_handle;
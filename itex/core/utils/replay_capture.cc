@@ -0,0 +1,321 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "itex/core/utils/replay_capture.h"
+
+#include <unistd.h>
+
+#include <atomic>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "itex/core/utils/env.h"
+#include "itex/core/utils/env_var.h"
+#include "itex/core/utils/hash.h"
+#include "itex/core/utils/logging.h"
+#include "itex/core/utils/mutex.h"
+#include "itex/core/utils/op_kernel.h"
+#include "protos/graph.pb.h"
+#include "protos/op_def.pb.h"
+#include "tensorflow/c/c_api.h"
+
+extern char** environ;
+
+namespace itex {
+namespace replay_capture {
+
+namespace {
+
+// Environment variables which change how the kernels compute.
+constexpr const char* kEnvPrefixes[] = {"ITEX_", "ONEDNN_", "DNNL_", "OMP_",
+                                        "KMP_"};
+
+struct Config {
+  absl::flat_hash_set<string> nodes;
+  int64 run = 0;
+  bool data = false;
+  string dir;
+};
+
+const Config& GetConfig() {
+  static const Config* config = [] {
+    auto* config = new Config();
+    string nodes;
+    ITEX_CHECK_OK(ReadStringFromEnvVar("ITEX_REPLAY_CAPTURE", "", &nodes));
+    for (absl::string_view node :
+         absl::StrSplit(nodes, ',', absl::SkipWhitespace())) {
+      config->nodes.insert(string(absl::StripAsciiWhitespace(node)));
+    }
+    ITEX_CHECK_OK(
+        ReadInt64FromEnvVar("ITEX_REPLAY_CAPTURE_RUN", 0, &config->run));
+    ITEX_CHECK_OK(
+        ReadBoolFromEnvVar("ITEX_REPLAY_CAPTURE_DATA", false, &config->data));
+    ITEX_CHECK_OK(
+        ReadStringFromEnvVar("ITEX_REPLAY_CAPTURE_DIR", "/tmp", &config->dir));
+    return config;
+  }();
+  return *config;
+}
+
+// Returns the definitions of the ops registered with TensorFlow, the ones of
+// ITEX included.
+const OpList& GetOpList() {
+  static const OpList* op_list = [] {
+    auto* op_list = new OpList();
+    TF_Buffer* buffer = TF_GetAllOpList();
+    op_list->ParseFromArray(buffer->data, buffer->length);
+    TF_DeleteBuffer(buffer);
+    return op_list;
+  }();
+  return *op_list;
+}
+
+const OpDef* FindOpDef(absl::string_view type) {
+  for (const OpDef& op_def : GetOpList().op()) {
+    if (op_def.name() == type) return &op_def;
+  }
+  return nullptr;
+}
+
+// Reads the attr "name" of op definition type "type" into "value". Returns
+// false if it cannot be read through the kernel construction API.
+bool ReadAttr(OpKernelConstruction* context, const string& name,
+              const string& type, AttrValue* value) {
+  if (type == "int") {
+    int64_t i;
+    if (!context->GetAttr(name, &i).ok()) return false;
+    value->set_i(i);
+  } else if (type == "float") {
+    float f;
+    if (!context->GetAttr(name, &f).ok()) return false;
+    value->set_f(f);
+  } else if (type == "bool") {
+    bool b;
+    if (!context->GetAttr(name, &b).ok()) return false;
+    value->set_b(b);
+  } else if (type == "type") {
+    DataType dtype;
+    if (!context->GetAttr(name, &dtype).ok()) return false;
+    value->set_type(dtype);
+  } else if (type == "string") {
+    string s;
+    if (!context->GetAttr(name, &s).ok()) return false;
+    value->set_s(s);
+  } else if (type == "shape") {
+    TensorShape shape;
+    if (!context->GetAttr(name, &shape).ok()) return false;
+    shape.AsProto(value->mutable_shape());
+  } else if (type == "list(int)") {
+    std::vector<int64_t> ints;
+    if (!context->GetAttr(name, &ints).ok()) return false;
+    AttrValue::ListValue* list = value->mutable_list();
+    for (int64_t i : ints) list->add_i(i);
+  } else if (type == "list(float)") {
+    std::vector<float> floats;
+    if (!context->GetAttr(name, &floats).ok()) return false;
+    AttrValue::ListValue* list = value->mutable_list();
+    for (float f : floats) list->add_f(f);
+  } else if (type == "list(bool)") {
+    std::vector<bool> bools;
+    if (!context->GetAttr(name, &bools).ok()) return false;
+    AttrValue::ListValue* list = value->mutable_list();
+    for (bool b : bools) list->add_b(b);
+  } else if (type == "list(type)") {
+    std::vector<DataType> dtypes;
+    if (!context->GetAttr(name, &dtypes).ok()) return false;
+    AttrValue::ListValue* list = value->mutable_list();
+    for (DataType dtype : dtypes) list->add_type(dtype);
+  } else if (type == "list(string)") {
+    std::vector<string> strings;
+    if (!context->GetAttr(name, &strings).ok()) return false;
+    AttrValue::ListValue* list = value->mutable_list();
+    for (const string& s : strings) list->add_s(s);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+struct KernelCapture {
+  NodeDef node_def;
+  std::atomic<int64> runs{0};
+};
+
+// Captures of the kernels of the ITEX_REPLAY_CAPTURE nodes. They are never
+// removed, there is one per kernel created for these nodes.
+class CaptureTable {
+ public:
+  int32 Add(NodeDef node_def) TF_LOCKS_EXCLUDED(mu_) {
+    mutex_lock l(&mu_);
+    captures_.emplace_back();
+    captures_.back().node_def = std::move(node_def);
+    return captures_.size() - 1;
+  }
+
+  KernelCapture* Get(int32 id) TF_LOCKS_EXCLUDED(mu_) {
+    mutex_lock l(&mu_);
+    return &captures_[id];
+  }
+
+ private:
+  mutex mu_;
+  std::deque<KernelCapture> captures_ TF_GUARDED_BY(mu_);
+};
+
+CaptureTable* GetCaptureTable() {
+  static CaptureTable* table = new CaptureTable();
+  return table;
+}
+
+bool CanCaptureData(const Tensor& tensor) {
+#ifdef INTEL_CPU_ONLY
+  switch (tensor.dtype()) {
+    case DT_STRING:
+    case DT_RESOURCE:
+    case DT_VARIANT:
+      return false;
+    default:
+      return true;
+  }
+#else
+  // The data of GPU kernels is in device memory.
+  return false;
+#endif  // INTEL_CPU_ONLY
+}
+
+void AddEnv(AttrValue* env) {
+  for (char** var = environ; *var != nullptr; ++var) {
+    absl::string_view entry(*var);
+    if (absl::StartsWith(entry, "ITEX_REPLAY_")) continue;
+    for (const char* prefix : kEnvPrefixes) {
+      if (absl::StartsWith(entry, prefix)) {
+        env->mutable_list()->add_s(string(entry));
+        break;
+      }
+    }
+  }
+}
+
+string CapturePath(const string& node_name) {
+  string name = node_name;
+  for (char& c : name) {
+    if (c == '/' || c == ':') c = '_';
+  }
+  return absl::StrCat(GetConfig().dir, "/itex_replay_", name, "_", getpid(),
+                      ".pb");
+}
+
+}  // namespace
+
+bool IsEnabled() { return !GetConfig().nodes.empty(); }
+
+int32 RegisterKernel(absl::string_view name, absl::string_view type,
+                     OpKernelConstruction* context) {
+  if (!IsEnabled() || !GetConfig().nodes.contains(name)) return -1;
+  NodeDef node_def;
+  node_def.set_name(string(name));
+  node_def.set_op(string(type));
+  const OpDef* op_def = FindOpDef(type);
+  if (op_def == nullptr) {
+    ITEX_LOG(WARNING) << "No op definition of " << type << " to capture "
+                      << name << " for replay";
+  } else {
+    for (const OpDef::AttrDef& attr : op_def->attr()) {
+      AttrValue value;
+      if (ReadAttr(context, attr.name(), attr.type(), &value)) {
+        (*node_def.mutable_attr())[attr.name()] = value;
+      } else {
+        ITEX_LOG(WARNING) << "Attr " << attr.name() << " of type "
+                          << attr.type() << " of " << name
+                          << " is not captured for replay";
+      }
+    }
+  }
+  return GetCaptureTable()->Add(std::move(node_def));
+}
+
+void Capture(int32 id, OpKernelContext* context) {
+  const Config& config = GetConfig();
+  KernelCapture* capture = GetCaptureTable()->Get(id);
+  if (capture->runs.fetch_add(1, std::memory_order_relaxed) != config.run) {
+    return;
+  }
+
+  GraphDef graph;
+  NodeDef* node = graph.add_node();
+  *node = capture->node_def;
+  NodeDef* meta = graph.add_node();
+  meta->set_name(kMetaNodeName);
+  meta->set_op("NoOp");
+  auto* meta_attr = meta->mutable_attr();
+  const uint64 seed = Hash64(node->name());
+  (*meta_attr)["seed"].set_i(static_cast<int64>(seed >> 1));
+  (*meta_attr)["step_id"].set_i(context->step_id());
+  (*meta_attr)["run"].set_i(config.run);
+  AddEnv(&(*meta_attr)["env"]);
+  AttrValue::ListValue* output_types =
+      (*meta_attr)["output_types"].mutable_list();
+  for (int i = 0; i < context->num_outputs(); ++i) {
+    output_types->add_type(context->expected_output_dtype(i));
+  }
+  AttrValue::ListValue* seeded_inputs =
+      (*meta_attr)["seeded_inputs"].mutable_list();
+
+  for (int i = 0; i < context->num_inputs(); ++i) {
+    NodeDef* input = graph.add_node();
+    input->set_name(absl::StrCat(kInputNodePrefix, i));
+    input->set_op("Const");
+    node->add_input(input->name());
+    TensorProto* value = (*input->mutable_attr())["value"].mutable_tensor();
+    if (context->input_is_ref(i) ||
+        context->input(i).GetTFTensor() == nullptr) {
+      // Not supported by the replay, which reports it.
+      value->set_dtype(context->input_dtype(i));
+      seeded_inputs->add_i(i);
+    } else {
+      const Tensor& tensor = context->input(i);
+      const bool small =
+          tensor.TotalBytes() <= static_cast<size_t>(kMaxSeededInputBytes);
+      if (CanCaptureData(tensor) && (small || config.data)) {
+        tensor.AsProtoTensorContent(value);
+      } else {
+        value->set_dtype(tensor.dtype());
+        tensor.shape().AsProto(value->mutable_tensor_shape());
+        seeded_inputs->add_i(i);
+      }
+    }
+    (*input->mutable_attr())["dtype"].set_type(value->dtype());
+  }
+
+  const string path = CapturePath(node->name());
+  Status status = WriteBinaryProto(Env::Default(), path, graph);
+  if (status.ok()) {
+    ITEX_LOG(INFO) << "Captured run " << config.run << " of " << node->name()
+                   << " for replay to " << path;
+  } else {
+    ITEX_LOG(WARNING) << "Failed to capture " << node->name()
+                      << " for replay: " << status;
+  }
+}
+
+}  // namespace replay_capture
+}  // namespace itex
@@ -0,0 +1,68 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef ITEX_CORE_UTILS_REPLAY_CAPTURE_H_
+#define ITEX_CORE_UTILS_REPLAY_CAPTURE_H_
+
+#include "absl/strings/string_view.h"
+#include "itex/core/utils/types.h"
+
+namespace itex {
+
+class OpKernelConstruction;
+class OpKernelContext;
+
+namespace replay_capture {
+
+// Captures one run of a node of a live model, for replaying its kernel in
+// isolation with itex/core/kernels/benchmark:kernel_replay.
+//
+// ITEX_REPLAY_CAPTURE is a comma separated list of node names. The kernels of
+// these nodes read the attrs of their op definition when they are created,
+// and write their run ITEX_REPLAY_CAPTURE_RUN (0, the first one, by default)
+// to ITEX_REPLAY_CAPTURE_DIR, before computing it. The capture is a GraphDef
+// of:
+//   - the node, with the op, the attrs and the inputs of the kernel,
+//   - a Const node per input, with its dtype and shape. Inputs of up to
+//     kMaxSeededInputBytes keep their data, since they are usually shapes,
+//     axes or oneDNN layout metadata, and larger ones keep it only with
+//     ITEX_REPLAY_CAPTURE_DATA=1. The others are filled from a seed,
+//   - the kMetaNodeName node, with the output types, the seed, the step and
+//     the ITEX, oneDNN and OpenMP environment variables of the process, e.g.
+//     ITEX_CACHE_ONEDNN_OBJECT. The layout and mixed precision passes are
+//     part of the node itself, as its op, e.g. _OneDnnMatMul, and dtypes.
+// Attrs which are not in the op definition, e.g. the ones starting with "_",
+// and attrs of func or tensor type are not captured.
+
+constexpr char kMetaNodeName[] = "_itex_replay_meta";
+constexpr char kInputNodePrefix[] = "_itex_replay_input_";
+constexpr int64 kMaxSeededInputBytes = 4096;
+
+// Whether ITEX_REPLAY_CAPTURE names any node.
+bool IsEnabled();
+
+// Returns the id of the capture of the kernel of node "name" of op "type",
+// whose attrs are read from "context", or -1 if the node is not captured.
+int32 RegisterKernel(absl::string_view name, absl::string_view type,
+                     OpKernelConstruction* context);
+
+// Counts a run of the kernel "id" and writes its capture if it is the run of
+// ITEX_REPLAY_CAPTURE_RUN.
+void Capture(int32 id, OpKernelContext* context);
+
+}  // namespace replay_capture
+}  // namespace itex
+
+#endif  // ITEX_CORE_UTILS_REPLAY_CAPTURE_H_
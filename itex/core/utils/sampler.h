@@ -0,0 +1,237 @@
+/* Copyright (c) 2023 Intel Corporation
+
+Copyright 2016 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef ITEX_CORE_UTILS_SAMPLER_H_
+#define ITEX_CORE_UTILS_SAMPLER_H_
+
+// clang-format off
+#include "itex/core/utils/platform.h"
+// clang-format on
+
+#include <algorithm>  //NOLINT
+#include <array>      //NOLINT
+#include <cfloat>     //NOLINT
+#include <map>        //NOLINT
+#include <memory>     //NOLINT
+#include <string>     //NOLINT
+#include <utility>    //NOLINT
+#include <vector>     //NOLINT
+
+#include "itex/core/utils/collection_registry.h"
+#include "itex/core/utils/logging.h"
+#include "itex/core/utils/macros.h"
+#include "itex/core/utils/metric_def.h"
+#include "itex/core/utils/monitoring_types.h"
+#include "itex/core/utils/mutex.h"
+#include "itex/core/utils/status.h"
+#include "itex/core/utils/thread_annotations.h"
+#include "itex/core/utils/types.h"
+
+namespace itex {
+namespace monitoring {
+
+// The bucket limits of a Sampler.
+class Buckets {
+ public:
+  // Buckets with limits scale, scale * growth_factor,
+  // scale * growth_factor^2, ... up to bucket_count limits, and a last bucket
+  // up to DBL_MAX.
+  //
+  // REQUIRES: scale > 0, growth_factor > 1 and bucket_count > 0.
+  static std::vector<double> Exponential(double scale, double growth_factor,
+                                         int bucket_count) {
+    ITEX_CHECK_GT(scale, 0);
+    ITEX_CHECK_GT(growth_factor, 1);
+    ITEX_CHECK_GT(bucket_count, 0);
+    std::vector<double> limits;
+    double limit = scale;
+    for (int i = 0; i < bucket_count; ++i) {
+      limits.push_back(limit);
+      limit *= growth_factor;
+    }
+    limits.push_back(DBL_MAX);
+    return limits;
+  }
+};
+
+// SamplerCell stores each value of a Sampler.
+//
+// A cell can be passed off to a module which may repeatedly update it without
+// needing further map-indexing computations. This improves both encapsulation
+// (separate modules can own a cell each, without needing to know about the map
+// to which both cells belong) and performance (since map indexing and
+// associated locking are both avoided).
+//
+// This class is thread-safe.
+class SamplerCell {
+ public:
+  explicit SamplerCell(const std::vector<double>& bucket_limits) {
+    histogram_.bucket_limit = bucket_limits;
+    histogram_.bucket.assign(bucket_limits.size(), 0);
+  }
+  ~SamplerCell() {}
+
+  // Atomically adds a sample.
+  void Add(double sample) TF_LOCKS_EXCLUDED(mu_);
+
+  // Returns the current histogram value.
+  Histogram value() const TF_LOCKS_EXCLUDED(mu_);
+
+ private:
+  Histogram histogram_ TF_GUARDED_BY(mu_);
+  mutable mutex mu_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(SamplerCell);
+};
+
+// A stateful class for updating a cumulative histogram metric.
+//
+// This class encapsulates a set of histograms (or a single histogram for a
+// label-less metric) configured with a list of increasing bucket boundaries.
+// Each histogram is identified by a tuple of labels. The class allows the
+// user to add a sample to each histogram value.
+//
+// Sampler allocates storage and maintains a cell for each value. You can
+// retrieve an individual cell using a label-tuple and update it separately.
+// This improves performance since operations related to retrieval, like
+// map-indexing and locking, are avoided.
+//
+// This class is thread-safe.
+template <int NumLabels>
+class Sampler {
+ public:
+  ~Sampler() {
+    // Deleted here, before the metric_def is destroyed.
+    registration_handle_.reset();
+  }
+
+  // Creates the metric based on the metric-definition arguments and buckets.
+  //
+  // Example;
+  // auto* sampler_with_label = Sampler<1>::New({"/itex/sampler",
+  //   "ITEX sampler", "MyLabelName"}, Buckets::Exponential(1, 2, 20));
+  static Sampler* New(const MetricDef<MetricKind::kCumulative, Histogram,
+                                      NumLabels>& metric_def,
+                      std::vector<double> bucket_limits);
+
+  // Retrieves the cell for the specified labels, creating it on demand if
+  // not already present.
+  template <typename... Labels>
+  SamplerCell* GetCell(const Labels&... labels) TF_LOCKS_EXCLUDED(mu_);
+
+  Status GetStatus() { return status_; }
+
+ private:
+  Sampler(const MetricDef<MetricKind::kCumulative, Histogram, NumLabels>&
+              metric_def,
+          std::vector<double> bucket_limits)
+      : metric_def_(metric_def),
+        bucket_limits_(std::move(bucket_limits)),
+        registration_handle_(CollectionRegistry::Default()->Register(
+            &metric_def_, [&](MetricCollectorGetter getter) {
+              auto metric_collector = getter.Get(&metric_def_);
+
+              mutex_lock l(&mu_);
+              for (const auto& cell : cells_) {
+                metric_collector.CollectValue(cell.first, cell.second.value());
+              }
+            })) {
+    if (registration_handle_) {
+      status_ = Status::OK();
+    } else {
+      status_ = Status(TF_ALREADY_EXISTS,
+                       "Another metric with the same name already exists.");
+    }
+  }
+
+  mutable mutex mu_;
+
+  Status status_;
+
+  // The metric definition. This will be used to identify the metric when we
+  // register it for collection.
+  const MetricDef<MetricKind::kCumulative, Histogram, NumLabels> metric_def_;
+
+  // Bucket limits of the histograms of all the cells.
+  const std::vector<double> bucket_limits_;
+
+  std::unique_ptr<CollectionRegistry::RegistrationHandle> registration_handle_;
+
+  using LabelArray = std::array<std::string, NumLabels>;
+  std::map<LabelArray, SamplerCell> cells_ TF_GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(Sampler);
+};
+
+////
+//  Implementation details follow. API readers may skip.
+////
+
+inline void SamplerCell::Add(const double sample) {
+  mutex_lock l(&mu_);
+  const auto bucket = std::lower_bound(histogram_.bucket_limit.begin(),
+                                       histogram_.bucket_limit.end(), sample);
+  const size_t index =
+      std::min<size_t>(bucket - histogram_.bucket_limit.begin(),
+                       histogram_.bucket.size() - 1);
+  histogram_.bucket[index] += 1;
+  if (histogram_.num == 0 || sample < histogram_.min) histogram_.min = sample;
+  if (histogram_.num == 0 || sample > histogram_.max) histogram_.max = sample;
+  histogram_.num += 1;
+  histogram_.sum += sample;
+  histogram_.sum_squares += sample * sample;
+}
+
+inline Histogram SamplerCell::value() const {
+  mutex_lock l(&mu_);
+  return histogram_;
+}
+
+template <int NumLabels>
+Sampler<NumLabels>* Sampler<NumLabels>::New(
+    const MetricDef<MetricKind::kCumulative, Histogram, NumLabels>& metric_def,
+    std::vector<double> bucket_limits) {
+  return new Sampler<NumLabels>(metric_def, std::move(bucket_limits));
+}
+
+template <int NumLabels>
+template <typename... Labels>
+SamplerCell* Sampler<NumLabels>::GetCell(const Labels&... labels)
+    TF_LOCKS_EXCLUDED(mu_) {
+  // Provides a more informative error message than the one during array
+  // construction below.
+  static_assert(sizeof...(Labels) == NumLabels,
+                "Mismatch between Sampler<NumLabels> and number of labels "
+                "provided in GetCell(...).");
+
+  const LabelArray& label_array = {{labels...}};
+  mutex_lock l(&mu_);
+  const auto found_it = cells_.find(label_array);
+  if (found_it != cells_.end()) {
+    return &(found_it->second);
+  }
+  return &(cells_
+               .emplace(std::piecewise_construct,
+                        std::forward_as_tuple(label_array),
+                        std::forward_as_tuple(bucket_limits_))
+               .first->second);
+}
+
+}  // namespace monitoring
+}  // namespace itex
+
+#endif  // ITEX_CORE_UTILS_SAMPLER_H_
@@ -24,6 +24,7 @@ limitations under the License.
 #include "absl/strings/ascii.h"
 #include "absl/strings/escaping.h"
 #include "absl/strings/match.h"
+#include "absl/strings/str_format.h"
 #include "absl/strings/strip.h"
 #include "itex/core/utils/logging.h"
 #include "itex/core/utils/stringpiece.h"
@@ -33,6 +34,33 @@ namespace str_util {
 
 string CEscape(StringPiece src) { return absl::CEscape(src); }
 
+string JsonString(StringPiece src) {
+  string result = "\"";
+  for (char c : src) {
+    switch (c) {
+      case '"':
+        result += "\\\"";
+        break;
+      case '\\':
+        result += "\\\\";
+        break;
+      case '\n':
+        result += "\\n";
+        break;
+      case '\t':
+        result += "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          absl::StrAppendFormat(&result, "\\u%04x", static_cast<int>(c));
+        } else {
+          result += c;
+        }
+    }
+  }
+  return result + "\"";
+}
+
 bool CUnescape(StringPiece source, string* dest, string* error) {
   return absl::CUnescape(source, dest, error);
 }
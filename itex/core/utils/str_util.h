@@ -37,6 +37,10 @@ using std::string;
 // escaped using C-style escape sequences.
 std::string CEscape(StringPiece src);
 
+// Returns 'src' as a quoted JSON string, escaping quotes, backslashes and
+// control characters.
+std::string JsonString(StringPiece src);
+
 // Copies "source" to "dest", rewriting C-style escape sequences --
 // '\n', '\r', '\\', '\ooo', etc -- to their ASCII equivalents.
 //
@@ -18,6 +18,10 @@ limitations under the License.
 #include "itex/core/utils/threadpool.h"
 
 // #define EIGEN_USE_THREADS
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT(build/c++11)
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -25,10 +29,12 @@ limitations under the License.
 #include "absl/types/optional.h"
 #include "itex/core/utils/blocking_counter.h"
 #include "itex/core/utils/context.h"
+#include "itex/core/utils/cpu_info.h"
 #include "itex/core/utils/denormal.h"
 #include "itex/core/utils/logging.h"
 #include "itex/core/utils/mutex.h"
 #include "itex/core/utils/numa.h"
+#include "itex/core/utils/numa_threadpool.h"
 #include "itex/core/utils/setround.h"
 #include "itex/core/utils/tracing.h"
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
@@ -64,6 +70,10 @@ struct EigenEnvironment {
       if (thread_options_.numa_node != port::kNUMANoAffinity) {
         port::NUMASetThreadNodeAffinity(thread_options_.numa_node);
       }
+      if (!thread_options_.cpus.empty() &&
+          !port::SetThreadCPUAffinity(thread_options_.cpus)) {
+        ITEX_LOG(WARNING) << "Could not pin thread of pool " << name_;
+      }
       f();
     });
   }
@@ -91,6 +101,64 @@ struct EigenEnvironment {
   }
 };
 
+namespace {
+
+// Shards cheaper than this many cycles cost more to schedule than to run.
+// This is the task size of Eigen's TensorCostModel.
+constexpr int64_t kMinShardCost = 40000;
+// Shards per thread of a node, so that threads that finish early take over
+// the shards of slower ones.
+constexpr int64_t kShardsPerThread = 4;
+// How long a thread of the pool waits for the threads of another node to take
+// a ParallelForOnNode before it takes the blocks that are left itself.
+constexpr std::chrono::milliseconds kCrossNodeWait(1);
+
+// The part of a ParallelFor that runs on one NUMA node. Every thread that
+// calls RunBlocks claims the next block until none is left. It is shared with
+// the scheduled closures, which may only start after the loop is done.
+struct NodeBlocks {
+  NodeBlocks(int64_t first, int64_t last, int64_t block_size,
+             const std::function<void(int64_t, int64_t)>* fn,
+             BlockingCounter* done)
+      : next(first), last(last), block_size(block_size), fn(fn), done(done) {}
+
+  int64_t NumBlocks() const {
+    return (last - next + block_size - 1) / block_size;
+  }
+
+  void RunBlocks() {
+    while (true) {
+      const int64_t first = next.fetch_add(block_size);
+      if (first >= last) return;
+      (*fn)(first, std::min(first + block_size, last));
+      done->DecrementCount();
+    }
+  }
+
+  std::atomic<int64_t> next;
+  const int64_t last;
+  const int64_t block_size;
+  // Only used once a block is claimed, while the loop is waiting for it.
+  const std::function<void(int64_t, int64_t)>* const fn;
+  BlockingCounter* const done;
+};
+
+// Returns the block size that splits [first, last) into shards of roughly
+// equal cost for "num_threads" threads, 0 if the range is empty.
+int64_t BlockSize(int64_t first, int64_t last, int64_t cost_per_unit,
+                  int num_threads) {
+  const int64_t size = last - first;
+  if (size <= 0) return 0;
+  const double cost =
+      static_cast<double>(size) * std::max<int64_t>(cost_per_unit, 1);
+  const int64_t max_shards = num_threads * kShardsPerThread;
+  const int64_t num_shards = std::max<int64_t>(
+      1, std::min<double>(max_shards, cost / kMinShardCost));
+  return (size + num_shards - 1) / num_shards;
+}
+
+}  // namespace
+
 ThreadPool::ThreadPool(Env* env, const string& name, int num_threads)
     : ThreadPool(env, ThreadOptions(), name, num_threads, true, nullptr) {}
 
@@ -110,6 +178,26 @@ ThreadPool::ThreadPool(Env* env, const ThreadOptions& thread_options,
                                                        num_threads, allocator));
 }
 
+ThreadPool::ThreadPool(Env* env, const ThreadOptions& thread_options,
+                       const string& name,
+                       const std::vector<int>& threads_per_node,
+                       Eigen::Allocator* allocator) {
+  numa_threadpool_.reset(new NUMAThreadPool(env, thread_options, "tf_" + name,
+                                            threads_per_node));
+  underlying_threadpool_ = numa_threadpool_.get();
+  threadpool_device_.reset(new Eigen::ThreadPoolDevice(
+      underlying_threadpool_, underlying_threadpool_->NumThreads(), allocator));
+}
+
+/* static */ std::vector<int> ThreadPool::ThreadsPerNUMANode(int num_threads) {
+  const int num_nodes = port::NUMAEnabled() ? port::NUMANumNodes() : 1;
+  std::vector<int> threads_per_node(num_nodes, num_threads / num_nodes);
+  for (int node = 0; node < num_threads % num_nodes; ++node) {
+    ++threads_per_node[node];
+  }
+  return threads_per_node;
+}
+
 ThreadPool::ThreadPool(thread::ThreadPoolInterface* user_threadpool) {
   underlying_threadpool_ = user_threadpool;
   threadpool_device_.reset(new Eigen::ThreadPoolDevice(
@@ -209,6 +297,10 @@ void ThreadPool::ParallelFor(int64_t total, int64_t cost_per_unit,
                              const std::function<void(int64_t, int64_t)>& fn) {
   ITEX_CHECK_GE(total, 0);
   ITEX_CHECK_EQ(total, (int64_t)(Eigen::Index)total);
+  if (numa_threadpool_ != nullptr) {
+    ParallelForOnNUMANodes(total, cost_per_unit, fn);
+    return;
+  }
   threadpool_device_->parallelFor(
       total, Eigen::TensorOpCost(0, 0, cost_per_unit),
       [&fn](Eigen::Index first, Eigen::Index last) { fn(first, last); });
@@ -219,6 +311,14 @@ void ThreadPool::ParallelForWithWorkerId(
     const std::function<void(int64_t, int64_t, int)>& fn) {
   ITEX_CHECK_GE(total, 0);
   ITEX_CHECK_EQ(total, (int64_t)(Eigen::Index)total);
+  if (numa_threadpool_ != nullptr) {
+    ParallelFor(total, cost_per_unit,
+                [this, &fn](int64_t start, int64_t limit) {
+                  int id = CurrentThreadId() + 1;
+                  fn(start, limit, id);
+                });
+    return;
+  }
 
   threadpool_device_->parallelFor(total,
                                   Eigen::TensorOpCost(0, 0, cost_per_unit),
@@ -246,14 +346,123 @@ void ThreadPool::ParallelForWithWorkerId(
               });
 }
 
+void ThreadPool::ParallelForOnNode(
+    int node, int64_t total, int64_t cost_per_unit,
+    const std::function<void(int64_t, int64_t)>& fn) {
+  ITEX_CHECK_GE(total, 0);
+  const int num_node_threads = NumThreadsOnNode(node);
+  ITEX_CHECK_GT(num_node_threads, 0) << "No threads on NUMA node " << node;
+  const int64_t block_size =
+      BlockSize(0, total, cost_per_unit, num_node_threads);
+  if (block_size == 0) return;
+  // A thread of the node takes part in the loop instead of only waiting for
+  // it, so that a node with a single thread cannot wait on itself.
+  const bool run_here = CurrentNUMANode() == node;
+  if (block_size == total && run_here) {
+    fn(0, total);
+    return;
+  }
+
+  BlockingCounter counter((total + block_size - 1) / block_size);
+  auto blocks =
+      std::make_shared<NodeBlocks>(0, total, block_size, &fn, &counter);
+  const int num_helpers = std::min<int64_t>(
+      blocks->NumBlocks() - (run_here ? 1 : 0), num_node_threads);
+  for (int i = 0; i < num_helpers; ++i) {
+    numa_threadpool_->ScheduleOnNode(
+        node, [blocks]() { blocks->RunBlocks(); }, /*pinned=*/true);
+  }
+  if (run_here) {
+    blocks->RunBlocks();
+  } else if (CurrentNUMANode() != port::kNUMANoAffinity &&
+             !counter.WaitFor(kCrossNodeWait)) {
+    // The threads of "node" may all be waiting on loops of the calling
+    // thread's node, so the blocks they have not claimed run here.
+    blocks->RunBlocks();
+  }
+  counter.Wait();
+}
+
+void ThreadPool::ParallelForOnNUMANodes(
+    int64_t total, int64_t cost_per_unit,
+    const std::function<void(int64_t, int64_t)>& fn) {
+  if (total == 0) return;
+  if (static_cast<double>(total) * cost_per_unit < kMinShardCost) {
+    fn(0, total);
+    return;
+  }
+
+  // The split only depends on total, so repeated loops over the same range
+  // run each unit of work on the same node.
+  const int num_threads = NumThreads();
+  auto split = [total, num_threads](int thread) {
+    return total / num_threads * thread +
+           total % num_threads * thread / num_threads;
+  };
+  const int num_nodes = numa_threadpool_->NumNodes();
+  std::vector<int64_t> firsts(num_nodes), lasts(num_nodes),
+      block_sizes(num_nodes);
+  int64_t num_blocks = 0;
+  for (int node = 0; node < num_nodes; ++node) {
+    const int first_thread = numa_threadpool_->FirstThreadOnNode(node);
+    firsts[node] = split(first_thread);
+    lasts[node] = split(first_thread + NumThreadsOnNode(node));
+    block_sizes[node] = BlockSize(firsts[node], lasts[node], cost_per_unit,
+                                  NumThreadsOnNode(node));
+    if (block_sizes[node] == 0) continue;
+    const int64_t size = lasts[node] - firsts[node];
+    num_blocks += (size + block_sizes[node] - 1) / block_sizes[node];
+  }
+
+  BlockingCounter counter(num_blocks);
+  std::vector<std::shared_ptr<NodeBlocks>> node_blocks(num_nodes);
+  const int current_node = CurrentNUMANode();
+  for (int node = 0; node < num_nodes; ++node) {
+    if (block_sizes[node] == 0) continue;
+    node_blocks[node] = std::make_shared<NodeBlocks>(
+        firsts[node], lasts[node], block_sizes[node], &fn, &counter);
+    std::shared_ptr<NodeBlocks> blocks = node_blocks[node];
+    const int num_helpers =
+        std::min<int64_t>(blocks->NumBlocks() - (node == current_node ? 1 : 0),
+                          NumThreadsOnNode(node));
+    for (int i = 0; i < num_helpers; ++i) {
+      numa_threadpool_->ScheduleOnNode(node,
+                                       [blocks]() { blocks->RunBlocks(); });
+    }
+  }
+  // A thread of the pool helps with the blocks of its own node first. Then it
+  // takes the blocks of the other nodes that are still left, rather than
+  // wait on threads that may be waiting on it in turn.
+  if (current_node != port::kNUMANoAffinity) {
+    for (int i = 0; i < num_nodes; ++i) {
+      const auto& blocks = node_blocks[(current_node + i) % num_nodes];
+      if (blocks != nullptr) blocks->RunBlocks();
+    }
+  }
+  counter.Wait();
+}
+
 int ThreadPool::NumThreads() const {
   return underlying_threadpool_->NumThreads();
 }
 
+int ThreadPool::NumThreadsOnNode(int node) const {
+  if (numa_threadpool_ == nullptr || node < 0 ||
+      node >= numa_threadpool_->NumNodes()) {
+    return 0;
+  }
+  return numa_threadpool_->NumThreadsOnNode(node);
+}
+
 int ThreadPool::CurrentThreadId() const {
   return underlying_threadpool_->CurrentThreadId();
 }
 
+int ThreadPool::CurrentNUMANode() const {
+  if (numa_threadpool_ == nullptr) return port::kNUMANoAffinity;
+  return numa_threadpool_->CurrentNode();
+}
+
 void ThreadPool::ScheduleWithHint(std::function<void()> fn, int start,
                                   int limit) {
   underlying_threadpool_->ScheduleWithHint(std::move(fn), start, limit);
@@ -43,6 +43,7 @@ namespace itex {
 namespace thread {
 
 struct EigenEnvironment;
+class NUMAThreadPool;
 
 class ThreadPool {
  public:
@@ -130,6 +131,22 @@ class ThreadPool {
   ThreadPool(Env* env, const ThreadOptions& thread_options,
              const std::string& name, int num_threads);
 
+  // Constructs a pool with threads_per_node[i] threads pinned to NUMA node i,
+  // see ThreadsPerNUMANode and NUMAThreadPool. Closures stay on the node they
+  // are scheduled on unless all of its threads are busy. ParallelFor gives
+  // every node a contiguous part of the range in proportion to its threads,
+  // so that repeated loops over the same data run each unit of work on the
+  // same node.
+  //
+  // REQUIRES: threads_per_node has at least one non-zero entry.
+  ThreadPool(Env* env, const ThreadOptions& thread_options,
+             const std::string& name, const std::vector<int>& threads_per_node,
+             Eigen::Allocator* allocator = nullptr);
+
+  // Spreads "num_threads" threads evenly over the NUMA nodes of the machine.
+  // Returns {num_threads} if NUMA is not enabled.
+  static std::vector<int> ThreadsPerNUMANode(int num_threads);
+
   // Constructs a pool that wraps around the thread::ThreadPoolInterface
   // instance provided by the caller. Caller retains ownership of
   // `user_threadpool` and must ensure its lifetime is longer than the
@@ -209,9 +226,26 @@ class ThreadPool {
       int64_t total, const SchedulingParams& scheduling_params,
       const std::function<void(int64_t, int64_t, int)>& fn);
 
+  // Runs ParallelFor on the threads pinned to NUMA "node" only, e.g. for
+  // work on memory from NUMAMalloc(node, ...). A thread of another node of the
+  // pool that calls it takes the blocks left after a short wait, since the
+  // threads of "node" may be waiting on its own node in nested loops.
+  //
+  // REQUIRES: the pool was constructed with threads on "node".
+  void ParallelForOnNode(int node, int64_t total, int64_t cost_per_unit,
+                         const std::function<void(int64_t, int64_t)>& fn);
+
   // Returns the number of threads in the pool.
   int NumThreads() const;
 
+  // Returns the number of threads pinned to NUMA "node", 0 if the pool was not
+  // constructed with threads_per_node.
+  int NumThreadsOnNode(int node) const;
+
+  // Returns the NUMA node of the current thread if it is a thread of a pool
+  // constructed with threads_per_node, port::kNUMANoAffinity otherwise.
+  int CurrentNUMANode() const;
+
   // Returns current thread id between 0 and NumThreads() - 1, if called from a
   // thread in the pool. Returns -1 otherwise.
   int CurrentThreadId() const;
@@ -233,8 +267,17 @@ class ThreadPool {
       const int64_t total, const int64_t block_size,
       const std::function<void(int64_t, int64_t)>& fn);
 
+  // Splits [0, total) over the NUMA nodes in proportion to their threads and
+  // runs each part on its node.
+  void ParallelForOnNUMANodes(int64_t total, int64_t cost_per_unit,
+                              const std::function<void(int64_t, int64_t)>& fn);
+
+  // numa_threadpool_ is instantiated and owned by thread::ThreadPool if it is
+  // constructed with threads_per_node.
+  std::unique_ptr<NUMAThreadPool> numa_threadpool_;
   // underlying_threadpool_ is the user_threadpool if user_threadpool is
-  // provided in the constructor. Otherwise it is the eigen_threadpool_.
+  // provided in the constructor, the numa_threadpool_ if threads_per_node is.
+  // Otherwise it is the eigen_threadpool_.
   Eigen::ThreadPoolInterface* underlying_threadpool_;
   // eigen_threadpool_ is instantiated and owned by thread::ThreadPool if
   // user_threadpool is not in the constructor.
@@ -20,6 +20,22 @@ from intel_extension_for_tensorflow.python.config import set_config  # pylint: d
 from intel_extension_for_tensorflow.python.config import get_config  # pylint: disable=unused-import
 from intel_extension_for_tensorflow.python.device import set_backend  # pylint: disable=unused-import
 from intel_extension_for_tensorflow.python.device import get_backend  # pylint: disable=unused-import
+from intel_extension_for_tensorflow.python.execution_domain import create_execution_domains  # pylint: disable=unused-import
+from intel_extension_for_tensorflow.python.execution_domain import get_execution_domains  # pylint: disable=unused-import
+from intel_extension_for_tensorflow.python.execution_domain import current_execution_domain  # pylint: disable=unused-import
+from intel_extension_for_tensorflow.python.execution_domain import execution_domain  # pylint: disable=unused-import
+from intel_extension_for_tensorflow.python.kernel_metrics import get_kernel_metrics  # pylint: disable=unused-import
+from intel_extension_for_tensorflow.python.kernel_metrics import get_kernel_metrics_text  # pylint: disable=unused-import
+from intel_extension_for_tensorflow.python.roofline import measure_machine_peaks  # pylint: disable=unused-import
+from intel_extension_for_tensorflow.python.roofline import get_roofline_summary  # pylint: disable=unused-import
+from intel_extension_for_tensorflow.python.roofline import format_roofline_summary  # pylint: disable=unused-import
+from intel_extension_for_tensorflow.python.memory_profile import is_memory_profile_enabled  # pylint: disable=unused-import
+from intel_extension_for_tensorflow.python.memory_profile import get_memory_report  # pylint: disable=unused-import
+from intel_extension_for_tensorflow.python.memory_profile import reset_memory_profile  # pylint: disable=unused-import
+from intel_extension_for_tensorflow.python.memory_profile import format_memory_report  # pylint: disable=unused-import
+from intel_extension_for_tensorflow.python.flight_recorder import is_flight_recorder_enabled  # pylint: disable=unused-import
+from intel_extension_for_tensorflow.python.flight_recorder import get_flight_recorder_trace  # pylint: disable=unused-import
+from intel_extension_for_tensorflow.python.flight_recorder import dump_flight_recorder  # pylint: disable=unused-import
 from intel_extension_for_tensorflow.python import ops  # pylint: disable=unused-import,line-too-long
 from intel_extension_for_tensorflow.python.version import __version__  # pylint: disable=unused-import
 from intel_extension_for_tensorflow.python import version  # pylint: disable=unused-import
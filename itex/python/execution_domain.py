@@ -0,0 +1,60 @@
+# Copyright (c) 2023 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+
+"""execution domain"""
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+
+import collections
+import contextlib
+
+from intel_extension_for_tensorflow.python._pywrap_itex import *
+
+ExecutionDomainInfo = collections.namedtuple(
+    "ExecutionDomainInfo", ["id", "cpus", "numa_node"])
+
+
+def create_execution_domains(num_domains, cores_per_domain=0):
+  """Splits the physical cores into `num_domains` execution domains.
+
+  Every domain gets `cores_per_domain` cores, or an equal share of the cores
+  if it is 0, and a thread pool pinned to them. Can only be called once.
+  """
+  ITEX_CreateExecutionDomains(num_domains, cores_per_domain)
+  return get_execution_domains()
+
+
+def get_execution_domains():
+  return [ExecutionDomainInfo(*domain) for domain in ITEX_GetExecutionDomains()]
+
+
+def current_execution_domain():
+  """Returns the id of the domain of the calling thread, -1 if it has none."""
+  return ITEX_CurrentExecutionDomain()
+
+
+@contextlib.contextmanager
+def execution_domain(domain_id):
+  """Runs the calling thread in domain `domain_id` and pins it to its cores.
+
+  Eager ops run in the domain. A tf.function or Session graph is bound to the
+  domain that is current when it is traced or first run.
+  """
+  ITEX_EnterExecutionDomain(domain_id)
+  try:
+    yield
+  finally:
+    ITEX_ExitExecutionDomain()
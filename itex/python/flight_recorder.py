@@ -0,0 +1,47 @@
+# Copyright (c) 2023 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+
+"""flight recorder"""
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+
+import json
+
+from intel_extension_for_tensorflow.python._pywrap_itex import *
+
+
+def is_flight_recorder_enabled():
+  """Returns whether the flight recorder is on, see ITEX_FLIGHT_RECORDER."""
+  return ITEX_IsFlightRecorderEnabled()
+
+
+def get_flight_recorder_trace():
+  """Returns the recent kernel runs of every thread as a Chrome trace dict.
+
+  Each run is a complete event ("ph": "X") named after the node, with the op
+  type as its category and the step id in its args. Times are microseconds
+  since otherData.base_unix_nsecs.
+  """
+  return json.loads(ITEX_GetFlightRecorderTrace().decode("utf-8"))
+
+
+def dump_flight_recorder(path=None):
+  """Writes the Chrome trace of the flight recorder to path.
+
+  Without a path, the trace goes to a new file in ITEX_FLIGHT_RECORDER_DIR.
+  Returns the path of the file.
+  """
+  return ITEX_DumpFlightRecorder(path or "")
@@ -14,10 +14,16 @@ limitations under the License.
 ==============================================================================*/
 
 #include <iostream>
+#include <stdexcept>
 
 #include "Python.h"
 #include "itex/core/devices/device_backend_util.h"
 #include "itex/core/graph/config_util.h"
+#include "itex/core/utils/cpu_info.h"
+#include "itex/core/utils/execution_domain.h"
+#include "itex/core/utils/flight_recorder.h"
+#include "itex/core/utils/kernel_metrics.h"
+#include "itex/core/utils/memory_profiler.h"
 #include "pybind11/pybind11.h"
 
 namespace py = pybind11;
@@ -39,6 +45,22 @@ static py::bytes ITEX_GetConfig() {
   return py::bytes(config_str);
 }
 
+static void ITEX_ThrowIfError(const Status& status) {
+  if (!status.ok()) throw std::runtime_error(status.error_message());
+}
+
+// Returns (id, cpus, numa_node) of every execution domain.
+static py::list ITEX_GetExecutionDomains() {
+  py::list domains;
+  for (int id = 0; id < ExecutionDomain::NumDomains(); ++id) {
+    const ExecutionDomain* domain = ExecutionDomain::Get(id);
+    py::list cpus;
+    for (int cpu : domain->cpus()) cpus.append(cpu);
+    domains.append(py::make_tuple(id, cpus, domain->numa_node()));
+  }
+  return domains;
+}
+
 PYBIND11_MODULE(_pywrap_itex, m) {
   m.doc() = "pybind11 front-end api for Intel ® Extension for TensorFlow*";
   m.def("ITEX_SetBackend",
@@ -57,6 +79,49 @@ PYBIND11_MODULE(_pywrap_itex, m) {
     itex_set_config(config);
   });
   m.def("ITEX_GetConfig", &itex::ITEX_GetConfig);
+
+  m.def("ITEX_CreateExecutionDomains",
+        [](int num_domains, int cores_per_domain) {
+          ITEX_ThrowIfError(
+              ExecutionDomain::Create(num_domains, cores_per_domain));
+        });
+  m.def("ITEX_GetExecutionDomains", &itex::ITEX_GetExecutionDomains);
+  m.def("ITEX_EnterExecutionDomain",
+        [](int id) { ITEX_ThrowIfError(ExecutionDomain::Enter(id)); });
+  m.def("ITEX_ExitExecutionDomain",
+        []() { ITEX_ThrowIfError(ExecutionDomain::Exit()); });
+  m.def("ITEX_CurrentExecutionDomain", []() {
+    const ExecutionDomain* domain = ExecutionDomain::Current();
+    return domain == nullptr ? -1 : domain->id();
+  });
+  m.def("ITEX_GetKernelMetrics",
+        []() { return py::bytes(metrics::MetricsText()); });
+  m.def("ITEX_GetCpuInfo", []() {
+    py::dict info;
+    info["vendor"] = port::CPUVendorIDString();
+    info["num_cpus"] = port::NumSchedulableCPUs();
+    info["hyperthreads_per_core"] = port::NumHyperthreadsPerCore();
+    info["avx2"] = port::TestCPUFeature(port::CPUFeature::AVX2);
+    info["fma"] = port::TestCPUFeature(port::CPUFeature::FMA);
+    info["avx512f"] = port::TestCPUFeature(port::CPUFeature::AVX512F);
+    info["avx512_vnni"] = port::TestCPUFeature(port::CPUFeature::AVX512_VNNI);
+    info["avx512_bf16"] = port::TestCPUFeature(port::CPUFeature::AVX512_BF16);
+    info["amx_bf16"] = port::TestCPUFeature(port::CPUFeature::AMX_BF16);
+    info["amx_int8"] = port::TestCPUFeature(port::CPUFeature::AMX_INT8);
+    return info;
+  });
+  m.def("ITEX_IsMemoryProfileEnabled", &itex::IsMemoryProfileEnabled);
+  m.def("ITEX_GetMemoryProfile",
+        [](int top_n) { return py::bytes(MemoryProfileJson(top_n)); });
+  m.def("ITEX_ResetMemoryProfile", &itex::ResetMemoryProfile);
+  m.def("ITEX_IsFlightRecorderEnabled", &flight_recorder::IsEnabled);
+  m.def("ITEX_GetFlightRecorderTrace",
+        []() { return py::bytes(flight_recorder::ChromeTrace()); });
+  m.def("ITEX_DumpFlightRecorder", [](const std::string& path) {
+    std::string written_path;
+    ITEX_ThrowIfError(flight_recorder::Dump(path, &written_path));
+    return written_path;
+  });
 }
 
 }  // namespace itex
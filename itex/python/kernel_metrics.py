@@ -0,0 +1,41 @@
+# Copyright (c) 2023 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+
+"""kernel metrics"""
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+
+from intel_extension_for_tensorflow.python._pywrap_itex import *
+
+
+def get_kernel_metrics_text():
+  """Returns the ITEX metrics in the Prometheus text format."""
+  return ITEX_GetKernelMetrics().decode("utf-8")
+
+
+def get_kernel_metrics():
+  """Returns the ITEX metrics as a dict of sample to value.
+
+  Samples are named as in the Prometheus text format, e.g.
+  'itex_kernels_primitive_creations{op_type="_OneDnnMatMul"}'.
+  """
+  result = {}
+  for line in get_kernel_metrics_text().splitlines():
+    if not line or line.startswith("#"):
+      continue
+    sample, value = line.rsplit(" ", 1)
+    result[sample] = float(value)
+  return result
@@ -0,0 +1,88 @@
+# Copyright (c) 2023 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+
+"""memory profile"""
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+
+import json
+
+from intel_extension_for_tensorflow.python._pywrap_itex import *
+
+_KINDS = ("output", "temp", "persistent", "cache")
+
+
+def is_memory_profile_enabled():
+  """Returns whether ITEX_MEMORY_PROFILE is set and supported by the build."""
+  return ITEX_IsMemoryProfileEnabled()
+
+
+def get_memory_report(top_n=20):
+  """Returns the report of the memory profiler as a dict.
+
+  Needs ITEX_MEMORY_PROFILE=1 on CPU, the report is empty otherwise.
+
+  The report has the live and peak bytes of the kernel allocations, with the
+  step and the node which reached the peak, and:
+    top_at_peak: the top_n nodes with the most live bytes at the peak, split
+      by kind: outputs, temps, persistent tensors and weight caches.
+    top_nodes: the top_n nodes by their own peak of live bytes, with their
+      allocations and the outputs TensorFlow allocated for them, whose release
+      is not tracked.
+    steps: the peak live bytes of the recent steps, in order.
+    timeline: samples of the live bytes, taken at most every
+      ITEX_MEMORY_PROFILE_SAMPLE_USECS, with the usecs since the profiler
+      started or was reset and the nodes with the most live bytes.
+  """
+  return json.loads(ITEX_GetMemoryProfile(top_n).decode("utf-8"))
+
+
+def reset_memory_profile():
+  """Restarts the peaks and the counters from the bytes that are live now."""
+  ITEX_ResetMemoryProfile()
+
+
+def _mib(value):
+  return value / float(1 << 20)
+
+
+def format_memory_report(report):
+  """Formats a report of get_memory_report() as a table."""
+  if not report:
+    return "ITEX_MEMORY_PROFILE is not enabled"
+  lines = [
+      "peak %.1f MiB at step %d in %s, %.1f MiB live now" %
+      (_mib(report["peak_bytes"]), report["peak_step"],
+       report["peak_node"] or "-", _mib(report["live_bytes"])),
+      "%-48s %-28s %9s %7s %9s %9s %9s %9s" %
+      ("node at the peak", "op", "MiB", "share%", "output", "temp",
+       "persist", "cache"),
+  ]
+  peak = max(report["peak_bytes"], 1)
+  for entry in report["top_at_peak"]:
+    lines.append("%-48s %-28s %9.1f %7.1f %9.1f %9.1f %9.1f %9.1f" %
+                 ((entry["node"] or "-", entry["op"] or "-",
+                   _mib(entry["bytes"]), entry["bytes"] * 100.0 / peak) +
+                  tuple(_mib(entry[kind]) for kind in _KINDS)))
+  lines.append("%-48s %-28s %9s %9s %9s %12s" %
+               ("node", "op", "peak MiB", "live MiB", "allocs",
+                "untracked MiB"))
+  for entry in report["top_nodes"]:
+    lines.append("%-48s %-28s %9.1f %9.1f %9d %12.1f" %
+                 (entry["node"] or "-", entry["op"] or "-",
+                  _mib(entry["peak_bytes"]), _mib(entry["live_bytes"]),
+                  entry["allocations"], _mib(entry["untracked_bytes"])))
+  return "\n".join(lines)
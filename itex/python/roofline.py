@@ -0,0 +1,151 @@
+# Copyright (c) 2023 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+
+"""roofline"""
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+
+import collections
+import re
+import time
+
+import tensorflow as tf
+
+from intel_extension_for_tensorflow.python._pywrap_itex import *
+from intel_extension_for_tensorflow.python.kernel_metrics import get_kernel_metrics
+
+MachinePeaks = collections.namedtuple("MachinePeaks",
+                                      ["gflops", "gbytes_per_sec"])
+
+_OP_COST_SAMPLE = re.compile(
+    r'^itex_kernels_op_(runs|nsecs|flops|bytes)\{op_type="([^"]*)"\}$')
+
+
+def get_cpu_info():
+  """Returns the vendor, the number of CPUs and the ISA features of the CPU."""
+  return dict(ITEX_GetCpuInfo())
+
+
+def _best_secs(fn, repeats):
+  fn()  # Warm-up, builds the primitives.
+  best = float("inf")
+  for _ in range(repeats):
+    start = time.perf_counter()
+    fn()
+    best = min(best, time.perf_counter() - start)
+  return best
+
+
+def measure_machine_peaks(gemm_size=4096, stream_elements=64 * 1024 * 1024,
+                          repeats=5):
+  """Measures the attainable compute and memory bandwidth of the CPU.
+
+  The compute peak is the best float32 GEMM throughput of tf.matmul on two
+  square matrices of gemm_size. The bandwidth peak is the best throughput of
+  the STREAM scale kernel, b = 3 * a, on float32 arrays of stream_elements,
+  which should be much larger than the last level cache.
+
+  Returns a MachinePeaks of GFLOP/s and GB/s.
+  """
+  with tf.device("/CPU:0"):
+    lhs = tf.random.uniform([gemm_size, gemm_size])
+    rhs = tf.random.uniform([gemm_size, gemm_size])
+    array = tf.random.uniform([stream_elements])
+    gemm_secs = _best_secs(tf.function(lambda: tf.matmul(lhs, rhs)), repeats)
+    scale_secs = _best_secs(tf.function(lambda: array * 3.0), repeats)
+  return MachinePeaks(
+      gflops=2.0 * gemm_size**3 / gemm_secs / 1e9,
+      gbytes_per_sec=2.0 * array.dtype.size * stream_elements / scale_secs /
+      1e9)
+
+
+def get_roofline_summary(peaks, before=None):
+  """Ranks the op types by the time they lose against the roofline.
+
+  Needs ITEX_OP_COST=1, which records the analytical FLOPs and bytes and the
+  host time of every kernel run in the kernel metrics.
+
+  Args:
+    peaks: MachinePeaks of the machine, e.g. from measure_machine_peaks().
+    before: Optional snapshot of get_kernel_metrics() to only summarize the
+      runs after it.
+
+  Returns:
+    A list of dicts, one per op type, sorted by lost_secs. The attainable
+    throughput of an op is the roofline min(peak GFLOP/s, intensity * peak
+    GB/s), or the peak GB/s for ops without FLOPs. Its efficiency is the
+    achieved over the attainable throughput and lost_secs the time it would
+    save at the roofline.
+  """
+  before = before or {}
+  totals = collections.defaultdict(lambda: collections.defaultdict(float))
+  for sample, value in get_kernel_metrics().items():
+    match = _OP_COST_SAMPLE.match(sample)
+    if match:
+      totals[match.group(2)][match.group(1)] += value - before.get(sample, 0.0)
+
+  total_secs = sum(t["nsecs"] for t in totals.values()) / 1e9
+  summary = []
+  for op_type, t in totals.items():
+    secs = t["nsecs"] / 1e9
+    if t["runs"] <= 0 or secs <= 0:
+      continue
+    gflops = t["flops"] / secs / 1e9
+    gbytes_per_sec = t["bytes"] / secs / 1e9
+    intensity = t["flops"] / t["bytes"] if t["bytes"] > 0 else 0.0
+    if t["flops"] > 0:
+      memory_roof = intensity * peaks.gbytes_per_sec
+      bound = "compute" if memory_roof >= peaks.gflops else "memory"
+      efficiency = gflops / min(peaks.gflops, memory_roof)
+    else:
+      bound = "memory"
+      efficiency = gbytes_per_sec / peaks.gbytes_per_sec
+    summary.append({
+        "op_type": op_type,
+        "runs": int(t["runs"]),
+        "secs": secs,
+        "time_share": secs / total_secs,
+        "gflops": gflops,
+        "gbytes_per_sec": gbytes_per_sec,
+        "intensity": intensity,
+        "bound": bound,
+        "efficiency": efficiency,
+        "lost_secs": secs * max(0.0, 1.0 - efficiency),
+    })
+  summary.sort(key=lambda entry: entry["lost_secs"], reverse=True)
+  return summary
+
+
+def format_roofline_summary(summary, peaks, top=20):
+  """Formats the first top entries of get_roofline_summary() as a table."""
+  cpu = get_cpu_info()
+  isa = [name for name in ("avx2", "avx512f", "avx512_bf16", "amx_bf16")
+         if cpu.get(name)]
+  lines = [
+      "%s, %d CPUs, %s: peak %.1f GFLOP/s, %.1f GB/s" %
+      (cpu["vendor"], cpu["num_cpus"], "/".join(isa) or "no AVX2",
+       peaks.gflops, peaks.gbytes_per_sec),
+      "%-36s %8s %9s %6s %10s %9s %9s %8s %6s %9s" %
+      ("op type", "runs", "ms", "time%", "GFLOP/s", "GB/s", "FLOP/B",
+       "bound", "eff%", "lost ms"),
+  ]
+  for entry in summary[:top]:
+    lines.append("%-36s %8d %9.2f %6.1f %10.1f %9.1f %9.2f %8s %6.1f %9.2f" %
+                 (entry["op_type"], entry["runs"], entry["secs"] * 1e3,
+                  entry["time_share"] * 100, entry["gflops"],
+                  entry["gbytes_per_sec"], entry["intensity"], entry["bound"],
+                  entry["efficiency"] * 100, entry["lost_secs"] * 1e3))
+  return "\n".join(lines)
@@ -0,0 +1,274 @@
+# Copyright (c) 2023 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+
+"""Benchmarks the ITEX graph optimizer on large synthetic graphs.
+
+Builds ResNet, BERT and DLRM scale graphs in-process, runs Grappler with the
+ITEX plugin optimizer over each of them and reports the time of every ITEX
+pass, the graph size before and after it, the shape inference time and the
+fusions applied, all taken from the ITEX graph metrics.
+
+Usage: python graph_optimizer_benchmark.py [--graphs=resnet50,bert_large]
+                                           [--iterations=3]
+                                           [--output=results.json]
+"""
+
+import argparse
+import collections
+import json
+import re
+import time
+
+import tensorflow as tf
+import intel_extension_for_tensorflow as itex
+from tensorflow.core.protobuf import config_pb2
+from tensorflow.python.grappler import tf_optimizer
+
+v1 = tf.compat.v1
+
+
+def _weight(name, shape):
+    return v1.get_variable(name, shape,
+                           initializer=v1.glorot_uniform_initializer())
+
+
+def _conv_bn_relu(x, name, filters, kernel, stride=1, relu=True):
+    with v1.variable_scope(name):
+        w = _weight("w", [kernel, kernel, x.shape[-1], filters])
+        x = tf.nn.conv2d(x, w, strides=stride, padding="SAME")
+        x, _, _ = v1.nn.fused_batch_norm(
+            x, _weight("scale", [filters]), _weight("offset", [filters]),
+            mean=_weight("mean", [filters]),
+            variance=_weight("variance", [filters]), is_training=False)
+        return tf.nn.relu(x) if relu else x
+
+
+def resnet(blocks):
+    """ResNet v1 with bottleneck blocks, e.g. [3, 4, 6, 3] for ResNet-50."""
+    x = v1.placeholder(tf.float32, [32, 224, 224, 3], name="images")
+    x = _conv_bn_relu(x, "stem", 64, 7, stride=2)
+    x = tf.nn.max_pool2d(x, 3, 2, "SAME")
+    for stage, num_blocks in enumerate(blocks):
+        filters = 64 * 2**stage
+        for block in range(num_blocks):
+            name = "stage%d_block%d" % (stage, block)
+            stride = 2 if block == 0 and stage > 0 else 1
+            shortcut = x
+            if block == 0:
+                shortcut = _conv_bn_relu(x, name + "_shortcut", filters * 4, 1,
+                                         stride, relu=False)
+            y = _conv_bn_relu(x, name + "_a", filters, 1, stride)
+            y = _conv_bn_relu(y, name + "_b", filters, 3)
+            y = _conv_bn_relu(y, name + "_c", filters * 4, 1, relu=False)
+            x = tf.nn.relu(y + shortcut)
+    x = tf.reduce_mean(x, axis=[1, 2])
+    return tf.nn.bias_add(tf.matmul(x, _weight("fc", [x.shape[-1], 1000])),
+                          _weight("fc_bias", [1000]))
+
+
+def _dense(x, name, units, activation=None):
+    with v1.variable_scope(name):
+        y = tf.matmul(x, _weight("kernel", [x.shape[-1], units]))
+        y = tf.nn.bias_add(y, _weight("bias", [units]))
+        return activation(y) if activation else y
+
+
+def _gelu(x):
+    return 0.5 * x * (1.0 + tf.math.erf(x / 1.4142135623730951))
+
+
+def _layer_norm(x, name):
+    with v1.variable_scope(name):
+        mean, variance = tf.nn.moments(x, axes=[-1], keepdims=True)
+        x = (x - mean) * tf.math.rsqrt(variance + 1e-12)
+        return x * _weight("gamma", [x.shape[-1]]) + _weight(
+            "beta", [x.shape[-1]])
+
+
+def bert(layers, hidden, heads, batch=8, seq_len=384):
+    """BERT encoder, e.g. 24 layers of 1024 hidden units for BERT-large."""
+    head_size = hidden // heads
+    ids = v1.placeholder(tf.int32, [batch, seq_len], name="input_ids")
+    mask = v1.placeholder(tf.float32, [batch, 1, 1, seq_len], name="mask")
+    x = tf.gather(_weight("word_embeddings", [30522, hidden]), ids)
+    x = _layer_norm(tf.reshape(x, [-1, hidden]), "embeddings_ln")
+
+    def split_heads(t):
+        t = tf.reshape(t, [batch, seq_len, heads, head_size])
+        return tf.transpose(t, [0, 2, 1, 3])
+
+    for layer in range(layers):
+        with v1.variable_scope("layer%d" % layer):
+            q = split_heads(_dense(x, "query", hidden))
+            k = split_heads(_dense(x, "key", hidden))
+            v = split_heads(_dense(x, "value", hidden))
+            scores = tf.matmul(q, k, transpose_b=True) * (head_size**-0.5)
+            probs = tf.nn.softmax(scores + (1.0 - mask) * -10000.0)
+            context = tf.transpose(tf.matmul(probs, v), [0, 2, 1, 3])
+            context = tf.reshape(context, [-1, hidden])
+            x = _layer_norm(x + _dense(context, "attention_output", hidden),
+                            "attention_ln")
+            y = _dense(x, "intermediate", hidden * 4, _gelu)
+            x = _layer_norm(x + _dense(y, "output", hidden), "output_ln")
+    return _dense(x, "pooler", hidden, tf.tanh)
+
+
+def dlrm(num_tables=26, embedding_dim=128, rows=1000000, batch=2048):
+    """DLRM with a bottom MLP, embedding tables and a dot interaction."""
+    dense = v1.placeholder(tf.float32, [batch, 13], name="dense_features")
+    x = dense
+    for i, units in enumerate([512, 256, embedding_dim]):
+        x = _dense(x, "bottom_mlp%d" % i, units, tf.nn.relu)
+    features = [x]
+    for table in range(num_tables):
+        ids = v1.placeholder(tf.int32, [batch], name="sparse%d" % table)
+        features.append(
+            tf.nn.embedding_lookup(
+                _weight("table%d" % table, [rows, embedding_dim]), ids))
+    t = tf.stack(features, axis=1)
+    interactions = tf.matmul(t, t, transpose_b=True)
+    num_features = num_tables + 1
+    lower = [[i * num_features + j for j in range(i)]
+             for i in range(num_features)]
+    flat = tf.reshape(interactions, [batch, -1])
+    x = tf.concat([x, tf.gather(flat, sum(lower, []), axis=1)], axis=1)
+    for i, units in enumerate([1024, 1024, 512, 256]):
+        x = _dense(x, "top_mlp%d" % i, units, tf.nn.relu)
+    return tf.sigmoid(_dense(x, "top_mlp_out", 1))
+
+
+GRAPHS = collections.OrderedDict([
+    ("resnet50", lambda: resnet([3, 4, 6, 3])),
+    ("resnet152", lambda: resnet([3, 8, 36, 3])),
+    ("bert_base", lambda: bert(12, 768, 12)),
+    ("bert_large", lambda: bert(24, 1024, 16)),
+    ("dlrm", dlrm),
+])
+
+
+def build_meta_graph(build_fn):
+    graph = tf.Graph()
+    with graph.as_default():
+        output = build_fn()
+        graph.add_to_collection("train_op", output)
+        return v1.train.export_meta_graph(graph=graph)
+
+
+def _labels(sample):
+    match = re.search(r"\{(.*)\}", sample)
+    if not match:
+        return {}
+    return dict(re.findall(r'(\w+)="([^"]*)"', match.group(1)))
+
+
+def _delta(before, after, prefix):
+    """Returns {labels: value} of the samples starting with prefix{ that
+    changed between two snapshots of itex.get_kernel_metrics()."""
+    result = {}
+    for sample, value in after.items():
+        if not sample.startswith(prefix + "{") and sample != prefix:
+            continue
+        delta = value - before.get(sample, 0.0)
+        if delta:
+            result[tuple(sorted(_labels(sample).items()))] = delta
+    return result
+
+
+def benchmark(name, meta_graph, iterations):
+    config = config_pb2.ConfigProto()
+    wall_secs = []
+    for _ in range(iterations):
+        before = itex.get_kernel_metrics()
+        start = time.perf_counter()
+        tf_optimizer.OptimizeGraph(config, meta_graph)
+        wall_secs.append(time.perf_counter() - start)
+        after = itex.get_kernel_metrics()
+
+    # Passes of the last iteration; every iteration optimizes the same graph.
+    passes = collections.OrderedDict()
+    usecs = _delta(before, after, "itex_graph_pass_usecs_sum")
+    runs = _delta(before, after, "itex_graph_pass_usecs_count")
+    shape_usecs = _delta(before, after,
+                         "itex_graph_shape_inference_usecs_sum")
+    for labels, total in usecs.items():
+        pass_name = dict(labels)["pass"]
+
+        def gauge(metric, stage, pass_name=pass_name):
+            return int(after.get('%s{pass="%s",stage="%s"}' %
+                                 (metric, pass_name, stage), 0))
+
+        passes[pass_name] = {
+            "runs": int(runs.get(labels, 0)),
+            "msecs": total / 1e3,
+            "shape_inference_msecs": shape_usecs.get(labels, 0.0) / 1e3,
+            "nodes_before": gauge("itex_graph_pass_nodes", "before"),
+            "nodes_after": gauge("itex_graph_pass_nodes", "after"),
+            "edges_before": gauge("itex_graph_pass_edges", "before"),
+            "edges_after": gauge("itex_graph_pass_edges", "after"),
+        }
+    fusions = {
+        dict(labels)["pattern"]: int(count)
+        for labels, count in _delta(before, after, "itex_graph_fusions").items()
+    }
+    itex_usecs = sum(
+        _delta(before, after, "itex_graph_optimize_usecs_sum").values())
+    return {
+        "graph": name,
+        "nodes": len(meta_graph.graph_def.node),
+        "grappler_msecs": sorted(wall_secs)[len(wall_secs) // 2] * 1e3,
+        "itex_msecs": itex_usecs / 1e3,
+        "passes": passes,
+        "fusions": fusions,
+    }
+
+
+def print_result(result):
+    print("%s: %d nodes, Grappler %.1f ms, ITEX %.1f ms" %
+          (result["graph"], result["nodes"], result["grappler_msecs"],
+           result["itex_msecs"]))
+    print("  %-26s %5s %10s %10s %15s %15s" %
+          ("pass", "runs", "ms", "shape ms", "nodes", "edges"))
+    for pass_name, p in result["passes"].items():
+        print("  %-26s %5d %10.1f %10.1f %7d->%-7d %7d->%-7d" %
+              (pass_name, p["runs"], p["msecs"], p["shape_inference_msecs"],
+               p["nodes_before"], p["nodes_after"], p["edges_before"],
+               p["edges_after"]))
+    for pattern, count in sorted(result["fusions"].items()):
+        print("  fusion %-40s %6d" % (pattern, count))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--graphs", default=",".join(GRAPHS),
+                        help="Comma separated graphs out of %s." %
+                        ", ".join(GRAPHS))
+    parser.add_argument("--iterations", type=int, default=3,
+                        help="Optimizations of every graph.")
+    parser.add_argument("--output", help="File to write the results to.")
+    args = parser.parse_args()
+
+    results = []
+    for name in args.graphs.split(","):
+        result = benchmark(name, build_meta_graph(GRAPHS[name]),
+                           args.iterations)
+        print_result(result)
+        results.append(result)
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(results, f, indent=2)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,121 @@
+# Copyright (c) 2023 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+
+"""Measures the per-op dispatch overhead of the plugin kernels.
+
+The ops run on tiny tensors, so the time is dominated by setting up the
+OpKernelContext, fetching the inputs and allocating the outputs rather than by
+the computation. Compare the printed us/op before and after a change to the
+kernel launch path. testManyInputs also prints the cost of AddN of 16 inputs
+relative to AddV2, which grows with per-input allocations in the launch path.
+Nothing is asserted, the numbers depend on the machine and its load.
+"""
+
+import time
+
+import numpy as np
+import tensorflow as tf
+from tensorflow.python.framework import constant_op
+from tensorflow.python.framework import dtypes
+from tensorflow.python.ops import gen_math_ops
+
+try:
+    from intel_extension_for_tensorflow.python.test_func import test
+except ImportError:
+    from tensorflow.python.platform import test
+
+WARMUP = 100
+ITERATION = 10000
+# Ops launched per tf.function call, so that the function call itself is
+# amortized.
+OPS_PER_GRAPH = 100
+# Each case is timed this many times and the fastest run is kept.
+REPEATS = 5
+
+
+class OpDispatchOverheadTest(test.TestCase):
+    def _report(self, name, seconds, num_ops):
+        """Prints and returns the us/op of a case."""
+        us_per_op = seconds * 1e6 / num_ops
+        print("{}: {:.3f} us/op".format(name, us_per_op))
+        return us_per_op
+
+    def _time_eager(self, name, fn):
+        for _ in range(WARMUP):
+            fn()
+        seconds = []
+        for _ in range(REPEATS):
+            start = time.perf_counter()
+            for _ in range(ITERATION):
+                out = fn()
+            out.numpy()
+            seconds.append(time.perf_counter() - start)
+        return self._report(name + " (eager)", min(seconds), ITERATION)
+
+    def _time_graph(self, name, fn, x):
+        @tf.function
+        def chain(x):
+            for _ in range(OPS_PER_GRAPH):
+                x = fn(x)
+            return x
+
+        for _ in range(WARMUP // 10):
+            chain(x)
+        iteration = ITERATION // OPS_PER_GRAPH
+        seconds = []
+        for _ in range(REPEATS):
+            start = time.perf_counter()
+            for _ in range(iteration):
+                out = chain(x)
+            out.numpy()
+            seconds.append(time.perf_counter() - start)
+        return self._report(name + " (graph)", min(seconds),
+                            iteration * OPS_PER_GRAPH)
+
+    def testUnary(self):
+        x = constant_op.constant(np.random.normal(size=[1]),
+                                 dtype=dtypes.float32)
+        self._time_eager("Abs", lambda: gen_math_ops._abs(x))
+        self._time_graph("Abs", gen_math_ops._abs, x)
+
+    def testBinary(self):
+        x = constant_op.constant(np.random.normal(size=[1]),
+                                 dtype=dtypes.float32)
+        y = constant_op.constant(np.random.normal(size=[1]),
+                                 dtype=dtypes.float32)
+        self._time_eager("AddV2", lambda: gen_math_ops.add_v2(x, y))
+        self._time_graph("AddV2", lambda x: gen_math_ops.add_v2(x, y), x)
+
+    def testManyInputs(self):
+        # More inputs than the context keeps inline.
+        inputs = [constant_op.constant(np.random.normal(size=[1]),
+                                       dtype=dtypes.float32)
+                  for _ in range(16)]
+        y = inputs[1]
+        base_eager = self._time_eager(
+            "AddV2", lambda: gen_math_ops.add_v2(inputs[0], y))
+        base_graph = self._time_graph(
+            "AddV2", lambda x: gen_math_ops.add_v2(x, y), inputs[0])
+        many_eager = self._time_eager(
+            "AddN x16", lambda: gen_math_ops.add_n(inputs))
+        many_graph = self._time_graph(
+            "AddN x16",
+            lambda x: gen_math_ops.add_n([x] + inputs[1:]), inputs[0])
+        print("AddN x16 / AddV2: {:.2f} (eager), {:.2f} (graph)".format(
+            many_eager / base_eager, many_graph / base_graph))
+
+
+if __name__ == '__main__':
+    test.main()
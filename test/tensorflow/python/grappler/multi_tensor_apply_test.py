@@ -0,0 +1,115 @@
+# Copyright (c) 2023 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+"""Tests for grouping optimizer apply ops into multi-tensor kernels."""
+
+import os
+
+import numpy as np
+import tensorflow as tf
+
+from intel_extension_for_tensorflow.python.test_func import test_util
+from intel_extension_for_tensorflow.python.test_func import test as test_lib
+
+from tensorflow.python.platform import test
+from tensorflow.core.protobuf import config_pb2
+
+tf.compat.v1.disable_eager_execution()
+
+SHAPES = [[3], [17, 5], [40000], [2, 3, 4]]
+
+
+def keras_minimize(optimizer):
+  """Returns a v1-style minimize function for a Keras optimizer."""
+  def minimize(loss, variables):
+    grads = optimizer.get_gradients(loss, variables)
+    return optimizer.apply_gradients(zip(grads, variables))
+  return minimize
+
+
+def v1_minimize(optimizer):
+  return lambda loss, variables: optimizer.minimize(loss, var_list=variables)
+
+
+class MultiTensorApplyTest(test_util.TensorFlowTestCase):
+
+  def _train(self, minimize_fn, enable):
+    """Runs a few steps and returns the variables and the partition graph."""
+    np.random.seed(0)
+    with tf.Graph().as_default() as graph:
+      variables = [
+          tf.compat.v1.get_variable(
+              "var_%d" % i, initializer=np.random.uniform(
+                  -1, 1, shape).astype(np.float32), use_resource=True)
+          for i, shape in enumerate(SHAPES)
+      ]
+      loss = tf.add_n([tf.reduce_sum(v * v * (i + 1))
+                       for i, v in enumerate(variables)])
+      train_op = minimize_fn()(loss, variables)
+      init_op = tf.compat.v1.global_variables_initializer()
+
+    os.environ["ITEX_MULTI_TENSOR_APPLY"] = "1" if enable else "0"
+    run_options = config_pb2.RunOptions(output_partition_graphs=True)
+    metadata = config_pb2.RunMetadata()
+    try:
+      with self.session(graph=graph) as sess:
+        sess.run(init_op)
+        for _ in range(3):
+          sess.run(train_op, options=run_options, run_metadata=metadata)
+        values = sess.run(variables)
+    finally:
+      del os.environ["ITEX_MULTI_TENSOR_APPLY"]
+    return values, metadata.partition_graphs[0]
+
+  def _testOptimizer(self, minimize_fn, fused_op):
+    if test_lib.is_gpu_available():
+      self.skipTest("Multi-tensor apply is only supported on CPU.")
+    expected, _ = self._train(minimize_fn, enable=False)
+    result, graph = self._train(minimize_fn, enable=True)
+
+    fused_nodes = [node for node in graph.node if node.op == fused_op]
+    self.assertEqual(len(fused_nodes), 1, "this pattern has fusion issue!!")
+    self.assertEqual(fused_nodes[0].attr["N"].i, len(SHAPES))
+    for e, r in zip(expected, result):
+      self.assertAllClose(e, r, rtol=1e-5, atol=1e-5)
+
+  @test_util.run_deprecated_v1
+  def testAdam(self):
+    self._testOptimizer(
+        lambda: keras_minimize(tf.keras.optimizers.legacy.Adam(0.1)),
+        "_ITEXMultiTensorApplyAdam")
+
+  @test_util.run_deprecated_v1
+  def testAdagrad(self):
+    self._testOptimizer(
+        lambda: keras_minimize(tf.keras.optimizers.legacy.Adagrad(0.1)),
+        "_ITEXMultiTensorApplyAdagrad")
+
+  @test_util.run_deprecated_v1
+  def testNesterovMomentum(self):
+    self._testOptimizer(
+        lambda: v1_minimize(tf.compat.v1.train.MomentumOptimizer(
+            0.1, 0.9, use_nesterov=True)),
+        "_ITEXMultiTensorApplyMomentum")
+
+  @test_util.run_deprecated_v1
+  def testRMSProp(self):
+    self._testOptimizer(
+        lambda: keras_minimize(
+            tf.keras.optimizers.legacy.RMSprop(0.1, momentum=0.5)),
+        "_ITEXMultiTensorApplyRMSProp")
+
+
+if __name__ == "__main__":
+  test.main()
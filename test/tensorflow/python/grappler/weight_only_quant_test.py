@@ -0,0 +1,195 @@
+# Copyright (c) 2023 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+
+
+import os
+
+import numpy as np
+import tensorflow as tf
+
+from intel_extension_for_tensorflow.python.test_func import test_util
+from intel_extension_for_tensorflow.python.test_func import test as test_lib
+
+from tensorflow.python.ops import array_ops
+from tensorflow.python.platform import test
+from tensorflow.core.protobuf import config_pb2
+
+tf.compat.v1.disable_eager_execution()
+
+
+def dequantize_reference(w, bits, group_size):
+  """Fake-quantizes a [K, N] weight the same way as the graph pass."""
+  w_t = w.T.astype(np.float32)
+  out = np.empty_like(w_t)
+  for k0 in range(0, w_t.shape[1], group_size):
+    g = w_t[:, k0:k0 + group_size]
+    min_val = np.minimum(g.min(axis=1, keepdims=True), 0)
+    max_val = np.maximum(g.max(axis=1, keepdims=True), 0)
+    if bits == 8:
+      scale = np.maximum(-min_val, max_val) / 127
+      scale[scale == 0] = 1
+      q = np.clip(np.round(g / scale), -127, 127)
+    else:
+      scale = (max_val - min_val) / 15
+      scale[scale == 0] = 1
+      zero = np.clip(np.round(-min_val / scale), 0, 15)
+      q = np.clip(np.round(g / scale) + zero, 0, 15) - zero
+    out[:, k0:k0 + group_size] = q * scale
+  return out.T
+
+
+def fp8_e4m3_reference(w):
+  """Fake-quantizes a weight to E4M3 with one scale, like the graph pass."""
+  scale = np.abs(w).max() / 448
+  x = w.astype(np.float64) / scale
+  exp = np.floor(np.log2(np.maximum(np.abs(x), 2.0**-6)))
+  quantum = 2.0**(exp - 3)
+  return (np.round(x / quantum) * quantum * scale).astype(np.float32)
+
+
+class WeightOnlyQuantTest(test_util.TensorFlowTestCase):
+
+  def _run_matmul(self, bits, group_size, with_bias):
+    np.random.seed(0)
+    x = np.random.uniform(-1, 1, [4, 512]).astype(np.float32)
+    w = np.random.uniform(-1, 1, [512, 256]).astype(np.float32)
+    b = np.random.uniform(-1, 1, [256]).astype(np.float32)
+
+    os.environ["ITEX_WEIGHT_ONLY_QUANT_BITS"] = str(bits)
+    os.environ["ITEX_WEIGHT_ONLY_QUANT_GROUP_SIZE"] = str(group_size)
+    run_options = config_pb2.RunOptions(output_partition_graphs=True)
+    metadata = config_pb2.RunMetadata()
+    try:
+      with self.session() as sess:
+        out = tf.matmul(x, w)
+        if with_bias:
+          out = tf.nn.bias_add(out, b)
+        out = array_ops.identity(out)
+        result = sess.run(out, options=run_options, run_metadata=metadata)
+    finally:
+      del os.environ["ITEX_WEIGHT_ONLY_QUANT_BITS"]
+      del os.environ["ITEX_WEIGHT_ONLY_QUANT_GROUP_SIZE"]
+
+    graph = metadata.partition_graphs[0]
+    found_fused_op = False
+    for node in graph.node:
+      if node.op == "_ITEXWeightOnlyQuantMatMul":
+        found_fused_op = True
+        self.assertEqual(node.attr["weight_bits"].i, bits)
+        fused_ops = node.attr["fused_ops"].list.s
+        self.assertAllEqual(fused_ops, [b"BiasAdd"] if with_bias else [])
+        break
+    self.assertTrue(found_fused_op,
+                    "this pattern has fusion issue!!")
+
+    expected = np.matmul(x, dequantize_reference(w, bits, group_size))
+    if with_bias:
+      expected += b
+    self.assertAllClose(expected, result, rtol=1e-4, atol=1e-4)
+
+  @test_util.run_deprecated_v1
+  def testInt8MatMul(self):
+    if test_lib.is_gpu_available():
+      self.skipTest("Weight-only quantization is only supported on CPU.")
+    self._run_matmul(8, 128, with_bias=False)
+
+  @test_util.run_deprecated_v1
+  def testInt8MatMulWithBias(self):
+    if test_lib.is_gpu_available():
+      self.skipTest("Weight-only quantization is only supported on CPU.")
+    self._run_matmul(8, 64, with_bias=True)
+
+  @test_util.run_deprecated_v1
+  def testInt4MatMulWithBias(self):
+    if test_lib.is_gpu_available():
+      self.skipTest("Weight-only quantization is only supported on CPU.")
+    self._run_matmul(4, 128, with_bias=True)
+
+  @test_util.run_deprecated_v1
+  def testFP8MatMulWithBias(self):
+    if test_lib.is_gpu_available():
+      self.skipTest("FP8 weight storage is only supported on CPU.")
+    np.random.seed(0)
+    x = np.random.uniform(-1, 1, [4, 512]).astype(np.float32)
+    w = np.random.uniform(-1, 1, [512, 256]).astype(np.float32)
+    b = np.random.uniform(-1, 1, [256]).astype(np.float32)
+
+    os.environ["ITEX_WEIGHT_FP8_FORMAT"] = "E4M3"
+    run_options = config_pb2.RunOptions(output_partition_graphs=True)
+    metadata = config_pb2.RunMetadata()
+    try:
+      with self.session() as sess:
+        out = array_ops.identity(tf.nn.bias_add(tf.matmul(x, w), b))
+        result = sess.run(out, options=run_options, run_metadata=metadata)
+    finally:
+      del os.environ["ITEX_WEIGHT_FP8_FORMAT"]
+
+    graph = metadata.partition_graphs[0]
+    found_fused_op = False
+    for node in graph.node:
+      if node.op == "_ITEXFP8WeightMatMul":
+        found_fused_op = True
+        self.assertEqual(node.attr["fp8_format"].s, b"E4M3")
+        self.assertAllEqual(node.attr["fused_ops"].list.s, [b"BiasAdd"])
+        break
+    self.assertTrue(found_fused_op,
+                    "this pattern has fusion issue!!")
+
+    expected = np.matmul(x, fp8_e4m3_reference(w)) + b
+    self.assertAllClose(expected, result, rtol=1e-4, atol=1e-4)
+
+
+  @test_util.run_deprecated_v1
+  def testDynamicQuantMatMulWithBias(self):
+    if test_lib.is_gpu_available():
+      self.skipTest("Dynamic quantized MatMul is only supported on CPU.")
+    np.random.seed(0)
+    x = np.random.uniform(-1, 1, [4, 512]).astype(np.float32)
+    w = np.random.uniform(-1, 1, [512, 256]).astype(np.float32)
+    b = np.random.uniform(-1, 1, [256]).astype(np.float32)
+
+    os.environ["ITEX_DYNAMIC_QUANT"] = "1"
+    run_options = config_pb2.RunOptions(output_partition_graphs=True)
+    metadata = config_pb2.RunMetadata()
+    try:
+      with self.session() as sess:
+        out = array_ops.identity(tf.nn.bias_add(tf.matmul(x, w), b))
+        result = sess.run(out, options=run_options, run_metadata=metadata)
+    finally:
+      del os.environ["ITEX_DYNAMIC_QUANT"]
+
+    graph = metadata.partition_graphs[0]
+    found_fused_op = False
+    for node in graph.node:
+      if node.op == "_ITEXDynamicQuantizedMatMul":
+        found_fused_op = True
+        self.assertTrue(node.attr["transpose_b"].b)
+        self.assertTrue(node.attr["is_weight_const"].b)
+        self.assertAllEqual(node.attr["fused_ops"].list.s, [b"BiasAdd"])
+        break
+    self.assertTrue(found_fused_op,
+                    "this pattern has fusion issue!!")
+
+    # Per-token activation and per-channel weight fake quantization.
+    x_scale = np.abs(x).max(axis=1, keepdims=True) / 127
+    w_scale = np.abs(w).max(axis=0) / 127
+    x_q = np.clip(np.rint(x / x_scale), -127, 127)
+    w_q = np.clip(np.rint(w / w_scale), -127, 127)
+    expected = np.matmul(x_q, w_q) * x_scale * w_scale + b
+    self.assertAllClose(expected, result, rtol=1e-3, atol=1e-3)
+
+
+if __name__ == "__main__":
+  test.main()
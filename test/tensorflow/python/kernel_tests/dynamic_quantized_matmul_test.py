@@ -0,0 +1,101 @@
+# Copyright (c) 2023 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+"""Functional tests for dynamic per-token quantized MatMul."""
+
+import numpy as np
+import tensorflow as tf
+
+from intel_extension_for_tensorflow.python.test_func import test_util
+from intel_extension_for_tensorflow.python.test_func import test
+from intel_extension_for_tensorflow.python.ops.load_ops_library import load_ops_library
+
+from tensorflow.python.framework import constant_op
+from tensorflow.python.framework import dtypes
+from tensorflow.python.ops import array_ops
+
+
+class DynamicQuantizedMatMulTest(test.TestCase):
+
+  def _reference(self, x, w, bias, per_channel):
+    """Applies the same per-token / per-channel fake quantization."""
+    x_scale = np.abs(x).max(axis=1, keepdims=True) / 127
+    x_q = np.clip(np.rint(x / x_scale), -127, 127)
+    w_range = np.abs(w).max(axis=0) if per_channel else np.abs(w).max()
+    w_scale = w_range / 127
+    w_q = np.clip(np.rint(w / w_scale), -127, 127)
+    out = np.matmul(x_q, w_q) * x_scale * w_scale
+    return out + bias if bias is not None else out
+
+  @test_util.run_deprecated_v1
+  def _testMatMul(self, per_channel, with_bias, transpose_b,
+                  is_weight_const=False):
+    if test.is_gpu_available():
+      self.skipTest("Dynamic quantized MatMul is only supported on CPU.")
+    np.random.seed(0)
+    x = np.random.uniform(-1, 1, [6, 64]).astype(np.float32)
+    # Outliers in one token must not hurt the precision of the other tokens.
+    x[2] *= 100
+    w = np.random.uniform(-1, 1, [64, 32]).astype(np.float32)
+    bias = np.random.uniform(-1, 1, [32]).astype(np.float32)
+
+    axis = 1 if per_channel else None
+    w_min = np.min(w, axis=0) if per_channel else np.min(w)
+    w_max = np.max(w, axis=0) if per_channel else np.max(w)
+    w_int8, w_min, w_max = array_ops.quantize(
+        constant_op.constant(w), w_min, w_max, T=dtypes.qint8, mode="SCALED",
+        round_mode="HALF_TO_EVEN", narrow_range=True, axis=axis)
+    if transpose_b:
+      w_int8 = array_ops.transpose(w_int8)
+
+    out = load_ops_library._ITEXDynamicQuantizedMatMul(
+        a=constant_op.constant(x), b=w_int8, min_b=w_min, max_b=w_max,
+        args=[constant_op.constant(bias)] if with_bias else [],
+        transpose_b=transpose_b,
+        fused_ops=["BiasAdd"] if with_bias else [],
+        is_weight_const=is_weight_const)
+    out = array_ops.identity(out)
+
+    with self.session(use_gpu=False) as sess:
+      # With is_weight_const, the first run fills the weight cache and the
+      # second one reads the reordered weight from it.
+      results = [sess.run(out) for _ in range(2)]
+    expected = self._reference(x, w, bias if with_bias else None,
+                               per_channel)
+    for result in results:
+      self.assertAllClose(expected, result, rtol=1e-3, atol=1e-3)
+      self.assertAllClose(np.matmul(x, w) + (bias if with_bias else 0),
+                          result, rtol=0.05, atol=0.1)
+    self.assertAllEqual(results[0], results[1])
+
+  def testPerTensorWeight(self):
+    self._testMatMul(per_channel=False, with_bias=False, transpose_b=False)
+
+  def testPerChannelWeightWithBias(self):
+    self._testMatMul(per_channel=True, with_bias=True, transpose_b=False)
+
+  def testTransposedWeightWithBias(self):
+    self._testMatMul(per_channel=True, with_bias=True, transpose_b=True)
+
+  def testWeightCache(self):
+    self._testMatMul(per_channel=True, with_bias=True, transpose_b=False,
+                     is_weight_const=True)
+
+  def testTransposedWeightCache(self):
+    self._testMatMul(per_channel=False, with_bias=False, transpose_b=True,
+                     is_weight_const=True)
+
+
+if __name__ == "__main__":
+  test.main()
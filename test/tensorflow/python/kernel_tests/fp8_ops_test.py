@@ -0,0 +1,121 @@
+# Copyright (c) 2023 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+"""Functional tests for FP8 quantize, dequantize and weight MatMul ops."""
+
+import numpy as np
+import tensorflow as tf
+
+from intel_extension_for_tensorflow.python.test_func import test_util
+from intel_extension_for_tensorflow.python.test_func import test
+from intel_extension_for_tensorflow.python.ops.load_ops_library import load_ops_library
+
+from tensorflow.python.framework import constant_op
+from tensorflow.python.ops import array_ops
+
+# (mantissa bits, minimum normal exponent, largest finite value)
+FP8_FORMATS = {
+    "E4M3": (3, -6, 448.0),
+    "E5M2": (2, -14, 57344.0),
+}
+
+
+def fp8_round(x, fp8_format):
+  """Rounds to the nearest FP8 value, half to even, saturating."""
+  mantissa_bits, min_exp, max_value = FP8_FORMATS[fp8_format]
+  x = np.asarray(x, dtype=np.float64)
+  exp = np.floor(np.log2(np.maximum(np.abs(x), 2.0**min_exp)))
+  quantum = 2.0**(exp - mantissa_bits)
+  return np.clip(np.round(x / quantum) * quantum, -max_value, max_value)
+
+
+class FP8OpsTest(test.TestCase):
+
+  def _testRoundTrip(self, fp8_format, scale):
+    if test.is_gpu_available():
+      self.skipTest("FP8 ops are only supported on CPU.")
+    np.random.seed(0)
+    x = np.random.uniform(-2, 2, [8, 33]).astype(np.float32)
+    x[0, :3] = [1e6, -1e6, 0]
+
+    bits = load_ops_library._ITEXFP8Quantize(
+        input=constant_op.constant(x), scale=scale, fp8_format=fp8_format)
+    out = load_ops_library._ITEXFP8Dequantize(
+        input=bits, scale=scale, dtype=tf.float32, fp8_format=fp8_format)
+
+    with self.session(use_gpu=False) as sess:
+      result = sess.run(out)
+    expected = fp8_round(x / scale, fp8_format) * scale
+    self.assertAllClose(expected, result, rtol=1e-6, atol=1e-6)
+
+  @test_util.run_deprecated_v1
+  def testE4M3RoundTrip(self):
+    self._testRoundTrip("E4M3", 0.5)
+
+  @test_util.run_deprecated_v1
+  def testE5M2RoundTrip(self):
+    self._testRoundTrip("E5M2", 0.01)
+
+  @test_util.run_deprecated_v1
+  def testInvalidScale(self):
+    if test.is_gpu_available():
+      self.skipTest("FP8 ops are only supported on CPU.")
+    bits = load_ops_library._ITEXFP8Quantize(
+        input=constant_op.constant([1.0, 2.0]), scale=0.0)
+    with self.session(use_gpu=False) as sess:
+      with self.assertRaisesOpError("positive and finite"):
+        sess.run(bits)
+
+  def _testMatMul(self, fp8_format, with_bias, dtype):
+    if test.is_gpu_available():
+      self.skipTest("FP8 ops are only supported on CPU.")
+    np.random.seed(0)
+    # K is not a multiple of the GEMM tile to cover the tail.
+    x = np.random.uniform(-1, 1, [3, 5, 300]).astype(np.float32)
+    w = np.random.uniform(-1, 1, [70, 300]).astype(np.float32)
+    bias = np.random.uniform(-1, 1, [70]).astype(np.float32)
+    scale = np.abs(w).max() / FP8_FORMATS[fp8_format][2]
+
+    w_bits = load_ops_library._ITEXFP8Quantize(
+        input=constant_op.constant(w), scale=scale, fp8_format=fp8_format)
+    args = [tf.cast(constant_op.constant(bias), dtype)] if with_bias else []
+    out = load_ops_library._ITEXFP8WeightMatMul(
+        a=tf.cast(constant_op.constant(x), dtype), b=w_bits, scale=scale,
+        args=args, fp8_format=fp8_format,
+        fused_ops=["BiasAdd"] if with_bias else [])
+    out = array_ops.identity(tf.cast(out, tf.float32))
+
+    with self.session(use_gpu=False) as sess:
+      result = sess.run(out)
+    expected = np.matmul(x, fp8_round(w / scale, fp8_format).T * scale)
+    if with_bias:
+      expected += bias
+    tol = 1e-4 if dtype == tf.float32 else 0.2
+    self.assertAllClose(expected, result, rtol=tol, atol=tol)
+
+  @test_util.run_deprecated_v1
+  def testE4M3MatMul(self):
+    self._testMatMul("E4M3", with_bias=False, dtype=tf.float32)
+
+  @test_util.run_deprecated_v1
+  def testE5M2MatMulWithBias(self):
+    self._testMatMul("E5M2", with_bias=True, dtype=tf.float32)
+
+  @test_util.run_deprecated_v1
+  def testE4M3MatMulWithBiasBF16(self):
+    self._testMatMul("E4M3", with_bias=True, dtype=tf.bfloat16)
+
+
+if __name__ == "__main__":
+  test.main()
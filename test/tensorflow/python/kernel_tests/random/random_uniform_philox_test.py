@@ -0,0 +1,76 @@
+# Copyright (c) 2023 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+"""Tests for the multi-lane Philox CPU RandomUniform and FusedRandom."""
+
+import numpy as np
+import tensorflow as tf
+
+from intel_extension_for_tensorflow.python.test_func import test
+from intel_extension_for_tensorflow.python.ops.load_ops_library import load_ops_library
+
+from tensorflow.python.framework import constant_op
+
+
+class RandomUniformPhiloxTest(test.TestCase):
+
+  def _uniform(self, size, dtype=tf.float32, seed=87654321, seed2=123):
+    return load_ops_library._ITEXRandomUniform(
+        shape=constant_op.constant([size], dtype=tf.int32), dtype=dtype,
+        seed=seed, seed2=seed2)
+
+  def testRangeAndMoments(self):
+    if test.is_gpu_available():
+      self.skipTest("Multi-lane Philox is only used on CPU.")
+    for dtype in [tf.float32, tf.bfloat16]:
+      with self.session(use_gpu=False) as sess:
+        x = sess.run(tf.cast(self._uniform(1 << 20, dtype), tf.float32))
+      self.assertGreaterEqual(x.min(), 0.0)
+      self.assertLess(x.max(), 1.0)
+      self.assertAllClose(x.mean(), 0.5, atol=1e-2)
+      self.assertAllClose(x.var(), 1.0 / 12, atol=1e-2)
+
+  def testStreamIndependentOfSize(self):
+    # The output is a single Philox stream regardless of how the work is
+    # split across lanes and threads, so a longer tensor drawn with the same
+    # seeds starts with the shorter one. 1001 is not a multiple of the lanes.
+    if test.is_gpu_available():
+      self.skipTest("Multi-lane Philox is only used on CPU.")
+    with self.session(use_gpu=False) as sess:
+      short, full = sess.run([self._uniform(1001), self._uniform(1 << 18)])
+    self.assertAllEqual(short, full[:1001])
+    self.assertGreater(np.unique(full).size, (1 << 18) * 0.95)
+
+  def testFusedRandomMask(self):
+    if test.is_gpu_available():
+      self.skipTest("Multi-lane Philox is only used on CPU.")
+    size = 1 << 18
+    rate = 0.3
+    mask = load_ops_library._ITEXFusedRandom(
+        shape=constant_op.constant([size], dtype=tf.int32),
+        y=constant_op.constant(rate, dtype=tf.float32),
+        fused_ops=["GreaterEqual", "Cast"], direction=0, seed=87654321,
+        seed2=123)
+    with self.session(use_gpu=False) as sess:
+      mask, uniform = sess.run([mask, self._uniform(size)])
+    self.assertAllInSet(mask, [0.0, 1.0])
+    self.assertAllClose(mask.mean(), 1 - rate, atol=1e-2)
+    # Same seeds give the same stream, so the mask is `uniform >= rate` up to
+    # the rounding of the threshold.
+    mismatch = np.count_nonzero(mask != (uniform >= rate))
+    self.assertLess(mismatch, size * 1e-4)
+
+
+if __name__ == "__main__":
+  test.main()
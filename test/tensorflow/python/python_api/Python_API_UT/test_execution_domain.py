@@ -0,0 +1,77 @@
+# Copyright (c) 2023 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+
+
+import os
+
+import numpy as np
+import tensorflow as tf
+import intel_extension_for_tensorflow as itex
+from intel_extension_for_tensorflow.python.test_func import test_util
+from intel_extension_for_tensorflow.python.test_func import test
+
+
+class ExecutionDomainTest(test_util.TensorFlowTestCase):
+    """test execution domain itex python api"""
+
+    # Domains can only be created once per process, so everything is checked
+    # in one test.
+    def testExecutionDomains(self):
+        num_domains = 2 if len(os.sched_getaffinity(0)) >= 2 else 1
+        with self.assertRaises(RuntimeError):
+            itex.create_execution_domains(0)
+        domains = itex.create_execution_domains(num_domains)
+        self.assertLen(domains, num_domains)
+        self.assertEqual(domains, itex.get_execution_domains())
+        cpus = set()
+        for i, domain in enumerate(domains):
+            self.assertEqual(domain.id, i)
+            self.assertNotEmpty(domain.cpus)
+            self.assertEmpty(cpus.intersection(domain.cpus))
+            cpus.update(domain.cpus)
+        with self.assertRaises(RuntimeError):
+            itex.create_execution_domains(num_domains)
+
+        self.assertEqual(itex.current_execution_domain(), -1)
+        affinity = os.sched_getaffinity(0)
+        with itex.execution_domain(num_domains - 1):
+            self.assertEqual(itex.current_execution_domain(), num_domains - 1)
+            self.assertEqual(os.sched_getaffinity(0),
+                             set(domains[num_domains - 1].cpus))
+        self.assertEqual(itex.current_execution_domain(), -1)
+        self.assertEqual(os.sched_getaffinity(0), affinity)
+        with self.assertRaises(RuntimeError):
+            with itex.execution_domain(num_domains):
+                pass
+
+        x = np.random.normal(size=[64, 64]).astype(np.float32)
+        y = np.random.normal(size=[64, 64]).astype(np.float32)
+        expected = np.maximum(np.matmul(x, y), 0)
+        for i in range(num_domains):
+            # One function per domain, traced in it.
+            @tf.function
+            def fn(x, y):
+                return tf.nn.relu(tf.matmul(x, y))
+
+            with itex.execution_domain(i):
+                self.assertAllClose(fn(x, y), expected, rtol=1e-4, atol=1e-4)
+                self.assertAllClose(tf.nn.relu(tf.matmul(x, y)), expected,
+                                    rtol=1e-4, atol=1e-4)
+            # The function keeps running in its domain.
+            self.assertAllClose(fn(x, y), expected, rtol=1e-4, atol=1e-4)
+
+
+if __name__ == "__main__":
+    test.main()
@@ -0,0 +1,57 @@
+# Copyright (c) 2023 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+# ==============================================================================
+
+
+import json
+import os
+import tempfile
+
+import numpy as np
+import tensorflow as tf
+import intel_extension_for_tensorflow as itex
+from intel_extension_for_tensorflow.python.test_func import test_util
+from intel_extension_for_tensorflow.python.test_func import test
+
+
+class FlightRecorderTest(test_util.TensorFlowTestCase):
+    """test flight recorder itex python api"""
+
+    def _MatMulRuns(self, trace):
+        return [event for event in trace["traceEvents"]
+                if event["ph"] == "X" and "MatMul" in event["cat"]]
+
+    def testRecordsKernelRuns(self):
+        self.assertTrue(itex.is_flight_recorder_enabled())
+        x = np.random.normal(size=[32, 48]).astype(np.float32)
+        y = np.random.normal(size=[48, 16]).astype(np.float32)
+        self.assertAllClose(tf.matmul(x, y), np.matmul(x, y),
+                            rtol=1e-4, atol=1e-4)
+
+        runs = self._MatMulRuns(itex.get_flight_recorder_trace())
+        self.assertTrue(runs)
+        self.assertGreaterEqual(runs[-1]["dur"], 0.0)
+        self.assertIn("step_id", runs[-1]["args"])
+
+    def testDump(self):
+        tf.matmul(tf.ones([4, 4]), tf.ones([4, 4]))
+        path = os.path.join(tempfile.mkdtemp(), "trace.json")
+        self.assertEqual(itex.dump_flight_recorder(path), path)
+        with open(path) as trace:
+            self.assertTrue(self._MatMulRuns(json.load(trace)))
+
+
+if __name__ == "__main__":
+    test.main()
@@ -0,0 +1,48 @@
+# Copyright (c) 2023 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+
+
+import numpy as np
+import tensorflow as tf
+import intel_extension_for_tensorflow as itex
+from intel_extension_for_tensorflow.python.test_func import test_util
+from intel_extension_for_tensorflow.python.test_func import test
+
+
+class KernelMetricsTest(test_util.TensorFlowTestCase):
+    """test kernel metrics itex python api"""
+
+    def _PrimitiveCreations(self):
+        return sum(value for sample, value in itex.get_kernel_metrics().items()
+                   if sample.startswith("itex_kernels_primitive_creations{"))
+
+    def testKernelMetrics(self):
+        before = self._PrimitiveCreations()
+        x = np.random.normal(size=[32, 48]).astype(np.float32)
+        y = np.random.normal(size=[48, 16]).astype(np.float32)
+        self.assertAllClose(tf.matmul(x, y), np.matmul(x, y),
+                            rtol=1e-4, atol=1e-4)
+        self.assertGreater(self._PrimitiveCreations(), before)
+
+        text = itex.get_kernel_metrics_text()
+        self.assertIn("# TYPE itex_kernels_reorders counter", text)
+        self.assertIn("# TYPE itex_kernels_primitive_creation_usecs histogram",
+                      text)
+        self.assertIn('itex_kernels_primitive_creation_usecs_bucket{', text)
+        self.assertIn('le="+Inf"', text)
+
+
+if __name__ == "__main__":
+    test.main()
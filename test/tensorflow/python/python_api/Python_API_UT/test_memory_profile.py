@@ -0,0 +1,70 @@
+# Copyright (c) 2023 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+# ==============================================================================
+
+
+import os
+
+# Read once by the first kernel allocation.
+os.environ["ITEX_MEMORY_PROFILE"] = "1"
+
+import numpy as np
+import tensorflow as tf
+import intel_extension_for_tensorflow as itex
+from intel_extension_for_tensorflow.python.test_func import test_util
+from intel_extension_for_tensorflow.python.test_func import test
+
+
+class MemoryProfileTest(test_util.TensorFlowTestCase):
+    """test memory profile itex python api"""
+
+    def testMatMulOutput(self):
+        if not itex.is_memory_profile_enabled():
+            self.skipTest("The memory profiler only supports CPU.")
+        itex.reset_memory_profile()
+        x = np.random.normal(size=[256, 128]).astype(np.float32)
+        y = np.random.normal(size=[128, 64]).astype(np.float32)
+        with tf.device("/CPU:0"):
+            z = tf.matmul(x, y)
+        self.assertAllClose(z, np.matmul(x, y), rtol=1e-4, atol=1e-4)
+
+        report = itex.get_memory_report(top_n=5)
+        output_bytes = 4 * 256 * 64
+        self.assertGreaterEqual(report["peak_bytes"], output_bytes)
+        matmul = [entry for entry in report["top_nodes"]
+                  if "MatMul" in entry["op"]]
+        self.assertEqual(len(matmul), 1)
+        self.assertGreaterEqual(
+            matmul[0]["allocated_bytes"] + matmul[0]["untracked_bytes"],
+            output_bytes)
+        self.assertLessEqual(len(report["top_at_peak"]), 5)
+        self.assertTrue(report["steps"])
+        self.assertTrue(report["timeline"])
+        for sample in report["timeline"]:
+            self.assertLessEqual(sample["live_bytes"], report["peak_bytes"])
+            self.assertLessEqual(sum(n["bytes"] for n in sample["nodes"]),
+                                 sample["live_bytes"])
+        self.assertIn("MatMul", itex.format_memory_report(report))
+
+        # The output is released with the last reference to it.
+        del z
+        report = itex.get_memory_report(top_n=5)
+        matmul = [entry for entry in report["top_nodes"]
+                  if "MatMul" in entry["op"]]
+        self.assertEqual(matmul[0]["live_bytes"], 0)
+
+
+if __name__ == "__main__":
+    test.main()
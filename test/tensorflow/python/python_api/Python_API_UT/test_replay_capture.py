@@ -0,0 +1,126 @@
+# Copyright (c) 2023 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+
+
+import glob
+import os
+import subprocess
+import tempfile
+
+# Read once by the first kernel created.
+CAPTURE_DIR = tempfile.mkdtemp()
+os.environ["ITEX_REPLAY_CAPTURE"] = "replay_matmul"
+os.environ["ITEX_REPLAY_CAPTURE_DIR"] = CAPTURE_DIR
+
+import numpy as np
+import tensorflow as tf
+from intel_extension_for_tensorflow.python.test_func import test_util
+from intel_extension_for_tensorflow.python.test_func import test
+
+from tensorflow.core.framework import graph_pb2
+
+META_NODE = "_itex_replay_meta"
+INPUT_PREFIX = "_itex_replay_input_"
+
+
+def find_kernel_replay():
+    """Returns the path of the kernel_replay binary, None if not built."""
+    path = os.environ.get("ITEX_KERNEL_REPLAY")
+    if path:
+        return path
+    root = os.path.dirname(os.path.abspath(__file__))
+    while root != os.path.dirname(root):
+        path = os.path.join(root, "bazel-bin", "itex", "core", "kernels",
+                            "benchmark", "kernel_replay")
+        if os.path.exists(path):
+            return path
+        root = os.path.dirname(root)
+    return None
+
+
+class ReplayCaptureTest(test_util.TensorFlowTestCase):
+    """test ITEX_REPLAY_CAPTURE and its replay with kernel_replay"""
+
+    def _capture_matmul(self, x, w):
+        graph = tf.Graph()
+        with graph.as_default():
+            x_in = tf.compat.v1.placeholder(tf.float32, x.shape)
+            w_in = tf.compat.v1.placeholder(tf.float32, w.shape)
+            out = tf.identity(tf.matmul(x_in, w_in, name="replay_matmul"))
+            with tf.compat.v1.Session(graph=graph) as sess:
+                result = sess.run(out, feed_dict={x_in: x, w_in: w})
+        self.assertAllClose(result, np.matmul(x, w), rtol=1e-4, atol=1e-4)
+        paths = glob.glob(
+            os.path.join(CAPTURE_DIR, "itex_replay_replay_matmul_*.pb"))
+        self.assertEqual(len(paths), 1)
+        return paths[0]
+
+    def testCaptureAndReplay(self):
+        if test.is_gpu_available():
+            self.skipTest("Kernel replay only supports CPU.")
+        # x keeps its data, w is larger than 4 KiB and is seeded.
+        x = np.random.normal(size=[4, 8]).astype(np.float32)
+        w = np.random.normal(size=[8, 256]).astype(np.float32)
+        path = self._capture_matmul(x, w)
+
+        graph = graph_pb2.GraphDef()
+        with open(path, "rb") as f:
+            graph.ParseFromString(f.read())
+        nodes = {node.name: node for node in graph.node}
+        node = nodes["replay_matmul"]
+        self.assertIn("MatMul", node.op)
+        self.assertEqual(node.attr["T"].type, tf.float32.as_datatype_enum)
+        self.assertFalse(node.attr["transpose_a"].b)
+        self.assertFalse(node.attr["transpose_b"].b)
+        self.assertEqual(list(node.input),
+                         [INPUT_PREFIX + "0", INPUT_PREFIX + "1"])
+
+        meta = nodes[META_NODE]
+        self.assertEqual(list(meta.attr["seeded_inputs"].list.i), [1])
+        self.assertEqual(list(meta.attr["output_types"].list.type),
+                         [tf.float32.as_datatype_enum])
+        # The capture settings are not replayed.
+        for entry in meta.attr["env"].list.s:
+            self.assertFalse(entry.startswith(b"ITEX_REPLAY_"), entry)
+        self.assertAllEqual(
+            tf.make_ndarray(nodes[INPUT_PREFIX + "0"].attr["value"].tensor),
+            x)
+        w_value = nodes[INPUT_PREFIX + "1"].attr["value"].tensor
+        self.assertEqual(w_value.dtype, tf.float32.as_datatype_enum)
+        self.assertEqual([d.size for d in w_value.tensor_shape.dim],
+                         [8, 256])
+        self.assertFalse(w_value.tensor_content)
+
+        kernel_replay = find_kernel_replay()
+        if kernel_replay is None:
+            self.skipTest("kernel_replay is not built, set ITEX_KERNEL_REPLAY "
+                          "to its path.")
+        env = dict(os.environ)
+        del env["ITEX_REPLAY_CAPTURE"]
+        replay = subprocess.run(
+            [kernel_replay, "--capture=" + path, "--iterations=3",
+             "--warmup=0"],
+            stdout=subprocess.PIPE, stderr=subprocess.STDOUT, env=env,
+            check=False)
+        output = replay.stdout.decode()
+        self.assertEqual(replay.returncode, 0, output)
+        self.assertIn("Node replay_matmul of op " + node.op, output)
+        self.assertIn("Input 0: float [4,8]\n", output)
+        self.assertIn("Input 1: float [8,256] (seeded)", output)
+        self.assertIn("Steady state over 3 runs", output)
+
+
+if __name__ == "__main__":
+    test.main()
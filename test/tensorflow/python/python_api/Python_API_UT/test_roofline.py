@@ -0,0 +1,70 @@
+# Copyright (c) 2023 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+# ==============================================================================
+
+
+import os
+
+# Read once by the first kernel run.
+os.environ["ITEX_OP_COST"] = "1"
+
+import numpy as np
+import tensorflow as tf
+import intel_extension_for_tensorflow as itex
+from intel_extension_for_tensorflow.python.roofline import MachinePeaks
+from intel_extension_for_tensorflow.python.test_func import test_util
+from intel_extension_for_tensorflow.python.test_func import test
+
+
+class RooflineTest(test_util.TensorFlowTestCase):
+    """test roofline itex python api"""
+
+    def _MatMulCost(self, metric, before):
+        prefix = "itex_kernels_op_%s{" % metric
+        return sum(value - before.get(sample, 0.0)
+                   for sample, value in itex.get_kernel_metrics().items()
+                   if sample.startswith(prefix) and "MatMul" in sample)
+
+    def testMatMulCost(self):
+        before = itex.get_kernel_metrics()
+        x = np.random.normal(size=[32, 48]).astype(np.float32)
+        y = np.random.normal(size=[48, 16]).astype(np.float32)
+        self.assertAllClose(tf.matmul(x, y), np.matmul(x, y),
+                            rtol=1e-4, atol=1e-4)
+
+        self.assertEqual(self._MatMulCost("runs", before), 1)
+        self.assertEqual(self._MatMulCost("flops", before), 2 * 32 * 48 * 16)
+        self.assertEqual(self._MatMulCost("bytes", before),
+                         4 * (32 * 48 + 48 * 16 + 32 * 16))
+
+        summary = itex.get_roofline_summary(MachinePeaks(100.0, 10.0), before)
+        matmul = [entry for entry in summary if "MatMul" in entry["op_type"]]
+        self.assertEqual(len(matmul), 1)
+        self.assertGreater(matmul[0]["efficiency"], 0.0)
+        self.assertEqual(sorted(summary, key=lambda e: -e["lost_secs"]),
+                         summary)
+        self.assertIn(matmul[0]["op_type"], itex.format_roofline_summary(
+            summary, MachinePeaks(100.0, 10.0)))
+
+    def testMeasureMachinePeaks(self):
+        peaks = itex.measure_machine_peaks(gemm_size=256,
+                                           stream_elements=1 << 20,
+                                           repeats=2)
+        self.assertGreater(peaks.gflops, 0.0)
+        self.assertGreater(peaks.gbytes_per_sec, 0.0)
+
+
+if __name__ == "__main__":
+    test.main()